@@ -0,0 +1,790 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file Benchmarks.cpp Times each parse call of XmlParser and ConfigParser.
+
+
+// ----------------------------------------------------------------------------
+
+#include "Benchmarks.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "../Util/include/CharFinder.hpp"
+#include "../Util/include/ErrorReceiver.hpp"
+#include "../Util/include/EventBuffer.hpp"
+#include "../Util/include/RuleProfile.hpp"
+#include "../Xml/include/XmlParser.hpp"
+#include "../Xml/include/XmlEventBatcher.hpp"
+#include "../Xml/include/XmlSplitParser.hpp"
+#include "../Config/include/ConfigParser.hpp"
+#include "../Config/include/ConfigEventBatcher.hpp"
+#include "../Config/include/ConfigSink.hpp"
+#include "../Config/include/ConfigSplitParser.hpp"
+
+#include "Counters.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Bytes given to XmlParser::Feed at once.
+const size_t s_feedSize = 64 * 1024;
+
+/// Chars in each piece the split parsers give to a thread.
+const unsigned long s_splitSize = 16 * 1024;
+
+/// Events in the array of the event buffer, and in each of its batches.
+const unsigned long s_eventCapacity = 1024;
+const unsigned long s_eventBatchSize = 256;
+
+// ----------------------------------------------------------------------------
+
+/** @class EventCounter
+ Receives content from every parse call and only counts the calls, so the
+ results show the cost of parsing and not the cost of using the content.  It
+ also counts the events in each batch from an event buffer.
+ */
+class EventCounter : public ICommentReceiver, public IExternalIdReceiver,
+    public IAttributeReceiver, public IEnumeratedTypeReceiver,
+    public IEntityValueReceiver, public IXmlDeclarationReceiver,
+    public IAttListDeclReceiver, public INodeReceiver, public IDocumentReceiver,
+    public IConfigReceiver, public IParseErrorReceiver, public IEventBatchReceiver
+{
+public:
+
+    EventCounter( void ) : m_events( 0 ), m_messages( 0 ) {}
+
+    virtual ~EventCounter( void ) {}
+
+    inline void Reset( void )
+    {
+        m_events = 0;
+        m_messages = 0;
+    }
+
+    inline unsigned long GetEvents( void ) const { return m_events; }
+
+    inline unsigned long GetMessages( void ) const { return m_messages; }
+
+    /// Adds calls counted by a sink which is not this.
+    inline void AddEvents( unsigned long count ) { m_events += count; }
+
+    /// Returns this as a reference receiver.  This has two bases of that type.
+    inline IReferenceReceiver * AsReferenceReceiver( void )
+    {
+        return static_cast< IAttributeValueReceiver * >( this );
+    }
+
+    virtual bool AddComment( const char *, const char * ) { return Count(); }
+
+    virtual bool SetPublicIdLiteral( const char *, const char *, bool ) { return Count(); }
+
+    virtual bool SetSystemLiteral( const char *, const char *, bool ) { return Count(); }
+
+    virtual void DoneExternalIdLiteral( bool, const char *, const char * ) { Count(); }
+
+    virtual bool SetName( const char *, const char * ) { return Count(); }
+
+    virtual bool AddPeReference( const char *, const char * ) { return Count(); }
+
+    virtual bool AddReference( const char *, const char *, RefType ) { return Count(); }
+
+    virtual bool AddValue( const char *, const char * ) { return Count(); }
+
+    virtual void DoneAttributeValue( bool, bool, const char *, const char * ) { Count(); }
+
+    virtual bool AddNotation( const char *, const char * ) { return Count(); }
+
+    virtual bool AddEnumeration( const char *, const char * ) { return Count(); }
+
+    virtual void DoneEnumeratedType( bool, const char *, const char * ) { Count(); }
+
+    virtual void DoneEntityValue( bool, bool, const char *, const char * ) { Count(); }
+
+    virtual bool SetEncName( const char *, const char * ) { return Count(); }
+
+    virtual void DoneEncodingDecl( bool, bool, const char *, const char * ) { Count(); }
+
+    virtual bool SetVersionNumber( bool, const char *, const char * ) { return Count(); }
+
+    virtual bool SetIsStandalone( bool, bool ) { return Count(); }
+
+    virtual void DoneXmlDeclaration( bool, const char *, const char * ) { Count(); }
+
+    virtual bool SetAttName( const char *, const char * ) { return Count(); }
+
+    virtual bool AddNotateName( const char *, const char * ) { return Count(); }
+
+    virtual bool SetAttType( AttType ) { return Count(); }
+
+    virtual bool SetDefaultDeclType( DefaultDeclType ) { return Count(); }
+
+    virtual IAttributeValueReceiver * AddAttributeValue( void )
+    {
+        Count();
+        return this;
+    }
+
+    virtual IEnumeratedTypeReceiver * AddEnumeratedType( void )
+    {
+        Count();
+        return this;
+    }
+
+    virtual void DoneAttListDecl( bool, const char *, const char * ) { Count(); }
+
+    virtual bool SetTagName( const char *, const char * ) { return Count(); }
+
+    virtual bool SetElementName( const char *, const char * ) { return Count(); }
+
+    virtual bool AddCData( const char *, const char * ) { return Count(); }
+
+    virtual bool SetAttributeName( const char *, const char * ) { return Count(); }
+
+    virtual bool SetAttributeValue( const char *, const char * ) { return Count(); }
+
+    virtual INodeReceiver * AddChild( void )
+    {
+        Count();
+        return this;
+    }
+
+    virtual bool DoneNode( bool, const char *, const char * ) { return Count(); }
+
+    virtual INodeReceiver * AddRoot( void )
+    {
+        Count();
+        return this;
+    }
+
+    virtual bool SetStandalone( bool ) { return Count(); }
+
+    virtual bool DoneDocument( bool, const char *, const char * ) { return Count(); }
+
+    virtual bool AddGlobalKey( const char *, const char *, const char *, const char * )
+    {
+        return Count();
+    }
+
+    virtual bool AddSection( const char *, const char * ) { return Count(); }
+
+    virtual bool AddSectionKey( const char *, const char *, const char *, const char * )
+    {
+        return Count();
+    }
+
+    virtual void ParsedConfigFile( bool ) { Count(); }
+
+    virtual bool TakeEvents( const ParseEvent *, unsigned long count )
+    {
+        m_events += count;
+        return true;
+    }
+
+    /// Counts message without making its text.
+    virtual bool ReceiveParseMessage( const ParseMessage & )
+    {
+        ++m_messages;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType * )
+    {
+        ++m_messages;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *,
+        unsigned long )
+    {
+        ++m_messages;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *,
+        const char *, unsigned long )
+    {
+        ++m_messages;
+        return true;
+    }
+
+private:
+
+    /// Not implemented.
+    EventCounter( const EventCounter & );
+    /// Not implemented.
+    EventCounter & operator = ( const EventCounter & );
+
+    inline bool Count( void )
+    {
+        ++m_events;
+        return true;
+    }
+
+    unsigned long m_events;
+    unsigned long m_messages;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigCounter
+ Counts config calls like EventCounter, but is a sink for ParseConfig with no
+ virtual functions, so the calls are inlined.
+ */
+class ConfigCounter
+{
+public:
+
+    ConfigCounter( void ) : m_events( 0 ) {}
+
+    inline bool AddGlobalKey( const char *, const char *, const char *, const char * )
+    {
+        return Count();
+    }
+
+    inline bool AddSection( const char *, const char * ) { return Count(); }
+
+    inline bool AddSectionKey( const char *, const char *, const char *, const char * )
+    {
+        return Count();
+    }
+
+    inline void ParsedConfigFile( bool ) { Count(); }
+
+    inline unsigned long GetEvents( void ) const { return m_events; }
+
+private:
+
+    inline bool Count( void )
+    {
+        ++m_events;
+        return true;
+    }
+
+    unsigned long m_events;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Parsers and receiver shared by all benchmarks.
+class BenchContext
+{
+public:
+
+    BenchContext( const BenchOptions & options );
+
+    XmlParser m_xml;
+    XmlSplitParser m_split;
+    ConfigParser m_config;
+    ConfigSplitParser m_configSplit;
+    EventCounter m_counter;
+    ParseEvent m_eventArray[ s_eventCapacity ];
+    /// Gives batches of events to m_counter.
+    EventBuffer m_events;
+    const char * m_fileName;
+
+private:
+
+    /// Not implemented.
+    BenchContext( const BenchContext & );
+    /// Not implemented.
+    BenchContext & operator = ( const BenchContext & );
+};
+
+// ----------------------------------------------------------------------------
+
+BenchContext::BenchContext( const BenchOptions & options ) :
+    m_xml(),
+    m_split(),
+    m_config(),
+    m_configSplit(),
+    m_counter(),
+    m_events( m_eventArray, s_eventCapacity, s_eventBatchSize, &m_counter ),
+    m_fileName( options.m_fileName )
+{
+    assert( NULL != this );
+    m_xml.SetErrorReceiver( &m_counter );
+    m_xml.SetFastScanning( options.m_fastScanning );
+    m_split.SetErrorReceiver( &m_counter );
+    m_split.SetPieceSize( s_splitSize );
+
+    ConfigParser::ParserPolicy policy;
+    policy.TrimWhiteSpace = true;
+    policy.AllowQuotedCommentInValue = true;
+    m_config.SetPolicy( policy );
+    m_config.SetMessageReceiver( &m_counter );
+    m_configSplit.SetPolicy( policy );
+    m_configSplit.SetMessageReceiver( &m_counter );
+    m_configSplit.SetPieceSize( s_splitSize );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses one piece of a corpus.  Returns true if the piece is all valid.
+typedef bool ( * ParseFunction )( BenchContext & context, const char * begin,
+    const char * end );
+
+bool ParseComment( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseComment( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParsePublicId( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParsePublicIdLiteral( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseExternalId( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseExternalId( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseName( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseName( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParsePeReference( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParsePeReference( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseReference( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseReference( begin, end,
+        context.m_counter.AsReferenceReceiver() ) );
+}
+
+bool ParseAttributeValue( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseAttributeValue( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseAttribute( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseAttribute( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseEnumeratedType( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseEnumeratedType( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseEntityValue( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseEntityValue( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseEncoding( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseEncoding( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseXmlDeclaration( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseXmlDeclaration( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseAttListDecl( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseAttListDecl( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseNode( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseNode( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseDocument( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseDocument( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseXmlFile( BenchContext & context, const char *, const char * )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseFile( context.m_fileName,
+        &context.m_counter ) );
+}
+
+/// The rules add events straight to the buffer.
+bool ParseDocumentEvents( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_xml.ParseDocument( begin, end,
+        context.m_events ) );
+}
+
+/// The batcher is the receiver, and makes an event from each call it gets.
+bool BatchDocument( BenchContext & context, const char * begin, const char * end )
+{
+    XmlEventBatcher batcher( context.m_events );
+    batcher.Begin( begin );
+    const XmlParser::ParseResults result = context.m_xml.ParseDocument( begin,
+        end, &batcher );
+    batcher.Finish( end );
+    return ( XmlParser::AllValid == result );
+}
+
+bool FeedDocument( BenchContext & context, const char * begin, const char * end )
+{
+    XmlParser & parser = context.m_xml;
+    if ( XmlParser::AllValid != parser.StartFeeding( &context.m_counter ) )
+        return false;
+    bool valid = true;
+    while ( begin < end )
+    {
+        const size_t rest = static_cast< size_t >( end - begin );
+        const char * next = begin + ( ( rest < s_feedSize ) ? rest : s_feedSize );
+        if ( XmlParser::AllValid != parser.Feed( begin, next ) )
+            valid = false;
+        begin = next;
+    }
+    if ( XmlParser::AllValid != parser.Finish() )
+        valid = false;
+    return valid;
+}
+
+bool SplitDocument( BenchContext & context, const char * begin, const char * end )
+{
+    return ( XmlParser::AllValid == context.m_split.ParseDocument( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseConfig( BenchContext & context, const char * begin, const char * end )
+{
+    return ( ConfigParser::AllValid == context.m_config.Parse( begin, end,
+        &context.m_counter ) );
+}
+
+/// The rules add events straight to the buffer.
+bool ParseConfigEvents( BenchContext & context, const char * begin, const char * end )
+{
+    return ( ConfigParser::AllValid == context.m_config.Parse( begin, end,
+        context.m_events ) );
+}
+
+/// The batcher is the receiver, and makes an event from each call it gets.
+bool BatchConfig( BenchContext & context, const char * begin, const char * end )
+{
+    ConfigEventBatcher batcher( context.m_events );
+    return ( ConfigParser::AllValid == context.m_config.Parse( begin, end,
+        &batcher ) );
+}
+
+/// The sink's calls are inlined into the loop over each batch of events.
+bool SinkConfig( BenchContext & context, const char * begin, const char * end )
+{
+    ConfigCounter counter;
+    const ConfigParser::ParseResults result = ::Parser::ParseConfig( context.m_config,
+        begin, end, counter );
+    context.m_counter.AddEvents( counter.GetEvents() );
+    return ( ConfigParser::AllValid == result );
+}
+
+bool SplitConfig( BenchContext & context, const char * begin, const char * end )
+{
+    return ( ConfigParser::AllValid == context.m_configSplit.Parse( begin, end,
+        &context.m_counter ) );
+}
+
+bool ParseConfigFile( BenchContext & context, const char *, const char * )
+{
+    return ( ConfigParser::AllValid == context.m_config.Parse( context.m_fileName,
+        &context.m_counter ) );
+}
+
+// ----------------------------------------------------------------------------
+
+struct Benchmark
+{
+    const char * m_name;
+    CorpusKind m_kind;
+    ParseFunction m_parse;
+    /// True if this parses the corpus from a file.
+    bool m_usesFile;
+};
+
+/// Benchmarks which parse the same kind of corpus are next to each other, so
+/// each corpus is made only once.
+const Benchmark s_benchmarks[] =
+{
+    { "xml.comment",         Comments,        &ParseComment,        false },
+    { "xml.public_id",       PublicIds,       &ParsePublicId,       false },
+    { "xml.external_id",     ExternalIds,     &ParseExternalId,     false },
+    { "xml.name",            Names,           &ParseName,           false },
+    { "xml.pe_reference",    PeReferences,    &ParsePeReference,    false },
+    { "xml.reference",       References,      &ParseReference,      false },
+    { "xml.attribute_value", AttributeValues, &ParseAttributeValue, false },
+    { "xml.attribute",       Attributes,      &ParseAttribute,      false },
+    { "xml.enumerated_type", EnumeratedTypes, &ParseEnumeratedType, false },
+    { "xml.entity_value",    EntityValues,    &ParseEntityValue,    false },
+    { "xml.encoding",        Encodings,       &ParseEncoding,       false },
+    { "xml.xml_declaration", XmlDeclarations, &ParseXmlDeclaration, false },
+    { "xml.attlist_decl",    AttListDecls,    &ParseAttListDecl,    false },
+    { "xml.node",            Nodes,           &ParseNode,           false },
+    { "xml.document",        XmlDocument,     &ParseDocument,       false },
+    { "xml.events",          XmlDocument,     &ParseDocumentEvents, false },
+    { "xml.batcher",         XmlDocument,     &BatchDocument,       false },
+    { "xml.feed",            XmlDocument,     &FeedDocument,        false },
+    { "xml.split",           XmlDocument,     &SplitDocument,       false },
+    { "xml.file",            XmlDocument,     &ParseXmlFile,        true  },
+    { "config.parse",        ConfigFile,      &ParseConfig,         false },
+    { "config.events",       ConfigFile,      &ParseConfigEvents,   false },
+    { "config.batcher",      ConfigFile,      &BatchConfig,         false },
+    { "config.sink",         ConfigFile,      &SinkConfig,          false },
+    { "config.split",        ConfigFile,      &SplitConfig,         false },
+    { "config.file",         ConfigFile,      &ParseConfigFile,     true  },
+};
+
+const unsigned int s_benchmarkCount = sizeof( s_benchmarks ) / sizeof( s_benchmarks[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+bool IsWanted( const BenchOptions & options, const Benchmark & benchmark )
+{
+    if ( NULL == options.m_only )
+        return true;
+    return ( 0 == ::strncmp( benchmark.m_name, options.m_only,
+        ::strlen( options.m_only ) ) );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses each piece of corpus once.  Returns count of invalid pieces.
+unsigned long DoPass( BenchContext & context, const Benchmark & benchmark,
+    const Corpus & corpus )
+{
+    unsigned long invalid = 0;
+    const unsigned long count = corpus.GetPieceCount();
+    for ( unsigned long ii = 0; ii < count; ++ii )
+    {
+        if ( !( *benchmark.m_parse )( context, corpus.GetPieceBegin( ii ),
+            corpus.GetPieceEnd( ii ) ) )
+            ++invalid;
+    }
+    return invalid;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * GetKernelName( CharFinder::Kernel kernel )
+{
+    switch ( kernel )
+    {
+        case CharFinder::Scalar: return "Scalar";
+        case CharFinder::Sse2:   return "SSE2";
+        case CharFinder::Avx2:   return "AVX2";
+        default: break;
+    }
+    return "Unknown";
+}
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+BenchOptions::BenchOptions( void ) :
+    m_corpus(),
+    m_passes( 5 ),
+    m_fastScanning( true ),
+    m_only( NULL ),
+    m_fileName( "BenchCorpus.tmp" ),
+    m_ruleReport( NULL )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+bool RunBenchmarks( const BenchOptions & options, BenchResults & results )
+{
+    assert( 0 < options.m_passes );
+    BenchContext context( options );
+    CorpusMaker maker( options.m_corpus );
+    Corpus corpus;
+    CorpusKind madeKind = CorpusKindCount;
+    bool okay = true;
+
+    for ( unsigned int bi = 0; bi < s_benchmarkCount; ++bi )
+    {
+        const Benchmark & benchmark = s_benchmarks[ bi ];
+        if ( !IsWanted( options, benchmark ) )
+            continue;
+        if ( madeKind != benchmark.m_kind )
+        {
+            maker.Make( benchmark.m_kind, corpus );
+            madeKind = benchmark.m_kind;
+        }
+        if ( benchmark.m_usesFile && !corpus.WriteFile( options.m_fileName ) )
+        {
+            cerr << "Could not write file: " << options.m_fileName << endl;
+            okay = false;
+            continue;
+        }
+
+        BenchResult result;
+        result.m_name = benchmark.m_name;
+        result.m_bytes = corpus.GetText().size();
+        result.m_pieces = corpus.GetPieceCount();
+
+        // First pass is not timed.  It counts events, and lets the parsers
+        // make anything they make only on first use.
+        context.m_counter.Reset();
+        RuleProfile::Reset();
+        result.m_invalid = DoPass( context, benchmark, corpus );
+        result.m_events = context.m_counter.GetEvents();
+        result.m_messages = context.m_counter.GetMessages();
+        if ( NULL != options.m_ruleReport )
+        {
+            *options.m_ruleReport << "# Rules for " << benchmark.m_name << "\n";
+            RuleProfile::Write( *options.m_ruleReport );
+        }
+
+        HeapCounts::Reset();
+        const double start = GetSeconds();
+        for ( unsigned int pass = 0; pass < options.m_passes; ++pass )
+            DoPass( context, benchmark, corpus );
+        result.m_seconds = GetSeconds() - start;
+        const HeapCounts heap = HeapCounts::Get();
+
+        result.m_allocations = heap.m_allocations / options.m_passes;
+        result.m_allocatedBytes = heap.m_bytes / options.m_passes;
+        result.m_peakHeap = heap.m_peakBytes;
+        result.m_peakRss = GetPeakRss();
+        results.push_back( result );
+
+        if ( benchmark.m_usesFile )
+            ::remove( options.m_fileName );
+        if ( 0 != result.m_invalid )
+            okay = false;
+    }
+
+    return okay;
+}
+
+// ----------------------------------------------------------------------------
+
+bool WriteCorpora( const BenchOptions & options, const char * prefix )
+{
+    CorpusMaker maker( options.m_corpus );
+    Corpus corpus;
+    CorpusKind madeKind = CorpusKindCount;
+    bool okay = true;
+
+    for ( unsigned int bi = 0; bi < s_benchmarkCount; ++bi )
+    {
+        const Benchmark & benchmark = s_benchmarks[ bi ];
+        if ( !IsWanted( options, benchmark ) || ( madeKind == benchmark.m_kind ) )
+            continue;
+        maker.Make( benchmark.m_kind, corpus );
+        madeKind = benchmark.m_kind;
+        string filename( prefix );
+        filename += CorpusMaker::GetKindName( benchmark.m_kind );
+        filename += ( ConfigFile == benchmark.m_kind ) ? ".ini" : ".xml";
+        if ( !corpus.WriteFile( filename.c_str() ) )
+        {
+            cerr << "Could not write file: " << filename << endl;
+            okay = false;
+        }
+    }
+
+    return okay;
+}
+
+// ----------------------------------------------------------------------------
+
+void WriteResults( ostream & out, const BenchOptions & options,
+    const BenchResults & results )
+{
+    const CorpusSettings & corpus = options.m_corpus;
+    out << "# Parser benchmarks, version " << ConfigParser::GetMajorVersion()
+        << '.' << ConfigParser::GetMinorVersion() << "\n";
+    out << "# size=" << corpus.m_size
+        << " comments=" << corpus.m_commentPercent
+        << " section_keys=" << corpus.m_sectionKeys
+        << " attributes=" << corpus.m_attributes
+        << " seed=" << corpus.m_seed
+        << " passes=" << options.m_passes
+        << " fast=" << ( options.m_fastScanning ? 1 : 0 )
+        << " kernel=" << GetKernelName( CharFinder::GetKernel() ) << "\n";
+    out << "name,bytes,pieces,invalid,messages,seconds,mb_per_s,events,"
+        "events_per_s,allocations,allocated_bytes,peak_heap,peak_rss_kb\n";
+
+    const ios::fmtflags oldFlags = out.flags();
+    out << fixed;
+    for ( BenchResults::const_iterator it( results.begin() ); it != results.end(); ++it )
+    {
+        const BenchResult & result = *it;
+        const double passes = static_cast< double >( options.m_passes );
+        // Timer may not be fine enough to see a tiny corpus parsed once.
+        const double seconds = ( 0.0 < result.m_seconds ) ? result.m_seconds : 1.0e-6;
+        const double megabytes = static_cast< double >( result.m_bytes ) * passes / 1.0e6;
+        const double events = static_cast< double >( result.m_events ) * passes;
+        out << result.m_name
+            << ',' << result.m_bytes
+            << ',' << result.m_pieces
+            << ',' << result.m_invalid
+            << ',' << result.m_messages
+            << ',' << setprecision( 6 ) << result.m_seconds
+            << ',' << setprecision( 3 ) << ( megabytes / seconds )
+            << ',' << result.m_events
+            << ',' << setprecision( 0 ) << ( events / seconds )
+            << ',' << result.m_allocations
+            << ',' << setprecision( 0 ) << result.m_allocatedBytes
+            << ',' << result.m_peakHeap
+            << ',' << result.m_peakRss
+            << "\n";
+    }
+    out.flags( oldFlags );
+    out.flush();
+}
+
+// ----------------------------------------------------------------------------
+
+void WriteBenchmarkNames( ostream & out )
+{
+    for ( unsigned int bi = 0; bi < s_benchmarkCount; ++bi )
+        out << s_benchmarks[ bi ].m_name << "\n";
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file Benchmarks.hpp Times each parse call of XmlParser and ConfigParser.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_BENCH_BENCHMARKS_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_BENCH_BENCHMARKS_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <iosfwd>
+#include <vector>
+
+#include "CorpusMaker.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+/// Choices for a run of benchmarks.
+struct BenchOptions
+{
+    CorpusSettings m_corpus;
+    /// Times each corpus is parsed while timing.
+    unsigned int m_passes;
+    /// False to parse xml with Spirit rules only.
+    bool m_fastScanning;
+    /// Only run benchmarks whose names start with this, or all if NULL.
+    const char * m_only;
+    /// File written for benchmarks which parse files.  Removed when done.
+    const char * m_fileName;
+    /// Where to write counts for each grammar rule from the untimed pass of
+    /// each benchmark, or NULL to not write them.  See RuleProfile.
+    ::std::ostream * m_ruleReport;
+
+    BenchOptions( void );
+};
+
+// ----------------------------------------------------------------------------
+
+/// What one benchmark measured.  Counts are for one pass over the corpus.
+struct BenchResult
+{
+    const char * m_name;
+    /// Bytes in the corpus.
+    size_t m_bytes;
+    /// Parse calls made for each pass.
+    unsigned long m_pieces;
+    /// Parse calls which did not give AllValid.
+    unsigned long m_invalid;
+    /// Calls to content receivers.
+    unsigned long m_events;
+    /// Calls to error receiver.
+    unsigned long m_messages;
+    /// Seconds taken by all passes.
+    double m_seconds;
+    unsigned long m_allocations;
+    double m_allocatedBytes;
+    /// Most heap used at once while parsing, beyond what was used before.
+    size_t m_peakHeap;
+    /// Most memory in RAM since program started, in KB.
+    unsigned long m_peakRss;
+};
+
+typedef ::std::vector< BenchResult > BenchResults;
+
+// ----------------------------------------------------------------------------
+
+/** Runs each benchmark named by the options, and adds what it measured to the
+ results.  Each benchmark makes its corpus, parses it once to count events and
+ warm caches, and then times the passes.
+ @return False if any benchmark could not run, or if any piece was invalid.
+ */
+bool RunBenchmarks( const BenchOptions & options, BenchResults & results );
+
+/** Writes the corpus each benchmark named by the options would parse into a
+ file named by the prefix and the kind of corpus.
+ @return False if any file could not be written.
+ */
+bool WriteCorpora( const BenchOptions & options, const char * prefix );
+
+/** Writes results as comma separated values, one line for each benchmark,
+ after comment lines starting with # which tell how the results were made.
+ */
+void WriteResults( ::std::ostream & out, const BenchOptions & options,
+    const BenchResults & results );
+
+/// Writes name of each benchmark on its own line.
+void WriteBenchmarkNames( ::std::ostream & out );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
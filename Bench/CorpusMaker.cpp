@@ -0,0 +1,647 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file CorpusMaker.cpp Makes made-up xml and config text to parse.
+
+
+// ----------------------------------------------------------------------------
+
+#include "CorpusMaker.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+
+namespace
+{
+
+const char * const s_kindNames[] =
+{
+    "xml.comment",
+    "xml.public_id",
+    "xml.external_id",
+    "xml.name",
+    "xml.pe_reference",
+    "xml.reference",
+    "xml.attribute_value",
+    "xml.attribute",
+    "xml.enumerated_type",
+    "xml.entity_value",
+    "xml.encoding",
+    "xml.xml_declaration",
+    "xml.attlist_decl",
+    "xml.node",
+    "xml.document",
+    "config.file",
+};
+
+const char * const s_encodings[] =
+{
+    "UTF-8", "UTF-16", "ISO-8859-1", "windows-1252", "US-ASCII", "Shift_JIS",
+};
+
+const unsigned int s_encodingCount = sizeof( s_encodings ) / sizeof( s_encodings[ 0 ] );
+
+const char * const s_attTypes[] =
+{
+    "CDATA", "ID", "IDREF", "IDREFS", "ENTITY", "ENTITIES", "NMTOKEN", "NMTOKENS",
+};
+
+const unsigned int s_attTypeCount = sizeof( s_attTypes ) / sizeof( s_attTypes[ 0 ] );
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+CorpusSettings::CorpusSettings( void ) :
+    m_size( 1024 * 1024 ),
+    m_commentPercent( 10 ),
+    m_sectionKeys( 8 ),
+    m_attributes( 3 ),
+    m_seed( 12345 )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+Corpus::Corpus( void ) :
+    m_text(),
+    m_ends()
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void Corpus::Clear( void )
+{
+    assert( NULL != this );
+    m_text.clear();
+    m_ends.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void Corpus::EndPiece( void )
+{
+    assert( NULL != this );
+    m_ends.push_back( m_text.size() );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * Corpus::GetPieceBegin( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_ends.size() );
+    const size_t offset = ( 0 == index ) ? 0 : m_ends[ index - 1 ];
+    return m_text.data() + offset;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * Corpus::GetPieceEnd( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_ends.size() );
+    return m_text.data() + m_ends[ index ];
+}
+
+// ----------------------------------------------------------------------------
+
+bool Corpus::WriteFile( const char * filename ) const
+{
+    assert( NULL != this );
+    FILE * file = ::fopen( filename, "wb" );
+    if ( NULL == file )
+        return false;
+    const size_t written = ::fwrite( m_text.data(), 1, m_text.size(), file );
+    const bool closed = ( 0 == ::fclose( file ) );
+    return ( closed && ( written == m_text.size() ) );
+}
+
+// ----------------------------------------------------------------------------
+
+CorpusMaker::CorpusMaker( const CorpusSettings & settings ) :
+    m_settings( settings ),
+    m_seed( settings.m_seed )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * CorpusMaker::GetKindName( CorpusKind kind )
+{
+    assert( kind < CorpusKindCount );
+    return s_kindNames[ kind ];
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned int CorpusMaker::Next( void )
+{
+    assert( NULL != this );
+    // Keep only 32 bits so platforms with 64 bit longs make the same numbers.
+    m_seed = ( m_seed * 1103515245UL + 12345UL ) & 0xFFFFFFFFUL;
+    return static_cast< unsigned int >( ( m_seed >> 16 ) & 0x7FFF );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CorpusMaker::IsComment( void )
+{
+    assert( NULL != this );
+    return ( Pick( 100 ) < m_settings.m_commentPercent );
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddWord( string & text )
+{
+    assert( NULL != this );
+    const unsigned int length = 2 + Pick( 8 );
+    for ( unsigned int ii = 0; ii < length; ++ii )
+        text += static_cast< char >( 'a' + Pick( 26 ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddName( string & text )
+{
+    assert( NULL != this );
+    AddWord( text );
+    switch ( Pick( 6 ) )
+    {
+        case 0: text += '_'; AddWord( text ); break;
+        case 1: text += '.'; AddWord( text ); break;
+        case 2: text += '-'; AddNumber( text, Pick( 100 ) ); break;
+        default: break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddNumber( string & text, unsigned long number )
+{
+    assert( NULL != this );
+    char buffer[ 24 ];
+    ::sprintf( buffer, "%lu", number );
+    text += buffer;
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddWords( string & text, unsigned int most )
+{
+    assert( NULL != this );
+    const unsigned int count = 1 + Pick( most );
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        if ( 0 != ii )
+            text += ' ';
+        AddWord( text );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddReference( string & text )
+{
+    assert( NULL != this );
+    static const char s_hexDigits[] = "0123456789ABCDEF";
+    switch ( Pick( 4 ) )
+    {
+        case 0:
+            text += "&#";
+            AddNumber( text, 32 + Pick( 95 ) );
+            break;
+        case 1:
+            text += "&#x";
+            text += s_hexDigits[ 2 + Pick( 6 ) ];
+            text += s_hexDigits[ Pick( 16 ) ];
+            break;
+        default:
+            text += '&';
+            AddName( text );
+            break;
+    }
+    text += ';';
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddCharData( string & text )
+{
+    assert( NULL != this );
+    const unsigned int count = 1 + Pick( 4 );
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        if ( 0 != ii )
+            text += ' ';
+        if ( 0 == Pick( 4 ) )
+            AddReference( text );
+        else
+            AddWords( text, 6 );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddAttributeValue( string & text )
+{
+    assert( NULL != this );
+    const char quote = ( 0 == Pick( 3 ) ) ? '\'' : '"';
+    text += quote;
+    const unsigned int count = Pick( 4 );
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        if ( 0 != ii )
+            text += ' ';
+        if ( 0 == Pick( 5 ) )
+            AddReference( text );
+        else
+            AddWords( text, 3 );
+    }
+    text += quote;
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddAttributes( string & text )
+{
+    assert( NULL != this );
+    const unsigned int count = Pick( m_settings.m_attributes + 1 );
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        text += ' ';
+        // Number on the end keeps names within one element apart.
+        AddWord( text );
+        AddNumber( text, ii );
+        text += '=';
+        AddAttributeValue( text );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddXmlComment( string & text )
+{
+    assert( NULL != this );
+    text += "<!-- ";
+    AddWords( text, 16 );
+    if ( 0 == Pick( 4 ) )
+    {
+        text += " - ";
+        AddWords( text, 4 );
+    }
+    text += " -->";
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddExternalId( string & text )
+{
+    assert( NULL != this );
+    if ( 0 == Pick( 2 ) )
+    {
+        text += "PUBLIC \"-//";
+        AddWord( text );
+        text += "//DTD ";
+        AddWords( text, 3 );
+        text += "//EN\" ";
+    }
+    else
+        text += "SYSTEM ";
+    text += "'http://www.";
+    AddWord( text );
+    text += ".com/";
+    AddWord( text );
+    text += '/';
+    AddName( text );
+    text += ".dtd'";
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddEnumeratedType( string & text )
+{
+    assert( NULL != this );
+    if ( 0 == Pick( 3 ) )
+        text += "NOTATION ";
+    text += '(';
+    const unsigned int count = 1 + Pick( 5 );
+    for ( unsigned int ii = 0; ii < count; ++ii )
+    {
+        if ( 0 != ii )
+            text += ( 0 == Pick( 2 ) ) ? "|" : " | ";
+        AddName( text );
+    }
+    text += ')';
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddXmlDeclaration( string & text )
+{
+    assert( NULL != this );
+    text += "<?xml version=\"1.0\"";
+    if ( 0 != Pick( 4 ) )
+    {
+        text += " encoding=\"";
+        text += s_encodings[ Pick( s_encodingCount ) ];
+        text += '"';
+    }
+    switch ( Pick( 3 ) )
+    {
+        case 0: text += " standalone='yes'"; break;
+        case 1: text += " standalone='no'"; break;
+        default: break;
+    }
+    text += "?>";
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddElement( string & text, unsigned int depth )
+{
+    assert( NULL != this );
+    string name;
+    AddName( name );
+    text += '<';
+    text += name;
+    AddAttributes( text );
+    if ( 0 == depth )
+    {
+        if ( 0 == Pick( 4 ) )
+        {
+            text += "/>";
+            return;
+        }
+        text += '>';
+        AddCharData( text );
+    }
+    else
+    {
+        text += '>';
+        const unsigned int count = 1 + Pick( 4 );
+        for ( unsigned int ii = 0; ii < count; ++ii )
+        {
+            text += "\n";
+            if ( IsComment() )
+                AddXmlComment( text );
+            else switch ( Pick( 16 ) )
+            {
+                case 0:
+                    text += "<![CDATA[ <";
+                    AddWords( text, 6 );
+                    text += "> & ]]>";
+                    break;
+                case 1:
+                    text += "<?bench ";
+                    AddWords( text, 4 );
+                    text += "?>";
+                    break;
+                case 2:
+                case 3:
+                case 4:
+                    AddCharData( text );
+                    break;
+                default:
+                    AddElement( text, depth - 1 );
+                    break;
+            }
+        }
+        text += "\n";
+    }
+    text += "</";
+    text += name;
+    text += '>';
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::AddPiece( CorpusKind kind, string & text )
+{
+    assert( NULL != this );
+    const char quote = ( 0 == Pick( 2 ) ) ? '\'' : '"';
+    switch ( kind )
+    {
+        case Comments:
+            AddXmlComment( text );
+            break;
+        case PublicIds:
+            text += quote;
+            AddWords( text, 6 );
+            text += quote;
+            break;
+        case ExternalIds:
+            AddExternalId( text );
+            break;
+        case Names:
+            AddName( text );
+            break;
+        case PeReferences:
+            text += '%';
+            AddName( text );
+            text += ';';
+            break;
+        case References:
+            AddReference( text );
+            break;
+        case AttributeValues:
+            AddAttributeValue( text );
+            break;
+        case Attributes:
+            AddName( text );
+            text += ( 0 == Pick( 4 ) ) ? " = " : "=";
+            AddAttributeValue( text );
+            break;
+        case EnumeratedTypes:
+            AddEnumeratedType( text );
+            break;
+        case EntityValues:
+        {
+            text += quote;
+            const unsigned int count = 1 + Pick( 4 );
+            for ( unsigned int ii = 0; ii < count; ++ii )
+            {
+                switch ( Pick( 4 ) )
+                {
+                    case 0: AddReference( text ); break;
+                    case 1: text += '%'; AddName( text ); text += ';'; break;
+                    default: AddWords( text, 4 ); break;
+                }
+            }
+            text += quote;
+            break;
+        }
+        case Encodings:
+            text += "encoding=";
+            text += quote;
+            text += s_encodings[ Pick( s_encodingCount ) ];
+            text += quote;
+            break;
+        case XmlDeclarations:
+            AddXmlDeclaration( text );
+            break;
+        case AttListDecls:
+            text += "<!ATTLIST ";
+            AddName( text );
+            text += ' ';
+            AddName( text );
+            text += ' ';
+            if ( 0 == Pick( 4 ) )
+                AddEnumeratedType( text );
+            else
+                text += s_attTypes[ Pick( s_attTypeCount ) ];
+            switch ( Pick( 4 ) )
+            {
+                case 0: text += " #REQUIRED"; break;
+                case 1: text += " #IMPLIED"; break;
+                case 2: text += " #FIXED "; AddAttributeValue( text ); break;
+                default: text += ' '; AddAttributeValue( text ); break;
+            }
+            text += '>';
+            break;
+        case Nodes:
+            AddElement( text, 2 );
+            break;
+        default:
+            assert( false );
+            break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::MakeXmlDocument( Corpus & corpus )
+{
+    assert( NULL != this );
+    string & text = corpus.GetText();
+    AddXmlDeclaration( text );
+    text += "\n";
+    if ( IsComment() )
+    {
+        AddXmlComment( text );
+        text += "\n";
+    }
+    text += "<corpus>\n";
+    while ( text.size() + 10 < m_settings.m_size )
+    {
+        if ( IsComment() )
+            AddXmlComment( text );
+        else
+            AddElement( text, 3 );
+        text += "\n";
+    }
+    text += "</corpus>\n";
+    corpus.EndPiece();
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::MakeConfigFile( Corpus & corpus )
+{
+    assert( NULL != this );
+    string & text = corpus.GetText();
+    text += "; Made-up config file.\n";
+    unsigned long section = 0;
+    unsigned int keys = 1 + Pick( 4 );
+    while ( text.size() < m_settings.m_size )
+    {
+        for ( unsigned int ii = 0; ii < keys; ++ii )
+        {
+            if ( IsComment() )
+            {
+                if ( 0 == Pick( 2 ) )
+                {
+                    text += "; ";
+                    AddWords( text, 12 );
+                }
+                else
+                {
+                    text += "/* ";
+                    AddWords( text, 12 );
+                    text += " */";
+                }
+                text += "\n";
+                continue;
+            }
+            AddName( text );
+            switch ( Pick( 8 ) )
+            {
+                case 0:
+                    break;
+                case 1:
+                    text += " = \"";
+                    AddWords( text, 4 );
+                    text += " ; ";
+                    AddWords( text, 2 );
+                    text += '"';
+                    break;
+                case 2:
+                    text += " = ";
+                    AddWords( text, 4 );
+                    text += " ; ";
+                    AddWords( text, 6 );
+                    break;
+                default:
+                    text += ( 0 == Pick( 2 ) ) ? " = " : "=";
+                    AddWords( text, 6 );
+                    break;
+            }
+            text += "\n";
+        }
+        text += "\n[section_";
+        AddNumber( text, section++ );
+        text += "]\n";
+        keys = m_settings.m_sectionKeys;
+    }
+    corpus.EndPiece();
+}
+
+// ----------------------------------------------------------------------------
+
+void CorpusMaker::Make( CorpusKind kind, Corpus & corpus )
+{
+    assert( NULL != this );
+    assert( kind < CorpusKindCount );
+    corpus.Clear();
+    corpus.GetText().reserve( m_settings.m_size + 1024 );
+    m_seed = m_settings.m_seed;
+    if ( XmlDocument == kind )
+        MakeXmlDocument( corpus );
+    else if ( ConfigFile == kind )
+        MakeConfigFile( corpus );
+    else
+    {
+        string & text = corpus.GetText();
+        while ( text.size() < m_settings.m_size )
+        {
+            AddPiece( kind, text );
+            corpus.EndPiece();
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file CorpusMaker.hpp Makes made-up xml and config text to parse.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_BENCH_CORPUS_MAKER_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_BENCH_CORPUS_MAKER_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+/// Choices which shape a made-up corpus.
+struct CorpusSettings
+{
+    /// Bytes of text to make.  The last item may go a little past this.
+    size_t m_size;
+    /// Percent of items which are comments, from 0 through 100.
+    unsigned int m_commentPercent;
+    /// Keys in each config section.  Fewer keys make more sections.
+    unsigned int m_sectionKeys;
+    /// Most attributes in each xml element.
+    unsigned int m_attributes;
+    /// First random number.  The same settings always make the same corpus.
+    unsigned long m_seed;
+
+    CorpusSettings( void );
+};
+
+// ----------------------------------------------------------------------------
+
+/// Kinds of text a CorpusMaker makes, one for each kind of parse call.
+enum CorpusKind
+{
+    Comments = 0,
+    PublicIds,
+    ExternalIds,
+    Names,
+    PeReferences,
+    References,
+    AttributeValues,
+    Attributes,
+    EnumeratedTypes,
+    EntityValues,
+    Encodings,
+    XmlDeclarations,
+    AttListDecls,
+    Nodes,
+    XmlDocument,
+    ConfigFile,
+    CorpusKindCount
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class Corpus
+ Text to parse, split into pieces which are each given to one parse call.  A
+ document or config file is one piece, and a corpus of names or references is
+ many small pieces laid end to end.
+ */
+class Corpus
+{
+public:
+
+    Corpus( void );
+
+    void Clear( void );
+
+    /// Returns all the text.
+    inline const ::std::string & GetText( void ) const { return m_text; }
+
+    /// Returns place to add text to the current piece.
+    inline ::std::string & GetText( void ) { return m_text; }
+
+    /// Ends the current piece, so later text goes into a new piece.
+    void EndPiece( void );
+
+    inline unsigned long GetPieceCount( void ) const
+    {
+        return static_cast< unsigned long >( m_ends.size() );
+    }
+
+    const char * GetPieceBegin( unsigned long index ) const;
+
+    const char * GetPieceEnd( unsigned long index ) const;
+
+    /// Writes all the text to a file.  Returns false if it could not.
+    bool WriteFile( const char * filename ) const;
+
+private:
+
+    /// Not implemented.
+    Corpus( const Corpus & );
+    /// Not implemented.
+    Corpus & operator = ( const Corpus & );
+
+    ::std::string m_text;
+    /// Offset just past the end of each piece.
+    ::std::vector< size_t > m_ends;
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class CorpusMaker
+ Makes text which the parsers find valid, with names, values, and comments
+ picked at random.  Random numbers come from a simple generator which acts
+ the same on every platform, so the same settings make the same corpus
+ everywhere, and results from different builds may be compared.
+ */
+class CorpusMaker
+{
+public:
+
+    explicit CorpusMaker( const CorpusSettings & settings );
+
+    /// Returns name used for the kind in results and file names.
+    static const char * GetKindName( CorpusKind kind );
+
+    /// Replaces contents of corpus with text of the kind.
+    void Make( CorpusKind kind, Corpus & corpus );
+
+private:
+
+    /// Not implemented.
+    CorpusMaker( void );
+    /// Not implemented.
+    CorpusMaker( const CorpusMaker & );
+    /// Not implemented.
+    CorpusMaker & operator = ( const CorpusMaker & );
+
+    /// Returns a number from 0 through 0x7FFF.
+    unsigned int Next( void );
+
+    /// Returns a number from 0 up to but not including count.
+    inline unsigned int Pick( unsigned int count )
+    {
+        return ( 0 == count ) ? 0 : ( Next() % count );
+    }
+
+    /// Returns true as often as the settings say the next item is a comment.
+    bool IsComment( void );
+
+    void AddWord( ::std::string & text );
+
+    void AddName( ::std::string & text );
+
+    void AddNumber( ::std::string & text, unsigned long number );
+
+    /// Adds between one and most words with spaces between them.
+    void AddWords( ::std::string & text, unsigned int most );
+
+    void AddReference( ::std::string & text );
+
+    void AddCharData( ::std::string & text );
+
+    void AddAttributeValue( ::std::string & text );
+
+    void AddAttributes( ::std::string & text );
+
+    void AddXmlComment( ::std::string & text );
+
+    void AddExternalId( ::std::string & text );
+
+    void AddEnumeratedType( ::std::string & text );
+
+    void AddXmlDeclaration( ::std::string & text );
+
+    void AddElement( ::std::string & text, unsigned int depth );
+
+    /// Adds one piece of a kind which is parsed as many small pieces.
+    void AddPiece( CorpusKind kind, ::std::string & text );
+
+    void MakeXmlDocument( Corpus & corpus );
+
+    void MakeConfigFile( Corpus & corpus );
+
+    const CorpusSettings m_settings;
+    unsigned long m_seed;
+
+};
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
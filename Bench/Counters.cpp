@@ -0,0 +1,211 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file Counters.cpp Measures time, heap use, and memory use of this program.
+
+
+// ----------------------------------------------------------------------------
+
+#include "Counters.hpp"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <new>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+    #include <psapi.h>
+    #if defined( _MSC_VER )
+        #pragma comment( lib, "psapi.lib" )
+    #endif
+#else
+    #include <sys/time.h>
+    #include <sys/resource.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Room before each block for its size.  Big enough to keep blocks aligned.
+const size_t s_headerSize = 16;
+
+unsigned long s_allocations = 0;
+double s_allocatedBytes = 0.0;
+size_t s_bytesInUse = 0;
+size_t s_bytesAtReset = 0;
+size_t s_peakBytes = 0;
+
+// ----------------------------------------------------------------------------
+
+void * Allocate( size_t size )
+{
+    void * place = ::malloc( size + s_headerSize );
+    if ( NULL == place )
+        return NULL;
+    *static_cast< size_t * >( place ) = size;
+    ++s_allocations;
+    s_allocatedBytes += static_cast< double >( size );
+    s_bytesInUse += size;
+    if ( s_peakBytes < s_bytesInUse )
+        s_peakBytes = s_bytesInUse;
+    return static_cast< char * >( place ) + s_headerSize;
+}
+
+// ----------------------------------------------------------------------------
+
+void Release( void * block )
+{
+    if ( NULL == block )
+        return;
+    char * place = static_cast< char * >( block ) - s_headerSize;
+    s_bytesInUse -= *reinterpret_cast< size_t * >( place );
+    ::free( place );
+}
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+void * operator new ( size_t size ) throw ( ::std::bad_alloc )
+{
+    void * block = Allocate( size );
+    if ( NULL == block )
+        throw ::std::bad_alloc();
+    return block;
+}
+
+// ----------------------------------------------------------------------------
+
+void * operator new [] ( size_t size ) throw ( ::std::bad_alloc )
+{
+    void * block = Allocate( size );
+    if ( NULL == block )
+        throw ::std::bad_alloc();
+    return block;
+}
+
+// ----------------------------------------------------------------------------
+
+void * operator new ( size_t size, const ::std::nothrow_t & ) throw ()
+{
+    return Allocate( size );
+}
+
+// ----------------------------------------------------------------------------
+
+void * operator new [] ( size_t size, const ::std::nothrow_t & ) throw ()
+{
+    return Allocate( size );
+}
+
+// ----------------------------------------------------------------------------
+
+void operator delete ( void * block ) throw ()
+{
+    Release( block );
+}
+
+// ----------------------------------------------------------------------------
+
+void operator delete [] ( void * block ) throw ()
+{
+    Release( block );
+}
+
+// ----------------------------------------------------------------------------
+
+void operator delete ( void * block, const ::std::nothrow_t & ) throw ()
+{
+    Release( block );
+}
+
+// ----------------------------------------------------------------------------
+
+void operator delete [] ( void * block, const ::std::nothrow_t & ) throw ()
+{
+    Release( block );
+}
+
+// ----------------------------------------------------------------------------
+
+HeapCounts HeapCounts::Get( void )
+{
+    HeapCounts counts;
+    counts.m_allocations = s_allocations;
+    counts.m_bytes = s_allocatedBytes;
+    counts.m_peakBytes = ( s_bytesAtReset < s_peakBytes )
+        ? ( s_peakBytes - s_bytesAtReset ) : 0;
+    return counts;
+}
+
+// ----------------------------------------------------------------------------
+
+void HeapCounts::Reset( void )
+{
+    s_allocations = 0;
+    s_allocatedBytes = 0.0;
+    s_bytesAtReset = s_bytesInUse;
+    s_peakBytes = s_bytesInUse;
+}
+
+// ----------------------------------------------------------------------------
+
+double GetSeconds( void )
+{
+#if defined( _WIN32 )
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    ::QueryPerformanceFrequency( &frequency );
+    ::QueryPerformanceCounter( &now );
+    return static_cast< double >( now.QuadPart )
+        / static_cast< double >( frequency.QuadPart );
+#else
+    timeval now;
+    ::gettimeofday( &now, NULL );
+    return static_cast< double >( now.tv_sec )
+        + static_cast< double >( now.tv_usec ) / 1000000.0;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long GetPeakRss( void )
+{
+#if defined( _WIN32 )
+    PROCESS_MEMORY_COUNTERS counters;
+    if ( !::GetProcessMemoryInfo( ::GetCurrentProcess(), &counters,
+        sizeof( counters ) ) )
+        return 0;
+    return static_cast< unsigned long >( counters.PeakWorkingSetSize / 1024 );
+#else
+    rusage usage;
+    if ( 0 != ::getrusage( RUSAGE_SELF, &usage ) )
+        return 0;
+    #if defined( __APPLE__ )
+        // Mac OS gives bytes where other systems give KB.
+        return static_cast< unsigned long >( usage.ru_maxrss / 1024 );
+    #else
+        return static_cast< unsigned long >( usage.ru_maxrss );
+    #endif
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file Counters.hpp Measures time, heap use, and memory use of this program.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_BENCH_COUNTERS_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_BENCH_COUNTERS_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <stddef.h>
+
+
+// ----------------------------------------------------------------------------
+
+/// Returns a time in seconds, only useful for finding elapsed times.
+double GetSeconds( void );
+
+/// Returns most memory this program has had in RAM since it started, in KB.
+unsigned long GetPeakRss( void );
+
+// ----------------------------------------------------------------------------
+
+/** @struct HeapCounts
+ Counts of calls to operator new since the counts were last reset.  This
+ program replaces the global operator new and delete so every allocation made
+ by the parsers and the standard library is counted.  The counters are not
+ locked, so they are only right while one thread allocates.
+ */
+struct HeapCounts
+{
+    /// Calls to any form of operator new.
+    unsigned long m_allocations;
+    /// Total bytes asked for by those calls.
+    double m_bytes;
+    /// Most bytes in use at once, beyond what was in use when reset.
+    size_t m_peakBytes;
+
+    /// Returns counts since Reset was last called.
+    static HeapCounts Get( void );
+
+    /// Starts counting again from zero.
+    static void Reset( void );
+};
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
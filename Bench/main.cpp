@@ -0,0 +1,231 @@
+// ----------------------------------------------------------------------------
+// Parser Benchmarks
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file main.cpp Measures how fast the parsers parse made-up text.
+
+
+// ----------------------------------------------------------------------------
+// Include Files
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+
+#include "../Util/include/RuleProfile.hpp"
+
+#include "Benchmarks.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+using namespace ::std;
+
+namespace
+{
+
+/// Smallest and largest corpus sizes, in bytes.
+const size_t s_smallestSize = 1024;
+const size_t s_largestSize = 1024 * 1024 * 1024;
+
+// ----------------------------------------------------------------------------
+
+void ShowHelp( const char * myName )
+{
+    cout << "Usage: " << myName << " [-h] [-l] [-p] [-u] [-z:size] [-c:#] [-k:#] [-a:#] [-e:#]\n";
+    cout << "    [-r:#] [-b:name] [-t:filename] [-g:prefix]\n";
+    cout << "  Makes a corpus for each benchmark, parses it, and writes comma separated\n";
+    cout << "  results to standard output.  A megabyte is 1000000 bytes.\n";
+    cout << "    -a = Most attributes in each xml element.  Default is -a:3\n";
+    cout << "    -b = Only run benchmarks whose names start with this, such as -b:xml\n";
+    cout << "    -c = Percent of xml children or config lines which are comments.\n";
+    cout << "         Default is -c:10\n";
+    cout << "    -e = Seed for making random text.  Default is -e:12345\n";
+    cout << "    -g = Write corpus for each benchmark to files whose names start with\n";
+    cout << "         prefix, and then stop without parsing.\n";
+    cout << "    -h = Show this help info.\n";
+    cout << "    -k = Keys in each config section.  Default is -k:8\n";
+    cout << "    -l = List names of all benchmarks.\n";
+    cout << "    -p = Parse xml with Spirit rules only, without fast scanners.\n";
+    cout << "    -r = Times to parse each corpus while timing.  Default is -r:5\n";
+    cout << "    -t = File to write for benchmarks which parse a file.\n";
+    cout << "         Default is -t:BenchCorpus.tmp\n";
+    cout << "    -u = Write counts for each grammar rule from the untimed pass to\n";
+    cout << "         standard error.  Needs a build with PARSER_RULE_PROFILE defined.\n";
+    cout << "    -z = Bytes in each corpus, from 1K through 1G.  May end with K, M, or G.\n";
+    cout << "         Default is -z:1M\n";
+}
+
+// ----------------------------------------------------------------------------
+
+void ShowUsage( const char * myName )
+{
+    cout << "Usage: " << myName << " [-h] [-l] [-p] [-u] [-z:size] [-c:#] [-k:#] [-a:#] [-e:#]\n";
+    cout << "    [-r:#] [-b:name] [-t:filename] [-g:prefix]\n";
+}
+
+// ----------------------------------------------------------------------------
+
+/// Reads a number after the colon in an option.  Returns false if none there.
+bool GetNumber( const char * arg, unsigned long & number )
+{
+    if ( ( ':' != arg[ 2 ] ) || !::isdigit( arg[ 3 ] ) )
+        return false;
+    char * end = NULL;
+    number = ::strtoul( arg + 3, &end, 10 );
+    return ( '\0' == *end );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Reads a size which may end with K, M, or G.
+bool GetSize( const char * arg, size_t & size )
+{
+    if ( ( ':' != arg[ 2 ] ) || !::isdigit( arg[ 3 ] ) )
+        return false;
+    char * end = NULL;
+    const unsigned long number = ::strtoul( arg + 3, &end, 10 );
+    unsigned long scale = 1;
+    switch ( ::toupper( *end ) )
+    {
+        case '\0': break;
+        case 'K': scale = 1024; ++end; break;
+        case 'M': scale = 1024 * 1024; ++end; break;
+        case 'G': scale = 1024 * 1024 * 1024; ++end; break;
+        default: return false;
+    }
+    if ( ( '\0' != *end ) || ( s_largestSize / scale < number ) )
+        return false;
+    size = static_cast< size_t >( number ) * scale;
+    return ( s_smallestSize <= size );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CheckParameters( unsigned int argc, const char * argv[], BenchOptions & options,
+    bool & listNames, const char * & corpusPrefix )
+{
+    bool showHelp = false;
+    bool validCommands = true;
+    unsigned long number = 0;
+
+    const char * myName = ::strrchr( argv[0], '/' );
+    if ( ( NULL == myName ) || ( 0 == *myName ) ) myName = ::strrchr( argv[0], '\\' );
+    if ( ( NULL == myName ) || ( 0 == *myName ) ) myName = "ParserBench.exe"; else ++myName;
+
+    for ( unsigned long ai = 1; ( validCommands ) && ( ai < argc ); ++ai )
+    {
+        const char * arg = argv[ ai ];
+        const unsigned long length = static_cast< unsigned long >( ::strlen( arg ) );
+        if ( ( *arg != '-' ) || ( length < 2 ) )
+        {
+            validCommands = false;
+            break;
+        }
+        switch ( arg[ 1 ] )
+        {
+            case 'a':
+                validCommands = GetNumber( arg, number );
+                options.m_corpus.m_attributes = static_cast< unsigned int >( number );
+                break;
+            case 'b':
+                validCommands = ( ( ':' == arg[ 2 ] ) && ( 4 <= length ) );
+                options.m_only = arg + 3;
+                break;
+            case 'c':
+                validCommands = GetNumber( arg, number ) && ( number <= 100 );
+                options.m_corpus.m_commentPercent = static_cast< unsigned int >( number );
+                break;
+            case 'e':
+                validCommands = GetNumber( arg, number );
+                options.m_corpus.m_seed = number;
+                break;
+            case 'g':
+                validCommands = ( ( ':' == arg[ 2 ] ) && ( 4 <= length ) );
+                corpusPrefix = arg + 3;
+                break;
+            case 'k':
+                validCommands = GetNumber( arg, number );
+                options.m_corpus.m_sectionKeys = static_cast< unsigned int >( number );
+                break;
+            case 'r':
+                validCommands = GetNumber( arg, number ) && ( 0 < number );
+                options.m_passes = static_cast< unsigned int >( number );
+                break;
+            case 't':
+                validCommands = ( ( ':' == arg[ 2 ] ) && ( 4 <= length ) );
+                options.m_fileName = arg + 3;
+                break;
+            case 'z':
+                validCommands = GetSize( arg, options.m_corpus.m_size );
+                break;
+            case 'h': showHelp = true; break;
+            case 'l': listNames = true; break;
+            case 'p': options.m_fastScanning = false; break;
+            case 'u': options.m_ruleReport = &cerr; break;
+            default:  validCommands = false; break;
+        }
+    }
+
+    if ( showHelp )
+        ShowHelp( myName );
+    else if ( !validCommands )
+        ShowUsage( myName );
+
+    return ( validCommands && !showHelp );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+int main( int argc, const char * argv[] )
+{
+
+    BenchOptions options;
+    bool listNames = false;
+    const char * corpusPrefix = NULL;
+
+    if ( !CheckParameters( argc, argv, options, listNames, corpusPrefix ) )
+        return 1;
+
+    if ( listNames )
+    {
+        WriteBenchmarkNames( cout );
+        return 0;
+    }
+
+    if ( NULL != corpusPrefix )
+        return WriteCorpora( options, corpusPrefix ) ? 0 : 1;
+
+    if ( ( NULL != options.m_ruleReport ) && !::Parser::RuleProfile::IsEnabled() )
+    {
+        cerr << "Rule counts need a build with PARSER_RULE_PROFILE defined.\n";
+        return 1;
+    }
+
+    BenchResults results;
+    const bool okay = RunBenchmarks( options, results );
+    WriteResults( cout, options, results );
+
+    return okay ? 0 : 1;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
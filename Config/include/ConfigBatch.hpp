@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigBatch.hpp Defines a class which parses many config files at once.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_BATCH_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_BATCH_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <string>
+#include <vector>
+
+#include <UtilParsers/Util/include/BatchRunner.hpp>
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+    class ConfigDocument;
+
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigBatch
+ Parses a list of config files and buffers across several threads, each with
+ its own ConfigParser, and keeps a ConfigDocument, a result, and the messages
+ for each one in the order they were added.  Documents copy what they keep, so
+ buffers need only last until Run returns.
+ */
+class ConfigBatch : public BatchRunner
+{
+public:
+
+    /// @param threadCount Most threads to use, or zero for one per processor.
+    explicit ConfigBatch( unsigned long threadCount = 0 );
+
+    virtual ~ConfigBatch( void );
+
+    /** Sets policy for the parser of each thread, which uses the default policy
+     otherwise.  The strings the policy points to must last until Run returns.
+     */
+    void SetPolicy( const ConfigParser::ParserPolicy & policy );
+
+    /// Adds a file to parse, and returns its index.
+    unsigned long AddFile( const char * filename );
+
+    /** Adds chars to parse, and returns their index.
+     @param name Name to show for buffer, or NULL.
+     */
+    unsigned long AddBuffer( const char * begin, const char * end, const char * name );
+
+    /// Removes all files and buffers, and their results.
+    void Clear( void );
+
+    /// Parses everything added.  Returns true if all were AllValid.
+    bool Run( void );
+
+    inline unsigned long GetCount( void ) const
+    {
+        return static_cast< unsigned long >( m_items.size() );
+    }
+
+    /// Returns file name, or name given to AddBuffer, or empty.
+    const char * GetName( unsigned long index ) const;
+
+    /// Returns what the parser returned.  Is NotParsed before Run.
+    ConfigParser::ParseResults GetResult( unsigned long index ) const;
+
+    /// Returns contents found by the parser.
+    const ConfigDocument & GetDocument( unsigned long index ) const;
+
+    /// Returns messages for one item, one per line.
+    const char * GetMessages( unsigned long index ) const;
+
+    unsigned long GetMessageCount( unsigned long index ) const;
+
+private:
+
+    /// Not implemented.
+    ConfigBatch( const ConfigBatch & );
+    /// Not implemented.
+    ConfigBatch & operator = ( const ConfigBatch & );
+
+    struct Item
+    {
+        ::std::string m_name;
+        bool m_isFile;
+        const char * m_begin;
+        const char * m_end;
+        ConfigParser::ParseResults m_result;
+        ConfigDocument * m_document;
+        ::std::string m_messages;
+        unsigned long m_messageCount;
+    };
+
+    virtual void * MakeWorker( void );
+
+    virtual void RunJob( void * worker, unsigned long job );
+
+    virtual void DestroyWorker( void * worker );
+
+    Item & AddItem( const char * name );
+
+    ::std::vector< Item * > m_items;
+    ConfigParser::ParserPolicy m_policy;
+    bool m_hasPolicy;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,226 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigDocument.hpp Defines a receiver which stores a whole config file.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_DOCUMENT_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_DOCUMENT_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <vector>
+
+#include <UtilParsers/Util/include/LineIndex.hpp>
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+    class ConfigSplitParser;
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigDocument
+ Stores every section and key a ConfigParser gives it, and finds any value by
+ section and key name in constant time without allocating memory.
+
+ All names and values are copied into one array of chars, so the parsed data
+ need not outlive the document.  Sections and keys are kept in two flat arrays
+ and found through open addressing hash tables, which hold only indexes.
+
+ Global keys, those before any section, belong to section 0, whose name is
+ empty.  A repeated section name continues the earlier section with that name,
+ as ConfigParser allows.  A repeated key within a section replaces the value
+ of the earlier key, and keeps the place of the earlier key.
+
+ Call Clear before using a document to receive another config file.  When
+ the document parses the file itself through Parse, it also stores the line on
+ which each section and key was last found.
+ */
+class ConfigDocument : public IConfigReceiver
+{
+public:
+
+    /// An index which refers to no section or key.
+    enum { NoIndex = 0xFFFFFFFFUL };
+
+    ConfigDocument( void );
+
+    virtual ~ConfigDocument( void );
+
+    /// Removes all sections and keys, but keeps memory for next time.
+    void Clear( void );
+
+    /** Parses config chars and replaces anything stored before.  Unlike a
+     document given straight to a parser, this also stores line numbers.
+     @param parser Parser to use.  It needs an error receiver.
+     @return What the parser returned.
+     */
+    ConfigParser::ParseResults Parse( ConfigParser & parser, const char * begin,
+        const char * end );
+
+    /** Parses config chars on several threads, and stores line numbers too.
+     @param parser Parser to use.  It needs an error receiver.
+     @return What the parser returned.
+     */
+    ConfigParser::ParseResults Parse( ConfigSplitParser & parser, const char * begin,
+        const char * end );
+
+    /// Returns FNV-1a hash of chars.  Used for section names.
+    static unsigned long HashText( const char * begin, const char * end );
+
+    /// Returns hash of key name mixed with index of its section.
+    static unsigned long HashKeyName( unsigned long section, const char * begin,
+        const char * end );
+
+    virtual bool AddGlobalKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual bool AddSection( const char * nameStart, const char * nameEnd );
+
+    virtual bool AddSectionKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual void ParsedConfigFile( bool valid );
+
+    /// Returns true if the parser finished and found the whole file valid.
+    inline bool IsValid( void ) const { return m_valid; }
+
+    /** Finds the value of a key.
+     @param section Name of section, or NULL or empty for global keys.
+     @param key Name of key.
+     @return Nil-terminated value, which is empty if the key has no value, or
+      NULL if there is no such key.  Good until document changes.
+     */
+    const char * Get( const char * section, const char * key ) const;
+
+    /// Returns index of section, or NoIndex.  NULL or empty finds global keys.
+    unsigned long FindSection( const char * name ) const;
+
+    /// Returns index of key within a section, or NoIndex.
+    unsigned long FindKey( unsigned long section, const char * key ) const;
+
+    /// Returns count of sections, including section 0 for global keys.
+    inline unsigned long GetSectionCount( void ) const
+    {
+        return static_cast< unsigned long >( m_sections.size() );
+    }
+
+    const char * GetSectionName( unsigned long section ) const;
+
+    /// Returns line where section name was first found, or 0 if not known.
+    unsigned long GetSectionLine( unsigned long section ) const;
+
+    /// Returns how many different keys a section has.
+    unsigned long GetKeyCount( unsigned long section ) const;
+
+    /// Returns first key of section in order keys were found, or NoIndex.
+    unsigned long GetFirstKey( unsigned long section ) const;
+
+    /// Returns next key in the same section, or NoIndex.
+    unsigned long GetNextKey( unsigned long key ) const;
+
+    const char * GetKeyName( unsigned long key ) const;
+
+    const char * GetKeyValue( unsigned long key ) const;
+
+    /// Returns line where key was last found, or 0 if not known.
+    unsigned long GetKeyLine( unsigned long key ) const;
+
+private:
+
+    /// Not implemented.
+    ConfigDocument( const ConfigDocument & );
+    /// Not implemented.
+    ConfigDocument & operator = ( const ConfigDocument & );
+
+    struct Section
+    {
+        /// Offset of name within chars.
+        unsigned long m_name;
+        unsigned long m_hash;
+        unsigned long m_firstKey;
+        unsigned long m_lastKey;
+        unsigned long m_keyCount;
+        unsigned long m_line;
+    };
+
+    struct Key
+    {
+        unsigned long m_section;
+        /// Offset of name within chars.
+        unsigned long m_name;
+        /// Offset of value within chars.
+        unsigned long m_value;
+        unsigned long m_hash;
+        unsigned long m_nextKey;
+        unsigned long m_line;
+    };
+
+    typedef ::std::vector< unsigned long > Slots;
+
+    /// Copies chars into char array with a nil after them, and returns offset.
+    unsigned long AddChars( const char * begin, const char * end );
+
+    /// Adds or replaces key within current section.
+    bool AddKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    /// Returns place in slots which holds section or should hold it.
+    unsigned long FindSectionSlot( const char * begin, const char * end,
+        unsigned long hash ) const;
+
+    /// Returns place in slots which holds key or should hold it.
+    unsigned long FindKeySlot( unsigned long section, const char * begin,
+        const char * end, unsigned long hash ) const;
+
+    /// Doubles size of hash tables when they get half full.
+    void GrowSlots( Slots & slots, unsigned long count, bool forKeys );
+
+    /// Returns line which holds place, or 0 if not parsing through Parse.
+    unsigned long GetLine( const char * place );
+
+    friend class ConfigSnapshot;
+
+    ::std::vector< char > m_chars;
+    ::std::vector< Section > m_sections;
+    ::std::vector< Key > m_keys;
+    Slots m_sectionSlots;
+    Slots m_keySlots;
+    /// Index of section which gets keys now.
+    unsigned long m_current;
+    /// Finds line of each section and key while inside Parse, else holds no text.
+    LineIndex m_lines;
+    bool m_valid;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigEventBatcher.hpp Defines a receiver which adds config events to a buffer.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_EVENT_BATCHER_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_EVENT_BATCHER_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <UtilParsers/Util/include/EventBuffer.hpp>
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigEventBatcher
+ Gives sections, keys, and values of config chars to an EventBuffer, so the
+ buffer's receiver gets them in batches.  Parse has the parser's rules append
+ each event to the buffer directly, with no call through a receiver for each
+ one.  The batcher is also a receiver which turns each call into an event, for
+ parsers which only take a receiver, such as ConfigSplitParser.
+ A key and its value always come in the same batch, key first.
+ A key with no value still has a Value event, whose view is empty and may be
+ NULL.  Unless the buffer's receiver said to stop, the last event is EndFile,
+ and the buffer is flushed after it.
+ */
+class ConfigEventBatcher : public IConfigReceiver
+{
+public:
+
+    enum Events
+    {
+        Section = 1, ///< View is the name of a section.
+        GlobalKey,   ///< View is the name of a key before any section.
+        SectionKey,  ///< View is the name of a key within the last section.
+        Value,       ///< View is the value of the key just before.
+        EndFile      ///< View is empty.  Flags has Valid if the file was.
+    };
+
+    enum Flags
+    {
+        Valid = 0x01 ///< Set for EndFile if the whole file was valid.
+    };
+
+    /// Returns name of event kind for showing to people.
+    static const char * GetEventName( unsigned short kind );
+
+    explicit ConfigEventBatcher( EventBuffer & buffer );
+
+    virtual ~ConfigEventBatcher( void );
+
+    /** Parses config chars and gives every event to the buffer.  The buffer is
+     flushed even if the parser stops before the end.
+     @param parser Parser to use.  It needs an error receiver.
+     @return What the parser returned.
+     */
+    ConfigParser::ParseResults Parse( ConfigParser & parser, const char * begin,
+        const char * end );
+
+    virtual bool AddGlobalKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual bool AddSection( const char * nameStart, const char * nameEnd );
+
+    virtual bool AddSectionKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual void ParsedConfigFile( bool valid );
+
+private:
+
+    /// Not implemented.
+    ConfigEventBatcher( void );
+    /// Not implemented.
+    ConfigEventBatcher( const ConfigEventBatcher & );
+    /// Not implemented.
+    ConfigEventBatcher & operator = ( const ConfigEventBatcher & );
+
+    EventBuffer & m_buffer;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -30,6 +30,7 @@ namespace Parser
 {
     class IParseErrorReceiver;
     class ConfigParserImpl;
+    class EventBuffer;
 
 
 // ----------------------------------------------------------------------------
@@ -187,6 +188,16 @@ class ConfigParser
         ConfigParser::ParseResults Parse( const char * filename,
             IConfigReceiver * pReceiver );
 
+        /** Parses config chars, and the rules add each section, key, value,
+         and the end of the file to the buffer as ConfigEventBatcher events,
+         with no call through a receiver for each one.  EndFile is added and
+         the buffer flushed only if the rules reach the end, as a receiver only
+         gets ParsedConfigFile then.  No more events are added once the
+         buffer's receiver says to stop.
+         */
+        ConfigParser::ParseResults Parse( const char * start, const char * end,
+            EventBuffer & events );
+
     private:
         ConfigParser( const ConfigParser & );
         ConfigParser & operator = ( const ConfigParser & );
@@ -0,0 +1,162 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigSink.hpp Parses config chars into a sink known when compiling.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_SINK_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_SINK_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <assert.h>
+
+#include "ConfigEventBatcher.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigSinkReceiver
+ Takes batches of config events and gives each to a sink with the call an
+ IConfigReceiver gets for it.  The batch comes through one virtual call, and
+ the calls to the sink within it are inlined.
+ */
+template < class Sink >
+class ConfigSinkReceiver : public IEventBatchReceiver
+{
+public:
+
+    /// Events in the one batch of the buffer.  Must be more than one, so a key
+    /// and its value always come in the same batch.
+    enum { BatchSize = 64 };
+
+    inline explicit ConfigSinkReceiver( Sink & sink ) :
+        IEventBatchReceiver(), m_sink( sink ), m_stopped( false ) {}
+
+    inline virtual ~ConfigSinkReceiver( void ) {}
+
+    virtual bool TakeEvents( const ParseEvent * events, unsigned long count )
+    {
+        // A buffer sends a batch again if this threw while taking it.
+        if ( m_stopped )
+            return false;
+        m_stopped = true;
+        const ParseEvent * const last = events + count;
+        for ( const ParseEvent * event = events; event != last; ++event )
+        {
+            bool keep = true;
+            switch ( event->m_kind )
+            {
+                case ConfigEventBatcher::Section:
+                    keep = m_sink.AddSection( event->m_begin, event->m_end );
+                    break;
+                case ConfigEventBatcher::GlobalKey:
+                    assert( event + 1 != last );
+                    ++event;
+                    keep = m_sink.AddGlobalKey( event[ -1 ].m_begin, event[ -1 ].m_end,
+                        event->m_begin, event->m_end );
+                    break;
+                case ConfigEventBatcher::SectionKey:
+                    assert( event + 1 != last );
+                    ++event;
+                    keep = m_sink.AddSectionKey( event[ -1 ].m_begin, event[ -1 ].m_end,
+                        event->m_begin, event->m_end );
+                    break;
+                case ConfigEventBatcher::EndFile:
+                    m_sink.ParsedConfigFile( 0 != ( ConfigEventBatcher::Valid & event->m_flags ) );
+                    break;
+                default:
+                    break;
+            }
+            if ( !keep )
+                return false;
+        }
+        m_stopped = false;
+        return true;
+    }
+
+private:
+
+    /// Not implemented.
+    ConfigSinkReceiver( const ConfigSinkReceiver & );
+    /// Not implemented.
+    ConfigSinkReceiver & operator = ( const ConfigSinkReceiver & );
+
+    Sink & m_sink;
+    /// True once the sink said to stop or threw.
+    bool m_stopped;
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** Parses config chars and gives them to a sink with the same calls, in the
+ same order, as ConfigParser::Parse gives a receiver.  Sink may be any class
+ with AddGlobalKey, AddSection, AddSectionKey, and ParsedConfigFile, so calls
+ to a sink known when compiling are inlined, and IConfigReceiver is the sink
+ for receivers called through virtual functions.  The rules add each section
+ and key to a small buffer on the stack, and the sink gets them a batch at a
+ time, so it gets no more calls once one returns false, and a call may come
+ after the rules have gone on past the part it is for.
+ @return Same results as ConfigParser::Parse.
+ */
+template < class Sink >
+ConfigParser::ParseResults ParseConfig( ConfigParser & parser, const char * begin,
+    const char * end, Sink & sink )
+{
+    ParseEvent events[ ConfigSinkReceiver< Sink >::BatchSize ];
+    ConfigSinkReceiver< Sink > receiver( sink );
+    EventBuffer buffer( events, ConfigSinkReceiver< Sink >::BatchSize,
+        ConfigSinkReceiver< Sink >::BatchSize, &receiver );
+    const ConfigParser::ParseResults result = parser.Parse( begin, end, buffer );
+    try
+    {
+        // Rules only flush if they reach the end, and a receiver still gets
+        // what came before the place where the rules gave up.
+        buffer.Flush();
+    }
+    catch ( ... )
+    {
+        return ConfigParser::Exception;
+    }
+    return result;
+}
+
+/// A receiver is already what the rules call, so it needs no buffer.
+template <>
+inline ConfigParser::ParseResults ParseConfig< IConfigReceiver >( ConfigParser & parser,
+    const char * begin, const char * end, IConfigReceiver & sink )
+{
+    return parser.Parse( begin, end, &sink );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,235 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigSnapshot.hpp Defines a binary image of a parsed config file.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_SNAPSHOT_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_SNAPSHOT_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <vector>
+
+#include <UtilParsers/Util/include/FileBuffer.hpp>
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+    class ConfigDocument;
+
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigSnapshot
+ Finds sections and keys of a config file within a binary image made from a
+ ConfigDocument.  The image holds a header, the arrays of sections and keys,
+ both hash tables, and all the names and values.  Every reference inside the
+ image is an offset or index, so the image can be mapped from a file at any
+ address and used in place without parsing or allocating memory.
+
+ The header records the size and hash of the config file the image was made
+ from.  Load checks those against the config file, and parses that file and
+ makes a new image when they differ.  The image does not record the parser
+ policy, so use a separate image file for each policy.
+
+ Numbers in the image are 32 bits in the byte order of the machine which made
+ it.  An image from a machine with the other byte order is rejected.
+ */
+class ConfigSnapshot
+{
+public:
+
+    /// An index which refers to no section or key.
+    enum { NoIndex = 0xFFFFFFFFUL };
+
+    /// Version of image layout.  Images with any other version are rejected.
+    enum { Version = 1 };
+
+    enum LoadResults
+    {
+        Mapped = 0, ///< Image file matched config file and is used in place.
+        Rebuilt,    ///< Config file was parsed, and a new image was saved.
+        NotSaved,   ///< Config file was parsed, but the image file could not be written.
+        NotValid,   ///< Config file was parsed, but it is not valid.  No image saved.
+        NoSource    ///< Config file could not be opened.
+    };
+
+    static const char * Name( LoadResults result );
+
+    ConfigSnapshot( void );
+
+    ~ConfigSnapshot( void );
+
+    /** Makes an image of a document.
+     @param document Document to copy.
+     @param sourceBegin Start of config file the document was parsed from.
+     @param sourceEnd Place after last char of config file.
+     @param image Gets the image.  Anything in it before is replaced.
+     @return False if document is too large to fit in 32-bit offsets.
+     */
+    static bool MakeImage( const ConfigDocument & document, const char * sourceBegin,
+        const char * sourceEnd, ::std::vector< char > & image );
+
+    /** Uses an image in place after checking that it is whole and consistent.
+     The image must outlive the snapshot, or stay until Close is called.
+     @param image Start of image.  Must be aligned for 32-bit numbers.
+     @param size Bytes in image.
+     @param sourceBegin Start of config file to check against, or NULL to skip
+      that check.
+     @param sourceEnd Place after last char of config file.
+     @return True if the image can be used.
+     */
+    bool Attach( const char * image, unsigned long size, const char * sourceBegin,
+        const char * sourceEnd );
+
+    /** Uses image file if it was made from the config file as it is now.
+     Otherwise parses the config file and, if it is valid, writes a new image
+     file.  The snapshot has the contents of the config file in every case
+     except NoSource, even when the config file is not valid.
+     @param parser Parser to use if needed.  It needs an error receiver.
+     @param sourceFile Path to config file.
+     @param imageFile Path to image file, or NULL to just parse.
+     */
+    LoadResults Load( ConfigParser & parser, const char * sourceFile,
+        const char * imageFile );
+
+    /// Writes image in use to a file.  Returns false if nothing is attached.
+    bool Save( const char * filename ) const;
+
+    /// Stops using image, and unmaps or frees it.
+    void Close( void );
+
+    /// Returns true if an image is in use.
+    inline bool IsOpen( void ) const { return ( NULL != m_image ); }
+
+    /// Returns true if the image is mapped straight from a file.
+    bool IsMapped( void ) const;
+
+    /// Returns true if the config file was valid when the image was made.
+    bool IsValid( void ) const;
+
+    /// Returns bytes in image, or 0 if none is in use.
+    unsigned long GetImageSize( void ) const;
+
+    /// Same as ConfigDocument::Get.  Returns NULL if no image is in use.
+    const char * Get( const char * section, const char * key ) const;
+
+    /// Returns index of section, or NoIndex.  NULL or empty finds global keys.
+    unsigned long FindSection( const char * name ) const;
+
+    /// Returns index of key within a section, or NoIndex.
+    unsigned long FindKey( unsigned long section, const char * key ) const;
+
+    unsigned long GetSectionCount( void ) const;
+
+    const char * GetSectionName( unsigned long section ) const;
+
+    unsigned long GetSectionLine( unsigned long section ) const;
+
+    unsigned long GetKeyCount( unsigned long section ) const;
+
+    unsigned long GetFirstKey( unsigned long section ) const;
+
+    unsigned long GetNextKey( unsigned long key ) const;
+
+    const char * GetKeyName( unsigned long key ) const;
+
+    const char * GetKeyValue( unsigned long key ) const;
+
+    unsigned long GetKeyLine( unsigned long key ) const;
+
+private:
+
+    /// Not implemented.
+    ConfigSnapshot( const ConfigSnapshot & );
+    /// Not implemented.
+    ConfigSnapshot & operator = ( const ConfigSnapshot & );
+
+    /// 32-bit number used for every field of the image.
+    typedef unsigned int Word;
+
+    struct Header
+    {
+        Word m_magic;
+        Word m_version;
+        Word m_imageSize;
+        Word m_sourceSize;
+        Word m_sourceHash;
+        Word m_valid;
+        Word m_sectionCount;
+        Word m_keyCount;
+        Word m_sectionSlotCount;
+        Word m_keySlotCount;
+        Word m_charCount;
+        /// Byte offsets of each part from start of image.
+        Word m_sections;
+        Word m_keys;
+        Word m_sectionSlots;
+        Word m_keySlots;
+        Word m_chars;
+    };
+
+    struct Section
+    {
+        Word m_name;
+        Word m_hash;
+        Word m_firstKey;
+        Word m_keyCount;
+        Word m_line;
+    };
+
+    struct Key
+    {
+        Word m_section;
+        Word m_name;
+        Word m_value;
+        Word m_hash;
+        Word m_nextKey;
+        Word m_line;
+    };
+
+    bool CheckImage( const char * image, unsigned long size ) const;
+
+    ::Parser::FileBuffer m_file;
+    /// Image made by Load when the image file did not match.
+    ::std::vector< char > m_made;
+    const char * m_image;
+    const Header * m_header;
+    const Section * m_sections;
+    const Key * m_keys;
+    const Word * m_sectionSlots;
+    const Word * m_keySlots;
+    const char * m_chars;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigSplitParser.hpp Defines a class which parses one config file on many threads.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_SPLIT_PARSER_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_SPLIT_PARSER_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <UtilParsers/Util/include/BatchRunner.hpp>
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+/// What happened during the last parse by a ConfigSplitParser.
+struct ConfigSplitStats
+{
+    /// Pieces the file was split into, or zero if it was not split.
+    unsigned long m_pieces;
+    /// True if the file was parsed again on one thread after it was split.
+    bool m_reparsed;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigSplitParser
+ Parses one large config file on several threads, and gives calls to the
+ receiver in file order, the same calls ConfigParser::Parse would give.
+
+ The file is split into pieces of about the same size, each starting at a line
+ whose first item, after any blanks, is a section name.  A line which starts
+ with a line comment or block comment is never a split point, even if the
+ comment delimiter starts with the section starter.  The grammar ends every
+ comment, quoted value, and section name at the end of its line, so each line
+ starts outside of them, and a piece which starts with a section has no global
+ keys.  So each piece parses just as it would within the whole file.
+
+ Each thread parses some pieces with its own ConfigParser and records the
+ receiver calls.  Once all pieces are parsed, the calling thread gives the calls
+ to the receiver in order.  Since the calls point into the file, a receiver
+ finds the same places, and so the same line numbers, as from one pass.
+
+ If any piece is not valid or has messages, nothing is given from the pieces,
+ and the file is parsed again on one thread with the receiver, so the result
+ and messages are the same as from ConfigParser::Parse.  A file smaller than
+ two pieces, or without a section to split at, is simply parsed on one thread.
+ */
+class ConfigSplitParser : public BatchRunner
+{
+public:
+
+    /// @param threadCount Most threads to use, or zero for one per processor.
+    explicit ConfigSplitParser( unsigned long threadCount = 0 );
+
+    virtual ~ConfigSplitParser( void );
+
+    bool SetMessageReceiver( IParseErrorReceiver * pReceiver );
+
+    IParseErrorReceiver * GetMessageReceiver( void );
+
+    /// Sets policy for every parser.  Same rules as ConfigParser::SetPolicy.
+    bool SetPolicy( const ConfigParser::ParserPolicy & policy );
+
+    const ConfigParser::ParserPolicy & GetPolicy( void ) const;
+
+    /// Sets about how many chars go in each piece.  Default is 256 kilobytes.
+    void SetPieceSize( unsigned long size );
+
+    unsigned long GetPieceSize( void ) const;
+
+    ConfigParser::ParseResults Parse( const char * start, const char * end,
+        IConfigReceiver * pReceiver );
+
+    ConfigSplitStats GetSplitStats( void ) const;
+
+private:
+
+    /// Not implemented.
+    ConfigSplitParser( const ConfigSplitParser & );
+    /// Not implemented.
+    ConfigSplitParser & operator = ( const ConfigSplitParser & );
+
+    virtual void * MakeWorker( void );
+
+    virtual void RunJob( void * worker, unsigned long job );
+
+    virtual void DestroyWorker( void * worker );
+
+    class Impl;
+
+    /// Pieces, recorded calls, and the parser for the calling thread.
+    Impl * m_impl;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,191 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigWatcher.hpp Defines a class which reloads config files as they change.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( UTIL_CONFIG_WATCHER_H_INCLUDED )
+/// file guardian.
+#define UTIL_CONFIG_WATCHER_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+    class ConfigDocument;
+
+
+// ----------------------------------------------------------------------------
+
+/// What happened during one reload of one config file.
+struct ConfigReloadInfo
+{
+    /// What the parser returned, or CantOpenFile if the file could not be read.
+    ConfigParser::ParseResults m_result;
+    /// Number of calls to ChangedConfig for this reload.
+    unsigned long m_changes;
+    /// Time spent inside the parser, in microseconds.
+    unsigned long m_parseTime;
+    /// Time from noticing the change until the last change was given, in microseconds.
+    unsigned long m_latency;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Counters kept by a ConfigWatcher since it was made.
+struct ConfigWatcherStats
+{
+    /// Times a file was read to see if its contents changed.
+    unsigned long m_checks;
+    /// Checks which found the same contents, so nothing was parsed.
+    unsigned long m_unchanged;
+    /// Checks which parsed new contents and gave changes.
+    unsigned long m_reloads;
+    /// Checks which could not read the file, or found it not valid.
+    unsigned long m_failures;
+};
+
+// ----------------------------------------------------------------------------
+
+class IConfigChangeReceiver
+{
+protected:
+
+    /// Trivially implemented.
+    inline IConfigChangeReceiver( void ) {}
+
+    /// Trivially implemented.
+    inline virtual ~IConfigChangeReceiver( void ) {}
+
+public:
+
+    enum Changes
+    {
+        SectionAdded = 0, ///< Section is new.  Its keys follow as KeyAdded.
+        SectionRemoved,   ///< Section is gone.  Its keys came before as KeyRemoved.
+        KeyAdded,         ///< Key is new.
+        KeyRemoved,       ///< Key is gone.
+        KeyChanged        ///< Key has a different value.
+    };
+
+    /** Called once for each difference between the old and new contents of a
+     file.  Removals come first, then additions and changes, in file order.
+     @param filename Name of file as given to ConfigWatcher::AddFile.
+     @param change What changed.
+     @param section Name of section, which is empty for global keys.
+     @param key Name of key, or NULL if a section changed.
+     @param oldValue Value before, or NULL if there was none.
+     @param newValue Value now, or NULL if there is none.
+     */
+    virtual void ChangedConfig( const char * filename, Changes change,
+        const char * section, const char * key, const char * oldValue,
+        const char * newValue ) = 0;
+
+    /** Called after each reload which read the file and found new contents,
+     even if the new contents were not valid.  Nothing changes when they are
+     not valid, so the old contents are kept.
+     */
+    virtual void ReloadedConfigFile( const char * filename,
+        const ConfigReloadInfo & info ) = 0;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class ConfigWatcher
+ Keeps the contents of some config files, and reloads each one when it
+ changes.  Contents are parsed only when the bytes of a file differ from the
+ last time it was read.  The new contents are compared to the old contents, and
+ only the sections and keys which differ are given to the change receiver.
+ When a file is added, all its sections and keys are given as added.
+
+ On Linux the folder of each file is watched through inotify, so a change is
+ noticed as soon as a writer closes the file or renames another file over it.
+ On other platforms, Poll checks the time and size of each file.
+
+ A ConfigWatcher is not thread safe.  Call its functions from one thread, such
+ as the thread which now handles SIGHUP, and have that thread call Poll.
+ */
+class ConfigWatcher
+{
+public:
+
+    /** Makes a watcher with no files.
+     @param parser Parser for all files.  It needs an error receiver.
+     @param receiver Gets changes, or NULL to just keep the contents.
+     */
+    ConfigWatcher( ConfigParser & parser, IConfigChangeReceiver * receiver );
+
+    ~ConfigWatcher( void );
+
+    /** Starts watching a file, and loads it if it can be read.
+     @return False if the file is already watched, or could not be watched.
+     */
+    bool AddFile( const char * filename );
+
+    /// Stops watching a file.  Returns false if it was not watched.
+    bool RemoveFile( const char * filename );
+
+    unsigned long GetFileCount( void ) const;
+
+    /// Returns last valid contents of file, or NULL if file is not watched.
+    const ConfigDocument * GetDocument( const char * filename ) const;
+
+    /** Waits for files to change, then reloads those which did.
+     @param waitTime Most milliseconds to wait, or zero to only check.
+     @return Number of files reloaded with new valid contents.
+     */
+    unsigned long Poll( unsigned long waitTime );
+
+    /// Reads every file now and reloads those whose contents differ.
+    unsigned long ReloadAll( void );
+
+    /// Returns true if the platform tells the watcher when files change.
+    bool IsNotified( void ) const;
+
+    ConfigWatcherStats GetStats( void ) const;
+
+private:
+
+    /// Not implemented.
+    ConfigWatcher( void );
+    /// Not implemented.
+    ConfigWatcher( const ConfigWatcher & );
+    /// Not implemented.
+    ConfigWatcher & operator = ( const ConfigWatcher & );
+
+    class Impl;
+
+    /// Files, documents, and platform handles, which need platform headers.
+    Impl * m_impl;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -44,10 +44,9 @@ namespace Parser
 
 LineCounter::LineCounter( void ) :
     m_new_line(),
-    m_line_count( 0 )
+    m_index()
 {
-    m_new_line = ( !ch_p( '\r' ) >> ch_p( '\n' ) )
-        [ FNewLineIncrement( this ) ];
+    m_new_line = ( !ch_p( '\r' ) >> ch_p( '\n' ) );
 }
 
 // ----------------------------------------------------------------------------
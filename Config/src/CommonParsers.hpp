@@ -29,6 +29,9 @@
 #include <boost/spirit/core.hpp>
 #include <boost/spirit/utility/chset.hpp>
 
+#include "../../Util/include/CharFinder.hpp"
+#include "../../Util/include/LineIndex.hpp"
+
 
 // ----------------------------------------------------------------------------
 // Namespace resolution.
@@ -40,6 +43,11 @@ namespace Parser
 // ----------------------------------------------------------------------------
 // Class definitions.
 
+/** @class LineCounter
+ Matches each newline with no action, so parsing clean text records nothing
+ about lines.  Only when a message needs to say where it is does this find the
+ line and column of a place, through a LineIndex.
+ */
 class LineCounter
 {
 public:
@@ -49,35 +57,86 @@ public:
 
     inline const boost::spirit::rule<> & GetRule( void ) const { return m_new_line; }
 
-    inline unsigned long GetLineCount( void ) const { return m_line_count; }
-    inline unsigned long & Counter( void ) { return m_line_count; }
+    /// Starts over with the text about to be parsed.
+    inline void Reset( const char * begin, const char * end )
+    {
+        m_index.SetText( begin, end );
+    }
 
-    inline void Reset( void ) { m_line_count = 0; }
+    /// Finds line and column of place.  Returns false if place is not in text.
+    inline bool FindPlace( const char * place, unsigned long & line,
+        unsigned long & column )
+    {
+        return m_index.Find( place, line, column );
+    }
 
 private:
 
-    inline void IncrementCount( void ) { ++m_line_count; }
+    boost::spirit::rule<> m_new_line;
+    LineIndex m_index;
+
+    /// Not implemented.
+    LineCounter( const LineCounter & );
+    /// Not implemented.
+    LineCounter & operator = ( const LineCounter & );
+};
+
+
+// ----------------------------------------------------------------------------
+
+/** @class RunParser
+ Matches the same text as *( print_p - ( str_p( a ) | str_p( b ) ) ) and
+ similar rules, but skips to the next char which could end the run instead of
+ trying every char.  Always matches, perhaps with zero length.  See RunFinder.
+ */
+class RunParser : public boost::spirit::parser< RunParser >
+{
+public:
 
-    struct FNewLineIncrement
+    typedef RunParser self_t;
+
+    inline explicit RunParser( const RunFinder & finder ) : m_finder( finder ) {}
+
+    template < typename ScannerT >
+    typename boost::spirit::parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
     {
-        inline explicit FNewLineIncrement( LineCounter * pCounter ) : m_pCounter( pCounter ) {}
+        const char * const begin = scan.first;
+        const char * const end = m_finder.Find( begin, scan.last );
+        scan.first = end;
+        return scan.create_match( end - begin, boost::spirit::nil_t(),
+            begin, end );
+    }
 
-        inline void operator () ( char ) const
-        { m_pCounter->IncrementCount(); }
+private:
 
-        inline void operator () ( const char *, const char * ) const
-        { m_pCounter->IncrementCount(); }
+    RunFinder m_finder;
+};
 
-        LineCounter * m_pCounter;
-    };
 
-    boost::spirit::rule<> m_new_line;
-    unsigned long m_line_count;
+// ----------------------------------------------------------------------------
 
-    /// Not implemented.
-    LineCounter( const LineCounter & );
-    /// Not implemented.
-    LineCounter & operator = ( const LineCounter & );
+/** @class CharPairParser
+ Matches the same text as str_p( "ab" ) for two chars fixed when compiling, so
+ each match is two compares of single chars instead of a loop over a string.
+ */
+template < char First, char Second >
+class CharPairParser : public boost::spirit::parser< CharPairParser< First, Second > >
+{
+public:
+
+    typedef CharPairParser< First, Second > self_t;
+
+    template < typename ScannerT >
+    typename boost::spirit::parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
+    {
+        const char * const begin = scan.first;
+        if ( ( scan.last - begin < 2 ) || ( First != begin[ 0 ] ) || ( Second != begin[ 1 ] ) )
+            return scan.no_match();
+        scan.first = begin + 2;
+        return scan.create_match( 2, boost::spirit::nil_t(), begin, begin + 2 );
+    }
 };
 
 
@@ -0,0 +1,260 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigBatch.cpp Parses many config files on many threads.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigBatch.hpp"
+
+#include <assert.h>
+
+#include "../include/ConfigDocument.hpp"
+#include "../../Util/include/FileBuffer.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Parser and message receiver used by one thread.
+struct ConfigWorker
+{
+    ::Parser::ConfigParser m_parser;
+    ::Parser::MessageCollector m_messages;
+};
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+ConfigBatch::ConfigBatch( unsigned long threadCount ) :
+    BatchRunner( threadCount ),
+    m_items(),
+    m_policy(),
+    m_hasPolicy( false )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigBatch::~ConfigBatch( void )
+{
+    assert( NULL != this );
+    Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigBatch::SetPolicy( const ConfigParser::ParserPolicy & policy )
+{
+    assert( NULL != this );
+    m_policy = policy;
+    m_hasPolicy = true;
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigBatch::Clear( void )
+{
+    assert( NULL != this );
+    for ( ::std::vector< Item * >::iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        delete ( *it )->m_document;
+        delete *it;
+    }
+    m_items.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigBatch::Item & ConfigBatch::AddItem( const char * name )
+{
+    assert( NULL != this );
+    Item * item = new Item;
+    item->m_name = ( NULL == name ) ? "" : name;
+    item->m_isFile = false;
+    item->m_begin = NULL;
+    item->m_end = NULL;
+    item->m_result = ConfigParser::NotParsed;
+    item->m_document = NULL;
+    item->m_messageCount = 0;
+    try
+    {
+        item->m_document = new ConfigDocument;
+        m_items.push_back( item );
+    }
+    catch ( ... )
+    {
+        delete item->m_document;
+        delete item;
+        throw;
+    }
+    return *item;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigBatch::AddFile( const char * filename )
+{
+    assert( NULL != this );
+    Item & item = AddItem( filename );
+    item.m_isFile = true;
+    return GetCount() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigBatch::AddBuffer( const char * begin, const char * end,
+    const char * name )
+{
+    assert( NULL != this );
+    Item & item = AddItem( name );
+    item.m_begin = begin;
+    item.m_end = end;
+    return GetCount() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigBatch::Run( void )
+{
+    assert( NULL != this );
+
+    for ( ::std::vector< Item * >::iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        Item & item = **it;
+        item.m_result = ConfigParser::NotParsed;
+        item.m_messages.clear();
+        item.m_messageCount = 0;
+    }
+    RunJobs( GetCount() );
+
+    for ( ::std::vector< Item * >::const_iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        if ( ConfigParser::AllValid != ( *it )->m_result )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void * ConfigBatch::MakeWorker( void )
+{
+    assert( NULL != this );
+    ConfigWorker * worker = new ConfigWorker;
+    worker->m_parser.SetMessageReceiver( &worker->m_messages );
+    if ( m_hasPolicy )
+        worker->m_parser.SetPolicy( m_policy );
+    return worker;
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigBatch::RunJob( void * worker, unsigned long job )
+{
+    assert( NULL != this );
+    assert( job < m_items.size() );
+
+    ConfigWorker & parts = *reinterpret_cast< ConfigWorker * >( worker );
+    Item & item = *m_items[ job ];
+    parts.m_messages.SetTarget( &item.m_messages, &item.m_messageCount );
+    item.m_result = ConfigParser::Exception;
+
+    if ( item.m_isFile )
+    {
+        FileBuffer file;
+        if ( !file.Open( item.m_name.c_str() ) )
+            item.m_result = ConfigParser::CantOpenFile;
+        else if ( 0 == file.GetSize() )
+            item.m_result = ConfigParser::EmptyFile;
+        else
+            item.m_result = item.m_document->Parse( parts.m_parser, file.GetBegin(),
+                file.GetEnd() );
+    }
+    else
+        item.m_result = item.m_document->Parse( parts.m_parser, item.m_begin, item.m_end );
+
+    parts.m_messages.SetTarget( NULL, NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigBatch::DestroyWorker( void * worker )
+{
+    assert( NULL != this );
+    delete reinterpret_cast< ConfigWorker * >( worker );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigBatch::GetName( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_name.c_str();
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigParser::ParseResults ConfigBatch::GetResult( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_result;
+}
+
+// ----------------------------------------------------------------------------
+
+const ConfigDocument & ConfigBatch::GetDocument( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return *m_items[ index ]->m_document;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigBatch::GetMessages( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_messages.c_str();
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigBatch::GetMessageCount( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_messageCount;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
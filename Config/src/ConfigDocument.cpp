@@ -0,0 +1,461 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigDocument.cpp Stores sections and keys, and finds them by name.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigDocument.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include "../include/ConfigSplitParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Gives global section and keys without values something to point at.
+const char s_empty[] = "";
+
+/// Fewest slots in a hash table.  Must be a power of two.
+const unsigned long s_minSlotCount = 16;
+
+// ----------------------------------------------------------------------------
+
+/// Mixes chars into a hash the FNV-1a way.
+inline unsigned long HashChars( const char * begin, const char * end,
+    unsigned long hash )
+{
+    for ( ; begin != end; ++begin )
+    {
+        hash ^= static_cast< unsigned char >( *begin );
+        hash = ( hash * 16777619UL ) & 0xFFFFFFFFUL;
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if nil-terminated chars match chars from begin to end.
+inline bool SameName( const char * name, const char * begin, const char * end )
+{
+    const size_t length = static_cast< size_t >( end - begin );
+    return ( 0 == ::strncmp( name, begin, length ) ) && ( '\0' == name[ length ] );
+}
+
+// ----------------------------------------------------------------------------
+
+} // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigDocument::ConfigDocument( void ) :
+    IConfigReceiver(),
+    m_chars(),
+    m_sections(),
+    m_keys(),
+    m_sectionSlots(),
+    m_keySlots(),
+    m_current( 0 ),
+    m_lines(),
+    m_valid( false )
+{
+    assert( NULL != this );
+    Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigDocument::~ConfigDocument( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void ::Parser::ConfigDocument::Clear( void )
+{
+    assert( NULL != this );
+
+    m_chars.clear();
+    m_sections.clear();
+    m_keys.clear();
+    m_sectionSlots.assign( m_sectionSlots.size(), NoIndex );
+    m_keySlots.assign( m_keySlots.size(), NoIndex );
+    m_valid = false;
+    AddSection( s_empty, s_empty );
+    assert( 0 == m_current );
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigParser::ParseResults Parser::ConfigDocument::Parse(
+    ConfigParser & parser, const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    Clear();
+    m_lines.SetText( begin, end );
+    const ConfigParser::ParseResults result = parser.Parse( begin, end, this );
+    m_lines.SetText( NULL, NULL );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigParser::ParseResults Parser::ConfigDocument::Parse(
+    ConfigSplitParser & parser, const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    // Split parser gives places within the same text, so lines are found the same way.
+    Clear();
+    m_lines.SetText( begin, end );
+    const ConfigParser::ParseResults result = parser.Parse( begin, end, this );
+    m_lines.SetText( NULL, NULL );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::HashText( const char * begin, const char * end )
+{
+    return HashChars( begin, end, 2166136261UL );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::HashKeyName( unsigned long section,
+    const char * begin, const char * end )
+{
+    const unsigned long seed = ( 2166136261UL ^ ( section * 0x9E3779B1UL ) ) & 0xFFFFFFFFUL;
+    return HashChars( begin, end, seed );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetLine( const char * place )
+{
+    assert( NULL != this );
+
+    // Index keeps the newlines it found, so places in any order are quick.
+    unsigned long line = 0;
+    unsigned long column = 0;
+    m_lines.Find( place, line, column );
+    return line;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::AddChars( const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    const unsigned long offset = static_cast< unsigned long >( m_chars.size() );
+    if ( NULL != begin )
+        m_chars.insert( m_chars.end(), begin, end );
+    m_chars.push_back( '\0' );
+    return offset;
+}
+
+// ----------------------------------------------------------------------------
+
+void ::Parser::ConfigDocument::GrowSlots( Slots & slots, unsigned long count,
+    bool forKeys )
+{
+    assert( NULL != this );
+
+    // Half empty slots keep probe runs short.
+    if ( ( count + 1 ) * 2 <= slots.size() )
+        return;
+    const unsigned long size = ( slots.empty() ) ? s_minSlotCount
+        : static_cast< unsigned long >( slots.size() * 2 );
+    slots.assign( size, NoIndex );
+    const unsigned long mask = size - 1;
+    for ( unsigned long ii = 0; ii < count; ++ii )
+    {
+        const unsigned long hash = forKeys ? m_keys[ ii ].m_hash : m_sections[ ii ].m_hash;
+        unsigned long place = hash & mask;
+        while ( NoIndex != slots[ place ] )
+            place = ( place + 1 ) & mask;
+        slots[ place ] = ii;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::FindSectionSlot( const char * begin,
+    const char * end, unsigned long hash ) const
+{
+    assert( NULL != this );
+    assert( !m_sectionSlots.empty() );
+
+    const unsigned long mask = static_cast< unsigned long >( m_sectionSlots.size() - 1 );
+    unsigned long place = hash & mask;
+    for ( ;; )
+    {
+        const unsigned long index = m_sectionSlots[ place ];
+        if ( NoIndex == index )
+            break;
+        const Section & section = m_sections[ index ];
+        if ( ( hash == section.m_hash )
+          && SameName( &m_chars[ section.m_name ], begin, end ) )
+            break;
+        place = ( place + 1 ) & mask;
+    }
+    return place;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::FindKeySlot( unsigned long section,
+    const char * begin, const char * end, unsigned long hash ) const
+{
+    assert( NULL != this );
+    assert( !m_keySlots.empty() );
+
+    const unsigned long mask = static_cast< unsigned long >( m_keySlots.size() - 1 );
+    unsigned long place = hash & mask;
+    for ( ;; )
+    {
+        const unsigned long index = m_keySlots[ place ];
+        if ( NoIndex == index )
+            break;
+        const Key & key = m_keys[ index ];
+        if ( ( hash == key.m_hash ) && ( section == key.m_section )
+          && SameName( &m_chars[ key.m_name ], begin, end ) )
+            break;
+        place = ( place + 1 ) & mask;
+    }
+    return place;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigDocument::AddSection( const char * nameStart, const char * nameEnd )
+{
+    assert( NULL != this );
+
+    const unsigned long hash = HashText( nameStart, nameEnd );
+    const unsigned long count = static_cast< unsigned long >( m_sections.size() );
+    GrowSlots( m_sectionSlots, count, false );
+    const unsigned long place = FindSectionSlot( nameStart, nameEnd, hash );
+    if ( NoIndex != m_sectionSlots[ place ] )
+    {
+        // Repeated section continues where earlier one left off.
+        m_current = m_sectionSlots[ place ];
+        return true;
+    }
+
+    Section section;
+    section.m_name = AddChars( nameStart, nameEnd );
+    section.m_hash = hash;
+    section.m_firstKey = NoIndex;
+    section.m_lastKey = NoIndex;
+    section.m_keyCount = 0;
+    section.m_line = GetLine( nameStart );
+    m_sections.push_back( section );
+    m_sectionSlots[ place ] = count;
+    m_current = count;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigDocument::AddKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    assert( m_current < m_sections.size() );
+
+    const unsigned long hash = HashKeyName( m_current, keyStart, keyEnd );
+    const unsigned long count = static_cast< unsigned long >( m_keys.size() );
+    GrowSlots( m_keySlots, count, true );
+    const unsigned long place = FindKeySlot( m_current, keyStart, keyEnd, hash );
+    if ( NoIndex != m_keySlots[ place ] )
+    {
+        Key & key = m_keys[ m_keySlots[ place ] ];
+        key.m_value = AddChars( valueStart, valueEnd );
+        key.m_line = GetLine( keyStart );
+        return true;
+    }
+
+    Key key;
+    key.m_section = m_current;
+    key.m_name = AddChars( keyStart, keyEnd );
+    key.m_value = AddChars( valueStart, valueEnd );
+    key.m_hash = hash;
+    key.m_nextKey = NoIndex;
+    key.m_line = GetLine( keyStart );
+    m_keys.push_back( key );
+    m_keySlots[ place ] = count;
+
+    Section & section = m_sections[ m_current ];
+    if ( NoIndex == section.m_lastKey )
+        section.m_firstKey = count;
+    else
+        m_keys[ section.m_lastKey ].m_nextKey = count;
+    section.m_lastKey = count;
+    ++section.m_keyCount;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigDocument::AddGlobalKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    m_current = 0;
+    return AddKey( keyStart, keyEnd, valueStart, valueEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigDocument::AddSectionKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    return AddKey( keyStart, keyEnd, valueStart, valueEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+void ::Parser::ConfigDocument::ParsedConfigFile( bool valid )
+{
+    assert( NULL != this );
+    m_valid = valid;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::FindSection( const char * name ) const
+{
+    assert( NULL != this );
+
+    if ( NULL == name )
+        name = s_empty;
+    const char * end = name + ::strlen( name );
+    const unsigned long place = FindSectionSlot( name, end, HashText( name, end ) );
+    return m_sectionSlots[ place ];
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::FindKey( unsigned long section,
+    const char * key ) const
+{
+    assert( NULL != this );
+    assert( NULL != key );
+
+    if ( ( m_sections.size() <= section ) || m_keySlots.empty() )
+        return NoIndex;
+    const char * end = key + ::strlen( key );
+    const unsigned long place = FindKeySlot( section, key, end,
+        HashKeyName( section, key, end ) );
+    return m_keySlots[ place ];
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ::Parser::ConfigDocument::Get( const char * section,
+    const char * key ) const
+{
+    assert( NULL != this );
+
+    const unsigned long index = FindKey( FindSection( section ), key );
+    return ( NoIndex == index ) ? NULL : &m_chars[ m_keys[ index ].m_value ];
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ::Parser::ConfigDocument::GetSectionName( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < m_sections.size() );
+    return &m_chars[ m_sections[ section ].m_name ];
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetSectionLine( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < m_sections.size() );
+    return m_sections[ section ].m_line;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetKeyCount( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < m_sections.size() );
+    return m_sections[ section ].m_keyCount;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetFirstKey( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < m_sections.size() );
+    return m_sections[ section ].m_firstKey;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetNextKey( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( key < m_keys.size() );
+    return m_keys[ key ].m_nextKey;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ::Parser::ConfigDocument::GetKeyName( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( key < m_keys.size() );
+    return &m_chars[ m_keys[ key ].m_name ];
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ::Parser::ConfigDocument::GetKeyValue( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( key < m_keys.size() );
+    return &m_chars[ m_keys[ key ].m_value ];
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ::Parser::ConfigDocument::GetKeyLine( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( key < m_keys.size() );
+    return m_keys[ key ].m_line;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
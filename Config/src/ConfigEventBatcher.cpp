@@ -0,0 +1,118 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigEventBatcher.cpp Adds events from a config parser to a buffer.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigEventBatcher.hpp"
+
+#include <assert.h>
+
+
+// ----------------------------------------------------------------------------
+
+const char * ::Parser::ConfigEventBatcher::GetEventName( unsigned short kind )
+{
+    switch ( kind )
+    {
+        case Section:    return "Section";
+        case GlobalKey:  return "GlobalKey";
+        case SectionKey: return "SectionKey";
+        case Value:      return "Value";
+        case EndFile:    return "EndFile";
+        default: break;
+    }
+    return "Unknown";
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigEventBatcher::ConfigEventBatcher( EventBuffer & buffer ) :
+    IConfigReceiver(),
+    m_buffer( buffer )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigEventBatcher::~ConfigEventBatcher( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::ConfigParser::ParseResults Parser::ConfigEventBatcher::Parse(
+    ConfigParser & parser, const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    // Rules add events straight to the buffer, with no call to this for each.
+    const ConfigParser::ParseResults result = parser.Parse( begin, end, m_buffer );
+    // Rules only add EndFile if they reached the end, which they always do
+    // unless the parser refused the chars or gave up.
+    if ( ( ConfigParser::AllValid != result ) && ( ConfigParser::SomeValid != result )
+      && ( ConfigParser::NotValid != result ) )
+        ParsedConfigFile( false );
+    else
+        // Rules do not flush if the buffer's receiver said to stop.
+        m_buffer.Flush();
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigEventBatcher::AddGlobalKey( const char * keyStart,
+    const char * keyEnd, const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    return m_buffer.AddPair( GlobalKey, 0, keyStart, keyEnd,
+        Value, 0, valueStart, valueEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigEventBatcher::AddSection( const char * nameStart,
+    const char * nameEnd )
+{
+    assert( NULL != this );
+    return m_buffer.Add( Section, 0, nameStart, nameEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+bool ::Parser::ConfigEventBatcher::AddSectionKey( const char * keyStart,
+    const char * keyEnd, const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    return m_buffer.AddPair( SectionKey, 0, keyStart, keyEnd,
+        Value, 0, valueStart, valueEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+void ::Parser::ConfigEventBatcher::ParsedConfigFile( bool valid )
+{
+    assert( NULL != this );
+    m_buffer.Add( EndFile, valid ? Valid : 0, NULL, NULL );
+    m_buffer.Flush();
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
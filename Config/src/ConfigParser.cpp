@@ -23,12 +23,13 @@
 #include <string.h>
 #include <memory.h>
 #include <string>
-#include <fstream>
+#include <memory>
 #include <algorithm>
 
 #include "../../Util/include/ParseUtil.hpp"
 #include "../../Util/include/ParseInfo.hpp"
 #include "../../Util/include/ErrorReceiver.hpp"
+#include "../../Util/include/FileBuffer.hpp"
 
 #include "ParserRules.hpp"
 #include "CommonParsers.hpp"
@@ -56,8 +57,6 @@ using namespace ::boost::spirit;
 
 // ----------------------------------------------------------------------------
 
-typedef istream_iterator< char > FileStreamIter;
-
 namespace
 {
 
@@ -93,49 +92,6 @@ inline bool IsGoodResult( ::Parser::ConfigParser::ParseResults result )
     return ::Parser::ConfigParser::NotValid;
 }
 
-// ChangeEmbeddedNils -------------------------------------------------------------------------
-
-bool ChangeEmbeddedNils( string & ss, char ch = '\0' )
-{
-
-    if ( ch == '\0' )
-        return false;
-    bool found = false;
-    string::iterator here( ss.begin() );
-    string::iterator last( ss.end() );
-    while ( here != last )
-    {
-        if ( '\0' == *here )
-        {
-            found = true;
-            *here = ch;
-        }
-        ++here;
-    }
-
-    return found;
-}
-
-// ReadFileIntoString -------------------------------------------------------------------------
-
-bool ReadFileIntoString( const char * filename, string & target )
-{
-
-    target.clear();
-    ifstream input( filename );
-    if ( input.fail() )
-        return false;
-    input.unsetf( ios::skipws ); // Must turn off whitespace skipping.
-
-    FileStreamIter first( input );
-    FileStreamIter last;
-    string temp( first, last );
-    ChangeEmbeddedNils( temp );
-    temp.swap( target );
-
-    return true;
-}
-
 // ----------------------------------------------------------------------------
 
 } // end anonymous namespace
@@ -213,6 +169,12 @@ public:
 
     void FreePolicy( void );
 
+    /// Gives message to receiver, and stops sending if receiver fails.
+    bool GiveMessage( const ParseMessage & message );
+
+    /// Counts errors, and throws once there are too many.
+    void CountError( ::Parser::ErrorLevel::Levels level );
+
     virtual bool PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
         const char * message );
 
@@ -226,10 +188,11 @@ public:
     virtual bool PrepareContentMessage( const char * section, const char * name,
         unsigned long line, unsigned long chars );
 
+    /// Gives contents to receiver, or adds them to events if that is not NULL.
     ConfigParser::ParseResults ParseContents( const char * start, const char * end,
-        IConfigReceiver * pReceiver );
+        IConfigReceiver * pReceiver, EventBuffer * pEvents );
 
-    void StartParse( void );
+    void StartParse( const char * start, const char * end );
 
     inline void EndParse( void ) { m_parsing = false; }
 
@@ -339,19 +302,19 @@ bool ConfigParserImpl::SetPolicy( const ConfigParser::ParserPolicy & policy )
 
 // ----------------------------------------------------------------------------
 
-void ConfigParserImpl::StartParse( void )
+void ConfigParserImpl::StartParse( const char * start, const char * end )
 {
     assert( NULL != this );
     m_parsing = true;
     m_ErrorCount = 0;
-    m_Counter.Reset();
+    m_Counter.Reset( start, end );
     m_Messages.Clear();
 }
 
 // ----------------------------------------------------------------------------
 
 ConfigParser::ParseResults ConfigParserImpl::ParseContents( const char * start, const char * end,
-    IConfigReceiver * pReceiver )
+    IConfigReceiver * pReceiver, EventBuffer * pEvents )
 {
     assert( NULL != this );
 
@@ -359,8 +322,9 @@ ConfigParser::ParseResults ConfigParserImpl::ParseContents( const char * start,
     unsigned long tempCount = 0;
     try
     {
-        StartParse();
+        StartParse( start, end );
         m_parser.SetReceiver( pReceiver );
+        m_parser.SetEventBuffer( pEvents );
         const SpiritRule & myRule = m_parser.GetRule();
         const ParseInfo::ParseResult result1 = m_results.Parse( start, end, myRule );
         result = Convert( result1 );
@@ -372,43 +336,32 @@ ConfigParser::ParseResults ConfigParserImpl::ParseContents( const char * start,
     PARSER_CATCH_STD_EXCP_BLOCK( "Exception thrown when parsing config contents!" )
     PARSER_CATCH_ALL_BLOCK( "Unknown exception thrown when parsing config contents!" )
 
+    m_parser.SetEventBuffer( NULL );
     return result;
 }
 
 // ----------------------------------------------------------------------------
 
-bool ConfigParserImpl::PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
-    const char * message )
+bool ConfigParserImpl::GiveMessage( const ParseMessage & message )
 {
     assert( NULL != this );
 
-    if ( ( NULL == message ) || ( '\0' == *message ) )
+    if ( NULL == m_pErrorReceiver )
         return false;
-    const unsigned int length = ::strlen( message );
-    const CharType * last = message + length;
-    const bool okay = PrepareErrorMessage( level, message, last );
-    return okay;
+    if ( !m_pErrorReceiver->ReceiveParseMessage( message ) )
+    {
+        m_pErrorReceiver = NULL;
+        return false;
+    }
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 
-bool ConfigParserImpl::PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
-    const char * first, const char * last )
+void ConfigParserImpl::CountError( ::Parser::ErrorLevel::Levels level )
 {
     assert( NULL != this );
-    assert( NULL != first );
-    assert( NULL != last );
-    assert( first < last );
-    (void)last;
 
-    if ( NULL == m_pErrorReceiver )
-        return false;
-    bool okay = true;
-    if ( !m_pErrorReceiver->GiveParseMessage( level, first ) )
-    {
-        m_pErrorReceiver = NULL;
-        okay = false;
-    }
     if ( ErrorLevel::Minor <= level )
     {
         ++m_ErrorCount;
@@ -417,46 +370,59 @@ bool ConfigParserImpl::PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
             throw XMaxErrorException();
         }
     }
-    return okay;
 }
 
 // ----------------------------------------------------------------------------
 
-bool ConfigParserImpl::PrepareContentMessage( const char * section )
+bool ConfigParserImpl::PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
+    const char * message )
 {
     assert( NULL != this );
-    if ( NULL == m_pErrorReceiver )
+
+    if ( ( NULL == message ) || ( '\0' == *message ) )
         return false;
-    if ( !m_pErrorReceiver->GiveParseMessage( ErrorLevel::Content, section ) )
-    {
-        m_pErrorReceiver = NULL;
+    if ( NULL == m_pErrorReceiver )
         return false;
-    }
-    return true;
+    ParseMessage parseMessage( level, message );
+    // Lines are only found for messages which are sent, never while parsing.
+    m_Counter.FindPlace( m_Messages.GetSendPlace(), parseMessage.m_line,
+        parseMessage.m_column );
+    const bool okay = GiveMessage( parseMessage );
+    CountError( level );
+    return okay;
 }
 
 // ----------------------------------------------------------------------------
 
-bool ConfigParserImpl::PrepareContentMessage( const char * section, const char * name )
+bool ConfigParserImpl::PrepareErrorMessage( ::Parser::ErrorLevel::Levels level,
+    const char * first, const char * last )
 {
     assert( NULL != this );
+    assert( NULL != first );
+    assert( NULL != last );
+    assert( first < last );
+
     if ( NULL == m_pErrorReceiver )
         return false;
+    const bool okay = GiveMessage( ParseMessage( level, first, last ) );
+    CountError( level );
+    return okay;
+}
 
-    unsigned long length = ::strlen( section ) + ::strlen( name ) + 100;
-    char * buffer = reinterpret_cast< char * >( ::malloc( length ) );
-    if ( NULL == buffer )
-        return false;
-    auto_ptr< char > temp( buffer );
+// ----------------------------------------------------------------------------
 
-    ::sprintf( buffer, "Inside %s section for %s\n", section, name );
-    if ( !m_pErrorReceiver->GiveParseMessage( ErrorLevel::Content, buffer ) )
-    {
-        m_pErrorReceiver = NULL;
-        return false;
-    }
+bool ConfigParserImpl::PrepareContentMessage( const char * section )
+{
+    assert( NULL != this );
+    return GiveMessage( ParseMessage( section, NULL, 0, 0 ) );
+}
 
-    return true;
+// ----------------------------------------------------------------------------
+
+bool ConfigParserImpl::PrepareContentMessage( const char * section, const char * name )
+{
+    assert( NULL != this );
+    return GiveMessage( ParseMessage( section, name, 0, 0 ) );
 }
 
 // ----------------------------------------------------------------------------
@@ -465,25 +431,7 @@ bool ConfigParserImpl::PrepareContentMessage( const char * section,
     const char * name, unsigned long line, unsigned long chars )
 {
     assert( NULL != this );
-
-    if ( NULL == m_pErrorReceiver )
-        return false;
-
-    unsigned long length = ::strlen( section ) + ::strlen( name ) + 200;
-    char * buffer = reinterpret_cast< char * >( ::malloc( length ) );
-    if ( NULL == buffer )
-        return false;
-    auto_ptr< char > temp( buffer );
-
-    ::sprintf( buffer, "Inside %s section for %s on line %u at char %u.\n",
-        section, name, line, chars );
-    if ( !m_pErrorReceiver->GiveParseMessage( ErrorLevel::Content, buffer ) )
-    {
-        m_pErrorReceiver = NULL;
-        return false;
-    }
-
-    return true;
+    return GiveMessage( ParseMessage( section, name, line, chars ) );
 }
 
 // ----------------------------------------------------------------------------
@@ -655,7 +603,31 @@ ConfigParser::ParseResults ConfigParser::Parse( const char * start, const char *
     if ( NULL == m_impl->m_pErrorReceiver )
         return ConfigParser::NoErrorRecv;
 
-    return m_impl->ParseContents( start, end, pReceiver );
+    return m_impl->ParseContents( start, end, pReceiver, NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigParser::ParseResults ConfigParser::Parse( const char * start, const char * end,
+    EventBuffer & events )
+{
+    assert( NULL != this );
+    assert( NULL != m_impl );
+
+    if ( m_impl->m_parsing )
+        return ConfigParser::ParsingNow;
+    if ( NULL == start )
+        return ConfigParser::NoStart;
+    if ( '\0' == *start )
+        return ConfigParser::EmptyData;
+    if ( NULL == end )
+        return ConfigParser::NoEnd;
+    if ( end  <= start )
+        return ConfigParser::LowerEnd;
+    if ( NULL == m_impl->m_pErrorReceiver )
+        return ConfigParser::NoErrorRecv;
+
+    return m_impl->ParseContents( start, end, NULL, &events );
 }
 
 // ----------------------------------------------------------------------------
@@ -677,30 +649,17 @@ ConfigParser::ParseResults ConfigParser::Parse( const char * filename,
     if ( NULL == m_impl->m_pErrorReceiver )
         return ConfigParser::NoErrorRecv;
 
-    string fileContents;
-    unsigned long contentSize = 0;
-    try
-    {
-        if ( !ReadFileIntoString( filename, fileContents ) )
-        {
-            return ConfigParser::CantOpenFile;
-        }
-
-        contentSize = fileContents.size();
-        if ( 0 == contentSize )
-            return ConfigParser::EmptyFile;
-        // Ensure that we have enough trailing newlines to eliminate
-        // the need to check for end of file in the grammar.
-        fileContents.push_back( '\n' );
-    }
-    catch ( ... )
-    {
+    // The grammar checks for end of data and embedded nils itself, so the file
+    // contents are parsed in place without copying or rewriting them.
+    FileBuffer fileContents;
+    if ( !fileContents.Open( filename ) )
         return ConfigParser::CantOpenFile;
-    }
+    if ( 0 == fileContents.GetSize() )
+        return ConfigParser::EmptyFile;
 
-    const char * start = fileContents.c_str();
-    const char * end = start + contentSize + 1;
-    return m_impl->ParseContents( start, end, pReceiver );
+    const char * start = fileContents.GetBegin();
+    const char * end = fileContents.GetEnd();
+    return m_impl->ParseContents( start, end, pReceiver, NULL );
 }
 
 // ----------------------------------------------------------------------------
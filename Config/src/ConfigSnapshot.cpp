@@ -0,0 +1,560 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigSnapshot.cpp Makes, checks, and reads binary images of config files.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigSnapshot.hpp"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "../include/ConfigDocument.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Spells CFGS in memory on a little-endian machine.
+const unsigned int s_magic = 0x53474643UL;
+
+/// Largest size or offset an image can hold.
+const size_t s_maxImageSize = 0xFFFFFFF0UL;
+
+typedef char WordMustHold32Bits[ ( 4 == sizeof( unsigned int ) ) ? 1 : -1 ];
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if count items of itemSize bytes fit at offset within size.
+inline bool PartFits( unsigned long offset, unsigned long count, unsigned long itemSize,
+    unsigned long size )
+{
+    if ( ( 0 != ( offset % sizeof( unsigned int ) ) ) || ( size < offset ) )
+        return false;
+    return ( count <= ( size - offset ) / itemSize );
+}
+
+// ----------------------------------------------------------------------------
+
+inline bool IsPowerOfTwo( unsigned long count )
+{
+    return ( 0 != count ) && ( 0 == ( count & ( count - 1 ) ) );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if each slot is empty or refers to an item.
+inline bool SlotsFit( const unsigned int * slots, unsigned long slotCount,
+    unsigned long itemCount )
+{
+    for ( unsigned long ii = 0; ii < slotCount; ++ii )
+    {
+        if ( ( ::Parser::ConfigSnapshot::NoIndex != slots[ ii ] ) && ( itemCount <= slots[ ii ] ) )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if nil-terminated chars match chars from begin to end.
+inline bool SameName( const char * name, const char * begin, const char * end )
+{
+    const size_t length = static_cast< size_t >( end - begin );
+    return ( 0 == ::strncmp( name, begin, length ) ) && ( '\0' == name[ length ] );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns next part offset after count items of itemSize bytes.
+inline size_t AddPart( size_t offset, size_t count, size_t itemSize )
+{
+    return offset + count * itemSize;
+}
+
+// ----------------------------------------------------------------------------
+
+} // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigSnapshot::Name( ConfigSnapshot::LoadResults result )
+{
+    switch ( result )
+    {
+        case Mapped:    return "Image file matched config file and is used in place.";
+        case Rebuilt:   return "Config file was parsed, and a new image was saved.";
+        case NotSaved:  return "Config file was parsed, but the image file could not be written.";
+        case NotValid:  return "Config file was parsed, but it is not valid.";
+        case NoSource:  return "Config file could not be opened.";
+    }
+    return "Unknown load result";
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSnapshot::ConfigSnapshot( void ) :
+    m_file(),
+    m_made(),
+    m_image( NULL ),
+    m_header( NULL ),
+    m_sections( NULL ),
+    m_keys( NULL ),
+    m_sectionSlots( NULL ),
+    m_keySlots( NULL ),
+    m_chars( NULL )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSnapshot::~ConfigSnapshot( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSnapshot::Close( void )
+{
+    assert( NULL != this );
+
+    m_image = NULL;
+    m_header = NULL;
+    m_sections = NULL;
+    m_keys = NULL;
+    m_sectionSlots = NULL;
+    m_keySlots = NULL;
+    m_chars = NULL;
+    m_file.Close();
+    m_made.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::MakeImage( const ConfigDocument & document,
+    const char * sourceBegin, const char * sourceEnd, ::std::vector< char > & image )
+{
+    const size_t sectionCount = document.m_sections.size();
+    const size_t keyCount = document.m_keys.size();
+    const size_t sectionSlotCount = document.m_sectionSlots.size();
+    const size_t keySlotCount = document.m_keySlots.size();
+    const size_t charCount = document.m_chars.size();
+    const size_t sourceSize = static_cast< size_t >( sourceEnd - sourceBegin );
+
+    const size_t sections = sizeof( Header );
+    const size_t keys = AddPart( sections, sectionCount, sizeof( Section ) );
+    const size_t sectionSlots = AddPart( keys, keyCount, sizeof( Key ) );
+    const size_t keySlots = AddPart( sectionSlots, sectionSlotCount, sizeof( Word ) );
+    const size_t chars = AddPart( keySlots, keySlotCount, sizeof( Word ) );
+    const size_t size = chars + charCount;
+    if ( ( s_maxImageSize < size ) || ( s_maxImageSize < sourceSize ) )
+        return false;
+
+    image.assign( size, '\0' );
+    char * place = &image[ 0 ];
+
+    Header * header = reinterpret_cast< Header * >( place );
+    header->m_magic = s_magic;
+    header->m_version = Version;
+    header->m_imageSize = static_cast< Word >( size );
+    header->m_sourceSize = static_cast< Word >( sourceSize );
+    header->m_sourceHash = static_cast< Word >( ConfigDocument::HashText( sourceBegin, sourceEnd ) );
+    header->m_valid = document.IsValid() ? 1 : 0;
+    header->m_sectionCount = static_cast< Word >( sectionCount );
+    header->m_keyCount = static_cast< Word >( keyCount );
+    header->m_sectionSlotCount = static_cast< Word >( sectionSlotCount );
+    header->m_keySlotCount = static_cast< Word >( keySlotCount );
+    header->m_charCount = static_cast< Word >( charCount );
+    header->m_sections = static_cast< Word >( sections );
+    header->m_keys = static_cast< Word >( keys );
+    header->m_sectionSlots = static_cast< Word >( sectionSlots );
+    header->m_keySlots = static_cast< Word >( keySlots );
+    header->m_chars = static_cast< Word >( chars );
+
+    Section * section = reinterpret_cast< Section * >( place + sections );
+    for ( size_t ii = 0; ii < sectionCount; ++ii, ++section )
+    {
+        const ConfigDocument::Section & from = document.m_sections[ ii ];
+        section->m_name = static_cast< Word >( from.m_name );
+        section->m_hash = static_cast< Word >( from.m_hash );
+        section->m_firstKey = static_cast< Word >( from.m_firstKey );
+        section->m_keyCount = static_cast< Word >( from.m_keyCount );
+        section->m_line = static_cast< Word >( from.m_line );
+    }
+
+    Key * key = reinterpret_cast< Key * >( place + keys );
+    for ( size_t ii = 0; ii < keyCount; ++ii, ++key )
+    {
+        const ConfigDocument::Key & from = document.m_keys[ ii ];
+        key->m_section = static_cast< Word >( from.m_section );
+        key->m_name = static_cast< Word >( from.m_name );
+        key->m_value = static_cast< Word >( from.m_value );
+        key->m_hash = static_cast< Word >( from.m_hash );
+        key->m_nextKey = static_cast< Word >( from.m_nextKey );
+        key->m_line = static_cast< Word >( from.m_line );
+    }
+
+    Word * slot = reinterpret_cast< Word * >( place + sectionSlots );
+    for ( size_t ii = 0; ii < sectionSlotCount; ++ii )
+        slot[ ii ] = static_cast< Word >( document.m_sectionSlots[ ii ] );
+    slot = reinterpret_cast< Word * >( place + keySlots );
+    for ( size_t ii = 0; ii < keySlotCount; ++ii )
+        slot[ ii ] = static_cast< Word >( document.m_keySlots[ ii ] );
+
+    if ( 0 != charCount )
+        ::memcpy( place + chars, &document.m_chars[ 0 ], charCount );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::CheckImage( const char * image, unsigned long size ) const
+{
+    assert( NULL != this );
+
+    if ( ( NULL == image ) || ( size < sizeof( Header ) )
+      || ( 0 != ( reinterpret_cast< size_t >( image ) % sizeof( Word ) ) ) )
+        return false;
+    const Header & header = *reinterpret_cast< const Header * >( image );
+    if ( ( s_magic != header.m_magic ) || ( Version != header.m_version )
+      || ( size != header.m_imageSize ) )
+        return false;
+
+    const unsigned long sectionCount = header.m_sectionCount;
+    const unsigned long keyCount = header.m_keyCount;
+    const unsigned long charCount = header.m_charCount;
+    // Each table needs an empty slot, or a search for a missing name never ends.
+    if ( ( 0 == sectionCount ) || ( 0 == charCount )
+      || !IsPowerOfTwo( header.m_sectionSlotCount ) || !IsPowerOfTwo( header.m_keySlotCount )
+      || ( header.m_sectionSlotCount <= sectionCount ) || ( header.m_keySlotCount <= keyCount ) )
+        return false;
+    if ( !PartFits( header.m_sections, sectionCount, sizeof( Section ), size )
+      || !PartFits( header.m_keys, keyCount, sizeof( Key ), size )
+      || !PartFits( header.m_sectionSlots, header.m_sectionSlotCount, sizeof( Word ), size )
+      || !PartFits( header.m_keySlots, header.m_keySlotCount, sizeof( Word ), size )
+      || ( size < header.m_chars ) || ( size - header.m_chars < charCount ) )
+        return false;
+
+    const char * chars = image + header.m_chars;
+    if ( '\0' != chars[ charCount - 1 ] )
+        return false;
+
+    // Every index and offset is checked once here, so lookups need not check.
+    const Section * sections = reinterpret_cast< const Section * >( image + header.m_sections );
+    for ( unsigned long ii = 0; ii < sectionCount; ++ii )
+    {
+        const Section & section = sections[ ii ];
+        if ( ( charCount <= section.m_name )
+          || ( ( NoIndex != section.m_firstKey ) && ( keyCount <= section.m_firstKey ) ) )
+            return false;
+    }
+    const Key * keys = reinterpret_cast< const Key * >( image + header.m_keys );
+    for ( unsigned long ii = 0; ii < keyCount; ++ii )
+    {
+        const Key & key = keys[ ii ];
+        // Keys are linked in the order they were added, so links only go forward.
+        if ( ( sectionCount <= key.m_section ) || ( charCount <= key.m_name )
+          || ( charCount <= key.m_value )
+          || ( ( NoIndex != key.m_nextKey )
+            && ( ( keyCount <= key.m_nextKey ) || ( key.m_nextKey <= ii ) ) ) )
+            return false;
+    }
+    const Word * sectionSlots = reinterpret_cast< const Word * >( image + header.m_sectionSlots );
+    const Word * keySlots = reinterpret_cast< const Word * >( image + header.m_keySlots );
+    return SlotsFit( sectionSlots, header.m_sectionSlotCount, sectionCount )
+        && SlotsFit( keySlots, header.m_keySlotCount, keyCount );
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::Attach( const char * image, unsigned long size,
+    const char * sourceBegin, const char * sourceEnd )
+{
+    assert( NULL != this );
+
+    m_image = NULL;
+    m_header = NULL;
+    if ( !CheckImage( image, size ) )
+        return false;
+    const Header * header = reinterpret_cast< const Header * >( image );
+    if ( NULL != sourceBegin )
+    {
+        const unsigned long sourceSize = static_cast< unsigned long >( sourceEnd - sourceBegin );
+        if ( ( header->m_sourceSize != sourceSize )
+          || ( header->m_sourceHash != ConfigDocument::HashText( sourceBegin, sourceEnd ) ) )
+            return false;
+    }
+
+    m_image = image;
+    m_header = header;
+    m_sections = reinterpret_cast< const Section * >( image + header->m_sections );
+    m_keys = reinterpret_cast< const Key * >( image + header->m_keys );
+    m_sectionSlots = reinterpret_cast< const Word * >( image + header->m_sectionSlots );
+    m_keySlots = reinterpret_cast< const Word * >( image + header->m_keySlots );
+    m_chars = image + header->m_chars;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSnapshot::LoadResults ConfigSnapshot::Load( ConfigParser & parser,
+    const char * sourceFile, const char * imageFile )
+{
+    assert( NULL != this );
+
+    Close();
+    FileBuffer source;
+    if ( ( NULL == sourceFile ) || !source.Open( sourceFile ) )
+        return NoSource;
+    const char * begin = source.GetBegin();
+    const char * end = source.GetEnd();
+    if ( ( NULL != imageFile ) && m_file.Open( imageFile )
+      && Attach( m_file.GetBegin(), m_file.GetSize(), begin, end ) )
+        return Mapped;
+    m_file.Close();
+
+    ConfigDocument document;
+    document.Parse( parser, begin, end );
+    if ( !MakeImage( document, begin, end, m_made ) )
+    {
+        m_made.clear();
+        return NotSaved;
+    }
+    Attach( &m_made[ 0 ], static_cast< unsigned long >( m_made.size() ), NULL, NULL );
+    assert( IsOpen() );
+
+    // An image of a broken file would hide the errors on every later start.
+    if ( !document.IsValid() )
+        return NotValid;
+    if ( NULL == imageFile )
+        return Rebuilt;
+    return Save( imageFile ) ? Rebuilt : NotSaved;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::Save( const char * filename ) const
+{
+    assert( NULL != this );
+
+    if ( !IsOpen() || ( NULL == filename ) )
+        return false;
+
+    // Write a new file and rename it, so other processes which mapped the old
+    // file keep seeing all of it.
+    const ::std::string temporary = ::std::string( filename ) + ".new";
+    FILE * file = ::fopen( temporary.c_str(), "wb" );
+    if ( NULL == file )
+        return false;
+    const size_t size = m_header->m_imageSize;
+    const bool wrote = ( size == ::fwrite( m_image, 1, size, file ) );
+    if ( ( 0 != ::fclose( file ) ) || !wrote )
+    {
+        ::remove( temporary.c_str() );
+        return false;
+    }
+#if defined( _WIN32 )
+    ::remove( filename );
+#endif
+    if ( 0 != ::rename( temporary.c_str(), filename ) )
+    {
+        ::remove( temporary.c_str() );
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::IsMapped( void ) const
+{
+    assert( NULL != this );
+    return IsOpen() && ( m_image == m_file.GetBegin() ) && m_file.IsMapped();
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSnapshot::IsValid( void ) const
+{
+    assert( NULL != this );
+    return IsOpen() && ( 0 != m_header->m_valid );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetImageSize( void ) const
+{
+    assert( NULL != this );
+    return IsOpen() ? m_header->m_imageSize : 0;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::FindSection( const char * name ) const
+{
+    assert( NULL != this );
+
+    if ( !IsOpen() )
+        return NoIndex;
+    if ( NULL == name )
+        name = "";
+    const char * end = name + ::strlen( name );
+    const unsigned long hash = ConfigDocument::HashText( name, end );
+    const unsigned long mask = m_header->m_sectionSlotCount - 1;
+    for ( unsigned long place = hash & mask; ; place = ( place + 1 ) & mask )
+    {
+        const unsigned long index = m_sectionSlots[ place ];
+        if ( NoIndex == index )
+            return NoIndex;
+        const Section & section = m_sections[ index ];
+        if ( ( hash == section.m_hash ) && SameName( m_chars + section.m_name, name, end ) )
+            return index;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::FindKey( unsigned long section, const char * key ) const
+{
+    assert( NULL != this );
+    assert( NULL != key );
+
+    if ( !IsOpen() || ( m_header->m_sectionCount <= section ) )
+        return NoIndex;
+    const char * end = key + ::strlen( key );
+    const unsigned long hash = ConfigDocument::HashKeyName( section, key, end );
+    const unsigned long mask = m_header->m_keySlotCount - 1;
+    for ( unsigned long place = hash & mask; ; place = ( place + 1 ) & mask )
+    {
+        const unsigned long index = m_keySlots[ place ];
+        if ( NoIndex == index )
+            return NoIndex;
+        const Key & found = m_keys[ index ];
+        if ( ( hash == found.m_hash ) && ( section == found.m_section )
+          && SameName( m_chars + found.m_name, key, end ) )
+            return index;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigSnapshot::Get( const char * section, const char * key ) const
+{
+    assert( NULL != this );
+
+    const unsigned long index = FindKey( FindSection( section ), key );
+    return ( NoIndex == index ) ? NULL : m_chars + m_keys[ index ].m_value;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetSectionCount( void ) const
+{
+    assert( NULL != this );
+    return IsOpen() ? m_header->m_sectionCount : 0;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigSnapshot::GetSectionName( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < GetSectionCount() );
+    return m_chars + m_sections[ section ].m_name;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetSectionLine( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < GetSectionCount() );
+    return m_sections[ section ].m_line;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetKeyCount( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < GetSectionCount() );
+    return m_sections[ section ].m_keyCount;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetFirstKey( unsigned long section ) const
+{
+    assert( NULL != this );
+    assert( section < GetSectionCount() );
+    return m_sections[ section ].m_firstKey;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetNextKey( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( IsOpen() && ( key < m_header->m_keyCount ) );
+    return m_keys[ key ].m_nextKey;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigSnapshot::GetKeyName( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( IsOpen() && ( key < m_header->m_keyCount ) );
+    return m_chars + m_keys[ key ].m_name;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * ConfigSnapshot::GetKeyValue( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( IsOpen() && ( key < m_header->m_keyCount ) );
+    return m_chars + m_keys[ key ].m_value;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSnapshot::GetKeyLine( unsigned long key ) const
+{
+    assert( NULL != this );
+    assert( IsOpen() && ( key < m_header->m_keyCount ) );
+    return m_keys[ key ].m_line;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,514 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigSplitParser.cpp Parses pieces of one config file on many threads.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigSplitParser.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <exception>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Default number of chars in each piece.
+const unsigned long s_defaultPieceSize = 256 * 1024;
+
+// ----------------------------------------------------------------------------
+
+/// Kinds of receiver calls a PieceRecorder keeps.
+enum CallType
+{
+    GlobalKeyCall,
+    SectionCall,
+    SectionKeyCall
+};
+
+/// One receiver call made while parsing a piece.
+struct Call
+{
+    CallType m_type;
+    const char * m_keyStart;
+    const char * m_keyEnd;
+    const char * m_valueStart;
+    const char * m_valueEnd;
+};
+
+typedef ::std::vector< Call > Calls;
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if chars from place start with all of nil-terminated text.
+inline bool StartsWith( const char * place, const char * end, const char * text )
+{
+    for ( ; '\0' != *text; ++place, ++text )
+    {
+        if ( ( place == end ) || ( *place != *text ) )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Keeps the calls a parser makes for one piece.
+class PieceRecorder : public ::Parser::IConfigReceiver
+{
+public:
+
+    inline PieceRecorder( void ) : IConfigReceiver(), m_calls( NULL ) {}
+
+    virtual ~PieceRecorder( void ) {}
+
+    /// Starts keeping calls for a piece.
+    inline void Start( Calls * calls ) { m_calls = calls; }
+
+    virtual bool AddGlobalKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd )
+    {
+        return Add( GlobalKeyCall, keyStart, keyEnd, valueStart, valueEnd );
+    }
+
+    virtual bool AddSection( const char * nameStart, const char * nameEnd )
+    {
+        return Add( SectionCall, nameStart, nameEnd, NULL, NULL );
+    }
+
+    virtual bool AddSectionKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd )
+    {
+        return Add( SectionKeyCall, keyStart, keyEnd, valueStart, valueEnd );
+    }
+
+    /// The parse result says the same, so this is not kept.
+    virtual void ParsedConfigFile( bool ) {}
+
+private:
+
+    /// Not implemented.
+    PieceRecorder( const PieceRecorder & );
+    /// Not implemented.
+    PieceRecorder & operator = ( const PieceRecorder & );
+
+    inline bool Add( CallType type, const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd )
+    {
+        assert( NULL != m_calls );
+        const Call call = { type, keyStart, keyEnd, valueStart, valueEnd };
+        m_calls->push_back( call );
+        return true;
+    }
+
+    Calls * m_calls;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Parser, message counter, and recorder used by one thread.
+struct SplitWorker
+{
+    ::Parser::ConfigParser m_parser;
+    ::Parser::MessageCollector m_messages;
+    PieceRecorder m_recorder;
+};
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+class ConfigSplitParser::Impl
+{
+public:
+
+    /// Part of the file parsed by one job.
+    struct Piece
+    {
+        const char * m_begin;
+        const char * m_end;
+        ConfigParser::ParseResults m_result;
+        unsigned long m_messageCount;
+        Calls m_calls;
+    };
+
+    typedef ::std::vector< Piece > Pieces;
+
+    Impl( void );
+
+    ~Impl( void ) {}
+
+    /// Returns true if the first item on the line starting at place is a section.
+    bool IsSectionLine( const char * place, const char * end ) const;
+
+    /// Makes pieces, each after the first starting at a section line.
+    void Split( const char * begin, const char * end, unsigned long count );
+
+    /// Parses one piece with parts of one thread.
+    void ParsePiece( SplitWorker & worker, unsigned long index );
+
+    /// Gives recorded calls to receiver, in order, until it stops taking them.
+    void Give( const Calls & calls );
+
+    /// Gives message to message receiver, as ConfigParser does for exceptions.
+    void SendMessage( ErrorLevel::Levels level, const char * message );
+
+    /// Drops pieces and recorded calls.
+    void Clear( void );
+
+    ConfigParser m_parser;
+    unsigned long m_pieceSize;
+    ConfigSplitStats m_stats;
+    Pieces m_pieces;
+    bool m_parsing;
+
+    /// Receiver, or NULL if it stopped taking calls.
+    IConfigReceiver * m_receiver;
+
+private:
+
+    /// Not implemented.
+    Impl( const Impl & );
+    /// Not implemented.
+    Impl & operator = ( const Impl & );
+};
+
+// ----------------------------------------------------------------------------
+
+ConfigSplitParser::Impl::Impl( void ) :
+    m_parser(),
+    m_pieceSize( s_defaultPieceSize ),
+    m_stats(),
+    m_pieces(),
+    m_parsing( false ),
+    m_receiver( NULL )
+{
+    assert( NULL != this );
+    m_stats.m_pieces = 0;
+    m_stats.m_reparsed = false;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSplitParser::Impl::IsSectionLine( const char * place, const char * end ) const
+{
+    assert( NULL != this );
+
+    const ConfigParser::ParserPolicy & policy = m_parser.GetPolicy();
+    while ( ( place != end ) && ( ( ' ' == *place ) || ( '\t' == *place ) ) )
+        ++place;
+    // The grammar tries comments before sections, so a comment delimiter which
+    // starts with the section starter still makes a comment.
+    if ( StartsWith( place, end, policy.BlockCommentStarter )
+      || StartsWith( place, end, policy.LineComment ) )
+        return false;
+    return ( '\0' != *policy.SectionNameStarter )
+        && StartsWith( place, end, policy.SectionNameStarter );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::Impl::Split( const char * begin, const char * end,
+    unsigned long count )
+{
+    assert( NULL != this );
+    assert( 1 < count );
+
+    Piece piece;
+    piece.m_begin = begin;
+    piece.m_end = end;
+    piece.m_result = ConfigParser::NotParsed;
+    piece.m_messageCount = 0;
+    m_pieces.clear();
+    m_pieces.reserve( count );
+    m_pieces.push_back( piece );
+
+    // Each search starts where the last one stopped, so no line is looked at twice.
+    const char * place = begin;
+    for ( unsigned long ii = 1; ii < count; ++ii )
+    {
+        const char * guess = begin + ii * m_pieceSize;
+        if ( place < guess )
+            place = guess;
+        do
+        {
+            const void * found = ::memchr( place, '\n', static_cast< size_t >( end - place ) );
+            place = ( NULL == found ) ? end : static_cast< const char * >( found ) + 1;
+        }
+        while ( ( place != end ) && !IsSectionLine( place, end ) );
+        if ( place == end )
+            break;
+        m_pieces.back().m_end = place;
+        piece.m_begin = place;
+        m_pieces.push_back( piece );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::Impl::ParsePiece( SplitWorker & worker, unsigned long index )
+{
+    assert( NULL != this );
+    assert( index < m_pieces.size() );
+
+    Piece & piece = m_pieces[ index ];
+    piece.m_result = ConfigParser::Exception;
+    piece.m_messageCount = 0;
+    piece.m_calls.clear();
+    worker.m_messages.SetTarget( NULL, &piece.m_messageCount );
+    worker.m_recorder.Start( &piece.m_calls );
+    piece.m_result = worker.m_parser.Parse( piece.m_begin, piece.m_end, &worker.m_recorder );
+    worker.m_messages.SetTarget( NULL, NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::Impl::Give( const Calls & calls )
+{
+    assert( NULL != this );
+
+    for ( Calls::const_iterator it( calls.begin() );
+        ( it != calls.end() ) && ( NULL != m_receiver ); ++it )
+    {
+        const Call & call = *it;
+        bool keep = false;
+        switch ( call.m_type )
+        {
+            case GlobalKeyCall:
+                keep = m_receiver->AddGlobalKey( call.m_keyStart, call.m_keyEnd,
+                    call.m_valueStart, call.m_valueEnd );
+                break;
+            case SectionCall:
+                keep = m_receiver->AddSection( call.m_keyStart, call.m_keyEnd );
+                break;
+            case SectionKeyCall:
+                keep = m_receiver->AddSectionKey( call.m_keyStart, call.m_keyEnd,
+                    call.m_valueStart, call.m_valueEnd );
+                break;
+        }
+        if ( !keep )
+            m_receiver = NULL;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::Impl::SendMessage( ErrorLevel::Levels level, const char * message )
+{
+    assert( NULL != this );
+
+    IParseErrorReceiver * receiver = m_parser.GetMessageReceiver();
+    if ( NULL != receiver )
+        receiver->ReceiveParseMessage( ParseMessage( level, message ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::Impl::Clear( void )
+{
+    assert( NULL != this );
+    Pieces().swap( m_pieces );
+    m_receiver = NULL;
+    m_parsing = false;
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSplitParser::ConfigSplitParser( unsigned long threadCount ) :
+    BatchRunner( threadCount ),
+    m_impl( new Impl )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSplitParser::~ConfigSplitParser( void )
+{
+    assert( NULL != this );
+    delete m_impl;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSplitParser::SetMessageReceiver( IParseErrorReceiver * pReceiver )
+{
+    assert( NULL != this );
+    return m_impl->m_parser.SetMessageReceiver( pReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+IParseErrorReceiver * ConfigSplitParser::GetMessageReceiver( void )
+{
+    assert( NULL != this );
+    return m_impl->m_parser.GetMessageReceiver();
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigSplitParser::SetPolicy( const ConfigParser::ParserPolicy & policy )
+{
+    assert( NULL != this );
+    return m_impl->m_parser.SetPolicy( policy );
+}
+
+// ----------------------------------------------------------------------------
+
+const ConfigParser::ParserPolicy & ConfigSplitParser::GetPolicy( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_parser.GetPolicy();
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::SetPieceSize( unsigned long size )
+{
+    assert( NULL != this );
+    m_impl->m_pieceSize = ( 0 == size ) ? s_defaultPieceSize : size;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigSplitParser::GetPieceSize( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_pieceSize;
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigSplitStats ConfigSplitParser::GetSplitStats( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_stats;
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigParser::ParseResults ConfigSplitParser::Parse( const char * start,
+    const char * end, IConfigReceiver * pReceiver )
+{
+    assert( NULL != this );
+
+    Impl & impl = *m_impl;
+    if ( impl.m_parsing )
+        return ConfigParser::ParsingNow;
+    impl.m_stats.m_pieces = 0;
+    impl.m_stats.m_reparsed = false;
+    const unsigned long count = ( ( NULL == start ) || ( end <= start ) ) ? 0
+        : static_cast< unsigned long >( end - start ) / impl.m_pieceSize;
+    if ( ( count < 2 ) || ( GetThreadCount() < 2 ) || ( NULL == pReceiver )
+      || ( NULL == impl.m_parser.GetMessageReceiver() ) || ( '\0' == *start ) )
+        return impl.m_parser.Parse( start, end, pReceiver );
+
+    impl.Split( start, end, count );
+    const unsigned long pieceCount = static_cast< unsigned long >( impl.m_pieces.size() );
+    if ( pieceCount < 2 )
+    {
+        impl.Clear();
+        return impl.m_parser.Parse( start, end, pReceiver );
+    }
+
+    impl.m_stats.m_pieces = pieceCount;
+    impl.m_parsing = true;
+    RunJobs( pieceCount );
+    for ( unsigned long ii = 0; ii < pieceCount; ++ii )
+    {
+        const Impl::Piece & piece = impl.m_pieces[ ii ];
+        if ( ( ConfigParser::AllValid != piece.m_result ) || ( 0 != piece.m_messageCount ) )
+        {
+            // Messages from pieces may differ from those of one pass, as when
+            // too many errors stop parsing, so parse once more to get those.
+            impl.Clear();
+            impl.m_stats.m_reparsed = true;
+            return impl.m_parser.Parse( start, end, pReceiver );
+        }
+    }
+
+    ConfigParser::ParseResults result = ConfigParser::AllValid;
+    impl.m_receiver = pReceiver;
+    try
+    {
+        for ( unsigned long ii = 0; ii < pieceCount; ++ii )
+        {
+            Impl::Piece & piece = impl.m_pieces[ ii ];
+            impl.Give( piece.m_calls );
+            Calls().swap( piece.m_calls );
+        }
+        if ( NULL != impl.m_receiver )
+            impl.m_receiver->ParsedConfigFile( true );
+    }
+    catch ( const ::std::exception & ex )
+    {
+        impl.SendMessage( ErrorLevel::Except, ex.what() );
+        impl.SendMessage( ErrorLevel::Except, "Exception thrown when parsing config contents!" );
+        result = ConfigParser::Exception;
+    }
+    catch ( ... )
+    {
+        impl.SendMessage( ErrorLevel::Except, "Unknown exception thrown when parsing config contents!" );
+        result = ConfigParser::Exception;
+    }
+    impl.Clear();
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+void * ConfigSplitParser::MakeWorker( void )
+{
+    assert( NULL != this );
+    SplitWorker * worker = new SplitWorker;
+    worker->m_parser.SetMessageReceiver( &worker->m_messages );
+    // Rules point at the strings of the policy, which this parser keeps.
+    worker->m_parser.SetPolicy( m_impl->m_parser.GetPolicy() );
+    return worker;
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::RunJob( void * worker, unsigned long job )
+{
+    assert( NULL != this );
+    m_impl->ParsePiece( *reinterpret_cast< SplitWorker * >( worker ), job );
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigSplitParser::DestroyWorker( void * worker )
+{
+    assert( NULL != this );
+    delete reinterpret_cast< SplitWorker * >( worker );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
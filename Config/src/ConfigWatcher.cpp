@@ -0,0 +1,605 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ConfigWatcher.cpp Watches config files and gives changes in their contents.
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/ConfigWatcher.hpp"
+
+#include <assert.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <string>
+#include <vector>
+
+#include "../include/ConfigDocument.hpp"
+#include "../../Util/include/FileBuffer.hpp"
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <sys/time.h>
+    #include <unistd.h>
+    #if defined( __linux__ )
+        #include <poll.h>
+        #include <sys/inotify.h>
+    #endif
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+using ::Parser::ConfigDocument;
+using ::Parser::IConfigChangeReceiver;
+
+#if defined( __linux__ )
+/// Writers close a file when done, or rename a finished file over it.
+const unsigned int s_watchEvents = IN_CLOSE_WRITE | IN_MOVED_TO;
+#endif
+
+// ----------------------------------------------------------------------------
+
+/// Returns a time in microseconds, only useful for finding elapsed times.
+unsigned long GetMicroseconds( void )
+{
+#if defined( _WIN32 )
+    return static_cast< unsigned long >( ::GetTickCount() ) * 1000;
+#else
+    timeval now;
+    ::gettimeofday( &now, NULL );
+    return static_cast< unsigned long >( now.tv_sec ) * 1000000
+        + static_cast< unsigned long >( now.tv_usec );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+struct WatchedFile
+{
+    explicit WatchedFile( const char * filename ) :
+        m_name( filename ), m_folder(), m_base(), m_watch( -1 ),
+        m_document( new ConfigDocument ), m_spare( new ConfigDocument ),
+        m_read( false ), m_size( 0 ), m_hash( 0 ), m_modified( 0 ),
+        m_statSize( 0 ), m_dirty( false ) {}
+
+    ~WatchedFile( void )
+    {
+        delete m_document;
+        delete m_spare;
+    }
+
+    ::std::string m_name;
+    /// Folder and name within folder, which inotify reports separately.
+    ::std::string m_folder;
+    ::std::string m_base;
+    int m_watch;
+    /// Last valid contents, and a spare which receives the next parse.
+    ConfigDocument * m_document;
+    ConfigDocument * m_spare;
+    /// Size and hash of bytes last read, valid or not.
+    bool m_read;
+    unsigned long m_size;
+    unsigned long m_hash;
+    /// Time and size from stat, for platforms without notices.
+    time_t m_modified;
+    off_t m_statSize;
+    bool m_dirty;
+
+private:
+
+    /// Not implemented.
+    WatchedFile( const WatchedFile & );
+    /// Not implemented.
+    WatchedFile & operator = ( const WatchedFile & );
+};
+
+typedef ::std::vector< WatchedFile * > WatchedFiles;
+
+// ----------------------------------------------------------------------------
+
+/// Gives changes between two documents to a receiver, and counts them.
+class Differ
+{
+public:
+
+    Differ( const char * filename, IConfigChangeReceiver * receiver ) :
+        m_filename( filename ), m_receiver( receiver ), m_count( 0 ) {}
+
+    void Compare( const ConfigDocument & before, const ConfigDocument & after );
+
+    unsigned long GetCount( void ) const { return m_count; }
+
+private:
+
+    /// Not implemented.
+    Differ & operator = ( const Differ & );
+
+    void Give( IConfigChangeReceiver::Changes change, const char * section,
+        const char * key, const char * oldValue, const char * newValue )
+    {
+        ++m_count;
+        if ( NULL != m_receiver )
+            m_receiver->ChangedConfig( m_filename, change, section, key, oldValue, newValue );
+    }
+
+    const char * m_filename;
+    IConfigChangeReceiver * m_receiver;
+    unsigned long m_count;
+};
+
+// ----------------------------------------------------------------------------
+
+void Differ::Compare( const ConfigDocument & before, const ConfigDocument & after )
+{
+    const unsigned long NoIndex = ConfigDocument::NoIndex;
+
+    // Section 0 holds global keys, and is in every document.
+    for ( unsigned long ii = 0; ii < before.GetSectionCount(); ++ii )
+    {
+        const char * section = before.GetSectionName( ii );
+        const unsigned long other = ( 0 == ii ) ? 0 : after.FindSection( section );
+        for ( unsigned long key = before.GetFirstKey( ii ); NoIndex != key;
+            key = before.GetNextKey( key ) )
+        {
+            const char * name = before.GetKeyName( key );
+            if ( ( NoIndex == other ) || ( NoIndex == after.FindKey( other, name ) ) )
+                Give( IConfigChangeReceiver::KeyRemoved, section, name,
+                    before.GetKeyValue( key ), NULL );
+        }
+        if ( NoIndex == other )
+            Give( IConfigChangeReceiver::SectionRemoved, section, NULL, NULL, NULL );
+    }
+
+    for ( unsigned long ii = 0; ii < after.GetSectionCount(); ++ii )
+    {
+        const char * section = after.GetSectionName( ii );
+        const unsigned long other = ( 0 == ii ) ? 0 : before.FindSection( section );
+        if ( NoIndex == other )
+            Give( IConfigChangeReceiver::SectionAdded, section, NULL, NULL, NULL );
+        for ( unsigned long key = after.GetFirstKey( ii ); NoIndex != key;
+            key = after.GetNextKey( key ) )
+        {
+            const char * name = after.GetKeyName( key );
+            const char * value = after.GetKeyValue( key );
+            const unsigned long old = ( NoIndex == other ) ? NoIndex
+                : before.FindKey( other, name );
+            if ( NoIndex == old )
+                Give( IConfigChangeReceiver::KeyAdded, section, name, NULL, value );
+            else if ( 0 != ::strcmp( before.GetKeyValue( old ), value ) )
+                Give( IConfigChangeReceiver::KeyChanged, section, name,
+                    before.GetKeyValue( old ), value );
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+class ConfigWatcher::Impl
+{
+public:
+
+    Impl( ConfigParser & parser, IConfigChangeReceiver * receiver );
+
+    ~Impl( void );
+
+    WatchedFiles::iterator Find( const char * filename );
+
+    /// Watches folder of file.  Returns false if it cannot be watched.
+    bool Watch( WatchedFile & file );
+
+    /// Stops watching folder of file, unless another file is in that folder.
+    void Unwatch( const WatchedFile & file );
+
+    /// Waits for notices or for time to pass, and marks files which changed.
+    void Wait( unsigned long waitTime );
+
+    /// Reloads file if its bytes changed.  Returns true for new valid contents.
+    bool Check( WatchedFile & file, unsigned long noticed );
+
+    /// Reloads each marked file.
+    unsigned long CheckMarked( unsigned long noticed );
+
+    ConfigParser & m_parser;
+    IConfigChangeReceiver * m_receiver;
+    WatchedFiles m_files;
+    ConfigWatcherStats m_stats;
+    /// Handle for inotify, or -1 if there is none.
+    int m_notices;
+
+private:
+
+    /// Not implemented.
+    Impl( const Impl & );
+    /// Not implemented.
+    Impl & operator = ( const Impl & );
+
+};
+
+// ----------------------------------------------------------------------------
+
+ConfigWatcher::Impl::Impl( ConfigParser & parser, IConfigChangeReceiver * receiver ) :
+    m_parser( parser ),
+    m_receiver( receiver ),
+    m_files(),
+    m_stats(),
+    m_notices( -1 )
+{
+    assert( NULL != this );
+    ::memset( &m_stats, 0, sizeof( m_stats ) );
+#if defined( __linux__ )
+    m_notices = ::inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigWatcher::Impl::~Impl( void )
+{
+    assert( NULL != this );
+    for ( WatchedFiles::iterator it( m_files.begin() ); it != m_files.end(); ++it )
+        delete *it;
+#if defined( __linux__ )
+    if ( -1 != m_notices )
+        ::close( m_notices );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+WatchedFiles::iterator ConfigWatcher::Impl::Find( const char * filename )
+{
+    assert( NULL != this );
+    WatchedFiles::iterator it( m_files.begin() );
+    for ( ; it != m_files.end(); ++it )
+    {
+        if ( ( *it )->m_name == filename )
+            break;
+    }
+    return it;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigWatcher::Impl::Watch( WatchedFile & file )
+{
+    assert( NULL != this );
+
+    ::std::string::size_type slash = file.m_name.find_last_of( "/\\" );
+    if ( ::std::string::npos == slash )
+    {
+        file.m_folder = ".";
+        file.m_base = file.m_name;
+    }
+    else
+    {
+        file.m_folder = file.m_name.substr( 0, ( 0 == slash ) ? 1 : slash );
+        file.m_base = file.m_name.substr( slash + 1 );
+    }
+
+#if defined( __linux__ )
+    if ( -1 != m_notices )
+    {
+        // Folder is watched, since a rename over the file replaces its inode.
+        file.m_watch = ::inotify_add_watch( m_notices, file.m_folder.c_str(), s_watchEvents );
+        return ( -1 != file.m_watch );
+    }
+#endif
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigWatcher::Impl::Unwatch( const WatchedFile & file )
+{
+    assert( NULL != this );
+
+#if defined( __linux__ )
+    if ( ( -1 == m_notices ) || ( -1 == file.m_watch ) )
+        return;
+    // inotify gives one watch per folder, shared by every file in it.
+    for ( WatchedFiles::const_iterator it( m_files.begin() ); it != m_files.end(); ++it )
+    {
+        if ( ( *it != &file ) && ( ( *it )->m_watch == file.m_watch ) )
+            return;
+    }
+    ::inotify_rm_watch( m_notices, file.m_watch );
+#else
+    (void)file;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+void ConfigWatcher::Impl::Wait( unsigned long waitTime )
+{
+    assert( NULL != this );
+
+#if defined( __linux__ )
+    if ( -1 != m_notices )
+    {
+        pollfd ready;
+        ready.fd = m_notices;
+        ready.events = POLLIN;
+        ready.revents = 0;
+        if ( ::poll( &ready, 1, static_cast< int >( waitTime ) ) <= 0 )
+            return;
+
+        // Buffer is aligned for inotify_event, and holds many of them.
+        union
+        {
+            inotify_event m_event;
+            char m_bytes[ 4096 ];
+        } buffer;
+        for ( ;; )
+        {
+            const ssize_t count = ::read( m_notices, buffer.m_bytes, sizeof( buffer.m_bytes ) );
+            if ( count <= 0 )
+                break;
+            for ( ssize_t place = 0; place < count; )
+            {
+                const inotify_event * event =
+                    reinterpret_cast< const inotify_event * >( buffer.m_bytes + place );
+                place += sizeof( inotify_event ) + event->len;
+                const bool overflow = ( 0 != ( event->mask & IN_Q_OVERFLOW ) );
+                for ( WatchedFiles::iterator it( m_files.begin() ); it != m_files.end(); ++it )
+                {
+                    WatchedFile & file = **it;
+                    if ( overflow || ( ( file.m_watch == event->wd ) && ( 0 != event->len )
+                      && ( file.m_base == event->name ) ) )
+                        file.m_dirty = true;
+                }
+            }
+        }
+        return;
+    }
+#endif
+
+    if ( 0 != waitTime )
+    {
+#if defined( _WIN32 )
+        ::Sleep( waitTime );
+#else
+        ::usleep( static_cast< useconds_t >( waitTime ) * 1000 );
+#endif
+    }
+    for ( WatchedFiles::iterator it( m_files.begin() ); it != m_files.end(); ++it )
+    {
+        WatchedFile & file = **it;
+        struct stat status;
+        if ( 0 != ::stat( file.m_name.c_str(), &status ) )
+            continue;
+        if ( ( status.st_mtime != file.m_modified ) || ( status.st_size != file.m_statSize ) )
+        {
+            file.m_modified = status.st_mtime;
+            file.m_statSize = status.st_size;
+            file.m_dirty = true;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigWatcher::Impl::Check( WatchedFile & file, unsigned long noticed )
+{
+    assert( NULL != this );
+
+    file.m_dirty = false;
+    ++m_stats.m_checks;
+    ConfigReloadInfo info;
+    info.m_result = ConfigParser::CantOpenFile;
+    info.m_changes = 0;
+    info.m_parseTime = 0;
+    info.m_latency = 0;
+
+    FileBuffer buffer;
+    if ( !buffer.Open( file.m_name.c_str() ) )
+    {
+        // A missing file keeps its contents, and is reloaded once it is back.
+        ++m_stats.m_failures;
+        file.m_read = false;
+        return false;
+    }
+    const char * begin = buffer.GetBegin();
+    const char * end = buffer.GetEnd();
+    const unsigned long size = buffer.GetSize();
+    const unsigned long hash = ConfigDocument::HashText( begin, end );
+    if ( file.m_read && ( size == file.m_size ) && ( hash == file.m_hash ) )
+    {
+        ++m_stats.m_unchanged;
+        return false;
+    }
+    file.m_read = true;
+    file.m_size = size;
+    file.m_hash = hash;
+
+    const unsigned long parseStart = GetMicroseconds();
+    info.m_result = file.m_spare->Parse( m_parser, begin, end );
+    info.m_parseTime = GetMicroseconds() - parseStart;
+    const bool valid = file.m_spare->IsValid();
+    if ( valid )
+    {
+        Differ differ( file.m_name.c_str(), m_receiver );
+        differ.Compare( *file.m_document, *file.m_spare );
+        info.m_changes = differ.GetCount();
+        // Swapping keeps the memory of both documents for later reloads.
+        ConfigDocument * old = file.m_document;
+        file.m_document = file.m_spare;
+        file.m_spare = old;
+        ++m_stats.m_reloads;
+    }
+    else
+        ++m_stats.m_failures;
+    file.m_spare->Clear();
+
+    info.m_latency = GetMicroseconds() - noticed;
+    if ( NULL != m_receiver )
+        m_receiver->ReloadedConfigFile( file.m_name.c_str(), info );
+    return valid;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigWatcher::Impl::CheckMarked( unsigned long noticed )
+{
+    assert( NULL != this );
+    unsigned long count = 0;
+    for ( WatchedFiles::iterator it( m_files.begin() ); it != m_files.end(); ++it )
+    {
+        if ( ( *it )->m_dirty && Check( **it, noticed ) )
+            ++count;
+    }
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigWatcher::ConfigWatcher( ConfigParser & parser, IConfigChangeReceiver * receiver ) :
+    m_impl( new Impl( parser, receiver ) )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigWatcher::~ConfigWatcher( void )
+{
+    assert( NULL != this );
+    delete m_impl;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigWatcher::AddFile( const char * filename )
+{
+    assert( NULL != this );
+
+    if ( ( NULL == filename ) || ( '\0' == *filename )
+      || ( m_impl->m_files.end() != m_impl->Find( filename ) ) )
+        return false;
+
+    WatchedFile * file = new WatchedFile( filename );
+    if ( !m_impl->Watch( *file ) )
+    {
+        delete file;
+        return false;
+    }
+
+    struct stat status;
+    if ( 0 == ::stat( filename, &status ) )
+    {
+        file->m_modified = status.st_mtime;
+        file->m_statSize = status.st_size;
+    }
+    m_impl->m_files.push_back( file );
+    m_impl->Check( *file, GetMicroseconds() );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigWatcher::RemoveFile( const char * filename )
+{
+    assert( NULL != this );
+
+    if ( NULL == filename )
+        return false;
+    WatchedFiles::iterator it( m_impl->Find( filename ) );
+    if ( m_impl->m_files.end() == it )
+        return false;
+    m_impl->Unwatch( **it );
+    delete *it;
+    m_impl->m_files.erase( it );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigWatcher::GetFileCount( void ) const
+{
+    assert( NULL != this );
+    return static_cast< unsigned long >( m_impl->m_files.size() );
+}
+
+// ----------------------------------------------------------------------------
+
+const ConfigDocument * ConfigWatcher::GetDocument( const char * filename ) const
+{
+    assert( NULL != this );
+
+    if ( NULL == filename )
+        return NULL;
+    WatchedFiles::iterator it( m_impl->Find( filename ) );
+    return ( m_impl->m_files.end() == it ) ? NULL : ( *it )->m_document;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigWatcher::Poll( unsigned long waitTime )
+{
+    assert( NULL != this );
+    m_impl->Wait( waitTime );
+    return m_impl->CheckMarked( GetMicroseconds() );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ConfigWatcher::ReloadAll( void )
+{
+    assert( NULL != this );
+    // Clear any notices first, so Poll does not read the same files again.
+    m_impl->Wait( 0 );
+    for ( WatchedFiles::iterator it( m_impl->m_files.begin() ); it != m_impl->m_files.end(); ++it )
+        ( *it )->m_dirty = true;
+    return m_impl->CheckMarked( GetMicroseconds() );
+}
+
+// ----------------------------------------------------------------------------
+
+bool ConfigWatcher::IsNotified( void ) const
+{
+    assert( NULL != this );
+    return ( -1 != m_impl->m_notices );
+}
+
+// ----------------------------------------------------------------------------
+
+ConfigWatcherStats ConfigWatcher::GetStats( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_stats;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
@@ -20,8 +20,13 @@
 
 #include "ParserRules.hpp"
 
+#include <string.h>
+
+#include "../../Util/include/EventBuffer.hpp"
 #include "../../Util/include/ParseUtil.hpp"
+#include "../../Util/include/RuleProfile.hpp"
 
+#include "../include/ConfigEventBatcher.hpp"
 #include "CommonParsers.hpp"
 
 
@@ -52,6 +57,7 @@ namespace
 // ----------------------------------------------------------------------------
 
 static const char s_Quote = '\"';
+static const char * const s_QuoteString = "\"";
 
 // ----------------------------------------------------------------------------
 
@@ -72,9 +78,125 @@ void TrimWhitespace( const char * & first, const char * & last )
 
 // ----------------------------------------------------------------------------
 
-} // end namespace Parser
+/// Matches delimiters of any policy by comparing strings while parsing.
+class PolicyDelimiters
+{
+public:
+
+    inline explicit PolicyDelimiters( const ConfigParser::ParserPolicy & policy ) :
+        m_policy( policy ) {}
+
+    inline strlit< char * > LineComment( void ) const
+    { return str_p( m_policy.LineComment ); }
+    inline strlit< char * > BlockCommentStarter( void ) const
+    { return str_p( m_policy.BlockCommentStarter ); }
+    inline strlit< char * > BlockCommentEnder( void ) const
+    { return str_p( m_policy.BlockCommentEnder ); }
+    inline strlit< char * > SectionNameStarter( void ) const
+    { return str_p( m_policy.SectionNameStarter ); }
+    inline strlit< char * > SectionNameEnder( void ) const
+    { return str_p( m_policy.SectionNameEnder ); }
+    inline strlit< char * > AssignOperator( void ) const
+    { return str_p( m_policy.AssignOperator ); }
+
+private:
+
+    /// Not implemented.
+    PolicyDelimiters & operator = ( const PolicyDelimiters & );
+
+    const ConfigParser::ParserPolicy & m_policy;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Matches the default delimiters with chars fixed when compiling.
+class DefaultDelimiters
+{
+public:
+
+    inline chlit<> LineComment( void ) const { return ch_p( ';' ); }
+    inline CharPairParser< '/', '*' > BlockCommentStarter( void ) const
+    { return CharPairParser< '/', '*' >(); }
+    inline CharPairParser< '*', '/' > BlockCommentEnder( void ) const
+    { return CharPairParser< '*', '/' >(); }
+    inline chlit<> SectionNameStarter( void ) const { return ch_p( '[' ); }
+    inline chlit<> SectionNameEnder( void ) const { return ch_p( ']' ); }
+    inline chlit<> AssignOperator( void ) const { return ch_p( '=' ); }
+};
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if policy has the delimiters DefaultDelimiters matches.
+bool HasDefaultDelimiters( const ConfigParser::ParserPolicy & policy )
+{
+    return ( 0 == ::strcmp( policy.LineComment, ";" ) )
+        && ( 0 == ::strcmp( policy.BlockCommentStarter, "/*" ) )
+        && ( 0 == ::strcmp( policy.BlockCommentEnder, "*/" ) )
+        && ( 0 == ::strcmp( policy.SectionNameStarter, "[" ) )
+        && ( 0 == ::strcmp( policy.SectionNameEnder, "]" ) )
+        && ( 0 == ::strcmp( policy.AssignOperator, "=" ) );
+}
+
+// ----------------------------------------------------------------------------
+
+/** @class ContentSwitch
+ Matches the same text as ( blockComment | lineComment | section | keyValue |
+ embeddedNil ) with the default delimiters.  Every alternative but keyValue
+ starts with a fixed char and does nothing unless it finds that char, so the
+ first char picks the only alternatives which could match, through a switch
+ instead of trying each rule in turn.
+ */
+class ContentSwitch : public parser< ContentSwitch >
+{
+public:
+
+    typedef ContentSwitch self_t;
+
+    inline ContentSwitch( const rule<> & blockComment, const rule<> & lineComment,
+        const rule<> & section, const rule<> & keyValue, const rule<> & embeddedNil ) :
+        m_blockComment( blockComment ), m_lineComment( lineComment ),
+        m_section( section ), m_keyValue( keyValue ), m_embeddedNil( embeddedNil ) {}
+
+    template < typename ScannerT >
+    typename parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
+    {
+        typedef typename parser_result< self_t, ScannerT >::type result_t;
+        if ( scan.at_end() )
+            return scan.no_match();
+        const char * const save = scan.first;
+        const rule<> * first = NULL;
+        switch ( *save )
+        {
+            case '/':  first = &m_blockComment; break;
+            case ';':  first = &m_lineComment;  break;
+            case '[':  first = &m_section;      break;
+            case '\0': return m_embeddedNil.parse( scan );
+            default:   break;
+        }
+        if ( NULL != first )
+        {
+            result_t hit = first->parse( scan );
+            if ( hit )
+                return hit;
+            scan.first = save;
+        }
+        // Only a key can start with any other printable char.
+        return m_keyValue.parse( scan );
+    }
+
+private:
 
-ConfigFileParser * ConfigFileParser::s_pParser = NULL;
+    const rule<> & m_blockComment;
+    const rule<> & m_lineComment;
+    const rule<> & m_section;
+    const rule<> & m_keyValue;
+    const rule<> & m_embeddedNil;
+};
+
+// ----------------------------------------------------------------------------
+
+} // end anonymous namespace
 
 namespace Parser
 {
@@ -92,6 +214,7 @@ ConfigFileParser::ConfigFileParser( const ConfigParser::ParserPolicy & policy,
     m_valueStart( NULL ),
     m_valueEnd( NULL ),
     m_pReceiver( NULL ),
+    m_pEvents( NULL ),
     m_start(),
     m_name_rule(),
     m_start_section(),
@@ -119,46 +242,46 @@ ConfigFileParser::ConfigFileParser( const ConfigParser::ParserPolicy & policy,
     m_config()
 {
     SetPolicy( policy, stack, lineCounter );
-    s_pParser = this;
 }
 
 // ----------------------------------------------------------------------------
 
 ConfigFileParser::~ConfigFileParser( void )
 {
-    s_pParser = NULL;
 }
 
 // ----------------------------------------------------------------------------
 
-void ConfigFileParser::SetPolicy( const ConfigParser::ParserPolicy & policy,
-    MessageStack & stack, LineCounter & lineCounter )
+template < class Delimiters >
+void ConfigFileParser::MakeRules( const Delimiters & delimiters,
+    const ConfigParser::ParserPolicy & policy, MessageStack & stack,
+    LineCounter & lineCounter )
 {
 
-    m_start = epsilon_p
-        [ FClear() ];
+    PARSER_PROFILE_RULE( m_start ) = epsilon_p
+        [ FClear( this ) ];
 
-    m_line_comment =
+    PARSER_PROFILE_RULE( m_line_comment ) =
         (
-          str_p( policy.LineComment )
-          >> ( *( print_p - eol_p ) )
-          >> lineCounter.GetRule()
+          delimiters.LineComment()
+          >> RunParser( RunFinder( true, NULL ) )
+          >> ( lineCounter.GetRule() | end_p )
         );
 
-    m_skip_block_comment = ( *print_p )
+    PARSER_PROFILE_RULE( m_skip_block_comment ) = ( *print_p )
         [ FPopMessageStack( stack ) ]
-        [ FSetValidSyntax( false ) ];
+        [ FSetValidSyntax( this, false ) ];
 
-    m_block_comment_start = str_p( policy.BlockCommentStarter )
+    PARSER_PROFILE_RULE( m_block_comment_start ) = delimiters.BlockCommentStarter()
         [ FPushMessage( stack, ErrorLevel::Major, "Found start of comment, but no comment content.", __FILE__, "m_block_comment_start" ) ];
 
-    m_comment_content = ( *( print_p - str_p( policy.BlockCommentEnder ) ) )
+    PARSER_PROFILE_RULE( m_comment_content ) = RunParser( RunFinder( true, policy.BlockCommentEnder ) )
         [ FPrepareMessage( stack, ErrorLevel::Major, "Found comment, but no end of comment.", __FILE__, "m_comment_content" ) ];
 
-    m_block_comment_end = str_p( policy.BlockCommentEnder )
+    PARSER_PROFILE_RULE( m_block_comment_end ) = delimiters.BlockCommentEnder()
         [ FCancelMessage( stack ) ];
 
-    m_block_comment =
+    PARSER_PROFILE_RULE( m_block_comment ) =
         ( m_block_comment_start
           >> ( *( blank_p )
             >> ( m_comment_content >> m_block_comment_end )
@@ -166,28 +289,25 @@ void ConfigFileParser::SetPolicy( const ConfigParser::ParserPolicy & policy,
              )
         );
 
-    m_assign =
+    PARSER_PROFILE_RULE( m_assign ) =
         (
           *( blank_p )
-          >> str_p( policy.AssignOperator )
+          >> delimiters.AssignOperator()
           >> *( blank_p )
         );
     if ( policy.AllowQuotedCommentInValue )
     {
-        m_quoted_part =
-            (
-              *( print_p -
-                 ( ch_p( s_Quote ) | eol_p | end_p )
-               )
-            );
-        m_skip_quote =
+        // Same as *( print_p - ( ch_p( s_Quote ) | eol_p | end_p ) ), since
+        // print_p never matches an end of line.
+        PARSER_PROFILE_RULE( m_quoted_part ) = RunParser( RunFinder( true, s_QuoteString ) );
+        PARSER_PROFILE_RULE( m_skip_quote ) =
             (
               *( print_p - eol_p ) | end_p
             )
             [ FSendMessageNow( stack, ErrorLevel::Major, "Could not find ending quote for value." ) ]
-            [ FSetValidContent( false ) ]
-            [ FSetValidSyntax( false ) ];
-        m_quoted_value =
+            [ FSetValidContent( this, false ) ]
+            [ FSetValidSyntax( this, false ) ];
+        PARSER_PROFILE_RULE( m_quoted_value ) =
             (
               ch_p( s_Quote )
               >> (
@@ -195,54 +315,51 @@ void ConfigFileParser::SetPolicy( const ConfigParser::ParserPolicy & policy,
                    | m_skip_quote
                  )
             );
-        m_bare_value =
-            (
-              *( print_p -
-                 (
-                   str_p( policy.BlockCommentStarter )
-                   | str_p( policy.LineComment )
-                   | eol_p
-                 )
-              )
-            );
-        m_value_rule = ( m_quoted_value | m_bare_value )
-            [ FSetValue() ];
+        PARSER_PROFILE_RULE( m_bare_value ) = RunParser( RunFinder( true,
+            policy.BlockCommentStarter, policy.LineComment ) );
+        PARSER_PROFILE_RULE( m_value_rule ) = ( m_quoted_value | m_bare_value )
+            [ FSetValue( this ) ];
     }
     else
     {
-        m_value_rule =
+        PARSER_PROFILE_RULE( m_value_rule ) =
             (
               *( print_p -
-                 ( str_p( policy.BlockCommentStarter ) | m_line_comment | eol_p )
+                 ( delimiters.BlockCommentStarter() | m_line_comment | eol_p )
               )
             )
-            [ FSetValue() ];
+            [ FSetValue( this ) ];
     }
-    m_key_value
+    PARSER_PROFILE_RULE( m_key_value )
         = ( m_key_rule
             >> !( m_assign >> ( !m_value_rule ) )
             >> !( m_line_comment | m_block_comment )
           )
-        [ FSendKeyValuePair() ];
-    m_clear_content = epsilon_p
-        [ FClearContents() ];
-    m_end_error = ( *print_p )
+        [ FSendKeyValuePair( this ) ];
+    PARSER_PROFILE_RULE( m_clear_content ) = epsilon_p
+        [ FClearContents( this ) ];
+    // Nils embedded in the data are reported and skipped here, so callers
+    // may parse file contents in place without rewriting them first.
+    PARSER_PROFILE_RULE( m_embedded_nil ) = ch_p( '\0' )
+        [ FSendMessageNow( stack, ErrorLevel::Major, "Found embedded nil character." ) ]
+        [ FSetValidSyntax( this, false ) ];
+    PARSER_PROFILE_RULE( m_end_error ) = ( *print_p )
         [ FSendMessageNow( stack, ErrorLevel::Fatal, "Could not parse contents." ) ]
-        [ FSetValidSyntax( false ) ];
+        [ FSetValidSyntax( this, false ) ];
 
-    m_start_section = ( str_p( policy.SectionNameStarter ) >> *( blank_p ) )
+    PARSER_PROFILE_RULE( m_start_section ) = ( delimiters.SectionNameStarter() >> *( blank_p ) )
         [ FPushMessage( stack, ErrorLevel::Major, "Found start of section, but no section name.", __FILE__, "m_start_section" ) ];
-    m_end_section = ( *( blank_p ) >> str_p( policy.SectionNameEnder ) )
-        [ FSendSectionName() ]
+    PARSER_PROFILE_RULE( m_end_section ) = ( *( blank_p ) >> delimiters.SectionNameEnder() )
+        [ FSendSectionName( this ) ]
         [ FCancelMessage( stack ) ];
-    m_skip_section =
+    PARSER_PROFILE_RULE( m_skip_section ) =
         (
-         ( *( print_p - str_p( policy.SectionNameEnder ) ) - eol_p )
+         ( *( print_p - delimiters.SectionNameEnder() ) - eol_p )
           >> ( !eol_p )
         )
-        [ FSetValidSyntax( false ) ]
+        [ FSetValidSyntax( this, false ) ]
         [ FPopMessageStack( stack ) ];
-    m_section =
+    PARSER_PROFILE_RULE( m_section ) =
         ( m_start_section
           >> (
                ( m_section_name >> m_end_section )
@@ -252,50 +369,75 @@ void ConfigFileParser::SetPolicy( const ConfigParser::ParserPolicy & policy,
 
     if ( policy.AlphaNumericNames )
     {
-        m_name_rule =
+        PARSER_PROFILE_RULE( m_name_rule ) =
             ( ( alpha_p | ch_p( '_' ) )
               >> ( *( alnum_p | ch_p( '_' ) ) )
             )
-            [ FSetName() ];
-        m_section_name = ( m_name_rule )
+            [ FSetName( this ) ];
+        PARSER_PROFILE_RULE( m_section_name ) = ( m_name_rule )
             [ FPrepareMessage( stack, ErrorLevel::Major, "Found section name, but no end of section.", __FILE__, "m_section_name 1" ) ];
-        m_key_rule = m_name_rule;
+        PARSER_PROFILE_RULE( m_key_rule ) = m_name_rule;
     }
     else
     {
-        m_section_name =
+        PARSER_PROFILE_RULE( m_section_name ) =
             (
               +( print_p -
                  (
-                   str_p( policy.SectionNameEnder )
-                   | str_p( policy.SectionNameStarter )
+                   delimiters.SectionNameEnder()
+                   | delimiters.SectionNameStarter()
                    | eol_p
                  )
               )
             )
-            [ FSetName() ]
+            [ FSetName( this ) ]
             [ FPrepareMessage( stack, ErrorLevel::Major, "Found section name, but no end of section.", __FILE__, "m_section_name 2" ) ];
-        m_key_rule =
+        PARSER_PROFILE_RULE( m_key_rule ) =
             ( +( print_p - ( m_start_section | m_assign | eol_p ) ) )
-            [ FSetName() ];
+            [ FSetName( this ) ];
     }
+}
 
-    m_content =
-        ( m_clear_content
-          >> ( *( blank_p ) )
-          >> ( m_block_comment
-             | m_line_comment
-             | m_section
-             | m_key_value )
-          >> ( *( blank_p ) )
-          >> ( *( lineCounter.GetRule() ) )
-        );
-    m_config =
+// ----------------------------------------------------------------------------
+
+void ConfigFileParser::SetPolicy( const ConfigParser::ParserPolicy & policy,
+    MessageStack & stack, LineCounter & lineCounter )
+{
+
+    if ( HasDefaultDelimiters( policy ) )
+    {
+        MakeRules( DefaultDelimiters(), policy, stack, lineCounter );
+        PARSER_PROFILE_RULE( m_content ) =
+            ( m_clear_content
+              >> ( *( blank_p ) )
+              >> ContentSwitch( m_block_comment, m_line_comment, m_section,
+                    m_key_value, m_embedded_nil )
+              >> ( *( blank_p ) )
+              >> ( *( lineCounter.GetRule() ) )
+            );
+    }
+    else
+    {
+        MakeRules( PolicyDelimiters( policy ), policy, stack, lineCounter );
+        PARSER_PROFILE_RULE( m_content ) =
+            ( m_clear_content
+              >> ( *( blank_p ) )
+              >> ( m_block_comment
+                 | m_line_comment
+                 | m_section
+                 | m_key_value
+                 | m_embedded_nil )
+              >> ( *( blank_p ) )
+              >> ( *( lineCounter.GetRule() ) )
+            );
+    }
+    // Content never backtracks, so an error is reported where content stopped.
+    PARSER_PROFILE_RULE( m_config ) =
         ( m_start
-          >> ( ( *( m_content ) >> end_p )
-             | m_end_error )
+          >> ( *( m_content ) )
+          >> ( end_p | m_end_error )
         )
-        [ FDone() ];
+        [ FDone( this ) ];
 
     m_trim = policy.TrimWhiteSpace;
 }
@@ -334,6 +476,20 @@ void ConfigFileParser::SetName( const char * first, const char * last )
 void ConfigFileParser::SendSectionName( void )
 {
     m_DidSection = true;
+    if ( NULL != m_pEvents )
+    {
+        try
+        {
+            if ( !m_pEvents->Add( ConfigEventBatcher::Section, 0, m_keyStart, m_keyEnd ) )
+                m_pEvents = NULL;
+        }
+        catch ( ... )
+        {
+            m_pEvents = NULL;
+            throw;
+        }
+        return;
+    }
     if ( NULL == m_pReceiver )
         return;
 
@@ -363,10 +519,28 @@ void ConfigFileParser::SetValue( const char * first, const char * last )
 
 void ConfigFileParser::SendKeyValuePair( void )
 {
+    if ( !m_ValidContent )
+        return;
+    if ( NULL != m_pEvents )
+    {
+        // Appended in place, so a key costs no call through a receiver.
+        const unsigned short kind = m_DidSection ?
+            ConfigEventBatcher::SectionKey : ConfigEventBatcher::GlobalKey;
+        try
+        {
+            if ( !m_pEvents->AddPair( kind, 0, m_keyStart, m_keyEnd,
+                ConfigEventBatcher::Value, 0, m_valueStart, m_valueEnd ) )
+                m_pEvents = NULL;
+        }
+        catch ( ... )
+        {
+            m_pEvents = NULL;
+            throw;
+        }
+        return;
+    }
     if ( NULL == m_pReceiver )
         return;
-    if ( !m_ValidContent )
-        return;
 
     try
     {
@@ -392,6 +566,15 @@ void ConfigFileParser::SendKeyValuePair( void )
 
 void ConfigFileParser::Done( void )
 {
+    if ( NULL != m_pEvents )
+    {
+        EventBuffer * pEvents = m_pEvents;
+        m_pEvents = NULL;
+        pEvents->Add( ConfigEventBatcher::EndFile,
+            IsValid() ? ConfigEventBatcher::Valid : 0, NULL, NULL );
+        pEvents->Flush();
+        return;
+    }
     if ( NULL == m_pReceiver )
         return;
     try
@@ -36,6 +36,7 @@
 
 namespace Parser
 {
+    class EventBuffer;
     class IConfigReceiver;
     class LineCounter;
     class MessageStack;
@@ -48,8 +49,6 @@ class ConfigFileParser
 {
 public:
 
-    inline static ConfigFileParser & GetIt( void ) { return *s_pParser; }
-
     ConfigFileParser( const ::Parser::ConfigParser::ParserPolicy & policy,
         ::Parser::MessageStack & stack, LineCounter & counter );
 
@@ -63,6 +62,14 @@ public:
         ::Parser::MessageStack & stack, LineCounter & lineCounter );
 
     inline IConfigReceiver * GetReceiver( void ) { return m_pReceiver; }
+
+    /** Sets buffer to which the rules add each section, key, value, and end of
+     file as ConfigEventBatcher events, instead of calling a receiver.
+     */
+    inline void SetEventBuffer( EventBuffer * pEvents ) { m_pEvents = pEvents; }
+
+    /// Returns event buffer, or NULL once the rules reached the end or it said to stop.
+    inline EventBuffer * GetEventBuffer( void ) { return m_pEvents; }
 
     inline bool IsValid( void ) const { return m_ValidSyntax; }
 
@@ -72,6 +79,14 @@ public:
 
 private:
 
+    /** Makes every rule but the content and config rules.
+     @param delimiters Makes the parsers which match each delimiter.
+     */
+    template < class Delimiters >
+    void MakeRules( const Delimiters & delimiters,
+        const ::Parser::ConfigParser::ParserPolicy & policy,
+        ::Parser::MessageStack & stack, LineCounter & lineCounter );
+
     void Clear( void );
 
     void ClearContents( void );
@@ -90,74 +105,105 @@ private:
 
     void Done( void );
 
+    /// Each action keeps a pointer to the parser which owns its rule, so
+    /// separate parsers never share state and may run on separate threads.
     struct FClear
     {
-        inline void operator () ( const char *, const char * ) const { s_pParser->Clear(); }
+        inline explicit FClear( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
+        inline void operator () ( const char *, const char * ) const { m_pParser->Clear(); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FClearContents
     {
+        inline explicit FClearContents( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->ClearContents(); }
+        { m_pParser->ClearContents(); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FSetValidSyntax
     {
-        inline explicit FSetValidSyntax( bool valid ) :
-            m_valid( valid ) {}
+        inline FSetValidSyntax( ConfigFileParser * pParser, bool valid ) :
+            m_pParser( pParser ), m_valid( valid ) {}
 
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->SetValidSyntax( m_valid ); }
+        { m_pParser->SetValidSyntax( m_valid ); }
 
-        inline void operator () ( char ) const { s_pParser->SetValidSyntax( m_valid ); }
+        inline void operator () ( char ) const { m_pParser->SetValidSyntax( m_valid ); }
 
+        ConfigFileParser * m_pParser;
         bool m_valid;
     };
 
     struct FSetValidContent
     {
-        inline explicit FSetValidContent( bool valid ) :
-            m_valid( valid ) {}
+        inline FSetValidContent( ConfigFileParser * pParser, bool valid ) :
+            m_pParser( pParser ), m_valid( valid ) {}
 
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->SetValidContent( m_valid ); }
+        { m_pParser->SetValidContent( m_valid ); }
 
-        inline void operator () ( char ) const { s_pParser->SetValidContent( m_valid ); }
+        inline void operator () ( char ) const { m_pParser->SetValidContent( m_valid ); }
 
+        ConfigFileParser * m_pParser;
         bool m_valid;
     };
 
     struct FSetName
     {
+        inline explicit FSetName( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char * first, const char * last ) const
-        { s_pParser->SetName( first, last ); }
+        { m_pParser->SetName( first, last ); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FSendSectionName
     {
+        inline explicit FSendSectionName( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->SendSectionName(); }
+        { m_pParser->SendSectionName(); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FSetValue
     {
+        inline explicit FSetValue( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char * first, const char * last ) const
-        { s_pParser->SetValue( first, last ); }
+        { m_pParser->SetValue( first, last ); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FSendKeyValuePair
     {
+        inline explicit FSendKeyValuePair( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->SendKeyValuePair(); }
+        { m_pParser->SendKeyValuePair(); }
+
+        ConfigFileParser * m_pParser;
     };
 
     struct FDone
     {
+        inline explicit FDone( ConfigFileParser * pParser ) : m_pParser( pParser ) {}
+
         inline void operator () ( const char *, const char * ) const
-        { s_pParser->Done(); }
+        { m_pParser->Done(); }
+
+        ConfigFileParser * m_pParser;
     };
 
-    static ConfigFileParser * s_pParser;
 
     bool m_ValidSyntax;
     bool m_ValidContent;
@@ -168,6 +214,7 @@ private:
     const char * m_valueStart;
     const char * m_valueEnd;
     IConfigReceiver * m_pReceiver;
+    EventBuffer * m_pEvents;
 
     ::boost::spirit::rule<> m_start;
     ::boost::spirit::rule<> m_name_rule;
@@ -194,6 +241,7 @@ private:
     ::boost::spirit::rule<> m_key_value;
     ::boost::spirit::rule<> m_skip_over;
     ::boost::spirit::rule<> m_clear_content;
+    ::boost::spirit::rule<> m_embedded_nil;
     ::boost::spirit::rule<> m_end_error;
     ::boost::spirit::rule<> m_content;
     ::boost::spirit::rule<> m_config;
@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file BatchTester.cpp Tests ConfigBatch.
+
+
+// ----------------------------------------------------------------------------
+
+#include "BatchTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/ConfigBatch.hpp"
+#include "../include/ConfigDocument.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+const unsigned int s_inputCount = 300;
+
+// ----------------------------------------------------------------------------
+
+/// Makes inputs whose sizes differ a lot, so some threads must steal work.
+void MakeInputs( vector< string > & inputs )
+{
+    char line[ 64 ];
+    inputs.resize( s_inputCount );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        string & text = inputs[ ii ];
+        const unsigned int sections = ( 0 == ii % 50 ) ? 200 : 1 + ii % 5;
+        ::sprintf( line, "Input = %u\n", ii );
+        text += line;
+        for ( unsigned int jj = 0; jj < sections; ++jj )
+        {
+            ::sprintf( line, "[Section%u]\nKey%u = %u\nOther = %u\n", jj, jj, ii, jj );
+            text += line;
+        }
+        if ( 0 == ii % 7 )
+            text += "[Broken\nKey = Value\n";
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoBatchTests( unsigned int threadCount, bool showSummary )
+{
+    vector< string > inputs;
+    MakeInputs( inputs );
+
+    ConfigBatch batch( threadCount );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const string & text = inputs[ ii ];
+        batch.AddBuffer( text.c_str(), text.c_str() + text.size(), NULL );
+    }
+    const unsigned long missing = batch.AddFile( "NoSuchFile.cfg" );
+    const bool allValid = batch.Run();
+    const BatchStats stats = batch.GetStats();
+
+    // Same parse on this thread alone, one input at a time.
+    ConfigParser parser;
+    MessageCollector collector;
+    parser.SetMessageReceiver( &collector );
+    ConfigDocument document;
+    unsigned long matched = 0;
+    unsigned long mismatched = 0;
+    unsigned long invalid = 0;
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const string & text = inputs[ ii ];
+        string messages;
+        unsigned long messageCount = 0;
+        collector.SetTarget( &messages, &messageCount );
+        const ConfigParser::ParseResults result = document.Parse( parser, text.c_str(),
+            text.c_str() + text.size() );
+        if ( ConfigParser::AllValid != result )
+            ++invalid;
+        if ( ( result == batch.GetResult( ii ) )
+          && ( messageCount == batch.GetMessageCount( ii ) )
+          && ( messages == batch.GetMessages( ii ) )
+          && SameDocuments( document, batch.GetDocument( ii ), false ) )
+            ++matched;
+        else
+            ++mismatched;
+    }
+
+    bool passed = ( 0 == mismatched ) && !allValid && ( 0 != invalid )
+        && ( ConfigParser::CantOpenFile == batch.GetResult( missing ) )
+        && ( s_inputCount + 1 == stats.m_jobs ) && ( 0 == stats.m_exceptions )
+        && ( stats.m_threads <= threadCount );
+    if ( showSummary || !passed )
+    {
+        cout << "Batch Threads: [" << stats.m_threads << "] of [" << threadCount
+            << "]\tJobs: [" << stats.m_jobs << "]\tMatched: [" << matched
+            << "]\tMismatched: [" << mismatched << "]\tInvalid: [" << invalid
+            << "]\t" << ( passed ? "Passed" : "Failed" ) << '\n';
+    }
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DelimiterTester.cpp Tests rules made for the default delimiters.
+
+
+// ----------------------------------------------------------------------------
+
+#include "DelimiterTester.hpp"
+
+#include <assert.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigParser.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Lines which start with each delimiter, or almost do, or break it.
+const char * const s_lines[] =
+{
+    "GlobalKey = GlobalValue\n",
+    "; comment\n",
+    ";comment with\ttab\n",
+    ";key = value\n",
+    "/* comment */\n",
+    "/* comment */ [Section1] ; comment\n",
+    "/* comment */ key = value\n",
+    "/* no end of comment\n",
+    "/ key = value\n",
+    "/key\n",
+    "[Section2]\n",
+    " \t[ Section3 ]\t; comment\n",
+    "[Section4] key = value\n",
+    "[Section5\n",
+    "[\n",
+    "[]\n",
+    "key = value [not a section]\n",
+    "key [Section6]\n",
+    "key = value ; comment\n",
+    "key = value /* comment */\n",
+    "key = \"quoted ; value\" ; comment\n",
+    "key = \"no end quote\n",
+    "key = a = b\n",
+    "= value\n",
+    "key =\n",
+    "key_only\n",
+    "*/ key\n",
+    "]\n",
+    "\x01 key\n",
+    "last = line",
+};
+
+const unsigned int s_lineCount = sizeof( s_lines ) / sizeof( s_lines[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Parses text and writes result, calls, and messages into one string.
+string ParseText( ConfigParser & parser, const string & text )
+{
+    const char * begin = text.data();
+    MessageCollector collector;
+    string messages;
+    collector.SetTarget( &messages, NULL );
+    parser.SetMessageReceiver( &collector );
+    CallRecorder recorder( begin );
+    const ConfigParser::ParseResults result = parser.Parse( begin, begin + text.size(),
+        &recorder );
+    return string( ConfigParser::Name( result ) ) + '\n' + recorder.m_calls + messages;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Parses text with default delimiters, and again with '#' in place of each
+ ';', and checks both give the same output.
+ */
+bool SameParse( ConfigParser & defaultParser, ConfigParser & policyParser,
+    const string & text )
+{
+    string hashText( text );
+    ::std::replace( hashText.begin(), hashText.end(), ';', '#' );
+    string expected = ParseText( policyParser, hashText );
+    ::std::replace( expected.begin(), expected.end(), '#', ';' );
+    return ( expected == ParseText( defaultParser, text ) );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoDelimiterTests( bool showSummary )
+{
+    TestChecker checker( "Delimiter" );
+    char hashComment[] = "#";
+
+    // Each mix of the other policy options, since they change the rules too.
+    for ( unsigned int options = 0; options < 8; ++options )
+    {
+        ConfigParser::ParserPolicy policy;
+        policy.TrimWhiteSpace = ( 0 != ( options & 1 ) );
+        policy.AlphaNumericNames = ( 0 != ( options & 2 ) );
+        policy.AllowQuotedCommentInValue = ( 0 != ( options & 4 ) );
+        ConfigParser defaultParser;
+        defaultParser.SetPolicy( policy );
+        policy.LineComment = hashComment;
+        ConfigParser policyParser;
+        policyParser.SetPolicy( policy );
+
+        string all;
+        for ( unsigned int ii = 0; ii < s_lineCount; ++ii )
+        {
+            const string line( s_lines[ ii ] );
+            all += line;
+            if ( !checker.Check( SameParse( defaultParser, policyParser, line ), line.c_str() ) )
+                cout << "Options: " << options << '\n';
+        }
+        // All lines at once, plus an embedded nil.
+        all.insert( all.size() / 2, 1, '\0' );
+        if ( !checker.Check( SameParse( defaultParser, policyParser, all ), "all lines" ) )
+            cout << "Options: " << options << '\n';
+    }
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DelimiterTester.hpp Checks that default delimiter rules match policy rules.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_DELIMITER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_DELIMITER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses tricky config lines with the default delimiters, which use rules
+ made for those delimiters, and the same lines with another line comment
+ delimiter, which use rules that compare the policy strings.  Checks that both
+ give the same calls, results, and messages.
+ @param showSummary True to show counts of checks.
+ @return True if all checks passed.
+ */
+bool DoDelimiterTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
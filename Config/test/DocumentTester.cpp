@@ -0,0 +1,193 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DocumentTester.cpp Tests ConfigDocument.
+
+
+// ----------------------------------------------------------------------------
+
+#include "DocumentTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigDocument.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+const char s_config[] =
+    "Global1 = One\n"
+    "Global2 = Two\n"
+    "[Colors]\n"
+    "Red = FF0000\n"
+    "Green = 00FF00\n"
+    "[Sizes]\n"
+    "Small = 1\n"
+    "Red = 2\n"
+    "[Colors]\n"
+    "Blue = 0000FF\n"
+    "Red = Crimson\n";
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of key values to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "Config Document" ) {}
+
+    void CheckValue( const ConfigDocument & document, const char * section,
+        const char * key, const char * expected )
+    {
+        const char * value = document.Get( section, key );
+        const bool passed = ( NULL == expected ) ? ( NULL == value )
+            : ( ( NULL != value ) && ( 0 == ::strcmp( value, expected ) ) );
+        Check( passed, key );
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+void CheckSmallDocument( Checker & checker, ConfigParser & parser )
+{
+    ConfigDocument document;
+    const ConfigParser::ParseResults result = parser.Parse( s_config,
+        s_config + sizeof( s_config ) - 1, &document );
+    checker.Check( ConfigParser::AllValid == result, "parse result" );
+    checker.Check( document.IsValid(), "valid" );
+
+    checker.CheckValue( document, NULL, "Global1", "One" );
+    checker.CheckValue( document, "", "Global2", "Two" );
+    checker.CheckValue( document, "Colors", "Green", "00FF00" );
+    checker.CheckValue( document, "Colors", "Blue", "0000FF" );
+    checker.CheckValue( document, "Colors", "Red", "Crimson" );
+    checker.CheckValue( document, "Sizes", "Red", "2" );
+    checker.CheckValue( document, "Sizes", "Green", NULL );
+    checker.CheckValue( document, "Shapes", "Red", NULL );
+    checker.CheckValue( document, NULL, "Red", NULL );
+    checker.CheckValue( document, "Colors", "Re", NULL );
+    checker.CheckValue( document, "Colors", "Reds", NULL );
+
+    // Repeated section continues the first one, and repeated key keeps its place.
+    checker.Check( 3 == document.GetSectionCount(), "section count" );
+    const unsigned long colors = document.FindSection( "Colors" );
+    checker.Check( 1 == colors, "section index" );
+    checker.Check( 0 == document.FindSection( NULL ), "global section" );
+    checker.Check( 3 == document.GetKeyCount( colors ), "key count" );
+    const char * const names[] = { "Red", "Green", "Blue" };
+    unsigned long count = 0;
+    for ( unsigned long key = document.GetFirstKey( colors );
+        ConfigDocument::NoIndex != key; key = document.GetNextKey( key ) )
+    {
+        checker.Check( ( count < 3 )
+            && ( 0 == ::strcmp( document.GetKeyName( key ), names[ count ] ) ),
+            "key order" );
+        ++count;
+    }
+    checker.Check( 3 == count, "key walk" );
+
+    document.Clear();
+    checker.Check( !document.IsValid(), "cleared" );
+    checker.Check( 1 == document.GetSectionCount(), "cleared sections" );
+    checker.CheckValue( document, "Colors", "Red", NULL );
+
+    // Sections without any keys leave the key table empty.
+    const char keyless[] = "[Empty]\n";
+    ConfigDocument sectionsOnly;
+    parser.Parse( keyless, keyless + sizeof( keyless ) - 1, &sectionsOnly );
+    checker.Check( 2 == sectionsOnly.GetSectionCount(), "keyless sections" );
+    checker.CheckValue( sectionsOnly, "Empty", "Red", NULL );
+    checker.CheckValue( sectionsOnly, NULL, "Red", NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Makes enough sections and keys that both hash tables grow several times.
+void CheckLargeDocument( Checker & checker, ConfigParser & parser )
+{
+    const unsigned long sectionCount = 200;
+    const unsigned long keyCount = 20;
+    char line[ 64 ];
+    string text;
+    for ( unsigned long ii = 0; ii < sectionCount; ++ii )
+    {
+        ::sprintf( line, "[Section%lu]\n", ii );
+        text += line;
+        for ( unsigned long jj = 0; jj < keyCount; ++jj )
+        {
+            ::sprintf( line, "Key%lu = %lu\n", jj, ii * keyCount + jj );
+            text += line;
+        }
+    }
+
+    ConfigDocument document;
+    parser.Parse( text.c_str(), text.c_str() + text.size(), &document );
+    checker.Check( document.IsValid(), "large valid" );
+    checker.Check( sectionCount + 1 == document.GetSectionCount(), "large sections" );
+
+    bool found = true;
+    char section[ 32 ];
+    char key[ 32 ];
+    char value[ 32 ];
+    for ( unsigned long ii = 0; ii < sectionCount; ++ii )
+    {
+        ::sprintf( section, "Section%lu", ii );
+        for ( unsigned long jj = 0; jj < keyCount; ++jj )
+        {
+            ::sprintf( key, "Key%lu", jj );
+            ::sprintf( value, "%lu", ii * keyCount + jj );
+            const char * got = document.Get( section, key );
+            if ( ( NULL == got ) || ( 0 != ::strcmp( got, value ) ) )
+                found = false;
+        }
+    }
+    checker.Check( found, "large lookups" );
+    checker.CheckValue( document, "Section200", "Key0", NULL );
+    checker.CheckValue( document, "Section7", "Key20", NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoDocumentTests( bool showSummary )
+{
+    QuietReceiver quiet;
+    ConfigParser parser;
+    parser.SetMessageReceiver( &quiet );
+
+    Checker checker;
+    CheckSmallDocument( checker, parser );
+    CheckLargeDocument( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
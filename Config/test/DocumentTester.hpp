@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DocumentTester.hpp Checks that ConfigDocument stores and finds keys.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_DOCUMENT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_DOCUMENT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses config text into a ConfigDocument, and checks that global keys,
+ repeated sections, and repeated keys are found as expected, and that lookups
+ still work after the hash tables grow.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoDocumentTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,334 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventTester.cpp Tests ConfigEventBatcher, EventBuffer, and ParseConfig.
+
+
+// ----------------------------------------------------------------------------
+
+#include "EventTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigEventBatcher.hpp"
+#include "../include/ConfigSink.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Array sizes and batch sizes for event buffers.
+const unsigned long s_shapes[][ 2 ] =
+{
+    { 1, 1 },
+    { 2, 2 },
+    { 7, 3 },
+    { 64, 16 },
+};
+
+const unsigned int s_shapeCount = sizeof( s_shapes ) / sizeof( s_shapes[ 0 ] );
+
+const char * const s_validConfig =
+    "Global1 = One\n"
+    "GlobalFlag\n"
+    "[First]\n"
+    "Key1 = 1\n"
+    "Key2 = \"quoted value\" ; comment\n"
+    "Flag\n"
+    "[Second]\n"
+    "/* [NotSection] */ Inner = 2\n"
+    "Key3 = 3\n";
+
+const char * const s_brokenConfig =
+    "Global1 = One\n"
+    "[First]\n"
+    "Key1 = 1\n"
+    "[Broken\n"
+    "Key2 = 2\n";
+
+// ----------------------------------------------------------------------------
+
+/** Writes every event into a string in the same form as CallRecorder writes
+ receiver calls, and checks where each batch lies.
+ */
+class EventRecorder : public IEventBatchReceiver
+{
+public:
+
+    EventRecorder( const char * buffer, const ParseEvent * array,
+        unsigned long capacity, unsigned long batchSize ) :
+        IEventBatchReceiver(),
+        m_calls( buffer ),
+        m_array( array ),
+        m_capacity( capacity ),
+        m_batchSize( batchSize ),
+        m_held( 0 ),
+        m_badBatches( 0 ),
+        m_splitPairs( 0 ),
+        m_stopAfter( 0 ),
+        m_batches( 0 ),
+        m_keyCall( NULL ),
+        m_keyBegin( NULL ),
+        m_keyEnd( NULL )
+    {}
+
+    virtual ~EventRecorder( void ) {}
+
+    virtual bool TakeEvents( const ParseEvent * events, unsigned long count )
+    {
+        ++m_batches;
+        ++m_held;
+        if ( ( 0 == count ) || ( m_batchSize < count ) || ( events < m_array )
+          || ( m_array + m_capacity < events + count ) )
+            ++m_badBatches;
+        // A key and its value may not be split across two batches.
+        if ( ( 1 < m_batchSize ) && ( ConfigEventBatcher::Value == events[ 0 ].m_kind ) )
+            ++m_splitPairs;
+        for ( unsigned long ii = 0; ii < count; ++ii )
+        {
+            const ParseEvent & event = events[ ii ];
+            switch ( event.m_kind )
+            {
+                case ConfigEventBatcher::GlobalKey:
+                    HoldKey( "AddGlobalKey", event );
+                    break;
+                case ConfigEventBatcher::SectionKey:
+                    HoldKey( "AddSectionKey", event );
+                    break;
+                case ConfigEventBatcher::Section:
+                    m_calls.AddSection( event.m_begin, event.m_end );
+                    break;
+                case ConfigEventBatcher::Value:
+                    if ( NULL != m_keyCall )
+                    {
+                        m_calls.Add( m_keyCall, m_keyBegin, m_keyEnd,
+                            event.m_begin, event.m_end );
+                    }
+                    m_keyCall = NULL;
+                    break;
+                case ConfigEventBatcher::EndFile:
+                    m_calls.ParsedConfigFile(
+                        0 != ( ConfigEventBatcher::Valid & event.m_flags ) );
+                    break;
+            }
+        }
+        return ( 0 == m_stopAfter ) || ( m_batches < m_stopAfter );
+    }
+
+    virtual void ReuseEvents( const ParseEvent *, unsigned long )
+    {
+        --m_held;
+    }
+
+    CallRecorder m_calls;
+    const ParseEvent * m_array;
+    unsigned long m_capacity;
+    unsigned long m_batchSize;
+    /// Batches taken but not reused yet.
+    unsigned long m_held;
+    unsigned long m_badBatches;
+    unsigned long m_splitPairs;
+    /// Says to stop after this many batches, or zero to never stop.
+    unsigned long m_stopAfter;
+    unsigned long m_batches;
+
+private:
+
+    /// Keeps a key until its value comes, since a batch of one event may be
+    /// reused before the next batch.
+    void HoldKey( const char * call, const ParseEvent & event )
+    {
+        m_keyCall = call;
+        m_keyBegin = event.m_begin;
+        m_keyEnd = event.m_end;
+    }
+
+    const char * m_keyCall;
+    const char * m_keyBegin;
+    const char * m_keyEnd;
+
+    EventRecorder( const EventRecorder & );
+    EventRecorder & operator = ( const EventRecorder & );
+};
+
+// ----------------------------------------------------------------------------
+
+/// Parses a buffer with and without a batcher, and compares calls to events.
+void CheckConfig( TestChecker & checker, ConfigParser & parser, const char * text,
+    bool valid )
+{
+    const char * begin = text;
+    const char * end = begin + ::strlen( begin );
+    CallRecorder expected( begin );
+    const ConfigParser::ParseResults expectedResult = parser.Parse( begin, end, &expected );
+    checker.Check( valid == ( ConfigParser::AllValid == expectedResult ),
+        "Parser finds which buffer is broken." );
+
+    for ( unsigned int ii = 0; ii < s_shapeCount; ++ii )
+    {
+        const unsigned long capacity = s_shapes[ ii ][ 0 ];
+        const unsigned long batchSize = s_shapes[ ii ][ 1 ];
+        vector< ParseEvent > array( capacity );
+        EventRecorder recorder( begin, &array[ 0 ], capacity, batchSize );
+        EventBuffer buffer( &array[ 0 ], capacity, batchSize, &recorder );
+        ConfigEventBatcher batcher( buffer );
+        const ConfigParser::ParseResults result = batcher.Parse( parser, begin, end );
+
+        checker.Check( expectedResult == result, "Batcher returns what parser returns." );
+        checker.Check( expected.m_calls == recorder.m_calls.m_calls, "Events match receiver calls." );
+        checker.Check( 0 == recorder.m_badBatches, "Batches fit in array." );
+        checker.Check( 0 == recorder.m_held, "Flush reuses every batch." );
+        checker.Check( 0 == recorder.m_splitPairs, "Key and value stay in one batch." );
+        checker.Check( buffer.GetBatchCount() == recorder.m_batches,
+            "Buffer counts every batch." );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+/// Checks that a receiver can stop parsing, and that Reset lets the buffer go on.
+void CheckStop( TestChecker & checker, ConfigParser & parser )
+{
+    const char * begin = s_validConfig;
+    const char * end = begin + ::strlen( begin );
+    ParseEvent array[ 4 ];
+    EventRecorder recorder( begin, array, 4, 2 );
+    recorder.m_stopAfter = 2;
+    EventBuffer buffer( array, 4, 2, &recorder );
+    ConfigEventBatcher batcher( buffer );
+    batcher.Parse( parser, begin, end );
+
+    checker.Check( buffer.IsStopped(), "Buffer knows receiver said to stop." );
+    checker.Check( 2 == recorder.m_batches, "No batch given after stopping." );
+    checker.Check( 0 == recorder.m_held, "Stopped buffer reuses every batch." );
+
+    buffer.Reset();
+    recorder.m_stopAfter = 0;
+    recorder.m_batches = 0;
+    recorder.m_calls.m_calls.clear();
+    batcher.Parse( parser, begin, end );
+    checker.Check( !buffer.IsStopped(), "Reset buffer takes events again." );
+    checker.Check( buffer.GetBatchCount() == recorder.m_batches, "Reset clears counts." );
+    checker.Check( string::npos != recorder.m_calls.m_calls.find( "ParsedConfigFile valid" ),
+        "Parse after Reset gets to the end." );
+}
+
+// ----------------------------------------------------------------------------
+
+/** @class ThrowingSink
+ A sink which is not a receiver, and throws from the call after its limit.
+ */
+class ThrowingSink
+{
+public:
+
+    explicit ThrowingSink( unsigned long limit ) : m_limit( limit ), m_count( 0 ) {}
+
+    bool AddGlobalKey( const char *, const char *, const char *, const char * )
+    {
+        return Take();
+    }
+
+    bool AddSection( const char *, const char * ) { return Take(); }
+
+    bool AddSectionKey( const char *, const char *, const char *, const char * )
+    {
+        return Take();
+    }
+
+    void ParsedConfigFile( bool ) { Take(); }
+
+    unsigned long m_limit;
+    unsigned long m_count;
+
+private:
+
+    bool Take( void )
+    {
+        ++m_count;
+        if ( m_limit < m_count )
+            throw ::std::exception();
+        return true;
+    }
+
+};
+
+// ----------------------------------------------------------------------------
+
+/// Checks that ParseConfig gives a sink the same calls as Parse gives a receiver.
+void CheckSink( TestChecker & checker, ConfigParser & parser, const char * text )
+{
+    const char * begin = text;
+    const char * end = begin + ::strlen( begin );
+
+    for ( unsigned long limit = 0; limit < 8; ++limit )
+    {
+        CallRecorder expected( begin, limit );
+        const ConfigParser::ParseResults expectedResult =
+            parser.Parse( begin, end, &expected );
+        CallRecorder sink( begin, limit );
+        const ConfigParser::ParseResults result = ParseConfig( parser, begin, end, sink );
+        checker.Check( expectedResult == result, "Sink gets what parser returns." );
+        checker.Check( expected.m_calls == sink.m_calls, "Sink gets receiver calls." );
+
+        CallRecorder virtualSink( begin, limit );
+        IConfigReceiver & receiver = virtualSink;
+        ParseConfig( parser, begin, end, receiver );
+        checker.Check( expected.m_calls == virtualSink.m_calls,
+            "Receiver is one kind of sink." );
+    }
+
+    ThrowingSink thrower( 2 );
+    const ConfigParser::ParseResults result = ParseConfig( parser, begin, end, thrower );
+    checker.Check( ConfigParser::Exception == result, "Sink may throw." );
+    checker.Check( 3 == thrower.m_count, "No call after sink throws." );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoEventTests( bool showSummary )
+{
+    TestChecker checker( "Config Event" );
+    ConfigParser parser;
+    MessageCollector messages;
+    parser.SetMessageReceiver( &messages );
+
+    CheckConfig( checker, parser, s_validConfig, true );
+    CheckConfig( checker, parser, s_brokenConfig, false );
+    CheckStop( checker, parser );
+    CheckSink( checker, parser, s_validConfig );
+    CheckSink( checker, parser, s_brokenConfig );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventTester.hpp Checks that ConfigEventBatcher gives every call as an event.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_EVENT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_EVENT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses config buffers through a ConfigEventBatcher with several buffer
+ shapes, and checks the events against the calls a receiver gets directly.
+ @param showSummary True to show counts of checks.
+ @return True if all checks passed.
+ */
+bool DoEventTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+
+// $Header: $
+
+/// @file FileBufferTester.cpp Tests FileBuffer.
+
+
+// ----------------------------------------------------------------------------
+
+#include "FileBufferTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "../../Util/include/FileBuffer.hpp"
+#include "../../Util/include/TestUtil.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+const char s_scratchFile[] = "FileBufferTest.txt";
+
+/// Size of file which is read instead of mapped, since it fills whole pages
+/// and leaves no room in the mapped view for the sentinel.  This is a whole
+/// number of pages for every common page size.
+const unsigned long s_pagesSize = 0x10000;
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of loaded contents to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "File Buffer" ) {}
+
+    /// Checks the buffer holds exactly the text, followed by a nil.
+    void CheckContents( const FileBuffer & buffer, const string & text,
+        const char * what )
+    {
+        const bool passed = buffer.IsOpen()
+            && ( text.size() == buffer.GetSize() )
+            && ( buffer.GetBegin() + buffer.GetSize() == buffer.GetEnd() )
+            && ( 0 == ::memcmp( buffer.GetBegin(), text.data(), text.size() ) )
+            && ( '\0' == *buffer.GetEnd() );
+        Check( passed, what );
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+void CheckMissing( Checker & checker )
+{
+    FileBuffer buffer;
+    checker.Check( !buffer.IsOpen() && ( 0 == buffer.GetSize() ), "starts closed" );
+    ::remove( s_scratchFile );
+    checker.Check( !buffer.Open( s_scratchFile ), "missing file" );
+    checker.Check( !buffer.IsOpen() && ( NULL == buffer.GetBegin() ), "missing closed" );
+    checker.Check( !buffer.Open( NULL ), "no filename" );
+    checker.Check( !buffer.Open( "" ), "empty filename" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckEmpty( Checker & checker )
+{
+    FileBuffer buffer;
+    if ( !checker.Check( WriteTestFile( s_scratchFile, "" ), "write empty file" ) )
+        return;
+    checker.Check( buffer.Open( s_scratchFile ), "empty file" );
+    checker.CheckContents( buffer, string(), "empty contents" );
+    checker.Check( buffer.GetBegin() == buffer.GetEnd(), "empty range" );
+    buffer.Close();
+    checker.Check( !buffer.IsOpen() && ( 0 == buffer.GetSize() ), "empty closed" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckSmall( Checker & checker )
+{
+    const string text( "[Section]\nKey = Value\n" );
+    FileBuffer buffer;
+    if ( !checker.Check( WriteTestFile( s_scratchFile, text.c_str() ), "write small file" ) )
+        return;
+    checker.Check( buffer.Open( s_scratchFile ), "small file" );
+    checker.Check( buffer.IsMapped(), "small file mapped" );
+    checker.CheckContents( buffer, text, "small contents" );
+
+    // Opening again releases the old contents first.
+    checker.Check( buffer.Open( s_scratchFile ), "small file again" );
+    checker.CheckContents( buffer, text, "small contents again" );
+    buffer.Close();
+    checker.Check( !buffer.IsOpen() && !buffer.IsMapped(), "small closed" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckPages( Checker & checker )
+{
+    string text;
+    text.reserve( s_pagesSize );
+    while ( text.size() < s_pagesSize )
+        text += static_cast< char >( 'a' + ( text.size() % 26 ) );
+    FileBuffer buffer;
+    if ( !checker.Check( WriteTestFile( s_scratchFile, text.c_str() ), "write pages file" ) )
+        return;
+    checker.Check( buffer.Open( s_scratchFile ), "pages file" );
+    checker.Check( !buffer.IsMapped(), "pages file read" );
+    checker.CheckContents( buffer, text, "pages contents" );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoFileBufferTests( bool showSummary )
+{
+    Checker checker;
+    CheckMissing( checker );
+    CheckEmpty( checker );
+    CheckSmall( checker );
+    CheckPages( checker );
+    ::remove( s_scratchFile );
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+
+// $Header: $
+
+/// @file FileBufferTester.hpp Checks how FileBuffer loads files.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_FILE_BUFFER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_FILE_BUFFER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Loads an empty file, a missing file, a small file which is mapped, and a
+ file whose size is a whole number of pages so it is read instead, and checks
+ the size, contents, and nil sentinel of each.  Writes scratch files in the
+ current folder and removes them.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoFileBufferTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
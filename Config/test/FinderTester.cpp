@@ -0,0 +1,282 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file FinderTester.cpp Compares CharFinder kernels and RunParsers.
+
+
+// ----------------------------------------------------------------------------
+
+#include "FinderTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/spirit/core.hpp>
+
+#include "../../Util/include/CharFinder.hpp"
+#include "../src/CommonParsers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::boost::spirit;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Chars which finders and rules look for, mixed into runs of letters.
+const char s_specials[] = "-'\"&%]>?#/*; \t\r\n\x01\x7F\x80\xFF";
+
+const unsigned int s_specialCount = sizeof( s_specials ) - 1;
+
+/// Most chars past the start of a text at which to start searching.
+const unsigned int s_offsetCount = 40;
+
+// ----------------------------------------------------------------------------
+
+/// Makes the same texts on every run, so any failure can be repeated.
+class TextMaker
+{
+public:
+
+    TextMaker( void ) : m_seed( 12345 ) {}
+
+    /** Makes a text of mostly letters, with some special chars.
+     @param length How many chars to make.
+     @param spacing About how many chars from one special char to the next.
+     */
+    string Make( unsigned int length, unsigned int spacing )
+    {
+        string text;
+        text.reserve( length );
+        for ( unsigned int ii = 0; ii < length; ++ii )
+        {
+            const unsigned int value = Next();
+            if ( 0 == ( value % spacing ) )
+            {
+                const unsigned int which = ( value / spacing ) % ( s_specialCount + 1 );
+                // One place past the specials stands for an embedded nil.
+                text += ( which < s_specialCount ) ? s_specials[ which ] : '\0';
+            }
+            else
+                text += static_cast< char >( 'a' + ( value % 26 ) );
+        }
+        return text;
+    }
+
+private:
+
+    inline unsigned int Next( void )
+    {
+        m_seed = m_seed * 1103515245UL + 12345UL;
+        return static_cast< unsigned int >( ( m_seed >> 16 ) & 0x7FFF );
+    }
+
+    unsigned long m_seed;
+};
+
+// ----------------------------------------------------------------------------
+
+/// What a CharFinder should find, done the slow way.
+struct FinderCase
+{
+    const char * m_chars;
+    bool m_findUnprintable;
+
+    const char * Find( const char * begin, const char * end ) const
+    {
+        for ( ; begin != end; ++begin )
+        {
+            const char ch = *begin;
+            if ( m_findUnprintable && ( ( ch < ' ' ) || ( '~' < ch ) ) )
+                return begin;
+            if ( ( '\0' != ch ) && ( NULL != ::strchr( m_chars, ch ) ) )
+                return begin;
+        }
+        return end;
+    }
+};
+
+const FinderCase s_finderCases[] =
+{
+    { "-",    true  },
+    { "'&%",  false },
+    { "\"&%", false },
+    { "",     true  },
+    { "]",    false },
+    { "#/;x", true  },
+};
+
+const unsigned int s_finderCaseCount =
+    sizeof( s_finderCases ) / sizeof( s_finderCases[ 0 ] );
+
+
+// ----------------------------------------------------------------------------
+
+class FinderTester
+{
+public:
+
+    FinderTester( void );
+
+    /// Checks every case on every text with the kernel in use now.
+    void CheckAll( const vector< string > & texts );
+
+    inline unsigned long GetCheckCount( void ) const { return m_checks; }
+    inline unsigned long GetMismatchCount( void ) const { return m_mismatches; }
+
+private:
+
+    void Check( bool matched );
+
+    enum { RunCaseCount = 7 };
+
+    /// Each RunParser, and the Spirit rule it replaces at the same index.
+    rule<> m_fast[ RunCaseCount ];
+    rule<> m_spirit[ RunCaseCount ];
+    unsigned long m_checks;
+    unsigned long m_mismatches;
+};
+
+// ----------------------------------------------------------------------------
+
+FinderTester::FinderTester( void ) :
+    m_checks( 0 ),
+    m_mismatches( 0 )
+{
+    // These are the ways the config rules use RunParser.
+    m_fast[ 0 ] = RunParser( RunFinder( true, NULL ) );
+    m_spirit[ 0 ] = *( print_p - eol_p );
+    m_fast[ 1 ] = RunParser( RunFinder( true, "*/" ) );
+    m_spirit[ 1 ] = *( print_p - str_p( "*/" ) );
+    m_fast[ 2 ] = RunParser( RunFinder( true, "\"" ) );
+    m_spirit[ 2 ] = *( print_p - ( ch_p( '"' ) | eol_p | end_p ) );
+    m_fast[ 3 ] = RunParser( RunFinder( true, "/*", "#" ) );
+    m_spirit[ 3 ] = *( print_p - ( str_p( "/*" ) | str_p( "#" ) | eol_p ) );
+    // These are the ways the xml rules use RunFinder.
+    m_fast[ 4 ] = RunParser( RunFinder( false, "]]>" ) );
+    m_spirit[ 4 ] = *( anychar_p - str_p( "]]>" ) );
+    m_fast[ 5 ] = RunParser( RunFinder( false, "?>" ) );
+    m_spirit[ 5 ] = *( anychar_p - str_p( "?>" ) );
+    // An empty stop string hides the stop strings after it.
+    m_fast[ 6 ] = RunParser( RunFinder( true, "--", "", "#" ) );
+    m_spirit[ 6 ] = *( print_p - ( str_p( "--" ) | str_p( "" ) | str_p( "#" ) ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void FinderTester::Check( bool matched )
+{
+    ++m_checks;
+    if ( !matched )
+        ++m_mismatches;
+}
+
+// ----------------------------------------------------------------------------
+
+void FinderTester::CheckAll( const vector< string > & texts )
+{
+    for ( vector< string >::const_iterator it( texts.begin() );
+        it != texts.end(); ++it )
+    {
+        const char * const start = it->data();
+        const char * const end = start + it->size();
+        for ( unsigned int offset = 0;
+            ( offset < s_offsetCount ) && ( offset <= it->size() ); ++offset )
+        {
+            const char * const begin = start + offset;
+            for ( unsigned int ii = 0; ii < s_finderCaseCount; ++ii )
+            {
+                const FinderCase & finderCase = s_finderCases[ ii ];
+                const CharFinder finder( finderCase.m_chars,
+                    finderCase.m_findUnprintable );
+                Check( finder.Find( begin, end ) == finderCase.Find( begin, end ) );
+            }
+            for ( unsigned int ii = 0; ii < RunCaseCount; ++ii )
+            {
+                const parse_info<> fast = parse( begin, end, m_fast[ ii ] );
+                const parse_info<> spirit = parse( begin, end, m_spirit[ ii ] );
+                Check( ( fast.hit == spirit.hit ) && ( fast.stop == spirit.stop ) );
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+const char * GetKernelName( CharFinder::Kernel kernel )
+{
+    switch ( kernel )
+    {
+        case CharFinder::Scalar: return "Scalar";
+        case CharFinder::Sse2:   return "SSE2";
+        case CharFinder::Avx2:   return "AVX2";
+        default: break;
+    }
+    return "Unknown";
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoFinderTests( bool showSummary )
+{
+    // Short texts only reach the scalar tail of each kernel, and long texts with
+    // few specials let the vector loops run many times before finding one.
+    vector< string > texts;
+    TextMaker maker;
+    for ( unsigned int length = 0; length < 80; ++length )
+        texts.push_back( maker.Make( length, 7 ) );
+    for ( unsigned int ii = 0; ii < 40; ++ii )
+    {
+        texts.push_back( maker.Make( 300 + ii, 23 ) );
+        texts.push_back( maker.Make( 1000 + ii * 7, 200 ) );
+    }
+
+    const CharFinder::Kernel best = CharFinder::GetKernel();
+    const CharFinder::Kernel kernels[] =
+        { CharFinder::Scalar, CharFinder::Sse2, CharFinder::Avx2 };
+    FinderTester tester;
+    string used;
+    for ( unsigned int ii = 0; ii < sizeof( kernels ) / sizeof( kernels[ 0 ] ); ++ii )
+    {
+        if ( !CharFinder::SetKernel( kernels[ ii ] ) )
+            continue;
+        if ( !used.empty() )
+            used += ' ';
+        used += GetKernelName( kernels[ ii ] );
+        tester.CheckAll( texts );
+    }
+    CharFinder::SetKernel( best );
+
+    const bool passed = ( 0 == tester.GetMismatchCount() );
+    if ( showSummary || !passed )
+    {
+        cout << "Kernels: [" << used << "]\tBest: [" << GetKernelName( best )
+            << "]\tChecks: [" << tester.GetCheckCount() << "]\tMismatched: ["
+            << tester.GetMismatchCount() << "]\n";
+    }
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
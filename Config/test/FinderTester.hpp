@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file FinderTester.hpp Checks that every CharFinder kernel finds the same
+///  chars, and that RunParser matches what its Spirit rule matches.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_FINDER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_FINDER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Runs CharFinders and RunParsers over many made-up texts, at every offset,
+ once for each kernel this processor can use.  CharFinder results are checked
+ against a plain loop over each char, and RunParser results against the Spirit
+ rules which RunParser replaces.  The best kernel is chosen again afterward.
+ @param showSummary True to show which kernels were checked.
+ @return True if all results matched.
+ */
+bool DoFinderTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,532 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file MessageTester.cpp Tests MessageBuffer, ParseMessage, LineIndex, stacks, and receivers.
+
+
+// ----------------------------------------------------------------------------
+
+#include "MessageTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../Util/include/ErrorReceiver.hpp"
+#include "../../Util/include/LineIndex.hpp"
+#include "../../Util/include/ParseUtil.hpp"
+#include "../include/ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Config text with errors and warnings in several places.
+const char s_badConfig[] =
+    "GlobalKey = GlobalValue\n"
+    "[Section1\n"
+    "Key1 = Value1\n"
+    "= NoKey\n"
+    "[Section2]\n"
+    "Key2 = \"Unclosed\n"
+    "/* Unclosed comment\n";
+
+// ----------------------------------------------------------------------------
+
+/// Takes content from the parser and ignores it.
+class IgnoreReceiver : public IConfigReceiver
+{
+public:
+
+    IgnoreReceiver( void ) : IConfigReceiver() {}
+
+    virtual ~IgnoreReceiver( void ) {}
+
+    virtual bool AddGlobalKey( const char *, const char *, const char *, const char * )
+    {
+        return true;
+    }
+
+    virtual bool AddSection( const char *, const char * )
+    {
+        return true;
+    }
+
+    virtual bool AddSectionKey( const char *, const char *, const char *, const char * )
+    {
+        return true;
+    }
+
+    virtual void ParsedConfigFile( bool ) {}
+};
+
+// ----------------------------------------------------------------------------
+
+/// Counts messages by their fields, and never makes any text.
+class CountingReceiver : public IParseErrorReceiver
+{
+public:
+
+    CountingReceiver( void ) : IParseErrorReceiver(), m_count( 0 ), m_textCount( 0 ) {}
+
+    virtual ~CountingReceiver( void ) {}
+
+    virtual bool ReceiveParseMessage( const ParseMessage & )
+    {
+        ++m_count;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType * )
+    {
+        ++m_textCount;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *, unsigned long )
+    {
+        ++m_textCount;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *,
+        const char *, unsigned long )
+    {
+        ++m_textCount;
+        return true;
+    }
+
+    unsigned long m_count;
+    /// Calls which made text.  Should stay zero.
+    unsigned long m_textCount;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Counts messages given as text, and checks each text fits in a buffer.
+class TextReceiver : public IParseErrorReceiver
+{
+public:
+
+    TextReceiver( void ) : IParseErrorReceiver(), m_count( 0 ), m_badCount( 0 ) {}
+
+    virtual ~TextReceiver( void ) {}
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message )
+    {
+        ++m_count;
+        if ( !ErrorLevel::Valid( level ) || ( NULL == message )
+          || ( MessageBuffer::Capacity <= ::strlen( message ) ) )
+            ++m_badCount;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message,
+        unsigned long )
+    {
+        return GiveParseMessage( level, message );
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message,
+        const char *, unsigned long )
+    {
+        return GiveParseMessage( level, message );
+    }
+
+    unsigned long m_count;
+    unsigned long m_badCount;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Keeps line and column of each message, and never makes any text.
+class PlaceReceiver : public IParseErrorReceiver
+{
+public:
+
+    enum { MaxPlaces = 8 };
+
+    PlaceReceiver( void ) : IParseErrorReceiver(), m_count( 0 ) {}
+
+    virtual ~PlaceReceiver( void ) {}
+
+    virtual bool ReceiveParseMessage( const ParseMessage & message )
+    {
+        if ( m_count < MaxPlaces )
+        {
+            m_lines[ m_count ] = message.m_line;
+            m_columns[ m_count ] = message.m_column;
+        }
+        ++m_count;
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType * )
+    {
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *, unsigned long )
+    {
+        return true;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels, const CharType *,
+        const char *, unsigned long )
+    {
+        return true;
+    }
+
+    unsigned long m_count;
+    unsigned long m_lines[ MaxPlaces ];
+    unsigned long m_columns[ MaxPlaces ];
+};
+
+// ----------------------------------------------------------------------------
+
+bool CheckText( const MessageBuffer & buffer, const char * expected )
+{
+    if ( 0 == ::strcmp( buffer.GetText(), expected ) )
+        return true;
+    cout << "Message: [" << buffer.GetText() << "]\tExpected: [" << expected << "]\n";
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CheckBuffers( void )
+{
+    bool passed = true;
+
+    MessageBuffer numbers;
+    numbers.Append( 0UL );
+    numbers.Append( " " );
+    numbers.Append( 4294967295UL );
+    if ( !CheckText( numbers, "0 4294967295" ) || numbers.IsCut() )
+        passed = false;
+
+    // Fill buffer one char short, then add more than fits.
+    const string filler( MessageBuffer::Capacity - 2, 'x' );
+    MessageBuffer full;
+    full.Append( filler.c_str() );
+    if ( full.IsCut() || ( filler.size() != full.GetLength() ) )
+        passed = false;
+    full.Append( "yz" );
+    const string cut = filler.substr( 0, filler.size() - 2 ) + "...";
+    if ( !full.IsCut() || !CheckText( full, cut.c_str() ) )
+        passed = false;
+    if ( MessageBuffer::Capacity - 1 != full.GetLength() )
+        passed = false;
+    full.Append( "more" );
+    if ( !CheckText( full, cut.c_str() ) )
+        passed = false;
+
+    const string longText( MessageBuffer::Capacity * 3, 'w' );
+    MessageBuffer range;
+    range.Append( longText.c_str(), longText.c_str() + longText.size() );
+    if ( !range.IsCut() || ( MessageBuffer::Capacity - 1 != range.GetLength() ) )
+        passed = false;
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CheckFormats( void )
+{
+    bool passed = true;
+
+    {
+        MessageBuffer buffer;
+        ParseMessage( ErrorLevel::Minor, "Bad key." ).Format( buffer );
+        passed = CheckText( buffer, "Bad key." ) && passed;
+    }
+    {
+        MessageBuffer buffer;
+        ParseMessage message( ErrorLevel::Minor, "Bad key." );
+        message.m_line = 3;
+        message.m_column = 5;
+        message.Format( buffer );
+        passed = CheckText( buffer, "Bad key. On line 3 at char 5." ) && passed;
+    }
+    {
+        const char text[] = "Key1 = Value1\nKey2";
+        MessageBuffer buffer;
+        ParseMessage message( ErrorLevel::Content, text, text + 13 );
+        message.Format( buffer );
+        passed = CheckText( buffer, "Key1 = Value1" ) && passed;
+        passed = ( ParseMessage::Content == message.m_code ) && passed;
+    }
+    {
+        MessageBuffer buffer;
+        ParseMessage( "section", NULL, 0, 0 ).Format( buffer );
+        passed = CheckText( buffer, "section" ) && passed;
+    }
+    {
+        MessageBuffer buffer;
+        ParseMessage( "key", "Section1", 0, 0 ).Format( buffer );
+        passed = CheckText( buffer, "Inside key section for Section1" ) && passed;
+    }
+    {
+        MessageBuffer buffer;
+        ParseMessage message( "key", "Section1", 12, 7 );
+        message.Format( buffer );
+        passed = CheckText( buffer,
+            "Inside key section for Section1 on line 12 at char 7." ) && passed;
+        passed = ( ErrorLevel::Content == message.m_level ) && passed;
+        passed = ( ParseMessage::Location == message.m_code ) && passed;
+    }
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Checks each place in text against lines and columns counted one char at a time.
+bool CheckLineIndex( LineIndex & index, const string & text )
+{
+    const char * begin = text.data();
+    const char * end = begin + text.size();
+    index.SetText( begin, end );
+    bool passed = true;
+    unsigned long line = 0;
+    unsigned long column = 0;
+    // Look at the last place first, so the rest find newlines already stored.
+    if ( !index.Find( end, line, column ) )
+        passed = false;
+    unsigned long expectedLine = 1;
+    unsigned long expectedColumn = 1;
+    for ( const char * place = begin; place <= end; ++place )
+    {
+        if ( !index.Find( place, line, column )
+          || ( expectedLine != line ) || ( expectedColumn != column ) )
+        {
+            cout << "Line index at " << ( place - begin ) << " gave line " << line
+                << " char " << column << ", not line " << expectedLine
+                << " char " << expectedColumn << ".\n";
+            passed = false;
+        }
+        if ( ( place != end ) && ( '\n' == *place ) )
+        {
+            ++expectedLine;
+            expectedColumn = 1;
+        }
+        else
+            ++expectedColumn;
+    }
+    line = 0;
+    if ( index.Find( end + 1, line, column ) || index.Find( NULL, line, column )
+      || ( 0 != line ) )
+        passed = false;
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CheckLineIndexes( void )
+{
+    LineIndex index;
+    unsigned long line = 0;
+    unsigned long column = 0;
+    bool passed = !index.Find( "", line, column );
+
+    string text;
+    passed = CheckLineIndex( index, text ) && passed;
+    passed = CheckLineIndex( index, "\n" ) && passed;
+    passed = CheckLineIndex( index, "no newline" ) && passed;
+    passed = CheckLineIndex( index, "\n\nKey = Value\r\n\r\n[Section]\n" ) && passed;
+    // Lines longer and shorter than the widths the finder kernels look at.
+    for ( unsigned int ii = 0; ii < 200; ++ii )
+    {
+        text.append( ( ii * 7 ) % 71, 'x' );
+        text += '\n';
+    }
+    passed = CheckLineIndex( index, text ) && passed;
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Keeps places of messages sent by a MessageStack, and counts content.
+class StackRecorder : public IStackMessagePreparer
+{
+public:
+
+    explicit StackRecorder( const MessageStack * stack ) : IStackMessagePreparer(),
+        m_stack( stack ), m_places(), m_contentCount( 0 ) {}
+
+    virtual ~StackRecorder( void ) {}
+
+    virtual bool PrepareErrorMessage( ErrorLevel::Levels, const CharType * )
+    {
+        m_places.push_back( m_stack->GetSendPlace() );
+        return true;
+    }
+
+    virtual bool PrepareErrorMessage( ErrorLevel::Levels, const CharType *,
+        const CharType * )
+    {
+        return true;
+    }
+
+    virtual bool PrepareContentMessage( const CharType * )
+    {
+        ++m_contentCount;
+        return true;
+    }
+
+    virtual bool PrepareContentMessage( const CharType *, const CharType * )
+    {
+        ++m_contentCount;
+        return true;
+    }
+
+    virtual bool PrepareContentMessage( const CharType *, const CharType *,
+        unsigned long, unsigned long )
+    {
+        ++m_contentCount;
+        return true;
+    }
+
+    const MessageStack * m_stack;
+    vector< const CharType * > m_places;
+    unsigned long m_contentCount;
+
+private:
+
+    StackRecorder( const StackRecorder & );
+    StackRecorder & operator = ( const StackRecorder & );
+};
+
+// ----------------------------------------------------------------------------
+
+/// Checks that stacks deeper than they used to be able to hold keep every frame.
+bool CheckStacks( void )
+{
+    const unsigned long depth = 200;
+    const string text( depth, 'x' );
+    const CharType * const place = text.c_str();
+    bool passed = true;
+
+    MessageStack messages;
+    StackRecorder recorder( &messages );
+    messages.SetPreparer( &recorder );
+    for ( unsigned int round = 0; round < 2; ++round )
+    {
+        recorder.m_places.clear();
+        for ( unsigned long ii = 0; ii < depth; ++ii )
+            messages.Push( ErrorLevel::Minor, "Deep message.", NULL, NULL, place + ii );
+        passed = ( depth == messages.GetStackSize() ) && passed;
+        // Cancel the even ones, and send the odd ones.
+        for ( unsigned long ii = depth; 0 < ii; --ii )
+        {
+            if ( 0 == ii % 2 )
+                messages.Pop();
+            else
+                messages.Cancel();
+        }
+        passed = ( 0 == messages.GetStackSize() ) && passed;
+        passed = ( depth / 2 == recorder.m_places.size() ) && passed;
+        for ( unsigned long ii = 0; passed && ( ii < recorder.m_places.size() ); ++ii )
+            passed = ( place + depth - 1 - ii * 2 == recorder.m_places[ ii ] );
+    }
+
+    ContentStack contents;
+    contents.SetPreparer( &recorder );
+    for ( unsigned long ii = 0; ii < depth; ++ii )
+        contents.Push( place + ii, "element", ii + 1, 1 );
+    passed = ( depth == contents.GetStackSize() ) && passed;
+    passed = ( place == contents.GetContentAt( 0 ) ) && passed;
+    passed = ( place + depth - 1 == contents.GetContentAt( depth - 1 ) ) && passed;
+    passed = ( depth == contents.GetLineAt( depth - 1 ) ) && passed;
+    passed = ( NULL == contents.GetContentAt( depth ) ) && passed;
+    passed = contents.OutputWholeStack() && ( depth == recorder.m_contentCount ) && passed;
+    contents.Clear();
+    passed = ( 0 == contents.GetStackSize() ) && passed;
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Checks messages from the parser say which line and char they are about.
+bool CheckPlaces( ConfigParser & parser, const char * end )
+{
+    IgnoreReceiver content;
+    PlaceReceiver places;
+    parser.SetMessageReceiver( &places );
+    parser.Parse( s_badConfig, end, &content );
+    // Section with no end is on line 2, and its name starts at char 2.  The
+    // parser can not go past "= NoKey" at the start of line 4.
+    return ( 2 == places.m_count )
+        && ( 2 == places.m_lines[ 0 ] ) && ( 2 == places.m_columns[ 0 ] )
+        && ( 4 == places.m_lines[ 1 ] ) && ( 1 == places.m_columns[ 1 ] );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoMessageTests( bool showSummary )
+{
+    bool passed = CheckBuffers();
+    if ( !CheckFormats() )
+        passed = false;
+    if ( !CheckLineIndexes() )
+        passed = false;
+    if ( !CheckStacks() )
+        passed = false;
+
+    const char * end = s_badConfig + sizeof( s_badConfig ) - 1;
+    IgnoreReceiver content;
+    CountingReceiver counter;
+    TextReceiver reader;
+    ConfigParser parser;
+
+    parser.SetMessageReceiver( &counter );
+    const ConfigParser::ParseResults countResult = parser.Parse( s_badConfig, end, &content );
+    parser.SetMessageReceiver( &reader );
+    const ConfigParser::ParseResults textResult = parser.Parse( s_badConfig, end, &content );
+
+    if ( ( countResult != textResult ) || ( ConfigParser::AllValid == countResult ) )
+        passed = false;
+    if ( ( 0 == counter.m_count ) || ( 0 != counter.m_textCount ) )
+        passed = false;
+    if ( ( counter.m_count != reader.m_count ) || ( 0 != reader.m_badCount ) )
+        passed = false;
+    if ( !CheckPlaces( parser, end ) )
+        passed = false;
+
+    if ( showSummary || !passed )
+    {
+        cout << "Messages Counted: [" << counter.m_count << "]\tRead: ["
+            << reader.m_count << "]\tBad: [" << reader.m_badCount << "]\t"
+            << ( passed ? "Passed" : "Failed" ) << '\n';
+    }
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
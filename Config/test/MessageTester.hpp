@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file MessageTester.hpp Checks that parse messages are made without using
+///  the heap, and that receivers see the same messages with or without text.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_MESSAGE_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_MESSAGE_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Checks that MessageBuffer cuts long text, that each kind of ParseMessage
+ makes the expected text, and that a receiver which only counts messages is
+ given as many messages as one which reads the text of each.
+ @param showSummary True to show how many messages were checked.
+ @return True if all checks passed.
+ */
+bool DoMessageTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+
+// $Header: $
+
+/// @file ProfileTester.cpp Tests RuleProfile.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ProfileTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <boost/spirit/core.hpp>
+
+#include "../../Util/include/RuleProfile.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigParser.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::boost::spirit;
+using namespace ::Parser;
+
+namespace
+{
+
+#if defined( PARSER_RULE_PROFILE )
+
+/// Returns counts of the rule with this name in this file, or NULL if none.
+const RuleCounts * FindCounts( const char * name, const char * file )
+{
+    for ( unsigned long ii = 0; ii < RuleProfile::GetCount(); ++ii )
+    {
+        const RuleCounts & counts = RuleProfile::GetCounts( ii );
+        if ( ( 0 == ::strcmp( name, counts.m_name ) )
+          && ( 0 == ::strcmp( file, counts.m_file ) ) )
+            return &counts;
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Checks every count of a rule except its cycles.
+void CheckCounts( TestChecker & checker, const RuleCounts & counts,
+    unsigned long entries, unsigned long matches, unsigned long fails,
+    double bytes, double backtracked, const char * what )
+{
+    checker.Check( ( entries == counts.m_entries ) && ( matches == counts.m_matches )
+        && ( fails == counts.m_fails ) && ( bytes == counts.m_bytes )
+        && ( backtracked == counts.m_backtracked ), what );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckMarkedRule( TestChecker & checker )
+{
+    rule<> pair;
+    PARSER_PROFILE_RULE( pair ) = ch_p( 'a' ) >> ch_p( 'b' );
+    rule<> pairs = *pair;
+    const RuleCounts * found = FindCounts( "pair", "ProfileTester.cpp" );
+    if ( !checker.Check( NULL != found, "rule registered" ) )
+        return;
+    const RuleCounts & counts = *found;
+
+    RuleProfile::Reset();
+    CheckCounts( checker, counts, 0, 0, 0, 0.0, 0.0, "reset" );
+    const char * text = "ab";
+    checker.Check( parse( text, text + 2, pair ).full, "match" );
+    CheckCounts( checker, counts, 1, 1, 0, 2.0, 0.0, "counts after match" );
+    // The 'a' is matched before the rule fails, so it is gone back over.
+    text = "ax";
+    checker.Check( !parse( text, text + 2, pair ).hit, "fail" );
+    CheckCounts( checker, counts, 2, 1, 1, 2.0, 1.0, "counts after fail" );
+
+    // Within another rule, the rule is tried until it fails.
+    RuleProfile::Reset();
+    text = "ababx";
+    checker.Check( 4 == parse( text, text + 5, pairs ).length, "repeat" );
+    CheckCounts( checker, counts, 3, 2, 1, 4.0, 0.0, "counts after repeat" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckGrammarRule( TestChecker & checker )
+{
+    QuietReceiver quiet;
+    ConfigParser parser;
+    parser.SetMessageReceiver( &quiet );
+    const char * text = "Key = Value\n[Section]\nOther = Value\n";
+    CallRecorder recorder( text );
+    RuleProfile::Reset();
+    checker.Check( ConfigParser::AllValid == parser.Parse( text, text + ::strlen( text ),
+        &recorder ), "parse config" );
+    const RuleCounts * found = FindCounts( "m_start", "ParserRules.cpp" );
+    if ( !checker.Check( NULL != found, "grammar rule registered" ) )
+        return;
+    // The start rule matches no chars once each parse.
+    CheckCounts( checker, *found, 1, 1, 0, 0.0, 0.0, "grammar counts" );
+}
+
+#endif
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoProfileTests( bool showSummary )
+{
+    TestChecker checker( "Rule Profile" );
+#if defined( PARSER_RULE_PROFILE )
+    checker.Check( RuleProfile::IsEnabled(), "enabled" );
+    CheckMarkedRule( checker );
+    CheckGrammarRule( checker );
+#else
+    checker.Check( !RuleProfile::IsEnabled(), "not enabled" );
+    checker.Check( 0 == RuleProfile::GetCount(), "no rules registered" );
+#endif
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
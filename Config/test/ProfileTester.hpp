@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+
+// $Header: $
+
+/// @file ProfileTester.hpp Checks counts kept by RuleProfile.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_PROFILE_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_PROFILE_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** In builds which define PARSER_RULE_PROFILE, parses known inputs with a
+ marked rule and with the config grammar, and checks the entries, matches,
+ fails, and chars counted for each rule.  In other builds, checks that no
+ rule was registered.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoProfileTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
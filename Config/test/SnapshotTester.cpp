@@ -0,0 +1,215 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SnapshotTester.cpp Tests ConfigSnapshot.
+
+
+// ----------------------------------------------------------------------------
+
+#include "SnapshotTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigDocument.hpp"
+#include "../include/ConfigSnapshot.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+const char s_config[] =
+    "Global1 = One\n"
+    "[Colors]\n"
+    "Red = FF0000\n"
+    "Green = 00FF00\n"
+    "[Sizes]\n"
+    "Small = 1\n"
+    "[Colors]\n"
+    "Red = Crimson\n";
+
+const char s_changed[] =
+    "Global1 = One\n"
+    "[Colors]\n"
+    "Red = Scarlet\n";
+
+const char s_broken[] =
+    "[Colors\n"
+    "Red = FF0000\n";
+
+const char s_sourceFile[] = "SnapshotTest.cfg";
+const char s_imageFile[] = "SnapshotTest.img";
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of key values to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "Config Snapshot" ) {}
+
+    void CheckValue( const ConfigSnapshot & snapshot, const char * section,
+        const char * key, const char * expected )
+    {
+        const char * value = snapshot.Get( section, key );
+        const bool passed = ( NULL == expected ) ? ( NULL == value )
+            : ( ( NULL != value ) && ( 0 == ::strcmp( value, expected ) ) );
+        Check( passed, key );
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+/// Checks that every section and key of the document is in the snapshot.
+void CompareAll( Checker & checker, const ConfigDocument & document,
+    const ConfigSnapshot & snapshot )
+{
+    bool same = ( document.GetSectionCount() == snapshot.GetSectionCount() );
+    for ( unsigned long ii = 0; same && ( ii < document.GetSectionCount() ); ++ii )
+    {
+        const char * name = document.GetSectionName( ii );
+        same = ( ii == snapshot.FindSection( name ) )
+            && ( document.GetSectionLine( ii ) == snapshot.GetSectionLine( ii ) )
+            && ( document.GetKeyCount( ii ) == snapshot.GetKeyCount( ii ) );
+        for ( unsigned long key = document.GetFirstKey( ii );
+            same && ( ConfigDocument::NoIndex != key ); key = document.GetNextKey( key ) )
+        {
+            const char * value = snapshot.Get( name, document.GetKeyName( key ) );
+            same = ( NULL != value ) && ( 0 == ::strcmp( value, document.GetKeyValue( key ) ) )
+                && ( document.GetKeyLine( key ) == snapshot.GetKeyLine( key ) );
+        }
+    }
+    checker.Check( same, "same as document" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckImages( Checker & checker, ConfigParser & parser )
+{
+    const char * end = s_config + sizeof( s_config ) - 1;
+    ConfigDocument document;
+    document.Parse( parser, s_config, end );
+    checker.Check( document.IsValid(), "document valid" );
+    const unsigned long red = document.FindKey( document.FindSection( "Colors" ), "Red" );
+    checker.Check( 8 == document.GetKeyLine( red ), "document key line" );
+    checker.Check( 2 == document.GetSectionLine( document.FindSection( "Colors" ) ),
+        "document section line" );
+
+    vector< char > image;
+    checker.Check( ConfigSnapshot::MakeImage( document, s_config, end, image ), "make" );
+
+    ConfigSnapshot snapshot;
+    checker.Check( NULL == snapshot.Get( "Colors", "Red" ), "closed" );
+    const unsigned long size = static_cast< unsigned long >( image.size() );
+    checker.Check( snapshot.Attach( &image[ 0 ], size, s_config, end ), "attach" );
+    checker.Check( snapshot.IsValid() && !snapshot.IsMapped(), "attached" );
+    checker.CheckValue( snapshot, NULL, "Global1", "One" );
+    checker.CheckValue( snapshot, "Colors", "Red", "Crimson" );
+    checker.CheckValue( snapshot, "Colors", "Green", "00FF00" );
+    checker.CheckValue( snapshot, "Sizes", "Small", "1" );
+    checker.CheckValue( snapshot, "Sizes", "Red", NULL );
+    checker.CheckValue( snapshot, "Shapes", "Red", NULL );
+    CompareAll( checker, document, snapshot );
+
+    // Image of other chars, or a damaged image, is not used.
+    const char * changedEnd = s_changed + sizeof( s_changed ) - 1;
+    checker.Check( !snapshot.Attach( &image[ 0 ], size, s_changed, changedEnd ), "stale" );
+    checker.Check( !snapshot.IsOpen(), "stale closed" );
+    checker.Check( !snapshot.Attach( &image[ 0 ], size - 1, NULL, NULL ), "short" );
+    vector< char > damaged( image );
+    damaged[ 0 ] ^= 0x20;
+    checker.Check( !snapshot.Attach( &damaged[ 0 ], size, NULL, NULL ), "magic" );
+    damaged = image;
+    damaged[ size - 1 ] = 'x';
+    checker.Check( !snapshot.Attach( &damaged[ 0 ], size, NULL, NULL ), "no nil" );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckFiles( Checker & checker, ConfigParser & parser )
+{
+    ::remove( s_imageFile );
+    if ( !WriteTestFile( s_sourceFile, s_config ) )
+    {
+        checker.Check( false, "write config file" );
+        return;
+    }
+
+    ConfigSnapshot snapshot;
+    checker.Check( ConfigSnapshot::NoSource == snapshot.Load( parser, "NoSuchFile.cfg",
+        s_imageFile ), "no source" );
+    checker.Check( ConfigSnapshot::Rebuilt == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "first load" );
+    checker.CheckValue( snapshot, "Colors", "Red", "Crimson" );
+    checker.Check( ConfigSnapshot::Mapped == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "second load" );
+    checker.Check( snapshot.IsValid(), "mapped valid" );
+    checker.CheckValue( snapshot, "Colors", "Red", "Crimson" );
+    checker.CheckValue( snapshot, "Sizes", "Small", "1" );
+    checker.Check( 8 == snapshot.GetKeyLine( snapshot.FindKey( 1, "Red" ) ), "mapped line" );
+
+    checker.Check( WriteTestFile( s_sourceFile, s_changed ), "write changed file" );
+    checker.Check( ConfigSnapshot::Rebuilt == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "changed load" );
+    checker.CheckValue( snapshot, "Colors", "Red", "Scarlet" );
+    checker.CheckValue( snapshot, "Sizes", "Small", NULL );
+    checker.Check( ConfigSnapshot::Mapped == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "changed mapped" );
+
+    // Broken file is parsed each time and never replaces the saved image.
+    checker.Check( WriteTestFile( s_sourceFile, s_broken ), "write broken file" );
+    checker.Check( ConfigSnapshot::NotValid == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "broken load" );
+    checker.Check( snapshot.IsOpen() && !snapshot.IsValid(), "broken open" );
+    checker.Check( WriteTestFile( s_sourceFile, s_changed ), "restore changed file" );
+    checker.Check( ConfigSnapshot::Mapped == snapshot.Load( parser, s_sourceFile,
+        s_imageFile ), "image kept" );
+
+    snapshot.Close();
+    ::remove( s_sourceFile );
+    ::remove( s_imageFile );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoSnapshotTests( bool showSummary )
+{
+    QuietReceiver quiet;
+    ConfigParser parser;
+    parser.SetMessageReceiver( &quiet );
+
+    Checker checker;
+    CheckImages( checker, parser );
+    CheckFiles( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
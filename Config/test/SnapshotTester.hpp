@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SnapshotTester.hpp Checks that config images match their documents.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_SNAPSHOT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_SNAPSHOT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Makes images from parsed config text and checks that they find the same
+ values and lines as the document, that damaged or stale images are rejected,
+ and that Load maps a saved image and rebuilds it when the config file changes.
+ Writes two scratch files in the current folder and removes them.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoSnapshotTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
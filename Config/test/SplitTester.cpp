@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SplitTester.cpp Tests ConfigSplitParser.
+
+
+// ----------------------------------------------------------------------------
+
+#include "SplitTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+
+#include "../include/ConfigDocument.hpp"
+#include "../include/ConfigSplitParser.hpp"
+#include "../../Util/include/TestUtil.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Small, so a test buffer has many pieces.
+const unsigned long s_pieceSize = 2000;
+
+// ----------------------------------------------------------------------------
+
+/** Makes a config buffer with global keys, repeated sections, and comments,
+ some of which start with the line comment or block comment and hold things
+ which look like sections.
+ @param lineComment Line comment delimiter of the policy used.
+ @param broken True to put a section with no end near the end.
+ */
+string MakeConfig( unsigned long sectionCount, const char * lineComment, bool broken )
+{
+    string text;
+    char line[ 160 ];
+    ::sprintf( line, "%s [NotSection] comment\n", lineComment );
+    text += line;
+    text += "Global1 = One\n"
+        "/* [NotSection] */ Global2 = Two\n"
+        "GlobalFlag\n";
+    for ( unsigned long ii = 0; ii < sectionCount; ++ii )
+    {
+        if ( broken && ( sectionCount * 2 / 3 == ii ) )
+            text += "[Broken\n";
+        if ( 0 == ii % 7 )
+            text += "[Repeat]\n";
+        else if ( 1 == ii % 7 )
+        {
+            ::sprintf( line, " \t[ Section%lu ] %s comment\n", ii, lineComment );
+            text += line;
+        }
+        else
+        {
+            ::sprintf( line, "[Section%lu]\n", ii );
+            text += line;
+        }
+        ::sprintf( line, "Key%lu = %lu\n"
+            "%s[Section%lu] is not here\n"
+            "/* [Section%lu] */ Inner = %lu /* comment */\n"
+            "Quoted = \"quoted value %lu\"\n"
+            "Flag%lu\n\n",
+            ii, ii, lineComment, ii + 1, ii + 1, ii, ii, ii );
+        text += line;
+    }
+    return text;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses a buffer both ways and compares calls, results, messages, and documents.
+void CheckConfig( TestChecker & checker, ConfigSplitParser & splitter,
+    const ConfigParser::ParserPolicy & policy, const string & text, bool broken,
+    bool small, unsigned long limit )
+{
+    const char * begin = text.c_str();
+    const char * end = begin + text.size();
+
+    ConfigParser parser;
+    parser.SetPolicy( policy );
+    MessageCollector parserMessages;
+    string expectedMessages;
+    parserMessages.SetTarget( &expectedMessages, NULL );
+    parser.SetMessageReceiver( &parserMessages );
+    CallRecorder expected( begin, limit );
+    const ConfigParser::ParseResults expectedResult = parser.Parse( begin, end, &expected );
+
+    MessageCollector splitMessages;
+    string messages;
+    splitMessages.SetTarget( &messages, NULL );
+    splitter.SetMessageReceiver( &splitMessages );
+    CallRecorder received( begin, limit );
+    const ConfigParser::ParseResults result = splitter.Parse( begin, end, &received );
+    const ConfigSplitStats stats = splitter.GetSplitStats();
+
+    checker.Check( result == expectedResult, "Result is the same as one pass." );
+    checker.Check( messages == expectedMessages, "Messages are the same as one pass." );
+    checker.Check( expected.m_calls == received.m_calls,
+        "Receiver gets the same calls as one pass." );
+    checker.Check( small == ( 0 == stats.m_pieces ), "Buffer is split only if large." );
+    checker.Check( broken == stats.m_reparsed, "Only a broken buffer is parsed again." );
+    checker.Check( broken == ( ConfigParser::AllValid != result ),
+        "Only a broken buffer is not valid." );
+
+    ConfigDocument expectedDocument;
+    ConfigDocument document;
+    parserMessages.SetTarget( NULL, NULL );
+    splitMessages.SetTarget( NULL, NULL );
+    expectedDocument.Parse( parser, begin, end );
+    document.Parse( splitter, begin, end );
+    checker.Check( SameDocuments( expectedDocument, document, true ),
+        "Document has the same keys and lines as one pass." );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoSplitTests( unsigned int threadCount, bool showSummary )
+{
+    TestChecker checker( "Config Split" );
+    ConfigSplitParser splitter( threadCount );
+    splitter.SetPieceSize( s_pieceSize );
+    checker.Check( s_pieceSize == splitter.GetPieceSize(), "Piece size is kept." );
+
+    ConfigParser::ParserPolicy policy;
+    const string large = MakeConfig( 400, policy.LineComment, false );
+    CheckConfig( checker, splitter, policy, large, false, false, 0xFFFFFFFFUL );
+    const ConfigSplitStats stats = splitter.GetSplitStats();
+    CheckConfig( checker, splitter, policy, large, false, false, 1000 );
+    CheckConfig( checker, splitter, policy, MakeConfig( 400, policy.LineComment, true ),
+        true, false, 0xFFFFFFFFUL );
+    CheckConfig( checker, splitter, policy, MakeConfig( 3, policy.LineComment, false ),
+        false, true, 0xFFFFFFFFUL );
+
+    // A line comment which starts like a section still makes a comment.
+    char lineComment[] = "[[";
+    policy.LineComment = lineComment;
+    policy.TrimWhiteSpace = true;
+    policy.AllowQuotedCommentInValue = true;
+    checker.Check( splitter.SetPolicy( policy ), "Policy is taken." );
+    CheckConfig( checker, splitter, policy, MakeConfig( 400, lineComment, false ),
+        false, false, 0xFFFFFFFFUL );
+
+    if ( showSummary || ( 0 < checker.GetFailCount() ) )
+        cout << "Config Split Pieces: [" << stats.m_pieces << "]\n";
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
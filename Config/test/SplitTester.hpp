@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SplitTester.hpp Checks that ConfigSplitParser matches parsing in one pass.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_SPLIT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_SPLIT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses large config buffers with a ConfigSplitParser on several threads,
+ and checks the calls, result, messages, and line numbers against parsing the
+ same buffer with a ConfigParser in one pass.
+ @param threadCount Most threads for the split parser.
+ @param showSummary True to show counts of pieces and checks.
+ @return True if all checks passed.
+ */
+bool DoSplitTests( unsigned int threadCount, bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,151 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file TestHelpers.cpp Receivers and comparisons shared by the config testers.
+
+
+// ----------------------------------------------------------------------------
+
+#include "TestHelpers.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/ConfigDocument.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+
+// ----------------------------------------------------------------------------
+
+CallRecorder::CallRecorder( const char * buffer, unsigned long limit ) :
+    IConfigReceiver(),
+    m_calls(),
+    m_buffer( buffer ),
+    m_limit( limit ),
+    m_count( 0 )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+CallRecorder::~CallRecorder( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddGlobalKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    Add( "AddGlobalKey", keyStart, keyEnd, valueStart, valueEnd );
+    return Take();
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddSection( const char * nameStart, const char * nameEnd )
+{
+    assert( NULL != this );
+    Add( "AddSection", nameStart, nameEnd, NULL, NULL );
+    return Take();
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddSectionKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    Add( "AddSectionKey", keyStart, keyEnd, valueStart, valueEnd );
+    return Take();
+}
+
+// ----------------------------------------------------------------------------
+
+void CallRecorder::ParsedConfigFile( bool valid )
+{
+    assert( NULL != this );
+    m_calls += valid ? "ParsedConfigFile valid\n" : "ParsedConfigFile invalid\n";
+}
+
+// ----------------------------------------------------------------------------
+
+void CallRecorder::Add( const char * call, const char * keyStart,
+    const char * keyEnd, const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    char places[ 80 ];
+    ::sprintf( places, " %ld %ld %ld %ld\n", Offset( keyStart ), Offset( keyEnd ),
+        Offset( valueStart ), Offset( valueEnd ) );
+    m_calls += call;
+    m_calls += places;
+}
+
+// ----------------------------------------------------------------------------
+
+long CallRecorder::Offset( const char * place ) const
+{
+    assert( NULL != this );
+    return ( NULL == place ) ? -1 : static_cast< long >( place - m_buffer );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::Take( void )
+{
+    assert( NULL != this );
+    ++m_count;
+    return ( 0 == m_limit ) || ( m_count < m_limit );
+}
+
+// ----------------------------------------------------------------------------
+
+bool SameDocuments( const ConfigDocument & left, const ConfigDocument & right,
+    bool sameLines )
+{
+    if ( left.GetSectionCount() != right.GetSectionCount() )
+        return false;
+    for ( unsigned long ii = 0; ii < left.GetSectionCount(); ++ii )
+    {
+        if ( ( 0 != ::strcmp( left.GetSectionName( ii ), right.GetSectionName( ii ) ) )
+          || ( left.GetKeyCount( ii ) != right.GetKeyCount( ii ) ) )
+            return false;
+        if ( sameLines && ( left.GetSectionLine( ii ) != right.GetSectionLine( ii ) ) )
+            return false;
+        unsigned long other = right.GetFirstKey( ii );
+        for ( unsigned long key = left.GetFirstKey( ii ); ConfigDocument::NoIndex != key;
+            key = left.GetNextKey( key ), other = right.GetNextKey( other ) )
+        {
+            if ( ( 0 != ::strcmp( left.GetKeyName( key ), right.GetKeyName( other ) ) )
+              || ( 0 != ::strcmp( left.GetKeyValue( key ), right.GetKeyValue( other ) ) ) )
+                return false;
+            if ( sameLines && ( left.GetKeyLine( key ) != right.GetKeyLine( other ) ) )
+                return false;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
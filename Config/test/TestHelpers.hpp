@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file TestHelpers.hpp Receivers and comparisons shared by the config testers.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_TEST_HELPERS_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_TEST_HELPERS_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+#include <string>
+
+#include "../include/ConfigParser.hpp"
+
+
+namespace Parser
+{
+    class ConfigDocument;
+};
+
+
+// ----------------------------------------------------------------------------
+
+/** @class CallRecorder
+ Writes each receiver call into a string, one line each, with the places of
+ its key, value, or section name as offsets into the buffer, so calls made by
+ different parsers may be compared.  Places which are NULL are written as -1.
+ */
+class CallRecorder : public ::Parser::IConfigReceiver
+{
+public:
+
+    /** @param buffer Start of text being parsed.
+     @param limit Number of calls to take before returning false to stop the
+      parser, or zero to never stop it.
+     */
+    explicit CallRecorder( const char * buffer, unsigned long limit = 0 );
+
+    virtual ~CallRecorder( void );
+
+    virtual bool AddGlobalKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual bool AddSection( const char * nameStart, const char * nameEnd );
+
+    virtual bool AddSectionKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual void ParsedConfigFile( bool valid );
+
+    /// Adds a line in the same form as the receiver calls.
+    void Add( const char * call, const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    ::std::string m_calls;
+
+private:
+
+    /// Not implemented.
+    CallRecorder( const CallRecorder & );
+    /// Not implemented.
+    CallRecorder & operator = ( const CallRecorder & );
+
+    long Offset( const char * place ) const;
+
+    /// Counts one call, and returns false once the limit is reached.
+    bool Take( void );
+
+    const char * m_buffer;
+    unsigned long m_limit;
+    unsigned long m_count;
+};
+
+// ----------------------------------------------------------------------------
+
+/** Returns true if both documents have the same sections, keys, and values,
+ in the same order.
+ @param sameLines True to also compare the lines of sections and keys.
+ */
+bool SameDocuments( const ::Parser::ConfigDocument & left,
+    const ::Parser::ConfigDocument & right, bool sameLines );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
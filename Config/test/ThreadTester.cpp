@@ -0,0 +1,551 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ThreadTester.cpp Runs ConfigParsers on several threads at once.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ThreadTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+    #include <process.h>
+#else
+    #include <pthread.h>
+#endif
+
+#include "../../Util/include/ErrorReceiver.hpp"
+#include "../../Util/include/ParserPool.hpp"
+#include "../include/ConfigParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+/// Inputs cover global keys, sections, comments, quotes, and syntax errors so
+/// every kind of action and message is used while other threads are parsing.
+const char * const s_inputs[] =
+{
+    "globalkey = globalvalue\n"
+    "[Section1]\n"
+    "key1 = value1\n"
+    "key2\n"
+    "[Section2] ; comment\n"
+    "key3 = value3 # comment\n",
+
+    "/* block\n comment */ global1 = 1\n"
+    "global2 =\n"
+    "[ Section-A ]\n"
+    "key.a = \"quoted ; value\"\n"
+    "[Section_B]\n"
+    "key_b = value b\n",
+
+    "[Section1\n"
+    "key1 = value1\n"
+    "[Section2]\n"
+    "key2 = value2\n",
+
+    "[Section1]\n"
+    "= novalue\n"
+    "key1 = value1 /* open comment\n"
+    "[Section2]\n",
+
+    "\t[\tSection1\t]\t\n"
+    "\tkey1\t=\tvalue1\t\n"
+    "[Section1]\n"
+    "key1 = again\n",
+};
+
+const unsigned int s_inputCount = sizeof( s_inputs ) / sizeof( s_inputs[ 0 ] );
+
+/// Each thread uses one of these, so parsers with different rules run together.
+const unsigned int s_policyCount = 2;
+
+// ----------------------------------------------------------------------------
+
+ConfigParser::ParserPolicy MakePolicy( unsigned int which )
+{
+    ConfigParser::ParserPolicy policy;
+    if ( 0 == which )
+        policy.LineComment = ";";
+    else
+        policy.LineComment = "#";
+    policy.BlockCommentStarter = "/*";
+    policy.BlockCommentEnder = "*/";
+    policy.SectionNameStarter = "[";
+    policy.SectionNameEnder = "]";
+    policy.AssignOperator = "=";
+    policy.TrimWhiteSpace = true;
+    policy.AlphaNumericNames = ( 0 == which );
+    policy.AllowQuotedCommentInValue = ( 0 != which );
+    policy.MaxErrorCount = 3;
+    return policy;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Writes every call from a parser into a string so two parses can be compared.
+class Recorder : public IConfigReceiver, public IParseErrorReceiver
+{
+public:
+
+    Recorder( void ) : IConfigReceiver(), IParseErrorReceiver(), m_record() {}
+
+    virtual ~Recorder( void ) {}
+
+    inline void Clear( void ) { m_record.clear(); }
+
+    inline const string & GetRecord( void ) const { return m_record; }
+
+    void AddResult( ConfigParser::ParseResults result );
+
+    virtual bool AddGlobalKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual bool AddSection( const char * nameStart, const char * nameEnd );
+
+    virtual bool AddSectionKey( const char * keyStart, const char * keyEnd,
+        const char * valueStart, const char * valueEnd );
+
+    virtual void ParsedConfigFile( bool valid );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message, unsigned long line );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message, const char * filename, unsigned long line );
+
+private:
+
+    Recorder( const Recorder & );
+    Recorder & operator = ( const Recorder & );
+
+    void AddNumber( unsigned long number );
+
+    string m_record;
+};
+
+// ----------------------------------------------------------------------------
+
+void Recorder::AddNumber( unsigned long number )
+{
+    assert( NULL != this );
+    char buffer[ 24 ];
+    ::sprintf( buffer, "%lu", number );
+    m_record.append( buffer );
+}
+
+// ----------------------------------------------------------------------------
+
+void Recorder::AddResult( ConfigParser::ParseResults result )
+{
+    assert( NULL != this );
+    m_record.append( "Result: " );
+    m_record.append( ConfigParser::Name( result ) );
+    m_record.append( "\n" );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::AddGlobalKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    m_record.append( "Global: " );
+    m_record.append( keyStart, keyEnd );
+    m_record.append( " = " );
+    m_record.append( valueStart, valueEnd );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::AddSection( const char * nameStart, const char * nameEnd )
+{
+    assert( NULL != this );
+    m_record.append( "Section: " );
+    m_record.append( nameStart, nameEnd );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::AddSectionKey( const char * keyStart, const char * keyEnd,
+    const char * valueStart, const char * valueEnd )
+{
+    assert( NULL != this );
+    m_record.append( "Key: " );
+    m_record.append( keyStart, keyEnd );
+    m_record.append( " = " );
+    m_record.append( valueStart, valueEnd );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void Recorder::ParsedConfigFile( bool valid )
+{
+    assert( NULL != this );
+    m_record.append( valid ? "Done: valid\n" : "Done: invalid\n" );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, unsigned long line )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " line " );
+    AddNumber( line );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, const char * filename, unsigned long line )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " " );
+    m_record.append( filename );
+    m_record.append( " line " );
+    AddNumber( line );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses one input and returns everything the parser gave the recorder.
+const string & ParseOnce( ConfigParser & parser, Recorder & recorder,
+    unsigned int input )
+{
+    const char * begin = s_inputs[ input ];
+    const char * end = begin + ::strlen( begin );
+    recorder.Clear();
+    ConfigParser::ParseResults result = ConfigParser::Exception;
+    try
+    {
+        result = parser.Parse( begin, end, &recorder );
+    }
+    catch ( ... )
+    {
+    }
+    recorder.AddResult( result );
+    return recorder.GetRecord();
+}
+
+// ----------------------------------------------------------------------------
+
+typedef ::Parser::ParserPool< ConfigParser > ConfigParserPool;
+
+// ----------------------------------------------------------------------------
+
+/// Gives each parser made by the pool the first policy.
+void SetupPooledParser( ConfigParser & parser )
+{
+    parser.SetPolicy( MakePolicy( 0 ) );
+}
+
+// ----------------------------------------------------------------------------
+
+/// What one thread needs to do its parsing, and what it found.
+struct ThreadInfo
+{
+    unsigned int m_index;
+    unsigned int m_repeatCount;
+    const vector< string > * m_expected;
+    /// Pool to lease parsers from, or NULL if thread makes its own parser.
+    ConfigParserPool * m_pool;
+    unsigned long m_matched;
+    unsigned long m_mismatched;
+};
+
+// ----------------------------------------------------------------------------
+
+void RunThread( ThreadInfo & info )
+{
+    const unsigned int policyIndex = info.m_index % s_policyCount;
+    const vector< string > & expected = info.m_expected[ policyIndex ];
+
+    ConfigParser parser;
+    Recorder recorder;
+    parser.SetPolicy( MakePolicy( policyIndex ) );
+    parser.SetMessageReceiver( &recorder );
+
+    for ( unsigned int ii = 0; ii < info.m_repeatCount; ++ii )
+    {
+        // Start each thread at a different input so threads rarely parse the
+        // same input at the same moment.
+        for ( unsigned int jj = 0; jj < s_inputCount; ++jj )
+        {
+            const unsigned int input = ( info.m_index + jj ) % s_inputCount;
+            if ( ParseOnce( parser, recorder, input ) == expected[ input ] )
+                ++info.m_matched;
+            else
+                ++info.m_mismatched;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void RunPoolThread( ThreadInfo & info )
+{
+    assert( NULL != info.m_pool );
+    const vector< string > & expected = info.m_expected[ 0 ];
+    Recorder recorder;
+
+    for ( unsigned int ii = 0; ii < info.m_repeatCount; ++ii )
+    {
+        for ( unsigned int jj = 0; jj < s_inputCount; ++jj )
+        {
+            const unsigned int input = ( info.m_index + jj ) % s_inputCount;
+            ConfigParserPool::Leased parser( *info.m_pool );
+            parser->SetMessageReceiver( &recorder );
+            if ( ParseOnce( *parser, recorder, input ) == expected[ input ] )
+                ++info.m_matched;
+            else
+                ++info.m_mismatched;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( _WIN32 )
+
+unsigned __stdcall ThreadMain( void * pInfo )
+{
+    ThreadInfo & info = *reinterpret_cast< ThreadInfo * >( pInfo );
+    if ( NULL == info.m_pool )
+        RunThread( info );
+    else
+        RunPoolThread( info );
+    return 0;
+}
+
+#else
+
+extern "C" void * ThreadMain( void * pInfo )
+{
+    ThreadInfo & info = *reinterpret_cast< ThreadInfo * >( pInfo );
+    if ( NULL == info.m_pool )
+        RunThread( info );
+    else
+        RunPoolThread( info );
+    return NULL;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+/// Finds what one parser produces for each input when nothing else runs.
+void FindExpected( vector< string > * expected )
+{
+    for ( unsigned int ii = 0; ii < s_policyCount; ++ii )
+    {
+        ConfigParser parser;
+        Recorder recorder;
+        parser.SetPolicy( MakePolicy( ii ) );
+        parser.SetMessageReceiver( &recorder );
+        expected[ ii ].reserve( s_inputCount );
+        for ( unsigned int jj = 0; jj < s_inputCount; ++jj )
+            expected[ ii ].push_back( ParseOnce( parser, recorder, jj ) );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+/// Runs one thread for each info, and waits for them all to finish.
+/// @return How many threads were started.
+unsigned int RunThreads( vector< ThreadInfo > & infos )
+{
+    const unsigned int threadCount = static_cast< unsigned int >( infos.size() );
+    unsigned int started = 0;
+#if defined( _WIN32 )
+    vector< HANDLE > threads( threadCount, NULL );
+    for ( ; started < threadCount; ++started )
+    {
+        threads[ started ] = reinterpret_cast< HANDLE >( ::_beginthreadex( NULL, 0,
+            &ThreadMain, &infos[ started ], 0, NULL ) );
+        if ( NULL == threads[ started ] )
+            break;
+    }
+    for ( unsigned int ii = 0; ii < started; ++ii )
+    {
+        ::WaitForSingleObject( threads[ ii ], INFINITE );
+        ::CloseHandle( threads[ ii ] );
+    }
+#else
+    vector< pthread_t > threads( threadCount );
+    for ( ; started < threadCount; ++started )
+    {
+        if ( 0 != ::pthread_create( &threads[ started ], NULL, &ThreadMain,
+            &infos[ started ] ) )
+            break;
+    }
+    for ( unsigned int ii = 0; ii < started; ++ii )
+        ::pthread_join( threads[ ii ], NULL );
+#endif
+    return started;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Adds up what the threads found, and shows it if asked or if any failed.
+bool CheckThreads( const vector< ThreadInfo > & infos, unsigned int started,
+    bool showSummary )
+{
+    const unsigned int threadCount = static_cast< unsigned int >( infos.size() );
+    unsigned long matched = 0;
+    unsigned long mismatched = 0;
+    for ( unsigned int ii = 0; ii < started; ++ii )
+    {
+        matched += infos[ ii ].m_matched;
+        mismatched += infos[ ii ].m_mismatched;
+    }
+
+    const bool passed = ( started == threadCount ) && ( 0 == mismatched );
+    if ( showSummary || !passed )
+    {
+        cout << "Threads: [" << started << "] of [" << threadCount << "]\t"
+            << "Matched: [" << matched << "]\tMismatched: [" << mismatched << "]\n";
+    }
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+void InitInfos( vector< ThreadInfo > & infos, unsigned int repeatCount,
+    const vector< string > * expected, ConfigParserPool * pool )
+{
+    for ( unsigned int ii = 0; ii < infos.size(); ++ii )
+    {
+        ThreadInfo & info = infos[ ii ];
+        info.m_index = ii;
+        info.m_repeatCount = repeatCount;
+        info.m_expected = expected;
+        info.m_pool = pool;
+        info.m_matched = 0;
+        info.m_mismatched = 0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoThreadTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary )
+{
+
+    vector< string > expected[ s_policyCount ];
+    FindExpected( expected );
+
+    vector< ThreadInfo > infos( threadCount );
+    InitInfos( infos, repeatCount, expected, NULL );
+    const unsigned int started = RunThreads( infos );
+    return CheckThreads( infos, started, showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DoPoolTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary )
+{
+
+    vector< string > expected[ s_policyCount ];
+    FindExpected( expected );
+
+    const unsigned long maxCount = ( threadCount + 1 ) / 2;
+    ConfigParserPool pool( maxCount, &SetupPooledParser );
+    vector< ThreadInfo > infos( threadCount );
+    InitInfos( infos, repeatCount, expected, &pool );
+    const unsigned int started = RunThreads( infos );
+    bool passed = CheckThreads( infos, started, showSummary );
+
+    const ::Parser::ParserPoolStats stats = pool.GetStats();
+    const unsigned long leaseCount = started * repeatCount * s_inputCount;
+    const bool countsOkay = ( stats.m_leases == leaseCount )
+        && ( stats.m_hits + stats.m_misses == stats.m_leases )
+        && ( stats.m_threadHits <= stats.m_hits )
+        && ( stats.m_misses <= maxCount )
+        && ( stats.m_mostLeased <= maxCount )
+        && ( 0 == pool.GetLeasedCount() )
+        && ( pool.GetIdleCount() == stats.m_misses );
+    if ( !countsOkay )
+        passed = false;
+    if ( showSummary || !countsOkay )
+    {
+        cout << "Pool Leases: [" << stats.m_leases << "]\tHits: ["
+            << stats.m_hits << "]\tThread Hits: [" << stats.m_threadHits
+            << "]\tMisses: [" << stats.m_misses << "]\tWaits: ["
+            << stats.m_waits << "]\tWait Time: [" << stats.m_waitTime
+            << "]\n";
+    }
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ThreadTester.hpp Checks that ConfigParsers on separate threads do not
+///  interfere with each other.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_THREAD_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_THREAD_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses the same inputs with several threads at once, each thread using its
+ own ConfigParser with its own policy.  Each thread records every call made to
+ its receivers, and compares that against what a lone parser produced for the
+ same input before any threads started.  Any difference means one parser saw
+ the state of another.
+ @param threadCount How many threads to run at once.
+ @param repeatCount How many times each thread parses every input.
+ @param showSummary True to show how many parses matched.
+ @return True if every parse on every thread matched.
+ */
+bool DoThreadTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary );
+
+/** Parses the same inputs with several threads at once, each thread leasing a
+ ConfigParser from one ParserPool for every parse.  The pool holds fewer
+ parsers than there are threads, so threads must wait for each other.  Records
+ are checked as in DoThreadTests, and the pool's counters are checked too.
+ @param threadCount How many threads to run at once.
+ @param repeatCount How many times each thread parses every input.
+ @param showSummary True to show how many parses matched, and pool counters.
+ @return True if every parse matched and the counters add up.
+ */
+bool DoPoolTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,255 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file WatcherTester.cpp Tests ConfigWatcher.
+
+
+// ----------------------------------------------------------------------------
+
+#include "WatcherTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/ConfigDocument.hpp"
+#include "../include/ConfigWatcher.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+
+namespace
+{
+
+const char s_watchedFile[] = "WatcherTest.cfg";
+
+const char s_first[] =
+    "Global1 = One\n"
+    "[Colors]\n"
+    "Red = FF0000\n"
+    "Green = 00FF00\n"
+    "[Sizes]\n"
+    "Small = 1\n";
+
+/// Changes Red, removes Green and Sizes, and adds Blue and Shapes.
+const char s_second[] =
+    "Global1 = One\n"
+    "[Colors]\n"
+    "Red = Crimson\n"
+    "Blue = 0000FF\n"
+    "[Shapes]\n"
+    "Round = Circle\n";
+
+const char s_broken[] =
+    "[Colors\n"
+    "Red = FF0000\n";
+
+// ----------------------------------------------------------------------------
+
+/// Writes each change as one line of text, and keeps the last reload info.
+class ChangeRecorder : public IConfigChangeReceiver
+{
+public:
+
+    ChangeRecorder( void ) : IConfigChangeReceiver(), m_changes(), m_reloads( 0 )
+    {
+        ::memset( &m_info, 0, sizeof( m_info ) );
+    }
+
+    virtual ~ChangeRecorder( void ) {}
+
+    virtual void ChangedConfig( const char *, Changes change, const char * section,
+        const char * key, const char * oldValue, const char * newValue )
+    {
+        static const char * const names[] =
+            { "SectionAdded", "SectionRemoved", "KeyAdded", "KeyRemoved", "KeyChanged" };
+        string line( names[ change ] );
+        line += ' ';
+        line += section;
+        if ( NULL != key )
+        {
+            line += '.';
+            line += key;
+        }
+        if ( NULL != oldValue )
+        {
+            line += ' ';
+            line += oldValue;
+        }
+        if ( NULL != newValue )
+        {
+            line += ' ';
+            line += newValue;
+        }
+        m_changes.push_back( line );
+    }
+
+    virtual void ReloadedConfigFile( const char *, const ConfigReloadInfo & info )
+    {
+        ++m_reloads;
+        m_info = info;
+    }
+
+    vector< string > m_changes;
+    unsigned long m_reloads;
+    ConfigReloadInfo m_info;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of recorded changes to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "Config Watcher" ) {}
+
+    /// Checks recorded changes match expected lines, then forgets them.
+    void CheckChanges( ChangeRecorder & recorder, const char * const * expected,
+        const char * what )
+    {
+        bool same = true;
+        unsigned long count = 0;
+        for ( ; NULL != expected[ count ]; ++count )
+        {
+            if ( ( recorder.m_changes.size() <= count )
+              || ( recorder.m_changes[ count ] != expected[ count ] ) )
+                same = false;
+        }
+        if ( recorder.m_changes.size() != count )
+            same = false;
+        if ( !same )
+        {
+            for ( unsigned long ii = 0; ii < recorder.m_changes.size(); ++ii )
+                cout << "Change: [" << recorder.m_changes[ ii ] << "]\n";
+        }
+        Check( same, what );
+        recorder.m_changes.clear();
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+/// Polls until a reload happens, or about a second passes.
+void PollForReload( ConfigWatcher & watcher, ChangeRecorder & recorder )
+{
+    const unsigned long reloads = recorder.m_reloads;
+    for ( unsigned long ii = 0; ( ii < 10 ) && ( reloads == recorder.m_reloads ); ++ii )
+        watcher.Poll( 100 );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckWatcher( Checker & checker, ConfigParser & parser )
+{
+    if ( !WriteTestFile( s_watchedFile, s_first ) )
+    {
+        checker.Check( false, "write first file" );
+        return;
+    }
+
+    ChangeRecorder recorder;
+    ConfigWatcher watcher( parser, &recorder );
+    checker.Check( watcher.AddFile( s_watchedFile ), "add" );
+    checker.Check( !watcher.AddFile( s_watchedFile ), "add twice" );
+    const char * const added[] =
+    {
+        "KeyAdded .Global1 One",
+        "SectionAdded Colors",
+        "KeyAdded Colors.Red FF0000",
+        "KeyAdded Colors.Green 00FF00",
+        "SectionAdded Sizes",
+        "KeyAdded Sizes.Small 1",
+        NULL
+    };
+    checker.CheckChanges( recorder, added, "first load" );
+    checker.Check( ( ConfigParser::AllValid == recorder.m_info.m_result )
+        && ( 6 == recorder.m_info.m_changes ), "first info" );
+    const ConfigDocument * document = watcher.GetDocument( s_watchedFile );
+    checker.Check( ( NULL != document ) && ( NULL != document->Get( "Sizes", "Small" ) ),
+        "document" );
+
+    // Same bytes are read again but not parsed.
+    checker.Check( WriteTestFile( s_watchedFile, s_first ), "write same file" );
+    watcher.Poll( 100 );
+    checker.Check( 0 == watcher.ReloadAll(), "same reload" );
+    checker.Check( 1 == recorder.m_reloads, "same not parsed" );
+    checker.Check( 0 != watcher.GetStats().m_unchanged, "same counted" );
+
+    checker.Check( WriteTestFile( s_watchedFile, s_second ), "write second file" );
+    if ( watcher.IsNotified() )
+        PollForReload( watcher, recorder );
+    else
+        watcher.ReloadAll();
+    const char * const changed[] =
+    {
+        "KeyRemoved Colors.Green 00FF00",
+        "KeyRemoved Sizes.Small 1",
+        "SectionRemoved Sizes",
+        "KeyChanged Colors.Red FF0000 Crimson",
+        "KeyAdded Colors.Blue 0000FF",
+        "SectionAdded Shapes",
+        "KeyAdded Shapes.Round Circle",
+        NULL
+    };
+    checker.CheckChanges( recorder, changed, "second load" );
+    checker.Check( 2 == recorder.m_reloads, "second reloaded" );
+    document = watcher.GetDocument( s_watchedFile );
+    checker.Check( ( NULL != document ) && ( NULL == document->Get( "Sizes", "Small" ) )
+        && ( NULL != document->Get( "Shapes", "Round" ) ), "second document" );
+
+    // Contents which are not valid are reported, but change nothing.
+    checker.Check( WriteTestFile( s_watchedFile, s_broken ), "write broken file" );
+    watcher.ReloadAll();
+    checker.Check( ( 3 == recorder.m_reloads ) && recorder.m_changes.empty()
+        && ( ConfigParser::AllValid != recorder.m_info.m_result ), "broken ignored" );
+    checker.Check( NULL != watcher.GetDocument( s_watchedFile )->Get( "Colors", "Blue" ),
+        "broken kept" );
+
+    checker.Check( watcher.RemoveFile( s_watchedFile ), "remove" );
+    checker.Check( !watcher.RemoveFile( s_watchedFile ), "remove twice" );
+    checker.Check( ( 0 == watcher.GetFileCount() )
+        && ( NULL == watcher.GetDocument( s_watchedFile ) ), "removed" );
+    ::remove( s_watchedFile );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoWatcherTests( bool showSummary )
+{
+    QuietReceiver quiet;
+    ConfigParser parser;
+    parser.SetMessageReceiver( &quiet );
+
+    Checker checker;
+    CheckWatcher( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
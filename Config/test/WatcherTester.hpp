@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file WatcherTester.hpp Checks that ConfigWatcher gives only what changed.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_CONFIG_WATCHER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_CONFIG_WATCHER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Rewrites a scratch config file while a ConfigWatcher watches it, and checks
+ that each reload gives the expected changes, that unchanged bytes are not
+ parsed, and that contents which are not valid are ignored.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoWatcherTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
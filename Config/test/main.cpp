@@ -28,7 +28,19 @@
 #include "../../Util/include/ParseUtil.hpp"
 #include "../include/ConfigParser.hpp"
 
+#include "BatchTester.hpp"
 #include "ConfigTester.hpp"
+#include "DelimiterTester.hpp"
+#include "DocumentTester.hpp"
+#include "EventTester.hpp"
+#include "FileBufferTester.hpp"
+#include "FinderTester.hpp"
+#include "MessageTester.hpp"
+#include "ProfileTester.hpp"
+#include "SnapshotTester.hpp"
+#include "SplitTester.hpp"
+#include "ThreadTester.hpp"
+#include "WatcherTester.hpp"
 
 
 // ----------------------------------------------------------------------------
@@ -438,7 +450,35 @@ int main( int argc, const char * argv[] )
     bool passed = false;
 
     if ( doUnitTest )
+    {
         passed = DoUnitTests( tester, parser );
+        if ( !DoThreadTests( 8, 2000, showSummary ) )
+            passed = false;
+        if ( !DoPoolTests( 8, 500, showSummary ) )
+            passed = false;
+        if ( !DoFinderTests( showSummary ) )
+            passed = false;
+        if ( !DoFileBufferTests( showSummary ) )
+            passed = false;
+        if ( !DoProfileTests( showSummary ) )
+            passed = false;
+        if ( !DoDelimiterTests( showSummary ) )
+            passed = false;
+        if ( !DoMessageTests( showSummary ) )
+            passed = false;
+        if ( !DoDocumentTests( showSummary ) )
+            passed = false;
+        if ( !DoSnapshotTests( showSummary ) )
+            passed = false;
+        if ( !DoWatcherTests( showSummary ) )
+            passed = false;
+        if ( !DoBatchTests( 8, showSummary ) )
+            passed = false;
+        if ( !DoSplitTests( 4, showSummary ) )
+            passed = false;
+        if ( !DoEventTests( showSummary ) )
+            passed = false;
+    }
 
     if ( doFileTest )
         passed = DoFileTests( tester, parser, filename, showSummary );
@@ -0,0 +1,175 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file BatchRunner.hpp Defines classes which run many parse jobs on many threads.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_BATCH_RUNNER_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_BATCH_RUNNER_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <string>
+
+#include <UtilParsers/Util/include/ErrorReceiver.hpp>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/// Counters from the last run of a BatchRunner.
+struct BatchStats
+{
+    /// Threads which ran jobs, including the calling thread.
+    unsigned long m_threads;
+    /// Jobs run.
+    unsigned long m_jobs;
+    /// Times a thread took jobs from another thread's share.
+    unsigned long m_steals;
+    /// Jobs which threw an exception.
+    unsigned long m_exceptions;
+    /// Time from start to end of run, in microseconds.
+    unsigned long m_time;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class BatchRunner
+ Runs a number of jobs across some threads.  Each thread starts with an equal
+ share of the jobs, in order, and when its share runs out it takes the back
+ half of the largest share left, so threads stay busy even when jobs take very
+ different times.  Each thread makes one worker before its first job and
+ destroys it after its last, so a worker can hold a parser which never needs a
+ lock.  The calling thread runs jobs too, and runs all of them when only one
+ thread is wanted or no thread can be started.
+
+ Derived classes say what a worker is and what a job does.  Each job should
+ write its results to a place only that job uses, such as a slot in an array
+ indexed by job number, so results come out in job order.
+ */
+class BatchRunner
+{
+public:
+
+    /// Returns how many processors the system has, or 1 if it cannot tell.
+    static unsigned long GetProcessorCount( void );
+
+    /// Returns most threads a run will use.
+    unsigned long GetThreadCount( void ) const;
+
+    /// Sets most threads a run will use, or zero to use one per processor.
+    void SetThreadCount( unsigned long threadCount );
+
+    /// Returns counters from the last run.
+    BatchStats GetStats( void ) const;
+
+protected:
+
+    /// @param threadCount Most threads to use, or zero for one per processor.
+    explicit BatchRunner( unsigned long threadCount );
+
+    virtual ~BatchRunner( void );
+
+    /** Runs jobs numbered 0 through jobCount - 1, and returns once all are
+     done.  A job which throws is counted, and the thread goes on to its next.
+     Not thread safe, so only one run may happen at a time.
+     */
+    void RunJobs( unsigned long jobCount );
+
+    /// Makes a worker for one thread.  Called on that thread.
+    virtual void * MakeWorker( void ) = 0;
+
+    /// Runs one job with the worker of the calling thread.
+    virtual void RunJob( void * worker, unsigned long job ) = 0;
+
+    /// Destroys a worker made by MakeWorker.
+    virtual void DestroyWorker( void * worker ) = 0;
+
+private:
+
+    /// Not implemented.
+    BatchRunner( void );
+    /// Not implemented.
+    BatchRunner( const BatchRunner & );
+    /// Not implemented.
+    BatchRunner & operator = ( const BatchRunner & );
+
+    class Impl;
+    friend class Impl;
+
+    /// Shares, locks, and counters, which need platform headers.
+    Impl * m_impl;
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class MessageCollector
+ Adds the text of each message to a string, one line per message, so each job
+ of a batch can keep its own messages.  Set the target before each job.
+ */
+class MessageCollector : public IParseErrorReceiver
+{
+public:
+
+    MessageCollector( void ) : IParseErrorReceiver(), m_text( NULL ), m_count( NULL ) {}
+
+    virtual ~MessageCollector( void ) {}
+
+    /// Sets where to add text and count messages.  Either may be NULL.
+    inline void SetTarget( ::std::string * text, unsigned long * count )
+    {
+        m_text = text;
+        m_count = count;
+    }
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message,
+        unsigned long line );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level, const CharType * message,
+        const char * filename, unsigned long line );
+
+private:
+
+    /// Not implemented.
+    MessageCollector( const MessageCollector & );
+    /// Not implemented.
+    MessageCollector & operator = ( const MessageCollector & );
+
+    ::std::string * m_text;
+    unsigned long * m_count;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file CharFinder.hpp Defines classes which find delimiters in long runs of text.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_CHAR_FINDER_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_CHAR_FINDER_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <stddef.h>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/** @class CharFinder
+ Finds the next char which a grammar must look at more closely, such as a
+ quote, a '-' within a comment, or an unprintable char, and skips over all the
+ chars between without looking at them one at a time.  Where the processor has
+ them, SSE2 or AVX2 instructions compare 16 or 32 chars at once.  The kernel
+ used is chosen when the program starts, from the best one this processor can
+ run, and falls back to a table lookup for each char.
+ */
+class CharFinder
+{
+public:
+
+    /// Ways to search for chars.  All find the same chars.
+    enum Kernel
+    {
+        Scalar = 0, ///< Looks up each char in a table.
+        Sse2,       ///< Compares 16 chars at once.
+        Avx2        ///< Compares 32 chars at once.
+    };
+
+    /// Most chars one CharFinder can find, besides unprintable chars.
+    enum { MaxChars = 4 };
+
+    /// Returns the kernel all CharFinders use now.
+    static Kernel GetKernel( void );
+
+    /// Returns true if this build and this processor can use the kernel.
+    static bool CanUseKernel( Kernel kernel );
+
+    /** Chooses the kernel all CharFinders use.  Call this before any parsing
+     starts, since it is not safe to change kernels while other threads parse.
+     @return False if this processor can not use that kernel, so the kernel
+      did not change.
+     */
+    static bool SetKernel( Kernel kernel );
+
+    /** Makes a finder for some chars.
+     @param chars Nil-terminated list of up to MaxChars chars to find.
+     @param findUnprintable True to also find every char outside ' ' through
+      '~', which is what print_p does not match.
+     */
+    CharFinder( const char * chars, bool findUnprintable );
+
+    /// Makes a finder for unprintable chars only, or for nothing at all.
+    explicit CharFinder( bool findUnprintable );
+
+    /// Adds one more char to find.  Returns false if the finder is full.
+    bool AddChar( char ch );
+
+    /// Returns true if this finds the char.
+    inline bool IsWanted( char ch ) const
+    {
+        return ( 0 != m_table[ static_cast< unsigned char >( ch ) ] );
+    }
+
+    /// Returns the first char in range which this finds, or end if none.
+    const char * Find( const char * begin, const char * end ) const;
+
+private:
+
+    /// Not implemented.
+    CharFinder( void );
+
+    static const char * FindScalar( const CharFinder & finder,
+        const char * begin, const char * end );
+    static const char * FindSse2( const CharFinder & finder,
+        const char * begin, const char * end );
+    static const char * FindAvx2( const CharFinder & finder,
+        const char * begin, const char * end );
+
+    /// Chars to find.  Unused places repeat the first char.
+    char m_chars[ MaxChars ];
+    unsigned int m_count;
+    bool m_findUnprintable;
+    /// Nonzero for each char this finds.
+    unsigned char m_table[ 256 ];
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class RunFinder
+ Finds where a run of text ends, just as *( print_p - ( str_p( a ) | str_p( b )
+ | str_p( c ) ) ) would, or the same with anychar_p in place of print_p.  A
+ CharFinder skips to the first char of each stop string, and only there does
+ this check whether a whole stop string is in the text.
+ */
+class RunFinder
+{
+public:
+
+    /** Makes a finder for runs of text.
+     @param printableOnly True if the run has only chars ' ' through '~', like
+      print_p, or false if it may have any char, like anychar_p.
+     @param stop1 First string which ends the run, or NULL for none.
+     @param stop2 Second string which ends the run, or NULL for none.
+     @param stop3 Third string which ends the run, or NULL for none.
+     */
+    RunFinder( bool printableOnly, const char * stop1,
+        const char * stop2 = NULL, const char * stop3 = NULL );
+
+    /// Returns the end of the run which starts at begin.  Never fails.
+    const char * Find( const char * begin, const char * end ) const;
+
+private:
+
+    /// Not implemented.
+    RunFinder( void );
+
+    void AddStop( const char * stop );
+
+    CharFinder m_finder;
+    const char * m_stops[ 3 ];
+    unsigned int m_stopCount;
+    bool m_printableOnly;
+    /// True once an empty stop string was given.  Spirit matches the empty
+    /// string at once, so it ends no run and hides any stop strings after it.
+    bool m_sawEmpty;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -54,6 +54,101 @@ public:
 };
 
 
+// ----------------------------------------------------------------------------
+
+/** @class MessageBuffer
+ Builds the text of a message in a fixed array, so making a message never
+ allocates memory.  Text which does not fit is cut short and ends with "...".
+ */
+class MessageBuffer
+{
+public:
+
+    /// Most chars in the buffer, including the nil at the end.
+    enum { Capacity = 512 };
+
+    inline MessageBuffer( void ) : m_length( 0 ), m_cut( false )
+    {
+        m_text[ 0 ] = '\0';
+    }
+
+    /// Adds nil-terminated text.
+    void Append( const CharType * text );
+
+    /// Adds chars from first up to but not including last.
+    void Append( const CharType * first, const CharType * last );
+
+    void Append( unsigned long number );
+
+    /// Returns nil-terminated text.
+    inline const CharType * GetText( void ) const { return m_text; }
+
+    inline unsigned long GetLength( void ) const { return m_length; }
+
+    /// Returns true if some text did not fit.
+    inline bool IsCut( void ) const { return m_cut; }
+
+private:
+
+    /// Not implemented.
+    MessageBuffer( const MessageBuffer & );
+    /// Not implemented.
+    MessageBuffer & operator = ( const MessageBuffer & );
+
+    CharType m_text[ Capacity ];
+    unsigned long m_length;
+    bool m_cut;
+};
+
+
+// ----------------------------------------------------------------------------
+
+/** @struct ParseMessage
+ Fields of one message from a parser, given to a receiver before any text is
+ made.  The pointers refer to the parser's own data and are only good until
+ the receiver returns.
+ */
+struct ParseMessage
+{
+    /// What kind of message this is, and so which fields are used.
+    enum Codes
+    {
+        Message = 0, ///< m_text is a nil-terminated message from the parser.
+        Content,     ///< m_text up to m_textEnd is a piece of the parsed data.
+        Location     ///< Section, and maybe name, line, and column, where parser is.
+    };
+
+    ErrorLevel::Levels m_level;
+    Codes m_code;
+    /// Message, or start of content.  NULL for Location.
+    const CharType * m_text;
+    /// Place after content.  NULL unless m_code is Content.
+    const CharType * m_textEnd;
+    /// Name of section.  NULL unless m_code is Location.
+    const CharType * m_section;
+    /// Name of item inside section, or NULL.
+    const CharType * m_name;
+    /// Line number, or zero if not known.
+    unsigned long m_line;
+    /// Char number within line, or zero if not known.
+    unsigned long m_column;
+
+    /// Makes a Message.  A parser may then set m_line and m_column.
+    ParseMessage( ErrorLevel::Levels level, const CharType * message );
+
+    /// Makes Content.
+    ParseMessage( ErrorLevel::Levels level, const CharType * first,
+        const CharType * last );
+
+    /// Makes a Location at the Content level.
+    ParseMessage( const CharType * section, const CharType * name,
+        unsigned long line, unsigned long column );
+
+    /// Adds the text a receiver would show to the buffer.
+    void Format( MessageBuffer & buffer ) const;
+};
+
+
 // ----------------------------------------------------------------------------
 
 class IParseErrorReceiver
@@ -66,6 +161,13 @@ protected:
 
 public:
 
+    /** Parsers call this for every message.  It makes the text in a buffer on
+     the stack and gives it to GiveParseMessage.  A receiver which only counts
+     or sorts messages may override this, and then no text is ever made.
+     @return True to keep receiving messages, false to stop.
+     */
+    virtual bool ReceiveParseMessage( const ParseMessage & message );
+
     virtual bool GiveParseMessage( ::Parser::ErrorLevel::Levels level,
         const CharType * message ) = 0;
 
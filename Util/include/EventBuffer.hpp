@@ -0,0 +1,213 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventBuffer.hpp Defines a buffer which hands parse events over in batches.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_EVENT_BUFFER_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_EVENT_BUFFER_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/// One event from a parse.  The view points into the parsed chars.
+struct ParseEvent
+{
+    /// Kind of event, as defined by the receiver which made it.
+    unsigned short m_kind;
+    /// Bits whose meaning depends on the kind of event.
+    unsigned short m_flags;
+    const char * m_begin;
+    const char * m_end;
+};
+
+// ----------------------------------------------------------------------------
+
+class IEventBatchReceiver
+{
+public:
+
+    /** Called with each full batch, and with any events left when the buffer
+     is flushed.  The events stay untouched until ReuseEvents is called for
+     them, so they may be handed to another thread.
+     @return True to keep receiving events, false to stop.
+     */
+    virtual bool TakeEvents( const ParseEvent * events, unsigned long count ) = 0;
+
+    /** Called before a buffer writes over events it gave to TakeEvents, once
+     for each batch.  A receiver which handed the batch to another thread
+     should wait here until that thread is done with it.
+     */
+    virtual void ReuseEvents( const ParseEvent * events, unsigned long count );
+
+protected:
+
+    /// Trivially implemented.
+    inline IEventBatchReceiver( void ) {}
+
+    /// Trivially implemented.
+    inline virtual ~IEventBatchReceiver( void ) {}
+
+private:
+
+    /// Not implemented.
+    IEventBatchReceiver( const IEventBatchReceiver & );
+    /// Not implemented.
+    IEventBatchReceiver & operator = ( const IEventBatchReceiver & );
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class EventBuffer
+ Stores events in an array given by the caller, and gives them to a receiver a
+ batch at a time, so the receiver makes one call for many events and may walk
+ them in a tight loop.  The array is used as a ring of batches: once a batch
+ is full it goes to the receiver, and the next events go into the batch after
+ it, going back to the start of the array after the last batch.  A batch is
+ only written over after the receiver says it may be, so a receiver which
+ hands batches to another thread lets the parser fill the other batches while
+ that thread works.  Add never allocates memory.
+ ConfigParser and Xml::XmlParser each have a Parse function which takes a
+ buffer, and their rules call Add themselves, with no receiver call for each
+ part they find.  ConfigEventBatcher and Xml::XmlEventBatcher also add events
+ for parsers which only take a receiver.
+ */
+class EventBuffer
+{
+public:
+
+    /** @param events Array which holds events.  Must outlive the buffer.
+     @param capacity Number of events in array.
+     @param batchSize Most events in each batch.  The array holds as many
+      whole batches as fit, and at least one.
+     @param receiver Gets each batch.
+     */
+    EventBuffer( ParseEvent * events, unsigned long capacity,
+        unsigned long batchSize, IEventBatchReceiver * receiver );
+
+    ~EventBuffer( void );
+
+    /** Adds one event.  Gives the batch to the receiver if this fills it.
+     @return False if the receiver said to stop, in which case no more events
+      are added until Reset.
+     */
+    inline bool Add( unsigned short kind, unsigned short flags,
+        const char * begin, const char * end )
+    {
+        if ( m_stopped )
+            return false;
+        ParseEvent & event = m_events[ m_next ];
+        event.m_kind = kind;
+        event.m_flags = flags;
+        event.m_begin = begin;
+        event.m_end = end;
+        ++m_next;
+        if ( m_next - m_batchBegin < m_batchSize )
+            return true;
+        return SendBatch();
+    }
+
+    /** Adds two events to the same batch, sending the current batch early if
+     only one event would fit in it.  Use for events which mean nothing apart,
+     such as a key and its value.
+     */
+    inline bool AddPair( unsigned short kind1, unsigned short flags1,
+        const char * begin1, const char * end1, unsigned short kind2,
+        unsigned short flags2, const char * begin2, const char * end2 )
+    {
+        if ( ( m_next - m_batchBegin + 1 == m_batchSize ) && ( 1 < m_batchSize ) )
+        {
+            if ( !SendBatch() )
+                return false;
+        }
+        return Add( kind1, flags1, begin1, end1 )
+            && Add( kind2, flags2, begin2, end2 );
+    }
+
+    /** Gives any events not sent yet to the receiver as a short batch, and
+     then waits until the receiver is done with every batch.
+     @return False if the receiver said to stop.
+     */
+    bool Flush( void );
+
+    /// Forgets all events, and lets events be added again after a stop.
+    void Reset( void );
+
+    /// Returns true if the receiver said to stop.
+    inline bool IsStopped( void ) const { return m_stopped; }
+
+    /// Returns number of events added since construction or Reset.
+    inline unsigned long GetEventCount( void ) const
+    {
+        return m_sentEvents + ( m_next - m_batchBegin );
+    }
+
+    /// Returns number of batches given to the receiver since construction or Reset.
+    inline unsigned long GetBatchCount( void ) const { return m_batchCount; }
+
+private:
+
+    /// Not implemented.
+    EventBuffer( void );
+    /// Not implemented.
+    EventBuffer( const EventBuffer & );
+    /// Not implemented.
+    EventBuffer & operator = ( const EventBuffer & );
+
+    /// Gives current batch to receiver, and moves to the next batch in the ring.
+    bool SendBatch( void );
+
+    ParseEvent * m_events;
+    unsigned long m_batchSize;
+    /// Number of batches which fit in the array.
+    unsigned long m_batches;
+    IEventBatchReceiver * m_receiver;
+    /// Index of first event of current batch.
+    unsigned long m_batchBegin;
+    /// Index where next event goes.
+    unsigned long m_next;
+    /// Size of each batch given to the receiver and not reused yet, by index of
+    /// the batch in the ring.  Zero if the batch is not held by the receiver.
+    ::std::vector< unsigned long > m_held;
+    unsigned long m_sentEvents;
+    unsigned long m_batchCount;
+    bool m_stopped;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,116 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file FileBuffer.hpp Defines class which provides file contents to parsers.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_FILE_BUFFER_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_FILE_BUFFER_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <stddef.h>
+
+#include <UtilParsers/Util/include/TypeDefs.hpp>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/** @class FileBuffer
+ Provides the contents of a file as one contiguous read-only block so parsers
+ can consume it in place.  The file is memory-mapped when the platform allows
+ it, and otherwise read into a single buffer sized to the file.  Either way,
+ the contents are never copied or rewritten after loading.
+
+ The buffer always has a readable nil character just past the last byte of
+ the file, so *GetEnd() is '\0' and C string functions stop there.  Any nils
+ embedded within the file are left as is for the grammar to handle.
+ */
+class FileBuffer
+{
+public:
+
+    /// Constructs an empty buffer.  Call Open to load a file.
+    FileBuffer( void );
+
+    /// Releases the mapping or buffer if one is held.
+    ~FileBuffer( void );
+
+    /** Loads the contents of a file, releasing whatever was loaded before.
+     @param filename Path to file.
+     @return True if file was opened and loaded, false for any failure.  An
+      empty file is loaded successfully and has a size of zero.
+     */
+    bool Open( const char * filename );
+
+    /// Releases the mapping or buffer.  Safe to call when nothing is loaded.
+    void Close( void );
+
+    /// Returns true if a file was loaded.
+    inline bool IsOpen( void ) const { return ( NULL != m_begin ); }
+
+    /// Returns true if the file contents are memory-mapped rather than read.
+    inline bool IsMapped( void ) const { return m_mapped; }
+
+    /// Returns pointer to first byte of file contents.
+    inline const CharType * GetBegin( void ) const { return m_begin; }
+
+    /// Returns pointer to sentinel nil just past the file contents.
+    inline const CharType * GetEnd( void ) const { return m_begin + m_size; }
+
+    /// Returns number of bytes in file, excluding the sentinel.
+    inline unsigned long GetSize( void ) const { return m_size; }
+
+private:
+
+    /// Not implemented.
+    FileBuffer( const FileBuffer & );
+    /// Not implemented.
+    FileBuffer & operator = ( const FileBuffer & );
+
+    bool MapFile( const char * filename );
+
+    bool ReadFile( const char * filename );
+
+    /// Pointer to file contents, or NULL if nothing is loaded.
+    const CharType * m_begin;
+
+    /// Number of bytes in file.
+    unsigned long m_size;
+
+    /// True if m_begin points to a mapped view, false if it is allocated.
+    bool m_mapped;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,102 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file LineIndex.hpp Defines class which finds the line and column of a place.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_LINE_INDEX_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_LINE_INDEX_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <vector>
+
+#include <UtilParsers/Util/include/CharFinder.hpp>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/** @class LineIndex
+ Finds the line and column of any place in a text, so a parser need not count
+ lines while it parses.  Nothing is done until the first place is looked up.
+ Then a CharFinder skips from one newline to the next and stores where each
+ one is, but only as far as the furthest place looked up so far, and a binary
+ search over those finds the line of each place.  Memory is only allocated by
+ the first look up, and kept for the next text.
+ */
+class LineIndex
+{
+public:
+
+    LineIndex( void );
+
+    ~LineIndex( void );
+
+    /// Forgets newlines of the previous text.  Does not look at the new text.
+    void SetText( const char * begin, const char * end );
+
+    /// Returns true if place is within the text, or at its end.
+    inline bool Contains( const char * place ) const
+    {
+        return ( NULL != place ) && ( m_begin <= place ) && ( place <= m_end );
+    }
+
+    /** Finds where place is within the text.
+     @param line Line number of place, starting at 1.
+     @param column Char number of place within its line, starting at 1.
+     @return False if place is not within the text, so line and column were
+      not changed.
+     */
+    bool Find( const char * place, unsigned long & line, unsigned long & column );
+
+private:
+
+    /// Not implemented.
+    LineIndex( const LineIndex & );
+    /// Not implemented.
+    LineIndex & operator = ( const LineIndex & );
+
+    /// Stores places of newlines found before place.
+    void IndexUpTo( const char * place );
+
+    const char * m_begin;
+    const char * m_end;
+    /// Every newline before this place is stored.
+    const char * m_indexed;
+    /// Places of stored newlines, in order.
+    ::std::vector< const char * > m_newLines;
+    CharFinder m_finder;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -27,6 +27,7 @@
 // Included files.
 
 #include <string>
+#include <vector>
 
 #include <UtilParsers/Util/include/ErrorReceiver.hpp>
 #include <UtilParsers/Util/include/TypeDefs.hpp>
@@ -76,19 +77,22 @@ struct FBreakPoint
 
 // ----------------------------------------------------------------------------
 
+// The actions below call a function of the parser whose data is being parsed.
+// They hold no pointer to that parser.  Instead, ParserClass must provide a
+// static Current function which returns the parser for the parse running on
+// this thread.  This lets one set of rules serve every instance of ParserClass.
+
 template< class ParserClass >
 struct FClear
 {
-    explicit inline FClear( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType *, const Parser::CharType * ) const
     {
-        m_pParser->Clear();
+        ParserClass::Current().Clear();
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->Clear();
+        ParserClass::Current().Clear();
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -96,21 +100,19 @@ struct FClear
 template< class ParserClass >
 struct FSetValidSyntax
 {
-    inline FSetValidSyntax( ParserClass * pParser, bool valid ) :
-        m_pParser( pParser ), m_valid( valid ) {}
+    inline explicit FSetValidSyntax( bool valid ) : m_valid( valid ) {}
     inline FSetValidSyntax( const FSetValidSyntax & that ) :
-        m_pParser( that.m_pParser ), m_valid( that.m_valid ) {}
+        m_valid( that.m_valid ) {}
 
     inline void operator () ( const Parser::CharType *, const Parser::CharType * ) const
     {
-        m_pParser->SetValidSyntax( m_valid );
+        ParserClass::Current().SetValidSyntax( m_valid );
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->SetValidSyntax( m_valid );
+        ParserClass::Current().SetValidSyntax( m_valid );
     }
 
-    ParserClass * m_pParser;
     bool m_valid;
 };
 
@@ -119,19 +121,17 @@ struct FSetValidSyntax
 template< class ParserClass >
 struct FSetValidContent
 {
-    inline FSetValidContent( ParserClass * pParser, bool valid ) :
-        m_pParser( pParser ), m_valid( valid ) {}
+    inline explicit FSetValidContent( bool valid ) : m_valid( valid ) {}
 
     inline void operator () ( const Parser::CharType *, const Parser::CharType * ) const
     {
-        m_pParser->SetValidContent( m_valid );
+        ParserClass::Current().SetValidContent( m_valid );
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->SetValidContent( m_valid );
+        ParserClass::Current().SetValidContent( m_valid );
     }
 
-    ParserClass * m_pParser;
     bool m_valid;
 };
 
@@ -140,18 +140,15 @@ struct FSetValidContent
 template< class ParserClass >
 struct FSetContent
 {
-    inline explicit FSetContent( ParserClass * pParser ) :
-        m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType * begin,
         const Parser::CharType * end ) const
     {
-        m_pParser->SetContent( begin, end );
+        ParserClass::Current().SetContent( begin, end );
     }
     inline void operator () ( const Parser::CharType ch ) const
     {
-        m_pParser->SetContent( ch );
+        ParserClass::Current().SetContent( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -159,16 +156,14 @@ struct FSetContent
 template< class ParserClass >
 struct FDone
 {
-    explicit inline FDone( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType * begin, const Parser::CharType * end ) const
     {
-        m_pParser->Done( begin, end );
+        ParserClass::Current().Done( begin, end );
     }
     inline void operator () ( const Parser::CharType ch ) const
     {
-        m_pParser->Done( ch );
+        ParserClass::Current().Done( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -176,16 +171,14 @@ struct FDone
 template< class ParserClass >
 struct FEnd
 {
-    explicit inline FEnd( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType * , const Parser::CharType * ) const
     {
-        m_pParser->End();
+        ParserClass::Current().End();
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->End();
+        ParserClass::Current().End();
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -193,16 +186,14 @@ struct FEnd
 template< class ParserClass >
 struct FStoreStackSize
 {
-    explicit inline FStoreStackSize( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType *, const Parser::CharType * ) const
     {
-        m_pParser->StoreStackSize();
+        ParserClass::Current().StoreStackSize();
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->StoreStackSize();
+        ParserClass::Current().StoreStackSize();
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -210,16 +201,34 @@ struct FStoreStackSize
 template< class ParserClass >
 struct FCompareStackSize
 {
-    explicit inline FCompareStackSize( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType *, const Parser::CharType * ) const
     {
-        m_pParser->CompareStackSize();
+        ParserClass::Current().CompareStackSize();
     }
     inline void operator () ( const Parser::CharType ) const
     {
-        m_pParser->CompareStackSize();
+        ParserClass::Current().CompareStackSize();
     }
-    ParserClass * m_pParser;
+};
+
+// ----------------------------------------------------------------------------
+
+template< class ParserClass >
+struct FUnwindStack
+{
+    inline FUnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message ) :
+        m_level( level ), m_message( message ) {}
+    inline void operator () ( const Parser::CharType * first, const Parser::CharType * ) const
+    {
+        ParserClass::Current().UnwindStack( m_level, m_message, first );
+    }
+    inline void operator () ( const Parser::CharType ) const
+    {
+        ParserClass::Current().UnwindStack( m_level, m_message, NULL );
+    }
+    Parser::ErrorLevel::Levels m_level;
+    const Parser::CharType * m_message;
 };
 
 // ----------------------------------------------------------------------------
@@ -278,6 +287,10 @@ public:
 
     inline void Pop( void ) { if ( 0 <= m_stackIndex ) --m_stackIndex; }
 
+    /** Puts content on the stack.  Only the pointers are stored, so both
+     strings must stay valid until the content is popped.  The stack grows as
+     needed, so no content is ever dropped.
+     */
     void Push( const CharType * content, const CharType * type, unsigned long line,
         unsigned long chars );
 
@@ -305,15 +318,13 @@ private:
 
     enum Constants
     {
-        EmptySpot = -1,
-        TopPlace = 63,
-        MaxStackSize
+        EmptySpot = -1
     };
 
     struct ContentInfo
     {
-        StringType m_content;
-        StringType m_section;
+        const CharType * m_content;
+        const CharType * m_section;
         unsigned long m_line;
         unsigned long m_char;
 
@@ -326,7 +337,9 @@ private:
 
     signed long m_stackIndex;
 
-    ContentInfo m_messageStack[ MaxStackSize ];
+    /// Grows when pushed past its size, but never shrinks.  Empty until the
+    /// first push, so an unused stack costs no memory.
+    ::std::vector< ContentInfo > m_messageStack;
 
 };
 
@@ -414,12 +427,20 @@ public:
 
     void Clear( void );
 
+    /** Changes the message on top of the stack.
+     @param place Where in the text the message is about, or NULL if not known.
+     */
     void Prepare( Parser::ErrorLevel::Levels level, const CharType * message,
-        const char * file = NULL, const char * ruleName = NULL );
+        const char * file = NULL, const char * ruleName = NULL,
+        const CharType * place = NULL );
 
     bool Send( void );
 
-    bool Send( Parser::ErrorLevel::Levels level, const CharType * message );
+    /** Sends a message at once, without putting it on the stack.
+     @param place Where in the text the message is about, or NULL if not known.
+     */
+    bool Send( Parser::ErrorLevel::Levels level, const CharType * message,
+        const CharType * place = NULL );
 
     bool Send( const CharType * first, const CharType * last );
 
@@ -427,15 +448,39 @@ public:
 
     void Cancel( void );
 
+    /** Puts a message on the stack, to be sent by Pop unless Cancel is first.
+     Only pointers are stored, so a message which is canceled is never copied
+     or formatted.  The stack grows as needed, so every Push has a matching
+     Cancel or Pop however deep the grammar nests.
+     @param place Where in the text the message is about, or NULL if not known.
+     */
     void Push( Parser::ErrorLevel::Levels level, const CharType * message,
-        const char * file = NULL, const char * ruleName = NULL );
+        const char * file = NULL, const char * ruleName = NULL,
+        const CharType * place = NULL );
 
     void Pop( void );
+
+    /** Takes off every message put on the stack since it held size messages,
+     as when a production which could not be parsed is skipped over.  The
+     message on top tells best how far the production got, so it is sent and
+     the others are canceled.  If none were put on, the given message is sent
+     instead, so each production skipped over sends one message.
+     @param place Where in the text the skipped production starts.
+     */
+    void Unwind( unsigned long size, Parser::ErrorLevel::Levels level,
+        const CharType * message, const CharType * place = NULL );
 
     // void CancelAndPop( void );
 
     inline unsigned long GetStackSize( void ) const { return m_stackIndex+1; }
 
+    /** Returns where in the text the message being sent is about.  This is only
+     known while the preparer is called, and is NULL at any other time or if
+     the message did not say.  Storing a place costs one pointer, so a preparer
+     finds the line and column from it only when a message is sent.
+     */
+    inline const CharType * GetSendPlace( void ) const { return m_sendPlace; }
+
 private:
 
     typedef ::Parser::InvariantChecker< MessageStack > InvariantChecker;
@@ -443,9 +488,7 @@ private:
 
     enum Constants
     {
-        EmptySpot = -1,
-        TopPlace = 63,
-        MaxStackSize
+        EmptySpot = -1
     };
 
     struct MessageInfo
@@ -454,12 +497,14 @@ private:
         const CharType * m_message;
         const char * m_file;
         const char * m_ruleName;
+        const CharType * m_place;
 
         inline MessageInfo( void ) :
             m_level( Parser::ErrorLevel::None ),
             m_message( NULL ),
             m_file( NULL ),
-            m_ruleName( NULL ) {}
+            m_ruleName( NULL ),
+            m_place( NULL ) {}
 
         inline void Clear( void )
         {
@@ -490,7 +535,12 @@ private:
 
     signed long m_stackIndex;
 
-    MessageInfo m_messageStack[ MaxStackSize ];
+    /// Place of message being sent, or NULL.
+    const CharType * m_sendPlace;
+
+    /// Grows when pushed past its size, but never shrinks.  Places above
+    /// m_stackIndex are always cleared.
+    ::std::vector< MessageInfo > m_messageStack;
 
 };
 
@@ -507,9 +557,9 @@ struct FPushMessage
         m_stack( that.m_stack ), m_level( that.m_level ), m_message( that.m_message ),
         m_file( that.m_file ), m_ruleName( that.m_ruleName ) {}
 
-    inline void operator () ( const CharType *, const CharType * ) const
+    inline void operator () ( const CharType * first, const CharType * ) const
     {
-        m_stack.Push( m_level, m_message, m_file, m_ruleName );
+        m_stack.Push( m_level, m_message, m_file, m_ruleName, first );
     }
 
     inline void operator () ( CharType ) const
@@ -573,9 +623,9 @@ struct FPrepareMessage
         m_stack( that.m_stack ), m_level( that.m_level ), m_message( that.m_message ),
         m_file( that.m_file ), m_ruleName( that.m_ruleName ) {}
 
-    inline void operator () ( const CharType *, const CharType * ) const
+    inline void operator () ( const CharType * first, const CharType * ) const
     {
-        m_stack.Prepare( m_level, m_message, m_file, m_ruleName );
+        m_stack.Prepare( m_level, m_message, m_file, m_ruleName, first );
     }
 
     inline void operator () ( CharType ) const
@@ -610,9 +660,9 @@ struct FSendMessageNow
         m_stack( that.m_stack ), m_level( that.m_level ),
         m_message( that.m_message ) {}
 
-    inline void operator () ( const CharType *, const CharType * ) const
+    inline void operator () ( const CharType * first, const CharType * ) const
     {
-        m_stack.Send( m_level, m_message );
+        m_stack.Send( m_level, m_message, first );
     }
 
     inline void operator () ( CharType ) const
@@ -0,0 +1,261 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ParserPool.hpp Defines pool which lends parsers to many threads.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_POOL_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_POOL_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <stddef.h>
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+/// Counters kept by a ParserPool since it was made.
+struct ParserPoolStats
+{
+    /// Number of parsers lent out.
+    unsigned long m_leases;
+    /// Leases filled by an idle parser.
+    unsigned long m_hits;
+    /// Hits where the parser was last returned by the same thread.
+    unsigned long m_threadHits;
+    /// Leases which had to make a new parser.
+    unsigned long m_misses;
+    /// Leases which waited for another thread to return a parser.
+    unsigned long m_waits;
+    /// Total time spent waiting, in microseconds.
+    unsigned long m_waitTime;
+    /// Most parsers lent out at once.
+    unsigned long m_mostLeased;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class ParserPoolBase
+ Does the work for ParserPool which does not depend on the type of parser, so
+ the locking and platform code is not in the header.  Use ParserPool instead.
+ */
+class ParserPoolBase
+{
+public:
+
+    /// Returns a copy of the counters.  Safe to call from any thread.
+    ParserPoolStats GetStats( void ) const;
+
+    /// Returns most parsers this pool will make, or zero if it has no limit.
+    unsigned long GetMaxCount( void ) const;
+
+    /// Returns how many parsers are waiting in the pool to be lent.
+    unsigned long GetIdleCount( void ) const;
+
+    /// Returns how many parsers are lent out now.
+    unsigned long GetLeasedCount( void ) const;
+
+protected:
+
+    explicit ParserPoolBase( unsigned long maxCount );
+
+    virtual ~ParserPoolBase( void );
+
+    /** Lends a parser, preferring the one this thread returned most recently,
+     then any idle parser, and then a new one if the pool is below its limit.
+     @param wait True to wait for a parser if all are lent out and the pool is
+      at its limit, false to return NULL instead.
+     @return Pointer to parser, or NULL if none was available.  If making a new
+      parser throws, the exception passes to the caller.
+     */
+    void * LeaseParser( bool wait );
+
+    /// Takes back a lent parser and wakes one thread waiting for a parser.
+    void ReturnParser( void * parser );
+
+    /// Destroys all idle parsers.  Derived destructors must call this.
+    void DestroyIdleParsers( void );
+
+    /// Makes a parser when the pool has no idle one.  Called without the lock.
+    virtual void * MakeParser( void ) = 0;
+
+    /// Destroys a parser made by MakeParser.
+    virtual void DestroyParser( void * parser ) = 0;
+
+private:
+
+    /// Not implemented.
+    ParserPoolBase( void );
+    /// Not implemented.
+    ParserPoolBase( const ParserPoolBase & );
+    /// Not implemented.
+    ParserPoolBase & operator = ( const ParserPoolBase & );
+
+    class Impl;
+
+    /// Lock, idle parsers, and counters, which need platform headers.
+    Impl * m_impl;
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class ParserPool
+ Lends ready-to-use parsers to any number of threads.  A parser refuses to
+ parse while it is already parsing, so threads which share one parser must
+ take turns, and making a parser for each request costs time.  A pool keeps
+ parsers which are not in use and gives each thread its own for as long as it
+ needs one.  The pool remembers which thread returned each parser, and gives
+ a thread back the parser it used last when it can, since that parser is the
+ most likely to still be in that processor's cache.
+
+ ParserClass may be XmlParser or ConfigParser, or any class with a default
+ constructor.  Settings made on a lent parser, such as its error receiver, stay
+ with it when returned, so set them again on each lease or set them once in
+ the setup function given to the pool.
+ */
+template < class ParserClass >
+class ParserPool : public ParserPoolBase
+{
+public:
+
+    /// Function the pool calls on each parser it makes, before lending it.
+    typedef void ( * SetupFunction )( ParserClass & parser );
+
+    /** Makes an empty pool.  No parsers are made until they are needed.
+     @param maxCount Most parsers to make, or zero for no limit.  Threads wait
+      for a parser when this many are lent out.
+     @param setup Function to call on each new parser, or NULL for none.
+     */
+    explicit ParserPool( unsigned long maxCount = 0, SetupFunction setup = NULL ) :
+        ParserPoolBase( maxCount ),
+        m_setup( setup )
+    {
+    }
+
+    /// Destroys idle parsers.  All lent parsers must be returned first.
+    virtual ~ParserPool( void )
+    {
+        DestroyIdleParsers();
+    }
+
+    /// Lends a parser, and waits for one if the pool is at its limit.
+    inline ParserClass * Lease( void )
+    {
+        return static_cast< ParserClass * >( LeaseParser( true ) );
+    }
+
+    /// Lends a parser, or returns NULL at once if none is available.
+    inline ParserClass * TryLease( void )
+    {
+        return static_cast< ParserClass * >( LeaseParser( false ) );
+    }
+
+    /// Gives back a lent parser.  The parser must not be parsing.
+    inline void Return( ParserClass * parser )
+    {
+        ReturnParser( parser );
+    }
+
+    /** @class Leased
+     Leases a parser when constructed and returns it when destroyed, so the
+     parser goes back to the pool even if parsing throws.
+     */
+    class Leased
+    {
+    public:
+
+        explicit Leased( ParserPool & pool ) :
+            m_pool( pool ),
+            m_parser( pool.Lease() )
+        {
+        }
+
+        ~Leased( void )
+        {
+            if ( NULL != m_parser )
+                m_pool.Return( m_parser );
+        }
+
+        inline ParserClass * Get( void ) const { return m_parser; }
+
+        inline ParserClass * operator -> ( void ) const { return m_parser; }
+
+        inline ParserClass & operator * ( void ) const { return *m_parser; }
+
+    private:
+
+        /// Not implemented.
+        Leased( const Leased & );
+        /// Not implemented.
+        Leased & operator = ( const Leased & );
+
+        ParserPool & m_pool;
+        ParserClass * m_parser;
+    };
+
+private:
+
+    /// Not implemented.
+    ParserPool( const ParserPool & );
+    /// Not implemented.
+    ParserPool & operator = ( const ParserPool & );
+
+    virtual void * MakeParser( void )
+    {
+        ParserClass * parser = new ParserClass;
+        if ( NULL != m_setup )
+        {
+            try
+            {
+                m_setup( *parser );
+            }
+            catch ( ... )
+            {
+                delete parser;
+                throw;
+            }
+        }
+        return parser;
+    }
+
+    virtual void DestroyParser( void * parser )
+    {
+        delete static_cast< ParserClass * >( parser );
+    }
+
+    SetupFunction m_setup;
+
+};
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,239 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file RuleProfile.hpp Counts how often and how long each grammar rule runs.
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( PARSER_RULE_PROFILE_HPP_INCLUDED )
+/// File guardian.
+#define PARSER_RULE_PROFILE_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include <iosfwd>
+
+#if defined( PARSER_RULE_PROFILE )
+    #include <iterator>
+    #include <boost/spirit/core.hpp>
+#endif
+
+
+// ----------------------------------------------------------------------------
+// Namespace resolution.
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+#if defined( _MSC_VER )
+    typedef unsigned __int64 CycleCount;
+#else
+    typedef unsigned long long CycleCount;
+#endif
+
+// ----------------------------------------------------------------------------
+
+/** @struct RuleCounts
+ What one grammar rule did since counts were last reset.  Cycles include time
+ spent in rules called by this rule, so the rule for a whole production is
+ always at least as slow as any rule within it.
+ */
+struct RuleCounts
+{
+    /// Name of rule member, such as m_skipOver.
+    const char * m_name;
+    /// Source file which assigns the rule, without its directories.
+    const char * m_file;
+    /// Line which assigns the rule.
+    unsigned long m_line;
+    /// Times the rule was tried.
+    unsigned long m_entries;
+    unsigned long m_matches;
+    unsigned long m_fails;
+    /// Chars matched by the rule.
+    double m_bytes;
+    /// Chars the rule went past before it failed, which the grammar then goes
+    /// back over.  Rules which undo their own progress are not counted here.
+    double m_backtracked;
+    /// Processor cycles spent in the rule, or clock ticks if the processor has
+    /// no cycle counter.
+    double m_cycles;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class RuleProfile
+ Keeps counts for every rule marked with PARSER_PROFILE_RULE, in builds which
+ define PARSER_RULE_PROFILE.  Other builds keep no counts, and the macro adds
+ no code at all, so rules run just as fast as if never marked.  Counts are
+ not locked, so they are only right while one thread parses.  To get counts
+ for one parse, call Reset before it and Write after it.
+ */
+class RuleProfile
+{
+public:
+
+    /// Returns true if this build counts what each rule does.
+    static bool IsEnabled( void );
+
+    /** Returns counts for a rule, and adds them if not there yet.  Rules made
+     again at the same line, such as by another parser of the same kind, use
+     the same counts.  Safe to call from many threads.
+     */
+    static RuleCounts & Register( const char * name, const char * file,
+        unsigned long line );
+
+    /// Returns number of rules registered.
+    static unsigned long GetCount( void );
+
+    /// Returns counts for a rule.  index must be less than GetCount.
+    static const RuleCounts & GetCounts( unsigned long index );
+
+    /// Sets counts for every rule to zero.
+    static void Reset( void );
+
+    /** Writes one comma separated line for each rule which was tried, after a
+     line naming the columns, with the slowest rules first.
+     */
+    static void Write( ::std::ostream & out );
+
+    /// Returns processor cycles, only useful for finding elapsed cycles.
+    static CycleCount ReadCycles( void );
+
+private:
+
+    /// Not implemented.
+    RuleProfile( void );
+    /// Not implemented.
+    RuleProfile( const RuleProfile & );
+    /// Not implemented.
+    RuleProfile & operator = ( const RuleProfile & );
+};
+
+// ----------------------------------------------------------------------------
+
+#if defined( PARSER_RULE_PROFILE )
+
+/** @class ProfiledParser
+ Runs a Spirit parser, and adds what it did to the counts for a rule.
+ */
+template < class ParserT >
+class ProfiledParser :
+    public ::boost::spirit::parser< ProfiledParser< ParserT > >
+{
+public:
+
+    typedef ProfiledParser< ParserT > self_t;
+
+    template < typename ScannerT >
+    struct result
+    {
+        typedef typename ::boost::spirit::parser_result< ParserT, ScannerT >::type type;
+    };
+
+    inline ProfiledParser( RuleCounts & counts, const ParserT & subject ) :
+        m_counts( counts ), m_subject( subject ) {}
+
+    template < typename ScannerT >
+    typename ::boost::spirit::parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
+    {
+        typedef typename ::boost::spirit::parser_result< self_t, ScannerT >::type
+            result_t;
+        const typename ScannerT::iterator_t begin = scan.first;
+        ++m_counts.m_entries;
+        const CycleCount start = RuleProfile::ReadCycles();
+        result_t hit = m_subject.parse( scan );
+        m_counts.m_cycles += static_cast< double >( RuleProfile::ReadCycles() - start );
+        const double chars = static_cast< double >( ::std::distance( begin, scan.first ) );
+        if ( hit )
+        {
+            ++m_counts.m_matches;
+            m_counts.m_bytes += chars;
+        }
+        else
+        {
+            ++m_counts.m_fails;
+            m_counts.m_backtracked += chars;
+        }
+        return hit;
+    }
+
+private:
+
+    RuleCounts & m_counts;
+    typename ParserT::embed_t m_subject;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class RuleProfiler
+ Made by PARSER_PROFILE_RULE.  Assigning a parser to it assigns the rule a
+ ProfiledParser which runs that parser.
+ */
+template < class RuleT >
+class RuleProfiler
+{
+public:
+
+    inline RuleProfiler( RuleT & rule, const char * name, const char * file,
+        unsigned long line ) :
+        m_rule( rule ), m_counts( RuleProfile::Register( name, file, line ) ) {}
+
+    template < class ParserT >
+    inline RuleT & operator = ( const ParserT & parser )
+    {
+        m_rule = ProfiledParser< ParserT >( m_counts, parser );
+        return m_rule;
+    }
+
+private:
+
+    RuleT & m_rule;
+    RuleCounts & m_counts;
+};
+
+// ----------------------------------------------------------------------------
+
+template < class RuleT >
+inline RuleProfiler< RuleT > ProfileRule( RuleT & rule, const char * name,
+    const char * file, unsigned long line )
+{
+    return RuleProfiler< RuleT >( rule, name, file, line );
+}
+
+/// Put around a rule being assigned, so profiling builds count what it does.
+#define PARSER_PROFILE_RULE( rule ) \
+    ::Parser::ProfileRule( rule, #rule, __FILE__, __LINE__ )
+
+#else
+
+#define PARSER_PROFILE_RULE( rule ) rule
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -152,6 +152,76 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/// Ignores all messages, without making their text, so tests show only their
+/// own output.
+class QuietReceiver : public Parser::IParseErrorReceiver
+{
+public:
+
+    QuietReceiver( void ) : IParseErrorReceiver() {}
+
+    virtual ~QuietReceiver( void ) {}
+
+    virtual bool ReceiveParseMessage( const ParseMessage & message );
+
+    virtual bool GiveParseMessage( Parser::ErrorLevel::Levels level,
+        const CharType * message );
+
+    virtual bool GiveParseMessage( Parser::ErrorLevel::Levels level,
+        const CharType * message, unsigned long line );
+
+    virtual bool GiveParseMessage( Parser::ErrorLevel::Levels level,
+        const CharType * message, const char * filename, unsigned long line );
+
+private:
+    QuietReceiver( const QuietReceiver & );
+    QuietReceiver & operator = ( const QuietReceiver & );
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class TestChecker
+ Counts checks which pass and fail, for tests which make many small checks
+ instead of parsing a table of TestData.  Each failed check is shown at once.
+ */
+class TestChecker
+{
+public:
+
+    /// @param name Shown before each failed check and in the summary.
+    explicit TestChecker( const char * name );
+
+    ~TestChecker( void );
+
+    /// Counts one check, and shows what it was if it failed.  Returns passed.
+    bool Check( bool passed, const char * what );
+
+    inline unsigned long GetFailCount( void ) const { return m_failCount; }
+    inline unsigned long GetPassCount( void ) const { return m_passCount; }
+
+    /** Shows how many checks passed and failed if showSummary is true or if
+     any check failed.
+     @return True if no check failed.
+     */
+    bool ShowSummary( bool showSummary ) const;
+
+private:
+    TestChecker( void );
+    TestChecker( const TestChecker & );
+    TestChecker & operator = ( const TestChecker & );
+
+    const char * m_name;
+    unsigned long m_failCount;
+    unsigned long m_passCount;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Writes text to a file, replacing anything there.  Returns true if written.
+bool WriteTestFile( const char * filename, const char * text );
+
+// ----------------------------------------------------------------------------
+
 }; // end namespace Parser
 
 #endif // file guardian
@@ -0,0 +1,484 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file BatchRunner.cpp Runs jobs on threads which take work from each other.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/BatchRunner.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <vector>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+    #include <process.h>
+#else
+    #include <pthread.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Returns a time in microseconds, only useful for finding elapsed times.
+unsigned long GetMicroseconds( void )
+{
+#if defined( _WIN32 )
+    return static_cast< unsigned long >( ::GetTickCount() ) * 1000;
+#else
+    timeval now;
+    ::gettimeofday( &now, NULL );
+    return static_cast< unsigned long >( now.tv_sec ) * 1000000
+        + static_cast< unsigned long >( now.tv_usec );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+/// Jobs not yet taken from one thread's share, and the lock which guards them.
+class Share
+{
+public:
+
+    Share( void ) : m_next( 0 ), m_end( 0 ), m_steals( 0 )
+    {
+#if defined( _WIN32 )
+        ::InitializeCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_init( &m_lock, NULL );
+#endif
+    }
+
+    ~Share( void )
+    {
+#if defined( _WIN32 )
+        ::DeleteCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_destroy( &m_lock );
+#endif
+    }
+
+    inline void Lock( void )
+    {
+#if defined( _WIN32 )
+        ::EnterCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_lock( &m_lock );
+#endif
+    }
+
+    inline void Unlock( void )
+    {
+#if defined( _WIN32 )
+        ::LeaveCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_unlock( &m_lock );
+#endif
+    }
+
+    /// Takes first job of share.  Returns false if share is empty.
+    bool Take( unsigned long & job )
+    {
+        Lock();
+        const bool found = ( m_next < m_end );
+        if ( found )
+            job = m_next++;
+        Unlock();
+        return found;
+    }
+
+    /// Returns how many jobs are left.  Only a hint, since it does not lock.
+    inline unsigned long GetLeft( void ) const
+    {
+        return ( m_next < m_end ) ? ( m_end - m_next ) : 0;
+    }
+
+    /// Moves back half of this share to another share.  Returns false if empty.
+    bool GiveHalf( Share & thief )
+    {
+        Lock();
+        const unsigned long left = ( m_next < m_end ) ? ( m_end - m_next ) : 0;
+        const unsigned long middle = m_end - ( left + 1 ) / 2;
+        const unsigned long end = m_end;
+        if ( 0 != left )
+            m_end = middle;
+        Unlock();
+        if ( 0 == left )
+            return false;
+        thief.Lock();
+        thief.m_next = middle;
+        thief.m_end = end;
+        ++thief.m_steals;
+        thief.Unlock();
+        return true;
+    }
+
+    unsigned long m_next;
+    unsigned long m_end;
+    unsigned long m_steals;
+
+private:
+
+    /// Not implemented.
+    Share( const Share & );
+    /// Not implemented.
+    Share & operator = ( const Share & );
+
+#if defined( _WIN32 )
+    CRITICAL_SECTION m_lock;
+#else
+    pthread_mutex_t m_lock;
+#endif
+};
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+class BatchRunner::Impl
+{
+public:
+
+    /// What one thread needs to find its runner and its share.
+    struct ThreadStart
+    {
+        Impl * m_impl;
+        unsigned long m_index;
+        unsigned long m_jobs;
+        unsigned long m_exceptions;
+    };
+
+    Impl( BatchRunner & runner, unsigned long threadCount ) :
+        m_runner( runner ),
+        m_threadCount( threadCount ),
+        m_shares( NULL ),
+        m_shareCount( 0 ),
+        m_stats()
+    {
+        m_stats.m_threads = 0;
+        m_stats.m_jobs = 0;
+        m_stats.m_steals = 0;
+        m_stats.m_exceptions = 0;
+        m_stats.m_time = 0;
+    }
+
+    /// Runs jobs for one thread until no share has any left.
+    void RunThread( ThreadStart & start );
+
+    /// Finds a job in own share, or takes half of largest other share.
+    bool FindJob( unsigned long index, unsigned long & job );
+
+#if defined( _WIN32 )
+    static unsigned __stdcall ThreadMain( void * start );
+#else
+    static void * ThreadMain( void * start );
+#endif
+
+    BatchRunner & m_runner;
+    unsigned long m_threadCount;
+    Share * m_shares;
+    unsigned long m_shareCount;
+    BatchStats m_stats;
+
+private:
+
+    /// Not implemented.
+    Impl( const Impl & );
+    /// Not implemented.
+    Impl & operator = ( const Impl & );
+
+};
+
+// ----------------------------------------------------------------------------
+
+bool BatchRunner::Impl::FindJob( unsigned long index, unsigned long & job )
+{
+    Share & own = m_shares[ index ];
+    for ( ;; )
+    {
+        if ( own.Take( job ) )
+            return true;
+        unsigned long victim = index;
+        unsigned long most = 0;
+        for ( unsigned long ii = 0; ii < m_shareCount; ++ii )
+        {
+            const unsigned long left = m_shares[ ii ].GetLeft();
+            if ( ( ii != index ) && ( most < left ) )
+            {
+                most = left;
+                victim = ii;
+            }
+        }
+        if ( 0 == most )
+            return false;
+        // Victim may have emptied its share since it was counted, so look again.
+        m_shares[ victim ].GiveHalf( own );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRunner::Impl::RunThread( ThreadStart & start )
+{
+    void * worker = NULL;
+    try
+    {
+        worker = m_runner.MakeWorker();
+    }
+    catch ( ... )
+    {
+        // Without a worker, this thread leaves its share for others to take.
+        ++start.m_exceptions;
+        return;
+    }
+
+    unsigned long job = 0;
+    while ( FindJob( start.m_index, job ) )
+    {
+        try
+        {
+            m_runner.RunJob( worker, job );
+        }
+        catch ( ... )
+        {
+            ++start.m_exceptions;
+        }
+        ++start.m_jobs;
+    }
+    m_runner.DestroyWorker( worker );
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( _WIN32 )
+
+unsigned __stdcall BatchRunner::Impl::ThreadMain( void * start )
+{
+    ThreadStart & info = *reinterpret_cast< ThreadStart * >( start );
+    info.m_impl->RunThread( info );
+    return 0;
+}
+
+#else
+
+void * BatchRunner::Impl::ThreadMain( void * start )
+{
+    ThreadStart & info = *reinterpret_cast< ThreadStart * >( start );
+    info.m_impl->RunThread( info );
+    return NULL;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+unsigned long BatchRunner::GetProcessorCount( void )
+{
+#if defined( _WIN32 )
+    SYSTEM_INFO info;
+    ::GetSystemInfo( &info );
+    const unsigned long count = info.dwNumberOfProcessors;
+#else
+    const long found = ::sysconf( _SC_NPROCESSORS_ONLN );
+    const unsigned long count = ( found < 1 ) ? 1 : static_cast< unsigned long >( found );
+#endif
+    return ( 0 == count ) ? 1 : count;
+}
+
+// ----------------------------------------------------------------------------
+
+BatchRunner::BatchRunner( unsigned long threadCount ) :
+    m_impl( new Impl( *this, threadCount ) )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+BatchRunner::~BatchRunner( void )
+{
+    assert( NULL != this );
+    delete m_impl;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long BatchRunner::GetThreadCount( void ) const
+{
+    assert( NULL != this );
+    return ( 0 == m_impl->m_threadCount ) ? GetProcessorCount() : m_impl->m_threadCount;
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRunner::SetThreadCount( unsigned long threadCount )
+{
+    assert( NULL != this );
+    m_impl->m_threadCount = threadCount;
+}
+
+// ----------------------------------------------------------------------------
+
+BatchStats BatchRunner::GetStats( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_stats;
+}
+
+// ----------------------------------------------------------------------------
+
+void BatchRunner::RunJobs( unsigned long jobCount )
+{
+    assert( NULL != this );
+
+    const unsigned long startTime = GetMicroseconds();
+    unsigned long threadCount = GetThreadCount();
+    if ( jobCount < threadCount )
+        threadCount = ( 0 == jobCount ) ? 1 : jobCount;
+
+    // Shares hold locks, which may not be copied, so they are not in a vector.
+    Share * shares = new Share[ threadCount ];
+    ::std::vector< Impl::ThreadStart > starts( threadCount );
+    for ( unsigned long ii = 0; ii < threadCount; ++ii )
+    {
+        // Equal shares in job order, so neighbouring jobs run on one thread.
+        shares[ ii ].m_next = static_cast< unsigned long >(
+            ( static_cast< double >( jobCount ) * ii ) / threadCount );
+        shares[ ii ].m_end = static_cast< unsigned long >(
+            ( static_cast< double >( jobCount ) * ( ii + 1 ) ) / threadCount );
+        starts[ ii ].m_impl = m_impl;
+        starts[ ii ].m_index = ii;
+        starts[ ii ].m_jobs = 0;
+        starts[ ii ].m_exceptions = 0;
+    }
+    m_impl->m_shares = shares;
+    m_impl->m_shareCount = threadCount;
+
+    // Calling thread is thread 0, so only the others need starting.  Shares of
+    // threads which fail to start are stolen by those which did.
+    unsigned long started = 1;
+#if defined( _WIN32 )
+    ::std::vector< HANDLE > threads( threadCount, NULL );
+    for ( ; started < threadCount; ++started )
+    {
+        threads[ started ] = reinterpret_cast< HANDLE >( ::_beginthreadex( NULL, 0,
+            &Impl::ThreadMain, &starts[ started ], 0, NULL ) );
+        if ( NULL == threads[ started ] )
+            break;
+    }
+    m_impl->RunThread( starts[ 0 ] );
+    for ( unsigned long ii = 1; ii < started; ++ii )
+    {
+        ::WaitForSingleObject( threads[ ii ], INFINITE );
+        ::CloseHandle( threads[ ii ] );
+    }
+#else
+    ::std::vector< pthread_t > threads( threadCount );
+    for ( ; started < threadCount; ++started )
+    {
+        if ( 0 != ::pthread_create( &threads[ started ], NULL, &Impl::ThreadMain,
+            &starts[ started ] ) )
+            break;
+    }
+    m_impl->RunThread( starts[ 0 ] );
+    for ( unsigned long ii = 1; ii < started; ++ii )
+        ::pthread_join( threads[ ii ], NULL );
+#endif
+
+    BatchStats & stats = m_impl->m_stats;
+    stats.m_threads = started;
+    stats.m_jobs = 0;
+    stats.m_steals = 0;
+    stats.m_exceptions = 0;
+    for ( unsigned long ii = 0; ii < threadCount; ++ii )
+    {
+        stats.m_jobs += starts[ ii ].m_jobs;
+        stats.m_steals += shares[ ii ].m_steals;
+        stats.m_exceptions += starts[ ii ].m_exceptions;
+    }
+    stats.m_time = GetMicroseconds() - startTime;
+    m_impl->m_shares = NULL;
+    m_impl->m_shareCount = 0;
+    delete [] shares;
+}
+
+// ----------------------------------------------------------------------------
+
+bool MessageCollector::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message )
+{
+    assert( NULL != this );
+    if ( NULL != m_count )
+        ++*m_count;
+    if ( NULL != m_text )
+    {
+        *m_text += ErrorLevel::Name( level );
+        *m_text += ": ";
+        if ( NULL != message )
+            *m_text += message;
+        *m_text += '\n';
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool MessageCollector::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, unsigned long line )
+{
+    assert( NULL != this );
+    if ( NULL != m_count )
+        ++*m_count;
+    if ( NULL != m_text )
+    {
+        char number[ 32 ];
+        ::sprintf( number, " [line %lu]\n", line );
+        *m_text += ErrorLevel::Name( level );
+        *m_text += ": ";
+        if ( NULL != message )
+            *m_text += message;
+        *m_text += number;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool MessageCollector::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, const char *, unsigned long line )
+{
+    assert( NULL != this );
+    return GiveParseMessage( level, message, line );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,437 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file CharFinder.cpp Contains functions for CharFinder and RunFinder classes.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/CharFinder.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+// SSE2 is always there on x64, and on x86 when the compiler was told to use it.
+#if defined( __SSE2__ ) || defined( _M_X64 ) \
+    || ( defined( _M_IX86_FP ) && ( 2 <= _M_IX86_FP ) )
+    #define PARSER_CHAR_FINDER_SSE2
+    #include <emmintrin.h>
+#endif
+
+// AVX2 is only used after asking the processor for it, so the compiler must
+// be able to build AVX2 functions without using AVX2 everywhere else.
+#if defined( PARSER_CHAR_FINDER_SSE2 ) && defined( __GNUC__ ) \
+    && ( defined( __x86_64__ ) || defined( __i386__ ) ) \
+    && ( defined( __clang__ ) || ( 4 < __GNUC__ ) \
+      || ( ( 4 == __GNUC__ ) && ( 9 <= __GNUC_MINOR__ ) ) )
+    #define PARSER_CHAR_FINDER_AVX2
+    #define PARSER_AVX2_FUNCTION __attribute__(( target( "avx2" ) ))
+    #include <immintrin.h>
+#elif defined( PARSER_CHAR_FINDER_SSE2 ) && defined( _MSC_VER ) \
+    && ( 1700 <= _MSC_VER )
+    #define PARSER_CHAR_FINDER_AVX2
+    #define PARSER_AVX2_FUNCTION
+    #include <immintrin.h>
+#endif
+
+#if defined( PARSER_CHAR_FINDER_SSE2 ) && defined( _MSC_VER )
+    #include <intrin.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+#if defined( PARSER_CHAR_FINDER_SSE2 )
+
+/// Returns index of lowest set bit.  bits must not be zero.
+inline unsigned int LowestBit( unsigned int bits )
+{
+#if defined( _MSC_VER )
+    unsigned long index = 0;
+    ::_BitScanForward( &index, bits );
+    return index;
+#else
+    return static_cast< unsigned int >( __builtin_ctz( bits ) );
+#endif
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if this processor and operating system can run AVX2 code.
+bool HasAvx2( void )
+{
+#if !defined( PARSER_CHAR_FINDER_AVX2 )
+    return false;
+#elif defined( _MSC_VER )
+    int info[ 4 ];
+    ::__cpuid( info, 0 );
+    if ( info[ 0 ] < 7 )
+        return false;
+    ::__cpuid( info, 1 );
+    // The OS must save the AVX registers when it switches threads.
+    const int osxsaveAndAvx = ( 1 << 27 ) | ( 1 << 28 );
+    if ( osxsaveAndAvx != ( info[ 2 ] & osxsaveAndAvx ) )
+        return false;
+    if ( 6 != ( ::_xgetbv( 0 ) & 6 ) )
+        return false;
+    ::__cpuidex( info, 7, 0 );
+    return ( 0 != ( info[ 1 ] & ( 1 << 5 ) ) );
+#else
+    __builtin_cpu_init();
+    return ( 0 != __builtin_cpu_supports( "avx2" ) );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::CharFinder::Kernel ChooseBestKernel( void )
+{
+    if ( ::Parser::CharFinder::CanUseKernel( ::Parser::CharFinder::Avx2 ) )
+        return ::Parser::CharFinder::Avx2;
+    if ( ::Parser::CharFinder::CanUseKernel( ::Parser::CharFinder::Sse2 ) )
+        return ::Parser::CharFinder::Sse2;
+    return ::Parser::CharFinder::Scalar;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Kernel used by all CharFinders.
+::Parser::CharFinder::Kernel s_kernel = ChooseBestKernel();
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if the whole nil-terminated string is at the start of range.
+inline bool StartsWith( const char * begin, const char * end, const char * text )
+{
+    for ( ; '\0' != *text; ++text, ++begin )
+    {
+        if ( ( begin == end ) || ( *begin != *text ) )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns true for chars which print_p matches in the "C" locale.
+inline bool IsPrintable( char ch )
+{
+    return ( ( ' ' <= ch ) && ( ch <= '~' ) );
+}
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+CharFinder::Kernel CharFinder::GetKernel( void )
+{
+    return s_kernel;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CharFinder::CanUseKernel( Kernel kernel )
+{
+    switch ( kernel )
+    {
+        case Scalar:
+            return true;
+        case Sse2:
+#if defined( PARSER_CHAR_FINDER_SSE2 )
+            return true;
+#else
+            return false;
+#endif
+        case Avx2:
+            return HasAvx2();
+        default:
+            break;
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CharFinder::SetKernel( Kernel kernel )
+{
+    if ( !CanUseKernel( kernel ) )
+        return false;
+    s_kernel = kernel;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+CharFinder::CharFinder( const char * chars, bool findUnprintable ) :
+    m_count( 0 ),
+    m_findUnprintable( findUnprintable )
+{
+    assert( NULL != this );
+    assert( NULL != chars );
+    assert( ::strlen( chars ) <= MaxChars );
+    ::memset( m_chars, 0, sizeof( m_chars ) );
+    ::memset( m_table, 0, sizeof( m_table ) );
+    if ( findUnprintable )
+    {
+        for ( unsigned int ii = 0; ii < 256; ++ii )
+            if ( !IsPrintable( static_cast< char >( ii ) ) )
+                m_table[ ii ] = 1;
+    }
+    for ( ; '\0' != *chars; ++chars )
+        AddChar( *chars );
+}
+
+// ----------------------------------------------------------------------------
+
+CharFinder::CharFinder( bool findUnprintable ) :
+    m_count( 0 ),
+    m_findUnprintable( findUnprintable )
+{
+    assert( NULL != this );
+    ::memset( m_chars, 0, sizeof( m_chars ) );
+    ::memset( m_table, 0, sizeof( m_table ) );
+    if ( findUnprintable )
+    {
+        for ( unsigned int ii = 0; ii < 256; ++ii )
+            if ( !IsPrintable( static_cast< char >( ii ) ) )
+                m_table[ ii ] = 1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool CharFinder::AddChar( char ch )
+{
+    assert( NULL != this );
+    if ( MaxChars <= m_count )
+        return false;
+    if ( 0 == m_count )
+    {
+        // Unused places repeat the first char so kernels compare all four.
+        for ( unsigned int ii = 0; ii < MaxChars; ++ii )
+            m_chars[ ii ] = ch;
+    }
+    else
+        m_chars[ m_count ] = ch;
+    ++m_count;
+    m_table[ static_cast< unsigned char >( ch ) ] = 1;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * CharFinder::Find( const char * begin, const char * end ) const
+{
+    assert( NULL != this );
+    assert( begin <= end );
+    if ( ( 0 == m_count ) && !m_findUnprintable )
+        return end;
+    switch ( s_kernel )
+    {
+        case Avx2: return FindAvx2( *this, begin, end );
+        case Sse2: return FindSse2( *this, begin, end );
+        default:   break;
+    }
+    return FindScalar( *this, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * CharFinder::FindScalar( const CharFinder & finder,
+    const char * begin, const char * end )
+{
+    for ( ; begin != end; ++begin )
+    {
+        if ( finder.IsWanted( *begin ) )
+            return begin;
+    }
+    return end;
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( PARSER_CHAR_FINDER_SSE2 )
+
+const char * CharFinder::FindSse2( const CharFinder & finder,
+    const char * begin, const char * end )
+{
+    const __m128i char0 = _mm_set1_epi8( finder.m_chars[ 0 ] );
+    const __m128i char1 = _mm_set1_epi8( finder.m_chars[ 1 ] );
+    const __m128i char2 = _mm_set1_epi8( finder.m_chars[ 2 ] );
+    const __m128i char3 = _mm_set1_epi8( finder.m_chars[ 3 ] );
+    const __m128i low = _mm_set1_epi8( ' ' );
+    const __m128i high = _mm_set1_epi8( '~' );
+    const __m128i unprintable = _mm_set1_epi8(
+        static_cast< char >( finder.m_findUnprintable ? -1 : 0 ) );
+
+    while ( 16 <= end - begin )
+    {
+        const __m128i text = _mm_loadu_si128(
+            reinterpret_cast< const __m128i * >( begin ) );
+        const __m128i same = _mm_or_si128(
+            _mm_or_si128( _mm_cmpeq_epi8( text, char0 ),
+                _mm_cmpeq_epi8( text, char1 ) ),
+            _mm_or_si128( _mm_cmpeq_epi8( text, char2 ),
+                _mm_cmpeq_epi8( text, char3 ) ) );
+        // Compares are signed, so chars from 0x80 up are below ' ' too.
+        const __m128i outside = _mm_or_si128( _mm_cmplt_epi8( text, low ),
+            _mm_cmpgt_epi8( text, high ) );
+        const int bits = _mm_movemask_epi8( _mm_or_si128( same,
+            _mm_and_si128( outside, unprintable ) ) );
+        if ( 0 != bits )
+            return begin + LowestBit( static_cast< unsigned int >( bits ) );
+        begin += 16;
+    }
+    return FindScalar( finder, begin, end );
+}
+
+#else
+
+const char * CharFinder::FindSse2( const CharFinder & finder,
+    const char * begin, const char * end )
+{
+    return FindScalar( finder, begin, end );
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+#if defined( PARSER_CHAR_FINDER_AVX2 )
+
+PARSER_AVX2_FUNCTION
+const char * CharFinder::FindAvx2( const CharFinder & finder,
+    const char * begin, const char * end )
+{
+    const __m256i char0 = _mm256_set1_epi8( finder.m_chars[ 0 ] );
+    const __m256i char1 = _mm256_set1_epi8( finder.m_chars[ 1 ] );
+    const __m256i char2 = _mm256_set1_epi8( finder.m_chars[ 2 ] );
+    const __m256i char3 = _mm256_set1_epi8( finder.m_chars[ 3 ] );
+    const __m256i low = _mm256_set1_epi8( ' ' );
+    const __m256i high = _mm256_set1_epi8( '~' );
+    const __m256i unprintable = _mm256_set1_epi8(
+        static_cast< char >( finder.m_findUnprintable ? -1 : 0 ) );
+
+    while ( 32 <= end - begin )
+    {
+        const __m256i text = _mm256_loadu_si256(
+            reinterpret_cast< const __m256i * >( begin ) );
+        const __m256i same = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpeq_epi8( text, char0 ),
+                _mm256_cmpeq_epi8( text, char1 ) ),
+            _mm256_or_si256( _mm256_cmpeq_epi8( text, char2 ),
+                _mm256_cmpeq_epi8( text, char3 ) ) );
+        // Compares are signed, so chars from 0x80 up are below ' ' too.
+        const __m256i outside = _mm256_or_si256( _mm256_cmpgt_epi8( low, text ),
+            _mm256_cmpgt_epi8( text, high ) );
+        const int bits = _mm256_movemask_epi8( _mm256_or_si256( same,
+            _mm256_and_si256( outside, unprintable ) ) );
+        if ( 0 != bits )
+            return begin + LowestBit( static_cast< unsigned int >( bits ) );
+        begin += 32;
+    }
+    // Fewer than 32 chars are left, so finish with one SSE2 pass.
+    return FindSse2( finder, begin, end );
+}
+
+#else
+
+const char * CharFinder::FindAvx2( const CharFinder & finder,
+    const char * begin, const char * end )
+{
+    return FindSse2( finder, begin, end );
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+RunFinder::RunFinder( bool printableOnly, const char * stop1,
+    const char * stop2, const char * stop3 ) :
+    m_finder( printableOnly ),
+    m_stopCount( 0 ),
+    m_printableOnly( printableOnly ),
+    m_sawEmpty( false )
+{
+    assert( NULL != this );
+    m_stops[ 0 ] = NULL;
+    m_stops[ 1 ] = NULL;
+    m_stops[ 2 ] = NULL;
+    AddStop( stop1 );
+    AddStop( stop2 );
+    AddStop( stop3 );
+}
+
+// ----------------------------------------------------------------------------
+
+void RunFinder::AddStop( const char * stop )
+{
+    assert( NULL != this );
+    if ( ( NULL == stop ) || m_sawEmpty )
+        return;
+    if ( '\0' == *stop )
+    {
+        m_sawEmpty = true;
+        return;
+    }
+    m_stops[ m_stopCount ] = stop;
+    ++m_stopCount;
+    // Runs of printable chars already stop at unprintable ones.
+    if ( !m_printableOnly || IsPrintable( *stop ) )
+        m_finder.AddChar( *stop );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * RunFinder::Find( const char * begin, const char * end ) const
+{
+    assert( NULL != this );
+    assert( begin <= end );
+    for ( ;; )
+    {
+        begin = m_finder.Find( begin, end );
+        if ( begin == end )
+            return end;
+        if ( m_printableOnly && !IsPrintable( *begin ) )
+            return begin;
+        for ( unsigned int ii = 0; ii < m_stopCount; ++ii )
+        {
+            if ( StartsWith( begin, end, m_stops[ ii ] ) )
+                return begin;
+        }
+        ++begin;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
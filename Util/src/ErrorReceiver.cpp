@@ -19,6 +19,10 @@
 // Included files.
 
 #include "../include/ErrorReceiver.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
 
 
 // ----------------------------------------------------------------------------
@@ -50,6 +54,157 @@ bool Parser::ErrorLevel::Valid( Parser::ErrorLevel::Levels level )
 
 // ----------------------------------------------------------------------------
 
+void Parser::MessageBuffer::Append( const Parser::CharType * first,
+    const Parser::CharType * last )
+{
+    assert( NULL != this );
+    if ( m_cut || ( NULL == first ) || ( last <= first ) )
+        return;
+    static const char s_cutMark[] = "...";
+    static const unsigned long s_cutMarkSize = sizeof( s_cutMark ) - 1;
+    const unsigned long room = Capacity - 1 - m_length;
+    unsigned long count = static_cast< unsigned long >( last - first );
+    if ( room < count )
+    {
+        m_cut = true;
+        count = room;
+    }
+    ::memcpy( m_text + m_length, first, count * sizeof( CharType ) );
+    m_length += count;
+    if ( m_cut )
+    {
+        // Write mark over the last chars so readers know text is missing.
+        ::memcpy( m_text + m_length - s_cutMarkSize, s_cutMark, s_cutMarkSize );
+    }
+    m_text[ m_length ] = '\0';
+}
+
+// ----------------------------------------------------------------------------
+
+void Parser::MessageBuffer::Append( const Parser::CharType * text )
+{
+    assert( NULL != this );
+    if ( NULL != text )
+        Append( text, text + ::strlen( text ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void Parser::MessageBuffer::Append( unsigned long number )
+{
+    assert( NULL != this );
+    char digits[ 24 ];
+    ::sprintf( digits, "%lu", number );
+    Append( digits );
+}
+
+// ----------------------------------------------------------------------------
+
+Parser::ParseMessage::ParseMessage( Parser::ErrorLevel::Levels level,
+    const Parser::CharType * message ) :
+    m_level( level ),
+    m_code( Message ),
+    m_text( message ),
+    m_textEnd( NULL ),
+    m_section( NULL ),
+    m_name( NULL ),
+    m_line( 0 ),
+    m_column( 0 )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+Parser::ParseMessage::ParseMessage( Parser::ErrorLevel::Levels level,
+    const Parser::CharType * first, const Parser::CharType * last ) :
+    m_level( level ),
+    m_code( Content ),
+    m_text( first ),
+    m_textEnd( last ),
+    m_section( NULL ),
+    m_name( NULL ),
+    m_line( 0 ),
+    m_column( 0 )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+Parser::ParseMessage::ParseMessage( const Parser::CharType * section,
+    const Parser::CharType * name, unsigned long line, unsigned long column ) :
+    m_level( ErrorLevel::Content ),
+    m_code( Location ),
+    m_text( NULL ),
+    m_textEnd( NULL ),
+    m_section( section ),
+    m_name( name ),
+    m_line( line ),
+    m_column( column )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void Parser::ParseMessage::Format( Parser::MessageBuffer & buffer ) const
+{
+    assert( NULL != this );
+    switch ( m_code )
+    {
+        case Message:
+            buffer.Append( m_text );
+            if ( 0 != m_line )
+            {
+                buffer.Append( " On line " );
+                buffer.Append( m_line );
+                buffer.Append( " at char " );
+                buffer.Append( m_column );
+                buffer.Append( "." );
+            }
+            break;
+        case Content:
+            buffer.Append( m_text, m_textEnd );
+            break;
+        case Location:
+            if ( NULL == m_name )
+            {
+                buffer.Append( m_section );
+                break;
+            }
+            buffer.Append( "Inside " );
+            buffer.Append( m_section );
+            buffer.Append( " section for " );
+            buffer.Append( m_name );
+            if ( 0 != m_line )
+            {
+                buffer.Append( " on line " );
+                buffer.Append( m_line );
+                buffer.Append( " at char " );
+                buffer.Append( m_column );
+                buffer.Append( "." );
+            }
+            break;
+        default:
+            assert( false );
+            break;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::IParseErrorReceiver::ReceiveParseMessage(
+    const Parser::ParseMessage & message )
+{
+    assert( NULL != this );
+    MessageBuffer buffer;
+    message.Format( buffer );
+    return GiveParseMessage( message.m_level, buffer.GetText() );
+}
+
+// ----------------------------------------------------------------------------
+
 // $Log: ErrorReceiver.cpp,v $
 // Revision 1.1  2008/12/05 19:12:28  rich_sposato
 // Adding files to CVS.
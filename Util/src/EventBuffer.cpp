@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventBuffer.cpp Hands parse events over in batches.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/EventBuffer.hpp"
+
+#include <assert.h>
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+void IEventBatchReceiver::ReuseEvents( const ParseEvent * events,
+    unsigned long count )
+{
+    assert( NULL != this );
+    (void)events;
+    (void)count;
+}
+
+// ----------------------------------------------------------------------------
+
+EventBuffer::EventBuffer( ParseEvent * events, unsigned long capacity,
+    unsigned long batchSize, IEventBatchReceiver * receiver ) :
+    m_events( events ),
+    m_batchSize( batchSize ),
+    m_batches( 1 ),
+    m_receiver( receiver ),
+    m_batchBegin( 0 ),
+    m_next( 0 ),
+    m_held(),
+    m_sentEvents( 0 ),
+    m_batchCount( 0 ),
+    m_stopped( false )
+{
+    assert( NULL != this );
+    assert( NULL != events );
+    assert( 0 < capacity );
+    assert( NULL != receiver );
+
+    if ( 0 == m_batchSize )
+        m_batchSize = 1;
+    if ( capacity < m_batchSize )
+        m_batchSize = capacity;
+    m_batches = capacity / m_batchSize;
+    m_held.resize( m_batches, 0 );
+}
+
+// ----------------------------------------------------------------------------
+
+EventBuffer::~EventBuffer( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+bool EventBuffer::SendBatch( void )
+{
+    assert( NULL != this );
+    assert( m_batchBegin <= m_next );
+    assert( m_next - m_batchBegin <= m_batchSize );
+
+    if ( m_stopped )
+        return false;
+    const unsigned long count = m_next - m_batchBegin;
+    if ( 0 == count )
+        return true;
+    unsigned long batch = m_batchBegin / m_batchSize;
+    m_held[ batch ] = count;
+    m_sentEvents += count;
+    ++m_batchCount;
+    const bool keep = m_receiver->TakeEvents( m_events + m_batchBegin, count );
+
+    ++batch;
+    if ( m_batches <= batch )
+        batch = 0;
+    if ( 0 != m_held[ batch ] )
+    {
+        m_receiver->ReuseEvents( m_events + batch * m_batchSize, m_held[ batch ] );
+        m_held[ batch ] = 0;
+    }
+    m_batchBegin = batch * m_batchSize;
+    m_next = m_batchBegin;
+    if ( !keep )
+        m_stopped = true;
+    return keep;
+}
+
+// ----------------------------------------------------------------------------
+
+bool EventBuffer::Flush( void )
+{
+    assert( NULL != this );
+
+    const bool keep = SendBatch();
+    // Waits for the oldest batch first, so a receiver can finish them in order.
+    unsigned long batch = m_batchBegin / m_batchSize;
+    for ( unsigned long ii = 0; ii < m_batches; ++ii )
+    {
+        if ( 0 != m_held[ batch ] )
+        {
+            m_receiver->ReuseEvents( m_events + batch * m_batchSize, m_held[ batch ] );
+            m_held[ batch ] = 0;
+        }
+        ++batch;
+        if ( m_batches <= batch )
+            batch = 0;
+    }
+    return keep;
+}
+
+// ----------------------------------------------------------------------------
+
+void EventBuffer::Reset( void )
+{
+    assert( NULL != this );
+
+    // Receiver must be done with every batch before any is written over.
+    m_stopped = true;
+    Flush();
+    m_batchBegin = 0;
+    m_next = 0;
+    m_sentEvents = 0;
+    m_batchCount = 0;
+    m_stopped = false;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,283 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file FileBuffer.cpp Contains functions for FileBuffer class.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/FileBuffer.hpp"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Contents and sentinel given out for empty files, so nothing is allocated.
+const Parser::CharType s_emptyFile[ 1 ] = { '\0' };
+
+// ----------------------------------------------------------------------------
+
+/** Returns true if a mapping of the given size leaves room for the sentinel.
+ The operating system zero-fills the rest of the last page of a mapped view,
+ so the sentinel is free unless the file ends exactly on a page boundary.
+ */
+inline bool HasRoomForSentinel( unsigned long size, unsigned long pageSize )
+{
+    return ( 0 != pageSize ) && ( 0 != ( size % pageSize ) );
+}
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+FileBuffer::FileBuffer( void ) :
+    m_begin( NULL ),
+    m_size( 0 ),
+    m_mapped( false )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+FileBuffer::~FileBuffer( void )
+{
+    assert( this != NULL );
+    Close();
+}
+
+// ----------------------------------------------------------------------------
+
+bool FileBuffer::Open( const char * filename )
+{
+    assert( this != NULL );
+
+    Close();
+    if ( ( NULL == filename ) || ( '\0' == *filename ) )
+        return false;
+    if ( MapFile( filename ) )
+        return true;
+    return ReadFile( filename );
+}
+
+// ----------------------------------------------------------------------------
+
+void FileBuffer::Close( void )
+{
+    assert( this != NULL );
+
+    if ( ( NULL == m_begin ) || ( s_emptyFile == m_begin ) )
+    {
+    }
+    else if ( m_mapped )
+    {
+#if defined( _WIN32 )
+        ::UnmapViewOfFile( m_begin );
+#else
+        ::munmap( const_cast< CharType * >( m_begin ), m_size );
+#endif
+    }
+    else
+    {
+        ::free( const_cast< CharType * >( m_begin ) );
+    }
+    m_begin = NULL;
+    m_size = 0;
+    m_mapped = false;
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( _WIN32 )
+
+bool FileBuffer::MapFile( const char * filename )
+{
+    assert( this != NULL );
+
+    HANDLE file = ::CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if ( INVALID_HANDLE_VALUE == file )
+        return false;
+    LARGE_INTEGER fileSize;
+    if ( !::GetFileSizeEx( file, &fileSize ) )
+    {
+        ::CloseHandle( file );
+        return false;
+    }
+    const unsigned long size = static_cast< unsigned long >( fileSize.QuadPart );
+    if ( static_cast< LONGLONG >( size ) != fileSize.QuadPart )
+    {
+        ::CloseHandle( file );
+        return false;
+    }
+    if ( 0 == size )
+    {
+        ::CloseHandle( file );
+        m_begin = s_emptyFile;
+        return true;
+    }
+
+    SYSTEM_INFO info;
+    ::GetSystemInfo( &info );
+    if ( !HasRoomForSentinel( size, info.dwPageSize ) )
+    {
+        ::CloseHandle( file );
+        return false;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    ::CloseHandle( file );
+    if ( NULL == mapping )
+        return false;
+    // The view keeps the mapping object alive after its handle is closed.
+    void * view = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    ::CloseHandle( mapping );
+    if ( NULL == view )
+        return false;
+
+    m_begin = static_cast< const CharType * >( view );
+    m_size = size;
+    m_mapped = true;
+    return true;
+}
+
+#else
+
+bool FileBuffer::MapFile( const char * filename )
+{
+    assert( this != NULL );
+
+    const int file = ::open( filename, O_RDONLY );
+    if ( file < 0 )
+        return false;
+    struct stat status;
+    if ( ( ::fstat( file, &status ) != 0 ) || !S_ISREG( status.st_mode ) )
+    {
+        ::close( file );
+        return false;
+    }
+    const unsigned long size = static_cast< unsigned long >( status.st_size );
+    if ( static_cast< off_t >( size ) != status.st_size )
+    {
+        ::close( file );
+        return false;
+    }
+    if ( 0 == size )
+    {
+        ::close( file );
+        m_begin = s_emptyFile;
+        return true;
+    }
+
+    const long pageSize = ::sysconf( _SC_PAGESIZE );
+    if ( ( pageSize <= 0 )
+      || !HasRoomForSentinel( size, static_cast< unsigned long >( pageSize ) ) )
+    {
+        ::close( file );
+        return false;
+    }
+
+    void * view = ::mmap( NULL, size, PROT_READ, MAP_PRIVATE, file, 0 );
+    // The mapping stays valid after the descriptor is closed.
+    ::close( file );
+    if ( MAP_FAILED == view )
+        return false;
+#if defined( MADV_SEQUENTIAL )
+    ::madvise( view, size, MADV_SEQUENTIAL );
+#endif
+
+    m_begin = static_cast< const CharType * >( view );
+    m_size = size;
+    m_mapped = true;
+    return true;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+bool FileBuffer::ReadFile( const char * filename )
+{
+    assert( this != NULL );
+
+    FILE * file = ::fopen( filename, "rb" );
+    if ( NULL == file )
+        return false;
+    if ( ::fseek( file, 0, SEEK_END ) != 0 )
+    {
+        ::fclose( file );
+        return false;
+    }
+    const long length = ::ftell( file );
+    if ( ( length < 0 ) || ( ::fseek( file, 0, SEEK_SET ) != 0 ) )
+    {
+        ::fclose( file );
+        return false;
+    }
+    if ( 0 == length )
+    {
+        ::fclose( file );
+        m_begin = s_emptyFile;
+        return true;
+    }
+
+    const unsigned long size = static_cast< unsigned long >( length );
+    CharType * buffer = static_cast< CharType * >( ::malloc( size + 1 ) );
+    if ( NULL == buffer )
+    {
+        ::fclose( file );
+        return false;
+    }
+    const size_t count = ::fread( buffer, 1, size, file );
+    ::fclose( file );
+    if ( count != size )
+    {
+        ::free( buffer );
+        return false;
+    }
+    buffer[ size ] = '\0';
+
+    m_begin = buffer;
+    m_size = size;
+    m_mapped = false;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
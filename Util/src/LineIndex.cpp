@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file LineIndex.cpp Finds lines and columns only when asked.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/LineIndex.hpp"
+
+#include <assert.h>
+
+#include <algorithm>
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+LineIndex::LineIndex( void ) :
+    m_begin( NULL ),
+    m_end( NULL ),
+    m_indexed( NULL ),
+    m_newLines(),
+    m_finder( "\n", false )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+LineIndex::~LineIndex( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void LineIndex::SetText( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( begin <= end );
+    m_begin = begin;
+    m_end = end;
+    m_indexed = begin;
+    // Keeps capacity, so later texts need not allocate again.
+    m_newLines.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void LineIndex::IndexUpTo( const char * place )
+{
+    assert( NULL != this );
+    assert( Contains( place ) );
+    while ( m_indexed < place )
+    {
+        const char * found = m_finder.Find( m_indexed, m_end );
+        if ( found == m_end )
+        {
+            m_indexed = m_end;
+            break;
+        }
+        m_newLines.push_back( found );
+        m_indexed = found + 1;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool LineIndex::Find( const char * place, unsigned long & line, unsigned long & column )
+{
+    assert( NULL != this );
+    if ( !Contains( place ) )
+        return false;
+    IndexUpTo( place );
+
+    // Newlines before place end the lines before the line place is on.
+    ::std::vector< const char * >::const_iterator it =
+        ::std::lower_bound( m_newLines.begin(), m_newLines.end(), place );
+    const unsigned long before = static_cast< unsigned long >( it - m_newLines.begin() );
+    const char * lineStart = ( 0 == before ) ? m_begin : m_newLines[ before - 1 ] + 1;
+    line = before + 1;
+    column = static_cast< unsigned long >( place - lineStart ) + 1;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
@@ -53,8 +53,8 @@ namespace Parser
 // ----------------------------------------------------------------------------
 
 ContentStack::ContentInfo::ContentInfo( void ) :
-    m_content(),
-    m_section(),
+    m_content( NULL ),
+    m_section( NULL ),
     m_line( 0 ),
     m_char( 0 )
 {
@@ -73,8 +73,8 @@ ContentStack::ContentInfo::~ContentInfo( void )
 void ContentStack::ContentInfo::Clear( void )
 {
     assert( this != NULL );
-    m_content.clear(),
-    m_section.clear(),
+    m_content = NULL;
+    m_section = NULL;
     m_line = 0;
     m_char = 0;
 }
@@ -83,7 +83,8 @@ void ContentStack::ContentInfo::Clear( void )
 
 ContentStack::ContentStack( IStackMessagePreparer * pPreparer ) :
     m_pPreparer( pPreparer ),
-    m_stackIndex( EmptySpot )
+    m_stackIndex( EmptySpot ),
+    m_messageStack()
 {
     assert( this != NULL );
 }
@@ -102,11 +103,11 @@ void ContentStack::Clear( void )
     assert( this != NULL );
 
     ContentInfo * pInfo = NULL;
-    signed int ii = 0;
+    signed long ii = 0;
 
     if ( EmptySpot != m_stackIndex )
     {
-        assert( m_stackIndex < MaxStackSize );
+        assert( static_cast< unsigned long >( m_stackIndex ) < m_messageStack.size() );
         assert( 0 <= m_stackIndex );
         for ( ; ii <= m_stackIndex; ++ii )
         {
@@ -125,15 +126,18 @@ void ContentStack::Push( const CharType * content, const CharType * section,
 {
     assert( this != NULL );
 
-    if ( TopPlace <= m_stackIndex )
-        return;
     if ( NULL == content )
         content = reinterpret_cast< const Parser::CharType * >( "" );
+    if ( NULL == section )
+        section = reinterpret_cast< const Parser::CharType * >( "" );
     ++m_stackIndex;
-    m_messageStack[ m_stackIndex ].m_content = content;
-    m_messageStack[ m_stackIndex ].m_section = section;
-    m_messageStack[ m_stackIndex ].m_line = line;
-    m_messageStack[ m_stackIndex ].m_char = chars;
+    if ( m_messageStack.size() <= static_cast< unsigned long >( m_stackIndex ) )
+        m_messageStack.push_back( ContentInfo() );
+    ContentInfo & info = m_messageStack[ m_stackIndex ];
+    info.m_content = content;
+    info.m_section = section;
+    info.m_line = line;
+    info.m_char = chars;
 }
 
 // ----------------------------------------------------------------------------
@@ -142,10 +146,9 @@ const CharType * ContentStack::GetContentAt( unsigned long index ) const
 {
     assert( this != NULL );
 
-    if ( ( GetStackSize() <= index )
-      || ( index < MaxStackSize ) )
+    if ( GetStackSize() <= index )
         return NULL;
-    return m_messageStack[ index ].m_content.c_str();
+    return m_messageStack[ index ].m_content;
 }
 
 // ----------------------------------------------------------------------------
@@ -154,10 +157,9 @@ const CharType * ContentStack::GetSectionAt( unsigned long index ) const
 {
     assert( this != NULL );
 
-    if ( ( GetStackSize() <= index )
-      || ( index < MaxStackSize ) )
+    if ( GetStackSize() <= index )
         return NULL;
-    return m_messageStack[ index ].m_section.c_str();
+    return m_messageStack[ index ].m_section;
 }
 
 // ----------------------------------------------------------------------------
@@ -166,8 +168,7 @@ unsigned long ContentStack::GetLineAt( unsigned long index ) const
 {
     assert( this != NULL );
 
-    if ( ( GetStackSize() <= index )
-      || ( index < MaxStackSize ) )
+    if ( GetStackSize() <= index )
         return 0;
     return m_messageStack[ index ].m_line;
 }
@@ -178,8 +179,7 @@ unsigned long ContentStack::GetCharColAt( unsigned long index ) const
 {
     assert( this != NULL );
 
-    if ( ( GetStackSize() <= index )
-      || ( index < MaxStackSize ) )
+    if ( GetStackSize() <= index )
         return 0;
     return m_messageStack[ index ].m_char;
 }
@@ -200,17 +200,16 @@ bool ContentStack::OutputSubsetStack( unsigned long levels ) const
     for ( signed long index = m_stackIndex;
         ( index > EmptySpot ) && ( levels > 0 ) && ( okay ); --index, --levels )
     {
-        section = m_messageStack[ index ].m_section.c_str();
-        const StringType & name = m_messageStack[ index ].m_content;
+        section = m_messageStack[ index ].m_section;
+        cname = m_messageStack[ index ].m_content;
         line = m_messageStack[ index ].m_line;
 
-        if ( name.empty() )
+        if ( '\0' == *cname )
         {
             okay = m_pPreparer->PrepareContentMessage( section );
             continue;
         }
 
-        cname = name.c_str();
         if ( 0 == line )
             okay = m_pPreparer->PrepareContentMessage( section, cname );
         else
@@ -233,7 +232,9 @@ bool MessageStack::s_debug = false;
 MessageStack::MessageStack( IStackMessagePreparer * pPreparer ) :
     m_pPreparer( pPreparer ),
     m_highestLevel( Parser::ErrorLevel::None ),
-    m_stackIndex( EmptySpot )
+    m_stackIndex( EmptySpot ),
+    m_sendPlace( NULL ),
+    m_messageStack()
 {
     DEBUG_CODE( CheckInvariants() );
 }
@@ -253,11 +254,11 @@ void MessageStack::Clear( void )
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
 
     MessageInfo * pInfo = NULL;
-    signed int ii = 0;
+    signed long ii = 0;
 
     if ( EmptySpot != m_stackIndex )
     {
-        assert( m_stackIndex < MaxStackSize );
+        assert( static_cast< unsigned long >( m_stackIndex ) < m_messageStack.size() );
         assert( 0 <= m_stackIndex );
         for ( ; ii <= m_stackIndex; ++ii )
         {
@@ -290,25 +291,21 @@ void MessageStack::DebugOutput( const char * function ) const
 // ----------------------------------------------------------------------------
 
 void MessageStack::Push( Parser::ErrorLevel::Levels level, const CharType * message,
-    const char * file, const char * ruleName )
+    const char * file, const char * ruleName, const CharType * place )
 {
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
     assert( ( 0 <= m_stackIndex ) || ( EmptySpot == m_stackIndex ) );
-    assert( m_stackIndex <= TopPlace );
 
-    if ( TopPlace <= m_stackIndex )
-    {
-        // Perhaps this should throw an excecption to show the stack is too small.
-        // Or increase the stack size?
-        return;
-    }
     ++m_stackIndex;
+    if ( m_messageStack.size() <= static_cast< unsigned long >( m_stackIndex ) )
+        m_messageStack.push_back( MessageInfo() );
     MessageInfo & info = m_messageStack[ m_stackIndex ];
     info.m_message = message;
     info.m_level = level;
     info.m_file = file;
     info.m_ruleName = ruleName;
+    info.m_place = place;
 
     DEBUG_CODE( if ( IsDebugging() ) DebugOutput( __FUNCTION__ ); );
 }
@@ -316,18 +313,20 @@ void MessageStack::Push( Parser::ErrorLevel::Levels level, const CharType * mess
 // ----------------------------------------------------------------------------
 
 void MessageStack::Prepare( Parser::ErrorLevel::Levels level, const CharType * message,
-    const char * file, const char * ruleName )
+    const char * file, const char * ruleName, const CharType * place )
 {
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
     assert( 0 <= m_stackIndex );
-    assert( m_stackIndex <= TopPlace );
 
+    if ( m_stackIndex < 0 )
+        return;
     MessageInfo & info = m_messageStack[ m_stackIndex ];
     info.m_message = message;
     info.m_level = level;
     info.m_file = file;
     info.m_ruleName = ruleName;
+    info.m_place = place;
 
     DEBUG_CODE( if ( IsDebugging() ) DebugOutput( __FUNCTION__ ); );
 }
@@ -339,10 +338,8 @@ void MessageStack::Cancel( void )
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
     assert( 0 <= m_stackIndex );
-    assert( m_stackIndex <= TopPlace );
 
-    if ( ( m_stackIndex < 0 )
-      || ( TopPlace < m_stackIndex ) )
+    if ( m_stackIndex < 0 )
         return;
 
     DEBUG_CODE( if ( IsDebugging() ) DebugOutput( __FUNCTION__ ); );
@@ -358,10 +355,8 @@ void MessageStack::Pop( void )
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
     assert( 0 <= m_stackIndex );
-    assert( m_stackIndex <= TopPlace );
 
-    if ( ( m_stackIndex < 0 )
-      || ( TopPlace < m_stackIndex ) )
+    if ( m_stackIndex < 0 )
         return;
 
     DEBUG_CODE( if ( IsDebugging() ) DebugOutput( __FUNCTION__ ); );
@@ -373,24 +368,47 @@ void MessageStack::Pop( void )
 
 // ----------------------------------------------------------------------------
 
+void MessageStack::Unwind( unsigned long size, Parser::ErrorLevel::Levels level,
+    const CharType * message, const CharType * place )
+{
+    DEBUG_CODE( CheckInvariants() );
+    DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
+
+    if ( GetStackSize() <= size )
+    {
+        Send( level, message, place );
+        return;
+    }
+
+    DEBUG_CODE( if ( IsDebugging() ) DebugOutput( __FUNCTION__ ); );
+
+    Send();
+    while ( size < GetStackSize() )
+    {
+        m_messageStack[ m_stackIndex ].Clear();
+        --m_stackIndex;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 bool MessageStack::Send( void )
 {
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
     assert( 0 <= m_stackIndex );
-    assert( m_stackIndex <= TopPlace );
 
-    if ( ( m_stackIndex < 0 )
-      || ( TopPlace < m_stackIndex ) )
+    if ( m_stackIndex < 0 )
         return false;
 
     MessageInfo & r( m_messageStack[ m_stackIndex ] );
-    return Send( r.m_level, r.m_message );
+    return Send( r.m_level, r.m_message, r.m_place );
 }
 
 // ----------------------------------------------------------------------------
 
-bool MessageStack::Send( Parser::ErrorLevel::Levels level, const CharType * message )
+bool MessageStack::Send( Parser::ErrorLevel::Levels level, const CharType * message,
+    const CharType * place )
 {
     DEBUG_CODE( CheckInvariants() );
     DEBUG_CODE( InvariantChecker guard( this ); (void)guard; );
@@ -406,7 +424,10 @@ bool MessageStack::Send( Parser::ErrorLevel::Levels level, const CharType * mess
     {
         m_highestLevel = level;
     }
-    return DoSend( level, message );
+    m_sendPlace = place;
+    const bool sent = DoSend( level, message );
+    m_sendPlace = NULL;
+    return sent;
 }
 
 // ----------------------------------------------------------------------------
@@ -488,14 +509,14 @@ void MessageStack::CheckInvariants( void ) const
 {
     assert( this != NULL );
     assert( EmptySpot <= m_stackIndex );
-    assert( m_stackIndex < MaxStackSize );
+    const signed long size = static_cast< signed long >( m_messageStack.size() );
+    assert( m_stackIndex < size );
 
     const MessageInfo * pInfo = NULL;
-    signed int ii = 0;
+    signed long ii = 0;
 
     if ( EmptySpot != m_stackIndex )
     {
-        assert( m_stackIndex < MaxStackSize );
         assert( 0 <= m_stackIndex );
         for ( ; ii <= m_stackIndex; ++ii )
         {
@@ -505,7 +526,7 @@ void MessageStack::CheckInvariants( void ) const
         }
     }
 
-    for ( ; ii < MaxStackSize; ++ii )
+    for ( ; ii < size; ++ii )
     {
         pInfo = &( m_messageStack[ ii ] );
         assert( pInfo->m_message == NULL );
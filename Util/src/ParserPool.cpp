@@ -0,0 +1,417 @@
+// ----------------------------------------------------------------------------
+// The Parser Utility Library
+// Copyright (c) 2005, 2006, 2007, 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ParserPool.cpp Contains functions for ParserPoolBase class.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/ParserPool.hpp"
+
+#include <assert.h>
+
+#include <vector>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sys/time.h>
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+#if defined( _WIN32 )
+    typedef DWORD ThreadId;
+#else
+    typedef pthread_t ThreadId;
+#endif
+
+// ----------------------------------------------------------------------------
+
+inline ThreadId GetThreadId( void )
+{
+#if defined( _WIN32 )
+    return ::GetCurrentThreadId();
+#else
+    return ::pthread_self();
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+inline bool IsSameThread( ThreadId left, ThreadId right )
+{
+#if defined( _WIN32 )
+    return ( left == right );
+#else
+    return ( 0 != ::pthread_equal( left, right ) );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns a time in microseconds, only useful for finding elapsed times.
+unsigned long GetMicroseconds( void )
+{
+#if defined( _WIN32 )
+    return static_cast< unsigned long >( ::GetTickCount() ) * 1000;
+#else
+    timeval now;
+    ::gettimeofday( &now, NULL );
+    return static_cast< unsigned long >( now.tv_sec ) * 1000000
+        + static_cast< unsigned long >( now.tv_usec );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+/// A parser waiting in the pool, and the thread which returned it.
+struct IdleParser
+{
+    void * m_parser;
+    ThreadId m_thread;
+};
+
+typedef ::std::vector< IdleParser > IdleParsers;
+
+}; // end anonymous namespace
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+
+// ----------------------------------------------------------------------------
+
+class ParserPoolBase::Impl
+{
+public:
+
+    explicit Impl( unsigned long maxCount );
+
+    ~Impl( void );
+
+    inline void Lock( void )
+    {
+#if defined( _WIN32 )
+        ::EnterCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_lock( &m_lock );
+#endif
+    }
+
+    inline void Unlock( void )
+    {
+#if defined( _WIN32 )
+        ::LeaveCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_unlock( &m_lock );
+#endif
+    }
+
+    /// Unlocks until woken by Signal, then locks again.  May wake early.
+    inline void Wait( void )
+    {
+#if defined( _WIN32 )
+        ++m_waiting;
+        Unlock();
+        ::WaitForSingleObject( m_returned, INFINITE );
+        Lock();
+        --m_waiting;
+#else
+        ::pthread_cond_wait( &m_returned, &m_lock );
+#endif
+    }
+
+    /// Holds the lock until destroyed.
+    class ScopedLock
+    {
+    public:
+        inline explicit ScopedLock( Impl & impl ) : m_impl( impl )
+        {
+            m_impl.Lock();
+        }
+        inline ~ScopedLock( void )
+        {
+            m_impl.Unlock();
+        }
+    private:
+        /// Not implemented.
+        ScopedLock( const ScopedLock & );
+        /// Not implemented.
+        ScopedLock & operator = ( const ScopedLock & );
+        Impl & m_impl;
+    };
+
+    /// Wakes one waiting thread.  Called with the lock held.
+    inline void Signal( void )
+    {
+#if defined( _WIN32 )
+        if ( 0 < m_waiting )
+            ::ReleaseSemaphore( m_returned, 1, NULL );
+#else
+        ::pthread_cond_signal( &m_returned );
+#endif
+    }
+
+#if defined( _WIN32 )
+    CRITICAL_SECTION m_lock;
+    /** Semaphore released once for each returned parser, so returns which come
+     close together each wake a waiting thread.  An event would merge them
+     into one wakeup and leave the other threads waiting.
+     */
+    HANDLE m_returned;
+    /// Threads inside Wait, so nothing is released when none are waiting.
+    unsigned long m_waiting;
+#else
+    pthread_mutex_t m_lock;
+    pthread_cond_t m_returned;
+#endif
+
+    IdleParsers m_idle;
+    const unsigned long m_maxCount;
+    /// Parsers made and not yet destroyed, including any being made now.
+    unsigned long m_count;
+    unsigned long m_leased;
+    ParserPoolStats m_stats;
+
+private:
+
+    /// Not implemented.
+    Impl( const Impl & );
+    /// Not implemented.
+    Impl & operator = ( const Impl & );
+
+};
+
+// ----------------------------------------------------------------------------
+
+ParserPoolBase::Impl::Impl( unsigned long maxCount ) :
+#if defined( _WIN32 )
+    m_lock(),
+    m_returned( ::CreateSemaphore( NULL, 0, MAXLONG, NULL ) ),
+    m_waiting( 0 ),
+#else
+    m_lock(),
+    m_returned(),
+#endif
+    m_idle(),
+    m_maxCount( maxCount ),
+    m_count( 0 ),
+    m_leased( 0 ),
+    m_stats()
+{
+    assert( NULL != this );
+#if defined( _WIN32 )
+    ::InitializeCriticalSection( &m_lock );
+#else
+    ::pthread_mutex_init( &m_lock, NULL );
+    ::pthread_cond_init( &m_returned, NULL );
+#endif
+    m_stats.m_leases = 0;
+    m_stats.m_hits = 0;
+    m_stats.m_threadHits = 0;
+    m_stats.m_misses = 0;
+    m_stats.m_waits = 0;
+    m_stats.m_waitTime = 0;
+    m_stats.m_mostLeased = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+ParserPoolBase::Impl::~Impl( void )
+{
+    assert( NULL != this );
+#if defined( _WIN32 )
+    ::CloseHandle( m_returned );
+    ::DeleteCriticalSection( &m_lock );
+#else
+    ::pthread_cond_destroy( &m_returned );
+    ::pthread_mutex_destroy( &m_lock );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+ParserPoolBase::ParserPoolBase( unsigned long maxCount ) :
+    m_impl( new Impl( maxCount ) )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ParserPoolBase::~ParserPoolBase( void )
+{
+    assert( NULL != this );
+    assert( NULL != m_impl );
+    // Derived class must destroy idle parsers, since it knows their type.
+    assert( m_impl->m_idle.empty() );
+    assert( 0 == m_impl->m_leased );
+    delete m_impl;
+}
+
+// ----------------------------------------------------------------------------
+
+ParserPoolStats ParserPoolBase::GetStats( void ) const
+{
+    assert( NULL != this );
+    Impl::ScopedLock lock( *m_impl );
+    return m_impl->m_stats;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ParserPoolBase::GetMaxCount( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_maxCount;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ParserPoolBase::GetIdleCount( void ) const
+{
+    assert( NULL != this );
+    Impl::ScopedLock lock( *m_impl );
+    return static_cast< unsigned long >( m_impl->m_idle.size() );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long ParserPoolBase::GetLeasedCount( void ) const
+{
+    assert( NULL != this );
+    Impl::ScopedLock lock( *m_impl );
+    return m_impl->m_leased;
+}
+
+// ----------------------------------------------------------------------------
+
+void * ParserPoolBase::LeaseParser( bool wait )
+{
+    assert( NULL != this );
+    Impl & impl = *m_impl;
+    const ThreadId thread = GetThreadId();
+    {
+        Impl::ScopedLock lock( impl );
+        bool waited = false;
+        unsigned long waitStart = 0;
+        while ( impl.m_idle.empty()
+            && ( 0 != impl.m_maxCount ) && ( impl.m_maxCount <= impl.m_count ) )
+        {
+            if ( !wait )
+                return NULL;
+            if ( !waited )
+            {
+                waited = true;
+                waitStart = GetMicroseconds();
+                ++impl.m_stats.m_waits;
+            }
+            impl.Wait();
+        }
+        if ( waited )
+            impl.m_stats.m_waitTime += GetMicroseconds() - waitStart;
+
+        ++impl.m_stats.m_leases;
+        ++impl.m_leased;
+        if ( impl.m_stats.m_mostLeased < impl.m_leased )
+            impl.m_stats.m_mostLeased = impl.m_leased;
+
+        if ( !impl.m_idle.empty() )
+        {
+            ++impl.m_stats.m_hits;
+            // Most recently returned parsers are at the back, so search from
+            // there for the one this thread used last.
+            IdleParsers::iterator it( impl.m_idle.end() );
+            while ( it != impl.m_idle.begin() )
+            {
+                --it;
+                if ( IsSameThread( it->m_thread, thread ) )
+                {
+                    ++impl.m_stats.m_threadHits;
+                    void * parser = it->m_parser;
+                    impl.m_idle.erase( it );
+                    return parser;
+                }
+            }
+            void * parser = impl.m_idle.back().m_parser;
+            impl.m_idle.pop_back();
+            return parser;
+        }
+
+        // Reserve a place for the new parser so no other thread goes past the
+        // limit while this one makes it outside the lock.
+        ++impl.m_stats.m_misses;
+        ++impl.m_count;
+    }
+
+    try
+    {
+        return MakeParser();
+    }
+    catch ( ... )
+    {
+        Impl::ScopedLock lock( impl );
+        --impl.m_count;
+        --impl.m_leased;
+        impl.Signal();
+        throw;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void ParserPoolBase::ReturnParser( void * parser )
+{
+    assert( NULL != this );
+    if ( NULL == parser )
+        return;
+    IdleParser idle;
+    idle.m_parser = parser;
+    idle.m_thread = GetThreadId();
+    Impl::ScopedLock lock( *m_impl );
+    assert( 0 < m_impl->m_leased );
+    --m_impl->m_leased;
+    m_impl->m_idle.push_back( idle );
+    m_impl->Signal();
+}
+
+// ----------------------------------------------------------------------------
+
+void ParserPoolBase::DestroyIdleParsers( void )
+{
+    assert( NULL != this );
+    IdleParsers idle;
+    {
+        Impl::ScopedLock lock( *m_impl );
+        idle.swap( m_impl->m_idle );
+        m_impl->m_count -= static_cast< unsigned long >( idle.size() );
+    }
+    for ( IdleParsers::iterator it( idle.begin() ); it != idle.end(); ++it )
+        DestroyParser( it->m_parser );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
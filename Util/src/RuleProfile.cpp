@@ -0,0 +1,280 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file RuleProfile.cpp Counts how often and how long each grammar rule runs.
+
+
+// ----------------------------------------------------------------------------
+
+#include "../include/RuleProfile.hpp"
+
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+    #include <intrin.h>
+    #define PARSER_READ_CYCLES() ::__rdtsc()
+#elif defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    #include <x86intrin.h>
+    #define PARSER_READ_CYCLES() ::__rdtsc()
+#endif
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+
+namespace
+{
+
+typedef ::std::deque< ::Parser::RuleCounts > RuleList;
+
+// ----------------------------------------------------------------------------
+
+/// Counts of every rule, and the lock which guards adding more.
+class Registry
+{
+public:
+
+    Registry( void ) : m_rules()
+    {
+#if defined( _WIN32 )
+        ::InitializeCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_init( &m_lock, NULL );
+#endif
+    }
+
+    ~Registry( void )
+    {
+#if defined( _WIN32 )
+        ::DeleteCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_destroy( &m_lock );
+#endif
+    }
+
+    inline void Lock( void )
+    {
+#if defined( _WIN32 )
+        ::EnterCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_lock( &m_lock );
+#endif
+    }
+
+    inline void Unlock( void )
+    {
+#if defined( _WIN32 )
+        ::LeaveCriticalSection( &m_lock );
+#else
+        ::pthread_mutex_unlock( &m_lock );
+#endif
+    }
+
+    /// A deque, so counts never move once added.
+    RuleList m_rules;
+
+private:
+
+    /// Not implemented.
+    Registry( const Registry & );
+    /// Not implemented.
+    Registry & operator = ( const Registry & );
+
+#if defined( _WIN32 )
+    CRITICAL_SECTION m_lock;
+#else
+    pthread_mutex_t m_lock;
+#endif
+};
+
+// ----------------------------------------------------------------------------
+
+Registry & GetRegistry( void )
+{
+    static Registry registry;
+    return registry;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns file name without its directories.
+const char * GetBaseName( const char * file )
+{
+    const char * slash = ::strrchr( file, '/' );
+    const char * backslash = ::strrchr( file, '\\' );
+    if ( ( NULL == slash ) || ( ( NULL != backslash ) && ( slash < backslash ) ) )
+        slash = backslash;
+    return ( NULL == slash ) ? file : slash + 1;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Puts slower rules first.
+struct SlowerRule
+{
+    inline bool operator () ( const ::Parser::RuleCounts * left,
+        const ::Parser::RuleCounts * right ) const
+    {
+        return ( right->m_cycles < left->m_cycles );
+    }
+};
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+// ----------------------------------------------------------------------------
+
+bool RuleProfile::IsEnabled( void )
+{
+#if defined( PARSER_RULE_PROFILE )
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+RuleCounts & RuleProfile::Register( const char * name, const char * file,
+    unsigned long line )
+{
+    assert( NULL != name );
+    assert( NULL != file );
+
+    Registry & registry = GetRegistry();
+    file = GetBaseName( file );
+    registry.Lock();
+    RuleList & rules = registry.m_rules;
+    for ( RuleList::iterator it( rules.begin() ); it != rules.end(); ++it )
+    {
+        if ( ( line == it->m_line ) && ( 0 == ::strcmp( file, it->m_file ) )
+          && ( 0 == ::strcmp( name, it->m_name ) ) )
+        {
+            registry.Unlock();
+            return *it;
+        }
+    }
+    RuleCounts counts;
+    ::memset( &counts, 0, sizeof( counts ) );
+    counts.m_name = name;
+    counts.m_file = file;
+    counts.m_line = line;
+    rules.push_back( counts );
+    RuleCounts & added = rules.back();
+    registry.Unlock();
+    return added;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long RuleProfile::GetCount( void )
+{
+    return static_cast< unsigned long >( GetRegistry().m_rules.size() );
+}
+
+// ----------------------------------------------------------------------------
+
+const RuleCounts & RuleProfile::GetCounts( unsigned long index )
+{
+    assert( index < GetCount() );
+    return GetRegistry().m_rules[ index ];
+}
+
+// ----------------------------------------------------------------------------
+
+void RuleProfile::Reset( void )
+{
+    RuleList & rules = GetRegistry().m_rules;
+    for ( RuleList::iterator it( rules.begin() ); it != rules.end(); ++it )
+    {
+        RuleCounts & counts = *it;
+        counts.m_entries = 0;
+        counts.m_matches = 0;
+        counts.m_fails = 0;
+        counts.m_bytes = 0.0;
+        counts.m_backtracked = 0.0;
+        counts.m_cycles = 0.0;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void RuleProfile::Write( ostream & out )
+{
+    RuleList & rules = GetRegistry().m_rules;
+    vector< const RuleCounts * > tried;
+    for ( RuleList::const_iterator it( rules.begin() ); it != rules.end(); ++it )
+    {
+        if ( 0 < it->m_entries )
+            tried.push_back( &( *it ) );
+    }
+    ::std::stable_sort( tried.begin(), tried.end(), SlowerRule() );
+
+    out << "rule,file,line,entries,matches,fails,bytes,backtracked,cycles\n";
+    const ios::fmtflags oldFlags = out.flags();
+    out << fixed << setprecision( 0 );
+    for ( vector< const RuleCounts * >::const_iterator it( tried.begin() );
+        it != tried.end(); ++it )
+    {
+        const RuleCounts & counts = **it;
+        out << counts.m_name
+            << ',' << counts.m_file
+            << ',' << counts.m_line
+            << ',' << counts.m_entries
+            << ',' << counts.m_matches
+            << ',' << counts.m_fails
+            << ',' << counts.m_bytes
+            << ',' << counts.m_backtracked
+            << ',' << counts.m_cycles
+            << "\n";
+    }
+    out.flags( oldFlags );
+    out.flush();
+}
+
+// ----------------------------------------------------------------------------
+
+CycleCount RuleProfile::ReadCycles( void )
+{
+#if defined( PARSER_READ_CYCLES )
+    return static_cast< CycleCount >( PARSER_READ_CYCLES() );
+#else
+    return static_cast< CycleCount >( ::clock() );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Parser
+
+// $Log: $
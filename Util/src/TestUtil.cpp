@@ -20,6 +20,9 @@
 #include "../include/TestUtil.hpp"
 
 #include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
 #include <iostream>
 
 
@@ -224,6 +227,102 @@ bool Parser::TestBase::DoOneTest( const TestData & rData, unsigned long i )
 
 // ----------------------------------------------------------------------------
 
+bool Parser::QuietReceiver::ReceiveParseMessage( const ParseMessage & )
+{
+    assert( this != NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::QuietReceiver::GiveParseMessage( Parser::ErrorLevel::Levels,
+    const CharType * )
+{
+    assert( this != NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::QuietReceiver::GiveParseMessage( Parser::ErrorLevel::Levels,
+    const CharType *, unsigned long )
+{
+    assert( this != NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::QuietReceiver::GiveParseMessage( Parser::ErrorLevel::Levels,
+    const CharType *, const char *, unsigned long )
+{
+    assert( this != NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+Parser::TestChecker::TestChecker( const char * name ) :
+    m_name( name ),
+    m_failCount( 0 ),
+    m_passCount( 0 )
+{
+    assert( this != NULL );
+    assert( NULL != name );
+}
+
+// ----------------------------------------------------------------------------
+
+Parser::TestChecker::~TestChecker( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::TestChecker::Check( bool passed, const char * what )
+{
+    assert( this != NULL );
+    if ( passed )
+    {
+        ++m_passCount;
+        return true;
+    }
+    ++m_failCount;
+    cout << m_name << " check failed: " << what << '\n';
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::TestChecker::ShowSummary( bool showSummary ) const
+{
+    assert( this != NULL );
+    const bool passed = ( 0 == m_failCount );
+    if ( showSummary || !passed )
+    {
+        cout << m_name << " Checks:\tPassed: [" << m_passCount << "]\tFailed: ["
+            << m_failCount << "]\n";
+    }
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Parser::WriteTestFile( const char * filename, const char * text )
+{
+    assert( NULL != filename );
+    assert( NULL != text );
+    FILE * file = ::fopen( filename, "wb" );
+    if ( NULL == file )
+        return false;
+    const size_t size = ::strlen( text );
+    const bool wrote = ( size == ::fwrite( text, 1, size, file ) );
+    return ( 0 == ::fclose( file ) ) && wrote;
+}
+
+// ----------------------------------------------------------------------------
+
 // $Log: TestUtil.cpp,v $
 // Revision 1.2  2009/01/05 19:25:48  rich_sposato
 // Replaced tabs with spaces.
@@ -68,12 +68,12 @@ const TestData s_commentTestCases[] =
     { ParseInfo::AllValid,  "<!--\rabcd\r-->" },
     { ParseInfo::SomeValid, "<!-- a --> def" },
     { ParseInfo::SomeValid, "<!-- a --> " },
-    { ParseInfo::NotParsed, "<!-- abcd --->" },
-    { ParseInfo::NotParsed, "<!-- abcd ->" },
-    { ParseInfo::NotParsed, "<!-- ab -- d -->" },
-    { ParseInfo::NotParsed, "<!-- abc -- >" },
-    { ParseInfo::NotParsed, "<!------>" },
-    { ParseInfo::NotParsed, "<!-- -- -->" },
+    { ParseInfo::NotValid,  "<!-- abcd --->" },
+    { ParseInfo::NotValid,  "<!-- abcd ->" },
+    { ParseInfo::NotValid,  "<!-- ab -- d -->" },
+    { ParseInfo::NotValid,  "<!-- abc -- >" },
+    { ParseInfo::NotValid,  "<!------>" },
+    { ParseInfo::NotValid,  "<!-- -- -->" },
     { ParseInfo::NotParsed, "<!- abcd -->" },
     { ParseInfo::NotParsed, "<-- -->" },
     { ParseInfo::NotParsed, "<<-- -->" },
@@ -179,10 +179,10 @@ const TestData s_nameTestCases[] =
     { ParseInfo::NotParsed, "\"abc\".\"a" },
     { ParseInfo::NotParsed, "\"abc\"." },
     { ParseInfo::NotParsed, " starts with space" },
-    { ParseInfo::NotParsed, "^&l( " },
+    { ParseInfo::NotValid,  "^&l( " },
     { ParseInfo::NotParsed, "\"" },
     { ParseInfo::NotParsed, "\" " },
-    { ParseInfo::NotParsed, "1" },
+    { ParseInfo::NotValid,  "1" },
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -261,20 +261,20 @@ const TestData s_referenceTestCases[] =
     { ParseInfo::AllValid,  "&#xab;" }, // value is a hexdigit-reference.
     { ParseInfo::AllValid,  "&#xAB;" }, // value is a hexdigit-reference.
     { ParseInfo::AllValid,  "&#xF0;" }, // value is a hexdigit-reference.
-    { ParseInfo::NotParsed, "&000;" },  // invalid entity-reference value.
-    { ParseInfo::NotParsed, "&#abc;" }, // value is an entity-reference, but prefix is digit-ref.
-    { ParseInfo::NotParsed, "&#xFz;" }, // invalid hexdigit-reference value.
-    { ParseInfo::NotParsed, "&#abc;" }, // prefix for digit-ref, but value is hexdigit-reference.
+    { ParseInfo::NotValid,  "&000;" },  // invalid entity-reference value.
+    { ParseInfo::NotValid,  "&#abc;" }, // value is an entity-reference, but prefix is digit-ref.
+    { ParseInfo::NotValid,  "&#xFz;" }, // invalid hexdigit-reference value.
+    { ParseInfo::NotValid,  "&#abc;" }, // prefix for digit-ref, but value is hexdigit-reference.
     { ParseInfo::NotParsed, "&;" },     // value is missing an entity-reference.
     { ParseInfo::NotParsed, "& abc;" }, // value of entity-reference has extra space.
     { ParseInfo::NotParsed, " &abc;" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "&abc ;" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "&ab c;" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "&abc" },   // value with entity-reference is missing a semicolon.
-    { ParseInfo::NotParsed, "&# 000;" }, // value of digit-reference has extra space.
-    { ParseInfo::NotParsed, "&# x00;" }, // value of hexdigit-reference has extra space.
-    { ParseInfo::NotParsed, "&#000 ;" }, // value of digit-reference has extra space.
-    { ParseInfo::NotParsed, "&#x00 ;" }, // value of hexdigit-reference has extra space.
+    { ParseInfo::NotValid,  "&abc ;" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "&ab c;" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "&abc" },   // value with entity-reference is missing a semicolon.
+    { ParseInfo::NotValid,  "&# 000;" }, // value of digit-reference has extra space.
+    { ParseInfo::NotValid,  "&# x00;" }, // value of hexdigit-reference has extra space.
+    { ParseInfo::NotValid,  "&#000 ;" }, // value of digit-reference has extra space.
+    { ParseInfo::NotValid,  "&#x00 ;" }, // value of hexdigit-reference has extra space.
     { ParseInfo::NotParsed, "& #000;" }, // value of digit-reference has extra space.
     { ParseInfo::NotParsed, "& #x00;" }, // value of hexdigit-reference has extra space.
     { ParseInfo::NotParsed, " &#000;" }, // value of digit-reference has extra space.
@@ -380,15 +380,15 @@ const TestData s_attributeValueTestCases[] =
     { ParseInfo::AllValid,  "\"&#000;\"" }, // test single-quoted attribute with value.
     { ParseInfo::NotParsed, "\'&;\'" },     // value is missing an entity-reference.
     { ParseInfo::NotParsed, "\'& abc;\'" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "\'&abc ;\'" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "\'&abc\'" },   // value with entity-reference is missing a semicolon.
+    { ParseInfo::NotValid,  "\'&abc ;\'" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "\'&abc\'" },   // value with entity-reference is missing a semicolon.
     { ParseInfo::NotParsed, "\'b" },        // invalid if no ending single-quote.
     { ParseInfo::NotParsed, "\"b" },        // invalid if no ending double-quote.
-    { ParseInfo::NotParsed, "b\'" },        // invalid if no starting single-quote.
-    { ParseInfo::NotParsed, "b\"" },        // invalid if no starting double-quote.
+    { ParseInfo::NotValid,  "b\'" },        // invalid if no starting single-quote.
+    { ParseInfo::NotValid,  "b\"" },        // invalid if no starting double-quote.
     { ParseInfo::NotParsed, "\"b\'" },      // invalid if starting quote does not match ending quote.
     { ParseInfo::NotParsed, "\'b\"" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "A" },          // invalid if name only.
+    { ParseInfo::NotValid,  "A" },          // invalid if name only.
     { ParseInfo::NotParsed, "\'" },         // invalid if nothing after single-quote.
     { ParseInfo::NotParsed, "\"" },         // invalid if nothing after double-quote.
     { ParseInfo::CantStart, "" },           // invalid if empty.
@@ -530,21 +530,21 @@ const TestData s_attributeTestCases[] =
     { ParseInfo::AllValid,  "a=\"b&#xbc;\"" },  // test single-quoted attribute with value and reference.
     { ParseInfo::AllValid,  "a=\"&#000;&#xbc;\"" },  // test single-quoted attribute with value and reference.
     { ParseInfo::AllValid,  "a=\"&#000;\"" },  // test single-quoted attribute with value.
-    { ParseInfo::NotParsed, "a=\'&;\'" },     // value is missing an entity-reference.
-    { ParseInfo::NotParsed, "a=\'& abc;\'" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "a=\'&abc ;\'" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "a=\'&abc\'" },   // value with entity-reference is missing a semicolon.
-    { ParseInfo::NotParsed, "a=\'b" },        // invalid if no ending single-quote.
-    { ParseInfo::NotParsed, "a=\"b" },        // invalid if no ending double-quote.
-    { ParseInfo::NotParsed, "a=b\'" },        // invalid if no starting single-quote.
-    { ParseInfo::NotParsed, "a=b\"" },        // invalid if no starting double-quote.
-    { ParseInfo::NotParsed, "a\"b\"" },       // invalid if no equal sign.
-    { ParseInfo::NotParsed, "a=\"b\'" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "a=\'b\"" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "A" },            // invalid if name only.
-    { ParseInfo::NotParsed, "ab=" },          // invalid if nothing after equal sign.
-    { ParseInfo::NotParsed, "ab= \'" },       // invalid if nothing after single-quote.
-    { ParseInfo::NotParsed, "ab=\"" },        // invalid if nothing after double-quote.
+    { ParseInfo::NotValid,  "a=\'&;\'" },     // value is missing an entity-reference.
+    { ParseInfo::NotValid,  "a=\'& abc;\'" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "a=\'&abc ;\'" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "a=\'&abc\'" },   // value with entity-reference is missing a semicolon.
+    { ParseInfo::NotValid,  "a=\'b" },        // invalid if no ending single-quote.
+    { ParseInfo::NotValid,  "a=\"b" },        // invalid if no ending double-quote.
+    { ParseInfo::NotValid,  "a=b\'" },        // invalid if no starting single-quote.
+    { ParseInfo::NotValid,  "a=b\"" },        // invalid if no starting double-quote.
+    { ParseInfo::NotValid,  "a\"b\"" },       // invalid if no equal sign.
+    { ParseInfo::NotValid,  "a=\"b\'" },      // invalid if starting quote does not match ending quote.
+    { ParseInfo::NotValid,  "a=\'b\"" },      // invalid if starting quote does not match ending quote.
+    { ParseInfo::NotValid,  "A" },            // invalid if name only.
+    { ParseInfo::NotValid,  "ab=" },          // invalid if nothing after equal sign.
+    { ParseInfo::NotValid,  "ab= \'" },       // invalid if nothing after single-quote.
+    { ParseInfo::NotValid,  "ab=\"" },        // invalid if nothing after double-quote.
     { ParseInfo::NotParsed, "=\'b\'" },       // invalid if no name.
     { ParseInfo::NotParsed, "=\"b\"" },       // invalid if no name.
     { ParseInfo::CantStart, "" },             // invalid if empty.
@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file BatchTester.cpp Parses many documents with an XmlBatch.
+
+
+// ----------------------------------------------------------------------------
+
+#include "BatchTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/XmlBatch.hpp"
+#include "../include/XmlDocument.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+const unsigned int s_inputCount = 300;
+
+// ----------------------------------------------------------------------------
+
+/// Makes documents whose sizes differ a lot, so some threads must steal work.
+void MakeInputs( vector< string > & inputs )
+{
+    char line[ 96 ];
+    inputs.resize( s_inputCount );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        string & text = inputs[ ii ];
+        const unsigned int children = ( 0 == ii % 50 ) ? 500 : 1 + ii % 5;
+        ::sprintf( line, "<root index=\"%u\">\n", ii );
+        text += line;
+        for ( unsigned int jj = 0; jj < children; ++jj )
+        {
+            ::sprintf( line, "  <item id=\"%u\">text %u &amp; more</item>\n", jj, ii );
+            text += line;
+        }
+        if ( 0 == ii % 7 )
+            text += "  <broken attr></broken>\n";
+        text += "</root>\n";
+    }
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoBatchTests( unsigned int threadCount, bool showSummary )
+{
+    vector< string > inputs;
+    MakeInputs( inputs );
+
+    XmlBatch batch( threadCount );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const string & text = inputs[ ii ];
+        batch.AddBuffer( text.c_str(), text.c_str() + text.size(), NULL );
+    }
+    const unsigned long missing = batch.AddFile( "NoSuchFile.xml" );
+    const bool allValid = batch.Run();
+    const BatchStats stats = batch.GetStats();
+
+    // Same parse on this thread alone, one document at a time.
+    XmlParser parser;
+    MessageCollector collector;
+    parser.SetErrorReceiver( &collector );
+    unsigned long matched = 0;
+    unsigned long mismatched = 0;
+    unsigned long invalid = 0;
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const string & text = inputs[ ii ];
+        string messages;
+        unsigned long messageCount = 0;
+        collector.SetTarget( &messages, &messageCount );
+        XmlDocument document;
+        const XmlParser::ParseResults result = document.Parse( parser, text.c_str(),
+            text.c_str() + text.size() );
+        if ( XmlParser::AllValid != result )
+            ++invalid;
+        const XmlDocument & other = batch.GetDocument( ii );
+        if ( ( result == batch.GetResult( ii ) )
+          && ( messageCount == batch.GetMessageCount( ii ) )
+          && ( messages == batch.GetMessages( ii ) )
+          && ( document.GetNodeCount() == other.GetNodeCount() )
+          && ( document.GetAttributeCount() == other.GetAttributeCount() )
+          && ( document.IsValid() == other.IsValid() ) )
+            ++matched;
+        else
+            ++mismatched;
+    }
+
+    const bool passed = ( 0 == mismatched ) && !allValid && ( 0 != invalid )
+        && ( XmlParser::CantOpenFile == batch.GetResult( missing ) )
+        && ( s_inputCount + 1 == stats.m_jobs ) && ( 0 == stats.m_exceptions )
+        && ( stats.m_threads <= threadCount );
+    if ( showSummary || !passed )
+    {
+        cout << "Batch Threads: [" << stats.m_threads << "] of [" << threadCount
+            << "]\tJobs: [" << stats.m_jobs << "]\tMatched: [" << matched
+            << "]\tMismatched: [" << mismatched << "]\tInvalid: [" << invalid
+            << "]\t" << ( passed ? "Passed" : "Failed" ) << '\n';
+    }
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file BatchTester.hpp Checks that XmlBatch matches parsing one at a time.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_BATCH_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_BATCH_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses many documents of very different sizes with an XmlBatch on several
+ threads, and checks each result, tree, and message list against parsing the
+ same document on this thread alone.
+ @param threadCount Most threads for the batch.
+ @param showSummary True to show counts.
+ @return True if all checks passed.
+ */
+bool DoBatchTests( unsigned int threadCount, bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,198 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ChunkTester.cpp Feeds documents with very large items in small chunks.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ChunkTester.hpp"
+
+#include <assert.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlParser.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Small, so each large item is split across many chunks.
+const unsigned long s_chunkSize = 32;
+
+/// Size of the repeated part of each large item.
+const unsigned long s_itemSize = 0x100000;
+
+// ----------------------------------------------------------------------------
+
+/// Returns text made of part repeated until it is at least s_itemSize long.
+string Repeat( const char * part )
+{
+    const string piece( part );
+    string text;
+    text.reserve( s_itemSize + piece.size() );
+    while ( text.size() < s_itemSize )
+        text += piece;
+    return text;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Returns calls with each run of AddCData calls joined into one, and with the
+ text dropped from DoneNode and DoneDocument calls, since a fed document gives
+ character data in as many calls as it has chunks, and a node fed in chunks is
+ never whole in one place.
+ */
+string Simplify( const string & calls )
+{
+    const string cdata( "AddCData [" );
+    string simple;
+    bool inText = false;
+    for ( string::size_type begin = 0; begin < calls.size(); )
+    {
+        string::size_type end = calls.find( "]\n", begin );
+        end = ( string::npos == end ) ? calls.size() : end + 2;
+        const string line( calls, begin, end - begin );
+        begin = end;
+        if ( 0 == line.compare( 0, cdata.size(), cdata ) )
+        {
+            if ( inText )
+            {
+                simple.erase( simple.size() - 2 );
+                simple.append( line, cdata.size(), string::npos );
+            }
+            else
+                simple += line;
+            inText = true;
+            continue;
+        }
+        inText = false;
+        if ( ( 0 == line.compare( 0, 8, "DoneNode" ) )
+          || ( 0 == line.compare( 0, 12, "DoneDocument" ) ) )
+            simple.append( line, 0, line.find( " [" ) ).append( "\n" );
+        else
+            simple += line;
+    }
+    return simple;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses a document in one pass and fed in chunks, and compares both.
+void CheckDocument( TestChecker & checker, XmlParser & parser,
+    MessageCollector & collector, const string & document, bool valid,
+    const char * what, unsigned long chunkSize = s_chunkSize )
+{
+    const char * begin = document.c_str();
+    const char * end = begin + document.size();
+
+    string expectedMessages;
+    collector.SetTarget( &expectedMessages, NULL );
+    CallRecorder expected;
+    const XmlParser::ParseResults expectedResult =
+        parser.ParseDocument( begin, end, &expected );
+
+    string messages;
+    collector.SetTarget( &messages, NULL );
+    CallRecorder received;
+    XmlParser::ParseResults result = parser.StartFeeding( &received );
+    for ( const char * here = begin; here < end; here += chunkSize )
+    {
+        const char * chunkEnd = ( chunkSize < static_cast< unsigned long >( end - here ) )
+            ? here + chunkSize : end;
+        result = parser.Feed( here, chunkEnd );
+    }
+    result = parser.Finish();
+    collector.SetTarget( NULL, NULL );
+
+    if ( !checker.Check( valid == ( XmlParser::AllValid == expectedResult ),
+        "Document parsed in one pass has the expected result." ) )
+        cout << what << '\n';
+    if ( !checker.Check( result == expectedResult, "Result is the same as one pass." ) )
+        cout << what << '\n';
+    if ( !checker.Check( Simplify( received.m_calls ) == Simplify( expected.m_calls ),
+        "Receiver gets the same calls as one pass." ) )
+        cout << what << '\n' << received.m_calls << expected.m_calls;
+    if ( !checker.Check( messages == expectedMessages, "Messages are the same as one pass." ) )
+        cout << what << '\n' << messages << expectedMessages;
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoChunkTests( bool showSummary )
+{
+    TestChecker checker( "Chunk" );
+    XmlParser parser;
+    MessageCollector collector;
+    parser.SetErrorReceiver( &collector );
+
+    CheckDocument( checker, parser, collector,
+        "<root><!--" + Repeat( " a - b > c" ) + "--></root>", true, "comment" );
+    CheckDocument( checker, parser, collector,
+        "<root><![CDATA[" + Repeat( " <a> ]] ] ]>" ) + "]]></root>", true, "CDATA section" );
+    CheckDocument( checker, parser, collector,
+        "<root><?target" + Repeat( " ? > ?x" ) + "?></root>", true, "processing instruction" );
+    CheckDocument( checker, parser, collector,
+        "<root a=\"" + Repeat( "x > 'y' ]" ) + "\" b='c'/>", true, "attribute value" );
+    CheckDocument( checker, parser, collector,
+        "<!DOCTYPE root [" + Repeat( " <!ENTITY e \"[ > ]\"> <!-- a > b -->" ) + "]><root/>",
+        true, "internal subset" );
+    // Entity values may hold a '<', so it does not end the declaration.
+    CheckDocument( checker, parser, collector,
+        "<!DOCTYPE r [<!ENTITY e \"<x>\"><!ENTITY f 'a<b'>]><r/>", true,
+        "quoted '<' in internal subset", 1 );
+    CheckDocument( checker, parser, collector,
+        "<root>" + Repeat( "text ]] &amp; more &#65; " ) + "</root>", true, "character data" );
+    CheckDocument( checker, parser, collector,
+        "<root>&" + Repeat( "name" ) + ";</root>", true, "reference" );
+    CheckDocument( checker, parser, collector,
+        "<root><!--" + Repeat( " no end " ), false, "comment with no end" );
+
+    // Small bad documents, fed a char at a time, give the same messages too.
+    CheckDocument( checker, parser, collector, "<a b=\"<\"/>", false,
+        "quoted '<' in attribute value", 1 );
+    CheckDocument( checker, parser, collector, "<a b='x<y'>z</a>", false,
+        "single-quoted '<' in attribute value", 1 );
+    CheckDocument( checker, parser, collector, "<a b=\"x>y<\"/>", false,
+        "quoted '>' before quoted '<'", 1 );
+    CheckDocument( checker, parser, collector, "<a b=\"x><c/></a>", false,
+        "attribute value with no end", 1 );
+    CheckDocument( checker, parser, collector, "", false, "empty document", 1 );
+    CheckDocument( checker, parser, collector, "</a>", false, "end tag before root", 1 );
+    CheckDocument( checker, parser, collector, "<a><!--", false, "comment with no end", 1 );
+    CheckDocument( checker, parser, collector, "<r>&</a>--><!-- c --></r>", false,
+        "content after root closed as invalid", 1 );
+    CheckDocument( checker, parser, collector, "<r/><!-- c --><x/>", false,
+        "element after root", 1 );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
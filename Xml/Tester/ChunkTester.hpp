@@ -0,0 +1,41 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ChunkTester.hpp Feeds documents with very large items in small chunks.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_CHUNK_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_CHUNK_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Feeds documents which each hold one very large comment, CDATA section,
+ processing instruction, tag, declaration, or reference in small chunks, so the
+ item is split across thousands of chunks, and checks the result and every
+ receiver call and message against parsing in one pass.  A feeder which
+ searched each split item from its start again for every chunk would take far
+ too long.  Also feeds small bad documents a char at a time, and an empty one.
+ @param showSummary True to show counts.
+ @return True if all checks passed.
+ */
+bool DoChunkTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -39,6 +39,7 @@ CommandLineArgs::CommandLineArgs( unsigned int argc, const char * const argv[] )
     m_showTable( false ),
     m_doMeanTests( false ),
     m_showInfo( false ),
+    m_spiritOnly( false ),
     m_unitTestIndex( -1 ),
     m_showErrorLevel( ::Parser::ErrorLevel::Info ),
     m_fileName( NULL ),
@@ -107,6 +108,7 @@ CommandLineArgs::CommandLineArgs( unsigned int argc, const char * const argv[] )
             case 't': m_showTable   = true;  break;
             case 'c': m_showContent = true;  break;
             case 'm': m_doMeanTests = true;  break;
+            case 'p': m_spiritOnly  = true;  break;
             case 'W': m_doWait      = true;  break;
             default:  validCommands = false; break;
         }
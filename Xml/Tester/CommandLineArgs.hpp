@@ -56,6 +56,7 @@ public:
     inline bool DoShowTable( void ) const { return m_showTable; }
     inline bool DoMeanTests( void ) const { return m_doMeanTests; }
     inline bool DoShowInfo( void ) const { return m_showInfo; }
+    inline bool DoSpiritOnly( void ) const { return m_spiritOnly; }
     inline bool DoSpecificUnitTest( void ) const
     {
         return ( 0 <= m_unitTestIndex );
@@ -91,6 +92,7 @@ private:
     bool m_showTable;
     bool m_doMeanTests;
     bool m_showInfo;
+    bool m_spiritOnly;        ///< True to parse without fast scanners.
     signed int m_unitTestIndex;
     Parser::ErrorLevel::Levels m_showErrorLevel;
     const char * m_fileName;
@@ -0,0 +1,201 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DomTester.cpp Builds XmlDocuments and checks their trees.
+
+
+// ----------------------------------------------------------------------------
+
+#include "DomTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlDocument.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+const char s_document[] =
+    "<?xml version=\"1.0\" standalone=\"yes\"?>\n"
+    "<!-- before -->\n"
+    "<root a=\"1\" b='x &amp; y' c=\"&#x41;&#66;&lt;\">"
+    "<item id=\"first\">one &amp; two</item>"
+    "<other/>"
+    "<item id=\"second\"><![CDATA[keep &amp; as is]]><!-- inside --></item>"
+    "plain"
+    "</root>\n"
+    "<!-- after -->\n";
+
+const char s_badDocument[] =
+    "<root><item>text</item><item>more</root>";
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of text views to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "DOM" ) {}
+
+    void CheckText( const TextView & view, const char * expected, const char * what )
+    {
+        const bool passed = view.Equals( expected );
+        Check( passed, what );
+        if ( !passed )
+            cout << "  Found: [" << string( view.m_begin, view.m_length )
+                << "]\tExpected: [" << expected << "]\n";
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+void CheckDocument( Checker & checker, XmlParser & parser )
+{
+    XmlDocument document;
+    const XmlParser::ParseResults result = document.Parse( parser,
+        s_document, s_document + sizeof( s_document ) - 1 );
+    checker.Check( XmlParser::AllValid == result, "Document parsed as valid." );
+    checker.Check( document.IsValid(), "Document is valid." );
+    checker.Check( document.IsStandalone(), "Document is standalone." );
+    checker.Check( 0 < document.GetArenaSize(), "Arena holds tree." );
+    checker.Check( 11 == document.GetNodeCount(), "Node count." );
+    checker.Check( 5 == document.GetAttributeCount(), "Attribute count." );
+    if ( ( 11 != document.GetNodeCount() ) || ( 5 != document.GetAttributeCount() ) )
+        return;
+
+    const DomNode & top = document.GetNode( 0 );
+    checker.Check( DomNode::Document == top.m_kind, "First node is Document." );
+    checker.Check( XmlDocument::NoIndex == top.m_parent, "Document has no parent." );
+
+    // Document children are comment, root, and comment.
+    const DomNode & before = document.GetNode( top.m_firstChild );
+    checker.Check( DomNode::Comment == before.m_kind, "Comment before root." );
+    checker.CheckText( before.m_text, " before ", "Text of comment before root." );
+    const unsigned long root = document.GetRoot();
+    checker.Check( before.m_nextSibling == root, "Root follows comment." );
+    const DomNode & after = document.GetNode( top.m_lastChild );
+    checker.Check( DomNode::Comment == after.m_kind, "Comment after root." );
+    checker.Check( document.GetNode( root ).m_nextSibling == top.m_lastChild,
+        "Comment follows root." );
+
+    const DomNode & rootNode = document.GetNode( root );
+    checker.CheckText( rootNode.m_name, "root", "Name of root." );
+    checker.Check( 3 == rootNode.m_attributeCount, "Root has three attributes." );
+    const DomAttribute * a = document.FindAttribute( root, "a" );
+    const DomAttribute * b = document.FindAttribute( root, "b" );
+    const DomAttribute * c = document.FindAttribute( root, "c" );
+    checker.Check( ( NULL != a ) && ( NULL != b ) && ( NULL != c ), "Root attributes found." );
+    checker.Check( NULL == document.FindAttribute( root, "d" ), "Missing attribute not found." );
+    if ( ( NULL == a ) || ( NULL == b ) || ( NULL == c ) )
+        return;
+    checker.CheckText( a->m_value, "1", "Plain value." );
+    checker.Check( ( s_document < a->m_value.m_begin )
+        && ( a->m_value.m_begin < s_document + sizeof( s_document ) ),
+        "Plain value is a view into document." );
+    checker.CheckText( b->m_value, "x & y", "Value with entity reference." );
+    checker.CheckText( c->m_value, "AB<", "Value with char references." );
+
+    const unsigned long first = document.FindChild( root, "item" );
+    checker.Check( XmlDocument::NoIndex != first, "First item found." );
+    if ( XmlDocument::NoIndex == first )
+        return;
+    const DomAttribute * id = document.FindAttribute( first, "id" );
+    checker.Check( ( NULL != id ) && id->m_value.Equals( "first" ), "Id of first item." );
+    const DomNode & firstText = document.GetNode( document.GetNode( first ).m_firstChild );
+    checker.Check( DomNode::Text == firstText.m_kind, "First item has text." );
+    checker.CheckText( firstText.m_text, "one & two", "Text with reference." );
+
+    const unsigned long other = document.FindChild( root, "other" );
+    checker.Check( XmlDocument::NoIndex != other, "Empty element found." );
+    if ( XmlDocument::NoIndex != other )
+    {
+        const DomNode & otherNode = document.GetNode( other );
+        checker.Check( XmlDocument::NoIndex == otherNode.m_firstChild, "Empty element has no children." );
+        checker.Check( 0 == otherNode.m_attributeCount, "Empty element has no attributes." );
+        checker.Check( root == otherNode.m_parent, "Parent of empty element." );
+    }
+
+    const unsigned long second = document.FindNextSibling( first );
+    checker.Check( XmlDocument::NoIndex != second, "Second item found." );
+    if ( XmlDocument::NoIndex == second )
+        return;
+    checker.Check( XmlDocument::NoIndex == document.FindNextSibling( second ), "No third item." );
+    const DomNode & secondNode = document.GetNode( second );
+    const DomNode & cdata = document.GetNode( secondNode.m_firstChild );
+    checker.Check( DomNode::CData == cdata.m_kind, "Second item has CDATA." );
+    checker.CheckText( cdata.m_text, "keep &amp; as is", "CDATA is not replaced." );
+    const DomNode & inside = document.GetNode( secondNode.m_lastChild );
+    checker.Check( DomNode::Comment == inside.m_kind, "Comment inside element." );
+    checker.Check( second == inside.m_parent, "Parent of comment inside element." );
+
+    const DomNode & plain = document.GetNode( secondNode.m_nextSibling );
+    checker.Check( DomNode::Text == plain.m_kind, "Text after last item." );
+    checker.CheckText( plain.m_text, "plain", "Text after last item." );
+    checker.Check( rootNode.m_lastChild == secondNode.m_nextSibling, "Text is last child of root." );
+
+    document.Clear();
+    checker.Check( ( 0 == document.GetNodeCount() ) && ( 0 == document.GetArenaSize() ),
+        "Clear frees tree." );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckBadDocument( Checker & checker, XmlParser & parser )
+{
+    XmlDocument document;
+    const XmlParser::ParseResults result = document.Parse( parser,
+        s_badDocument, s_badDocument + sizeof( s_badDocument ) - 1 );
+    checker.Check( XmlParser::AllValid != result, "Bad document is not valid." );
+    checker.Check( !document.IsValid(), "Bad document tree is not valid." );
+    checker.Check( XmlDocument::NoIndex != document.GetRoot(), "Bad document has root." );
+    if ( XmlDocument::NoIndex == document.GetRoot() )
+        return;
+    checker.Check( XmlDocument::NoIndex != document.FindChild( document.GetRoot(), "item" ),
+        "Bad document has item." );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoDomTests( bool showSummary )
+{
+    Checker checker;
+    QuietReceiver receiver;
+    XmlParser parser;
+    parser.SetErrorReceiver( &receiver );
+    CheckDocument( checker, parser );
+    CheckBadDocument( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file DomTester.hpp Checks the tree XmlDocument builds.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_DOM_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_DOM_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses documents into XmlDocuments and checks the kind, name, text, and
+ links of every node, the attributes of each element, and that references are
+ replaced outside of CDATA sections.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoDomTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
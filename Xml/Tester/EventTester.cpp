@@ -0,0 +1,439 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventTester.cpp Parses documents into batches of events.
+
+
+// ----------------------------------------------------------------------------
+
+#include "EventTester.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlEventBatcher.hpp"
+#include "../include/XmlReader.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Documents to compare with reader tokens.  Some are not valid, so events
+/// for broken and unclosed elements are compared too.
+const char * const s_inputs[] =
+{
+    "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+    "<!-- first -->\n"
+    "<root a=\"1\" b='two' c=\"x&amp;y\">\n"
+    "  <child>text &amp; more &#65;</child>\n"
+    "  <empty/>\n"
+    "  <![CDATA[ <raw> ]]>\n"
+    "  <!-- inner -->\n"
+    "  <a><b><c x=\"y\" z='w'>deep</c></b></a>\n"
+    "</root>\n"
+    "<!-- last -->\n",
+    "<root><open></root>",
+    "<root><bad attr></bad><good/></root>",
+    "<root>text & more</root>",
+    "<root><1bad/></root>",
+};
+
+const unsigned int s_inputCount = sizeof( s_inputs ) / sizeof( s_inputs[ 0 ] );
+
+/// Array sizes and batch sizes for event buffers.
+const unsigned long s_shapes[][ 2 ] =
+{
+    { 1, 1 },
+    { 2, 2 },
+    { 7, 3 },
+    { 64, 16 },
+    { 1000, 1000 },
+};
+
+const unsigned int s_shapeCount = sizeof( s_shapes ) / sizeof( s_shapes[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Adds one line for an event or token to text.
+void AddLine( string & text, const char * kind, bool valid, const char * begin,
+    const char * end )
+{
+    text += kind;
+    if ( valid )
+        text += " valid";
+    text += " [";
+    if ( NULL != begin )
+        text.append( begin, end - begin );
+    text += "]\n";
+}
+
+// ----------------------------------------------------------------------------
+
+/** Writes every event into a string, and keeps a copy of each batch until the
+ buffer reuses it, to check that no batch is written over while held.
+ */
+class EventRecorder : public IEventBatchReceiver
+{
+public:
+
+    EventRecorder( const ParseEvent * array, unsigned long capacity,
+        unsigned long batchSize ) :
+        IEventBatchReceiver(),
+        m_text(),
+        m_events(),
+        m_array( array ),
+        m_capacity( capacity ),
+        m_batchSize( batchSize ),
+        m_held(),
+        m_badBatches( 0 ),
+        m_badReuses( 0 ),
+        m_splitPairs( 0 ),
+        m_lastKind( 0 ),
+        m_batches( 0 ),
+        m_stopAfter( 0 )
+    {}
+
+    virtual ~EventRecorder( void ) {}
+
+    virtual bool TakeEvents( const ParseEvent * events, unsigned long count )
+    {
+        ++m_batches;
+        if ( ( 0 == count ) || ( m_batchSize < count ) || ( events < m_array )
+          || ( m_array + m_capacity < events + count ) )
+            ++m_badBatches;
+        // A name with no value may end a batch, but a name and its value may not
+        // be split across two batches.
+        if ( ( 1 < m_batchSize ) && ( XmlEventBatcher::AttributeName == m_lastKind )
+          && ( XmlEventBatcher::AttributeValue == events[ 0 ].m_kind ) )
+            ++m_splitPairs;
+        m_lastKind = events[ count - 1 ].m_kind;
+        for ( unsigned long ii = 0; ii < count; ++ii )
+        {
+            const ParseEvent & event = events[ ii ];
+            const bool valid = ( ( XmlEventBatcher::EndElement == event.m_kind )
+                || ( XmlEventBatcher::EndDocument == event.m_kind ) )
+                && ( 0 != ( XmlEventBatcher::Valid & event.m_flags ) );
+            AddLine( m_text, XmlEventBatcher::GetEventName( event.m_kind ), valid,
+                event.m_begin, event.m_end );
+            m_events.push_back( event );
+        }
+        m_held.push_back( Batch( events, vector< ParseEvent >( events, events + count ) ) );
+        return ( 0 == m_stopAfter ) || ( m_batches < m_stopAfter );
+    }
+
+    virtual void ReuseEvents( const ParseEvent * events, unsigned long count )
+    {
+        // Batches must come back in the order they went out, and unchanged.
+        if ( m_held.empty() || ( m_held.front().first != events )
+          || ( m_held.front().second.size() != count )
+          || ( 0 != ::memcmp( events, &m_held.front().second[ 0 ],
+                count * sizeof( ParseEvent ) ) ) )
+            ++m_badReuses;
+        if ( !m_held.empty() )
+            m_held.pop_front();
+    }
+
+    typedef pair< const ParseEvent *, vector< ParseEvent > > Batch;
+
+    string m_text;
+    vector< ParseEvent > m_events;
+    const ParseEvent * m_array;
+    unsigned long m_capacity;
+    unsigned long m_batchSize;
+    deque< Batch > m_held;
+    unsigned long m_badBatches;
+    unsigned long m_badReuses;
+    unsigned long m_splitPairs;
+    /// Kind of last event in the previous batch.
+    unsigned short m_lastKind;
+    unsigned long m_batches;
+    /// Says to stop after this many batches, or zero to never stop.
+    unsigned long m_stopAfter;
+};
+
+// ----------------------------------------------------------------------------
+
+string GetReaderText( XmlReader & reader )
+{
+    string text;
+    reader.Rewind();
+    while ( XmlReader::None != reader.Next() )
+    {
+        const bool valid = ( ( XmlReader::EndElement == reader.GetToken() )
+            || ( XmlReader::EndDocument == reader.GetToken() ) ) && reader.IsValid();
+        AddLine( text, XmlReader::GetTokenName( reader.GetToken() ), valid,
+            reader.GetBegin(), reader.GetEnd() );
+    }
+    return text;
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckDocuments( TestChecker & checker, XmlParser & parser )
+{
+    XmlReader reader( parser );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const char * begin = s_inputs[ ii ];
+        const char * end = begin + ::strlen( begin );
+        reader.Open( begin, end );
+        const string expected = GetReaderText( reader );
+        const XmlParser::ParseResults readerResult = reader.GetResult();
+
+        for ( unsigned int jj = 0; jj < s_shapeCount; ++jj )
+        {
+            const unsigned long capacity = s_shapes[ jj ][ 0 ];
+            const unsigned long batchSize = s_shapes[ jj ][ 1 ];
+            vector< ParseEvent > array( capacity );
+            EventRecorder recorder( &array[ 0 ], capacity, batchSize );
+            EventBuffer buffer( &array[ 0 ], capacity, batchSize, &recorder );
+            XmlEventBatcher batcher( buffer );
+            const XmlParser::ParseResults result =
+                batcher.ParseDocument( parser, begin, end );
+
+            checker.Check( readerResult == result, "Batcher returns what parser returns." );
+            const bool same = ( expected == recorder.m_text );
+            checker.Check( same, "Events match reader tokens." );
+            if ( !same )
+            {
+                cout << "Reader tokens:\n" << expected << "Events:\n"
+                    << recorder.m_text;
+            }
+            checker.Check( 0 == recorder.m_badBatches, "Batches fit in array." );
+            checker.Check( 0 == recorder.m_badReuses, "Batches reused in order, unchanged." );
+            checker.Check( recorder.m_held.empty(), "Flush reuses every batch." );
+            checker.Check( 0 == recorder.m_splitPairs, "Attribute pairs stay in one batch." );
+            checker.Check( buffer.GetEventCount() == recorder.m_events.size(),
+                "Buffer counts every event." );
+            checker.Check( buffer.GetBatchCount() == recorder.m_batches,
+                "Buffer counts every batch." );
+        }
+    }
+
+    // The first document has one attribute value with a reference.
+    const char * begin = s_inputs[ 0 ];
+    vector< ParseEvent > array( 64 );
+    EventRecorder recorder( &array[ 0 ], 64, 16 );
+    EventBuffer buffer( &array[ 0 ], 64, 16, &recorder );
+    XmlEventBatcher batcher( buffer );
+    batcher.ParseDocument( parser, begin, begin + ::strlen( begin ) );
+    unsigned long values = 0;
+    unsigned long references = 0;
+    for ( unsigned long ii = 0; ii < recorder.m_events.size(); ++ii )
+    {
+        const ParseEvent & event = recorder.m_events[ ii ];
+        if ( XmlEventBatcher::AttributeValue != event.m_kind )
+            continue;
+        ++values;
+        if ( 0 != ( XmlEventBatcher::HasReference & event.m_flags ) )
+            ++references;
+    }
+    checker.Check( ( 5 == values ) && ( 1 == references ), "Values say if they have references." );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckStop( TestChecker & checker, XmlParser & parser )
+{
+    const char * begin = s_inputs[ 0 ];
+    const char * end = begin + ::strlen( begin );
+    ParseEvent array[ 6 ];
+    EventRecorder recorder( array, 6, 3 );
+    recorder.m_stopAfter = 2;
+    EventBuffer buffer( array, 6, 3, &recorder );
+    XmlEventBatcher batcher( buffer );
+    batcher.ParseDocument( parser, begin, end );
+    checker.Check( 2 == recorder.m_batches, "No batches after receiver says to stop." );
+    checker.Check( buffer.IsStopped(), "Buffer knows receiver said to stop." );
+    checker.Check( recorder.m_held.empty(), "Stopped buffer still reuses every batch." );
+    checker.Check( !buffer.Add( XmlEventBatcher::Text, 0, begin, end ), "Add fails once stopped." );
+
+    buffer.Reset();
+    recorder.m_stopAfter = 0;
+    recorder.m_events.clear();
+    batcher.ParseDocument( parser, begin, end );
+    checker.Check( !buffer.IsStopped(), "Reset lets events be added again." );
+    checker.Check( XmlEventBatcher::EndDocument == recorder.m_events.back().m_kind,
+        "Parse after Reset reaches EndDocument." );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckAttribute( TestChecker & checker, XmlParser & parser )
+{
+    const char attribute[] = "a = 'x&lt;y'";
+    ParseEvent array[ 8 ];
+    EventRecorder recorder( array, 8, 4 );
+    EventBuffer buffer( array, 8, 4, &recorder );
+    XmlEventBatcher batcher( buffer );
+    const XmlParser::ParseResults result = batcher.ParseAttribute( parser,
+        attribute, attribute + sizeof( attribute ) - 1 );
+    checker.Check( XmlParser::AllValid == result, "Attribute parsed as valid." );
+
+    const char * const expected =
+        "AttributeName [a]\n"
+        "ValueText [x]\n"
+        "Reference [&lt;]\n"
+        "ValueText [y]\n"
+        "AttributeValue [x&lt;y]\n";
+    const bool same = ( expected == recorder.m_text );
+    checker.Check( same, "Events for parts of attribute value." );
+    if ( !same )
+        cout << "Events:\n" << recorder.m_text;
+    if ( 5 != recorder.m_events.size() )
+        return;
+    checker.Check( IReferenceReceiver::Entity == recorder.m_events[ 2 ].m_flags,
+        "Reference event has its RefType." );
+    checker.Check( ( XmlEventBatcher::Valid | XmlEventBatcher::SingleQuoted
+        | XmlEventBatcher::HasReference ) == recorder.m_events[ 4 ].m_flags,
+        "Attribute value has its flags." );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns true if both have the same events, pointing to the same chars.
+bool SameEvents( const vector< ParseEvent > & left, const vector< ParseEvent > & right )
+{
+    if ( left.size() != right.size() )
+        return false;
+    for ( unsigned long ii = 0; ii < left.size(); ++ii )
+    {
+        if ( ( left[ ii ].m_kind != right[ ii ].m_kind )
+          || ( left[ ii ].m_flags != right[ ii ].m_flags )
+          || ( left[ ii ].m_begin != right[ ii ].m_begin )
+          || ( left[ ii ].m_end != right[ ii ].m_end ) )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Checks that events the rules add straight to a buffer are the same as
+ events from the batcher when it is given to the parser as a receiver, with
+ fast scanning on and off.
+ */
+void CheckReceiverPath( TestChecker & checker, XmlParser & parser )
+{
+    const char * const attributes[] =
+    {
+        "a = 'x&lt;y'",
+        "b=\"1&#65;2&#x42;\"",
+        "c='bad&'",
+        "d = \"&#x3C;&amp;\"",
+    };
+    const unsigned int attributeCount = sizeof( attributes ) / sizeof( attributes[ 0 ] );
+
+    for ( unsigned int fast = 0; fast < 2; ++fast )
+    {
+        parser.SetFastScanning( 0 != fast );
+        for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+        {
+            const char * begin = s_inputs[ ii ];
+            const char * end = begin + ::strlen( begin );
+            vector< ParseEvent > directArray( 7 );
+            EventRecorder direct( &directArray[ 0 ], 7, 3 );
+            EventBuffer directBuffer( &directArray[ 0 ], 7, 3, &direct );
+            const XmlParser::ParseResults directResult =
+                parser.ParseDocument( begin, end, directBuffer );
+
+            vector< ParseEvent > array( 7 );
+            EventRecorder recorder( &array[ 0 ], 7, 3 );
+            EventBuffer buffer( &array[ 0 ], 7, 3, &recorder );
+            XmlEventBatcher batcher( buffer );
+            batcher.Begin( begin );
+            const XmlParser::ParseResults result =
+                parser.ParseDocument( begin, end, &batcher );
+            batcher.Finish( end );
+
+            checker.Check( directResult == result, "Buffer and receiver get same result." );
+            const bool same = SameEvents( direct.m_events, recorder.m_events );
+            checker.Check( same, "Rules add the events a batcher adds." );
+            if ( !same )
+            {
+                cout << "Receiver events:\n" << recorder.m_text << "Rule events:\n"
+                    << direct.m_text;
+            }
+            checker.Check( direct.m_batches == recorder.m_batches,
+                "Rules fill batches as a batcher does." );
+        }
+
+        for ( unsigned int ii = 0; ii < attributeCount; ++ii )
+        {
+            const char * begin = attributes[ ii ];
+            const char * end = begin + ::strlen( begin );
+            ParseEvent directArray[ 8 ];
+            EventRecorder direct( directArray, 8, 4 );
+            EventBuffer directBuffer( directArray, 8, 4, &direct );
+            const XmlParser::ParseResults directResult =
+                parser.ParseAttribute( begin, end, directBuffer );
+
+            ParseEvent array[ 8 ];
+            EventRecorder recorder( array, 8, 4 );
+            EventBuffer buffer( array, 8, 4, &recorder );
+            XmlEventBatcher batcher( buffer );
+            batcher.Begin( begin );
+            const XmlParser::ParseResults result =
+                parser.ParseAttribute( begin, end, &batcher );
+            buffer.Flush();
+
+            checker.Check( directResult == result,
+                "Buffer and receiver get same attribute result." );
+            const bool same = SameEvents( direct.m_events, recorder.m_events );
+            checker.Check( same, "Rules add the attribute events a batcher adds." );
+            if ( !same )
+            {
+                cout << "Receiver events:\n" << recorder.m_text << "Rule events:\n"
+                    << direct.m_text;
+            }
+        }
+    }
+    parser.SetFastScanning( true );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoEventTests( bool showSummary )
+{
+    TestChecker checker( "Event" );
+    QuietReceiver receiver;
+    XmlParser parser;
+    parser.SetErrorReceiver( &receiver );
+    CheckDocuments( checker, parser );
+    CheckStop( checker, parser );
+    CheckAttribute( checker, parser );
+    CheckReceiverPath( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
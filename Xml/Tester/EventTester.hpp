@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file EventTester.hpp Checks batches of events from XmlEventBatcher.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_EVENT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_EVENT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses documents into event buffers of several sizes, and checks that the
+ events match the tokens of an XmlReader, that no batch is written over before
+ its receiver lets it be, and that a receiver can stop the events.  Also checks
+ the events for the parts of a lone attribute value.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoEventTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
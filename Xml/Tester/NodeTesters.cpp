@@ -0,0 +1,509 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+
+#include "NodeTesters.hpp"
+
+#include <string>
+#include <iostream>
+
+#include "../../Util/include/ParseInfo.hpp"
+
+#include "../include/XmlParser.hpp"
+
+#include "CommandLineArgs.hpp"
+
+
+using namespace std;
+using namespace Parser;
+
+
+extern ParseInfo::ParseResult Convert( Xml::XmlParser::ParseResults result );
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+void PrintContent( const char * label, const char * begin, const char * end )
+{
+    string content;
+    if ( begin < end )
+        content.assign( begin, end-begin );
+    else
+        content = "(empty)";
+    cout << label << ": [" << content << ']' << endl;
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+const TestData s_nodeTestCases[] =
+{
+    { ParseInfo::AllValid,  "<a/>" },
+    { ParseInfo::AllValid,  "<a />" },
+    { ParseInfo::AllValid,  "<a></a>" },
+    { ParseInfo::AllValid,  "<a >text</a >" },
+    { ParseInfo::AllValid,  "<a:b\n>text</a:b>" },
+    { ParseInfo::AllValid,  "<a b='c'/>" },
+    { ParseInfo::AllValid,  "<a b=\"c\" d='e'>x</a>" },
+    { ParseInfo::AllValid,  "<a b = 'c&amp;d'>x</a>" },
+    { ParseInfo::AllValid,  "<a><b/><c>d</c></a>" },
+    { ParseInfo::AllValid,  "<a><a><a/></a></a>" },
+    { ParseInfo::AllValid,  "<a>x<!-- c -->y</a>" },
+    { ParseInfo::AllValid,  "<a><![CDATA[<x>&]]></a>" },
+    { ParseInfo::AllValid,  "<a>&amp;&#65;&#x41;</a>" },
+    { ParseInfo::AllValid,  "<a><?pi data?></a>" },
+    { ParseInfo::AllValid,  "<a>\n\t<b>c</b>\n</a>" },
+    { ParseInfo::AllValid,  "<a b='1' bb='2' c:b='3'/>" },
+    { ParseInfo::AllValid,  "<a b='1'><c b='2'/></a>" },
+    { ParseInfo::AllValid,  "<a>x]]y]>z&gt;</a>" },
+    { ParseInfo::AllValid,  "<a><![CDATA[x]]]></a>" },
+    { ParseInfo::SomeValid, "<a/> tail" },
+    { ParseInfo::SomeValid, "<a></a><b/>" },
+    { ParseInfo::NotValid,  "<a>" },
+    { ParseInfo::NotValid,  "<a>text" },
+    { ParseInfo::NotValid,  "<a><b></a>" },
+    { ParseInfo::NotValid,  "<a></b>" },
+    { ParseInfo::NotValid,  "<a></ab>" },
+    { ParseInfo::NotValid,  "<a></ a>" },
+    { ParseInfo::NotValid,  "<a>x & y</a>" },
+    { ParseInfo::NotValid,  "<a>x < y</a>" },
+    { ParseInfo::NotValid,  "<a b>x</a>" },
+    { ParseInfo::NotValid,  "<a b='c' $>x</a>" },
+    { ParseInfo::NotValid,  "<a><![CDATA[x</a>" },
+    { ParseInfo::NotValid,  "<a" },
+    { ParseInfo::NotValid,  "<a b='1' b='2'/>" },
+    { ParseInfo::NotValid,  "<a b='1' c='2' b='3'>x</a>" },
+    { ParseInfo::NotValid,  "<a><c b='1' b=\"2\"></c></a>" },
+    { ParseInfo::NotValid,  "<a>x]]>y</a>" },
+    { ParseInfo::NotValid,  "<a>]]></a>" },
+    { ParseInfo::NotParsed, "a" },
+    { ParseInfo::NotParsed, " <a/>" },
+    { ParseInfo::NotParsed, "</a>" },
+    { ParseInfo::NotParsed, "<!-- c -->" },
+    { ParseInfo::NotParsed, "< a/>" },
+    { ParseInfo::CantStart, "" },             // invalid if empty.
+    { ParseInfo::CantStart, NULL }            // invalid if NULL.
+};
+
+const unsigned long s_nodeTestCount =
+    sizeof(s_nodeTestCases) / sizeof(s_nodeTestCases[0]);
+
+// ----------------------------------------------------------------------------
+
+NodeTester::NodeTester( Parser::Xml::XmlParser * pParser,
+    const CommandLineArgs & argInfo ) :
+    INodeReceiver(),
+    TestBase( "Node", argInfo.DoShowContent(),
+        argInfo.GetErrorLevel(), argInfo.DoShowInfo() ),
+    m_pParser( pParser )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+NodeTester::~NodeTester( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::SetupTest( void )
+{
+    assert( this != NULL );
+    return TestBase::SetupTest( s_nodeTestCases, s_nodeTestCount );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::OnParse( const char * begin, const char * end, unsigned long i )
+{
+    assert( this != NULL );
+
+    Parser::ErrorReceiver * errorCounter = AsErrorReceiver();
+    m_pParser->SetErrorReceiver( errorCounter );
+    INodeReceiver * nodeReceiver = dynamic_cast< INodeReceiver * >( this );
+    const Parser::Xml::XmlParser::ParseResults xmlResult =
+        m_pParser->ParseNode( begin, end, nodeReceiver );
+    const ParseInfo::ParseResult result = Convert( xmlResult );
+
+    return CheckResults( i, result, errorCounter->GetCount() );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::SetTagName( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Tag", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::SetElementName( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Element", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::AddComment( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Comment", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::AddCData( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "CData", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::SetAttributeName( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Attribute Name", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Attribute Value", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::Xml::INodeReceiver * NodeTester::AddChild( void )
+{
+    assert( this != NULL );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeTester::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+    {
+        cout << "Node is valid: [" << ( valid ? "yes" : "no" ) << ']' << endl;
+        PrintContent( "Node", begin, end );
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+const TestData s_documentTestCases[] =
+{
+    { ParseInfo::AllValid,  "<a/>" },
+    { ParseInfo::AllValid,  "<a/>\n" },
+    { ParseInfo::AllValid,  "\n<a>b</a>\n" },
+    { ParseInfo::AllValid,  "<?xml version='1.0'?><a/>" },
+    { ParseInfo::AllValid,  "<?xml version=\"1.0\" standalone='yes'?>\n<!-- c -->\n<a>b</a>\n" },
+    { ParseInfo::AllValid,  "<?xml version='1' encoding='a' ?>\n<a/>" },
+    { ParseInfo::AllValid,  "<!DOCTYPE a><a/>" },
+    { ParseInfo::AllValid,  "<!DOCTYPE a SYSTEM \"a.dtd\">\n<a/>" },
+    { ParseInfo::AllValid,  "<!DOCTYPE a [ <!ELEMENT a ANY> ]>\n<a/>" },
+    { ParseInfo::AllValid,  "<!DOCTYPE a [ <!ENTITY b ']>'> ]><a/>" },
+    { ParseInfo::AllValid,  "<?pi x?><a/><?pi y?>" },
+    { ParseInfo::AllValid,  "<a/><!-- after -->" },
+    { ParseInfo::AllValid,  "<a b='c'><d>e<!-- f --></d><g/></a>" },
+    { ParseInfo::NotValid,  "text" },
+    { ParseInfo::NotValid,  "<!-- c -->" },
+    { ParseInfo::NotValid,  "<?xml version='1.0'?>" },
+    { ParseInfo::NotValid,  "<a/><b/>" },
+    { ParseInfo::NotValid,  "<a/>text" },
+    { ParseInfo::NotValid,  "<a>" },
+    { ParseInfo::NotValid,  "<a></b>" },
+    { ParseInfo::NotValid,  "<a b='1' b='2'/>" },
+    { ParseInfo::NotValid,  "<a>x]]>y</a>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\"2\" ?><a/>" },
+    { ParseInfo::CantStart, "" },             // invalid if empty.
+    { ParseInfo::CantStart, NULL }            // invalid if NULL.
+};
+
+const unsigned long s_documentTestCount =
+    sizeof(s_documentTestCases) / sizeof(s_documentTestCases[0]);
+
+// ----------------------------------------------------------------------------
+
+DocumentTester::DocumentTester( Parser::Xml::XmlParser * pParser,
+    const CommandLineArgs & argInfo, ::Parser::Xml::INodeReceiver * root ) :
+    IDocumentReceiver(),
+    TestBase( "Document", argInfo.DoShowContent(),
+        argInfo.GetErrorLevel(), argInfo.DoShowInfo() ),
+    m_pParser( pParser ),
+    m_root( root )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentTester::~DocumentTester( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentTester::SetupTest( void )
+{
+    assert( this != NULL );
+    return TestBase::SetupTest( s_documentTestCases, s_documentTestCount );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentTester::OnParse( const char * begin, const char * end, unsigned long i )
+{
+    assert( this != NULL );
+
+    Parser::ErrorReceiver * errorCounter = AsErrorReceiver();
+    m_pParser->SetErrorReceiver( errorCounter );
+    IDocumentReceiver * documentReceiver =
+        dynamic_cast< IDocumentReceiver * >( this );
+    const Parser::Xml::XmlParser::ParseResults xmlResult =
+        m_pParser->ParseDocument( begin, end, documentReceiver );
+    const ParseInfo::ParseResult result = Convert( xmlResult );
+
+    return CheckResults( i, result, errorCounter->GetCount() );
+}
+
+// ----------------------------------------------------------------------------
+
+ParseInfo::ParseResult DocumentTester::ParseFile( const char * filename )
+{
+    assert( this != NULL );
+
+    m_pParser->SetErrorReceiver( AsErrorReceiver() );
+    IDocumentReceiver * documentReceiver =
+        dynamic_cast< IDocumentReceiver * >( this );
+    const Parser::Xml::XmlParser::ParseResults xmlResult =
+        m_pParser->ParseFile( filename, documentReceiver );
+    return Convert( xmlResult );
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::Xml::INodeReceiver * DocumentTester::AddRoot( void )
+{
+    assert( this != NULL );
+    return m_root;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentTester::AddComment( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Document Comment", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentTester::SetStandalone( bool standalone )
+{
+    assert( this != NULL );
+
+    if ( ShowContent() )
+        cout << "Standalone: [" << ( standalone ? "yes" : "no" ) << ']' << endl;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentTester::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+    (void)begin;
+    (void)end;
+
+    if ( ShowContent() )
+        cout << "Document is valid: [" << ( valid ? "yes" : "no" ) << ']' << endl;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+FeedTester::FeedTester( const char * name, Parser::Xml::XmlParser * pParser,
+    const CommandLineArgs & argInfo, ::Parser::Xml::INodeReceiver * root,
+    unsigned long chunkSize ) :
+    IDocumentReceiver(),
+    TestBase( name, argInfo.DoShowContent(),
+        argInfo.GetErrorLevel(), argInfo.DoShowInfo() ),
+    m_pParser( pParser ),
+    m_root( root ),
+    m_chunkSize( chunkSize )
+{
+    assert( this != NULL );
+    assert( 0 < chunkSize );
+}
+
+// ----------------------------------------------------------------------------
+
+FeedTester::~FeedTester( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool FeedTester::SetupTest( void )
+{
+    assert( this != NULL );
+    return TestBase::SetupTest( s_documentTestCases, s_documentTestCount );
+}
+
+// ----------------------------------------------------------------------------
+
+bool FeedTester::OnParse( const char * begin, const char * end, unsigned long i )
+{
+    assert( this != NULL );
+
+    Parser::ErrorReceiver * errorCounter = AsErrorReceiver();
+    m_pParser->SetErrorReceiver( errorCounter );
+    IDocumentReceiver * documentReceiver =
+        dynamic_cast< IDocumentReceiver * >( this );
+    Parser::Xml::XmlParser::ParseResults xmlResult =
+        m_pParser->StartFeeding( documentReceiver );
+    if ( Parser::Xml::XmlParser::AllValid == xmlResult )
+    {
+        if ( ( NULL == begin ) || ( begin == end ) )
+            xmlResult = m_pParser->Feed( begin, end );
+        // Each chunk is copied into the same scratch buffer, so the parser
+        // can't depend on a chunk after the call which gave it.
+        string chunk;
+        for ( const char * here = begin; ( NULL != here ) && ( here < end ); )
+        {
+            const unsigned long left = end - here;
+            const unsigned long size = ( m_chunkSize < left ) ? m_chunkSize : left;
+            chunk.assign( here, size );
+            xmlResult = m_pParser->Feed( chunk.data(), chunk.data() + size );
+            here += size;
+        }
+        const Parser::Xml::XmlParser::ParseResults finishResult =
+            m_pParser->Finish();
+        if ( ( Parser::Xml::XmlParser::AllValid == xmlResult )
+          || ( Parser::Xml::XmlParser::NotValid == xmlResult ) )
+            xmlResult = finishResult;
+    }
+    const ParseInfo::ParseResult result = Convert( xmlResult );
+
+    return CheckResults( i, result, errorCounter->GetCount() );
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::Xml::INodeReceiver * FeedTester::AddRoot( void )
+{
+    assert( this != NULL );
+    return m_root;
+}
+
+// ----------------------------------------------------------------------------
+
+bool FeedTester::AddComment( const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+
+    if ( ShowContent() )
+        PrintContent( "Document Comment", begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool FeedTester::SetStandalone( bool standalone )
+{
+    assert( this != NULL );
+
+    if ( ShowContent() )
+        cout << "Standalone: [" << ( standalone ? "yes" : "no" ) << ']' << endl;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool FeedTester::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    assert( begin != NULL );
+    assert( end != NULL );
+    (void)begin;
+    (void)end;
+
+    if ( ShowContent() )
+        cout << "Document is valid: [" << ( valid ? "yes" : "no" ) << ']' << endl;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
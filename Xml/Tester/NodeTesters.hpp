@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+
+// ----------------------------------------------------------------------------
+// Preprocessor directives.
+
+#if !defined( NODE_XML_PARSER_TESTERS_HPP_INCLUDED )
+/// File guardian.
+#define NODE_XML_PARSER_TESTERS_HPP_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+// Included files.
+
+#include "../include/Receivers.hpp"
+#include "../../Util/include/TestUtil.hpp"
+
+namespace Parser
+{
+    namespace Xml
+    {
+        class XmlParser;
+    };
+};
+
+class CommandLineArgs;
+
+
+// ----------------------------------------------------------------------------
+
+class NodeTester : public Parser::Xml::INodeReceiver, public Parser::TestBase
+{
+public:
+
+    NodeTester( Parser::Xml::XmlParser * pParser,
+        const CommandLineArgs & argInfo );
+
+    virtual ~NodeTester( void );
+
+    virtual bool SetupTest( void );
+
+private:
+
+    NodeTester( const NodeTester & );
+    NodeTester & operator = ( const NodeTester & );
+
+    virtual bool OnParse( const char * begin, const char * end, unsigned long i );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual ::Parser::Xml::INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    Parser::Xml::XmlParser * m_pParser;
+};
+
+// ----------------------------------------------------------------------------
+
+class DocumentTester : public Parser::Xml::IDocumentReceiver,
+    public Parser::TestBase
+{
+public:
+
+    DocumentTester( Parser::Xml::XmlParser * pParser,
+        const CommandLineArgs & argInfo, ::Parser::Xml::INodeReceiver * root );
+
+    virtual ~DocumentTester( void );
+
+    virtual bool SetupTest( void );
+
+    /// Parses a file through the same receivers used by the unit tests.
+    ::Parser::ParseInfo::ParseResult ParseFile( const char * filename );
+
+private:
+
+    DocumentTester( const DocumentTester & );
+    DocumentTester & operator = ( const DocumentTester & );
+
+    virtual bool OnParse( const char * begin, const char * end, unsigned long i );
+
+    virtual ::Parser::Xml::INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    Parser::Xml::XmlParser * m_pParser;
+    ::Parser::Xml::INodeReceiver * m_root;
+};
+
+// ----------------------------------------------------------------------------
+
+/// Gives each document test case to the parser a few bytes at a time.
+class FeedTester : public Parser::Xml::IDocumentReceiver,
+    public Parser::TestBase
+{
+public:
+
+    FeedTester( const char * name, Parser::Xml::XmlParser * pParser,
+        const CommandLineArgs & argInfo, ::Parser::Xml::INodeReceiver * root,
+        unsigned long chunkSize );
+
+    virtual ~FeedTester( void );
+
+    virtual bool SetupTest( void );
+
+private:
+
+    FeedTester( const FeedTester & );
+    FeedTester & operator = ( const FeedTester & );
+
+    virtual bool OnParse( const char * begin, const char * end, unsigned long i );
+
+    virtual ::Parser::Xml::INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    Parser::Xml::XmlParser * m_pParser;
+    ::Parser::Xml::INodeReceiver * m_root;
+    unsigned long m_chunkSize;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -140,28 +140,28 @@ const TestData s_externalIdLiteralTestCases[] =
     { ParseInfo::AllValid,  "PUBLIC \"\" \'def\'" },
     { ParseInfo::AllValid,  "PUBLIC  \'abc\'  \'def\'" },
     { ParseInfo::AllValid,  "PUBLIC  \"abc\"  \'def\'" },
-    { ParseInfo::NotParsed, "SYSTEM \"abc\'" },
-    { ParseInfo::NotParsed, "SYSTEM \"abc" },
-    { ParseInfo::NotParsed, "SYSTEM \'abc" },
-    { ParseInfo::NotParsed, "SYSTEM abc\'" },
-    { ParseInfo::NotParsed, "SYSTEM abc\"" },
+    { ParseInfo::NotValid,  "SYSTEM \"abc\'" },
+    { ParseInfo::NotValid,  "SYSTEM \"abc" },
+    { ParseInfo::NotValid,  "SYSTEM \'abc" },
+    { ParseInfo::NotValid,  "SYSTEM abc\'" },
+    { ParseInfo::NotValid,  "SYSTEM abc\"" },
     { ParseInfo::NotParsed, "PUBLIC \"abc\' \'def\'" },
     { ParseInfo::NotParsed, "PUBLIC \"abc \'def\'" },
-    { ParseInfo::NotParsed, "PUBLIC \'abc \'def\'" },
+    { ParseInfo::NotValid,  "PUBLIC \'abc \'def\'" },
     { ParseInfo::NotParsed, "PUBLIC abc\' \'def\'" },
     { ParseInfo::NotParsed, "PUBLIC abc\" \'def\'" },
-    { ParseInfo::NotParsed, "SYSTEM\'abc\'" },
-    { ParseInfo::NotParsed, "SYSTEM\"abc\"" },
+    { ParseInfo::NotValid,  "SYSTEM\'abc\'" },
+    { ParseInfo::NotValid,  "SYSTEM\"abc\"" },
     { ParseInfo::NotParsed, "SYSTEM\n\r\'" },
-    { ParseInfo::NotParsed, "SYSTEM \"" },
-    { ParseInfo::NotParsed, "SYSTEM   " },
-    { ParseInfo::NotParsed, "SYSTEM  \'def" },
+    { ParseInfo::NotValid,  "SYSTEM \"" },
+    { ParseInfo::NotValid,  "SYSTEM   " },
+    { ParseInfo::NotValid,  "SYSTEM  \'def" },
     { ParseInfo::NotParsed, "PUBLIC \'abc\'" },
     { ParseInfo::NotParsed, "PUBLIC\t\"abc\"" },
     { ParseInfo::NotParsed, "PUBLIC\n\r\'\'" },
     { ParseInfo::NotParsed, "PUBLIC \"\"" },
-    { ParseInfo::NotParsed, "PUBLIC  \'abc\' " },
-    { ParseInfo::NotParsed, "PUBLIC  \"abc\"  " },
+    { ParseInfo::NotValid,  "PUBLIC  \'abc\' " },
+    { ParseInfo::NotValid,  "PUBLIC  \"abc\"  " },
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -292,12 +292,12 @@ const TestData s_peReferenceTestCases[] =
     { ParseInfo::AllValid,  "%abc.def;" },
     { ParseInfo::SomeValid, "%ab; " },
     { ParseInfo::SomeValid, "%ab;;" },
-    { ParseInfo::NotParsed, "%aa" },
-    { ParseInfo::NotParsed, "%a ;" },
+    { ParseInfo::NotValid,  "%aa" },
+    { ParseInfo::NotValid,  "%a ;" },
     { ParseInfo::NotParsed, "% a;" },
-    { ParseInfo::NotParsed, "%%a;" },
+    { ParseInfo::NotValid,  "%%a;" },
     { ParseInfo::NotParsed, ";%a;" },
-    { ParseInfo::NotParsed, "%ab%" },
+    { ParseInfo::NotValid,  "%ab%" },
     { ParseInfo::NotParsed, ";" },
     { ParseInfo::NotParsed, "a;" },
     { ParseInfo::CantStart, "" },             // invalid if empty.
@@ -511,24 +511,24 @@ const TestData s_xmlDeclarationTestCases[] =
     { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\"a2 \" ?>" },
     { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\" a2\" ?>" },
     { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\"2\" ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1' encoding=\'a\' standalone='yes\"?>" },
-    { ParseInfo::NotParsed, "<?xml version='1.2' encoding=\"a\"  standalone=\"no'?>" },
-    { ParseInfo::NotParsed, "<?xml version=\"1.0\" encoding  = \"a\"  standalone= ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1'  standalone=no ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1' encoding=\'a\' standalone'yes'?>" },
-    { ParseInfo::NotParsed, "<?xml version='1.2' encoding=\"a\"  Standalone='no'?>" },
-    { ParseInfo::NotParsed, "<?xml version=\"1.0\" encoding  = \"a\"  standalone=yes ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1'  standalone\"no\" ?>" },
-    { ParseInfo::NotParsed, "<?xml encoding=\"a\"  ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding\'a\'?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding\"a\" ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=a\" ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=a\' ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=a ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=\'a\" ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=\'a ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=\"a\' ?>" },
-    { ParseInfo::NotParsed, "<?xml version='1_5' encoding=\"a ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1' encoding=\'a\' standalone='yes\"?>" },
+    { ParseInfo::NotValid,  "<?xml version='1.2' encoding=\"a\"  standalone=\"no'?>" },
+    { ParseInfo::NotValid,  "<?xml version=\"1.0\" encoding  = \"a\"  standalone= ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1'  standalone=no ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1' encoding=\'a\' standalone'yes'?>" },
+    { ParseInfo::NotValid,  "<?xml version='1.2' encoding=\"a\"  Standalone='no'?>" },
+    { ParseInfo::NotValid,  "<?xml version=\"1.0\" encoding  = \"a\"  standalone=yes ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1'  standalone\"no\" ?>" },
+    { ParseInfo::NotValid,  "<?xml encoding=\"a\"  ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding\'a\'?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding\"a\" ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=a\" ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=a\' ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=a ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\'a\" ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\'a ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\"a\' ?>" },
+    { ParseInfo::NotValid,  "<?xml version='1_5' encoding=\"a ?>" },
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -693,21 +693,21 @@ const TestData s_enumTypeTestCases[] =
     { ParseInfo::SomeValid, "NOTATION (a) abc" },
     { ParseInfo::SomeValid, "(a) abc" },
     { ParseInfo::NotParsed, " " },
-    { ParseInfo::NotParsed, "()" },
-    { ParseInfo::NotParsed, "(a|)" },
-    { ParseInfo::NotParsed, "(a|" },
-    { ParseInfo::NotParsed, "(a" },
-    { ParseInfo::NotParsed, "|a)" },
-    { ParseInfo::NotParsed, "(| b |c)" },
-    { ParseInfo::NotParsed, "b |c)" },
-    { ParseInfo::NotParsed, "NOTATION " },
-    { ParseInfo::NotParsed, "NOTATION ()" },
-    { ParseInfo::NotParsed, "NOTATION (a|)" },
-    { ParseInfo::NotParsed, "NOTATION (a|" },
-    { ParseInfo::NotParsed, "NOTATION (a" },
-    { ParseInfo::NotParsed, "NOTATION |a)" },
-    { ParseInfo::NotParsed, "NOTATION (| b |c)" },
-    { ParseInfo::NotParsed, "NOTATION b |c)" },
+    { ParseInfo::NotValid,  "()" },
+    { ParseInfo::NotValid,  "(a|)" },
+    { ParseInfo::NotValid,  "(a|" },
+    { ParseInfo::NotValid,  "(a" },
+    { ParseInfo::NotValid,  "|a)" },
+    { ParseInfo::NotValid,  "(| b |c)" },
+    { ParseInfo::NotValid,  "b |c)" },
+    { ParseInfo::NotValid,  "NOTATION " },
+    { ParseInfo::NotValid,  "NOTATION ()" },
+    { ParseInfo::NotValid,  "NOTATION (a|)" },
+    { ParseInfo::NotValid,  "NOTATION (a|" },
+    { ParseInfo::NotValid,  "NOTATION (a" },
+    { ParseInfo::NotValid,  "NOTATION |a)" },
+    { ParseInfo::NotValid,  "NOTATION (| b |c)" },
+    { ParseInfo::NotValid,  "NOTATION b |c)" },
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -847,33 +847,33 @@ const TestData s_entityValueTestCases[] =
     { ParseInfo::AllValid,  "\"ab\'c\"" },
     { ParseInfo::SomeValid, "\'%ab;\' " },
     { ParseInfo::SomeValid, "\'%ab;\';" },
-    { ParseInfo::NotParsed, "\'%aa\'" },
-    { ParseInfo::NotParsed, "\'%a ;\'" },
-    { ParseInfo::NotParsed, "\'% a;\'" },
-    { ParseInfo::NotParsed, "\'%%a;\'" },
-    { ParseInfo::NotParsed, "\'%ab%\'" },
-    { ParseInfo::NotParsed, "\"&000;\"" },  // invalid entity-reference value.
-    { ParseInfo::NotParsed, "\"&#abc;\"" }, // value is an entity-reference, but prefix is digit-ref.
-    { ParseInfo::NotParsed, "\"&#xFz;\"" }, // invalid hexdigit-reference value.
-    { ParseInfo::NotParsed, "\"&#abc;\"" }, // prefix for digit-ref, but value is hexdigit-reference.
-    { ParseInfo::NotParsed, "\"&;\"" },     // value is missing an entity-reference.
-    { ParseInfo::NotParsed, "\"& abc;\"" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "\"&abc ;\"" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "\"&ab c;\"" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "\"&abc\"" },   // value with entity-reference is missing a semicolon.
-    { ParseInfo::NotParsed, "\"&# 000;\"" }, // value of digit-reference has extra space.
-    { ParseInfo::NotParsed, "\"&# x00;\"" }, // value of hexdigit-reference has extra space.
-    { ParseInfo::NotParsed, "\"&#000 ;\"" }, // value of digit-reference has extra space.
-    { ParseInfo::NotParsed, "\"&#x00 ;\"" }, // value of hexdigit-reference has extra space.
-    { ParseInfo::NotParsed, "\"& #000;\"" }, // value of digit-reference has extra space.
-    { ParseInfo::NotParsed, "\"& #x00;\"" }, // value of hexdigit-reference has extra space.
-    { ParseInfo::NotParsed, "\"abc\'" },
-    { ParseInfo::NotParsed, "\"abc " },
-    { ParseInfo::NotParsed, "\'abc " },
-    { ParseInfo::NotParsed, " \'abc\'" },
-    { ParseInfo::NotParsed, " \"abc\"" },
-    { ParseInfo::NotParsed, "abc\'" },
-    { ParseInfo::NotParsed, "abc\"" },
+    { ParseInfo::NotValid,  "\'%aa\'" },
+    { ParseInfo::NotValid,  "\'%a ;\'" },
+    { ParseInfo::NotValid,  "\'% a;\'" },
+    { ParseInfo::NotValid,  "\'%%a;\'" },
+    { ParseInfo::NotValid,  "\'%ab%\'" },
+    { ParseInfo::NotValid,  "\"&000;\"" },  // invalid entity-reference value.
+    { ParseInfo::NotValid,  "\"&#abc;\"" }, // value is an entity-reference, but prefix is digit-ref.
+    { ParseInfo::NotValid,  "\"&#xFz;\"" }, // invalid hexdigit-reference value.
+    { ParseInfo::NotValid,  "\"&#abc;\"" }, // prefix for digit-ref, but value is hexdigit-reference.
+    { ParseInfo::NotValid,  "\"&;\"" },     // value is missing an entity-reference.
+    { ParseInfo::NotValid,  "\"& abc;\"" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "\"&abc ;\"" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "\"&ab c;\"" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "\"&abc\"" },   // value with entity-reference is missing a semicolon.
+    { ParseInfo::NotValid,  "\"&# 000;\"" }, // value of digit-reference has extra space.
+    { ParseInfo::NotValid,  "\"&# x00;\"" }, // value of hexdigit-reference has extra space.
+    { ParseInfo::NotValid,  "\"&#000 ;\"" }, // value of digit-reference has extra space.
+    { ParseInfo::NotValid,  "\"&#x00 ;\"" }, // value of hexdigit-reference has extra space.
+    { ParseInfo::NotValid,  "\"& #000;\"" }, // value of digit-reference has extra space.
+    { ParseInfo::NotValid,  "\"& #x00;\"" }, // value of hexdigit-reference has extra space.
+    { ParseInfo::NotValid,  "\"abc\'" },
+    { ParseInfo::NotValid,  "\"abc " },
+    { ParseInfo::NotValid,  "\'abc " },
+    { ParseInfo::NotValid,  " \'abc\'" },
+    { ParseInfo::NotValid,  " \"abc\"" },
+    { ParseInfo::NotValid,  "abc\'" },
+    { ParseInfo::NotValid,  "abc\"" },
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -1070,24 +1070,24 @@ const TestData s_attListDeclTestCases[] =
     { ParseInfo::AllValid,  "<!ATTLIST abc def ID #FIXED \"b&#xbc;\">" }, // test single-quoted attribute with value and reference.
     { ParseInfo::AllValid,  "<!ATTLIST abc def ID #FIXED \"&#000;&#xbc;\">" },  // test single-quoted attribute with value and reference.
     { ParseInfo::AllValid,  "<!ATTLIST abc def ID #FIXED \"&#000;\">" }, // test single-quoted attribute with value.
-    { ParseInfo::NotParsed, "<!ATTLIST a ()>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a (a|)>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a (a|>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a (a>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a |a)>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a (| b |c)>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a b |c)>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION (a|b)#IMPLIED>" }, //
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION ( a | b )#IMPLIED>" }, //
-    { ParseInfo::NotParsed, "<!ATTLIST a ( a | b )#IMPLIED>" }, //
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION #IMPLIED>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION () #IMPLIED >" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION (a|) #IMPLIED >" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION (a| #IMPLIED>" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION (a #IMPLIED >" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION |a) #IMPLIED >" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION (| b |c) #IMPLIED >" },
-    { ParseInfo::NotParsed, "<!ATTLIST a NOTATION b |c) #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a ()>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a (a|)>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a (a|>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a (a>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a |a)>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a (| b |c)>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a b |c)>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION (a|b)#IMPLIED>" }, //
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION ( a | b )#IMPLIED>" }, //
+    { ParseInfo::NotValid,  "<!ATTLIST a ( a | b )#IMPLIED>" }, //
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION #IMPLIED>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION () #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION (a|) #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION (a| #IMPLIED>" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION (a #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION |a) #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION (| b |c) #IMPLIED >" },
+    { ParseInfo::NotValid,  "<!ATTLIST a NOTATION b |c) #IMPLIED >" },
     { ParseInfo::NotParsed, "<! ATTLIST abc def CDATA #IMPLIED>" },
     { ParseInfo::NotParsed, "< !ATTLIST abc def CDATA #IMPLIED>" },
     { ParseInfo::NotParsed, "<!AttList abc def CDATA #IMPLIED>" },
@@ -1095,24 +1095,24 @@ const TestData s_attListDeclTestCases[] =
     { ParseInfo::NotParsed, "<!ATTLISTabc def CDATA #IMPLIED>" },
     { ParseInfo::NotParsed, "!ATTLIST abc def CDATA #IMPLIED>" },
     { ParseInfo::NotParsed, "!ATTLIST abc def CDATA #IMPLIED>" },
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID \'b>" },        // invalid if no ending single-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID \"b>" },        // invalid if no ending double-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID b\'>" },        // invalid if no starting single-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID b\">" },        // invalid if no starting double-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID \"b\'>" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'&;\'>" },     // value is missing an entity-reference.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'& abc;\'>" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'&abc ;\'>" }, // value of entity-reference has extra space.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'&abc\'>" },   // value with entity-reference is missing a semicolon.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'b>" },        // invalid if no ending single-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \"b>" },        // invalid if no ending double-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED b\'>" },        // invalid if no starting single-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED b\">" },        // invalid if no starting double-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \"b\'>" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'b\">" },      // invalid if starting quote does not match ending quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED A>" },          // invalid if name only.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \'>" },         // invalid if nothing after single-quote.
-    { ParseInfo::NotParsed, "<!ATTLIST abc def ID #FIXED \">" },         // invalid if nothing after double-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID \'b>" },        // invalid if no ending single-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID \"b>" },        // invalid if no ending double-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID b\'>" },        // invalid if no starting single-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID b\">" },        // invalid if no starting double-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID \"b\'>" },      // invalid if starting quote does not match ending quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'&;\'>" },     // value is missing an entity-reference.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'& abc;\'>" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'&abc ;\'>" }, // value of entity-reference has extra space.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'&abc\'>" },   // value with entity-reference is missing a semicolon.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'b>" },        // invalid if no ending single-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \"b>" },        // invalid if no ending double-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED b\'>" },        // invalid if no starting single-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED b\">" },        // invalid if no starting double-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \"b\'>" },      // invalid if starting quote does not match ending quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'b\">" },      // invalid if starting quote does not match ending quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED A>" },          // invalid if name only.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \'>" },         // invalid if nothing after single-quote.
+    { ParseInfo::NotValid,  "<!ATTLIST abc def ID #FIXED \">" },         // invalid if nothing after double-quote.
     { ParseInfo::CantStart, "" },             // invalid if empty.
     { ParseInfo::CantStart, NULL }            // invalid if NULL.
 };
@@ -0,0 +1,248 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ReaderTester.cpp Steps XmlReaders through documents.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ReaderTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlReader.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Documents for replays.  Some are not valid, so replays of broken and
+/// unclosed elements are compared too.
+const char * const s_inputs[] =
+{
+    "<?xml version=\"1.0\" standalone=\"no\"?>\n"
+    "<!-- first -->\n"
+    "<root a=\"1\" b='two'>\n"
+    "  <child>text &amp; more &#65;</child>\n"
+    "  <empty/>\n"
+    "  <![CDATA[ <raw> ]]>\n"
+    "  <!-- inner -->\n"
+    "  <a><b><c x=\"y\">deep</c></b></a>\n"
+    "</root>\n"
+    "<!-- last -->\n",
+    "<root><open></root>",
+    "<root><bad attr></bad><good/></root>",
+    "<root>text & more</root>",
+    "<a b=\"<\"/>",
+    "<r><a b='x<y'>z</a></r>",
+};
+
+const unsigned int s_inputCount = sizeof( s_inputs ) / sizeof( s_inputs[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Adds checks of reader tokens to the shared counts.
+class Checker : public TestChecker
+{
+public:
+
+    Checker( void ) : TestChecker( "Reader" ) {}
+
+    /// Checks the next token has the kind, depth, and text.
+    void CheckNext( XmlReader & reader, XmlReader::Tokens kind,
+        unsigned long depth, const char * text )
+    {
+        const XmlReader::Tokens found = reader.Next();
+        const bool passed = ( found == kind ) && ( reader.GetDepth() == depth )
+            && ( ( NULL == text ) || reader.Equals( text ) );
+        Check( passed, XmlReader::GetTokenName( kind ) );
+        if ( !passed )
+        {
+            const char * begin = reader.GetBegin();
+            cout << "  Found: " << XmlReader::GetTokenName( found ) << " ["
+                << reader.GetDepth() << "] ["
+                << ( ( NULL == begin ) ? string() : string( begin, reader.GetEnd() - begin ) )
+                << "]\tExpected: [" << depth << "] [" << ( ( NULL == text ) ? "" : text ) << "]\n";
+        }
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+void CheckTokens( Checker & checker, XmlParser & parser )
+{
+    const char document[] =
+        "<!-- c --><root a=\"1&amp;2\"><x>t</x><![CDATA[d]]><y/></root>";
+    XmlReader reader( parser );
+    const XmlParser::ParseResults result = reader.Open( document,
+        document + sizeof( document ) - 1 );
+    checker.Check( XmlParser::AllValid == result, "Document opened." );
+    checker.Check( XmlReader::None == reader.GetToken(), "Cursor starts before first token." );
+    checker.Check( 0 == reader.GetTokenCount(), "Nothing is parsed before Next." );
+    checker.Check( XmlParser::ParsingNow == reader.GetResult(), "Result not known yet." );
+
+    checker.CheckNext( reader, XmlReader::Comment, 0, " c " );
+    checker.Check( 1 == reader.GetTokenCount(), "Only the comment is parsed." );
+    checker.CheckNext( reader, XmlReader::StartElement, 0, "root" );
+    checker.Check( 5 == reader.GetTokenCount(), "Only the start tag of root is parsed." );
+    checker.CheckNext( reader, XmlReader::AttributeName, 0, "a" );
+    checker.CheckNext( reader, XmlReader::AttributeValue, 0, "1&amp;2" );
+    checker.CheckNext( reader, XmlReader::TagEnd, 0, "<root a=\"1&amp;2\">" );
+    checker.CheckNext( reader, XmlReader::StartElement, 1, "x" );
+    checker.CheckNext( reader, XmlReader::TagEnd, 1, "<x>" );
+    checker.CheckNext( reader, XmlReader::Text, 2, "t" );
+    checker.CheckNext( reader, XmlReader::EndElement, 1, "<x>t</x>" );
+    checker.Check( reader.IsValid(), "Element x is valid." );
+    checker.CheckNext( reader, XmlReader::CData, 1, "d" );
+    checker.CheckNext( reader, XmlReader::StartElement, 1, "y" );
+    checker.CheckNext( reader, XmlReader::TagEnd, 1, "<y/>" );
+    checker.CheckNext( reader, XmlReader::EndElement, 1, "<y/>" );
+    checker.CheckNext( reader, XmlReader::EndElement, 0, NULL );
+    checker.CheckNext( reader, XmlReader::EndDocument, 0, NULL );
+    checker.Check( reader.IsValid(), "Document is valid." );
+    checker.Check( XmlParser::AllValid == reader.GetResult(), "Document parsed as valid." );
+    checker.Check( XmlReader::None == reader.Next(), "No tokens after EndDocument." );
+    checker.Check( XmlReader::None == reader.Next(), "Still no tokens after EndDocument." );
+
+    // Skip whole root element after reading its name.
+    reader.Rewind();
+    checker.CheckNext( reader, XmlReader::Comment, 0, " c " );
+    checker.CheckNext( reader, XmlReader::StartElement, 0, "root" );
+    reader.SkipElement();
+    checker.CheckNext( reader, XmlReader::EndElement, 0, NULL );
+    checker.CheckNext( reader, XmlReader::EndDocument, 0, NULL );
+
+    // Skip first child, and read the rest.
+    reader.Rewind();
+    unsigned long starts = 0;
+    while ( XmlReader::None != reader.Next() )
+    {
+        if ( XmlReader::StartElement != reader.GetToken() )
+            continue;
+        ++starts;
+        if ( reader.Equals( "x" ) )
+        {
+            reader.SkipElement();
+            checker.CheckNext( reader, XmlReader::EndElement, 1, "<x>t</x>" );
+        }
+    }
+    checker.Check( 3 == starts, "Skipping x still finds root and y." );
+
+    reader.Close();
+    checker.Check( 0 == reader.GetTokenCount(), "Close drops tokens." );
+    checker.Check( XmlReader::None == reader.Next(), "No tokens after Close." );
+
+    // Skip root before its content is parsed, and stop partway.
+    reader.Open( document, document + sizeof( document ) - 1 );
+    checker.CheckNext( reader, XmlReader::Comment, 0, " c " );
+    checker.CheckNext( reader, XmlReader::StartElement, 0, "root" );
+    reader.SkipElement();
+    checker.CheckNext( reader, XmlReader::EndElement, 0, NULL );
+    checker.Check( reader.IsValid(), "Skipped root is valid." );
+    reader.Open( document, document + sizeof( document ) - 1 );
+    checker.CheckNext( reader, XmlReader::Comment, 0, " c " );
+    reader.Close();
+    CallRecorder direct;
+    checker.Check( XmlParser::AllValid == parser.ParseDocument( document,
+        document + sizeof( document ) - 1, &direct ), "Parser is free once reader closes." );
+}
+
+// ----------------------------------------------------------------------------
+
+/// Reads a tag with a '<' in an attribute value, which the parser rejects.
+void CheckBadValue( Checker & checker, XmlParser & parser )
+{
+    const char document[] = "<a b=\"<\"/>";
+    const char * const end = document + sizeof( document ) - 1;
+    CallRecorder direct;
+    const XmlParser::ParseResults directResult =
+        parser.ParseDocument( document, end, &direct );
+
+    XmlReader reader( parser );
+    reader.Open( document, end );
+    checker.CheckNext( reader, XmlReader::StartElement, 0, "a" );
+    checker.CheckNext( reader, XmlReader::AttributeName, 0, "b" );
+    checker.CheckNext( reader, XmlReader::TagEnd, 0, document );
+    checker.CheckNext( reader, XmlReader::EndElement, 0, document );
+    checker.Check( !reader.IsValid(), "Element with bad value is not valid." );
+    checker.CheckNext( reader, XmlReader::EndDocument, 0, NULL );
+    checker.Check( XmlReader::None == reader.Next(), "No text token for rest of tag." );
+    checker.Check( XmlParser::NotValid == directResult, "Parser rejects the value." );
+    checker.Check( directResult == reader.GetResult(), "Reader returns what parser returns." );
+}
+
+// ----------------------------------------------------------------------------
+
+void CheckReplays( Checker & checker, XmlParser & parser )
+{
+    XmlReader reader( parser );
+    for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+    {
+        const char * begin = s_inputs[ ii ];
+        const char * end = begin + ::strlen( begin );
+
+        CallRecorder direct;
+        const XmlParser::ParseResults directResult =
+            parser.ParseDocument( begin, end, &direct );
+        checker.Check( XmlParser::AllValid == reader.Open( begin, end ), "Reader opens." );
+
+        CallRecorder replayed;
+        checker.Check( reader.Replay( &replayed ), "Replay reaches end." );
+        checker.Check( directResult == reader.GetResult(), "Reader returns what parser returns." );
+        const bool same = ( direct.m_calls == replayed.m_calls );
+        checker.Check( same, "Replay makes the same calls as the parser." );
+        if ( !same )
+        {
+            cout << "Parser calls:\n" << direct.m_calls << "Replay calls:\n"
+                << replayed.m_calls;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoReaderTests( bool showSummary )
+{
+    Checker checker;
+    QuietReceiver receiver;
+    XmlParser parser;
+    parser.SetErrorReceiver( &receiver );
+    CheckTokens( checker, parser );
+    CheckBadValue( checker, parser );
+    CheckReplays( checker, parser );
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
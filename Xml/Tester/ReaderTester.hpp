@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ReaderTester.hpp Checks tokens from XmlReader, and replays of them.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_READER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_READER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Steps an XmlReader through documents and checks each token, checks that
+ skipped elements resume at their end tokens, and checks that receivers given
+ a replay of the tokens get the same calls as receivers given to the parser.
+ @param showSummary True to show how many checks passed.
+ @return True if all checks passed.
+ */
+bool DoReaderTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
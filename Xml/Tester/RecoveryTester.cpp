@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file RecoveryTester.cpp Parses documents with several separate errors.
+
+
+// ----------------------------------------------------------------------------
+
+#include "RecoveryTester.hpp"
+
+#include <assert.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlParser.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Holds a malformed document, the one message each of its errors should
+/// give, and receiver calls which only come if parsing goes on past them.
+struct RecoveryData
+{
+    const char * m_document;
+    const char * m_messages;
+    const char * m_calls[ 4 ];
+};
+
+const RecoveryData s_recoveryData[] =
+{
+    {
+        "<root>\n"
+        "<!-- bad -- comment -->\n"
+        "<first b>one</first>\n"
+        "<second c=d>two</second>\n"
+        "<third e='&bad ;'>three</third>\n"
+        "<last/>\n"
+        "</root>\n",
+
+        "Minor: Found start of comment, but not end of comment.\n"
+        "Minor: Found name but no equal sign for attribute.\n"
+        "Major: Unable to parse attribute value - skipping rest of content.\n"
+        "Minor: Found name for entity reference but no ending semicolon.\n",
+
+        {
+            "DoneNode invalid [<first b>one</first>]\n",
+            "DoneNode invalid [<second c=d>two</second>]\n",
+            "DoneNode invalid [<third e='&bad ;'>three</third>]\n",
+            "DoneNode valid [<last/>]\n",
+        }
+    },
+    {
+        "<?xml version='1.0' encoding='%bad'?>\n"
+        "<!-- a -- b -->\n"
+        "<root a='&#xZ;' b=\"x\">\n"
+        "<x y/>\n"
+        "<z/>\n"
+        "</root>\n",
+
+        "Major: Unable to parse single-quoted encoding - skipping rest of content.\n"
+        "Minor: Found start of comment, but not end of comment.\n"
+        "Minor: Name has an invalid character.\n"
+        "Minor: Found name but no equal sign for attribute.\n",
+
+        {
+            "SetAttributeValue [x]\n",
+            "DoneNode invalid [<x y/>]\n",
+            "DoneNode valid [<z/>]\n",
+            "DoneDocument invalid [",
+        }
+    },
+};
+
+const unsigned long s_recoveryCount = sizeof( s_recoveryData ) / sizeof( s_recoveryData[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Parses one malformed document and checks its result, messages, and calls.
+void CheckRecovery( TestChecker & checker, XmlParser & parser,
+    MessageCollector & collector, const RecoveryData & data )
+{
+    const string document( data.m_document );
+    string messages;
+    collector.SetTarget( &messages, NULL );
+    CallRecorder recorder;
+    const XmlParser::ParseResults result = parser.ParseDocument(
+        document.c_str(), document.c_str() + document.size(), &recorder );
+    collector.SetTarget( NULL, NULL );
+
+    if ( !checker.Check( XmlParser::NotValid == result,
+        "Document with errors is parsed but not valid." ) )
+        cout << document;
+    if ( !checker.Check( messages == data.m_messages, "Each error gives one message." ) )
+        cout << messages;
+    for ( unsigned int ii = 0; ii < sizeof( data.m_calls ) / sizeof( data.m_calls[ 0 ] ); ++ii )
+    {
+        if ( !checker.Check( string::npos != recorder.m_calls.find( data.m_calls[ ii ] ),
+            "Parsing goes on past each error." ) )
+            cout << data.m_calls[ ii ];
+    }
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoRecoveryTests( bool showSummary )
+{
+    TestChecker checker( "Recovery" );
+    XmlParser parser;
+    MessageCollector collector;
+    parser.SetErrorReceiver( &collector );
+
+    for ( unsigned int fast = 0; fast < 2; ++fast )
+    {
+        parser.SetFastScanning( 0 != fast );
+        for ( unsigned long ii = 0; ii < s_recoveryCount; ++ii )
+            CheckRecovery( checker, parser, collector, s_recoveryData[ ii ] );
+    }
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
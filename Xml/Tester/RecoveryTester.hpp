@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file RecoveryTester.hpp Parses documents with several separate errors.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_RECOVERY_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_RECOVERY_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses documents which have several bad comments, attributes, references,
+ and declarations in different places, and checks each error gets exactly one
+ message, the document is parsed but not valid, and the receiver still gets
+ the elements after each error.  Done with fast scanning on and off.
+ @param showSummary True to show counts.
+ @return True if all checks passed.
+ */
+bool DoRecoveryTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
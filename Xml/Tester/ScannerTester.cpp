@@ -0,0 +1,268 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ScannerTester.cpp Parses start tags into sinks known when compiling.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ScannerTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlScanners.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/** @class TagSink
+ Has the functions ParseStartTag calls, but no virtual functions, and writes
+ each call the same way CallRecorder does.
+ */
+class TagSink
+{
+public:
+
+    TagSink( void ) : m_calls(), m_stopName( NULL ) {}
+
+    bool SetTagName( const char * begin, const char * end )
+    {
+        return Add( "SetTagName", begin, end );
+    }
+
+    bool SetElementName( const char * begin, const char * end )
+    {
+        Add( "SetElementName", begin, end );
+        return ( NULL == m_stopName )
+            || ( ::strlen( m_stopName ) != static_cast< size_t >( end - begin ) )
+            || ( 0 != ::strncmp( begin, m_stopName, end - begin ) );
+    }
+
+    bool SetAttributeName( const char * begin, const char * end )
+    {
+        return Add( "SetAttributeName", begin, end );
+    }
+
+    bool SetAttributeValue( const char * begin, const char * end )
+    {
+        return Add( "SetAttributeValue", begin, end );
+    }
+
+    bool DoneNode( bool valid, const char * begin, const char * end )
+    {
+        return Add( valid ? "DoneNode valid" : "DoneNode invalid", begin, end );
+    }
+
+    string m_calls;
+    const char * m_stopName;
+
+private:
+
+    bool Add( const char * call, const char * begin, const char * end )
+    {
+        m_calls += call;
+        m_calls += " [";
+        m_calls.append( begin, end - begin );
+        m_calls += "]\n";
+        return true;
+    }
+
+};
+
+// ----------------------------------------------------------------------------
+
+/// Holds a tag, and the result and calls the rules give for it.
+struct TagData
+{
+    const char * m_tag;
+    XmlParser::ParseResults m_result;
+    const char * m_calls;
+};
+
+/// The scanners take the valid tags whole.  The others go to the rules.
+const TagData s_tagData[] =
+{
+    { "<a>", XmlParser::AllValid,
+        "SetElementName [a]\nSetTagName [<a>]\n" },
+    { "<a/>", XmlParser::AllValid,
+        "SetElementName [a]\nSetTagName [<a/>]\nDoneNode valid [<a/>]\n" },
+    { "<a b='c'>", XmlParser::AllValid,
+        "SetElementName [a]\nSetAttributeName [b]\nSetAttributeValue [c]\n"
+        "SetTagName [<a b='c'>]\n" },
+    { "<a\tb = \"c\"\nd='1&amp;2' />", XmlParser::AllValid,
+        "SetElementName [a]\nSetAttributeName [b]\nSetAttributeValue [c]\n"
+        "SetAttributeName [d]\nSetAttributeValue [1&amp;2]\n"
+        "SetTagName [<a\tb = \"c\"\nd='1&amp;2' />]\n"
+        "DoneNode valid [<a\tb = \"c\"\nd='1&amp;2' />]\n" },
+    { "<a b='' c=\"x\">", XmlParser::AllValid,
+        "SetElementName [a]\nSetAttributeName [b]\nSetAttributeValue []\n"
+        "SetAttributeName [c]\nSetAttributeValue [x]\n"
+        "SetTagName [<a b='' c=\"x\">]\n" },
+    { "<a b='c' b='d'>", XmlParser::NotValid,
+        "" },
+    { "<a b='c'd='e'>", XmlParser::NotValid,
+        "" },
+    { "<a b=c>", XmlParser::NotValid,
+        "" },
+    { "<a b>", XmlParser::NotValid,
+        "" },
+    { "<a b='%x'>", XmlParser::NotValid,
+        "" },
+    { "<a b='<'>", XmlParser::NotValid,
+        "" },
+    { "<a b='&bad ;'>", XmlParser::NotValid,
+        "" },
+    { "<a b='c'", XmlParser::NotValid,
+        "" },
+    { "<a b='c'>text", XmlParser::SomeValid,
+        "SetElementName [a]\nSetAttributeName [b]\nSetAttributeValue [c]\n"
+        "SetTagName [<a b='c'>]\n" },
+    { "<1a>", XmlParser::NotParsed,
+        "" },
+};
+
+const unsigned long s_tagCount = sizeof( s_tagData ) / sizeof( s_tagData[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Writes result, calls, and messages into one string.
+string Output( XmlParser::ParseResults result, const string & calls,
+    const string & messages )
+{
+    char number[ 24 ];
+    ::sprintf( number, "Result %d\n", static_cast< int >( result ) );
+    return number + calls + messages;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Parses a tag into the sink, through the virtual INodeReceiver instantiation,
+ and through XmlParser, and checks all three give the output the rules give.
+ */
+void CheckTag( TestChecker & checker, XmlParser & parser, MessageCollector & collector,
+    const string & tag, const char * stopName, const string & expected )
+{
+    const char * begin = tag.c_str();
+    const char * end = begin + tag.size();
+    string messages;
+
+    collector.SetTarget( &messages, NULL );
+    TagSink sink;
+    sink.m_stopName = stopName;
+    XmlParser::ParseResults result = ParseStartTag( parser, begin, end, sink );
+    if ( !checker.Check( Output( result, sink.m_calls, messages ) == expected,
+        "Sink gets the same calls as the rules make." ) )
+        cout << tag << '\n' << Output( result, sink.m_calls, messages );
+
+    messages.clear();
+    CallRecorder recorder;
+    recorder.SetStopName( stopName );
+    INodeReceiver & receiver = recorder;
+    result = ParseStartTag( parser, begin, end, receiver );
+    if ( !checker.Check( Output( result, recorder.m_calls, messages ) == expected,
+        "Receiver gets the same calls as the sink." ) )
+        cout << tag << '\n' << Output( result, recorder.m_calls, messages );
+
+    messages.clear();
+    CallRecorder other;
+    other.SetStopName( stopName );
+    result = parser.ParseStartTag( begin, end, &other );
+    checker.Check( Output( result, other.m_calls, messages ) == expected,
+        "XmlParser gives a tag to a receiver the same way." );
+    collector.SetTarget( NULL, NULL );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoScannerTests( bool showSummary )
+{
+    TestChecker checker( "Scanner" );
+    XmlParser parser;
+    MessageCollector collector;
+    parser.SetErrorReceiver( &collector );
+
+    for ( unsigned long ii = 0; ii < s_tagCount; ++ii )
+    {
+        const TagData & data = s_tagData[ ii ];
+        const string tag( data.m_tag );
+        const char * begin = tag.c_str();
+        const char * end = begin + tag.size();
+
+        // What the rules alone give is what every other way must give.
+        parser.SetFastScanning( false );
+        string messages;
+        collector.SetTarget( &messages, NULL );
+        CallRecorder recorder;
+        const XmlParser::ParseResults result = parser.ParseStartTag( begin, end, &recorder );
+        collector.SetTarget( NULL, NULL );
+        if ( !checker.Check( data.m_result == result, "Rules give expected result." ) )
+            cout << tag << '\n' << Output( result, "", "" );
+        const bool good = ( XmlParser::AllValid == result )
+            || ( XmlParser::SomeValid == result );
+        if ( good && !checker.Check(
+            data.m_calls == recorder.m_calls, "Rules give expected calls." ) )
+            cout << tag << '\n' << recorder.m_calls;
+        if ( !checker.Check( messages.empty() == good,
+            "Only a bad tag gives messages." ) )
+            cout << tag << '\n' << messages;
+        const string expected( Output( result, recorder.m_calls, messages ) );
+
+        for ( unsigned int fast = 0; fast < 2; ++fast )
+        {
+            parser.SetFastScanning( 0 != fast );
+            CheckTag( checker, parser, collector, tag, NULL, expected );
+        }
+
+        // A valid empty tag gets the same calls as a whole node.
+        if ( ( XmlParser::AllValid == result ) && ( '/' == end[ -2 ] ) )
+        {
+            CallRecorder node;
+            parser.ParseNode( begin, end, &node );
+            checker.Check( node.m_calls == recorder.m_calls,
+                "Empty tag gets the same calls as in ParseNode." );
+        }
+    }
+
+    // Calls stop once the sink refuses a name, on either path.
+    for ( unsigned int fast = 0; fast < 2; ++fast )
+    {
+        parser.SetFastScanning( 0 != fast );
+        CheckTag( checker, parser, collector, "<stop b='c'/>", "stop",
+            Output( XmlParser::AllValid, "SetElementName [stop]\n", "" ) );
+    }
+
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ScannerTester.hpp Parses start tags into sinks known when compiling.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_SCANNER_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_SCANNER_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses start tags with the ParseStartTag template into a sink which is not
+ a receiver, and into an INodeReceiver, with fast scanning on and off, and
+ checks each way gives the same calls, results, and messages.  Some tags are
+ taken by the scanners, and some are handed to the grammar rules.
+ @param showSummary True to show counts.
+ @return True if all checks passed.
+ */
+bool DoScannerTests( bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
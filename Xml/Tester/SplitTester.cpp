@@ -0,0 +1,220 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SplitTester.cpp Parses large documents in pieces with an XmlSplitParser.
+
+
+// ----------------------------------------------------------------------------
+
+#include "SplitTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+
+#include "../../Util/include/BatchRunner.hpp"
+#include "../../Util/include/TestUtil.hpp"
+#include "../include/XmlSplitParser.hpp"
+
+#include "TestHelpers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Small, so a test document has many pieces.
+const unsigned long s_pieceSize = 1500;
+
+/// Where errors go in a broken document.
+enum Breaks
+{
+    NoBreak,
+    EarlyBreak,
+    LateBreak
+};
+
+// ----------------------------------------------------------------------------
+
+/** Makes a document with elements nested in sections, so most pieces start
+ inside open elements, and with comments, CDATA sections, and processing
+ instructions which hold things that look like tags, so some pieces start
+ inside them.
+ */
+string MakeDocument( unsigned long itemCount, Breaks breakAt )
+{
+    string text;
+    text += "<?xml version=\"1.0\" standalone=\"yes\"?>\n"
+        "<!-- prolog <item id=\"fake\"> -->\n"
+        "<!DOCTYPE root [ <!ENTITY e \"<x>\"> ]>\n"
+        "<root kind=\"split\">\n";
+    char line[ 160 ];
+    for ( unsigned long ii = 0; ii < itemCount; ++ii )
+    {
+        if ( 0 == ii % 40 )
+        {
+            ::sprintf( line, "<section n=\"%lu\">\n", ii / 40 );
+            text += line;
+        }
+        if ( ( ( EarlyBreak == breakAt ) && ( 3 == ii ) )
+          || ( ( LateBreak == breakAt ) && ( itemCount * 2 / 3 == ii ) ) )
+            text += "<bad></wrong>\n";
+        switch ( ii % 6 )
+        {
+            case 0:
+                ::sprintf( line, "  <item id=\"%lu\" name='n&amp;%lu'>text &lt; %lu &#65;</item>\n",
+                    ii, ii, ii );
+                break;
+            case 1:
+                ::sprintf( line, "  <group n=\"%lu\"><a>one</a><b/><c x=\"1\">two<d>three</d></c></group>\n",
+                    ii );
+                break;
+            case 2:
+                ::sprintf( line, "  <!-- comment %lu <item id=\"fake\"> </item> -->\n", ii );
+                break;
+            case 3:
+                ::sprintf( line, "  <data><![CDATA[ <item>%lu not a tag</item> <x> ]]></data>\n", ii );
+                break;
+            case 4:
+                ::sprintf( line, "  <?target <item> %lu ?>\n", ii );
+                break;
+            default:
+                ::sprintf( line, "  <stop at=\"%lu\">skipped <z/> text</stop>\n", ii );
+                break;
+        }
+        text += line;
+        if ( ( 39 == ii % 40 ) || ( itemCount == ii + 1 ) )
+            text += "</section>\n";
+    }
+    text += "</root>\n<!-- trailing <item> -->\n";
+    return text;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses a document both ways and compares calls, results, and messages.
+void CheckDocument( TestChecker & checker, XmlSplitParser & splitter,
+    const string & document, Breaks breakAt, bool useStop, bool small )
+{
+    const char * begin = document.c_str();
+    const char * end = begin + document.size();
+
+    XmlParser parser;
+    MessageCollector parserMessages;
+    string expectedMessages;
+    parserMessages.SetTarget( &expectedMessages, NULL );
+    parser.SetErrorReceiver( &parserMessages );
+    CallRecorder expected( begin );
+    expected.SetStopName( useStop ? "stop" : NULL );
+    const XmlParser::ParseResults expectedResult = parser.ParseDocument( begin, end, &expected );
+
+    MessageCollector splitMessages;
+    string messages;
+    splitMessages.SetTarget( &messages, NULL );
+    splitter.SetErrorReceiver( &splitMessages );
+    CallRecorder received( begin );
+    received.SetStopName( useStop ? "stop" : NULL );
+    const XmlParser::ParseResults result = splitter.ParseDocument( begin, end, &received );
+    const XmlSplitStats stats = splitter.GetSplitStats();
+
+    checker.Check( result == expectedResult, "Result is the same as one pass." );
+    checker.Check( messages == expectedMessages, "Messages are the same as one pass." );
+    checker.Check( small == ( 0 == stats.m_pieces ), "Document is split only if large." );
+    if ( NoBreak == breakAt )
+    {
+        checker.Check( XmlParser::AllValid == result, "Document is valid." );
+        checker.Check( !stats.m_reparsed, "Valid document is parsed once." );
+        if ( !small )
+        {
+            checker.Check( 0 < stats.m_rescans, "Some guessed starts were inside items." );
+            checker.Check( 1 < stats.m_rounds, "Pieces were parsed in several rounds." );
+        }
+    }
+    else
+    {
+        checker.Check( XmlParser::AllValid != result, "Broken document is not valid." );
+    }
+
+    if ( ( NoBreak == breakAt ) || ( EarlyBreak == breakAt ) )
+    {
+        const bool same = ( expected.m_calls == received.m_calls );
+        checker.Check( same, "Receivers get the same calls as one pass." );
+        if ( !same )
+        {
+            const string & a = expected.m_calls;
+            const string & b = received.m_calls;
+            string::size_type at = 0;
+            while ( ( at < a.size() ) && ( at < b.size() ) && ( a[ at ] == b[ at ] ) )
+                ++at;
+            at = ( 200 < at ) ? at - 200 : 0;
+            cout << "One pass:\n" << a.substr( at, 400 ) << "\nSplit:\n"
+                << b.substr( at, 400 ) << '\n';
+        }
+        return;
+    }
+
+    // Calls stop between pieces, then open elements and the document are done.
+    string::size_type tail = received.m_calls.find( "DoneNode invalid" );
+    if ( string::npos == tail )
+        tail = received.m_calls.find( "DoneDocument invalid" );
+    checker.Check( string::npos != tail, "Open elements are done as not valid." );
+    if ( string::npos == tail )
+        return;
+    checker.Check( 0 == expected.m_calls.compare( 0, tail, received.m_calls, 0, tail ),
+        "Calls before the broken piece are the same as one pass." );
+    const string::size_type last = received.m_calls.rfind( "DoneDocument invalid" );
+    checker.Check( ( string::npos != last )
+        && ( received.m_calls.find( '\n', last ) + 1 == received.m_calls.size() ),
+        "Document is done last, as not valid." );
+    checker.Check( stats.m_reparsed, "Broken document is parsed again for messages." );
+}
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoSplitTests( unsigned int threadCount, bool showSummary )
+{
+    TestChecker checker( "Split" );
+    XmlSplitParser splitter( threadCount );
+    splitter.SetPieceSize( s_pieceSize );
+    checker.Check( s_pieceSize == splitter.GetPieceSize(), "Piece size is kept." );
+
+    const string large = MakeDocument( 3000, NoBreak );
+    CheckDocument( checker, splitter, large, NoBreak, false, false );
+    const XmlSplitStats stats = splitter.GetSplitStats();
+    CheckDocument( checker, splitter, large, NoBreak, true, false );
+    CheckDocument( checker, splitter, MakeDocument( 3000, EarlyBreak ), EarlyBreak, false, false );
+    CheckDocument( checker, splitter, MakeDocument( 3000, LateBreak ), LateBreak, false, false );
+    CheckDocument( checker, splitter, MakeDocument( 10, NoBreak ), NoBreak, false, true );
+
+    if ( showSummary || ( 0 < checker.GetFailCount() ) )
+    {
+        cout << "Split Pieces: [" << stats.m_pieces << "]\tRescans: [" << stats.m_rescans
+            << "]\tRounds: [" << stats.m_rounds << "]\n";
+    }
+    return checker.ShowSummary( showSummary );
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file SplitTester.hpp Checks that XmlSplitParser gives the calls of one pass.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_SPLIT_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_SPLIT_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses large documents with an XmlSplitParser using small pieces, so that
+ many pieces start inside comments and CDATA sections, and checks every
+ receiver call, result, and message against parsing in one pass.  Also checks
+ documents with errors and receivers which stop taking calls.
+ @param threadCount Most threads for the parser.
+ @param showSummary True to show counts.
+ @return True if all checks passed.
+ */
+bool DoSplitTests( unsigned int threadCount, bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file TestHelpers.cpp Receivers shared by the xml testers.
+
+
+// ----------------------------------------------------------------------------
+
+#include "TestHelpers.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser::Xml;
+
+
+// ----------------------------------------------------------------------------
+
+CallRecorder::CallRecorder( const char * document ) :
+    IDocumentReceiver(),
+    INodeReceiver(),
+    m_calls(),
+    m_document( document ),
+    m_stopName( NULL )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+CallRecorder::~CallRecorder( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * CallRecorder::AddRoot( void )
+{
+    assert( NULL != this );
+    m_calls += "AddRoot\n";
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "AddComment", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    m_calls += standalone ? "Standalone yes\n" : "Standalone no\n";
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( valid ? "DoneDocument valid" : "DoneDocument invalid", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "SetTagName", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( "SetElementName", begin, end );
+    if ( NULL == m_stopName )
+        return true;
+    const size_t length = ::strlen( m_stopName );
+    return ( length != static_cast< size_t >( end - begin ) )
+        || ( 0 != ::strncmp( begin, m_stopName, length ) );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "AddCData", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "AddCDataSection", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "SetAttributeName", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( "SetAttributeValue", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * CallRecorder::AddChild( void )
+{
+    assert( NULL != this );
+    m_calls += "AddChild\n";
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return Add( valid ? "DoneNode valid" : "DoneNode invalid", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool CallRecorder::Add( const char * call, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_calls += call;
+    if ( NULL == m_document )
+    {
+        m_calls += " [";
+        m_calls.append( begin, end - begin );
+        m_calls += "]\n";
+        return true;
+    }
+    char places[ 48 ];
+    ::sprintf( places, " %ld %ld\n", static_cast< long >( begin - m_document ),
+        static_cast< long >( end - m_document ) );
+    m_calls += places;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
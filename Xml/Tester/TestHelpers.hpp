@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file TestHelpers.hpp Receivers shared by the xml testers.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_TEST_HELPERS_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_TEST_HELPERS_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+#include <string>
+
+#include "../include/Receivers.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+/** @class CallRecorder
+ Writes every document and node receiver call into a string, one line each,
+ so calls made by different parsers or replays may be compared.
+ */
+class CallRecorder : public ::Parser::Xml::IDocumentReceiver,
+    public ::Parser::Xml::INodeReceiver
+{
+public:
+
+    /** @param document If not NULL, each line has the places of its chars as
+     offsets from here, instead of the chars.
+     */
+    explicit CallRecorder( const char * document = NULL );
+
+    virtual ~CallRecorder( void );
+
+    /// Makes SetElementName return false for elements with this name, so the
+    /// rest of each is not received.  NULL means to never stop.
+    inline void SetStopName( const char * name ) { m_stopName = name; }
+
+    virtual ::Parser::Xml::INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool AddCDataSection( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual ::Parser::Xml::INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    ::std::string m_calls;
+
+private:
+
+    /// Not implemented.
+    CallRecorder( const CallRecorder & );
+    /// Not implemented.
+    CallRecorder & operator = ( const CallRecorder & );
+
+    bool Add( const char * call, const char * begin, const char * end );
+
+    const char * m_document;
+    const char * m_stopName;
+};
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
@@ -0,0 +1,480 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ThreadTester.cpp Runs XmlParsers on several threads at once.
+
+
+// ----------------------------------------------------------------------------
+
+#include "ThreadTester.hpp"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+    #include <process.h>
+#else
+    #include <pthread.h>
+#endif
+
+#include "../../Util/include/ErrorReceiver.hpp"
+#include "../include/XmlParser.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+using namespace ::std;
+using namespace ::Parser;
+using namespace ::Parser::Xml;
+
+namespace
+{
+
+/// Documents cover declarations, nested elements, attributes, references,
+/// comments, CDATA, and syntax errors so most rules run while other threads
+/// are parsing.  The last ones have many names, references, and attribute
+/// values, good and bad, so the fast scanners and the rules they stand in
+/// for must agree.
+const char * const s_inputs[] =
+{
+    "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+    "<!-- first -->\n"
+    "<root a=\"1\" b='two'>\n"
+    "  <child>text &amp; more &#65;</child>\n"
+    "  <empty x=\"y\"/>\n"
+    "  <![CDATA[ <raw> ]]>\n"
+    "</root>\n",
+
+    "<doc><a><b><c>deep</c></b></a><d e=\"&lt;f&gt;\"/></doc>",
+
+    "<root><open></root>",
+
+    "<root a=\"1 b=2>text</root>",
+
+    "<?xml version=\"1.0\"?><r><!-- note --><s t='u'>v</s></r><!-- end -->",
+
+    "<list a='&#65;&#x4A;b&amp;' b=\"x&lt;y&gt;z\" c='' d=\"\" e='\"q\"'"
+    " _f.g-h:i='1'><item n='&#x;'/><item n='&#12x;'/><item n='&;'/>"
+    "<item n=\"50%\"/><item n='&amp'/><item n='&#;'/><item n='a&b;c'/></list>",
+
+    "<root x='&#x1F600;&#0010;'><a.b b='&name.with-dots;'/><c d='it\"s'/>"
+    "<e f=\"it's\"/><g h='no end/></root>",
+
+    "<?xml version=\"1.0\"?><!-- a long comment - with single dashes, tabs\t"
+    "and line ends\r\n that go on for more than one vector of chars -->"
+    "<?pi some long processing instruction text ? with a question mark ?>"
+    "<root v='a long attribute value with &amp; references &#x41; and more text'>"
+    "<![CDATA[ long CDATA text with ] and ]] but no end until here ]]>"
+    "<!-- bad -- comment -->text</root>",
+};
+
+const unsigned int s_inputCount = sizeof( s_inputs ) / sizeof( s_inputs[ 0 ] );
+
+// ----------------------------------------------------------------------------
+
+/// Writes every call from a parser into a string so two parses can be compared.
+class Recorder : public IDocumentReceiver, public INodeReceiver,
+    public IParseErrorReceiver
+{
+public:
+
+    Recorder( void ) : IDocumentReceiver(), INodeReceiver(),
+        IParseErrorReceiver(), m_record() {}
+
+    virtual ~Recorder( void ) {}
+
+    inline void Clear( void ) { m_record.clear(); }
+
+    inline const string & GetRecord( void ) const { return m_record; }
+
+    void AddResult( XmlParser::ParseResults result );
+
+    virtual INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message, unsigned long line );
+
+    virtual bool GiveParseMessage( ErrorLevel::Levels level,
+        const CharType * message, const char * filename, unsigned long line );
+
+private:
+
+    Recorder( const Recorder & );
+    Recorder & operator = ( const Recorder & );
+
+    void AddNumber( unsigned long number );
+
+    bool Add( const char * what, const char * begin, const char * end );
+
+    string m_record;
+};
+
+// ----------------------------------------------------------------------------
+
+void Recorder::AddNumber( unsigned long number )
+{
+    assert( NULL != this );
+    char buffer[ 24 ];
+    ::sprintf( buffer, "%lu", number );
+    m_record.append( buffer );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::Add( const char * what, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_record.append( what );
+    m_record.append( ": " );
+    if ( ( NULL != begin ) && ( begin < end ) )
+        m_record.append( begin, end );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void Recorder::AddResult( XmlParser::ParseResults result )
+{
+    assert( NULL != this );
+    m_record.append( "Result: " );
+    AddNumber( result );
+    m_record.append( "\n" );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * Recorder::AddRoot( void )
+{
+    assert( NULL != this );
+    m_record.append( "Root\n" );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::AddComment( const char * begin, const char * end )
+{
+    return Add( "Comment", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    m_record.append( standalone ? "Standalone: yes\n" : "Standalone: no\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    return Add( valid ? "Document: valid" : "Document: invalid", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::SetTagName( const char * begin, const char * end )
+{
+    return Add( "Tag", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::SetElementName( const char * begin, const char * end )
+{
+    return Add( "Element", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::AddCData( const char * begin, const char * end )
+{
+    return Add( "CData", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::SetAttributeName( const char * begin, const char * end )
+{
+    return Add( "Attribute", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::SetAttributeValue( const char * begin, const char * end )
+{
+    return Add( "Value", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * Recorder::AddChild( void )
+{
+    assert( NULL != this );
+    m_record.append( "Child\n" );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::DoneNode( bool valid, const char * begin, const char * end )
+{
+    return Add( valid ? "Node: valid" : "Node: invalid", begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, unsigned long line )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " line " );
+    AddNumber( line );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool Recorder::GiveParseMessage( ErrorLevel::Levels level,
+    const CharType * message, const char * filename, unsigned long line )
+{
+    assert( NULL != this );
+    m_record.append( "Message: " );
+    AddNumber( level );
+    m_record.append( " " );
+    m_record.append( filename );
+    m_record.append( " line " );
+    AddNumber( line );
+    m_record.append( " " );
+    m_record.append( message );
+    m_record.append( "\n" );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Parses one document and returns everything the parser gave the recorder.
+const string & ParseOnce( XmlParser & parser, Recorder & recorder,
+    unsigned int input )
+{
+    const char * begin = s_inputs[ input ];
+    const char * end = begin + ::strlen( begin );
+    recorder.Clear();
+    XmlParser::ParseResults result = XmlParser::Exception;
+    try
+    {
+        result = parser.ParseDocument( begin, end, &recorder );
+    }
+    catch ( ... )
+    {
+    }
+    recorder.AddResult( result );
+    return recorder.GetRecord();
+}
+
+// ----------------------------------------------------------------------------
+
+/// What one thread needs to do its parsing, and what it found.
+struct ThreadInfo
+{
+    unsigned int m_index;
+    bool m_fastScanning;
+    unsigned int m_repeatCount;
+    const vector< string > * m_expected;
+    unsigned long m_matched;
+    unsigned long m_mismatched;
+};
+
+// ----------------------------------------------------------------------------
+
+void RunThread( ThreadInfo & info )
+{
+    const vector< string > & expected = *info.m_expected;
+    Recorder recorder;
+
+    for ( unsigned int ii = 0; ii < info.m_repeatCount; ++ii )
+    {
+        // A new parser each time, since making one should cost little now
+        // that all parsers share their rules.
+        XmlParser parser;
+        parser.SetErrorReceiver( &recorder );
+        parser.SetFastScanning( info.m_fastScanning );
+        // Start each thread at a different input so threads rarely parse the
+        // same input at the same moment.
+        for ( unsigned int jj = 0; jj < s_inputCount; ++jj )
+        {
+            const unsigned int input = ( info.m_index + jj ) % s_inputCount;
+            if ( ParseOnce( parser, recorder, input ) == expected[ input ] )
+                ++info.m_matched;
+            else
+                ++info.m_mismatched;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( _WIN32 )
+
+unsigned __stdcall ThreadMain( void * pInfo )
+{
+    RunThread( *reinterpret_cast< ThreadInfo * >( pInfo ) );
+    return 0;
+}
+
+#else
+
+extern "C" void * ThreadMain( void * pInfo )
+{
+    RunThread( *reinterpret_cast< ThreadInfo * >( pInfo ) );
+    return NULL;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+bool DoThreadTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary )
+{
+
+    // Find what one parser produces for each input when nothing else runs,
+    // using only the Spirit rules, so threads with fast scanning on show
+    // whether the scanners give the same results as the rules.
+    vector< string > expected;
+    {
+        XmlParser parser;
+        Recorder recorder;
+        parser.SetErrorReceiver( &recorder );
+        parser.SetFastScanning( false );
+        expected.reserve( s_inputCount );
+        for ( unsigned int ii = 0; ii < s_inputCount; ++ii )
+            expected.push_back( ParseOnce( parser, recorder, ii ) );
+    }
+
+    vector< ThreadInfo > infos( threadCount );
+    for ( unsigned int ii = 0; ii < threadCount; ++ii )
+    {
+        ThreadInfo & info = infos[ ii ];
+        info.m_index = ii;
+        info.m_fastScanning = ( 0 != ( ii % 2 ) );
+        info.m_repeatCount = repeatCount;
+        info.m_expected = &expected;
+        info.m_matched = 0;
+        info.m_mismatched = 0;
+    }
+
+    unsigned int started = 0;
+#if defined( _WIN32 )
+    vector< HANDLE > threads( threadCount, NULL );
+    for ( ; started < threadCount; ++started )
+    {
+        threads[ started ] = reinterpret_cast< HANDLE >( ::_beginthreadex( NULL, 0,
+            &ThreadMain, &infos[ started ], 0, NULL ) );
+        if ( NULL == threads[ started ] )
+            break;
+    }
+    for ( unsigned int ii = 0; ii < started; ++ii )
+    {
+        ::WaitForSingleObject( threads[ ii ], INFINITE );
+        ::CloseHandle( threads[ ii ] );
+    }
+#else
+    vector< pthread_t > threads( threadCount );
+    for ( ; started < threadCount; ++started )
+    {
+        if ( 0 != ::pthread_create( &threads[ started ], NULL, &ThreadMain,
+            &infos[ started ] ) )
+            break;
+    }
+    for ( unsigned int ii = 0; ii < started; ++ii )
+        ::pthread_join( threads[ ii ], NULL );
+#endif
+
+    unsigned long matched = 0;
+    unsigned long mismatched = 0;
+    for ( unsigned int ii = 0; ii < started; ++ii )
+    {
+        matched += infos[ ii ].m_matched;
+        mismatched += infos[ ii ].m_mismatched;
+    }
+
+    const bool passed = ( started == threadCount ) && ( 0 == mismatched );
+    if ( showSummary || !passed )
+    {
+        cout << "Threads: [" << started << "] of [" << threadCount << "]\t"
+            << "Matched: [" << matched << "]\tMismatched: [" << mismatched << "]\n";
+    }
+
+    return passed;
+}
+
+// ----------------------------------------------------------------------------
+
+// $Log: $
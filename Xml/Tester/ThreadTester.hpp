@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------------
+// Parser Utility Testing
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file ThreadTester.hpp Checks that XmlParsers on separate threads do not
+///  interfere with each other.
+
+// ----------------------------------------------------------------------------
+
+#if !defined( PARSER_XML_THREAD_TEST_H_INCLUDED )
+/// file guardian.
+#define PARSER_XML_THREAD_TEST_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+/** Parses the same documents with several threads at once.  Each thread makes
+ its own XmlParsers, which all share one grammar, and records every call made
+ to its receivers.  The record is compared against what a lone parser produced
+ for the same document before any threads started.  Any difference means one
+ parse saw the state of another.
+ @param threadCount How many threads to run at once.
+ @param repeatCount How many times each thread parses every document.
+ @param showSummary True to show how many parses matched.
+ @return True if every parse on every thread matched.
+ */
+bool DoThreadTests( unsigned int threadCount, unsigned int repeatCount,
+    bool showSummary );
+
+// ----------------------------------------------------------------------------
+
+#endif // file guardian
+
+// $Log: $
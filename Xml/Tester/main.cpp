@@ -28,6 +28,16 @@
 
 #include "BasicTesters.hpp"
 #include "PrologTesters.hpp"
+#include "NodeTesters.hpp"
+#include "ThreadTester.hpp"
+#include "DomTester.hpp"
+#include "ReaderTester.hpp"
+#include "EventTester.hpp"
+#include "BatchTester.hpp"
+#include "SplitTester.hpp"
+#include "ChunkTester.hpp"
+#include "RecoveryTester.hpp"
+#include "ScannerTester.hpp"
 #include "CommandLineArgs.hpp"
 
 
@@ -40,7 +50,7 @@ using namespace Parser;
 
 void ShowHelp( const char * myName )
 {
-    cout << "Usage: " << myName << " [-h] [-u[:#]] [-c] [-s] [-t] [-w:#] [-W] [-f:filename]\n";
+    cout << "Usage: " << myName << " [-h] [-u[:#]] [-c] [-p] [-s] [-t] [-w:#] [-W] [-f:filename]\n";
     cout << "  You must use either -h, -u or -f command.\n";
     cout << "    -c = Show content of unit tests or file.\n";
     cout << "    -f = Test file for validity.  Use absolute path.\n";
@@ -54,6 +64,7 @@ void ShowHelp( const char * myName )
     cout << "         * Throw unknown exceptions at random moments.\n";
     cout << "         * Provide NULLs sometimes instead of valid pointers.\n";
     cout << "         * Return false to stop parser from providing content.\n";
+    cout << "    -p = Parse with Spirit rules only, without fast scanners.\n";
     cout << "    -s = Show summary info after each unit test.\n";
     cout << "    -t = Show table of all results after all unit tests." << endl;
     cout << "    -w = Set warning level to 0 through 7. Default is -w:1\n";
@@ -75,7 +86,7 @@ void ShowHelp( const char * myName )
 
 void ShowUsage( const char * myName )
 {
-    cout << "Usage: " << myName << " [-W] [-h] [-u] [-m] [-c] [-s] [-t] [-w:#] [-f:filename]\n";
+    cout << "Usage: " << myName << " [-W] [-h] [-u] [-m] [-c] [-p] [-s] [-t] [-w:#] [-f:filename]\n";
 }
 
 // ----------------------------------------------------------------------------
@@ -105,6 +116,8 @@ Parser::Xml::XmlParser::ParseResults MakeXmlParser( void )
         if ( NULL == s_pParser )
             return Parser::Xml::XmlParser::CantMakeParser;
         ::atexit( DestroyXmlParser );
+        s_pParser->SetFastScanning(
+            !CommandLineArgs::GetCommandLineArgs().DoSpiritOnly() );
     }
     return Parser::Xml::XmlParser::AllValid;
 }
@@ -154,7 +167,10 @@ private:
     EncodingTester          m_encodingTester;
     XmlDeclarationTester    m_xmlDeclarationTester;
     AttListDeclTester       m_attListDeclTester;
-//    FileTester m_fileTester;
+    NodeTester              m_nodeTester;
+    DocumentTester          m_documentTester;
+    FeedTester              m_byteFeedTester;
+    FeedTester              m_chunkFeedTester;
 
    TesterSet m_testers;
 };
@@ -175,7 +191,11 @@ XmlParserTester::XmlParserTester( const CommandLineArgs & argInfo ) :
     m_encodingTester( s_pParser, argInfo ),
     m_xmlDeclarationTester( s_pParser, argInfo ),
     m_attListDeclTester( s_pParser, argInfo, &m_attributeValueTest,
-        &m_enumeratedTypeTester )
+        &m_enumeratedTypeTester ),
+    m_nodeTester( s_pParser, argInfo ),
+    m_documentTester( s_pParser, argInfo, &m_nodeTester ),
+    m_byteFeedTester( "Document Fed By Byte", s_pParser, argInfo, &m_nodeTester, 1 ),
+    m_chunkFeedTester( "Document Fed By Chunk", s_pParser, argInfo, &m_nodeTester, 7 )
 {
     assert( this != NULL );
 
@@ -193,6 +213,10 @@ XmlParserTester::XmlParserTester( const CommandLineArgs & argInfo ) :
     m_testers.push_back( &m_encodingTester );
     m_testers.push_back( &m_xmlDeclarationTester );
     m_testers.push_back( &m_attListDeclTester );
+    m_testers.push_back( &m_nodeTester );
+    m_testers.push_back( &m_documentTester );
+    m_testers.push_back( &m_byteFeedTester );
+    m_testers.push_back( &m_chunkFeedTester );
 }
 
 // ----------------------------------------------------------------------------
@@ -372,6 +396,68 @@ void XmlParserTester::DoUnitTests( void )
         ++it;
     }
 
+    if ( argInfo.DoShowSummary() )
+        cout << "\nThread Test\n";
+    if ( DoThreadTests( 8, 200, argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nDOM Test\n";
+    if ( DoDomTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nReader Test\n";
+    if ( DoReaderTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nEvent Test\n";
+    if ( DoEventTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nBatch Test\n";
+    if ( DoBatchTests( 8, argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nSplit Test\n";
+    if ( DoSplitTests( 4, argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nChunk Test\n";
+    if ( DoChunkTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
+    if ( argInfo.DoShowSummary() )
+        cout << "\nRecovery Test\n";
+    if ( DoRecoveryTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+    if ( argInfo.DoShowSummary() )
+        cout << "\nScanner Test\n";
+    if ( DoScannerTests( argInfo.DoShowSummary() ) )
+        ++passCount;
+    else
+        ++failCount;
+
     if ( argInfo.DoShowTable() )
     {
         ShowSummaryTable();
@@ -428,17 +514,12 @@ void XmlParserTester::DoFileTests( void )
     assert( this != NULL );
     const CommandLineArgs & argInfo = CommandLineArgs::GetCommandLineArgs();
     const char * filename = argInfo.GetFileName();
-//    unsigned long parseLength = 0;
 
        if ( argInfo.DoShowSummary() )
         cout << "\n XML Parser File Test: [" << filename << "]\n";
 
-//    m_fileTester.SetGiveIncludePath( true );
-
-//    parser.SetErrorReceiver( m_fileTester.AsErrorReceiver() );
-    Parser::ParseInfo::ParseResult result = Parser::ParseInfo::AllValid;
-//    Parser::ParseInfo::ParseResult result =
-//        parser.ParseFile( filename, parseLength, &m_fileTester );
+    const Parser::ParseInfo::ParseResult result =
+        m_documentTester.ParseFile( filename );
 
        if ( argInfo.DoShowSummary() )
     {
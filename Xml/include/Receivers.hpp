@@ -375,7 +375,17 @@ public:
 
     virtual bool AddComment( const char * begin, const char * end ) = 0;
 
+    /// Called for char data.  See AddCDataSection for CDATA sections.
     virtual bool AddCData( const char * begin, const char * end ) = 0;
+
+    /** Called for contents of a CDATA section.  Gives the contents to AddCData
+     unless overridden, so receivers which do not care which kind of text they
+     get need not tell them apart.
+     */
+    inline virtual bool AddCDataSection( const char * begin, const char * end )
+    {
+        return AddCData( begin, end );
+    }
 
     virtual bool SetAttributeName( const char * begin, const char * end ) = 0;
 
@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlBatch.hpp Defines a class which parses many documents at once.
+
+
+#ifndef PARSER_XML_BATCH_H_INCLUDED
+#define PARSER_XML_BATCH_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <UtilParsers/Util/include/BatchRunner.hpp>
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+    class FileBuffer;
+
+namespace Xml
+{
+    class XmlDocument;
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlBatch
+ Parses a list of xml files and buffers across several threads, each with its
+ own XmlParser, and keeps an XmlDocument, a result, and the messages for each
+ one in the order they were added.  Documents are views into the parsed chars,
+ so the batch keeps each file loaded until Clear, and buffers must last as
+ long as their documents are used.
+ */
+class XmlBatch : public BatchRunner
+{
+public:
+
+    /// @param threadCount Most threads to use, or zero for one per processor.
+    explicit XmlBatch( unsigned long threadCount = 0 );
+
+    virtual ~XmlBatch( void );
+
+    /// Adds a file to parse, and returns its index.
+    unsigned long AddFile( const char * filename );
+
+    /** Adds chars to parse, and returns their index.
+     @param name Name to show for buffer, or NULL.
+     */
+    unsigned long AddBuffer( const char * begin, const char * end, const char * name );
+
+    /// Removes all files and buffers, and their results.
+    void Clear( void );
+
+    /// Parses everything added.  Returns true if all were AllValid.
+    bool Run( void );
+
+    inline unsigned long GetCount( void ) const
+    {
+        return static_cast< unsigned long >( m_items.size() );
+    }
+
+    /// Returns file name, or name given to AddBuffer, or empty.
+    const char * GetName( unsigned long index ) const;
+
+    /// Returns what the parser returned.  Is NotParsed before Run.
+    XmlParser::ParseResults GetResult( unsigned long index ) const;
+
+    /// Returns tree of nodes made by parsing.
+    const XmlDocument & GetDocument( unsigned long index ) const;
+
+    /// Returns messages for one item, one per line.
+    const char * GetMessages( unsigned long index ) const;
+
+    unsigned long GetMessageCount( unsigned long index ) const;
+
+private:
+
+    /// Not implemented.
+    XmlBatch( const XmlBatch & );
+    /// Not implemented.
+    XmlBatch & operator = ( const XmlBatch & );
+
+    struct Item
+    {
+        ::std::string m_name;
+        /// Contents of a file, or NULL for a buffer.
+        FileBuffer * m_file;
+        const char * m_begin;
+        const char * m_end;
+        XmlParser::ParseResults m_result;
+        XmlDocument * m_document;
+        ::std::string m_messages;
+        unsigned long m_messageCount;
+    };
+
+    virtual void * MakeWorker( void );
+
+    virtual void RunJob( void * worker, unsigned long job );
+
+    virtual void DestroyWorker( void * worker );
+
+    Item & AddItem( const char * name, bool isFile );
+
+    ::std::vector< Item * > m_items;
+
+}; // end class XmlBatch
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
@@ -0,0 +1,188 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlDocument.hpp Defines a tree of nodes built by parsing a document.
+
+
+#ifndef PARSER_XML_DOCUMENT_H_INCLUDED
+#define PARSER_XML_DOCUMENT_H_INCLUDED
+
+#include <stddef.h>
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/** @struct TextView
+ Some chars which are not nil-terminated.  A view points into the parsed
+ document when the text is used as is, or into the XmlDocument when references
+ inside the text had to be replaced.
+ */
+struct TextView
+{
+    const char * m_begin;
+    unsigned long m_length;
+
+    inline const char * GetEnd( void ) const { return m_begin + m_length; }
+
+    inline bool IsEmpty( void ) const { return ( 0 == m_length ); }
+
+    /// Returns true if the view holds the same chars as nil-terminated text.
+    bool Equals( const char * text ) const;
+};
+
+// ----------------------------------------------------------------------------
+
+struct DomAttribute
+{
+    TextView m_name;
+    /// Value without quote marks, with references replaced.
+    TextView m_value;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @struct DomNode
+ One node of an XmlDocument.  Nodes refer to each other by index into the
+ document's array of nodes, and a node's attributes are a run of the document's
+ array of attributes.  Indexes which refer to nothing are XmlDocument::NoIndex.
+ */
+struct DomNode
+{
+    enum Kinds
+    {
+        Document = 0, ///< The only node without a parent.  Always at index 0.
+        Element,      ///< Has a name, and may have attributes and children.
+        Text,         ///< Char data with references replaced.
+        CData,        ///< Contents of a CDATA section.
+        Comment       ///< Contents of a comment.
+    };
+
+    Kinds m_kind;
+    /// Name of an element, or empty for other kinds.
+    TextView m_name;
+    /// Text of Text, CData, and Comment nodes, or empty for other kinds.
+    TextView m_text;
+    unsigned long m_parent;
+    unsigned long m_firstChild;
+    unsigned long m_lastChild;
+    unsigned long m_nextSibling;
+    /// Index of first attribute of an element.
+    unsigned long m_firstAttribute;
+    unsigned long m_attributeCount;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlDocument
+ Builds a tree of nodes from the receiver calls an XmlParser makes while it
+ parses a whole document.  When parsing ends, the nodes, attributes, and any
+ text whose references were replaced are moved into one block of memory, so
+ the tree is freed with a single call.  Names and most text are views into the
+ parsed chars, so those chars must outlive the document.
+ */
+class XmlDocument
+{
+public:
+
+    /// An index which refers to no node or attribute.
+    enum { NoIndex = 0xFFFFFFFFUL };
+
+    XmlDocument( void );
+
+    ~XmlDocument( void );
+
+    /** Parses a document and replaces any tree made before.  A tree is made
+     even if the document is not valid, as long as the parser got that far.
+     @param parser Parser to use.  It needs an error receiver, and may not be
+      parsing anything else.
+     @param begin Start of document.  These chars must outlive the tree.
+     @param end Place after last char of document.
+     @return What the parser returned.
+     */
+    XmlParser::ParseResults Parse( XmlParser & parser, const char * begin,
+        const char * end );
+
+    /// Frees the tree.
+    void Clear( void );
+
+    /// Returns true if the parser found the whole document valid.
+    inline bool IsValid( void ) const { return m_valid; }
+
+    inline bool IsStandalone( void ) const { return m_standalone; }
+
+    /// Returns index of the outermost element, or NoIndex if there is none.
+    inline unsigned long GetRoot( void ) const { return m_root; }
+
+    /// Returns how many nodes there are, including the Document node.
+    inline unsigned long GetNodeCount( void ) const { return m_nodeCount; }
+
+    const DomNode & GetNode( unsigned long index ) const;
+
+    inline unsigned long GetAttributeCount( void ) const { return m_attributeCount; }
+
+    const DomAttribute & GetAttribute( unsigned long index ) const;
+
+    /// Returns index of first child element with the name, or NoIndex.
+    unsigned long FindChild( unsigned long parent, const char * name ) const;
+
+    /// Returns index of first sibling after node with the same name, or NoIndex.
+    unsigned long FindNextSibling( unsigned long node ) const;
+
+    /// Returns attribute of element with the name, or NULL if there is none.
+    const DomAttribute * FindAttribute( unsigned long element,
+        const char * name ) const;
+
+    /// Returns bytes in the block which holds the tree.
+    inline size_t GetArenaSize( void ) const { return m_arenaSize; }
+
+private:
+
+    /// Not implemented.
+    XmlDocument( const XmlDocument & );
+    /// Not implemented.
+    XmlDocument & operator = ( const XmlDocument & );
+
+    friend class DocumentBuilder;
+
+    /// Holds nodes, then attributes, then replaced text.
+    char * m_arena;
+    size_t m_arenaSize;
+    const DomNode * m_nodes;
+    unsigned long m_nodeCount;
+    const DomAttribute * m_attributes;
+    unsigned long m_attributeCount;
+    unsigned long m_root;
+    bool m_valid;
+    bool m_standalone;
+
+}; // end class XmlDocument
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
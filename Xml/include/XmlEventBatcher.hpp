@@ -0,0 +1,264 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlEventBatcher.hpp Defines a receiver which adds xml events to a buffer.
+
+
+#ifndef PARSER_XML_EVENT_BATCHER_H_INCLUDED
+#define PARSER_XML_EVENT_BATCHER_H_INCLUDED
+
+#include <UtilParsers/Util/include/EventBuffer.hpp>
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlEventWriter
+ Adds the events for the parts of a document or a lone attribute to an
+ EventBuffer, as XmlEventBatcher events.  The parser's rules call a writer
+ directly when parsing into a buffer, so no receiver is called for each part.
+ The writer keeps what spans calls: how many elements are open, and a start or
+ attribute name which is still waiting for its element name or value.  Each
+ function returns false once the buffer's receiver said to stop.
+ */
+class XmlEventWriter
+{
+public:
+
+    explicit XmlEventWriter( EventBuffer & buffer );
+
+    ~XmlEventWriter( void );
+
+    /// Prepares for a document or attribute whose chars start at begin.
+    void Begin( const char * begin );
+
+    /// Closes any elements left open, adds EndDocument if not added yet, and
+    /// flushes the buffer.
+    bool Finish( const char * end );
+
+    /// Adds an attribute name still waiting for its value, and flushes the buffer.
+    bool FinishAttribute( void );
+
+    /// Starts an element whose name is not known yet.
+    bool AddChild( void );
+
+    bool SetElementName( const char * begin, const char * end );
+
+    bool SetAttributeName( const char * begin, const char * end );
+
+    /// Adds value of an attribute within a start tag, without its quotes.
+    bool SetAttributeValue( const char * begin, const char * end );
+
+    bool SetTagName( const char * begin, const char * end );
+
+    bool AddCData( const char * begin, const char * end );
+
+    bool AddCDataSection( const char * begin, const char * end );
+
+    bool AddComment( const char * begin, const char * end );
+
+    bool DoneNode( bool valid, const char * begin, const char * end );
+
+    bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    /// Sets name of a lone attribute.
+    bool SetName( const char * begin, const char * end );
+
+    bool AddValue( const char * begin, const char * end );
+
+    bool AddReference( const char * begin, const char * end,
+        IReferenceReceiver::RefType refType );
+
+    /// Adds value of a lone attribute, once, with or without its quotes.
+    void DoneAttributeValue( bool valid, bool singleQuoted,
+        const char * begin, const char * end );
+
+private:
+
+    /// Not implemented.
+    XmlEventWriter( void );
+    /// Not implemented.
+    XmlEventWriter( const XmlEventWriter & );
+    /// Not implemented.
+    XmlEventWriter & operator = ( const XmlEventWriter & );
+
+    /// Adds a start or an attribute name which is still waiting for its
+    /// element name or value.  Called before adding any other event.
+    inline bool AddWaiting( void )
+    {
+        return ( !m_startWaiting && ( NULL == m_nameBegin ) ) || AddWaitingNow();
+    }
+
+    bool AddWaitingNow( void );
+
+    EventBuffer & m_buffer;
+    const char * m_documentBegin;
+    /// Elements started but not ended.
+    unsigned long m_depth;
+    /// True if an element started but its name has not come yet.
+    bool m_startWaiting;
+    /// Attribute name which is waiting for its value, or NULL.
+    const char * m_nameBegin;
+    const char * m_nameEnd;
+    /// True once a value of a lone attribute was added.
+    bool m_gotValue;
+    bool m_done;
+
+}; // end class XmlEventWriter
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlEventBatcher
+ Gives the parts of a document or an attribute to an EventBuffer, so the
+ buffer's receiver gets them in batches.  ParseDocument and ParseAttribute
+ have the parser's rules add each event to the buffer through an
+ XmlEventWriter, with no call through a receiver for each one.  The batcher is
+ also a receiver which turns each call into an event, for parsers which only
+ take a receiver, such as XmlSplitParser.  Events for an element come in the
+ same order as the tokens of an XmlReader, and are always nested properly.
+ Within a document, an attribute name and its value always come in the same
+ batch.
+
+ A document gives no events for the parts of an attribute value, but the
+ AttributeValue event says if the value has any references.  Parsing a lone
+ attribute also gives a ValueText or Reference event for each part of the
+ value, before the AttributeValue event.
+ */
+class XmlEventBatcher : public IDocumentReceiver, public INodeReceiver,
+    public IAttributeReceiver
+{
+public:
+
+    enum Events
+    {
+        StartElement = 1, ///< View is the name of the element.  May be NULL.
+        AttributeName,    ///< View is the name of an attribute.
+        AttributeValue,   ///< View is the value, without quotes.
+        ValueText,        ///< View is a run of chars in a value.
+        Reference,        ///< View is a reference in a value.  Flags is its RefType.
+        TagEnd,           ///< View is the whole start tag.  No more attributes.
+        Text,             ///< View is char data, with references unchanged.
+        CData,            ///< View is contents of a CDATA section.
+        Comment,          ///< View is contents of a comment.
+        EndElement,       ///< View is the whole element.  May be empty if never closed.
+        EndDocument       ///< View is the whole document.
+    };
+
+    enum Flags
+    {
+        /// EndElement, EndDocument, or value of a lone attribute was valid.  Values
+        /// within documents always have it, since a bad value makes its element bad.
+        Valid        = 0x01,
+        HasReference = 0x02, ///< AttributeValue has at least one reference.
+        SingleQuoted = 0x04  ///< AttributeValue from a lone attribute had single quotes.
+    };
+
+    /// Returns name of event kind for showing to people.
+    static const char * GetEventName( unsigned short kind );
+
+    explicit XmlEventBatcher( EventBuffer & buffer );
+
+    virtual ~XmlEventBatcher( void );
+
+    /** Parses a document and gives every event to the buffer.  The buffer is
+     flushed after the last event, even if the parser stopped early.  Same as
+     XmlParser::ParseDocument with the buffer.
+     @param parser Parser to use.  It needs an error receiver.
+     @return What the parser returned.
+     */
+    XmlParser::ParseResults ParseDocument( XmlParser & parser, const char * begin,
+        const char * end );
+
+    /// Parses one attribute and gives its events to the buffer, then flushes
+    /// it.  Same as XmlParser::ParseAttribute with the buffer.
+    XmlParser::ParseResults ParseAttribute( XmlParser & parser, const char * begin,
+        const char * end );
+
+    /** Prepares for a document whose chars start at documentBegin.  Only
+     needed when the batcher is given straight to a parser.
+     */
+    void Begin( const char * documentBegin );
+
+    /** Closes any elements left open, adds EndDocument if the parser did not,
+     and flushes the buffer.  Only needed when the batcher is given straight to
+     a parser.
+     */
+    bool Finish( const char * end );
+
+    virtual INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool AddCDataSection( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    virtual bool SetName( const char * begin, const char * end );
+
+    virtual bool AddValue( const char * begin, const char * end );
+
+    virtual bool AddReference( const char * begin, const char * end,
+        RefType refType );
+
+    virtual void DoneAttributeValue( bool valid, bool singleQuoted,
+        const char * begin, const char * end );
+
+private:
+
+    /// Not implemented.
+    XmlEventBatcher( void );
+    /// Not implemented.
+    XmlEventBatcher( const XmlEventBatcher & );
+    /// Not implemented.
+    XmlEventBatcher & operator = ( const XmlEventBatcher & );
+
+    EventBuffer & m_buffer;
+    /// Adds events for the calls this gets as a receiver.
+    XmlEventWriter m_writer;
+
+}; // end class XmlEventBatcher
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
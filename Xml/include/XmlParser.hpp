@@ -23,6 +23,7 @@
 namespace Parser
 {
     class IParseErrorReceiver;
+    class EventBuffer;
 
 namespace Xml
 {
@@ -30,6 +31,8 @@ namespace Xml
 // ----------------------------------------------------------------------------
 
 class XmlParserImpl;
+class XmlSplitParser;
+class XmlReader;
 
 class XmlParser
 {
@@ -64,6 +67,15 @@ public:
 
     IParseErrorReceiver * GetErrorReceiver( void );
 
+    /** Chooses whether names, references, and attribute values are found by
+     hand-written scanners before the Spirit rules are tried.  Results are the
+     same either way, so this is only useful for testing or measuring.  Fast
+     scanning is on unless turned off.  Ignored while parsing.
+     */
+    void SetFastScanning( bool fast );
+
+    bool IsFastScanning( void ) const;
+
     ParseResults ParseComment( const char * begin, ICommentReceiver * receiver );
 
     ParseResults ParseComment( const char * begin, const char * end,
@@ -108,6 +120,13 @@ public:
     ParseResults ParseAttribute( const char * begin, const char * end,
         IAttributeReceiver * receiver );
 
+    /** Parses one attribute, and the rules add its name, each part of its
+     value, and its value to the buffer as XmlEventBatcher events, with no call
+     through a receiver for each one.  The buffer is then flushed.
+     */
+    ParseResults ParseAttribute( const char * begin, const char * end,
+        EventBuffer & events );
+
     XmlParser::ParseResults ParseEnumeratedType( const char * begin,
         IEnumeratedTypeReceiver * receiver );
 
@@ -143,16 +162,120 @@ public:
     ParseResults ParseNode( const char * begin, const char * end,
         INodeReceiver * receiver );
 
+    /** Parses one start tag or empty-element tag.  Receiver gets the calls it
+     would get for that tag within ParseNode, and DoneNode only if the tag is
+     empty.  Same as the ParseStartTag template in XmlScanners.hpp with
+     INodeReceiver as the sink.
+     */
+    ParseResults ParseStartTag( const char * begin, const char * end,
+        INodeReceiver * receiver );
+
     ParseResults ParseDocument( const char * begin, IDocumentReceiver * receiver );
 
     ParseResults ParseDocument( const char * begin, const char * end,
         IDocumentReceiver * receiver );
+
+    /** Parses a document, and the rules add each part of it to the buffer as
+     XmlEventBatcher events, with no call through a receiver for each one.
+     Elements left open are closed, EndDocument is added, and the buffer is
+     flushed, even if the parser stopped early.  No more events are added once
+     the buffer's receiver says to stop, and an exception it throws goes up to
+     the caller.
+     */
+    ParseResults ParseDocument( const char * begin, const char * end,
+        EventBuffer & events );
 
     ParseResults ParseFile( const char * filename, IDocumentReceiver * receiver );
 
+    /** Starts parsing a document which arrives in pieces.  Give each piece to
+     Feed, and then call Finish.  Receivers are called as soon as each part of
+     the document is complete, so the whole document need not be in memory.
+     No other parsing may be done until Finish is called.
+     */
+    ParseResults StartFeeding( IDocumentReceiver * receiver );
+
+    /** Parses the next piece of a document.  A piece may end anywhere, even
+     within a tag or name.  The caller may release the piece once this returns.
+     @return AllValid if document is valid so far, NotValid if not.
+     */
+    ParseResults Feed( const char * begin, const char * end );
+
+    /** Parses the rest of a document given by Feed and calls DoneDocument.
+     @return EmptyData without calling the receiver if Feed was given nothing.
+     */
+    ParseResults Finish( void );
+
 private:
+
+    /// Only the split parser gives a parser pieces of a document.
+    friend class XmlSplitParser;
+    /// Only the reader pulls a document from a parser one item at a time.
+    friend class XmlReader;
+
+    /// Only the start tag template scans tags or falls back to the rules.
+    template < class Sink >
+    friend ParseResults ParseStartTag( XmlParser & parser, const char * begin,
+        const char * end, Sink & sink );
+
     XmlParser( const XmlParser & );
     XmlParser & operator = ( const XmlParser & );
+
+    /// Returns true if the parser has an error receiver and is not parsing.
+    bool IsReady( void ) const;
+
+    /** Parses one start tag or empty-element tag by the grammar rules alone,
+     even when fast scanning is on.
+     */
+    ParseResults ParseStartTagByRules( const char * begin, const char * end,
+        INodeReceiver * receiver );
+
+    /** Finds the name at begin the way fast scanning does.  Like the other
+     scanners, may be called only while some XmlParser exists.
+     @return End of the name, or NULL if no name starts at begin.
+     */
+    static const char * ScanName( const char * begin, const char * end );
+
+    /** Finds the start tag or empty-element tag at begin, if fast scanning
+     can take the whole tag.  It can not take a tag with a repeated attribute
+     name, or anything else the rules would send a message for.
+     @return End of the tag, or NULL if the rules must parse it.
+     */
+    static const char * ScanStartTag( const char * begin, const char * end );
+
+    /** Finds the next attribute of a tag ScanStartTag accepted.
+     @param here Just past the element name or the previous attribute.
+     @param valueBegin Set to the opening quote mark of the value.
+     @return End of the attribute, just past its closing quote mark, or NULL
+      if the tag has no more attributes.
+     */
+    static const char * ScanNextAttribute( const char * here, const char * end,
+        const char * & nameBegin, const char * & nameEnd, const char * & valueBegin );
+
+    /** Parses a piece of a document which begins and ends between items, as if
+     it came just after the start tags of the elements open where it begins.
+     Lets a document be split into pieces which are parsed on separate threads.
+     Receivers get the same calls as when feeding, including those for the
+     start tags, and DoneNode gets the range of the end tag.
+     @param tagsBegin Start of open tags, outermost first, such as "<a><b>".
+     @param tagsEnd End of open tags.  Same as tagsBegin if piece is first.
+     @param finishing True if piece is last, so DoneDocument is called.
+     @return AllValid if piece is valid, or NotValid if not.
+     */
+    ParseResults ParsePiece( const char * tagsBegin, const char * tagsEnd,
+        const char * begin, const char * end, bool finishing,
+        IDocumentReceiver * receiver );
+
+    /** Parses the first item of a document started by StartFeeding - one tag,
+     comment, CDATA section, processing instruction, or run of char data - in
+     place, so receivers get only the calls for that item.  An item which does
+     not end within the range is parsed as is.
+     @return End of the item, or NULL if parsing stopped from an exception, in
+      which case the document is dropped as if by CancelFeeding.
+     */
+    const char * FeedItem( const char * begin, const char * end );
+
+    /// Drops a document started by StartFeeding without calling its receivers.
+    void CancelFeeding( void );
 
     XmlParserImpl * m_impl;
 
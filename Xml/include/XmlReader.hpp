@@ -0,0 +1,256 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlReader.hpp Defines a cursor which steps through parts of a document.
+
+
+#ifndef PARSER_XML_READER_H_INCLUDED
+#define PARSER_XML_READER_H_INCLUDED
+
+#include <vector>
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+class TokenRecorder;
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlReader
+ Lets a caller pull each part of a document in order instead of having the
+ parser push parts into receivers.  Nothing is parsed until Next asks for a
+ token, and then only the next item of the document - one tag, comment, CDATA
+ section, or run of char data - so a caller which stops early never parses the
+ rest.  Tokens are kept in a compact list, and Next steps through the tokens of
+ each item with no virtual calls, so a loop may handle each token inline and
+ skip whole elements it does not need.  Views point into the parsed chars,
+ which must outlive the reader's tokens.
+
+ Tokens for an element come in this order: StartElement, then AttributeName
+ and AttributeValue for each attribute, then TagEnd, then tokens for content,
+ then EndElement.  An empty element has no content tokens.  Tokens are always
+ nested properly, even for a document which is not valid.
+
+ Replay gives the tokens to an IDocumentReceiver, so code written for the
+ receiver interfaces can run on top of a reader.
+ */
+class XmlReader
+{
+public:
+
+    enum Tokens
+    {
+        None = 0,       ///< Before first token or after last one.
+        StartElement,   ///< View is the name of the element.
+        AttributeName,  ///< View is the name of an attribute.
+        AttributeValue, ///< View is the value, without quotes or any changes.
+        TagEnd,         ///< View is the whole start tag.  No more attributes.
+        Text,           ///< View is char data, with references unchanged.
+        CData,          ///< View is contents of a CDATA section.
+        Comment,        ///< View is contents of a comment.
+        EndElement,     ///< View is the whole element, up to where parsing got if never closed.
+        EndDocument     ///< View is the whole document.  Always the last token.
+    };
+
+    /// Returns name of token for showing to people.
+    static const char * GetTokenName( Tokens token );
+
+    /** Makes a reader which uses a parser for each call to Open.  The parser
+     needs an error receiver, as it does for any other parse.
+     */
+    explicit XmlReader( XmlParser & parser );
+
+    ~XmlReader( void );
+
+    /** Starts a document and places the cursor before its first token, but
+     parses nothing yet.  The parser can not parse anything else until the
+     reader reaches EndDocument or is closed.  Tokens from any previous document
+     are dropped.
+     @return AllValid if parsing can start, or why it can not.
+     */
+    XmlParser::ParseResults Open( const char * begin, const char * end );
+
+    /** Stops parsing the rest of the document and drops all tokens.  The memory
+     which held them is kept for next time.
+     */
+    void Close( void );
+
+    /** Returns what the parser returned for the whole document once the reader
+     has parsed up to EndDocument, or ParsingNow until then.
+     */
+    inline XmlParser::ParseResults GetResult( void ) const { return m_result; }
+
+    /// Moves cursor back before first token.
+    inline void Rewind( void )
+    {
+        m_next = 0;
+        m_current = NULL;
+    }
+
+    /** Moves to next token and returns its kind, or None if there are no more.
+     Parses the next item of the document only if no parsed tokens are left.
+     */
+    inline Tokens Next( void )
+    {
+        if ( ( m_tokens.size() <= m_next ) && !ParseTo( m_next ) )
+        {
+            m_current = NULL;
+            return None;
+        }
+        m_current = &m_tokens[ m_next ];
+        ++m_next;
+        return m_current->m_kind;
+    }
+
+    /** When the cursor is at a StartElement, moves it so the next call to Next
+     returns the matching EndElement.  The content of the element is still
+     parsed, but gives no tokens to the caller.  Does nothing at any other token.
+     */
+    inline void SkipElement( void )
+    {
+        if ( ( NULL == m_current ) || ( StartElement != m_current->m_kind ) )
+            return;
+        if ( 0 == m_current->m_match )
+            ParseElement( m_next - 1 );
+        m_next = m_current->m_match;
+    }
+
+    inline Tokens GetToken( void ) const
+    {
+        return ( NULL == m_current ) ? None : m_current->m_kind;
+    }
+
+    inline const char * GetBegin( void ) const
+    {
+        return ( NULL == m_current ) ? NULL : m_current->m_begin;
+    }
+
+    inline const char * GetEnd( void ) const
+    {
+        return ( NULL == m_current ) ? NULL : m_current->m_end;
+    }
+
+    /** Returns how many elements hold the current token.  Tokens which make up
+     the tags of an element do not count that element, so root element is 0.
+     */
+    inline unsigned long GetDepth( void ) const
+    {
+        return ( NULL == m_current ) ? 0 : m_current->m_depth;
+    }
+
+    /// Returns true if current EndElement or EndDocument token was valid.
+    inline bool IsValid( void ) const
+    {
+        return ( NULL != m_current ) && m_current->m_valid;
+    }
+
+    /// Returns true if the view of the current token holds the same chars.
+    bool Equals( const char * text ) const;
+
+    /// Returns how many tokens were parsed so far.
+    inline unsigned long GetTokenCount( void ) const
+    {
+        return static_cast< unsigned long >( m_tokens.size() );
+    }
+
+    /** Returns true if the xml declaration said the document is standalone.
+     Only known once the reader has parsed past the xml declaration.
+     */
+    inline bool IsStandalone( void ) const { return m_standalone; }
+
+    /** Parses the rest of the document, and then gives every token to a
+     receiver in the same way the parser would have.  An element whose receiver
+     is NULL is skipped, and a receiver which returns false gets no more calls
+     for its element.  The cursor is not moved.
+     @return True if the document receiver got every call.
+     */
+    bool Replay( IDocumentReceiver * receiver );
+
+private:
+
+    /// Not implemented.
+    XmlReader( void );
+    /// Not implemented.
+    XmlReader( const XmlReader & );
+    /// Not implemented.
+    XmlReader & operator = ( const XmlReader & );
+
+    friend class TokenRecorder;
+
+    struct Token
+    {
+        Tokens m_kind;
+        bool m_valid;
+        unsigned long m_depth;
+        /** Index of EndElement for StartElement, and the other way around.  Zero
+         for a StartElement whose EndElement is not parsed yet.
+         */
+        unsigned long m_match;
+        const char * m_begin;
+        const char * m_end;
+    };
+
+    typedef ::std::vector< Token > TokenList;
+
+    /** Parses the next item of the document, or ends the document once every
+     item is parsed.
+     @return False if the document was already ended, so no tokens were added.
+     */
+    bool ParseItem( void );
+
+    /// Parses items until the token at index exists.  Returns false if it never will.
+    bool ParseTo( unsigned long index );
+
+    /** Parses items until the element whose StartElement is at index is closed.
+     Points the cursor at that StartElement again, since adding tokens may have
+     moved them.
+     */
+    void ParseElement( unsigned long index );
+
+    XmlParser & m_parser;
+    /// Receives the calls for each item, and adds tokens for them.
+    TokenRecorder * m_recorder;
+    TokenList m_tokens;
+    /// Index of token Next moves to.
+    unsigned long m_next;
+    const Token * m_current;
+    /// Start of first item not parsed yet.
+    const char * m_here;
+    const char * m_end;
+    /// True from Open until the document is ended.
+    bool m_parsing;
+    XmlParser::ParseResults m_result;
+    bool m_hasStandalone;
+    bool m_standalone;
+
+}; // end class XmlReader
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
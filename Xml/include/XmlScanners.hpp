@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlScanners.hpp Parses start tags into a sink known when compiling.
+
+
+#ifndef PARSER_XML_SCANNERS_H_INCLUDED
+#define PARSER_XML_SCANNERS_H_INCLUDED
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class NodeSinkReceiver
+ Gives the calls an INodeReceiver gets for a start tag to a sink, so the
+ grammar rules can parse a tag for a sink which is not a receiver.  Calls which
+ never come for a start tag are refused.
+ */
+template < class Sink >
+class NodeSinkReceiver : public INodeReceiver
+{
+public:
+
+    inline explicit NodeSinkReceiver( Sink & sink ) : INodeReceiver(), m_sink( sink ) {}
+
+    inline virtual ~NodeSinkReceiver( void ) {}
+
+    inline INodeReceiver * GetReceiver( void ) { return this; }
+
+    inline virtual bool SetTagName( const char * begin, const char * end )
+    {
+        return m_sink.SetTagName( begin, end );
+    }
+
+    inline virtual bool SetElementName( const char * begin, const char * end )
+    {
+        return m_sink.SetElementName( begin, end );
+    }
+
+    inline virtual bool AddComment( const char *, const char * ) { return false; }
+
+    inline virtual bool AddCData( const char *, const char * ) { return false; }
+
+    inline virtual bool SetAttributeName( const char * begin, const char * end )
+    {
+        return m_sink.SetAttributeName( begin, end );
+    }
+
+    inline virtual bool SetAttributeValue( const char * begin, const char * end )
+    {
+        return m_sink.SetAttributeValue( begin, end );
+    }
+
+    inline virtual INodeReceiver * AddChild( void ) { return NULL; }
+
+    inline virtual bool DoneNode( bool valid, const char * begin, const char * end )
+    {
+        return m_sink.DoneNode( valid, begin, end );
+    }
+
+private:
+
+    /// Not implemented.
+    NodeSinkReceiver( const NodeSinkReceiver & );
+    /// Not implemented.
+    NodeSinkReceiver & operator = ( const NodeSinkReceiver & );
+
+    Sink & m_sink;
+
+};
+
+/// A receiver is already a sink for the rules, so it needs no adapter.
+template <>
+class NodeSinkReceiver< INodeReceiver >
+{
+public:
+
+    inline explicit NodeSinkReceiver( INodeReceiver & sink ) : m_sink( sink ) {}
+
+    inline INodeReceiver * GetReceiver( void ) { return &m_sink; }
+
+private:
+
+    /// Not implemented.
+    NodeSinkReceiver( const NodeSinkReceiver & );
+    /// Not implemented.
+    NodeSinkReceiver & operator = ( const NodeSinkReceiver & );
+
+    INodeReceiver & m_sink;
+
+};
+
+// ----------------------------------------------------------------------------
+
+/** Parses one start tag or empty-element tag and gives it to a sink with the
+ calls an INodeReceiver gets for that tag: SetElementName, then SetAttributeName
+ and SetAttributeValue for each attribute, then SetTagName, and DoneNode only
+ if the tag is empty.  Sink may be any class with those functions, so calls to
+ a sink known when compiling are inlined, and INodeReceiver is the sink for
+ receivers called through virtual functions.  As in ParseNode, the sink gets
+ no more calls once one returns false or throws.
+ When fast scanning is on, a tag the scanners can take whole is given to the
+ sink here without the grammar rules.  Any other tag, or any tag when fast
+ scanning is off, is parsed by the rules, which make the same calls for a valid
+ tag and also send messages for a bad one.
+ @return Same results as ParseNode.
+ */
+template < class Sink >
+XmlParser::ParseResults ParseStartTag( XmlParser & parser, const char * begin,
+    const char * end, Sink & sink )
+{
+    const char * tagEnd = ( parser.IsFastScanning() && parser.IsReady() ) ?
+        XmlParser::ScanStartTag( begin, end ) : NULL;
+    if ( ( NULL == tagEnd ) || ( tagEnd != end ) )
+    {
+        NodeSinkReceiver< Sink > receiver( sink );
+        return parser.ParseStartTagByRules( begin, end, receiver.GetReceiver() );
+    }
+
+    try
+    {
+        const char * here = XmlParser::ScanName( begin + 1, end );
+        if ( !sink.SetElementName( begin + 1, here ) )
+            return XmlParser::AllValid;
+        const char * nameBegin = NULL;
+        const char * nameEnd = NULL;
+        const char * valueBegin = NULL;
+        while ( NULL != ( here = XmlParser::ScanNextAttribute( here, end,
+            nameBegin, nameEnd, valueBegin ) ) )
+        {
+            // Value range leaves out the quote marks, as for a receiver.
+            if ( !sink.SetAttributeName( nameBegin, nameEnd )
+              || !sink.SetAttributeValue( valueBegin + 1, here - 1 ) )
+                return XmlParser::AllValid;
+        }
+        if ( sink.SetTagName( begin, end ) && ( '/' == end[ -2 ] ) )
+            sink.DoneNode( true, begin, end );
+    }
+    catch ( ... )
+    {
+        // The rules also stop calling a receiver which throws.
+    }
+    return XmlParser::AllValid;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
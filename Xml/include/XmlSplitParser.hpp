@@ -0,0 +1,129 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlSplitParser.hpp Defines a class which parses one document on many threads.
+
+
+#ifndef PARSER_XML_SPLIT_PARSER_H_INCLUDED
+#define PARSER_XML_SPLIT_PARSER_H_INCLUDED
+
+#include <UtilParsers/Util/include/BatchRunner.hpp>
+
+#include "./XmlParser.hpp"
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+    class IParseErrorReceiver;
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/// What happened during the last parse by an XmlSplitParser.
+struct XmlSplitStats
+{
+    /// Pieces the document was split into, or zero if it was not split.
+    unsigned long m_pieces;
+    /// Pieces whose guessed start was inside an item, so they were scanned again.
+    unsigned long m_rescans;
+    /// Rounds of parsing pieces on threads and then giving their calls to receivers.
+    unsigned long m_rounds;
+    /// True if the document was parsed again on one thread after it was split.
+    bool m_reparsed;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlSplitParser
+ Parses one large document on several threads, and gives calls to receivers in
+ document order, the same calls XmlParser::ParseDocument would give.
+
+ The document is split into pieces of about the same size, each starting at a
+ '<' which looks like the start of a tag.  Each thread first scans some pieces
+ for where their items end, noting end tags of elements opened before the piece
+ and start tags of elements still open after it, which is cheap next to parsing.
+ When the pieces are joined in order, a guessed start inside a comment, CDATA
+ section, or other item is found because the last item of the piece before it
+ runs past it, and only that piece is scanned again from the real start.
+ Joining also finds the elements open where each piece starts, which is all the
+ state a piece needs, as the parser does no namespace processing.
+
+ Then the pieces are parsed on the threads, each as if it came just after the
+ start tags of its open elements, and the receiver calls of each piece are
+ recorded.  After each round of pieces, the calling thread gives the recorded
+ calls to the receivers, so memory use depends on the piece size and thread
+ count rather than the document size.
+
+ If a piece is not valid, receivers get the calls of the pieces before it, and
+ then each open element and the document are done as not valid.  The document
+ is then parsed again on one thread without receivers, so the result and
+ messages are the same as from XmlParser::ParseDocument.  A document whose first
+ piece is not valid, or which is smaller than two pieces, is simply parsed on
+ one thread.
+ */
+class XmlSplitParser : public BatchRunner
+{
+public:
+
+    /// @param threadCount Most threads to use, or zero for one per processor.
+    explicit XmlSplitParser( unsigned long threadCount = 0 );
+
+    virtual ~XmlSplitParser( void );
+
+    bool SetErrorReceiver( IParseErrorReceiver * receiver );
+
+    IParseErrorReceiver * GetErrorReceiver( void );
+
+    /// Sets about how many chars go in each piece.  Default is one megabyte.
+    void SetPieceSize( unsigned long size );
+
+    unsigned long GetPieceSize( void ) const;
+
+    XmlParser::ParseResults ParseDocument( const char * begin, const char * end,
+        IDocumentReceiver * receiver );
+
+    XmlSplitStats GetSplitStats( void ) const;
+
+private:
+
+    /// Not implemented.
+    XmlSplitParser( const XmlSplitParser & );
+    /// Not implemented.
+    XmlSplitParser & operator = ( const XmlSplitParser & );
+
+    virtual void * MakeWorker( void );
+
+    virtual void RunJob( void * worker, unsigned long job );
+
+    virtual void DestroyWorker( void * worker );
+
+    class Impl;
+
+    /// Pieces, recorded calls, and the parser for one thread.
+    Impl * m_impl;
+
+}; // end class XmlSplitParser
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif
+
+// $Log: $
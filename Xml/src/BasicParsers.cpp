@@ -18,11 +18,52 @@
 #include "./BasicParsers.hpp"
 
 #include "../include/Receivers.hpp"
+#include "../include/XmlEventBatcher.hpp"
 
 
 using namespace std;
 using namespace boost::spirit;
 
+namespace
+{
+
+// The rules and the scanners give these same messages, so parses make the same
+// calls to the error receiver with fast scanning on or off.
+
+const ::Parser::CharType * const s_badFirstNameChar =
+    "Name has invalid first character.";
+const ::Parser::CharType * const s_badRestOfName =
+    "Could not parse rest of name.";
+
+const ::Parser::CharType * const s_noRestOfReference =
+    "Found start of reference, but not rest of its content.";
+const ::Parser::CharType * const s_noDecDigits =
+    "Found '&#' for start of digit reference, but no digits.";
+const ::Parser::CharType * const s_noDecSemicolon =
+    "Found numbers for digits reference but no ending semicolon.";
+const ::Parser::CharType * const s_noHexDigits =
+    "Found '&#x' for start of hexdigit reference, but no hexdigits.";
+const ::Parser::CharType * const s_noHexSemicolon =
+    "Found numbers for hexdigit reference but no ending semicolon.";
+const ::Parser::CharType * const s_noNameSemicolon =
+    "Found name for entity reference but no ending semicolon.";
+
+const ::Parser::CharType * const s_noSingleQuoteContent =
+    "Entity value has starting single-quote but no content.";
+const ::Parser::CharType * const s_noDoubleQuoteContent =
+    "Entity value has starting double-quote but no content.";
+const ::Parser::CharType * const s_noEndSingleQuote =
+    "Entity value has no ending single-quote.";
+const ::Parser::CharType * const s_noEndDoubleQuote =
+    "Entity value has no ending double-quote.";
+
+const ::Parser::CharType * const s_noEqualSign =
+    "Found name but no equal sign for attribute.";
+const ::Parser::CharType * const s_noAttributeValue =
+    "Found equal sign but not value in attribute.";
+
+}; // end anonymous namespace
+
 namespace Parser
 {
 
@@ -32,16 +73,11 @@ namespace Xml
 
 // ----------------------------------------------------------------------------
 
-CommentParser::CommentParser( ParserStacks & stacks ) :
-    m_stacks( stacks ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+CommentParser::Rules::Rules( void ) :
     m_start(),
     m_skipOver(),
     m_char(),
+    m_text(),
     m_content(),
     m_end(),
     m_rule()
@@ -49,29 +85,51 @@ CommentParser::CommentParser( ParserStacks & stacks ) :
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = stacks.m_messages;
 
-    m_start = str_p( "<!--" )
-        [ FClear( this ) ]
-        [ FStoreStackSize( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_start ) = str_p( "<!--" )
+        [ FClear() ]
+        [ FStoreStackSize() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
             "Found start of comment, but not end of comment." ) ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
-            "Comment has invalid format." ) ]
-        [ Parser::FPopMessageStack( messages ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser() >> !ch_p( '>' ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
+            "Comment has invalid format." ) ];
 
-    m_char = ( ( print_p - '-' ) | commonRules.m_whiteSpace );
+    PARSER_PROFILE_RULE( m_char ) = ( ( print_p - '-' ) | commonRules.m_whiteSpace );
+
+    PARSER_PROFILE_RULE( m_text ) = ( *( m_char | ( '-' >> m_char ) ) );
+
+    PARSER_PROFILE_RULE( m_content ) = ( FastScanParser< CommentParser::TextScanner >( m_text ) )
+        [ FSetContent() ];
+
+    PARSER_PROFILE_RULE( m_end ) = str_p( "-->" )
+        [ FCancelMessage() ]
+        [ FDone() ];
+
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> ( ( m_content >> m_end ) | m_skipOver ) );
+}
+
+// ----------------------------------------------------------------------------
 
-    m_content = ( *( m_char | ( '-' >> m_char ) ) )
-        [ FSetContent( this ) ];
+CommentParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
 
-    m_end = str_p( "-->" )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FDone( this ) ];
+// ----------------------------------------------------------------------------
 
-    m_rule = ( m_start >> ( ( m_content >> m_end ) | m_skipOver ) );
+CommentParser::CommentParser( const Rules & rules, ParserStacks & stacks ) :
+    m_rules( rules ),
+    m_stacks( stacks ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -91,6 +149,33 @@ void CommentParser::StoreStackSize( void )
 
 // ----------------------------------------------------------------------------
 
+const Parser::CharType * CommentParser::TextScanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    for ( ;; )
+    {
+        // Skips printable chars other than '-', which m_char always takes.
+        begin = commonRules.m_commentFinder.Find( begin, end );
+        if ( begin == end )
+            return end;
+        if ( '-' != *begin )
+        {
+            // Whitespace is unprintable but still in m_char.
+            if ( !commonRules.IsCharClass( *begin, CommonParserRules::CommentClass ) )
+                return begin;
+            ++begin;
+        }
+        else if ( ( begin + 1 != end )
+            && commonRules.IsCharClass( begin[ 1 ], CommonParserRules::CommentClass ) )
+            begin += 2;
+        else
+            return begin;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 void CommentParser::Done( const Parser::CharType * begin,
         const Parser::CharType * end )
 {
@@ -114,46 +199,60 @@ void CommentParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-NameParser::NameParser( ParserStacks & stacks ) :
-    m_stacks( stacks ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
+NameParser::Rules::Rules( void ) :
     m_start(),
     m_firstChar(),
     m_nextChars(),
     m_skipOver(),
     m_goodName(),
+    m_spiritName(),
     m_name()
 {
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = stacks.m_messages;
 
-    m_start = ( epsilon_p )
-        [ FClear( this ) ];
+    PARSER_PROFILE_RULE( m_start ) = ( epsilon_p )
+        [ FClear() ]
+        [ FStoreStackSize() ];
 
-    m_firstChar = ( commonRules.m_firstNameChar )
-        [ FStoreStackSize( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
-            "Name has invalid first character." ) ];
+    PARSER_PROFILE_RULE( m_firstChar ) = ( commonRules.m_firstNameChar )
+        [ FPushMessage( Parser::ErrorLevel::Minor, s_badFirstNameChar ) ];
 
-    m_nextChars = ( *( commonRules.m_nameChar ) )
-        [ Parser::FPrepareMessage( messages,
-            Parser::ErrorLevel::Minor, "Could not parse rest of name." ) ];
+    PARSER_PROFILE_RULE( m_nextChars ) = ( *( commonRules.m_nameChar ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_badRestOfName ) ];
 
-    m_goodName = ( m_firstChar >> m_nextChars )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetName( this ) ];
+    PARSER_PROFILE_RULE( m_goodName ) = ( m_firstChar >> m_nextChars )
+        [ FCancelMessage() ]
+        [ FSetName() ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
-            "Name has an invalid character." ) ]
-        [ Parser::FPopMessageStack( messages ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
+            "Name has an invalid character." ) ];
 
-    m_name = ( m_start >> ( m_goodName | m_skipOver ) );
+    PARSER_PROFILE_RULE( m_spiritName ) = ( m_start >> ( m_goodName | m_skipOver ) );
+
+    PARSER_PROFILE_RULE( m_name ) = FastScanParser< NameParser::Scanner >( m_spiritName );
+}
+
+// ----------------------------------------------------------------------------
+
+NameParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+NameParser::NameParser( const Rules & rules, ParserStacks & stacks ) :
+    m_rules( rules ),
+    m_stacks( stacks ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -193,14 +292,46 @@ void NameParser::SetName( const Parser::CharType * begin, const Parser::CharType
 
 // ----------------------------------------------------------------------------
 
-ReferenceParser::ReferenceParser( NameParser & nameParser ) :
-    m_stacks( nameParser.GetStacks() ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_refType( Parser::Xml::IReferenceReceiver::Unknown ),
-    m_receiver( NULL ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+const Parser::CharType * NameParser::Scanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    if ( ( begin == end )
+      || !commonRules.IsCharClass( *begin, CommonParserRules::FirstNameClass ) )
+        return NULL;
+    ++begin;
+    while ( ( begin != end )
+        && commonRules.IsCharClass( *begin, CommonParserRules::NameClass ) )
+        ++begin;
+    return begin;
+}
+
+// ----------------------------------------------------------------------------
+
+void NameParser::Scanner::Take( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    NameParser::Current().TakeScannedName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NameParser::TakeScannedName( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( begin < end );
+    Clear();
+    StoreStackSize();
+    m_stacks.m_messages.Push( Parser::ErrorLevel::Minor, s_badFirstNameChar );
+    m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor, s_badRestOfName );
+    m_stacks.m_messages.Cancel();
+    SetName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+ReferenceParser::Rules::Rules( const NameParser::Rules & nameRules ) :
     m_start(),
     m_skipOver(),
     m_beginDecDigitRef(),
@@ -211,62 +342,81 @@ ReferenceParser::ReferenceParser( NameParser & nameParser ) :
     m_hexDigitRef(),
     m_nameRef(),
     m_entityRef(),
+    m_spiritRule(),
     m_rule()
 {
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_start = ( ch_p( '&' ) )
-        [ FClear( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
-            "Found start of reference, but not rest of its content.") ];
+    PARSER_PROFILE_RULE( m_start ) = ( ch_p( '&' ) )
+        [ FClear() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor, s_noRestOfReference ) ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
             "Unable to parse reference - skipping rest of content." ) ];
 
-    m_endRef = ( ch_p( ';' ) )
-        [ FSetValidSyntax( this, true ) ]
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endRef ) = ( ch_p( ';' ) )
+        [ FSetValidSyntax( true ) ]
+        [ FCancelMessage() ];
+
+    PARSER_PROFILE_RULE( m_beginDecDigitRef ) = ( ch_p( '#' ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noDecDigits ) ];
 
-    m_beginDecDigitRef = ( ch_p( '#' ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found '&#' for start of digit reference, but no digits.") ];
+    PARSER_PROFILE_RULE( m_middleDecDigitRef ) = ( +commonRules.m_digit )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noDecSemicolon ) ];
 
-    m_middleDecDigitRef = ( +commonRules.m_digit )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found numbers for digits reference but no ending semicolon.") ];
+    PARSER_PROFILE_RULE( m_decDigitRef ) = ( m_beginDecDigitRef >> m_middleDecDigitRef )
+        [ FSetRefType( Parser::Xml::IReferenceReceiver::Digits ) ]
+        [ FSetReference() ];
 
-    m_decDigitRef = ( m_beginDecDigitRef >> m_middleDecDigitRef )
-        [ FSetRefType( this, Parser::Xml::IReferenceReceiver::Digits ) ]
-        [ FSetReference( this ) ];
+    PARSER_PROFILE_RULE( m_beginHexDigitRef ) = ( str_p( "#x" ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noHexDigits ) ];
 
-    m_beginHexDigitRef = ( str_p( "#x" ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found '&#x' for start of hexdigit reference, but no hexdigits.") ];
+    PARSER_PROFILE_RULE( m_middleHexDigitRef ) = ( +commonRules.m_hexDigit )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noHexSemicolon ) ];
 
-    m_middleHexDigitRef = ( +commonRules.m_hexDigit )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found numbers for hexdigit reference but no ending semicolon.") ];
+    PARSER_PROFILE_RULE( m_hexDigitRef ) = ( m_beginHexDigitRef >> m_middleHexDigitRef )
+        [ FSetRefType( Parser::Xml::IReferenceReceiver::HexDigits ) ]
+        [ FSetReference() ];
 
-    m_hexDigitRef = ( m_beginHexDigitRef >> m_middleHexDigitRef )
-        [ FSetRefType( this, Parser::Xml::IReferenceReceiver::HexDigits ) ]
-        [ FSetReference( this ) ];
+    PARSER_PROFILE_RULE( m_nameRef ) = ( nameRules.m_name )
+        [ FSetRefType( Parser::Xml::IReferenceReceiver::Entity ) ]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noNameSemicolon ) ];
 
-    m_nameRef = ( nameParser.GetRule() )
-        [ FSetRefType( this, Parser::Xml::IReferenceReceiver::Entity ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found name for entity reference but no ending semicolon.") ];
+    PARSER_PROFILE_RULE( m_entityRef ) = ( ( m_hexDigitRef | m_decDigitRef | m_nameRef ) >> m_endRef )
+        [ FSetReference() ];
+
+    PARSER_PROFILE_RULE( m_spiritRule ) = ( m_start >> ( m_entityRef | m_skipOver ) )
+        [ FDone() ];
+
+    PARSER_PROFILE_RULE( m_rule ) = FastScanParser< ReferenceParser::Scanner >( m_spiritRule );
+}
+
+// ----------------------------------------------------------------------------
+
+ReferenceParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
 
-    m_entityRef = ( ( m_hexDigitRef | m_decDigitRef | m_nameRef ) >> m_endRef )
-        [ FSetReference( this ) ];
+// ----------------------------------------------------------------------------
 
-    m_rule = ( m_start >> ( m_entityRef | m_skipOver ) )
-        [ FDone( this ) ];
+ReferenceParser::ReferenceParser( const Rules & rules,
+    NameParser & nameParser ) :
+    m_rules( rules ),
+    m_nameParser( nameParser ),
+    m_stacks( nameParser.GetStacks() ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_refType( Parser::Xml::IReferenceReceiver::Unknown ),
+    m_receiver( NULL ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -300,6 +450,9 @@ void ReferenceParser::SetReference( const Parser::CharType * begin,
     assert( m_refType != Parser::Xml::IReferenceReceiver::Unknown );
     assert( m_stackSize <= m_stacks.m_messages.GetStackSize() );
 
+    if ( ( Parser::Xml::IReferenceReceiver::Entity == m_refType )
+        && !m_nameParser.IsValid() )
+        SetValidSyntax( false );
     m_pBegin = begin;
     m_pEnd = end;
     if ( m_receiver == NULL )
@@ -330,14 +483,85 @@ void ReferenceParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-AttributeValueParser::AttributeValueParser( ReferenceParser & refParser ) :
-    m_refParser( refParser ),
-    m_stacks( refParser.GetStacks() ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_validContent( false ),
-    m_singleQuoted( false ),
+const Parser::CharType * ReferenceParser::Scanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    if ( ( begin == end ) || ( '&' != *begin ) )
+        return NULL;
+    ++begin;
+    if ( ( begin != end ) && ( '#' == *begin ) )
+    {
+        ++begin;
+        // The rule tries "#x" first, and does not try "#" if "#x" fails.
+        unsigned int digitClass = CommonParserRules::DigitClass;
+        if ( ( begin != end ) && ( 'x' == *begin ) )
+        {
+            ++begin;
+            digitClass = CommonParserRules::HexDigitClass;
+        }
+        const CommonParserRules & commonRules = CommonParserRules::GetIt();
+        const Parser::CharType * const digits = begin;
+        while ( ( begin != end ) && commonRules.IsCharClass( *begin, digitClass ) )
+            ++begin;
+        if ( digits == begin )
+            return NULL;
+    }
+    else
+    {
+        begin = NameParser::Scanner::Scan( begin, end );
+        if ( NULL == begin )
+            return NULL;
+    }
+    if ( ( begin == end ) || ( ';' != *begin ) )
+        return NULL;
+    return begin + 1;
+}
+
+// ----------------------------------------------------------------------------
+
+void ReferenceParser::Scanner::Take( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    ReferenceParser::Current().TakeScannedReference( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void ReferenceParser::TakeScannedReference( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( begin + 2 < end );
+    const Parser::CharType * const semicolon = end - 1;
+    Clear();
+    m_stacks.m_messages.Push( Parser::ErrorLevel::Minor, s_noRestOfReference );
+    if ( '#' == begin[ 1 ] )
+    {
+        const bool hex = ( 'x' == begin[ 2 ] );
+        m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor,
+            hex ? s_noHexDigits : s_noDecDigits );
+        m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor,
+            hex ? s_noHexSemicolon : s_noDecSemicolon );
+        SetRefType( hex ? Parser::Xml::IReferenceReceiver::HexDigits
+            : Parser::Xml::IReferenceReceiver::Digits );
+        SetReference( begin + 1, semicolon );
+    }
+    else
+    {
+        NameParser::Scanner::Take( begin + 1, semicolon );
+        SetRefType( Parser::Xml::IReferenceReceiver::Entity );
+        m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor,
+            s_noNameSemicolon );
+    }
+    SetValidSyntax( true );
+    m_stacks.m_messages.Cancel();
+    SetReference( begin + 1, end );
+    Done( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeValueParser::Rules::Rules( const ReferenceParser::Rules & refRules ) :
     m_skipOver(),
     m_sqStart(),
     m_dqStart(),
@@ -350,72 +574,94 @@ AttributeValueParser::AttributeValueParser( ReferenceParser & refParser ) :
     m_dqEnd(),
     m_sqEntity(),
     m_dqEntity(),
+    m_spiritRule(),
     m_rule()
 {
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-//        [ FBreakPoint( this, "m_skipOver" )]
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
-            "Unable to parse entity value - skipping rest of content." ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+//        [ FBreakPoint( "m_skipOver" )]
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Major,
+            "Unable to parse attribute value - skipping rest of content." ) ];
 
-    m_sqStart = ( commonRules.m_singleQuote )
-//        [ FBreakPoint( this, "m_sqStart" )]
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
-            "Entity value has starting single-quote but no content." ) ];
+    PARSER_PROFILE_RULE( m_sqStart ) = ( commonRules.m_singleQuote )
+//        [ FBreakPoint( "m_sqStart" )]
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major, s_noSingleQuoteContent ) ];
 
-    m_dqStart = ( commonRules.m_doubleQuote )
-//        [ FBreakPoint( this, "m_dqStart" )]
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
-            "Entity value has starting double-quote but no content." ) ];
+    PARSER_PROFILE_RULE( m_dqStart ) = ( commonRules.m_doubleQuote )
+//        [ FBreakPoint( "m_dqStart" )]
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor, s_noDoubleQuoteContent ) ];
 
-    m_reference = refParser.GetRule()
-//        [ FBreakPoint( this, "m_reference" )]
-        [ FSetReference( this ) ];
+    PARSER_PROFILE_RULE( m_reference ) = refRules.m_rule
+//        [ FBreakPoint( "m_reference" )]
+        [ FSetReference() ];
 
-    m_sqValue = ( +( anychar_p - ( SpiritCharSet( "%&'" ) ) ) )
-//        [ FBreakPoint( this, "m_sqValue" )]
-        [ FSetValue( this ) ];
+    PARSER_PROFILE_RULE( m_sqValue ) = ( +( anychar_p - ( SpiritCharSet( "%&'<" ) ) ) )
+//        [ FBreakPoint( "m_sqValue" )]
+        [ FSetValue() ];
 
-    m_dqValue = ( +( anychar_p - ( SpiritCharSet( "%&\"" ) ) ) )
-//        [ FBreakPoint( this, "m_dqValue" )]
-        [ FSetValue( this ) ];
+    PARSER_PROFILE_RULE( m_dqValue ) = ( +( anychar_p - ( SpiritCharSet( "%&\"<" ) ) ) )
+//        [ FBreakPoint( "m_dqValue" )]
+        [ FSetValue() ];
 
-    m_sqContent = ( *( m_reference | m_sqValue ) )
-//        [ FBreakPoint( this, "m_sqContent" )]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Entity value has no ending single-quote." ) ];
+    PARSER_PROFILE_RULE( m_sqContent ) = ( *( m_reference | m_sqValue ) )
+//        [ FBreakPoint( "m_sqContent" )]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noEndSingleQuote ) ];
 
-    m_dqContent = ( *( m_reference | m_dqValue ) )
-//        [ FBreakPoint( this, "m_dqContent" )]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Entity value has no ending double-quote." ) ];
+    PARSER_PROFILE_RULE( m_dqContent ) = ( *( m_reference | m_dqValue ) )
+//        [ FBreakPoint( "m_dqContent" )]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noEndDoubleQuote ) ];
 
-    m_sqEnd = ( commonRules.m_singleQuote );
-//        [ FBreakPoint( this, "m_sqEnd" )];
+    PARSER_PROFILE_RULE( m_sqEnd ) = ( commonRules.m_singleQuote );
+//        [ FBreakPoint( "m_sqEnd" )];
 
-    m_dqEnd = ( commonRules.m_doubleQuote );
-//        [ FBreakPoint( this, "m_dqEnd" )];
+    PARSER_PROFILE_RULE( m_dqEnd ) = ( commonRules.m_doubleQuote );
+//        [ FBreakPoint( "m_dqEnd" )];
 
-    m_sqEntity = ( m_sqStart >> m_sqContent >> m_sqEnd )
-//        [ FBreakPoint( this, "m_sqEntity" )]
-        [ Parser::FCancelMessage( messages ) ]
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_sqEntity ) = ( m_sqStart >> m_sqContent >> m_sqEnd )
+//        [ FBreakPoint( "m_sqEntity" )]
+        [ FCancelMessage() ]
+        [ FDone() ];
 
-    m_dqEntity = ( m_dqStart >> m_dqContent >> m_dqEnd )
-//        [ FBreakPoint( this, "m_dqEntity" )]
-        [ Parser::FCancelMessage( messages ) ]
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_dqEntity ) = ( m_dqStart >> m_dqContent >> m_dqEnd )
+//        [ FBreakPoint( "m_dqEntity" )]
+        [ FCancelMessage() ]
+        [ FDone() ];
 
-    m_rule = ( m_sqEntity | m_dqEntity | m_skipOver );
-//        [ FBreakPoint( this, "m_rule" )];
+    PARSER_PROFILE_RULE( m_spiritRule ) = ( epsilon_p[ FStoreStackSize() ]
+        >> ( m_sqEntity | m_dqEntity | m_skipOver ) );
+//        [ FBreakPoint( "m_spiritRule" )];
+
+    PARSER_PROFILE_RULE( m_rule ) = FastScanParser< AttributeValueParser::Scanner >( m_spiritRule );
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeValueParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeValueParser::AttributeValueParser( const Rules & rules,
+    ReferenceParser & refParser ) :
+    m_rules( rules ),
+    m_refParser( refParser ),
+    m_stacks( refParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_pEvents( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_validContent( false ),
+    m_singleQuoted( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -445,6 +691,11 @@ void AttributeValueParser::SetValue( const Parser::CharType * begin,
     assert( this != NULL );
     assert( m_stackSize <= m_stacks.m_messages.GetStackSize() );
 
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddValue( begin, end );
+        return;
+    }
     if ( m_receiver == NULL )
         return;
     bool keep = false;
@@ -468,13 +719,18 @@ void AttributeValueParser::SetReference( const Parser::CharType * begin,
     assert( this != NULL );
     assert( m_stackSize <= m_stacks.m_messages.GetStackSize() );
 
+    if ( !m_refParser.IsValid() )
+        SetValidContent( false );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddReference( begin, end, m_refParser.GetRefType() );
+        return;
+    }
     if ( m_receiver == NULL )
         return;
     bool keep = false;
     try
     {
-        if ( !m_refParser.IsValid() )
-            SetValidContent( false );
         keep = m_receiver->AddReference( begin, end, m_refParser.GetRefType() );
     }
     catch ( ... )
@@ -493,6 +749,12 @@ void AttributeValueParser::Done( const Parser::CharType * begin,
     assert( this != NULL );
     SetValidSyntax( true );
     assert( m_stackSize == m_stacks.m_messages.GetStackSize() );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->DoneAttributeValue( IsValid(), m_singleQuoted, begin, end );
+        SetReceiver( NULL );
+        return;
+    }
     if ( m_receiver == NULL )
         return;
     try
@@ -508,51 +770,156 @@ void AttributeValueParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-AttributeParser::AttributeParser( NameParser & nameParser,
-    AttributeValueParser & valueParser ) :
-    m_valueParser( valueParser ),
-    m_nameParser( nameParser ),
-    m_stacks( nameParser.GetStacks() ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_validContent( false ),
-    m_singleQuoted( false ),
+const Parser::CharType * AttributeValueParser::Scanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    if ( begin == end )
+        return NULL;
+    const Parser::CharType quote = *begin;
+    if ( ( '\'' != quote ) && ( '"' != quote ) )
+        return NULL;
+    const CharFinder & finder = ( '\'' == quote )
+        ? CommonParserRules::GetIt().m_sqValueFinder
+        : CommonParserRules::GetIt().m_dqValueFinder;
+    ++begin;
+    while ( begin != end )
+    {
+        const Parser::CharType ch = *begin;
+        if ( quote == ch )
+            return begin + 1;
+        if ( ( '%' == ch ) || ( '<' == ch ) )
+            return NULL;
+        if ( '&' == ch )
+        {
+            begin = ReferenceParser::Scanner::Scan( begin, end );
+            if ( NULL == begin )
+                return NULL;
+        }
+        else
+            begin = finder.Find( begin, end );
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void AttributeValueParser::Scanner::Take( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    AttributeValueParser::Current().TakeScannedValue( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void AttributeValueParser::TakeScannedValue( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( begin + 1 < end );
+    const Parser::CharType quote = *begin;
+    const Parser::CharType * const last = end - 1;
+    const CharFinder & finder = ( '\'' == quote )
+        ? CommonParserRules::GetIt().m_sqValueFinder
+        : CommonParserRules::GetIt().m_dqValueFinder;
+    SetQuoteType( quote );
+    if ( '\'' == quote )
+        m_stacks.m_messages.Push( Parser::ErrorLevel::Major,
+            s_noSingleQuoteContent );
+    else
+        m_stacks.m_messages.Push( Parser::ErrorLevel::Minor,
+            s_noDoubleQuoteContent );
+
+    // Scan already found where each reference ends, and that no '%', '<', or
+    // quote is inside, so each piece is either a reference or a run of other chars.
+    const Parser::CharType * here = begin + 1;
+    while ( here != last )
+    {
+        const Parser::CharType * next = here;
+        if ( '&' == *here )
+        {
+            next = ReferenceParser::Scanner::Scan( here, last );
+            assert( NULL != next );
+            ReferenceParser::Scanner::Take( here, next );
+            SetReference( here, next );
+        }
+        else
+        {
+            next = finder.Find( here, last );
+            SetValue( here, next );
+        }
+        here = next;
+    }
+
+    m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor,
+        ( '\'' == quote ) ? s_noEndSingleQuote : s_noEndDoubleQuote );
+    m_stacks.m_messages.Cancel();
+    Done( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeParser::Rules::Rules( const NameParser::Rules & nameRules,
+    const AttributeValueParser::Rules & valueRules ) :
     m_skipOver(),
     m_name(),
     m_equals(),
     m_value(),
     m_attribute(),
+    m_spiritRule(),
     m_rule()
 {
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_name = ( nameParser.GetRule() )
-        [ FSetName( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
-            "Found name but no equal sign for attribute.") ];
+    PARSER_PROFILE_RULE( m_name ) = ( nameRules.m_name )
+        [ FSetName() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor, s_noEqualSign ) ];
 
-    m_equals = ( commonRules.m_equals )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
-            "Found equal sign but not value in attribute.") ];
+    PARSER_PROFILE_RULE( m_equals ) = ( commonRules.m_equals )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor, s_noAttributeValue ) ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Major,
             "Unable to parse attribute - skipping rest of content." ) ];
 
-    m_value = valueParser.GetRule();
+    PARSER_PROFILE_RULE( m_value ) = valueRules.m_rule;
+
+    PARSER_PROFILE_RULE( m_attribute ) = ( m_name >> m_equals >> m_value )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ]
+        [ FDone() ];
+
+    PARSER_PROFILE_RULE( m_spiritRule ) = ( epsilon_p[ FStoreStackSize() ]
+        >> ( m_attribute | m_skipOver ) );
 
-    m_attribute = ( m_name >> m_equals >> m_value )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ]
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_rule ) = FastScanParser< AttributeParser::Scanner >( m_spiritRule );
+}
+
+// ----------------------------------------------------------------------------
 
-    m_rule = ( m_attribute | m_skipOver );
+AttributeParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeParser::AttributeParser( const Rules & rules, NameParser & nameParser,
+    AttributeValueParser & valueParser ) :
+    m_rules( rules ),
+    m_valueParser( valueParser ),
+    m_nameParser( nameParser ),
+    m_stacks( nameParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_pEvents( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_validContent( false ),
+    m_singleQuoted( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -569,10 +936,16 @@ void AttributeParser::SetName( const Parser::CharType * begin,
 {
     assert( this != NULL );
     m_validSyntax = false;
-    m_validContent = true;
+    m_validContent = m_nameParser.IsValid();
     m_singleQuoted = false;
     m_nameParser.SetReceiver( NULL );
     m_stackSize = m_stacks.m_messages.GetStackSize();
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->SetName( begin, end );
+        m_valueParser.SetEventWriter( m_pEvents );
+        return;
+    }
     if ( m_receiver == NULL )
         return;
     bool keep = false;
@@ -597,8 +970,16 @@ void AttributeParser::Done( const Parser::CharType * begin,
 {
     assert( this != NULL );
     assert( m_stackSize <= m_stacks.m_messages.GetStackSize() );
+    if ( !m_valueParser.IsValid() )
+        SetValidContent( false );
     if ( IsValid() )
         assert( m_stackSize == m_stacks.m_messages.GetStackSize() );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->DoneAttributeValue( IsValid(), m_singleQuoted, begin, end );
+        SetReceiver( NULL );
+        return;
+    }
     if ( m_receiver == NULL )
         return;
     try
@@ -614,6 +995,71 @@ void AttributeParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
+const Parser::CharType * AttributeParser::Scanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    begin = NameParser::Scanner::Scan( begin, end );
+    if ( NULL == begin )
+        return NULL;
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    while ( ( begin != end )
+        && commonRules.IsCharClass( *begin, CommonParserRules::SpaceClass ) )
+        ++begin;
+    if ( ( begin == end ) || ( '=' != *begin ) )
+        return NULL;
+    ++begin;
+    while ( ( begin != end )
+        && commonRules.IsCharClass( *begin, CommonParserRules::SpaceClass ) )
+        ++begin;
+    return AttributeValueParser::Scanner::Scan( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void AttributeParser::Scanner::Split( const Parser::CharType * begin,
+    const Parser::CharType * end, const Parser::CharType * & nameEnd,
+    const Parser::CharType * & valueBegin )
+{
+    nameEnd = NameParser::Scanner::Scan( begin, end );
+    assert( NULL != nameEnd );
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    valueBegin = nameEnd;
+    // Skips the spaces and equal sign between name and value.
+    while ( ( '=' == *valueBegin )
+        || commonRules.IsCharClass( *valueBegin, CommonParserRules::SpaceClass ) )
+        ++valueBegin;
+    assert( valueBegin < end );
+}
+
+// ----------------------------------------------------------------------------
+
+void AttributeParser::Scanner::Take( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    AttributeParser::Current().TakeScannedAttribute( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void AttributeParser::TakeScannedAttribute( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    const Parser::CharType * nameEnd = NULL;
+    const Parser::CharType * valueBegin = NULL;
+    Scanner::Split( begin, end, nameEnd, valueBegin );
+    NameParser::Scanner::Take( begin, nameEnd );
+    SetName( begin, nameEnd );
+    m_stacks.m_messages.Push( Parser::ErrorLevel::Minor, s_noEqualSign );
+    m_stacks.m_messages.Prepare( Parser::ErrorLevel::Minor, s_noAttributeValue );
+    AttributeValueParser::Scanner::Take( valueBegin, end );
+    m_stacks.m_messages.Cancel();
+    SetValidSyntax( true );
+    Done( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
 }; // end namespace Xml
 
 }; // end namespace Parser
@@ -32,6 +32,8 @@ namespace Parser
 
 namespace Xml
 {
+
+class XmlEventWriter;
 
 
 // ----------------------------------------------------------------------------
@@ -40,7 +42,41 @@ class CommentParser
 {
 public:
 
-    explicit CommentParser( ParserStacks & stacks );
+    /// Returns the CommentParser of the parse running on this thread.
+    static CommentParser & Current( void );
+
+    /// Rules for comments.
+    class Rules
+    {
+    public:
+
+        Rules( void );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_skipOver;
+        SpiritRule m_char;
+        /// Finds comment text when fast scanning is off.
+        SpiritRule m_text;
+        SpiritRule m_content;
+        SpiritRule m_end;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds comment text with a CharFinder.  See FastScanParser.
+    struct TextScanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static inline void Take( const Parser::CharType *,
+            const Parser::CharType * ) {}
+    };
+
+    CommentParser( const Rules & rules, ParserStacks & stacks );
     ~CommentParser( void );
 
     inline void SetReceiver( ::Parser::Xml::ICommentReceiver * receiver )
@@ -52,7 +88,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -68,12 +104,14 @@ private:
     typedef ::Parser::FStoreStackSize< CommentParser > FStoreStackSize;
     typedef ::Parser::FBreakPoint< CommentParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< CommentParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< CommentParser > FUnwindStack;
     typedef ::Parser::FSetContent< CommentParser > FSetContent;
     typedef ::Parser::FClear< CommentParser > FClear;
     typedef ::Parser::FDone< CommentParser > FDone;
 
     friend struct ::Parser::FStoreStackSize< CommentParser >;
     friend struct ::Parser::FSetValidSyntax< CommentParser >;
+    friend struct ::Parser::FUnwindStack< CommentParser >;
     friend struct ::Parser::FSetContent< CommentParser >;
     friend struct ::Parser::FClear< CommentParser >;
     friend struct ::Parser::FDone< CommentParser >;
@@ -94,6 +132,13 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     inline void SetContent( const Parser::CharType * begin,
@@ -103,6 +148,7 @@ private:
         m_pEnd = end;
     }
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     ::Parser::Xml::ICommentReceiver * m_receiver;
     unsigned int m_stackSize;
@@ -111,13 +157,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_start;
-    SpiritRule m_skipOver;
-    SpiritRule m_char;
-    SpiritRule m_content;
-    SpiritRule m_end;
-    SpiritRule m_rule;
-
 }; // end class CommentParser
 
 // ----------------------------------------------------------------------------
@@ -126,7 +165,41 @@ class NameParser
 {
 public:
 
-    explicit NameParser( ParserStacks & stacks );
+    /// Returns the NameParser of the parse running on this thread.
+    static NameParser & Current( void );
+
+    /// Rules for names.
+    class Rules
+    {
+    public:
+
+        Rules( void );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_firstChar;
+        SpiritRule m_nextChars;
+        SpiritRule m_skipOver;
+        SpiritRule m_goodName;
+        /// Parses names when fast scanning is off, or when the scanner fails.
+        SpiritRule m_spiritName;
+        SpiritRule m_name;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds valid names without Spirit.  See FastScanParser.
+    struct Scanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static void Take( const Parser::CharType * begin,
+            const Parser::CharType * end );
+    };
+
+    NameParser( const Rules & rules, ParserStacks & stacks );
     ~NameParser( void );
 
     inline void SetReceiver( ::Parser::Xml::INameReceiver * receiver )
@@ -138,7 +211,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_name;
+        return m_rules.m_name;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -151,13 +224,16 @@ private:
     typedef ::Parser::FStoreStackSize< NameParser > FStoreStackSize;
     typedef ::Parser::FBreakPoint< NameParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< NameParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< NameParser > FUnwindStack;
     typedef ::Parser::FClear< NameParser > FClear;
     typedef ::Parser::Xml::FSetName< NameParser > FSetName;
 
     friend struct ::Parser::FStoreStackSize< NameParser >;
     friend struct ::Parser::FSetValidSyntax< NameParser >;
+    friend struct ::Parser::FUnwindStack< NameParser >;
     friend struct ::Parser::FClear< NameParser >;
     friend struct ::Parser::Xml::FSetName< NameParser >;
+    friend struct Scanner;
 
     NameParser( const NameParser & );
     NameParser & operator = ( const NameParser & );
@@ -172,23 +248,28 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     void SetName( const Parser::CharType * begin,
         const Parser::CharType * end );
 
+    /// Makes the calls m_spiritName makes for a name found by Scanner.
+    void TakeScannedName( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     ::Parser::Xml::INameReceiver * m_receiver;
     unsigned int m_stackSize;
     bool m_validSyntax;
 
-    SpiritRule m_start;
-    SpiritRule m_firstChar;
-    SpiritRule m_nextChars;
-    SpiritRule m_skipOver;
-    SpiritRule m_goodName;
-    SpiritRule m_name;
-
 }; // end class NameParser
 
 // ----------------------------------------------------------------------------
@@ -197,14 +278,55 @@ class ReferenceParser
 {
 public:
 
-    explicit ReferenceParser( NameParser & nameParser );
+    /// Returns the ReferenceParser of the parse running on this thread.
+    static ReferenceParser & Current( void );
+
+    /// Rules for character and entity references.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const NameParser::Rules & nameRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_skipOver;
+        SpiritRule m_endRef;
+        SpiritRule m_beginDecDigitRef;
+        SpiritRule m_middleDecDigitRef;
+        SpiritRule m_decDigitRef;
+        SpiritRule m_beginHexDigitRef;
+        SpiritRule m_middleHexDigitRef;
+        SpiritRule m_hexDigitRef;
+        SpiritRule m_nameRef;
+        SpiritRule m_entityRef;
+        /// Parses references when fast scanning is off, or when the scanner
+        /// fails.
+        SpiritRule m_spiritRule;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds valid references without Spirit.  See FastScanParser.
+    struct Scanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static void Take( const Parser::CharType * begin,
+            const Parser::CharType * end );
+    };
+
+    ReferenceParser( const Rules & rules, NameParser & nameParser );
     ~ReferenceParser( void );
 
     inline bool IsValid( void ) const { return m_validSyntax; }
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -232,15 +354,18 @@ private:
     typedef ::Parser::FBreakPoint< ReferenceParser > XmlRefParserBreaker;
     typedef ::Parser::FCompareStackSize< ReferenceParser > FCompareStackSize;
     typedef ::Parser::FSetValidSyntax< ReferenceParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< ReferenceParser > FUnwindStack;
     typedef ::Parser::FClear< ReferenceParser > FClear;
     typedef ::Parser::FDone< ReferenceParser > FDone;
     typedef ::Parser::Xml::FSetReference< ReferenceParser > FSetReference;
 
     friend struct ::Parser::FCompareStackSize< ReferenceParser >;
     friend struct ::Parser::FSetValidSyntax< ReferenceParser >;
+    friend struct ::Parser::FUnwindStack< ReferenceParser >;
     friend struct ::Parser::FClear< ReferenceParser >;
     friend struct ::Parser::FDone< ReferenceParser >;
     friend struct ::Parser::Xml::FSetReference< ReferenceParser >;
+    friend struct Scanner;
 
     ReferenceParser( const ReferenceParser & );
     ReferenceParser & operator = ( const ReferenceParser & );
@@ -252,6 +377,13 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     inline void SetRefType( ::Parser::Xml::IReferenceReceiver::RefType refType )
@@ -262,24 +394,29 @@ private:
     void SetReference( const Parser::CharType * begin,
         const Parser::CharType * end );
 
+    /// Makes the calls m_spiritRule makes for a reference found by Scanner.
+    void TakeScannedReference( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
     struct FSetRefType
     {
-        inline FSetRefType( ReferenceParser * pParser,
+        inline explicit FSetRefType(
             Parser::Xml::IReferenceReceiver::RefType refType ) :
-            m_pParser( pParser ), m_refType( refType ) {}
+            m_refType( refType ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->SetRefType( m_refType );
+            ReferenceParser::Current().SetRefType( m_refType );
         }
         inline void operator () ( ::Parser::CharType ) const
         {
-            m_pParser->SetRefType( m_refType );
+            ReferenceParser::Current().SetRefType( m_refType );
         }
-        ReferenceParser * m_pParser;
         Parser::Xml::IReferenceReceiver::RefType m_refType;
     };
 
+    const Rules & m_rules;
+    NameParser & m_nameParser;
     ParserStacks & m_stacks;
     unsigned int m_stackSize;
     bool m_validSyntax;
@@ -289,19 +426,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_start;
-    SpiritRule m_skipOver;
-    SpiritRule m_endRef;
-    SpiritRule m_beginDecDigitRef;
-    SpiritRule m_middleDecDigitRef;
-    SpiritRule m_decDigitRef;
-    SpiritRule m_beginHexDigitRef;
-    SpiritRule m_middleHexDigitRef;
-    SpiritRule m_hexDigitRef;
-    SpiritRule m_nameRef;
-    SpiritRule m_entityRef;
-    SpiritRule m_rule;
-
 }; // end class ReferenceParser
 
 // ----------------------------------------------------------------------------
@@ -310,19 +434,68 @@ class AttributeValueParser
 {
 public:
 
-    explicit AttributeValueParser( ReferenceParser & refParser );
+    /// Returns the AttributeValueParser of the parse running on this thread.
+    static AttributeValueParser & Current( void );
+
+    /// Rules for quoted attribute values.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const ReferenceParser::Rules & refRules );
+        ~Rules( void );
+
+        SpiritRule m_skipOver;
+        SpiritRule m_sqStart;
+        SpiritRule m_dqStart;
+        SpiritRule m_reference;
+        SpiritRule m_sqValue;
+        SpiritRule m_dqValue;
+        SpiritRule m_sqContent;
+        SpiritRule m_dqContent;
+        SpiritRule m_sqEnd;
+        SpiritRule m_dqEnd;
+        SpiritRule m_sqEntity;
+        SpiritRule m_dqEntity;
+        /// Parses values when fast scanning is off, or when the scanner fails.
+        SpiritRule m_spiritRule;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds valid quoted values without Spirit.  See FastScanParser.
+    struct Scanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static void Take( const Parser::CharType * begin,
+            const Parser::CharType * end );
+    };
+
+    AttributeValueParser( const Rules & rules, ReferenceParser & refParser );
     ~AttributeValueParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IAttributeValueReceiver * receiver )
     {
         m_receiver = receiver;
+        m_pEvents = NULL;
+    }
+
+    /// Sets writer to which the rules add events instead of calling a receiver.
+    inline void SetEventWriter( ::Parser::Xml::XmlEventWriter * pEvents )
+    {
+        m_receiver = NULL;
+        m_pEvents = pEvents;
     }
 
     inline bool IsValid( void ) const { return ( m_validSyntax && m_validContent ); }
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -334,6 +507,8 @@ private:
 
     typedef ::Parser::FBreakPoint< AttributeValueParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< AttributeValueParser > FSetValidSyntax;
+    typedef ::Parser::FStoreStackSize< AttributeValueParser > FStoreStackSize;
+    typedef ::Parser::FUnwindStack< AttributeValueParser > FUnwindStack;
     typedef ::Parser::FSetValidContent< AttributeValueParser > FSetValidContent;
     typedef ::Parser::FDone< AttributeValueParser > FDone;
     typedef ::Parser::Xml::FSetReference< AttributeValueParser > FSetReference;
@@ -342,10 +517,13 @@ private:
 
     friend struct ::Parser::FSetValidContent< AttributeValueParser >;
     friend struct ::Parser::FSetValidSyntax< AttributeValueParser >;
+    friend struct ::Parser::FStoreStackSize< AttributeValueParser >;
+    friend struct ::Parser::FUnwindStack< AttributeValueParser >;
     friend struct ::Parser::FDone< AttributeValueParser >;
     friend struct ::Parser::Xml::FSetReference< AttributeValueParser >;
     friend struct ::Parser::Xml::FSetQuoteType< AttributeValueParser >;
     friend struct ::Parser::Xml::FSetValue< AttributeValueParser >;
+    friend struct Scanner;
 
     AttributeValueParser( const AttributeValueParser & );
     AttributeValueParser & operator = ( const AttributeValueParser & );
@@ -355,6 +533,18 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
+    inline void StoreStackSize( void )
+    {
+        m_stackSize = m_stacks.m_messages.GetStackSize();
     }
 
     inline void SetValidContent( bool valid )
@@ -368,28 +558,20 @@ private:
 
     void SetReference( const Parser::CharType * begin, const Parser::CharType * end );
 
+    /// Makes the calls m_spiritRule makes for a value found by Scanner.
+    void TakeScannedValue( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    const Rules & m_rules;
     ReferenceParser & m_refParser;
     ParserStacks & m_stacks;
     ::Parser::Xml::IAttributeValueReceiver * m_receiver;
+    ::Parser::Xml::XmlEventWriter * m_pEvents;
     unsigned int m_stackSize;
     bool m_validSyntax;
     bool m_validContent;
     bool m_singleQuoted;
 
-    SpiritRule m_skipOver;
-    SpiritRule m_sqStart;
-    SpiritRule m_dqStart;
-    SpiritRule m_reference;
-    SpiritRule m_sqValue;
-    SpiritRule m_dqValue;
-    SpiritRule m_sqContent;
-    SpiritRule m_dqContent;
-    SpiritRule m_sqEnd;
-    SpiritRule m_dqEnd;
-    SpiritRule m_sqEntity;
-    SpiritRule m_dqEntity;
-    SpiritRule m_rule;
-
 }; // end class AttributeValueParser
 
 // ----------------------------------------------------------------------------
@@ -398,19 +580,71 @@ class AttributeParser
 {
 public:
 
-    AttributeParser( NameParser & nameParser, AttributeValueParser & valueParser );
+    /// Returns the AttributeParser of the parse running on this thread.
+    static AttributeParser & Current( void );
+
+    /// Rules for attributes.
+    class Rules
+    {
+    public:
+
+        Rules( const NameParser::Rules & nameRules,
+            const AttributeValueParser::Rules & valueRules );
+        ~Rules( void );
+
+        SpiritRule m_skipOver;
+        SpiritRule m_name;
+        SpiritRule m_equals;
+        SpiritRule m_value;
+        SpiritRule m_attribute;
+        /// Parses attributes when fast scanning is off, or when the scanner fails.
+        SpiritRule m_spiritRule;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds valid attributes without Spirit.  See FastScanParser.
+    struct Scanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static void Take( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        /** Finds the parts of an attribute which Scan accepted.
+         @param nameEnd End of the name, which starts at begin.
+         @param valueBegin Opening quote of the value, which ends at end.
+         */
+        static void Split( const Parser::CharType * begin,
+            const Parser::CharType * end, const Parser::CharType * & nameEnd,
+            const Parser::CharType * & valueBegin );
+    };
+
+    AttributeParser( const Rules & rules,
+        NameParser & nameParser, AttributeValueParser & valueParser );
     ~AttributeParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IAttributeReceiver * receiver )
     {
         m_receiver = receiver;
+        m_pEvents = NULL;
+    }
+
+    /// Sets writer to which the rules add events for the name, each part of
+    /// the value, and the value, instead of calling a receiver.
+    inline void SetEventWriter( ::Parser::Xml::XmlEventWriter * pEvents )
+    {
+        m_receiver = NULL;
+        m_pEvents = pEvents;
     }
 
     inline bool IsValid( void ) const { return ( m_validSyntax && m_validContent ); }
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -422,6 +656,8 @@ private:
 
     typedef ::Parser::FBreakPoint< AttributeParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< AttributeParser > FSetValidSyntax;
+    typedef ::Parser::FStoreStackSize< AttributeParser > FStoreStackSize;
+    typedef ::Parser::FUnwindStack< AttributeParser > FUnwindStack;
     typedef ::Parser::FSetValidContent< AttributeParser > FSetValidContent;
     typedef ::Parser::FDone< AttributeParser > FDone;
     typedef ::Parser::Xml::FSetReference< AttributeParser > FSetReference;
@@ -431,11 +667,14 @@ private:
 
     friend struct ::Parser::FSetValidContent< AttributeParser >;
     friend struct ::Parser::FSetValidSyntax< AttributeParser >;
+    friend struct ::Parser::FStoreStackSize< AttributeParser >;
+    friend struct ::Parser::FUnwindStack< AttributeParser >;
     friend struct ::Parser::FDone< AttributeParser >;
     friend struct ::Parser::Xml::FSetReference< AttributeParser >;
     friend struct ::Parser::Xml::FSetQuoteType< AttributeParser >;
     friend struct ::Parser::Xml::FSetValue< AttributeParser >;
     friend struct ::Parser::Xml::FSetName< AttributeParser >;
+    friend struct Scanner;
 
     AttributeParser( const AttributeParser & );
     AttributeParser & operator = ( const AttributeParser & );
@@ -445,6 +684,18 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
+    inline void StoreStackSize( void )
+    {
+        m_stackSize = m_stacks.m_messages.GetStackSize();
     }
 
     inline void SetValidContent( bool valid )
@@ -459,26 +710,69 @@ private:
 
     void SetName( const Parser::CharType * begin, const Parser::CharType * end );
 
+    /// Makes the calls m_spiritRule makes for an attribute found by Scanner.
+    void TakeScannedAttribute( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    const Rules & m_rules;
     AttributeValueParser & m_valueParser;
     NameParser & m_nameParser;
     ParserStacks & m_stacks;
     ::Parser::Xml::IAttributeReceiver * m_receiver;
+    ::Parser::Xml::XmlEventWriter * m_pEvents;
     unsigned int m_stackSize;
     bool m_validSyntax;
     bool m_validContent;
     bool m_singleQuoted;
 
-    SpiritRule m_skipOver;
-    SpiritRule m_name;
-    SpiritRule m_equals;
-    SpiritRule m_value;
-    SpiritRule m_attribute;
-    SpiritRule m_rule;
-
 }; // end class AttributeParser
 
 // ----------------------------------------------------------------------------
 
+/** @class NameScanner
+ Finds the same names as NameParser::Scanner, but gives each one to the static
+ function Sink::TakeName instead of through a NameParser to a virtual
+ INameReceiver.  Since the sink is known when compiling, its handler can be
+ inlined into the rule.  NameParser::Scanner itself gives each name to the
+ NameParser, and so to whatever receiver it has.  The ParseStartTag template in
+ XmlScanners.hpp scans whole start tags the same way for sinks outside the
+ library.
+ */
+template < class Sink >
+struct NameScanner : public NameParser::Scanner
+{
+    static inline void Take( const Parser::CharType * begin,
+        const Parser::CharType * end )
+    {
+        Sink::TakeName( begin, end );
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class AttributeScanner
+ Finds the same attributes as AttributeParser::Scanner, but gives each one to
+ the static function Sink::TakeAttribute in one call, instead of the calls to
+ SetName, AddValue, AddReference and DoneAttributeValue which an
+ IAttributeReceiver gets.  The value range includes its quote marks.  Each
+ value Scan accepts is valid.  AttributeParser::Scanner itself gives each
+ attribute to the AttributeParser, and so to whatever receiver it has.
+ */
+template < class Sink >
+struct AttributeScanner : public AttributeParser::Scanner
+{
+    static inline void Take( const Parser::CharType * begin,
+        const Parser::CharType * end )
+    {
+        const Parser::CharType * nameEnd = NULL;
+        const Parser::CharType * valueBegin = NULL;
+        AttributeParser::Scanner::Split( begin, end, nameEnd, valueBegin );
+        Sink::TakeAttribute( begin, nameEnd, valueBegin, end );
+    }
+};
+
+// ----------------------------------------------------------------------------
+
 }; // end namespace Xml
 
 }; // end namespace Parser
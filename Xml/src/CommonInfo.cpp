@@ -17,6 +17,9 @@
 
 #include "./CommonInfo.hpp"
 
+#include <ctype.h>
+#include <string.h>
+
 
 using namespace std;
 using namespace boost::spirit;
@@ -78,7 +81,8 @@ CommonParserRules::CommonParserRules( void ) :
     m_doubleQuote( '\"' ),
     m_char( "\x9\xA\xD\x20-\xFF" ),
     m_charNotDash( "\x9\xA\xD\x20-\x2C\x2E-\xFF" ),
-    m_whiteSpace( " \t\r\n" ),
+    // Nil is whitespace so nils embedded in file contents need no rewrite pass.
+    m_whiteSpace( SpiritCharSet( " \t\r\n" ) | ch_p( '\0' ) ),
     m_letter( "a-zA-Z\xC0-\xD6\xD8-\xF6\xF8-\xFF" ),
     m_digit( "0-9" ),
     m_hexDigit( "0-9a-fA-F" ),
@@ -95,10 +99,41 @@ CommonParserRules::CommonParserRules( void ) :
     m_nameToken( +m_nameChar ),
     m_encName( alpha_p >> *( alnum_p | '.' | '_' | '-' ) ),
     m_charRef( ( "&#"  >> +m_digit  >> ';' ) | ( "&#x" >> +m_hexDigit >> ';' ) ),
-    m_entityRef( '&' >> m_name >> ';' )
+    m_entityRef( '&' >> m_name >> ';' ),
+    m_commentFinder( "-", true ),
+    m_sqValueFinder( "'&%<", false ),
+    m_dqValueFinder( "\"&%<", false ),
+    m_cdataRun( false, "]]>" ),
+    m_piRun( false, "?>" ),
+    m_skipOverFinder( "<>\n", false ),
+    m_charClasses()
 {
     assert( this != NULL );
     assert( s_instance == NULL );
+
+    for ( unsigned int ii = 0; ii < 256; ++ii )
+    {
+        const CharType ch = static_cast< CharType >( ii );
+        unsigned char classes = 0;
+        if ( m_firstNameChar.test( ch ) )
+            classes |= FirstNameClass;
+        if ( m_nameChar.test( ch ) )
+            classes |= NameClass;
+        if ( m_digit.test( ch ) )
+            classes |= DigitClass;
+        if ( m_hexDigit.test( ch ) )
+            classes |= HexDigitClass;
+        // Same as ( print_p - '-' ) | m_whiteSpace in CommentParser.
+        if ( ( ( 0 != ::isprint( static_cast< unsigned char >( ch ) ) )
+            && ( '-' != ch ) ) || m_whiteSpace.test( ch ) )
+            classes |= CommentClass;
+        if ( m_whiteSpace.test( ch ) )
+            classes |= SpaceClass;
+        if ( m_whiteSpace.test( ch )
+          || ( ( '\0' != ch ) && ( NULL != ::strchr( "<>/;=\"'", ch ) ) ) )
+            classes |= SkipStopClass;
+        m_charClasses[ ii ] = classes;
+    }
 }
 
 // ----------------------------------------------------------------------------
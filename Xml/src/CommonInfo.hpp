@@ -21,6 +21,8 @@
 
 #include "../../Util/include/ParseInfo.hpp"
 #include "../../Util/include/ParseUtil.hpp"
+#include "../../Util/include/CharFinder.hpp"
+#include "../../Util/include/RuleProfile.hpp"
 
 
 namespace Parser
@@ -35,17 +37,15 @@ namespace Xml
 template< class ParserClass >
 struct FSetName
 {
-    inline explicit FSetName( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const ::Parser::CharType * begin,
         const ::Parser::CharType * end ) const
     {
-        m_pParser->SetName( begin, end );
+        ParserClass::Current().SetName( begin, end );
     }
     inline void operator () ( ::Parser::CharType ch ) const
     {
-        m_pParser->SetName( ch );
+        ParserClass::Current().SetName( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -53,18 +53,15 @@ struct FSetName
 template< class ParserClass >
 struct FSetValue
 {
-    inline explicit FSetValue( ParserClass * pParser ) :
-        m_pParser( pParser ) {}
     inline void operator () ( const Parser::CharType * begin,
         const Parser::CharType * end ) const
     {
-        m_pParser->SetValue( begin, end );
+        ParserClass::Current().SetValue( begin, end );
     }
     inline void operator () ( ::Parser::CharType ch ) const
     {
-        m_pParser->SetValue( ch );
+        ParserClass::Current().SetValue( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -72,17 +69,15 @@ struct FSetValue
 template< class ParserClass >
 struct FSetReference
 {
-    inline explicit FSetReference( ParserClass * pParser ) : m_pParser( pParser ) {}
     inline void operator () ( const ::Parser::CharType * begin,
         const ::Parser::CharType * end ) const
     {
-        m_pParser->SetReference( begin, end );
+        ParserClass::Current().SetReference( begin, end );
     }
     inline void operator () ( ::Parser::CharType ch ) const
     {
-        m_pParser->SetReference( ch );
+        ParserClass::Current().SetReference( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -90,18 +85,15 @@ struct FSetReference
 template< class ParserClass >
 struct FSetQuoteType
 {
-    inline explicit FSetQuoteType( ParserClass * pParser ) :
-        m_pParser( pParser ) {}
     inline void operator () ( const ::Parser::CharType * begin,
         const ::Parser::CharType * end ) const
     {
-        m_pParser->SetQuoteType( begin, end );
+        ParserClass::Current().SetQuoteType( begin, end );
     }
     inline void operator () ( const ::Parser::CharType ch ) const
     {
-        m_pParser->SetQuoteType( ch );
+        ParserClass::Current().SetQuoteType( ch );
     }
-    ParserClass * m_pParser;
 };
 
 // ----------------------------------------------------------------------------
@@ -124,10 +116,193 @@ private:
 
 // ----------------------------------------------------------------------------
 
+/// Returns the stacks of the parse running on this thread.
+ParserStacks & GetCurrentStacks( void );
+
+/// Returns true if the parse running on this thread uses FastScanParsers.
+bool IsFastScanning( void );
+
+// ----------------------------------------------------------------------------
+// These do the same as the message actions in ParseUtil.hpp, but act on the
+// message stack of the current parse, so the xml rules can be shared.
+
+struct FPushMessage
+{
+    inline FPushMessage( Parser::ErrorLevel::Levels level,
+        const CharType * message, const char * file = NULL,
+        const char * ruleName = NULL ) :
+        m_level( level ), m_message( message ),
+        m_file( file ), m_ruleName( ruleName ) {}
+
+    inline void operator () ( const CharType *, const CharType * ) const
+    {
+        GetCurrentStacks().m_messages.Push( m_level, m_message, m_file, m_ruleName );
+    }
+
+    inline void operator () ( CharType ) const
+    {
+        GetCurrentStacks().m_messages.Push( m_level, m_message, m_file, m_ruleName );
+    }
+
+    Parser::ErrorLevel::Levels m_level;
+    const CharType * m_message;
+    const char * m_file;
+    const char * m_ruleName;
+};
+
+// ----------------------------------------------------------------------------
+
+struct FPopMessageStack
+{
+    inline void operator () ( const CharType *, const CharType * ) const
+    {
+        GetCurrentStacks().m_messages.Pop();
+    }
+
+    inline void operator () ( CharType ) const
+    {
+        GetCurrentStacks().m_messages.Pop();
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+struct FPrepareMessage
+{
+    inline FPrepareMessage( Parser::ErrorLevel::Levels level,
+        const CharType * message, const char * file = NULL,
+        const char * ruleName = NULL ) :
+        m_level( level ), m_message( message ),
+        m_file( file ), m_ruleName( ruleName ) {}
+
+    inline void operator () ( const CharType *, const CharType * ) const
+    {
+        GetCurrentStacks().m_messages.Prepare( m_level, m_message, m_file,
+            m_ruleName );
+    }
+
+    inline void operator () ( CharType ) const
+    {
+        GetCurrentStacks().m_messages.Prepare( m_level, m_message, m_file,
+            m_ruleName );
+    }
+
+    Parser::ErrorLevel::Levels m_level;
+    const CharType * m_message;
+    const char * m_file;
+    const char * m_ruleName;
+};
+
+// ----------------------------------------------------------------------------
+
+struct FSendMessageNow
+{
+    inline FSendMessageNow( Parser::ErrorLevel::Levels level,
+        const CharType * message ) :
+        m_level( level ), m_message( message ) {}
+
+    inline void operator () ( const CharType *, const CharType * ) const
+    {
+        GetCurrentStacks().m_messages.Send( m_level, m_message );
+    }
+
+    inline void operator () ( CharType ) const
+    {
+        GetCurrentStacks().m_messages.Send( m_level, m_message );
+    }
+
+    Parser::ErrorLevel::Levels m_level;
+    const CharType * m_message;
+};
+
+// ----------------------------------------------------------------------------
+
+struct FCancelMessage
+{
+    inline void operator () ( const CharType *, const CharType * ) const
+    {
+        GetCurrentStacks().m_messages.Cancel();
+    }
+
+    inline void operator () ( CharType ) const
+    {
+        GetCurrentStacks().m_messages.Cancel();
+    }
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class FastScanParser
+ Gives a production to a hand-written scanner before the Spirit rule for it.
+ If the scanner finds a whole, valid production, it makes the same calls that
+ the rule's actions would make, and the rule is skipped.  Anything else, such
+ as a syntax error, goes to the rule, so results, messages, and receiver calls
+ are the same either way.  The Scanner class provides two static functions:
+ Scan returns the end of a valid production at the start of a range, or NULL,
+ and calls nothing.  Take makes the calls for a range which Scan accepted.
+ */
+template < class Scanner >
+class FastScanParser :
+    public ::boost::spirit::parser< FastScanParser< Scanner > >
+{
+public:
+
+    typedef FastScanParser< Scanner > self_t;
+
+    template < typename ScannerT >
+    struct result
+    {
+        typedef typename ::boost::spirit::match_result< ScannerT,
+            ::boost::spirit::nil_t >::type type;
+    };
+
+    inline explicit FastScanParser( const SpiritRule & rule ) : m_rule( rule ) {}
+
+    template < typename ScannerT >
+    typename ::boost::spirit::parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
+    {
+        if ( IsFastScanning() )
+        {
+            const CharType * const begin = scan.first;
+            const CharType * const end = Scanner::Scan( begin, scan.last );
+            if ( NULL != end )
+            {
+                Scanner::Take( begin, end );
+                scan.first = end;
+                return scan.create_match( end - begin, ::boost::spirit::nil_t(),
+                    begin, end );
+            }
+        }
+        return m_rule.parse( scan );
+    }
+
+private:
+
+    /// Rule which does the same as the scanner, and handles all errors.
+    const SpiritRule & m_rule;
+};
+
+// ----------------------------------------------------------------------------
+
 class CommonParserRules
 {
 public:
 
+    /// Bits for IsCharClass, one for each character set used by scanners.
+    enum CharClass
+    {
+        FirstNameClass = 0x01, ///< Chars in m_firstNameChar.
+        NameClass      = 0x02, ///< Chars in m_nameChar.
+        DigitClass     = 0x04, ///< Chars in m_digit.
+        HexDigitClass  = 0x08, ///< Chars in m_hexDigit.
+        CommentClass   = 0x10, ///< Chars a comment may have after a '-'.
+        SpaceClass     = 0x20, ///< Chars in m_whiteSpace.
+        /// Whitespace, quotes, and other chars which end a name, value, or
+        /// reference, where a SkipOverParser within a tag or value stops.
+        SkipStopClass  = 0x40
+    };
+
     static void IncReference( void );
     static void DecReference( void );
 
@@ -156,6 +331,26 @@ public:
     const SpiritRule m_charRef;
     const SpiritRule m_entityRef;
 
+    /// Finds '-' and unprintable chars in comments.
+    const CharFinder m_commentFinder;
+    /// Finds chars which end a run of chars in a single-quoted value.
+    const CharFinder m_sqValueFinder;
+    /// Finds chars which end a run of chars in a double-quoted value.
+    const CharFinder m_dqValueFinder;
+    /// Finds end of CDATA content.
+    const RunFinder m_cdataRun;
+    /// Finds end of processing instruction content.
+    const RunFinder m_piRun;
+    /// Finds the '<', '>', and newlines where SkipOverParser stops.
+    const CharFinder m_skipOverFinder;
+
+    /// Returns true if ch is in any of the character sets given by classes.
+    inline bool IsCharClass( CharType ch, unsigned int classes ) const
+    {
+        return ( 0 != ( m_charClasses[ static_cast< unsigned char >( ch ) ]
+            & classes ) );
+    }
+
 private:
     CommonParserRules( void );
     ~CommonParserRules( void );
@@ -166,10 +361,74 @@ private:
     static CommonParserRules * s_instance;
     static unsigned long s_count;
 
+    /// CharClass bits for each char, made from the character sets above so
+    /// scanners and rules always agree on which chars belong to each set.
+    unsigned char m_charClasses[ 256 ];
+
 }; // end class CommonParserRules
 
 // ----------------------------------------------------------------------------
 
+/** @class SkipOverParser
+ Skips the rest of a production which could not be parsed, up to the next '<',
+ '>', or newline, where the next construct may start, and matches the chars it
+ skipped.  The rule which used it then matches too, so its actions send the
+ message for the error, and the parser goes on from the boundary instead of
+ giving up on the rest of the input.  A production within a tag or a quoted
+ value stops at SkipStopClass chars instead, such as whitespace and quotes, so
+ only that production is skipped and the tag or value around it still ends in
+ place.
+ Fails without moving if the production stopped right at a boundary, so a
+ rule repeated by a kleene star always moves.
+ */
+class SkipOverParser :
+    public ::boost::spirit::parser< SkipOverParser >
+{
+public:
+
+    typedef SkipOverParser self_t;
+
+    template < typename ScannerT >
+    struct result
+    {
+        typedef typename ::boost::spirit::match_result< ScannerT,
+            ::boost::spirit::nil_t >::type type;
+    };
+
+    inline SkipOverParser( void ) : m_stopClass( 0 ) {}
+
+    /// @param stopClass Bit for the chars where skipping stops.
+    inline explicit SkipOverParser( CommonParserRules::CharClass stopClass ) :
+        m_stopClass( stopClass ) {}
+
+    template < typename ScannerT >
+    typename ::boost::spirit::parser_result< self_t, ScannerT >::type
+        parse( const ScannerT & scan ) const
+    {
+        const CommonParserRules & commonRules = CommonParserRules::GetIt();
+        const CharType * const begin = scan.first;
+        const CharType * end = begin;
+        if ( 0 == m_stopClass )
+            end = commonRules.m_skipOverFinder.Find( begin, scan.last );
+        else
+        {
+            while ( ( end != scan.last ) && !commonRules.IsCharClass( *end, m_stopClass ) )
+                ++end;
+        }
+        if ( end == begin )
+            return scan.no_match();
+        scan.first = end;
+        return scan.create_match( end - begin, ::boost::spirit::nil_t(),
+            begin, end );
+    }
+
+private:
+
+    unsigned int m_stopClass;
+};
+
+// ----------------------------------------------------------------------------
+
 }; // end namespace Xml
 
 }; // end namespace Parser
@@ -0,0 +1,454 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+
+// ----------------------------------------------------------------------------
+
+#include "./DocumentFeeder.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "./CommonInfo.hpp"
+
+
+using namespace std;
+
+namespace
+{
+
+using ::Parser::CharType;
+
+/// How much of a literal matches the start of a range.
+enum Match
+{
+    NoMatch,   ///< Range does not start with literal.
+    PartMatch, ///< Range is too short, but matches start of literal.
+    FullMatch  ///< Range starts with whole literal.
+};
+
+// ----------------------------------------------------------------------------
+
+Match StartsWith( const CharType * begin, const CharType * end,
+    const char * literal )
+{
+    for ( ; '\0' != *literal; ++literal, ++begin )
+    {
+        if ( begin == end )
+            return PartMatch;
+        if ( *begin != *literal )
+            return NoMatch;
+    }
+    return FullMatch;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns pointer just past first place text occurs in range, or NULL.
+const CharType * FindPast( const CharType * begin, const CharType * end,
+    const char * text )
+{
+    const unsigned long length = static_cast< unsigned long >( ::strlen( text ) );
+    while ( static_cast< unsigned long >( end - begin ) >= length )
+    {
+        const CharType * here = static_cast< const CharType * >(
+            ::memchr( begin, text[ 0 ], end - begin ) );
+        if ( ( NULL == here ) || ( static_cast< unsigned long >( end - here ) < length ) )
+            return NULL;
+        if ( ::memcmp( here, text, length ) == 0 )
+            return here + length;
+        begin = here + 1;
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Finds the '>' which ends a tag or declaration, skipping over quoted text,
+ and over brackets if the markup may have an internal subset.  An attribute
+ value may not hold a '<', so the rules end a tag with such a value at the
+ first '>' after its opening quote, and so does this, so a fed tag ends where
+ it does when the document is parsed in one pass.  Entity values in an
+ internal subset may hold a '<', so quotes in declarations are skipped whole.
+ @param item Start of the item, from which places in scan are offsets.
+ @param scan Quote and bracket depth where an earlier search stopped, which
+  are updated if the end is not found.
+ @return Pointer just past end of markup, or NULL if end is not in range.
+ */
+const CharType * FindMarkupEnd( const CharType * item, const CharType * begin,
+    const CharType * end, bool hasSubset, ::Parser::Xml::ItemScan & scan )
+{
+    CharType quote = scan.m_quote;
+    unsigned long depth = scan.m_depth;
+    for ( const CharType * here = begin; here != end; ++here )
+    {
+        const CharType ch = *here;
+        if ( scan.m_badValue )
+        {
+            if ( '>' == ch )
+                return here + 1;
+        }
+        else if ( '\0' != quote )
+        {
+            if ( ch == quote )
+            {
+                quote = '\0';
+                scan.m_quotedClose = 0;
+            }
+            else if ( hasSubset )
+                continue;
+            else if ( ( '>' == ch ) && ( 0 == scan.m_quotedClose ) )
+                scan.m_quotedClose = static_cast< unsigned long >( here + 1 - item );
+            else if ( '<' == ch )
+            {
+                if ( 0 != scan.m_quotedClose )
+                    return item + scan.m_quotedClose;
+                scan.m_badValue = true;
+            }
+        }
+        else if ( ( '"' == ch ) || ( '\'' == ch ) )
+            quote = ch;
+        else if ( hasSubset && ( '[' == ch ) )
+            ++depth;
+        else if ( hasSubset && ( ']' == ch ) && ( 0 < depth ) )
+            --depth;
+        else if ( ( '>' == ch ) && ( 0 == depth ) )
+            return here + 1;
+    }
+    scan.m_quote = quote;
+    scan.m_depth = depth;
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Finds the end of a run of character data.  A reference which may still be
+ incomplete is held back so it is parsed whole when the next chunk arrives,
+ and so is a "]" or "]]" at the end, so a "]]>" is always seen whole.  If an
+ earlier search held back the whole run, that run holds no '<' and is just a
+ reference which may still be incomplete, so the search only looks past it.
+ @return Pointer to end of run, or NULL if nothing can be parsed yet.
+ */
+const CharType * FindTextEnd( const CharType * begin, const CharType * end,
+    bool finishing, ::Parser::Xml::ItemScan & scan )
+{
+    const CharType * from = begin + scan.m_scanned;
+    const CharType * here = static_cast< const CharType * >(
+        ::memchr( from, '<', end - from ) );
+    if ( NULL != here )
+        return here;
+    if ( finishing )
+        return end;
+    if ( ']' == *( end - 1 ) )
+    {
+        here = end - 1;
+        if ( ( here != begin ) && ( ']' == *( here - 1 ) ) )
+            --here;
+        scan.m_scanned = 0;
+        return ( here == begin ) ? NULL : here;
+    }
+
+    const ::Parser::Xml::CommonParserRules & commonRules =
+        ::Parser::Xml::CommonParserRules::GetIt();
+    here = end;
+    while ( here != from )
+    {
+        const CharType ch = *( here - 1 );
+        if ( '&' == ch )
+            break;
+        if ( ( '#' != ch ) && !commonRules.m_nameChar.test( ch ) )
+            return end;
+        --here;
+    }
+    if ( here == from )
+    {
+        if ( from == begin )
+            return end;
+        // Still within the reference at begin.
+        scan.m_scanned = static_cast< unsigned long >( end - begin );
+        return NULL;
+    }
+    if ( here - 1 != begin )
+        return here - 1;
+    scan.m_scanned = static_cast< unsigned long >( end - begin );
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Finds the text which ends a comment, CDATA section, or processing
+ instruction, starting where an earlier search stopped.
+ @param first Place just past the start of the item.
+ */
+const CharType * FindItemPast( const CharType * begin, const CharType * first,
+    const CharType * end, const char * text, ::Parser::Xml::ItemScan & scan )
+{
+    // The last few characters searched may start the text.
+    const unsigned long overlap = static_cast< unsigned long >( ::strlen( text ) ) - 1;
+    const CharType * from = first;
+    if ( scan.m_scanned > overlap )
+        from = max( first, begin + ( scan.m_scanned - overlap ) );
+    const CharType * itemEnd = FindPast( from, end, text );
+    if ( NULL == itemEnd )
+        scan.m_scanned = static_cast< unsigned long >( end - begin );
+    return itemEnd;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Finds the '>' which ends a tag or declaration, starting where an earlier
+ search stopped.
+ @param first Place just past the start of the item.
+ */
+const CharType * FindItemMarkupEnd( const CharType * begin, const CharType * first,
+    const CharType * end, bool hasSubset, ::Parser::Xml::ItemScan & scan )
+{
+    const CharType * from = max( first, begin + scan.m_scanned );
+    const CharType * itemEnd = FindMarkupEnd( begin, from, end, hasSubset, scan );
+    if ( NULL == itemEnd )
+        scan.m_scanned = static_cast< unsigned long >( end - begin );
+    return itemEnd;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Tells the kind of item at begin, or NotKnown if range is too short.
+::Parser::Xml::ItemScan::Kind FindItemKind( const CharType * begin,
+    const CharType * end )
+{
+    if ( '<' != *begin )
+        return ::Parser::Xml::ItemScan::Text;
+    Match match = NoMatch;
+    if ( NoMatch != ( match = StartsWith( begin, end, "<!--" ) ) )
+        return ( FullMatch == match ) ? ::Parser::Xml::ItemScan::Comment
+            : ::Parser::Xml::ItemScan::NotKnown;
+    if ( NoMatch != ( match = StartsWith( begin, end, "<![CDATA[" ) ) )
+        return ( FullMatch == match ) ? ::Parser::Xml::ItemScan::CData
+            : ::Parser::Xml::ItemScan::NotKnown;
+    if ( NoMatch != ( match = StartsWith( begin, end, "<?" ) ) )
+        return ( FullMatch == match ) ? ::Parser::Xml::ItemScan::Instruction
+            : ::Parser::Xml::ItemScan::NotKnown;
+    if ( NoMatch != ( match = StartsWith( begin, end, "<!" ) ) )
+        return ( FullMatch == match ) ? ::Parser::Xml::ItemScan::Declaration
+            : ::Parser::Xml::ItemScan::NotKnown;
+    return ::Parser::Xml::ItemScan::Tag;
+}
+
+// ----------------------------------------------------------------------------
+
+/** Returns pointer to end of first item in range, or NULL if it is incomplete.
+ @param scan How far an earlier search for the end of this item went, which is
+  updated if the item is incomplete.
+ */
+const CharType * FindItemEnd( const CharType * begin, const CharType * end,
+    bool finishing, ::Parser::Xml::ItemScan & scan )
+{
+    assert( begin < end );
+    if ( ::Parser::Xml::ItemScan::NotKnown == scan.m_kind )
+        scan.m_kind = FindItemKind( begin, end );
+
+    const CharType * itemEnd = NULL;
+    switch ( scan.m_kind )
+    {
+        case ::Parser::Xml::ItemScan::Text:
+            return FindTextEnd( begin, end, finishing, scan );
+        case ::Parser::Xml::ItemScan::Comment:
+            itemEnd = FindItemPast( begin, begin + 4, end, "-->", scan );
+            break;
+        case ::Parser::Xml::ItemScan::CData:
+            itemEnd = FindItemPast( begin, begin + 9, end, "]]>", scan );
+            break;
+        case ::Parser::Xml::ItemScan::Instruction:
+            itemEnd = FindItemPast( begin, begin + 2, end, "?>", scan );
+            break;
+        case ::Parser::Xml::ItemScan::Declaration:
+            itemEnd = FindItemMarkupEnd( begin, begin + 2, end, true, scan );
+            break;
+        case ::Parser::Xml::ItemScan::Tag:
+            itemEnd = FindItemMarkupEnd( begin, begin + 1, end, false, scan );
+            break;
+        default:
+            break;
+    }
+
+    if ( ( NULL == itemEnd ) && finishing )
+        itemEnd = end;
+    return itemEnd;
+}
+
+}; // end anonymous namespace
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+
+// ----------------------------------------------------------------------------
+
+DocumentFeeder::DocumentFeeder( DocumentParser & documentParser ) :
+    m_documentParser( documentParser ),
+    m_pending(),
+    m_scan(),
+    m_feeding( false ),
+    m_hasData( false )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentFeeder::~DocumentFeeder( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentFeeder::Start( ::Parser::Xml::IDocumentReceiver * receiver )
+{
+    assert( this != NULL );
+    m_pending.clear();
+    m_scan.Reset();
+    m_feeding = true;
+    m_hasData = false;
+    m_documentParser.BeginItems( receiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentFeeder::Feed( const ::Parser::CharType * begin,
+    const ::Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( m_feeding );
+    assert( NULL != begin );
+    assert( begin <= end );
+
+    if ( begin != end )
+        m_hasData = true;
+    if ( m_pending.empty() )
+    {
+        // Common case: parse items directly within caller's chunk.
+        const CharType * rest = ParseItems( begin, end, false );
+        m_pending.assign( rest, end );
+        return;
+    }
+
+    m_pending.insert( m_pending.end(), begin, end );
+    const CharType * first = &m_pending[ 0 ];
+    const CharType * rest = ParseItems( first, first + m_pending.size(), false );
+    m_pending.erase( m_pending.begin(), m_pending.begin() + ( rest - first ) );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentFeeder::Finish( void )
+{
+    assert( this != NULL );
+    assert( m_feeding );
+
+    if ( !m_pending.empty() )
+    {
+        const CharType * first = &m_pending[ 0 ];
+        ParseItems( first, first + m_pending.size(), true );
+        m_pending.clear();
+    }
+    m_scan.Reset();
+    m_feeding = false;
+    m_documentParser.FinishItems();
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentFeeder::FeedItems( const ::Parser::CharType * begin,
+    const ::Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( m_feeding );
+    assert( m_pending.empty() );
+    assert( begin <= end );
+
+    if ( begin != end )
+        m_hasData = true;
+    ParseItems( begin, end, true );
+}
+
+// ----------------------------------------------------------------------------
+
+const ::Parser::CharType * DocumentFeeder::FeedItem(
+    const ::Parser::CharType * begin, const ::Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( m_feeding );
+    assert( m_pending.empty() );
+    assert( begin < end );
+
+    m_hasData = true;
+    const CharType * itemEnd = GetItemEnd( begin, end );
+    m_documentParser.ParseItem( begin, itemEnd );
+    return itemEnd;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentFeeder::Cancel( void )
+{
+    assert( this != NULL );
+    m_pending.clear();
+    m_scan.Reset();
+    m_feeding = false;
+    m_documentParser.CancelItems();
+}
+
+// ----------------------------------------------------------------------------
+
+const ::Parser::CharType * DocumentFeeder::GetItemEnd(
+    const ::Parser::CharType * begin, const ::Parser::CharType * end )
+{
+    ItemScan scan;
+    return FindItemEnd( begin, end, true, scan );
+}
+
+// ----------------------------------------------------------------------------
+
+const ::Parser::CharType * DocumentFeeder::ParseItems(
+    const ::Parser::CharType * begin, const ::Parser::CharType * end,
+    bool finishing )
+{
+    assert( this != NULL );
+
+    while ( begin < end )
+    {
+        const CharType * itemEnd = FindItemEnd( begin, end, finishing, m_scan );
+        if ( NULL == itemEnd )
+            break;
+        m_scan.Reset();
+        m_documentParser.ParseItem( begin, itemEnd );
+        begin = itemEnd;
+    }
+    return begin;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+#ifndef PARSER_XML_DOCUMENT_FEEDER_H_INCLUDED
+#define PARSER_XML_DOCUMENT_FEEDER_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+#include <vector>
+
+#include "../../Util/include/TypeDefs.hpp"
+
+#include "../include/Receivers.hpp"
+
+#include "./NodeParsers.hpp"
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+
+// ----------------------------------------------------------------------------
+
+/** @struct ItemScan
+ How far the search for the end of an item has gone, so the search resumes
+ where it stopped when the next chunk arrives instead of starting over from
+ the beginning of the item.  All places are offsets from start of the item.
+ */
+struct ItemScan
+{
+    /// Kind of item, as told by its first few characters.
+    enum Kind
+    {
+        NotKnown,    ///< Too few characters yet to tell.
+        Text,        ///< Character data.
+        Comment,     ///< Starts with "<!--".
+        CData,       ///< Starts with "<![CDATA[".
+        Instruction, ///< Starts with "<?".
+        Declaration, ///< Starts with "<!", such as a DOCTYPE.
+        Tag          ///< Start tag or end tag.
+    };
+
+    inline ItemScan( void ) { Reset(); }
+
+    /// Forgets the search, as for a new item.
+    inline void Reset( void )
+    {
+        m_kind = NotKnown;
+        m_scanned = 0;
+        m_quote = '\0';
+        m_depth = 0;
+        m_quotedClose = 0;
+        m_badValue = false;
+    }
+
+    Kind m_kind;
+    /// Number of characters already searched without finding the end.
+    unsigned long m_scanned;
+    /// Quote character of markup if search stopped within quotes.
+    ::Parser::CharType m_quote;
+    /// Depth of brackets in a declaration where the search stopped.
+    unsigned long m_depth;
+    /// Place just past the first '>' within the quotes of a tag where the
+    /// search stopped, or zero if there is none.
+    unsigned long m_quotedClose;
+    /// True if a '<' was found within the quotes of a tag, so the tag ends at
+    /// the next '>' whether quoted or not.
+    bool m_badValue;
+};
+
+// ----------------------------------------------------------------------------
+
+/** @class DocumentFeeder
+ Parses a document which arrives in chunks, such as from a socket or pipe.
+ Each chunk is split into items - tags, comments, CDATA sections, processing
+ instructions, and runs of character data - and each complete item is given to
+ the DocumentParser as soon as it is found, so receivers get their calls while
+ the rest of the document is still arriving.  Items are parsed in place within
+ the chunk.  Only an item split across chunks is copied, and only until the
+ chunk which completes it arrives, so memory use depends on the chunk size and
+ the largest single item, not on the size of the document.  The search for the
+ end of a split item resumes where it stopped, so an item fed in many small
+ chunks is still only searched once.
+ */
+class DocumentFeeder
+{
+public:
+
+    explicit DocumentFeeder( DocumentParser & documentParser );
+
+    ~DocumentFeeder( void );
+
+    /// Prepares to receive chunks of a new document.
+    void Start( ::Parser::Xml::IDocumentReceiver * receiver );
+
+    /// Parses all complete items in chunk, and keeps any incomplete tail.
+    void Feed( const ::Parser::CharType * begin, const ::Parser::CharType * end );
+
+    /// Parses whatever is left and ends the document.
+    void Finish( void );
+
+    /** Parses every item in range, even an incomplete one at the end, but does
+     not end the document.  For a document split into pieces which each begin
+     and end between items, so nothing is kept for the next piece.
+     */
+    void FeedItems( const ::Parser::CharType * begin, const ::Parser::CharType * end );
+
+    /** Parses the first item in range, even an incomplete one, and returns its
+     end.  Lets a caller pull a document one item at a time, with nothing kept
+     between calls.
+     */
+    const ::Parser::CharType * FeedItem( const ::Parser::CharType * begin,
+        const ::Parser::CharType * end );
+
+    /// Drops any remaining content without reporting it.
+    void Cancel( void );
+
+    /** Returns end of the item which starts at begin, found the same way as
+     when feeding.  An item which does not end within range ends at end.
+     */
+    static const ::Parser::CharType * GetItemEnd( const ::Parser::CharType * begin,
+        const ::Parser::CharType * end );
+
+    inline bool IsFeeding( void ) const { return m_feeding; }
+
+    /// Returns true if any content was given since feeding started.
+    inline bool HasData( void ) const { return m_hasData; }
+
+    inline bool IsValid( void ) const { return m_documentParser.IsValid(); }
+
+private:
+
+    DocumentFeeder( const DocumentFeeder & );
+    DocumentFeeder & operator = ( const DocumentFeeder & );
+
+    /** Parses each complete item in range.  The search for end of first item
+     resumes from m_scan, and m_scan keeps the search for an incomplete item.
+     @param finishing True if no more content will arrive, so an incomplete
+      item at the end is parsed anyway.
+     @return Start of first incomplete item, or end if none.
+     */
+    const ::Parser::CharType * ParseItems( const ::Parser::CharType * begin,
+        const ::Parser::CharType * end, bool finishing );
+
+    DocumentParser & m_documentParser;
+
+    /// Incomplete item left over from previous chunk.
+    ::std::vector< ::Parser::CharType > m_pending;
+
+    /// How far the search for end of first incomplete item has gone.
+    ItemScan m_scan;
+
+    bool m_feeding;
+
+    /// True once any content was given to Feed, FeedItems, or FeedItem.
+    bool m_hasData;
+
+}; // end class DocumentFeeder
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
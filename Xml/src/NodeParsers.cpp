@@ -0,0 +1,1411 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+
+// ----------------------------------------------------------------------------
+
+#include "./NodeParsers.hpp"
+
+#include <string.h>
+
+#include "../include/Receivers.hpp"
+#include "../include/XmlEventBatcher.hpp"
+
+#include "./BasicParsers.hpp"
+#include "./PrologParsers.hpp"
+
+
+using namespace std;
+using namespace boost::spirit;
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Range given to receivers when parsing items and no content is left.
+const Parser::CharType s_noContent[ 1 ] = { '\0' };
+
+}; // end anonymous namespace
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+
+// ----------------------------------------------------------------------------
+
+NodeParser::Rules::Rules( const NameParser::Rules & nameRules,
+    const AttributeParser::Rules & attributeRules,
+    const CommentParser::Rules & commentRules ) :
+    m_start(),
+    m_beginTag(),
+    m_spiritAttribute(),
+    m_attribute(),
+    m_emptyTagEnd(),
+    m_startTagEnd(),
+    m_badTagEnd(),
+    m_startTag(),
+    m_goodEndTag(),
+    m_badEndTag(),
+    m_endTag(),
+    m_comment(),
+    m_cdataText(),
+    m_goodCData(),
+    m_badCData(),
+    m_cdata(),
+    m_piText(),
+    m_processingInstruction(),
+    m_charData(),
+    m_badReference(),
+    m_badMarkup(),
+    m_content(),
+    m_rule()
+{
+    assert( this != NULL );
+
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+
+    PARSER_PROFILE_RULE( m_start ) = ( epsilon_p )
+        [ FClear() ];
+
+    PARSER_PROFILE_RULE( m_beginTag ) = ( ch_p( '<' ) >> eps_p( commonRules.m_firstNameChar ) )
+        [ FNodeEvent( &NodeParser::BeginElement ) ]
+        >> FastScanParser< NameScanner< NodeParser > >( nameRules.m_spiritName );
+
+    PARSER_PROFILE_RULE( m_spiritAttribute ) = ( attributeRules.m_spiritRule )
+        [ FNodeEvent( &NodeParser::CheckAttribute ) ];
+
+    PARSER_PROFILE_RULE( m_attribute ) = ( commonRules.m_whiteSpaces >> eps_p( commonRules.m_firstNameChar ) )
+        [ FNodeEvent( &NodeParser::PrepareAttribute ) ]
+        >> FastScanParser< AttributeScanner< NodeParser > >( m_spiritAttribute );
+
+    PARSER_PROFILE_RULE( m_emptyTagEnd ) = ( !commonRules.m_whiteSpaces >> str_p( "/>" ) )
+        [ FNodeEvent( &NodeParser::CloseEmptyElement ) ];
+
+    PARSER_PROFILE_RULE( m_startTagEnd ) = ( !commonRules.m_whiteSpaces >> ch_p( '>' ) )
+        [ FNodeEvent( &NodeParser::OpenElement ) ];
+
+    // Also matches at end of data, so a frame is never left without its tag.
+    PARSER_PROFILE_RULE( m_badTagEnd ) = ( *( anychar_p - ch_p( '>' ) ) >> ( ch_p( '>' ) | end_p ) )
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
+            "Start tag has invalid format." ) ]
+        [ FSetValidSyntax( false ) ]
+        [ FNodeEvent( &NodeParser::OpenElement ) ];
+
+    PARSER_PROFILE_RULE( m_startTag ) = ( m_beginTag >> *( m_attribute )
+        >> ( m_emptyTagEnd | m_startTagEnd | m_badTagEnd ) );
+
+    PARSER_PROFILE_RULE( m_goodEndTag ) = ( str_p( "</" )
+        >> ( commonRules.m_name )[ FNodeEvent( &NodeParser::SetEndName ) ]
+        >> !commonRules.m_whiteSpaces >> ch_p( '>' ) )
+        [ FNodeEvent( &NodeParser::CloseElement ) ];
+
+    PARSER_PROFILE_RULE( m_badEndTag ) = ( str_p( "</" ) >> *( anychar_p - ch_p( '>' ) ) >> ch_p( '>' ) )
+        [ FNodeEvent( &NodeParser::CloseBadElement ) ];
+
+    PARSER_PROFILE_RULE( m_endTag ) = ( m_goodEndTag | m_badEndTag );
+
+    PARSER_PROFILE_RULE( m_comment ) = eps_p( str_p( "<!--" ) )
+        [ FNodeEvent( &NodeParser::PrepareComment ) ]
+        >> ( commentRules.m_rule )
+            [ FNodeEvent( &NodeParser::CheckComment ) ];
+
+    PARSER_PROFILE_RULE( m_cdataText ) = ( *( anychar_p - str_p( "]]>" ) ) );
+
+    PARSER_PROFILE_RULE( m_goodCData ) = ( str_p( "<![CDATA[" )
+        >> ( FastScanParser< NodeParser::CDataScanner >( m_cdataText ) )
+            [ FNodeEvent( &NodeParser::AddCDataSection ) ]
+        >> str_p( "]]>" ) );
+
+    PARSER_PROFILE_RULE( m_badCData ) = ( str_p( "<![CDATA[" ) >> *( anychar_p ) )
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
+            "Found start of CDATA section, but not end of section." ) ]
+        [ FSetValidSyntax( false ) ];
+
+    PARSER_PROFILE_RULE( m_cdata ) = ( m_goodCData | m_badCData );
+
+    PARSER_PROFILE_RULE( m_piText ) = ( *( anychar_p - str_p( "?>" ) ) );
+
+    PARSER_PROFILE_RULE( m_processingInstruction ) = ( str_p( "<?" )
+        >> FastScanParser< NodeParser::PiScanner >( m_piText )
+        >> str_p( "?>" ) );
+
+    PARSER_PROFILE_RULE( m_charData ) = ( +( ( anychar_p - SpiritCharSet( "<&" ) )
+        | commonRules.m_charRef | commonRules.m_entityRef ) )
+        [ FNodeEvent( &NodeParser::AddCharData ) ];
+
+    PARSER_PROFILE_RULE( m_badReference ) = ch_p( '&' )
+        [ FSendMessageNow( Parser::ErrorLevel::Minor,
+            "Found '&' which does not start a valid reference." ) ]
+        [ FSetValidSyntax( false ) ];
+
+    PARSER_PROFILE_RULE( m_badMarkup ) = ch_p( '<' )
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
+            "Found '<' which does not start valid markup." ) ]
+        [ FSetValidSyntax( false ) ];
+
+    // Loops once per construct inside the element, and stops as soon as the
+    // end tag of the outermost element closes the last open frame.
+    PARSER_PROFILE_RULE( m_content ) = *( eps_p( FIsOpen() )
+        >> ( m_endTag | m_comment | m_cdata | m_processingInstruction
+           | m_startTag | m_charData | m_badReference | m_badMarkup ) );
+
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> m_startTag >> m_content )
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+NodeParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+NodeParser::NodeParser( const Rules & rules, NameParser & nameParser,
+    AttributeParser & attributeParser, CommentParser & commentParser ) :
+    m_rules( rules ),
+    m_nameParser( nameParser ),
+    m_attributeParser( attributeParser ),
+    m_commentParser( commentParser ),
+    m_stacks( nameParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_pEvents( NULL ),
+    m_validSyntax( false ),
+    m_byItems( false ),
+    m_endNameBegin( NULL ),
+    m_endNameEnd( NULL ),
+    m_charDataEnd( NULL ),
+    m_charDataAtEnd( false ),
+    m_foundCDataEnd( false ),
+    m_frames(),
+    m_names(),
+    m_attributeNames(),
+    m_elementNameReceiver( this ),
+    m_attributeReceiver( this ),
+    m_commentReceiver( this )
+{
+    assert( this != NULL );
+    m_frames.reserve( 64 );
+    m_names.reserve( 1024 );
+    m_attributeNames.reserve( 16 );
+}
+
+// ----------------------------------------------------------------------------
+
+NodeParser::~NodeParser( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+const Parser::CharType * NodeParser::CDataScanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    return CommonParserRules::GetIt().m_cdataRun.Find( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+const Parser::CharType * NodeParser::PiScanner::Scan(
+    const Parser::CharType * begin, const Parser::CharType * end )
+{
+    return CommonParserRules::GetIt().m_piRun.Find( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::TakeName( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    NodeParser & parser = NodeParser::Current();
+    // BeginElement gave the name parser a receiver in case the rule is used.
+    parser.m_nameParser.SetReceiver( NULL );
+    parser.SetElementName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::TakeAttribute( const Parser::CharType * nameBegin,
+    const Parser::CharType * nameEnd, const Parser::CharType * valueBegin,
+    const Parser::CharType * valueEnd )
+{
+    NodeParser & parser = NodeParser::Current();
+    // PrepareAttribute gave the attribute parser a receiver in case the rule
+    // is used.
+    parser.m_attributeParser.SetReceiver( NULL );
+    if ( parser.SetAttributeName( nameBegin, nameEnd ) )
+        parser.SetAttributeValue( true, valueBegin, valueEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::Clear( void )
+{
+    assert( this != NULL );
+    m_validSyntax = true;
+    m_byItems = false;
+    m_endNameBegin = NULL;
+    m_endNameEnd = NULL;
+    m_charDataEnd = NULL;
+    m_charDataAtEnd = false;
+    m_foundCDataEnd = false;
+    m_frames.clear();
+    m_names.clear();
+    m_attributeNames.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::BeginItems( ::Parser::Xml::INodeReceiver * receiver )
+{
+    assert( this != NULL );
+    Clear();
+    m_byItems = true;
+    SetReceiver( receiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::BeginItem( const Parser::CharType * begin )
+{
+    assert( this != NULL );
+    // The end of the last item may be released by now, so it is not compared.
+    m_charDataEnd = ( m_charDataAtEnd ) ? begin : NULL;
+    m_charDataAtEnd = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::EndItem( const Parser::CharType * end )
+{
+    assert( this != NULL );
+    m_charDataAtEnd = ( end == m_charDataEnd );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::FinishItems( void )
+{
+    assert( this != NULL );
+    Done( s_noContent, s_noContent );
+    m_byItems = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::SetValidSyntax( bool valid )
+{
+    assert( this != NULL );
+    m_validSyntax = valid;
+    if ( !valid && !m_frames.empty() )
+        m_frames.back().m_valid = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::SendMessage( ::Parser::ErrorLevel::Levels level,
+    const char * message )
+{
+    assert( this != NULL );
+    m_stacks.m_messages.Send( level, message );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::BeginElement( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)end;
+
+    ::Parser::Xml::INodeReceiver * receiver = NULL;
+    if ( NULL != m_pEvents )
+    {
+        // Whoever set the writer already started the outermost element.
+        if ( !m_frames.empty() )
+            m_pEvents->AddChild();
+    }
+    else if ( m_frames.empty() )
+    {
+        receiver = m_receiver;
+    }
+    else if ( NULL != m_frames.back().m_receiver )
+    {
+        try
+        {
+            receiver = m_frames.back().m_receiver->AddChild();
+        }
+        catch ( ... )
+        {
+            // throw exception back up to indicate Parser::ErrorLevel::Except
+        }
+    }
+
+    NodeFrame frame = { receiver, begin, m_names.size(), true };
+    m_frames.push_back( frame );
+    m_attributeNames.clear();
+    m_nameParser.SetReceiver( &m_elementNameReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::SetElementName( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    NodeFrame & frame = m_frames.back();
+    m_names.append( begin, end - begin );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->SetElementName( begin, end );
+        return;
+    }
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->SetElementName( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::PrepareAttribute( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    m_attributeParser.SetReceiver( &m_attributeReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CheckAttribute( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( !m_attributeParser.IsValid() )
+        SetValidSyntax( false );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::SetAttributeName( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    const size_t length = static_cast< size_t >( end - begin );
+    for ( AttributeNames::const_iterator it( m_attributeNames.begin() );
+        it != m_attributeNames.end(); ++it )
+    {
+        if ( ( length == static_cast< size_t >( it->m_end - it->m_begin ) )
+          && ( ::memcmp( begin, it->m_begin, length ) == 0 ) )
+        {
+            SendMessage( Parser::ErrorLevel::Major,
+                "Attribute name appears more than once in start tag." );
+            SetValidSyntax( false );
+            break;
+        }
+    }
+    const AttributeName name = { begin, end };
+    m_attributeNames.push_back( name );
+
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->SetAttributeName( begin, end );
+        return true;
+    }
+    NodeFrame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return true;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->SetAttributeName( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+    // The attribute parser must keep going so the value is still checked.
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::SetAttributeValue( bool valid, const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+    assert( begin < end );
+
+    if ( !valid )
+        SetValidSyntax( false );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->SetAttributeValue( begin + 1, end - 1 );
+        return;
+    }
+    NodeFrame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        // Range includes quote marks, so leave them out.
+        keep = frame.m_receiver->SetAttributeValue( begin + 1, end - 1 );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::OpenElement( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+    (void)begin;
+
+    NodeFrame & frame = m_frames.back();
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->SetTagName( frame.m_tagBegin, end );
+        return;
+    }
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->SetTagName( frame.m_tagBegin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CloseEmptyElement( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    OpenElement( begin, end );
+    CloseTopNode( m_frames.back().m_tagBegin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::SetEndName( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    m_endNameBegin = begin;
+    m_endNameEnd = end;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CloseElement( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+    assert( NULL != m_endNameBegin );
+
+    const NodeFrame & frame = m_frames.back();
+    const unsigned long startLength = m_names.size() - frame.m_nameOffset;
+    const unsigned long endLength =
+        static_cast< unsigned long >( m_endNameEnd - m_endNameBegin );
+    if ( ( startLength != endLength ) || ( ::memcmp( m_names.data()
+        + frame.m_nameOffset, m_endNameBegin, endLength ) != 0 ) )
+    {
+        SendMessage( Parser::ErrorLevel::Major,
+            "Name in end tag does not match name in start tag." );
+        SetValidSyntax( false );
+    }
+    m_endNameBegin = NULL;
+    m_endNameEnd = NULL;
+    CloseTopNode( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CloseBadElement( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    SendMessage( Parser::ErrorLevel::Major, "End tag has invalid format." );
+    SetValidSyntax( false );
+    m_endNameBegin = NULL;
+    m_endNameEnd = NULL;
+    CloseTopNode( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::PrepareComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    m_commentParser.SetReceiver( &m_commentReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CheckComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( !m_commentParser.IsValid() )
+        SetValidSyntax( false );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::AddComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddComment( begin, end );
+        return;
+    }
+    NodeFrame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->AddComment( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::AddCData( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddCData( begin, end );
+        return;
+    }
+    NodeFrame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->AddCData( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::AddCDataSection( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddCDataSection( begin, end );
+        return;
+    }
+    NodeFrame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = frame.m_receiver->AddCDataSection( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::AddCharData( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    if ( begin != m_charDataEnd )
+        m_foundCDataEnd = false;
+    m_charDataEnd = end;
+    // Only the end of a CDATA section may have "]]>".  A run of char data fed
+    // in pieces gets the message once, as when parsed in one pass.
+    if ( CommonParserRules::GetIt().m_cdataRun.Find( begin, end ) != end )
+    {
+        if ( !m_foundCDataEnd )
+            SendMessage( Parser::ErrorLevel::Major,
+                "Found \"]]>\" in character data, outside of CDATA section." );
+        m_foundCDataEnd = true;
+        SetValidSyntax( false );
+    }
+    AddCData( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::CloseTopNode( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( !m_frames.empty() );
+
+    const NodeFrame frame = m_frames.back();
+    m_frames.pop_back();
+    m_names.erase( frame.m_nameOffset );
+    if ( !frame.m_valid && !m_frames.empty() )
+        m_frames.back().m_valid = false;
+    // When parsing items, the start tag may already be released.
+    const Parser::CharType * nodeBegin = ( m_byItems ) ? begin : frame.m_tagBegin;
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->DoneNode( frame.m_valid, nodeBegin, end );
+        return;
+    }
+    if ( NULL == frame.m_receiver )
+        return;
+    try
+    {
+        frame.m_receiver->DoneNode( frame.m_valid, nodeBegin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::Done( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    while ( !m_frames.empty() )
+    {
+        SendMessage( Parser::ErrorLevel::Major,
+            "Found start tag of element, but not end tag." );
+        SetValidSyntax( false );
+        CloseTopNode( end, end );
+    }
+    SetReceiver( NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::ElementNameReceiver::SetName( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    m_pParser->SetElementName( begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::AttributeReceiver::SetName( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    m_gotValue = false;
+    return m_pParser->SetAttributeName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::AttributeReceiver::AddValue( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::AttributeReceiver::AddReference( const char * begin,
+    const char * end, RefType refType )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    (void)refType;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void NodeParser::AttributeReceiver::DoneAttributeValue( bool valid,
+    bool singleQuoted, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    (void)singleQuoted;
+    // The value parser calls this with the quoted value, and then the
+    // attribute parser calls it again with the whole attribute.  If the value
+    // parser skipped over a bad value, only the call with the whole attribute
+    // comes, and its range starts with the name instead of a quote mark.
+    if ( !m_gotValue && ( ( '\'' == *begin ) || ( '"' == *begin ) ) )
+    {
+        m_gotValue = true;
+        m_pParser->SetAttributeValue( valid, begin, end );
+    }
+    else if ( !valid )
+    {
+        m_pParser->SetValidSyntax( false );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+bool NodeParser::CommentReceiver::AddComment( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    m_pParser->AddComment( begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentParser::Rules::Rules( const NodeParser::Rules & nodeRules,
+    const CommentParser::Rules & commentRules,
+    const XmlDeclarationParser::Rules & xmlDeclarationRules ) :
+    m_start(),
+    m_xmlDeclaration(),
+    m_comment(),
+    m_processingInstruction(),
+    m_misc(),
+    m_quotedLiteral(),
+    m_internalSubset(),
+    m_docTypeDecl(),
+    m_prolog(),
+    m_root(),
+    m_noRoot(),
+    m_trailingData(),
+    m_rule(),
+    m_firstPrologItem(),
+    m_prologItem()
+{
+    assert( this != NULL );
+
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+
+    PARSER_PROFILE_RULE( m_start ) = ( epsilon_p )
+        [ FClear() ];
+
+    PARSER_PROFILE_RULE( m_xmlDeclaration ) = eps_p( str_p( "<?xml" ) >> commonRules.m_whiteSpace )
+        [ FDocumentEvent( &DocumentParser::PrepareXmlDeclaration ) ]
+        >> ( xmlDeclarationRules.m_rule )
+            [ FDocumentEvent( &DocumentParser::CheckXmlDeclaration ) ];
+
+    PARSER_PROFILE_RULE( m_comment ) = eps_p( str_p( "<!--" ) )
+        [ FDocumentEvent( &DocumentParser::PrepareComment ) ]
+        >> ( commentRules.m_rule )
+            [ FDocumentEvent( &DocumentParser::CheckComment ) ];
+
+    PARSER_PROFILE_RULE( m_processingInstruction ) = ( str_p( "<?" )
+        >> FastScanParser< NodeParser::PiScanner >( nodeRules.m_piText )
+        >> str_p( "?>" ) );
+
+    PARSER_PROFILE_RULE( m_misc ) = ( m_comment | m_processingInstruction | commonRules.m_whiteSpaces );
+
+    PARSER_PROFILE_RULE( m_quotedLiteral ) =
+        ( ( commonRules.m_singleQuote >> *( ~commonRules.m_singleQuote )
+            >> commonRules.m_singleQuote )
+        | ( commonRules.m_doubleQuote >> *( ~commonRules.m_doubleQuote )
+            >> commonRules.m_doubleQuote ) );
+
+    // Document type declarations are checked for balance but not processed.
+    PARSER_PROFILE_RULE( m_internalSubset ) = ( ch_p( '[' )
+        >> *( ( anychar_p - SpiritCharSet( "]\"'" ) ) | m_quotedLiteral )
+        >> ch_p( ']' ) );
+
+    PARSER_PROFILE_RULE( m_docTypeDecl ) = ( str_p( "<!DOCTYPE" )
+        >> *( ( anychar_p - SpiritCharSet( "[>\"'" ) ) | m_quotedLiteral )
+        >> !m_internalSubset >> !commonRules.m_whiteSpaces >> ch_p( '>' ) );
+
+    PARSER_PROFILE_RULE( m_prolog ) = ( !m_xmlDeclaration >> *( m_misc )
+        >> !( m_docTypeDecl >> *( m_misc ) ) );
+
+    PARSER_PROFILE_RULE( m_root ) = ( eps_p( ch_p( '<' ) >> commonRules.m_firstNameChar )
+        [ FDocumentEvent( &DocumentParser::AddRoot ) ]
+        >> nodeRules.m_rule )
+        [ FDocumentEvent( &DocumentParser::CheckRoot ) ];
+
+    PARSER_PROFILE_RULE( m_noRoot ) = ( epsilon_p )
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
+            "Could not find valid root element in document." ) ]
+        [ FSetValidSyntax( false ) ];
+
+    PARSER_PROFILE_RULE( m_trailingData ) = ( +anychar_p )
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
+            "Found content after end of root element." ) ]
+        [ FSetValidSyntax( false ) ];
+
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> m_prolog >> ( m_root | m_noRoot )
+        >> *( m_misc ) >> !m_trailingData )
+        [ FDone() ];
+
+    PARSER_PROFILE_RULE( m_firstPrologItem ) = ( m_xmlDeclaration | m_docTypeDecl | m_misc );
+
+    PARSER_PROFILE_RULE( m_prologItem ) = ( m_docTypeDecl | m_misc );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentParser::DocumentParser( const Rules & rules, NodeParser & nodeParser,
+    CommentParser & commentParser, XmlDeclarationParser & xmlDeclarationParser ) :
+    m_rules( rules ),
+    m_nodeParser( nodeParser ),
+    m_commentParser( commentParser ),
+    m_xmlDeclarationParser( xmlDeclarationParser ),
+    m_stacks( nodeParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_pEvents( NULL ),
+    m_validSyntax( false ),
+    m_place( InProlog ),
+    m_firstItem( false ),
+    m_foundDocType( false ),
+    m_foundTrailingData( false ),
+    m_xmlDeclarationReceiver( this ),
+    m_commentReceiver( this )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentParser::~DocumentParser( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::Clear( void )
+{
+    assert( this != NULL );
+    m_validSyntax = true;
+    m_nodeParser.SetReceiver( NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::PrepareXmlDeclaration( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    m_xmlDeclarationParser.SetReceiver( &m_xmlDeclarationReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::CheckXmlDeclaration( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( !m_xmlDeclarationParser.IsValid() )
+        SetValidSyntax( false );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::SetStandalone( bool standalone )
+{
+    assert( this != NULL );
+    // Events have nothing for the standalone declaration.
+    if ( NULL == m_receiver )
+        return true;
+    bool keep = false;
+    try
+    {
+        keep = m_receiver->SetStandalone( standalone );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        SetReceiver( NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::PrepareComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    m_commentParser.SetReceiver( &m_commentReceiver );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::CheckComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( !m_commentParser.IsValid() )
+        SetValidSyntax( false );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::AddComment( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddComment( begin, end );
+        return true;
+    }
+    if ( NULL == m_receiver )
+        return true;
+    bool keep = false;
+    try
+    {
+        keep = m_receiver->AddComment( begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    if ( !keep )
+        SetReceiver( NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+::Parser::Xml::INodeReceiver * DocumentParser::MakeRoot( void )
+{
+    assert( this != NULL );
+
+    ::Parser::Xml::INodeReceiver * root = NULL;
+    if ( NULL != m_receiver )
+    {
+        try
+        {
+            root = m_receiver->AddRoot();
+        }
+        catch ( ... )
+        {
+            // throw exception back up to indicate Parser::ErrorLevel::Except
+        }
+    }
+    return root;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::AddRoot( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->AddChild();
+        m_nodeParser.SetEventWriter( m_pEvents );
+        return;
+    }
+    m_nodeParser.SetReceiver( MakeRoot() );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::CheckRoot( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    if ( !m_nodeParser.IsValid() )
+        SetValidSyntax( false );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::SendMessage( ::Parser::ErrorLevel::Levels level,
+    const char * message )
+{
+    assert( this != NULL );
+    m_stacks.m_messages.Send( level, message );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::BeginItems( ::Parser::Xml::IDocumentReceiver * receiver )
+{
+    assert( this != NULL );
+    Clear();
+    SetReceiver( receiver );
+    m_place = InProlog;
+    m_firstItem = true;
+    m_foundDocType = false;
+    m_foundTrailingData = false;
+}
+
+// ----------------------------------------------------------------------------
+
+const Parser::CharType * DocumentParser::ParsePart( const Parser::CharType * begin,
+    const Parser::CharType * end, const SpiritRule & rule )
+{
+    assert( this != NULL );
+
+    const SpiritInfo info = ::boost::spirit::parse( begin, end, rule );
+    // Messages a failed production left on the stack are sent when the
+    // document ends, as when it is parsed in one pass.  Content on the stack
+    // points into the item, so it can not carry over to the next item.
+    while ( m_stacks.m_content.GetStackSize() > 0 )
+        m_stacks.m_content.Pop();
+    return ( info.hit ) ? info.stop : begin;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::CheckRootItem( void )
+{
+    assert( this != NULL );
+    if ( m_nodeParser.IsOpen() )
+        return;
+    m_nodeParser.FinishItems();
+    CheckRoot( NULL, NULL );
+    m_place = AfterRoot;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::SetNoRoot( void )
+{
+    assert( this != NULL );
+    SendMessage( Parser::ErrorLevel::Major,
+        "Could not find valid root element in document." );
+    SendMessage( Parser::ErrorLevel::Major,
+        "Found content after end of root element." );
+    SetValidSyntax( false );
+    m_place = AfterRoot;
+    m_foundTrailingData = true;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::SendLeftMessages( void )
+{
+    assert( this != NULL );
+    while ( m_stacks.m_messages.GetStackSize() > 0 )
+        m_stacks.m_messages.Pop();
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::ParseItem( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    assert( NULL != begin );
+    assert( begin < end );
+
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    const Parser::CharType * stop = end;
+    switch ( m_place )
+    {
+        case InProlog:
+        {
+            if ( ( '<' == *begin ) && ( begin + 1 < end )
+              && commonRules.m_firstNameChar.test( begin[ 1 ] ) )
+            {
+                m_nodeParser.BeginItems( MakeRoot() );
+                m_place = InRoot;
+                stop = ParsePart( begin, end, m_nodeParser.GetStartTagRule() );
+                CheckRootItem();
+            }
+            else
+            {
+                // As in the prolog rule, the declaration may only come first,
+                // and only misc items may follow a document type declaration.
+                const SpiritRule & rule = ( m_firstItem ) ? m_rules.m_firstPrologItem
+                    : ( m_foundDocType ? m_rules.m_misc : m_rules.m_prologItem );
+                const Parser::CharType * partEnd = ParsePart( begin, end, rule );
+                if ( partEnd != begin )
+                {
+                    stop = partEnd;
+                    if ( ( 9 <= end - begin ) && ( 0 == ::strncmp( begin, "<!DOCTYPE", 9 ) ) )
+                        m_foundDocType = true;
+                }
+                else
+                {
+                    SetNoRoot();
+                    // The document rule tries misc items once more where the
+                    // prolog stopped, so a bad item sends its messages again.
+                    ParsePart( begin, end, m_rules.m_misc );
+                }
+            }
+            break;
+        }
+        case InRoot:
+        {
+            m_nodeParser.BeginItem( begin );
+            stop = ParsePart( begin, end, m_nodeParser.GetContentRule() );
+            m_nodeParser.EndItem( stop );
+            CheckRootItem();
+            break;
+        }
+        case AfterRoot:
+        {
+            // The document rule skips everything after trailing data.
+            if ( m_foundTrailingData )
+                break;
+            if ( ParsePart( begin, end, m_rules.m_misc ) != end )
+            {
+                SendMessage( Parser::ErrorLevel::Major,
+                    "Found content after end of root element." );
+                SetValidSyntax( false );
+                m_foundTrailingData = true;
+            }
+            break;
+        }
+    }
+    m_firstItem = false;
+
+    if ( stop != end )
+    {
+        // A tag the rules end early, such as at a '>' within a bad attribute
+        // value, leaves the rest of the item to be parsed as what comes next.
+        if ( ( stop != begin ) || ( AfterRoot == m_place ) )
+        {
+            ParseItem( stop, end );
+        }
+        else
+        {
+            SendMessage( Parser::ErrorLevel::Major, "Unable to parse content." );
+            SetValidSyntax( false );
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::FinishItems( void )
+{
+    assert( this != NULL );
+
+    if ( InProlog == m_place )
+    {
+        SendMessage( Parser::ErrorLevel::Major,
+            "Could not find valid root element in document." );
+        SetValidSyntax( false );
+    }
+    else if ( InRoot == m_place )
+    {
+        m_nodeParser.FinishItems();
+        CheckRoot( NULL, NULL );
+    }
+    m_place = AfterRoot;
+    Done( s_noContent, s_noContent );
+    SendLeftMessages();
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::CancelItems( void )
+{
+    assert( this != NULL );
+    SendLeftMessages();
+    SetReceiver( NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::Done( const Parser::CharType * begin,
+    const Parser::CharType * end )
+{
+    assert( this != NULL );
+    if ( NULL != m_pEvents )
+    {
+        m_pEvents->DoneDocument( IsValid(), begin, end );
+        SetReceiver( NULL );
+        return;
+    }
+    if ( NULL == m_receiver )
+        return;
+    try
+    {
+        m_receiver->DoneDocument( IsValid(), begin, end );
+    }
+    catch ( ... )
+    {
+        // throw exception back up to indicate Parser::ErrorLevel::Except
+    }
+    SetReceiver( NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::XmlDeclarationReceiver::SetEncName( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    (void)begin;
+    (void)end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::XmlDeclarationReceiver::DoneEncodingDecl( bool valid,
+    bool singleQuoted, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    (void)valid;
+    (void)singleQuoted;
+    (void)begin;
+    (void)end;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::XmlDeclarationReceiver::SetVersionNumber(
+    bool singleQuoted, const char * begin, const char * end )
+{
+    assert( this != NULL );
+    (void)singleQuoted;
+    (void)begin;
+    (void)end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::XmlDeclarationReceiver::SetIsStandalone( bool standalone,
+    bool singleQuoted )
+{
+    assert( this != NULL );
+    (void)singleQuoted;
+    return m_pParser->SetStandalone( standalone );
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentParser::XmlDeclarationReceiver::DoneXmlDeclaration( bool valid,
+    const char * begin, const char * end )
+{
+    assert( this != NULL );
+    (void)valid;
+    (void)begin;
+    (void)end;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentParser::CommentReceiver::AddComment( const char * begin,
+    const char * end )
+{
+    assert( this != NULL );
+    return m_pParser->AddComment( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,627 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+#ifndef PARSER_XML_NODE_PARSERS_H_INCLUDED
+#define PARSER_XML_NODE_PARSERS_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+#include <string>
+#include <vector>
+
+#include "../../Util/include/ParseInfo.hpp"
+#include "../../Util/include/ParseUtil.hpp"
+
+#include "../include/Receivers.hpp"
+
+#include "./CommonInfo.hpp"
+#include "./BasicParsers.hpp"
+#include "./PrologParsers.hpp"
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+class XmlEventWriter;
+
+
+// ----------------------------------------------------------------------------
+
+/** @class NodeParser
+ Parses one element and all its content in a single linear pass.  The grammar
+ is flat: start tags, end tags, comments, CDATA sections and character data
+ are matched one at a time by a loop, and the nesting of elements is tracked
+ by a stack of frames instead of by recursive rules.  Each frame holds only
+ pointers into the parsed data and the position of its element name in a
+ shared name buffer, so memory use depends on the depth of the deepest
+ element, not on the size of the document.
+
+ Because all nesting state lives in the frames, the parser can also be given
+ an element one item at a time, where an item is a single tag, comment, CDATA
+ section, processing instruction, or run of character data.  Items need not
+ stay in memory after they are parsed.
+ */
+class NodeParser
+{
+public:
+
+    /// Returns the NodeParser of the parse running on this thread.
+    static NodeParser & Current( void );
+
+    /// Rules for elements.
+    class Rules
+    {
+    public:
+
+        Rules( const NameParser::Rules & nameRules,
+            const AttributeParser::Rules & attributeRules,
+            const CommentParser::Rules & commentRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_beginTag;
+        /// Parses attributes when fast scanning is off, or when the scanner
+        /// fails.
+        SpiritRule m_spiritAttribute;
+        SpiritRule m_attribute;
+        SpiritRule m_emptyTagEnd;
+        SpiritRule m_startTagEnd;
+        SpiritRule m_badTagEnd;
+        SpiritRule m_startTag;
+        SpiritRule m_goodEndTag;
+        SpiritRule m_badEndTag;
+        SpiritRule m_endTag;
+        SpiritRule m_comment;
+        /// Finds CDATA content when fast scanning is off.
+        SpiritRule m_cdataText;
+        SpiritRule m_goodCData;
+        SpiritRule m_badCData;
+        SpiritRule m_cdata;
+        /// Finds processing instruction content when fast scanning is off.
+        SpiritRule m_piText;
+        SpiritRule m_processingInstruction;
+        SpiritRule m_charData;
+        SpiritRule m_badReference;
+        SpiritRule m_badMarkup;
+        SpiritRule m_content;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    /// Finds CDATA content with a RunFinder.  See FastScanParser.
+    struct CDataScanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static inline void Take( const Parser::CharType *,
+            const Parser::CharType * ) {}
+    };
+
+    /// Finds processing instruction content with a RunFinder.
+    struct PiScanner
+    {
+        static const Parser::CharType * Scan( const Parser::CharType * begin,
+            const Parser::CharType * end );
+        static inline void Take( const Parser::CharType *,
+            const Parser::CharType * ) {}
+    };
+
+    /// Gives an element name found by NameScanner to the current NodeParser.
+    static void TakeName( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    /// Gives an attribute found by AttributeScanner to the current NodeParser.
+    static void TakeAttribute( const Parser::CharType * nameBegin,
+        const Parser::CharType * nameEnd, const Parser::CharType * valueBegin,
+        const Parser::CharType * valueEnd );
+
+    NodeParser( const Rules & rules,
+        NameParser & nameParser, AttributeParser & attributeParser,
+        CommentParser & commentParser );
+    ~NodeParser( void );
+
+    /// Sets receiver for the outermost element.  Nested elements get their
+    /// receivers by calling AddChild on the receiver of their parent.
+    inline void SetReceiver( ::Parser::Xml::INodeReceiver * receiver )
+    {
+        m_receiver = receiver;
+        m_pEvents = NULL;
+    }
+
+    /** Sets writer to which the rules add events for the outermost element
+     and all its content, instead of calling receivers.  The writer was already
+     told the outermost element started.
+     */
+    inline void SetEventWriter( ::Parser::Xml::XmlEventWriter * pEvents )
+    {
+        m_receiver = NULL;
+        m_pEvents = pEvents;
+    }
+
+    inline bool IsValid( void ) const { return m_validSyntax; }
+
+    /// Returns true while an element has been started but not ended.
+    inline bool IsOpen( void ) const { return !m_frames.empty(); }
+
+    inline const SpiritRule & GetRule( void ) const
+    {
+        return m_rules.m_rule;
+    }
+
+    inline ParserStacks & GetStacks( void )
+    {
+        return m_stacks;
+    }
+
+    /** Prepares to parse an element given as a series of items.  Since items
+     may be released after parsing, DoneNode gets the range of the end tag
+     instead of the range of the whole element.
+     @param receiver Receiver for the outermost element.
+     */
+    void BeginItems( ::Parser::Xml::INodeReceiver * receiver );
+
+    /// Rule for the first item, which must be the start tag of the element.
+    inline const SpiritRule & GetStartTagRule( void ) const
+    {
+        return m_rules.m_startTag;
+    }
+
+    /// Rule for any item after the first, while the element is still open.
+    inline const SpiritRule & GetContentRule( void ) const
+    {
+        return m_rules.m_content;
+    }
+
+    /** Marks the start of the next item.  Char data at begin continues a run
+     of char data which reached the end of the item before, so text given in
+     several items is checked as one run, as in one pass.
+     */
+    void BeginItem( const ::Parser::CharType * begin );
+
+    /// Marks where the content rule stopped within the item.
+    void EndItem( const ::Parser::CharType * end );
+
+    /// Closes any elements left open and finishes parsing items.
+    void FinishItems( void );
+
+private:
+
+    typedef ::Parser::FSetValidSyntax< NodeParser > FSetValidSyntax;
+    typedef ::Parser::FClear< NodeParser > FClear;
+    typedef ::Parser::FDone< NodeParser > FDone;
+
+    friend struct ::Parser::FSetValidSyntax< NodeParser >;
+    friend struct ::Parser::FClear< NodeParser >;
+    friend struct ::Parser::FDone< NodeParser >;
+
+    /// Calls one of the event handling functions below.
+    struct FNodeEvent
+    {
+        typedef void ( NodeParser::*Handler )( const ::Parser::CharType *,
+            const ::Parser::CharType * );
+        inline explicit FNodeEvent( Handler handler ) :
+            m_handler( handler ) {}
+        inline void operator () ( const ::Parser::CharType * begin,
+            const ::Parser::CharType * end ) const
+        {
+            ( NodeParser::Current().*m_handler )( begin, end );
+        }
+        Handler m_handler;
+    };
+
+    /// Condition which keeps the content loop going while an element is open.
+    struct FIsOpen
+    {
+        inline bool operator () ( void ) const
+        {
+            return NodeParser::Current().IsOpen();
+        }
+    };
+
+    /// Gives element names from the name parser to the current node receiver,
+    /// when the Spirit rule parses the name instead of NameScanner.
+    class ElementNameReceiver : public ::Parser::Xml::INameReceiver
+    {
+    public:
+        inline explicit ElementNameReceiver( NodeParser * pParser ) :
+            INameReceiver(), m_pParser( pParser ) {}
+        virtual bool SetName( const char * begin, const char * end );
+    private:
+        ElementNameReceiver( const ElementNameReceiver & );
+        ElementNameReceiver & operator = ( const ElementNameReceiver & );
+        NodeParser * m_pParser;
+    };
+
+    /// Gives attributes from the attribute parser to the current node receiver,
+    /// when the Spirit rule parses the attribute instead of AttributeScanner.
+    class AttributeReceiver : public ::Parser::Xml::IAttributeReceiver
+    {
+    public:
+        inline explicit AttributeReceiver( NodeParser * pParser ) :
+            IAttributeReceiver(), m_pParser( pParser ), m_gotValue( false ) {}
+        virtual bool SetName( const char * begin, const char * end );
+        virtual bool AddValue( const char * begin, const char * end );
+        virtual bool AddReference( const char * begin, const char * end,
+            RefType refType );
+        virtual void DoneAttributeValue( bool valid, bool singleQuoted,
+            const char * begin, const char * end );
+    private:
+        AttributeReceiver( const AttributeReceiver & );
+        AttributeReceiver & operator = ( const AttributeReceiver & );
+        NodeParser * m_pParser;
+        bool m_gotValue;
+    };
+
+    /// Gives comments from the comment parser to the current node receiver.
+    class CommentReceiver : public ::Parser::Xml::ICommentReceiver
+    {
+    public:
+        inline explicit CommentReceiver( NodeParser * pParser ) :
+            ICommentReceiver(), m_pParser( pParser ) {}
+        virtual bool AddComment( const char * begin, const char * end );
+    private:
+        CommentReceiver( const CommentReceiver & );
+        CommentReceiver & operator = ( const CommentReceiver & );
+        NodeParser * m_pParser;
+    };
+
+    /// Info about an element whose end tag was not reached yet.
+    struct NodeFrame
+    {
+        ::Parser::Xml::INodeReceiver * m_receiver;
+        const ::Parser::CharType * m_tagBegin;
+        /// Where the element name starts within m_names.
+        unsigned long m_nameOffset;
+        bool m_valid;
+    };
+
+    typedef ::std::vector< NodeFrame > NodeFrames;
+
+    /// Place of an attribute name within the start tag being parsed.
+    struct AttributeName
+    {
+        const ::Parser::CharType * m_begin;
+        const ::Parser::CharType * m_end;
+    };
+
+    typedef ::std::vector< AttributeName > AttributeNames;
+
+    NodeParser( const NodeParser & );
+    NodeParser & operator = ( const NodeParser & );
+
+    void Clear( void );
+
+    void SetValidSyntax( bool valid );
+
+    void Done( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void BeginElement( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void SetElementName( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void PrepareAttribute( const Parser::CharType * begin, const Parser::CharType * end );
+
+    /// Marks the element not valid if the attribute parser skipped a bad attribute.
+    void CheckAttribute( const Parser::CharType * begin, const Parser::CharType * end );
+
+    bool SetAttributeName( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void SetAttributeValue( bool valid, const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    void OpenElement( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CloseEmptyElement( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void SetEndName( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CloseElement( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CloseBadElement( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void PrepareComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    /// Marks the element not valid if the comment parser skipped a bad comment.
+    void CheckComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void AddComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void AddCData( const Parser::CharType * begin, const Parser::CharType * end );
+
+    /// Gives contents of a CDATA section, as opposed to char data.
+    void AddCDataSection( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void AddCharData( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CloseTopNode( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void SendMessage( ::Parser::ErrorLevel::Levels level, const char * message );
+
+    const Rules & m_rules;
+    NameParser & m_nameParser;
+    AttributeParser & m_attributeParser;
+    CommentParser & m_commentParser;
+    ParserStacks & m_stacks;
+    ::Parser::Xml::INodeReceiver * m_receiver;
+    /// Gets events instead of receivers when not NULL.
+    ::Parser::Xml::XmlEventWriter * m_pEvents;
+    bool m_validSyntax;
+    /// True if parsing one item at a time.
+    bool m_byItems;
+
+    const Parser::CharType * m_endNameBegin;
+    const Parser::CharType * m_endNameEnd;
+
+    /// End of the last char data, to tell if more char data continues its run.
+    const Parser::CharType * m_charDataEnd;
+    /// True if the last item ended with char data.
+    bool m_charDataAtEnd;
+    /// True if "]]>" was already found in the current run of char data.
+    bool m_foundCDataEnd;
+
+    NodeFrames m_frames;
+    /// Names of all open elements, back to back.  Copied so end tags can be
+    /// matched even after the start tag is released.
+    ::std::string m_names;
+    /// Names of attributes in the start tag being parsed, so a name given
+    /// twice is found.  The whole start tag is always in memory while parsed.
+    AttributeNames m_attributeNames;
+
+    ElementNameReceiver m_elementNameReceiver;
+    AttributeReceiver m_attributeReceiver;
+    CommentReceiver m_commentReceiver;
+
+}; // end class NodeParser
+
+// ----------------------------------------------------------------------------
+
+/** @class DocumentParser
+ Parses a whole document: an optional xml declaration, comments, processing
+ instructions and a document type declaration in the prolog, then the root
+ element, then any trailing comments or processing instructions.  The root
+ element is parsed by the NodeParser, so the same single pass and memory
+ bounds apply.  Like the NodeParser, it can also be given a document one item
+ at a time.
+ */
+class DocumentParser
+{
+public:
+
+    /// Returns the DocumentParser of the parse running on this thread.
+    static DocumentParser & Current( void );
+
+    /// Rules for whole documents.
+    class Rules
+    {
+    public:
+
+        Rules( const NodeParser::Rules & nodeRules,
+            const CommentParser::Rules & commentRules,
+            const XmlDeclarationParser::Rules & xmlDeclarationRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_xmlDeclaration;
+        SpiritRule m_comment;
+        SpiritRule m_processingInstruction;
+        SpiritRule m_misc;
+        SpiritRule m_quotedLiteral;
+        SpiritRule m_internalSubset;
+        SpiritRule m_docTypeDecl;
+        SpiritRule m_prolog;
+        SpiritRule m_root;
+        SpiritRule m_noRoot;
+        SpiritRule m_trailingData;
+        SpiritRule m_rule;
+        SpiritRule m_firstPrologItem;
+        SpiritRule m_prologItem;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    DocumentParser( const Rules & rules,
+        NodeParser & nodeParser, CommentParser & commentParser,
+        XmlDeclarationParser & xmlDeclarationParser );
+    ~DocumentParser( void );
+
+    inline void SetReceiver( ::Parser::Xml::IDocumentReceiver * receiver )
+    {
+        m_receiver = receiver;
+        m_pEvents = NULL;
+    }
+
+    /// Sets writer to which the rules add events instead of calling a receiver.
+    inline void SetEventWriter( ::Parser::Xml::XmlEventWriter * pEvents )
+    {
+        m_receiver = NULL;
+        m_pEvents = pEvents;
+    }
+
+    inline bool IsValid( void ) const { return m_validSyntax; }
+
+    inline const SpiritRule & GetRule( void ) const
+    {
+        return m_rules.m_rule;
+    }
+
+    inline ParserStacks & GetStacks( void )
+    {
+        return m_stacks;
+    }
+
+    /// Prepares to parse a document given as a series of items.
+    void BeginItems( ::Parser::Xml::IDocumentReceiver * receiver );
+
+    /** Parses one item of the document.
+     @param begin Start of a single tag, comment, CDATA section, processing
+      instruction, document type declaration, or run of character data.
+     @param end End of the item.  Nothing past the item is read.
+     */
+    void ParseItem( const Parser::CharType * begin, const Parser::CharType * end );
+
+    /// Reports anything left unfinished and ends the document.
+    void FinishItems( void );
+
+    /// Sends any messages left by items and drops the document unfinished.
+    void CancelItems( void );
+
+private:
+
+    typedef ::Parser::FSetValidSyntax< DocumentParser > FSetValidSyntax;
+    typedef ::Parser::FClear< DocumentParser > FClear;
+    typedef ::Parser::FDone< DocumentParser > FDone;
+
+    friend struct ::Parser::FSetValidSyntax< DocumentParser >;
+    friend struct ::Parser::FClear< DocumentParser >;
+    friend struct ::Parser::FDone< DocumentParser >;
+
+    /// Calls one of the event handling functions below.
+    struct FDocumentEvent
+    {
+        typedef void ( DocumentParser::*Handler )( const ::Parser::CharType *,
+            const ::Parser::CharType * );
+        inline explicit FDocumentEvent( Handler handler ) :
+            m_handler( handler ) {}
+        inline void operator () ( const ::Parser::CharType * begin,
+            const ::Parser::CharType * end ) const
+        {
+            ( DocumentParser::Current().*m_handler )( begin, end );
+        }
+        Handler m_handler;
+    };
+
+    /// Gives the standalone declaration to the document receiver.
+    class XmlDeclarationReceiver : public ::Parser::Xml::IXmlDeclarationReceiver
+    {
+    public:
+        inline explicit XmlDeclarationReceiver( DocumentParser * pParser ) :
+            IXmlDeclarationReceiver(), m_pParser( pParser ) {}
+        virtual bool SetEncName( const char * begin, const char * end );
+        virtual void DoneEncodingDecl( bool valid, bool singleQuoted,
+            const char * begin, const char * end );
+        virtual bool SetVersionNumber( bool singleQuoted, const char * begin,
+            const char * end );
+        virtual bool SetIsStandalone( bool standalone, bool singleQuoted );
+        virtual void DoneXmlDeclaration( bool valid, const char * begin,
+            const char * end );
+    private:
+        XmlDeclarationReceiver( const XmlDeclarationReceiver & );
+        XmlDeclarationReceiver & operator = ( const XmlDeclarationReceiver & );
+        DocumentParser * m_pParser;
+    };
+
+    /// Gives comments outside the root element to the document receiver.
+    class CommentReceiver : public ::Parser::Xml::ICommentReceiver
+    {
+    public:
+        inline explicit CommentReceiver( DocumentParser * pParser ) :
+            ICommentReceiver(), m_pParser( pParser ) {}
+        virtual bool AddComment( const char * begin, const char * end );
+    private:
+        CommentReceiver( const CommentReceiver & );
+        CommentReceiver & operator = ( const CommentReceiver & );
+        DocumentParser * m_pParser;
+    };
+
+    /// Which part of the document the next item belongs to.
+    enum Place
+    {
+        InProlog,
+        InRoot,
+        AfterRoot
+    };
+
+    DocumentParser( const DocumentParser & );
+    DocumentParser & operator = ( const DocumentParser & );
+
+    void Clear( void );
+
+    inline void SetValidSyntax( bool valid )
+    {
+        m_validSyntax = valid;
+    }
+
+    void Done( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void PrepareXmlDeclaration( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    void CheckXmlDeclaration( const Parser::CharType * begin,
+        const Parser::CharType * end );
+
+    bool SetStandalone( bool standalone );
+
+    void PrepareComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CheckComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    bool AddComment( const Parser::CharType * begin, const Parser::CharType * end );
+
+    ::Parser::Xml::INodeReceiver * MakeRoot( void );
+
+    void AddRoot( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CheckRoot( const Parser::CharType * begin, const Parser::CharType * end );
+
+    void CheckRootItem( void );
+
+    /// Reports content which can not start the root, as the document rule does.
+    void SetNoRoot( void );
+
+    /// Sends any messages left on the stack by productions which failed.
+    void SendLeftMessages( void );
+
+    const Parser::CharType * ParsePart( const Parser::CharType * begin,
+        const Parser::CharType * end, const SpiritRule & rule );
+
+    void SendMessage( ::Parser::ErrorLevel::Levels level, const char * message );
+
+    const Rules & m_rules;
+    NodeParser & m_nodeParser;
+    CommentParser & m_commentParser;
+    XmlDeclarationParser & m_xmlDeclarationParser;
+    ParserStacks & m_stacks;
+    ::Parser::Xml::IDocumentReceiver * m_receiver;
+    /// Gets events instead of the receiver when not NULL.
+    ::Parser::Xml::XmlEventWriter * m_pEvents;
+    bool m_validSyntax;
+
+    Place m_place;
+    bool m_firstItem;
+    bool m_foundDocType;
+    bool m_foundTrailingData;
+
+    XmlDeclarationReceiver m_xmlDeclarationReceiver;
+    CommentReceiver m_commentReceiver;
+
+}; // end class DocumentParser
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -36,14 +36,7 @@ namespace Xml
 
 // ----------------------------------------------------------------------------
 
-PublicIdLiteralParser::PublicIdLiteralParser( ParserStacks & stacks ) :
-    m_stacks( stacks ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_singleQuoted( false ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+PublicIdLiteralParser::Rules::Rules( void ) :
     m_skipOver(),
     m_startSQ(),
     m_sQuotedChars(),
@@ -62,61 +55,83 @@ PublicIdLiteralParser::PublicIdLiteralParser( ParserStacks & stacks ) :
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = stacks.m_messages;
 
     //m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-    //    [ FSetValidSyntax( this, false ) ]
-    //    [ Parser::FPopMessageStack( messages ) ]
-    //    [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    //    [ FSetValidSyntax( false ) ]
+    //    [ FPopMessageStack() ]
+    //    [ FSendMessageNow( Parser::ErrorLevel::Major,
     //        "Unable to parse public identifier literal - skipping rest of content." ) ];
 
-    m_startSQ = ( commonRules.m_singleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startSQ ) = ( commonRules.m_singleQuote )
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting single quote but no content for public identifier literal." ) ];
 
-    m_sQuotedChars = ( *( commonRules.m_pubidChar - commonRules.m_singleQuote ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_sQuotedChars ) = ( *( commonRules.m_pubidChar - commonRules.m_singleQuote ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending single-quote for public identifier literal." ) ]
-        [ FSetContent( this ) ];
+        [ FSetContent() ];
 
-    m_endSQ = ( commonRules.m_singleQuote )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ]
-        [ FEnd( this ) ];
+    PARSER_PROFILE_RULE( m_endSQ ) = ( commonRules.m_singleQuote )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ]
+        [ FEnd() ];
 
-    m_skipSQ = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipSQ ) = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse single-quoted public identifier literal - skipping rest of content." ) ];
 
-    m_singleQuotedValue = ( m_startSQ >> ( ( m_sQuotedChars >> m_endSQ ) | m_skipSQ ) );
+    PARSER_PROFILE_RULE( m_singleQuotedValue ) = ( m_startSQ >> ( ( m_sQuotedChars >> m_endSQ ) | m_skipSQ ) );
 
-    m_startDQ = ( commonRules.m_doubleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startDQ ) = ( commonRules.m_doubleQuote )
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting double quote but no content for public identifier literal." ) ];
 
-    m_dQuotedChars = ( *( commonRules.m_pubidChar - commonRules.m_doubleQuote ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_dQuotedChars ) = ( *( commonRules.m_pubidChar - commonRules.m_doubleQuote ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending double-quote for public identifier literal." ) ]
-        [ FSetContent( this ) ];
+        [ FSetContent() ];
 
-    m_endDQ = ( commonRules.m_doubleQuote )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ]
-        [ FEnd( this ) ];
+    PARSER_PROFILE_RULE( m_endDQ ) = ( commonRules.m_doubleQuote )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ]
+        [ FEnd() ];
 
-    m_skipDQ = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipDQ ) = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse double-quoted system literal - skipping rest of content." ) ];
 
-    m_doubleQuotedValue = ( m_startDQ >> ( ( m_dQuotedChars >> m_endDQ ) | m_skipDQ ) );
+    PARSER_PROFILE_RULE( m_doubleQuotedValue ) = ( m_startDQ >> ( ( m_dQuotedChars >> m_endDQ ) | m_skipDQ ) );
+
+    PARSER_PROFILE_RULE( m_rule ) = ( m_singleQuotedValue | m_doubleQuotedValue );
+}
+
+// ----------------------------------------------------------------------------
+
+PublicIdLiteralParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
 
-    m_rule = ( m_singleQuotedValue | m_doubleQuotedValue );
+PublicIdLiteralParser::PublicIdLiteralParser( const Rules & rules,
+    ParserStacks & stacks ) :
+    m_rules( rules ),
+    m_stacks( stacks ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_singleQuoted( false ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -171,15 +186,8 @@ void PublicIdLiteralParser::End( void )
 
 // ----------------------------------------------------------------------------
 
-ExternalIdLiteralParser::ExternalIdLiteralParser(
-    PublicIdLiteralParser & pubIdParser ) :
-    m_stacks( pubIdParser.GetStacks() ),
-    m_pubIdParser( pubIdParser ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+ExternalIdLiteralParser::Rules::Rules(
+    const PublicIdLiteralParser::Rules & pubIdRules ) :
     m_startSQ(),
     m_sQuotedChars(),
     m_endSQ(),
@@ -201,84 +209,105 @@ ExternalIdLiteralParser::ExternalIdLiteralParser(
 {
     assert( this != NULL );
 
-    Parser::MessageStack & messages = m_stacks.m_messages;
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
 
-    m_startSQ = ( commonRules.m_singleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startSQ ) = ( commonRules.m_singleQuote )
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting single quote but no content for system literal." ) ];
 
-    m_sQuotedChars = ( *( anychar_p - commonRules.m_singleQuote ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_sQuotedChars ) = ( *( anychar_p - commonRules.m_singleQuote ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending single-quote for system literal." ) ];
 
-    m_endSQ = ( commonRules.m_singleQuote )
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endSQ ) = ( commonRules.m_singleQuote )
+        [ FCancelMessage() ];
 
-    m_skipSQ = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipSQ ) = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse single-quoted system literal - skipping rest of content." ) ];
 
-    m_singleQuotedValue = ( m_startSQ >> ( ( m_sQuotedChars >> m_endSQ ) | m_skipSQ ) );
+    PARSER_PROFILE_RULE( m_singleQuotedValue ) = ( m_startSQ >> ( ( m_sQuotedChars >> m_endSQ ) | m_skipSQ ) );
 
-    m_startDQ = ( commonRules.m_doubleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startDQ ) = ( commonRules.m_doubleQuote )
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting double quote but no content for system literal." ) ];
 
-    m_dQuotedChars = ( *( anychar_p - commonRules.m_doubleQuote ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_dQuotedChars ) = ( *( anychar_p - commonRules.m_doubleQuote ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending double-quote for system literal." ) ];
 
-    m_endDQ = ( commonRules.m_doubleQuote )
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endDQ ) = ( commonRules.m_doubleQuote )
+        [ FCancelMessage() ];
 
-    m_skipDQ = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipDQ ) = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse double-quoted system literal - skipping rest of content." ) ];
 
-    m_doubleQuotedValue = ( m_startDQ >> ( ( m_dQuotedChars >> m_endDQ ) | m_skipDQ ) );
+    PARSER_PROFILE_RULE( m_doubleQuotedValue ) = ( m_startDQ >> ( ( m_dQuotedChars >> m_endDQ ) | m_skipDQ ) );
 
-    m_system = str_p( "SYSTEM" )
-        [ FSetup( this, false ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_system ) = str_p( "SYSTEM" )
+        [ FSetup( false ) ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
             "Found start of system literal, but no contents." ) ];
 
-    m_sysLiteral = ( m_singleQuotedValue | m_doubleQuotedValue )
-        [ FSetSysLiteral( this ) ]
-        [ FSetValidSyntax( this, true ) ]
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_sysLiteral ) = ( m_singleQuotedValue | m_doubleQuotedValue )
+        [ FSetSysLiteral() ]
+        [ FSetValidSyntax( true ) ]
+        [ FCancelMessage() ];
 
-    m_public = str_p( "PUBLIC" )
-        [ FSetup( this, true ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_public ) = str_p( "PUBLIC" )
+        [ FSetup( true ) ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
             "Found start of public literal, but no contents." ) ];
 
-    m_pubLiteral = pubIdParser.GetRule()
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_pubLiteral ) = pubIdRules.m_rule
+        [ FPrepareMessage( Parser::ErrorLevel::Minor,
             "Expected to find white space between public ID and system literals." ) ]
-        [ FSetPubIdLiteral( this ) ];
+        [ FSetPubIdLiteral() ];
 
-    m_whitespace = ( commonRules.m_whiteSpaces )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_whitespace ) = ( commonRules.m_whiteSpaces )
+        [ FPrepareMessage( Parser::ErrorLevel::Minor,
             "Expected to find quoted public-id or system literal." ) ];
 
-    m_pubRules = ( m_public >> m_whitespace >> m_pubLiteral );
+    PARSER_PROFILE_RULE( m_pubRules ) = ( m_public >> m_whitespace >> m_pubLiteral );
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ ::Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
-            "Unable to parse external ID reference." ) ]
-        [ ::Parser::FPopMessageStack( messages ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser() )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Major,
+            "Unable to parse external ID reference." ) ];
 
-    m_rule = ( ( m_pubRules | m_system ) >>
+    PARSER_PROFILE_RULE( m_rule ) = ( ( m_pubRules | m_system ) >>
         ( ( m_whitespace >> m_sysLiteral ) | m_skipOver ) )
-        [ FDone( this ) ];
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+ExternalIdLiteralParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+ExternalIdLiteralParser::ExternalIdLiteralParser( const Rules & rules,
+    PublicIdLiteralParser & pubIdParser ) :
+    m_rules( rules ),
+    m_stacks( pubIdParser.GetStacks() ),
+    m_pubIdParser( pubIdParser ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -366,13 +395,7 @@ void ExternalIdLiteralParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-PeReferenceParser::PeReferenceParser( NameParser & nameParser ) :
-    m_stacks( nameParser.GetStacks() ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+PeReferenceParser::Rules::Rules( const NameParser::Rules & nameRules ) :
     m_start(),
     m_name(),
     m_end(),
@@ -381,34 +404,55 @@ PeReferenceParser::PeReferenceParser( NameParser & nameParser ) :
 {
     assert( this != NULL );
 
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_start = ch_p( '%' )
-//        [ FBreakPoint( this, "" ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
-            "Found start of PE reference, but no name." ) ]
-        [ FClear( this ) ];
+    PARSER_PROFILE_RULE( m_start ) = ch_p( '%' )
+//        [ FBreakPoint( "" ) ]
+        [ FClear() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
+            "Found start of PE reference, but no name." ) ];
 
-    m_name = ( nameParser.GetRule() )
-//        [ FBreakPoint( this, "" ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_name ) = ( nameRules.m_name )
+//        [ FBreakPoint( "" ) ]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor,
             "Found name for PE reference, but no ending semicolon." ) ]
-        [ FSetName( this ) ];
+        [ FSetName() ];
 
-    m_end = ch_p( ';' )
-//        [ FBreakPoint( this, "" ) ]
-        [ FSetValidSyntax( this, true ) ]
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_end ) = ch_p( ';' )
+//        [ FBreakPoint( "" ) ]
+        [ FCancelMessage() ]
+        [ FEnd() ];
+
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+//        [ FBreakPoint( "" ) ]
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
+            "Unable to parse name for PE reference." ) ];
+
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> ( ( m_name >> m_end ) | m_skipOver ) );
+//        [ FBreakPoint( "m_rule" ) ];
+}
+
+// ----------------------------------------------------------------------------
+
+PeReferenceParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-//        [ FBreakPoint( this, "" ) ]
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
-            "Unable to parse name for PE reference." ) ]
-        [ Parser::FPopMessageStack( messages ) ];
+// ----------------------------------------------------------------------------
 
-    m_rule = ( m_start >> ( ( m_name >> m_end ) | m_skipOver ) );
-//        [ FBreakPoint( this, "m_rule" ) ];
+PeReferenceParser::PeReferenceParser( const Rules & rules,
+    NameParser & nameParser ) :
+    m_rules( rules ),
+    m_nameParser( nameParser ),
+    m_stacks( nameParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -435,7 +479,8 @@ void PeReferenceParser::End( void )
 {
     assert( this != NULL );
     assert( m_stackSize == m_stacks.m_messages.GetStackSize() );
-    m_validSyntax = true;
+    // The name rule skips over a bad name, so the name may not be valid.
+    m_validSyntax = m_nameParser.IsValid();
     if ( m_receiver == NULL )
         return;
     try
@@ -451,13 +496,7 @@ void PeReferenceParser::End( void )
 
 // ----------------------------------------------------------------------------
 
-EnumeratedTypeParser::EnumeratedTypeParser( NameParser & nameParser ) :
-    m_stacks( nameParser.GetStacks() ),
-    m_nameParser( nameParser ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_isNotation( false ),
+EnumeratedTypeParser::Rules::Rules( const NameParser::Rules & nameRules ) :
     m_noteStart(),
     m_noteBeginP(),
     m_name(),
@@ -473,55 +512,76 @@ EnumeratedTypeParser::EnumeratedTypeParser( NameParser & nameParser ) :
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_noteStart = str_p( "NOTATION" )
-        [ FSetEnumType( this, true ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_noteStart ) = str_p( "NOTATION" )
+        [ FSetEnumType( true ) ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Did not find starting paranthese for notation." ) ];
 
-    m_noteBeginP = ( !commonRules.m_whiteSpaces >> '(' >> !commonRules.m_whiteSpaces )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_noteBeginP ) = ( !commonRules.m_whiteSpaces >> '(' >> !commonRules.m_whiteSpaces )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find content for notation." ) ];
 
-    m_name = nameParser.GetRule()
-        [ FSetName( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_name ) = nameRules.m_name
+        [ FSetName() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find '|' delimiter or ending paranthese ')' after name in notation." ) ];
 
-    m_nameDelimiter = ( !commonRules.m_whiteSpaces >> '|' >> !commonRules.m_whiteSpaces )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_nameDelimiter ) = ( !commonRules.m_whiteSpaces >> '|' >> !commonRules.m_whiteSpaces )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find name after '|' delimiter." ) ];
 
-    m_endP = ( !commonRules.m_whiteSpaces >> ')' )
-        [ FSetValidSyntax( this, true ) ]
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endP ) = ( !commonRules.m_whiteSpaces >> ')' )
+        [ FSetValidSyntax( true ) ]
+        [ FCancelMessage() ];
 
-    m_notation = ( m_noteStart >> m_noteBeginP >> m_name >>
+    PARSER_PROFILE_RULE( m_notation ) = ( m_noteStart >> m_noteBeginP >> m_name >>
         *( m_nameDelimiter >> m_name ) >> m_endP );
 
-    m_enumStart = ( ch_p( '(' ) >> !commonRules.m_whiteSpaces )
-        [ FSetEnumType( this, false ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_enumStart ) = ( ch_p( '(' ) >> !commonRules.m_whiteSpaces )
+        [ FSetEnumType( false ) ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Did not find content for enumeration." ) ];
 
-    m_nameToken = commonRules.m_nameToken
-        [ FSetName( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_nameToken ) = commonRules.m_nameToken
+        [ FSetName() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
              "Did not find '|' delimiter or ending paranthese ')' after name in enumeration." ) ];
 
-    m_enumeration = ( m_enumStart >> m_nameToken >>
+    PARSER_PROFILE_RULE( m_enumeration ) = ( m_enumStart >> m_nameToken >>
         *( m_nameDelimiter >> m_nameToken ) >> m_endP );
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-//        [ FBreakPoint( this, "m_skipOver" ) ]
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+//        [ FBreakPoint( "m_skipOver" ) ]
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Major,
             "Unable to parse enumerated type - skipping rest of content." ) ];
 
-    m_rule = ( m_notation | m_enumeration | m_skipOver )
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_rule ) = ( epsilon_p[ FStoreStackSize() ]
+        >> ( m_notation | m_enumeration | m_skipOver ) )
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+EnumeratedTypeParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+EnumeratedTypeParser::EnumeratedTypeParser( const Rules & rules,
+    NameParser & nameParser ) :
+    m_rules( rules ),
+    m_stacks( nameParser.GetStacks() ),
+    m_nameParser( nameParser ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_isNotation( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -593,16 +653,8 @@ void EnumeratedTypeParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-EntityValueParser::EntityValueParser( ReferenceParser & refParser,
-    PeReferenceParser & peReferenceParser ) :
-    m_peRefParser( peReferenceParser ),
-    m_refParser( refParser ),
-    m_stacks( refParser.GetStacks() ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_validContent( false ),
-    m_singleQuoted( false ),
+EntityValueParser::Rules::Rules( const ReferenceParser::Rules & refRules,
+    const PeReferenceParser::Rules & peRefRules ) :
     m_skipOver(),
     m_sqStart(),
     m_dqStart(),
@@ -621,71 +673,95 @@ EntityValueParser::EntityValueParser( ReferenceParser & refParser,
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-//        [ FBreakPoint( this, "m_skipOver" )]
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser() )
+//        [ FBreakPoint( "m_skipOver" )]
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Major,
             "Unable to parse entity value - skipping rest of content." ) ];
 
-    m_sqStart = ( commonRules.m_singleQuote )
-//        [ FBreakPoint( this, "m_sqStart" )]
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_sqStart ) = ( commonRules.m_singleQuote )
+//        [ FBreakPoint( "m_sqStart" )]
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Entity value has starting single-quote but no content." ) ];
 
-    m_dqStart = ( commonRules.m_doubleQuote )
-//        [ FBreakPoint( this, "m_dqStart" )]
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_dqStart ) = ( commonRules.m_doubleQuote )
+//        [ FBreakPoint( "m_dqStart" )]
+        [ FSetQuoteType() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
             "Entity value has starting double-quote but no content." ) ];
 
-    m_reference = refParser.GetRule()
-//        [ FBreakPoint( this, "m_reference" )]
-        [ FSetReference( this ) ];
+    PARSER_PROFILE_RULE( m_reference ) = refRules.m_rule
+//        [ FBreakPoint( "m_reference" )]
+        [ FSetReference() ];
 
-    m_peReference = peReferenceParser.GetRule()
-//        [ FBreakPoint( this, "m_peReference" )]
-        [ FSetPeReference( this ) ];
+    PARSER_PROFILE_RULE( m_peReference ) = peRefRules.m_rule
+//        [ FBreakPoint( "m_peReference" )]
+        [ FSetPeReference() ];
 
-    m_sqValue = ( +( anychar_p - ( SpiritCharSet( "%&'" ) ) ) )
-//        [ FBreakPoint( this, "m_sqValue" )]
-        [ FSetValue( this ) ];
+    PARSER_PROFILE_RULE( m_sqValue ) = ( +( anychar_p - ( SpiritCharSet( "%&'" ) ) ) )
+//        [ FBreakPoint( "m_sqValue" )]
+        [ FSetValue() ];
 
-    m_dqValue = ( +( anychar_p - ( SpiritCharSet( "%&\"" ) ) ) )
-//        [ FBreakPoint( this, "m_dqValue" )]
-        [ FSetValue( this ) ];
+    PARSER_PROFILE_RULE( m_dqValue ) = ( +( anychar_p - ( SpiritCharSet( "%&\"" ) ) ) )
+//        [ FBreakPoint( "m_dqValue" )]
+        [ FSetValue() ];
 
-    m_sqContent = ( *( m_reference | m_peReference | m_sqValue ) )
-//        [ FBreakPoint( this, "m_sqContent" )]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_sqContent ) = ( *( m_reference | m_peReference | m_sqValue ) )
+//        [ FBreakPoint( "m_sqContent" )]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor,
             "Entity value has no ending single-quote." ) ];
 
-    m_dqContent = ( *( m_reference | m_peReference | m_dqValue ) )
-//        [ FBreakPoint( this, "m_dqContent" )]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_dqContent ) = ( *( m_reference | m_peReference | m_dqValue ) )
+//        [ FBreakPoint( "m_dqContent" )]
+        [ FPrepareMessage( Parser::ErrorLevel::Minor,
             "Entity value has no ending double-quote." ) ];
 
-    m_sqEnd = ( commonRules.m_singleQuote );
-//        [ FBreakPoint( this, "m_sqEnd" )];
+    PARSER_PROFILE_RULE( m_sqEnd ) = ( commonRules.m_singleQuote );
+//        [ FBreakPoint( "m_sqEnd" )];
+
+    PARSER_PROFILE_RULE( m_dqEnd ) = ( commonRules.m_doubleQuote );
+//        [ FBreakPoint( "m_dqEnd" )];
 
-    m_dqEnd = ( commonRules.m_doubleQuote );
-//        [ FBreakPoint( this, "m_dqEnd" )];
+    PARSER_PROFILE_RULE( m_sqEntity ) = ( m_sqStart >> m_sqContent >> m_sqEnd )
+//        [ FBreakPoint( "m_sqEntity" )]
+        [ FCancelMessage() ]
+        [ FDone() ];
 
-    m_sqEntity = ( m_sqStart >> m_sqContent >> m_sqEnd )
-//        [ FBreakPoint( this, "m_sqEntity" )]
-        [ Parser::FCancelMessage( messages ) ]
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_dqEntity ) = ( m_dqStart >> m_dqContent >> m_dqEnd )
+//        [ FBreakPoint( "m_dqEntity" )]
+        [ FCancelMessage() ]
+        [ FDone() ];
 
-    m_dqEntity = ( m_dqStart >> m_dqContent >> m_dqEnd )
-//        [ FBreakPoint( this, "m_dqEntity" )]
-        [ Parser::FCancelMessage( messages ) ]
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_rule ) = ( epsilon_p[ FStoreStackSize() ]
+        >> ( m_sqEntity | m_dqEntity | m_skipOver ) );
+//        [ FBreakPoint( "m_rule" )];
+}
 
-    m_rule = ( m_sqEntity | m_dqEntity | m_skipOver );
-//        [ FBreakPoint( this, "m_rule" )];
+// ----------------------------------------------------------------------------
+
+EntityValueParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+EntityValueParser::EntityValueParser( const Rules & rules,
+    ReferenceParser & refParser,
+    PeReferenceParser & peReferenceParser ) :
+    m_rules( rules ),
+    m_peRefParser( peReferenceParser ),
+    m_refParser( refParser ),
+    m_stacks( refParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_validContent( false ),
+    m_singleQuoted( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -808,13 +884,7 @@ void EntityValueParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-EncodingDeclParser::EncodingDeclParser( ParserStacks & stacks ) :
-    m_stacks( stacks ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+EncodingDeclParser::Rules::Rules( void ) :
     m_start(),
     m_equals(),
     m_encName(),
@@ -833,67 +903,87 @@ EncodingDeclParser::EncodingDeclParser( ParserStacks & stacks ) :
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = stacks.m_messages;
 
-    m_start = str_p( "encoding" )
-        [ FClear( this ) ]
-        [ FStoreStackSize( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_start ) = str_p( "encoding" )
+        [ FClear() ]
+        [ FStoreStackSize() ]
+        [ FPushMessage( Parser::ErrorLevel::Minor,
             "Did not find equal sign for encoding." ) ];
 
-    m_equals = commonRules.m_equals
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_equals ) = commonRules.m_equals
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find name for encoding." ) ];
 
-    m_encName = commonRules.m_encName
-        [ FSetName( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_encName ) = commonRules.m_encName
+        [ FSetName() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending quote for encoding." ) ];
 
-    m_startSQ = ( commonRules.m_singleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startSQ ) = ( commonRules.m_singleQuote )
+        [ FSetQuoteType() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Found starting single quote but no content for encoding." ) ];
 
-    m_endSQ = ( commonRules.m_singleQuote )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ];
+    PARSER_PROFILE_RULE( m_endSQ ) = ( commonRules.m_singleQuote )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ];
 
-    m_skipSQ = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipSQ ) = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse single-quoted encoding - skipping rest of content." ) ];
 
-    m_sQuotedContent = ( m_startSQ >> ( ( m_encName >> m_endSQ ) | m_skipSQ ) );
+    PARSER_PROFILE_RULE( m_sQuotedContent ) = ( m_startSQ >> ( ( m_encName >> m_endSQ ) | m_skipSQ ) );
 
-    m_startDQ = ( commonRules.m_doubleQuote )
-        [ FSetQuoteType( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startDQ ) = ( commonRules.m_doubleQuote )
+        [ FSetQuoteType() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Found starting double quote but no content for encoding." ) ];
 
-    m_endDQ = ( commonRules.m_doubleQuote )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ];
+    PARSER_PROFILE_RULE( m_endDQ ) = ( commonRules.m_doubleQuote )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ];
 
-    m_skipDQ = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipDQ ) = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse double-quoted encoding - skipping rest of content." ) ];
 
-    m_dQuotedContent = ( m_startDQ >> ( ( m_encName >> m_endDQ ) | m_skipDQ ) );
+    PARSER_PROFILE_RULE( m_dQuotedContent ) = ( m_startDQ >> ( ( m_encName >> m_endDQ ) | m_skipDQ ) );
 
-    m_content = ( m_equals >> ( m_dQuotedContent | m_sQuotedContent ) );
+    PARSER_PROFILE_RULE( m_content ) = ( m_equals >> ( m_dQuotedContent | m_sQuotedContent ) );
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
-            "Encoding has invalid format." ) ]
-        [ Parser::FPopMessageStack( messages ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser( CommonParserRules::SkipStopClass ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
+            "Encoding has invalid format." ) ];
 
-    m_rule = ( m_start >> ( m_content | m_skipOver ) )
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> ( m_content | m_skipOver ) )
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+EncodingDeclParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+EncodingDeclParser::EncodingDeclParser( const Rules & rules,
+    ParserStacks & stacks ) :
+    m_rules( rules ),
+    m_stacks( stacks ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -960,17 +1050,8 @@ void EncodingDeclParser::Done( const Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-XmlDeclarationParser::XmlDeclarationParser( EncodingDeclParser & encodingDeclParser ) :
-    m_encodingDeclParser( encodingDeclParser ),
-    m_stacks( encodingDeclParser.GetStacks() ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_validContent( false ),
-    m_singleQuoted( false ),
-    m_versionValue( '\0' ),
-    m_pBegin( NULL ),
-    m_pEnd( NULL ),
+XmlDeclarationParser::Rules::Rules(
+    const EncodingDeclParser::Rules & encodingDeclRules ) :
     m_start(),
     m_version(),
     m_versionEqual(),
@@ -999,104 +1080,128 @@ XmlDeclarationParser::XmlDeclarationParser( EncodingDeclParser & encodingDeclPar
 {
     assert( this != NULL );
 
-    Parser::MessageStack & messages = m_stacks.m_messages;
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
 
-    m_start = str_p( "<?xml" )
-        [ FClear( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_start ) = str_p( "<?xml" )
+        [ FClear() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found start of XML declaration, but no content." ) ];
 
-    m_version = ( commonRules.m_whiteSpaces >> str_p( "version" ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_version ) = ( commonRules.m_whiteSpaces >> str_p( "version" ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Found version keyword but no equal sign in xml declaration." ) ];
 
-    m_versionEqual = ch_p( '=' )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_versionEqual ) = ch_p( '=' )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Expected version number in single or double quotes after equal sign in xml declaration." ) ];
 
-    m_versionNumber = +( commonRules.m_versionChars )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_versionNumber ) = +( commonRules.m_versionChars )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Expected ending quote after version number in xml declaration." ) ];
 
-    m_startSQ = ( commonRules.m_singleQuote )
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startSQ ) = ( commonRules.m_singleQuote )
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting single quote but no content for version number." ) ];
 
-    m_endSQ = ( commonRules.m_singleQuote )
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endSQ ) = ( commonRules.m_singleQuote )
+        [ FCancelMessage() ];
 
-    m_skipSQ = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipSQ ) = ( *( ~commonRules.m_singleQuote ) >> commonRules.m_singleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse single-quoted version number - skipping rest of content." ) ];
 
-    m_versionSQ = ( m_startSQ >> ( ( m_versionNumber >> m_endSQ ) | m_skipSQ ) );
+    PARSER_PROFILE_RULE( m_versionSQ ) = ( m_startSQ >> ( ( m_versionNumber >> m_endSQ ) | m_skipSQ ) );
 
-    m_startDQ = ( commonRules.m_doubleQuote )
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_startDQ ) = ( commonRules.m_doubleQuote )
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Found starting double quote but no content for version number." ) ];
 
-    m_endDQ = ( commonRules.m_doubleQuote )
-        [ Parser::FCancelMessage( messages ) ];
+    PARSER_PROFILE_RULE( m_endDQ ) = ( commonRules.m_doubleQuote )
+        [ FCancelMessage() ];
 
-    m_skipDQ = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipDQ ) = ( *( ~commonRules.m_doubleQuote ) >> commonRules.m_doubleQuote )
+        [ FSetValidSyntax( false ) ]
+        [ FCancelMessage() ]
+        [ FSendMessageNow( Parser::ErrorLevel::Major,
             "Unable to parse double-quoted version number - skipping rest of content." ) ];
 
-    m_versionDQ = ( m_startDQ >> ( ( m_versionNumber >> m_endDQ ) | m_skipDQ ) );
+    PARSER_PROFILE_RULE( m_versionDQ ) = ( m_startDQ >> ( ( m_versionNumber >> m_endDQ ) | m_skipDQ ) );
 
-    m_versionInfo = ( m_version >> m_versionEqual >> ( m_versionSQ | m_versionDQ ) )
-        [ FPostVersionNumber( this ) ];
+    PARSER_PROFILE_RULE( m_versionInfo ) = ( m_version >> m_versionEqual >> ( m_versionSQ | m_versionDQ ) )
+        [ FPostVersionNumber() ];
 
-    m_encodingDecl = ( commonRules.m_whiteSpaces >> encodingDeclParser.GetRule() )
-        [ FPostEncodingDecl( this ) ];
+    PARSER_PROFILE_RULE( m_encodingDecl ) = ( commonRules.m_whiteSpaces >> encodingDeclRules.m_rule )
+        [ FPostEncodingDecl() ];
 
-    m_standalone = ( commonRules.m_whiteSpaces >> str_p( "standalone" ) )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_standalone ) = ( commonRules.m_whiteSpaces >> str_p( "standalone" ) )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Found standalone keyword but no equal sign." ) ];
 
-    m_equals = ch_p( '=' )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_equals ) = ch_p( '=' )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Found equal sign for standalone declaration but no value." ) ];
 
-    m_yesSQ = str_p( "\'yes\'" )
-        [ FSetStandaloneType( this, true, true ) ];
+    PARSER_PROFILE_RULE( m_yesSQ ) = str_p( "\'yes\'" )
+        [ FSetStandaloneType( true, true ) ];
 
-    m_yesDQ = str_p( "\"yes\"" )
-        [ FSetStandaloneType( this, true, false ) ];
+    PARSER_PROFILE_RULE( m_yesDQ ) = str_p( "\"yes\"" )
+        [ FSetStandaloneType( true, false ) ];
 
-    m_noSQ = str_p( "\'no\'" )
-        [ FSetStandaloneType( this, false, true ) ];
+    PARSER_PROFILE_RULE( m_noSQ ) = str_p( "\'no\'" )
+        [ FSetStandaloneType( false, true ) ];
 
-    m_noDQ = str_p( "\"no\"" )
-        [ FSetStandaloneType( this, false, false ) ];
+    PARSER_PROFILE_RULE( m_noDQ ) = str_p( "\"no\"" )
+        [ FSetStandaloneType( false, false ) ];
 
-    m_badDecl = nothing_p
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
+    PARSER_PROFILE_RULE( m_badDecl ) = nothing_p
+        [ FSendMessageNow( Parser::ErrorLevel::Minor,
             "Unable to parse value of xml standalone declaration." ) ]
-        [ FSetValidSyntax( this, false ) ];
+        [ FSetValidSyntax( false ) ];
 
-    m_standaloneDecl = ( m_standalone >> m_equals
+    PARSER_PROFILE_RULE( m_standaloneDecl ) = ( m_standalone >> m_equals
         >> ( m_yesSQ | m_yesDQ | m_noSQ | m_noDQ | m_badDecl ) );
 
-    m_end = str_p( "?>" )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ];
+    PARSER_PROFILE_RULE( m_end ) = str_p( "?>" )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ FSetValidSyntax( this, false ) ]
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Minor,
-            "Unable to parse xml declaration." ) ]
-        [ Parser::FPopMessageStack( messages ) ];
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser() >> !ch_p( '>' ) )
+        [ FSetValidSyntax( false ) ]
+        [ FUnwindStack( Parser::ErrorLevel::Minor,
+            "Unable to parse xml declaration." ) ];
 
-    m_rule = ( m_start >> ( ( m_versionInfo >> !m_encodingDecl
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> ( ( m_versionInfo >> !m_encodingDecl
         >> !m_standaloneDecl >> !commonRules.m_whiteSpaces >> m_end )
         | m_skipOver ) )
-        [ FDone( this ) ];
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+XmlDeclarationParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlDeclarationParser::XmlDeclarationParser( const Rules & rules,
+    EncodingDeclParser & encodingDeclParser ) :
+    m_rules( rules ),
+    m_encodingDeclParser( encodingDeclParser ),
+    m_stacks( encodingDeclParser.GetStacks() ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_validContent( false ),
+    m_singleQuoted( false ),
+    m_versionValue( '\0' ),
+    m_pBegin( NULL ),
+    m_pEnd( NULL )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
@@ -1181,12 +1286,8 @@ void XmlDeclarationParser::PostEncodingDecl( const ::Parser::CharType * begin,
     assert( m_stackSize <= m_stacks.m_messages.GetStackSize() );
     (void)begin;
     (void)end;
-    cout << __FUNCTION__ << '\t' << __LINE__ << endl;
     if ( !m_encodingDeclParser.IsValid() )
-    {
         SetValidContent( false );
-        cout << __FUNCTION__ << '\t' << __LINE__ << endl;
-    }
 }
 
 // ----------------------------------------------------------------------------
@@ -1218,15 +1319,9 @@ void XmlDeclarationParser::Done( const ::Parser::CharType * begin,
 
 // ----------------------------------------------------------------------------
 
-AttListDeclParser::AttListDeclParser( EnumeratedTypeParser & enumTypeParser,
-    AttributeValueParser & attValueParser ) :
-    m_stacks( attValueParser.GetStacks() ),
-    m_attValueParser( attValueParser ),
-    m_enumTypeParser( enumTypeParser ),
-    m_receiver( NULL ),
-    m_stackSize( 0 ),
-    m_validSyntax( false ),
-    m_validContent( false ),
+AttListDeclParser::Rules::Rules( const NameParser::Rules & nameRules,
+    const EnumeratedTypeParser::Rules & enumTypeRules,
+    const AttributeValueParser::Rules & attValueRules ) :
     m_start(),
     m_skipOver(),
     m_name(),
@@ -1235,7 +1330,7 @@ AttListDeclParser::AttListDeclParser( EnumeratedTypeParser & enumTypeParser,
     m_preEnumeration(),
     m_enumeratedType(),
     m_attType(),
-//    m_notationType(),
+//    m_notationType()
     m_defaultDeclType(),
     m_defaultDeclFixed(),
     m_preAttValue(),
@@ -1248,77 +1343,98 @@ AttListDeclParser::AttListDeclParser( EnumeratedTypeParser & enumTypeParser,
     assert( this != NULL );
 
     const CommonParserRules & commonRules = CommonParserRules::GetIt();
-    Parser::MessageStack & messages = m_stacks.m_messages;
-    NameParser & nameParser = enumTypeParser.GetNameParser();
 
-    m_start = ( str_p( "<!ATTLIST" ) >> commonRules.m_whiteSpaces )
-        [ FClear( this ) ]
-        [ Parser::FPushMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_start ) = ( str_p( "<!ATTLIST" ) >> commonRules.m_whiteSpaces )
+        [ FClear() ]
+        [ FPushMessage( Parser::ErrorLevel::Major,
             "Did not find name for attribute declaration." ) ];
 
-    m_skipOver = ( *( ~ch_p( '\0' ) ) >> ch_p( '\0' ) )
-        [ Parser::FSendMessageNow( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_skipOver ) = ( SkipOverParser() >> !ch_p( '>' ) )
+        [ FUnwindStack( Parser::ErrorLevel::Major,
             "Attribute declaration has invalid format." ) ]
-        [ Parser::FPopMessageStack( messages ) ]
-        [ FSetValidSyntax( this, false ) ];
+        [ FSetValidSyntax( false ) ];
 
-    m_name = nameParser.GetRule()
-        [ FSetName( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_name ) = nameRules.m_name
+        [ FSetName() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find content for attribute declaration." ) ];
 
-    m_attName = nameParser.GetRule()
-        [ FSetAttName( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_attName ) = nameRules.m_name
+        [ FSetAttName() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find attribute type within declaration." ) ];
 
-    m_tokenizedType = ( longest_d[
+    PARSER_PROFILE_RULE( m_tokenizedType ) = ( longest_d[
         str_p("ID") | "IDREF"   | "IDREFS"
                     | "ENTITY"  | "ENTITIES"
                     | "NMTOKEN" | "NMTOKENS"
                     | "CDATA" ] )
-        [ FSetAttType( this ) ];
+        [ FSetAttType() ];
 
-    m_preEnumeration = epsilon_p
-        [ FPreEnumeration( this ) ];
+    PARSER_PROFILE_RULE( m_preEnumeration ) = epsilon_p
+        [ FPreEnumeration() ];
 
-    m_enumeratedType = ( m_preEnumeration >> enumTypeParser.GetRule() )
-        [ FDoneEnumType( this ) ];
+    PARSER_PROFILE_RULE( m_enumeratedType ) = ( m_preEnumeration >> enumTypeRules.m_rule )
+        [ FDoneEnumType() ];
 
-    m_attType = ( m_tokenizedType | m_enumeratedType )
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_attType ) = ( m_tokenizedType | m_enumeratedType )
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find default declaration for attribute declaration." ) ];
 
-    m_defaultDeclType = ( str_p( "#REQUIRED" ) | "#IMPLIED" )
-        [ FSetDefaultDeclType( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_defaultDeclType ) = ( str_p( "#REQUIRED" ) | "#IMPLIED" )
+        [ FSetDefaultDeclType() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending brace for attribute declaration." ) ];
 
-    m_defaultDeclFixed = ( str_p( "#FIXED" ) >> commonRules.m_whiteSpaces )
-        [ FSetDefaultDeclType( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_defaultDeclFixed ) = ( str_p( "#FIXED" ) >> commonRules.m_whiteSpaces )
+        [ FSetDefaultDeclType() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find value for attribute declaration." ) ];
 
-    m_preAttValue = epsilon_p
-        [ FPreAttValue( this ) ];
+    PARSER_PROFILE_RULE( m_preAttValue ) = epsilon_p
+        [ FPreAttValue() ];
 
-    m_attValue = ( m_preAttValue >> attValueParser.GetRule() )
-        [ FDoneAttValue( this ) ]
-        [ Parser::FPrepareMessage( messages, Parser::ErrorLevel::Major,
+    PARSER_PROFILE_RULE( m_attValue ) = ( m_preAttValue >> attValueRules.m_rule )
+        [ FDoneAttValue() ]
+        [ FPrepareMessage( Parser::ErrorLevel::Major,
             "Did not find ending brace for attribute declaration." ) ];
 
-    m_defaultDecl = ( m_defaultDeclType | ( !m_defaultDeclFixed >> m_attValue ) );
+    PARSER_PROFILE_RULE( m_defaultDecl ) = ( m_defaultDeclType | ( !m_defaultDeclFixed >> m_attValue ) );
 
-    m_attDef = ( commonRules.m_whiteSpaces >> m_attName
+    PARSER_PROFILE_RULE( m_attDef ) = ( commonRules.m_whiteSpaces >> m_attName
         >> commonRules.m_whiteSpaces >> m_attType
         >> commonRules.m_whiteSpaces >> m_defaultDecl );
 
-    m_end = ( !commonRules.m_whiteSpaces >> '>' )
-        [ Parser::FCancelMessage( messages ) ]
-        [ FSetValidSyntax( this, true ) ];
+    PARSER_PROFILE_RULE( m_end ) = ( !commonRules.m_whiteSpaces >> '>' )
+        [ FCancelMessage() ]
+        [ FSetValidSyntax( true ) ];
 
-    m_rule = ( m_start >> ( ( m_name >> *m_attDef >> m_end ) | m_skipOver ) )
-        [ FDone( this ) ];
+    PARSER_PROFILE_RULE( m_rule ) = ( m_start >> ( ( m_name >> *m_attDef >> m_end ) | m_skipOver ) )
+        [ FDone() ];
+}
+
+// ----------------------------------------------------------------------------
+
+AttListDeclParser::Rules::~Rules( void )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+AttListDeclParser::AttListDeclParser( const Rules & rules,
+    EnumeratedTypeParser & enumTypeParser,
+    AttributeValueParser & attValueParser ) :
+    m_rules( rules ),
+    m_stacks( attValueParser.GetStacks() ),
+    m_attValueParser( attValueParser ),
+    m_enumTypeParser( enumTypeParser ),
+    m_receiver( NULL ),
+    m_stackSize( 0 ),
+    m_validSyntax( false ),
+    m_validContent( false )
+{
+    assert( this != NULL );
 }
 
 // ----------------------------------------------------------------------------
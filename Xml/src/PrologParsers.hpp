@@ -23,6 +23,7 @@
 #include "../../Util/include/ParseUtil.hpp"
 
 #include "./CommonInfo.hpp"
+#include "./BasicParsers.hpp"
 
 namespace Parser
 {
@@ -39,10 +40,6 @@ namespace Xml
     class IXmlDeclarationReceiver;
     class IAttListDeclReceiver;
 
-    class NameParser;
-    class ReferenceParser;
-    class AttributeValueParser;
-
 
 // ----------------------------------------------------------------------------
 
@@ -50,7 +47,38 @@ class PublicIdLiteralParser
 {
 public:
 
-    explicit PublicIdLiteralParser( ParserStacks & stacks );
+    /// Returns the PublicIdLiteralParser of the parse running on this thread.
+    static PublicIdLiteralParser & Current( void );
+
+    /// Rules for public id literals.
+    class Rules
+    {
+    public:
+
+        Rules( void );
+        ~Rules( void );
+
+        SpiritRule m_skipOver;
+        SpiritRule m_startSQ;
+        SpiritRule m_sQuotedChars;
+        SpiritRule m_sQuoteOrRef;
+        SpiritRule m_endSQ;
+        SpiritRule m_skipSQ;
+        SpiritRule m_singleQuotedValue;
+        SpiritRule m_startDQ;
+        SpiritRule m_dQuoteOrRef;
+        SpiritRule m_dQuotedChars;
+        SpiritRule m_endDQ;
+        SpiritRule m_skipDQ;
+        SpiritRule m_doubleQuotedValue;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    PublicIdLiteralParser( const Rules & rules, ParserStacks & stacks );
     ~PublicIdLiteralParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IPublicIdReceiver * receiver )
@@ -64,7 +92,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -111,6 +139,7 @@ private:
         m_pEnd = end;
     }
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     ::Parser::Xml::IPublicIdReceiver * m_receiver;
     unsigned int m_stackSize;
@@ -120,21 +149,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_skipOver;
-    SpiritRule m_startSQ;
-    SpiritRule m_sQuotedChars;
-    SpiritRule m_sQuoteOrRef;
-    SpiritRule m_endSQ;
-    SpiritRule m_skipSQ;
-    SpiritRule m_singleQuotedValue;
-    SpiritRule m_startDQ;
-    SpiritRule m_dQuoteOrRef;
-    SpiritRule m_dQuotedChars;
-    SpiritRule m_endDQ;
-    SpiritRule m_skipDQ;
-    SpiritRule m_doubleQuotedValue;
-    SpiritRule m_rule;
-
 }; // end class PublicIdLiteralParser
 
 // ----------------------------------------------------------------------------
@@ -143,7 +157,44 @@ class ExternalIdLiteralParser
 {
 public:
 
-    explicit ExternalIdLiteralParser( PublicIdLiteralParser & pubIdParser );
+    /// Returns the ExternalIdLiteralParser of the parse running on this thread.
+    static ExternalIdLiteralParser & Current( void );
+
+    /// Rules for external ids.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const PublicIdLiteralParser::Rules & pubIdRules );
+        ~Rules( void );
+
+        SpiritRule m_startSQ;
+        SpiritRule m_sQuotedChars;
+        SpiritRule m_endSQ;
+        SpiritRule m_skipSQ;
+        SpiritRule m_singleQuotedValue;
+        SpiritRule m_startDQ;
+        SpiritRule m_dQuotedChars;
+        SpiritRule m_endDQ;
+        SpiritRule m_skipDQ;
+        SpiritRule m_doubleQuotedValue;
+        SpiritRule m_system;
+        SpiritRule m_sysLiteral;
+        SpiritRule m_public;
+        SpiritRule m_pubLiteral;
+        SpiritRule m_whitespace;
+        SpiritRule m_pubRules;
+        SpiritRule m_skipOver;
+        SpiritRule m_done;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    ExternalIdLiteralParser( const Rules & rules,
+        PublicIdLiteralParser & pubIdParser );
     ~ExternalIdLiteralParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IExternalIdReceiver * receiver )
@@ -155,7 +206,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -167,48 +218,43 @@ private:
 
     typedef ::Parser::FBreakPoint< ExternalIdLiteralParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< ExternalIdLiteralParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< ExternalIdLiteralParser > FUnwindStack;
     typedef ::Parser::FDone< ExternalIdLiteralParser > FDone;
     typedef ::Parser::Xml::FSetQuoteType< ExternalIdLiteralParser > FSetQuoteType;
 
     friend struct ::Parser::FSetValidSyntax< ExternalIdLiteralParser >;
+    friend struct ::Parser::FUnwindStack< ExternalIdLiteralParser >;
     friend struct ::Parser::FDone< ExternalIdLiteralParser >;
     friend struct ::Parser::Xml::FSetQuoteType< ExternalIdLiteralParser >;
 
     struct FSetup
     {
-        inline FSetup( ExternalIdLiteralParser * pParser,
-            bool isPublicId ) : m_pParser( pParser ), m_isPublicId( isPublicId ) {}
+        inline explicit FSetup( bool isPublicId ) :
+            m_isPublicId( isPublicId ) {}
         inline void operator () ( const Parser::CharType *,
             const Parser::CharType * ) const
         {
-            m_pParser->Setup( m_isPublicId );
+            ExternalIdLiteralParser::Current().Setup( m_isPublicId );
         }
-        ExternalIdLiteralParser * m_pParser;
         bool m_isPublicId;
     };
 
     struct FSetSysLiteral
     {
-        inline FSetSysLiteral( ExternalIdLiteralParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const Parser::CharType * begin,
             const Parser::CharType * end ) const
         {
-            m_pParser->SetSysLiteral( begin, end );
+            ExternalIdLiteralParser::Current().SetSysLiteral( begin, end );
         }
-        ExternalIdLiteralParser * m_pParser;
     };
 
     struct FSetPubIdLiteral
     {
-        inline FSetPubIdLiteral( ExternalIdLiteralParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const Parser::CharType * begin,
             const Parser::CharType * end ) const
         {
-            m_pParser->SetPubIdLiteral( begin, end );
+            ExternalIdLiteralParser::Current().SetPubIdLiteral( begin, end );
         }
-        ExternalIdLiteralParser * m_pParser;
     };
 
     ExternalIdLiteralParser( const ExternalIdLiteralParser & );
@@ -224,6 +270,13 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     void SetSysLiteral( const Parser::CharType * begin,
@@ -234,6 +287,7 @@ private:
 
     void Done( const Parser::CharType * begin, const Parser::CharType * end );
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     PublicIdLiteralParser & m_pubIdParser;
     ::Parser::Xml::IExternalIdReceiver * m_receiver;
@@ -244,26 +298,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_startSQ;
-    SpiritRule m_sQuotedChars;
-    SpiritRule m_endSQ;
-    SpiritRule m_skipSQ;
-    SpiritRule m_singleQuotedValue;
-    SpiritRule m_startDQ;
-    SpiritRule m_dQuotedChars;
-    SpiritRule m_endDQ;
-    SpiritRule m_skipDQ;
-    SpiritRule m_doubleQuotedValue;
-    SpiritRule m_system;
-    SpiritRule m_sysLiteral;
-    SpiritRule m_public;
-    SpiritRule m_pubLiteral;
-    SpiritRule m_whitespace;
-    SpiritRule m_pubRules;
-    SpiritRule m_skipOver;
-    SpiritRule m_done;
-    SpiritRule m_rule;
-
 }; // end class ExternalIdLiteralParser
 
 // ----------------------------------------------------------------------------
@@ -272,7 +306,29 @@ class PeReferenceParser
 {
 public:
 
-    explicit PeReferenceParser( NameParser & nameParser );
+    /// Returns the PeReferenceParser of the parse running on this thread.
+    static PeReferenceParser & Current( void );
+
+    /// Rules for parameter entity references.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const NameParser::Rules & nameRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_name;
+        SpiritRule m_end;
+        SpiritRule m_skipOver;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    PeReferenceParser( const Rules & rules, NameParser & nameParser );
     ~PeReferenceParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IPeReferenceReceiver * receiver )
@@ -284,7 +340,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -296,11 +352,13 @@ private:
 
     typedef ::Parser::FBreakPoint< PeReferenceParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< PeReferenceParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< PeReferenceParser > FUnwindStack;
     typedef ::Parser::FClear< PeReferenceParser > FClear;
     typedef ::Parser::FEnd< PeReferenceParser > FEnd;
     typedef ::Parser::Xml::FSetName< PeReferenceParser > FSetName;
 
     friend struct ::Parser::FSetValidSyntax< PeReferenceParser >;
+    friend struct ::Parser::FUnwindStack< PeReferenceParser >;
     friend struct ::Parser::FClear< PeReferenceParser >;
     friend struct ::Parser::FEnd< PeReferenceParser >;
     friend struct ::Parser::Xml::FSetName< PeReferenceParser >;
@@ -315,6 +373,13 @@ private:
         m_validSyntax = valid;
     }
 
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
     void SetName( const Parser::CharType * begin, const Parser::CharType * end )
     {
         m_pBegin = begin;
@@ -323,6 +388,8 @@ private:
 
     void End( void );
 
+    const Rules & m_rules;
+    NameParser & m_nameParser;
     ParserStacks & m_stacks;
     ::Parser::Xml::IPeReferenceReceiver * m_receiver;
     unsigned int m_stackSize;
@@ -331,12 +398,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_start;
-    SpiritRule m_name;
-    SpiritRule m_end;
-    SpiritRule m_skipOver;
-    SpiritRule m_rule;
-
 }; // end class PeReferenceParser
 
 // ----------------------------------------------------------------------------
@@ -345,7 +406,35 @@ class EnumeratedTypeParser
 {
 public:
 
-    explicit EnumeratedTypeParser( NameParser & nameParser );
+    /// Returns the EnumeratedTypeParser of the parse running on this thread.
+    static EnumeratedTypeParser & Current( void );
+
+    /// Rules for notation and enumeration types.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const NameParser::Rules & nameRules );
+        ~Rules( void );
+
+        SpiritRule m_noteStart;
+        SpiritRule m_noteBeginP;
+        SpiritRule m_name;
+        SpiritRule m_nameDelimiter;
+        SpiritRule m_endP;
+        SpiritRule m_notation;
+        SpiritRule m_enumStart;
+        SpiritRule m_nameToken;
+        SpiritRule m_enumeration;
+        SpiritRule m_skipOver;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    EnumeratedTypeParser( const Rules & rules, NameParser & nameParser );
     ~EnumeratedTypeParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IEnumeratedTypeReceiver * receiver )
@@ -359,7 +448,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -377,24 +466,27 @@ private:
     typedef ::Parser::FBreakPoint< EnumeratedTypeParser > FBreakPoint;
     typedef ::Parser::FSetValidContent< EnumeratedTypeParser > FSetValidContent;
     typedef ::Parser::FSetValidSyntax< EnumeratedTypeParser > FSetValidSyntax;
+    typedef ::Parser::FStoreStackSize< EnumeratedTypeParser > FStoreStackSize;
+    typedef ::Parser::FUnwindStack< EnumeratedTypeParser > FUnwindStack;
     typedef ::Parser::FDone< EnumeratedTypeParser > FDone;
     typedef ::Parser::Xml::FSetName< EnumeratedTypeParser > FSetName;
 
     friend struct ::Parser::FSetValidContent< EnumeratedTypeParser >;
     friend struct ::Parser::FSetValidSyntax< EnumeratedTypeParser >;
+    friend struct ::Parser::FStoreStackSize< EnumeratedTypeParser >;
+    friend struct ::Parser::FUnwindStack< EnumeratedTypeParser >;
     friend struct ::Parser::FDone< EnumeratedTypeParser >;
     friend struct ::Parser::Xml::FSetName< EnumeratedTypeParser >;
 
     struct FSetEnumType
     {
-        inline FSetEnumType( EnumeratedTypeParser * pParser, bool isNotation ) :
-            m_pParser( pParser ), m_isNotation( isNotation ) {}
+        inline explicit FSetEnumType( bool isNotation ) :
+            m_isNotation( isNotation ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->SetEnumType( m_isNotation );
+            EnumeratedTypeParser::Current().SetEnumType( m_isNotation );
         }
-        EnumeratedTypeParser * m_pParser;
         bool m_isNotation;
     };
 
@@ -404,6 +496,18 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
+    inline void StoreStackSize( void )
+    {
+        m_stackSize = m_stacks.m_messages.GetStackSize();
     }
 
     void SetEnumType( bool notation );
@@ -413,6 +517,7 @@ private:
     void Done( const Parser::CharType * begin,
         const Parser::CharType * end );
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     NameParser & m_nameParser;
     ::Parser::Xml::IEnumeratedTypeReceiver * m_receiver;
@@ -420,18 +525,6 @@ private:
     bool m_validSyntax;
     bool m_isNotation;
 
-    SpiritRule m_noteStart;
-    SpiritRule m_noteBeginP;
-    SpiritRule m_name;
-    SpiritRule m_nameDelimiter;
-    SpiritRule m_endP;
-    SpiritRule m_notation;
-    SpiritRule m_enumStart;
-    SpiritRule m_nameToken;
-    SpiritRule m_enumeration;
-    SpiritRule m_skipOver;
-    SpiritRule m_rule;
-
 }; // end class EnumeratedTypeParser
 
 // ----------------------------------------------------------------------------
@@ -440,7 +533,39 @@ class EntityValueParser
 {
 public:
 
-    EntityValueParser( ReferenceParser & refParser,
+    /// Returns the EntityValueParser of the parse running on this thread.
+    static EntityValueParser & Current( void );
+
+    /// Rules for entity values.
+    class Rules
+    {
+    public:
+
+        Rules( const ReferenceParser::Rules & refRules,
+            const PeReferenceParser::Rules & peRefRules );
+        ~Rules( void );
+
+        SpiritRule m_skipOver;
+        SpiritRule m_sqStart;
+        SpiritRule m_dqStart;
+        SpiritRule m_reference;
+        SpiritRule m_peReference;
+        SpiritRule m_sqValue;
+        SpiritRule m_dqValue;
+        SpiritRule m_sqContent;
+        SpiritRule m_dqContent;
+        SpiritRule m_sqEnd;
+        SpiritRule m_dqEnd;
+        SpiritRule m_sqEntity;
+        SpiritRule m_dqEntity;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    EntityValueParser( const Rules & rules, ReferenceParser & refParser,
         PeReferenceParser & peReferenceParser );
     ~EntityValueParser( void );
 
@@ -453,7 +578,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -465,6 +590,8 @@ private:
 
     typedef ::Parser::FBreakPoint< EntityValueParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< EntityValueParser > FSetValidSyntax;
+    typedef ::Parser::FStoreStackSize< EntityValueParser > FStoreStackSize;
+    typedef ::Parser::FUnwindStack< EntityValueParser > FUnwindStack;
     typedef ::Parser::FSetValidContent< EntityValueParser > FSetValidContent;
     typedef ::Parser::FDone< EntityValueParser > FDone;
     typedef ::Parser::Xml::FSetReference< EntityValueParser > FSetReference;
@@ -473,6 +600,8 @@ private:
 
     friend struct ::Parser::FSetValidContent< EntityValueParser >;
     friend struct ::Parser::FSetValidSyntax< EntityValueParser >;
+    friend struct ::Parser::FStoreStackSize< EntityValueParser >;
+    friend struct ::Parser::FUnwindStack< EntityValueParser >;
     friend struct ::Parser::FDone< EntityValueParser >;
     friend struct ::Parser::Xml::FSetReference< EntityValueParser >;
     friend struct ::Parser::Xml::FSetQuoteType< EntityValueParser >;
@@ -486,6 +615,18 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
+    inline void StoreStackSize( void )
+    {
+        m_stackSize = m_stacks.m_messages.GetStackSize();
     }
 
     inline void SetValidContent( bool valid )
@@ -506,16 +647,14 @@ private:
 
     struct FSetPeReference
     {
-        inline explicit FSetPeReference( EntityValueParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const Parser::CharType * begin,
             const Parser::CharType * end ) const
         {
-            m_pParser->SetPeReference( begin, end );
+            EntityValueParser::Current().SetPeReference( begin, end );
         }
-        EntityValueParser * m_pParser;
     };
 
+    const Rules & m_rules;
     PeReferenceParser & m_peRefParser;
     ReferenceParser & m_refParser;
     ParserStacks & m_stacks;
@@ -525,21 +664,6 @@ private:
     bool m_validContent;
     bool m_singleQuoted;
 
-    SpiritRule m_skipOver;
-    SpiritRule m_sqStart;
-    SpiritRule m_dqStart;
-    SpiritRule m_reference;
-    SpiritRule m_peReference;
-    SpiritRule m_sqValue;
-    SpiritRule m_dqValue;
-    SpiritRule m_sqContent;
-    SpiritRule m_dqContent;
-    SpiritRule m_sqEnd;
-    SpiritRule m_dqEnd;
-    SpiritRule m_sqEntity;
-    SpiritRule m_dqEntity;
-    SpiritRule m_rule;
-
 }; // end class EntityValueParser
 
 // ----------------------------------------------------------------------------
@@ -548,7 +672,38 @@ class EncodingDeclParser
 {
 public:
 
-    explicit EncodingDeclParser( ParserStacks & stacks );
+    /// Returns the EncodingDeclParser of the parse running on this thread.
+    static EncodingDeclParser & Current( void );
+
+    /// Rules for encoding declarations.
+    class Rules
+    {
+    public:
+
+        Rules( void );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_equals;
+        SpiritRule m_encName;
+        SpiritRule m_startSQ;
+        SpiritRule m_endSQ;
+        SpiritRule m_skipSQ;
+        SpiritRule m_sQuotedContent;
+        SpiritRule m_startDQ;
+        SpiritRule m_endDQ;
+        SpiritRule m_skipDQ;
+        SpiritRule m_dQuotedContent;
+        SpiritRule m_content;
+        SpiritRule m_skipOver;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    EncodingDeclParser( const Rules & rules, ParserStacks & stacks );
     ~EncodingDeclParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IEncodingDeclReceiver * receiver )
@@ -562,7 +717,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -578,6 +733,7 @@ private:
     typedef ::Parser::FStoreStackSize< EncodingDeclParser > FStoreStackSize;
     typedef ::Parser::FBreakPoint< EncodingDeclParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< EncodingDeclParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< EncodingDeclParser > FUnwindStack;
     typedef ::Parser::FSetContent< EncodingDeclParser > FSetContent;
     typedef ::Parser::FClear< EncodingDeclParser > FClear;
     typedef ::Parser::FDone< EncodingDeclParser > FDone;
@@ -586,6 +742,7 @@ private:
 
     friend struct ::Parser::FStoreStackSize< EncodingDeclParser >;
     friend struct ::Parser::FSetValidSyntax< EncodingDeclParser >;
+    friend struct ::Parser::FUnwindStack< EncodingDeclParser >;
     friend struct ::Parser::FSetContent< EncodingDeclParser >;
     friend struct ::Parser::FClear< EncodingDeclParser >;
     friend struct ::Parser::FDone< EncodingDeclParser >;
@@ -609,6 +766,13 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     inline void SetQuoteType( const Parser::CharType ch )
@@ -619,6 +783,7 @@ private:
     void SetName( const Parser::CharType * begin,
         const Parser::CharType * end );
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     ::Parser::Xml::IEncodingDeclReceiver * m_receiver;
     unsigned int m_stackSize;
@@ -628,21 +793,6 @@ private:
     const Parser::CharType * m_pBegin;
     const Parser::CharType * m_pEnd;
 
-    SpiritRule m_start;
-    SpiritRule m_equals;
-    SpiritRule m_encName;
-    SpiritRule m_startSQ;
-    SpiritRule m_endSQ;
-    SpiritRule m_skipSQ;
-    SpiritRule m_sQuotedContent;
-    SpiritRule m_startDQ;
-    SpiritRule m_endDQ;
-    SpiritRule m_skipDQ;
-    SpiritRule m_dQuotedContent;
-    SpiritRule m_content;
-    SpiritRule m_skipOver;
-    SpiritRule m_rule;
-
 }; // end class EncodingDeclParser
 
 // ----------------------------------------------------------------------------
@@ -651,7 +801,50 @@ class XmlDeclarationParser
 {
 public:
 
-    explicit XmlDeclarationParser( EncodingDeclParser & encodingDeclParser );
+    /// Returns the XmlDeclarationParser of the parse running on this thread.
+    static XmlDeclarationParser & Current( void );
+
+    /// Rules for xml declarations.
+    class Rules
+    {
+    public:
+
+        explicit Rules( const EncodingDeclParser::Rules & encodingDeclRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_version;
+        SpiritRule m_versionEqual;
+        SpiritRule m_versionNumber;
+        SpiritRule m_startSQ;
+        SpiritRule m_endSQ;
+        SpiritRule m_skipSQ;
+        SpiritRule m_versionSQ;
+        SpiritRule m_startDQ;
+        SpiritRule m_endDQ;
+        SpiritRule m_skipDQ;
+        SpiritRule m_versionDQ;
+        SpiritRule m_versionInfo;
+        SpiritRule m_encodingDecl;
+        SpiritRule m_standalone;
+        SpiritRule m_equals;
+        SpiritRule m_yesSQ;
+        SpiritRule m_yesDQ;
+        SpiritRule m_noSQ;
+        SpiritRule m_noDQ;
+        SpiritRule m_badDecl;
+        SpiritRule m_standaloneDecl;
+        SpiritRule m_end;
+        SpiritRule m_skipOver;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    XmlDeclarationParser( const Rules & rules,
+        EncodingDeclParser & encodingDeclParser );
     ~XmlDeclarationParser( void );
 
     inline void SetReceiver( ::Parser::Xml::IXmlDeclarationReceiver * receiver )
@@ -666,7 +859,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -678,12 +871,14 @@ private:
 
     typedef ::Parser::FBreakPoint< XmlDeclarationParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< XmlDeclarationParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< XmlDeclarationParser > FUnwindStack;
     typedef ::Parser::FSetContent< XmlDeclarationParser > FSetContent;
     typedef ::Parser::FClear< XmlDeclarationParser > FClear;
     typedef ::Parser::FDone< XmlDeclarationParser > FDone;
     typedef ::Parser::Xml::FSetQuoteType< XmlDeclarationParser > FSetQuoteType;
 
     friend struct ::Parser::FSetValidSyntax< XmlDeclarationParser >;
+    friend struct ::Parser::FUnwindStack< XmlDeclarationParser >;
     friend struct ::Parser::FSetContent< XmlDeclarationParser >;
     friend struct ::Parser::FClear< XmlDeclarationParser >;
     friend struct ::Parser::FDone< XmlDeclarationParser >;
@@ -691,41 +886,34 @@ private:
 
     struct FSetStandaloneType
     {
-        inline FSetStandaloneType( XmlDeclarationParser * pParser, bool isYes,
-            bool singleQuoted ) : m_pParser( pParser ), m_isYes( isYes ),
-            m_singleQuoted( singleQuoted ) {}
+        inline FSetStandaloneType( bool isYes, bool singleQuoted ) :
+            m_isYes( isYes ), m_singleQuoted( singleQuoted ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->SetStandaloneType( m_isYes, m_singleQuoted );
+            XmlDeclarationParser::Current().SetStandaloneType( m_isYes,
+                m_singleQuoted );
         }
-        XmlDeclarationParser * m_pParser;
         bool m_isYes;
         bool m_singleQuoted;
     };
 
     struct FPostEncodingDecl
     {
-        inline explicit FPostEncodingDecl( XmlDeclarationParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->PostEncodingDecl( begin, end );
+            XmlDeclarationParser::Current().PostEncodingDecl( begin, end );
         }
-        XmlDeclarationParser * m_pParser;
     };
 
     struct FPostVersionNumber
     {
-        inline explicit FPostVersionNumber( XmlDeclarationParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->PostVersionNumber( begin, end );
+            XmlDeclarationParser::Current().PostVersionNumber( begin, end );
         }
-        XmlDeclarationParser * m_pParser;
     };
 
     XmlDeclarationParser( const XmlDeclarationParser & );
@@ -744,6 +932,13 @@ private:
     inline void SetValidSyntax( bool valid )
     {
         m_validSyntax = valid;
+    }
+
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
     }
 
     inline void SetValidContent( bool valid )
@@ -753,6 +948,7 @@ private:
 
     void Done( const ::Parser::CharType * begin, const ::Parser::CharType * end );
 
+    const Rules & m_rules;
     EncodingDeclParser & m_encodingDeclParser;
     ParserStacks & m_stacks;
     ::Parser::Xml::IXmlDeclarationReceiver * m_receiver;
@@ -765,32 +961,6 @@ private:
     const ::Parser::CharType * m_pBegin;
     const ::Parser::CharType * m_pEnd;
 
-    SpiritRule m_start;
-    SpiritRule m_version;
-    SpiritRule m_versionEqual;
-    SpiritRule m_versionNumber;
-    SpiritRule m_startSQ;
-    SpiritRule m_endSQ;
-    SpiritRule m_skipSQ;
-    SpiritRule m_versionSQ;
-    SpiritRule m_startDQ;
-    SpiritRule m_endDQ;
-    SpiritRule m_skipDQ;
-    SpiritRule m_versionDQ;
-    SpiritRule m_versionInfo;
-    SpiritRule m_encodingDecl;
-    SpiritRule m_standalone;
-    SpiritRule m_equals;
-    SpiritRule m_yesSQ;
-    SpiritRule m_yesDQ;
-    SpiritRule m_noSQ;
-    SpiritRule m_noDQ;
-    SpiritRule m_badDecl;
-    SpiritRule m_standaloneDecl;
-    SpiritRule m_end;
-    SpiritRule m_skipOver;
-    SpiritRule m_rule;
-
 }; // end class XmlDeclarationParser
 
 // ----------------------------------------------------------------------------
@@ -799,7 +969,43 @@ class AttListDeclParser
 {
 public:
 
-    AttListDeclParser( EnumeratedTypeParser & enumTypeParser,
+    /// Returns the AttListDeclParser of the parse running on this thread.
+    static AttListDeclParser & Current( void );
+
+    /// Rules for attribute list declarations.
+    class Rules
+    {
+    public:
+
+        Rules( const NameParser::Rules & nameRules,
+            const EnumeratedTypeParser::Rules & enumTypeRules,
+            const AttributeValueParser::Rules & attValueRules );
+        ~Rules( void );
+
+        SpiritRule m_start;
+        SpiritRule m_skipOver;
+        SpiritRule m_name;
+        SpiritRule m_attName;
+        SpiritRule m_tokenizedType;
+        SpiritRule m_preEnumeration;
+        SpiritRule m_enumeratedType;
+        SpiritRule m_attType;
+        SpiritRule m_defaultDeclType;
+        SpiritRule m_defaultDeclFixed;
+        SpiritRule m_preAttValue;
+        SpiritRule m_attValue;
+        SpiritRule m_defaultDecl;
+        SpiritRule m_attDef;
+        SpiritRule m_end;
+        SpiritRule m_rule;
+
+    private:
+        Rules( const Rules & );
+        Rules & operator = ( const Rules & );
+    };
+
+    AttListDeclParser( const Rules & rules,
+        EnumeratedTypeParser & enumTypeParser,
         AttributeValueParser & attValueParser );
 
     ~AttListDeclParser( void );
@@ -816,7 +1022,7 @@ public:
 
     inline const SpiritRule & GetRule( void ) const
     {
-        return m_rule;
+        return m_rules.m_rule;
     }
 
     inline ParserStacks & GetStacks( void )
@@ -828,109 +1034,87 @@ private:
 
     typedef ::Parser::FBreakPoint< AttListDeclParser > FBreakPoint;
     typedef ::Parser::FSetValidSyntax< AttListDeclParser > FSetValidSyntax;
+    typedef ::Parser::FUnwindStack< AttListDeclParser > FUnwindStack;
     typedef ::Parser::FClear< AttListDeclParser > FClear;
     typedef ::Parser::FDone< AttListDeclParser > FDone;
     typedef ::Parser::Xml::FSetName< AttListDeclParser > FSetName;
 
     friend struct ::Parser::FSetValidSyntax< AttListDeclParser >;
+    friend struct ::Parser::FUnwindStack< AttListDeclParser >;
     friend struct ::Parser::FClear< AttListDeclParser >;
     friend struct ::Parser::FDone< AttListDeclParser >;
     friend struct ::Parser::Xml::FSetName< AttListDeclParser >;
 
     struct FSetAttName
     {
-        inline explicit FSetAttName( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->SetAttName( begin, end );
+            AttListDeclParser::Current().SetAttName( begin, end );
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FSetAttType
     {
-        inline explicit FSetAttType( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->SetAttType( begin, end );
+            AttListDeclParser::Current().SetAttType( begin, end );
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FAddNotateName
     {
-        inline explicit FAddNotateName( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->AddNotateName( begin, end );
+            AttListDeclParser::Current().AddNotateName( begin, end );
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FSetDefaultDeclType
     {
-        inline FSetDefaultDeclType( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType * begin,
             const ::Parser::CharType * end ) const
         {
-            m_pParser->SetDefaultDeclType( begin, end );
+            AttListDeclParser::Current().SetDefaultDeclType( begin, end );
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FPreAttValue
     {
-        inline FPreAttValue( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->PreAttValue();
+            AttListDeclParser::Current().PreAttValue();
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FDoneAttValue
     {
-        inline FDoneAttValue( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->DoneAttValue();
+            AttListDeclParser::Current().DoneAttValue();
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FPreEnumeration
     {
-        inline FPreEnumeration( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->PreEnumeration();
+            AttListDeclParser::Current().PreEnumeration();
         }
-        AttListDeclParser * m_pParser;
     };
 
     struct FDoneEnumType
     {
-        inline FDoneEnumType( AttListDeclParser * pParser ) :
-            m_pParser( pParser ) {}
         inline void operator () ( const ::Parser::CharType *,
             const ::Parser::CharType * ) const
         {
-            m_pParser->DoneEnumType();
+            AttListDeclParser::Current().DoneEnumType();
         }
-        AttListDeclParser * m_pParser;
     };
 
     AttListDeclParser( const AttListDeclParser & );
@@ -943,6 +1127,13 @@ private:
         m_validSyntax = valid;
     }
 
+    /// Skips over a production which could not be parsed.  @see MessageStack::Unwind.
+    inline void UnwindStack( Parser::ErrorLevel::Levels level,
+        const Parser::CharType * message, const Parser::CharType * place )
+    {
+        m_stacks.m_messages.Unwind( m_stackSize, level, message, place );
+    }
+
     void SetName( const Parser::CharType * begin,
         const Parser::CharType * end );
 
@@ -969,6 +1160,7 @@ private:
     void Done( const Parser::CharType * begin,
         const Parser::CharType * end );
 
+    const Rules & m_rules;
     ParserStacks & m_stacks;
     AttributeValueParser & m_attValueParser;
     EnumeratedTypeParser & m_enumTypeParser;
@@ -977,23 +1169,7 @@ private:
     bool m_validSyntax;
     bool m_validContent;
 
-    SpiritRule m_start;
-    SpiritRule m_skipOver;
-    SpiritRule m_name;
-    SpiritRule m_attName;
-    SpiritRule m_tokenizedType;
-    SpiritRule m_preEnumeration;
-    SpiritRule m_enumeratedType;
-    SpiritRule m_attType;
 //    SpiritRule m_notationType;
-    SpiritRule m_defaultDeclType;
-    SpiritRule m_defaultDeclFixed;
-    SpiritRule m_preAttValue;
-    SpiritRule m_attValue;
-    SpiritRule m_defaultDecl;
-    SpiritRule m_attDef;
-    SpiritRule m_end;
-    SpiritRule m_rule;
 
 }; // end class AttListDeclParser
 
@@ -0,0 +1,250 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlBatch.cpp Parses many documents on many threads.
+
+
+#include "../include/XmlBatch.hpp"
+
+#include <assert.h>
+
+#include "../include/XmlDocument.hpp"
+#include "../../Util/include/FileBuffer.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Parser and message receiver used by one thread.
+struct XmlWorker
+{
+    ::Parser::Xml::XmlParser m_parser;
+    ::Parser::MessageCollector m_messages;
+};
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+XmlBatch::XmlBatch( unsigned long threadCount ) :
+    BatchRunner( threadCount ),
+    m_items()
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlBatch::~XmlBatch( void )
+{
+    assert( NULL != this );
+    Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlBatch::Clear( void )
+{
+    assert( NULL != this );
+    for ( ::std::vector< Item * >::iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        // Document points into the file, so it goes first.
+        delete ( *it )->m_document;
+        delete ( *it )->m_file;
+        delete *it;
+    }
+    m_items.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlBatch::Item & XmlBatch::AddItem( const char * name, bool isFile )
+{
+    assert( NULL != this );
+    Item * item = new Item;
+    item->m_name = ( NULL == name ) ? "" : name;
+    item->m_file = NULL;
+    item->m_begin = NULL;
+    item->m_end = NULL;
+    item->m_result = XmlParser::NotParsed;
+    item->m_document = NULL;
+    item->m_messageCount = 0;
+    try
+    {
+        item->m_document = new XmlDocument;
+        if ( isFile )
+            item->m_file = new FileBuffer;
+        m_items.push_back( item );
+    }
+    catch ( ... )
+    {
+        delete item->m_document;
+        delete item->m_file;
+        delete item;
+        throw;
+    }
+    return *item;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlBatch::AddFile( const char * filename )
+{
+    assert( NULL != this );
+    AddItem( filename, true );
+    return GetCount() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlBatch::AddBuffer( const char * begin, const char * end,
+    const char * name )
+{
+    assert( NULL != this );
+    Item & item = AddItem( name, false );
+    item.m_begin = begin;
+    item.m_end = end;
+    return GetCount() - 1;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlBatch::Run( void )
+{
+    assert( NULL != this );
+
+    for ( ::std::vector< Item * >::iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        Item & item = **it;
+        item.m_result = XmlParser::NotParsed;
+        item.m_messages.clear();
+        item.m_messageCount = 0;
+    }
+    RunJobs( GetCount() );
+
+    for ( ::std::vector< Item * >::const_iterator it( m_items.begin() ); it != m_items.end(); ++it )
+    {
+        if ( XmlParser::AllValid != ( *it )->m_result )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void * XmlBatch::MakeWorker( void )
+{
+    assert( NULL != this );
+    XmlWorker * worker = new XmlWorker;
+    worker->m_parser.SetErrorReceiver( &worker->m_messages );
+    return worker;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlBatch::RunJob( void * worker, unsigned long job )
+{
+    assert( NULL != this );
+    assert( job < m_items.size() );
+
+    XmlWorker & parts = *reinterpret_cast< XmlWorker * >( worker );
+    Item & item = *m_items[ job ];
+    parts.m_messages.SetTarget( &item.m_messages, &item.m_messageCount );
+    item.m_result = XmlParser::Exception;
+
+    if ( NULL != item.m_file )
+    {
+        if ( !item.m_file->IsOpen() && !item.m_file->Open( item.m_name.c_str() ) )
+        {
+            item.m_result = XmlParser::CantOpenFile;
+            parts.m_messages.SetTarget( NULL, NULL );
+            return;
+        }
+        item.m_begin = item.m_file->GetBegin();
+        item.m_end = item.m_file->GetEnd();
+    }
+    item.m_result = item.m_document->Parse( parts.m_parser, item.m_begin, item.m_end );
+    parts.m_messages.SetTarget( NULL, NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlBatch::DestroyWorker( void * worker )
+{
+    assert( NULL != this );
+    delete reinterpret_cast< XmlWorker * >( worker );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * XmlBatch::GetName( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_name.c_str();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlBatch::GetResult( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_result;
+}
+
+// ----------------------------------------------------------------------------
+
+const XmlDocument & XmlBatch::GetDocument( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return *m_items[ index ]->m_document;
+}
+
+// ----------------------------------------------------------------------------
+
+const char * XmlBatch::GetMessages( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_messages.c_str();
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlBatch::GetMessageCount( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_items.size() );
+    return m_items[ index ]->m_messageCount;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,653 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlDocument.cpp Builds a tree of nodes from receiver calls.
+
+
+#include "../include/XmlDocument.hpp"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+#include <string>
+#include <vector>
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+/// Gives empty views a place to point.
+const char s_empty[] = "";
+
+/// Each array in the arena starts at a multiple of this.
+const size_t s_alignment = 8;
+
+// ----------------------------------------------------------------------------
+
+inline size_t RoundUp( size_t bytes )
+{
+    return ( bytes + s_alignment - 1 ) & ~( s_alignment - 1 );
+}
+
+// ----------------------------------------------------------------------------
+
+inline ::Parser::Xml::TextView MakeView( const char * begin, const char * end )
+{
+    ::Parser::Xml::TextView view = { begin, static_cast< unsigned long >( end - begin ) };
+    return view;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Adds code point to text as UTF-8.
+void AddUtf8( unsigned long code, ::std::string & text )
+{
+    if ( code < 0x80 )
+    {
+        text += static_cast< char >( code );
+    }
+    else if ( code < 0x800 )
+    {
+        text += static_cast< char >( 0xC0 | ( code >> 6 ) );
+        text += static_cast< char >( 0x80 | ( code & 0x3F ) );
+    }
+    else if ( code < 0x10000 )
+    {
+        text += static_cast< char >( 0xE0 | ( code >> 12 ) );
+        text += static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+        text += static_cast< char >( 0x80 | ( code & 0x3F ) );
+    }
+    else
+    {
+        text += static_cast< char >( 0xF0 | ( ( code >> 18 ) & 0x07 ) );
+        text += static_cast< char >( 0x80 | ( ( code >> 12 ) & 0x3F ) );
+        text += static_cast< char >( 0x80 | ( ( code >> 6 ) & 0x3F ) );
+        text += static_cast< char >( 0x80 | ( code & 0x3F ) );
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+/** Adds chars of one reference to text.  Char references and the five
+ predefined entities are replaced.  Other entities have no replacement text
+ without a DTD, so they are added as is.
+ @param begin Place of name after '&'.
+ @param end Place of ';' after name.
+ */
+void AddReference( const char * begin, const char * end, ::std::string & text )
+{
+    const unsigned long length = static_cast< unsigned long >( end - begin );
+    if ( ( 1 < length ) && ( '#' == *begin ) )
+    {
+        const bool hex = ( 'x' == begin[ 1 ] );
+        unsigned long code = 0;
+        for ( const char * here = begin + ( hex ? 2 : 1 ); here != end; ++here )
+        {
+            const char ch = *here;
+            unsigned long digit = 0;
+            if ( ( '0' <= ch ) && ( ch <= '9' ) )
+                digit = ch - '0';
+            else if ( hex && ( 'a' <= ch ) && ( ch <= 'f' ) )
+                digit = ch - 'a' + 10;
+            else if ( hex && ( 'A' <= ch ) && ( ch <= 'F' ) )
+                digit = ch - 'A' + 10;
+            code = code * ( hex ? 16 : 10 ) + digit;
+            if ( 0x10FFFF < code )
+                break;
+        }
+        if ( code <= 0x10FFFF )
+        {
+            AddUtf8( code, text );
+            return;
+        }
+    }
+    else if ( ( 2 == length ) && ( 't' == begin[ 1 ] ) && ( 'l' == *begin ) )
+    {
+        text += '<';
+        return;
+    }
+    else if ( ( 2 == length ) && ( 't' == begin[ 1 ] ) && ( 'g' == *begin ) )
+    {
+        text += '>';
+        return;
+    }
+    else if ( ( 3 == length ) && ( 0 == ::strncmp( begin, "amp", 3 ) ) )
+    {
+        text += '&';
+        return;
+    }
+    else if ( ( 4 == length ) && ( 0 == ::strncmp( begin, "apos", 4 ) ) )
+    {
+        text += '\'';
+        return;
+    }
+    else if ( ( 4 == length ) && ( 0 == ::strncmp( begin, "quot", 4 ) ) )
+    {
+        text += '"';
+        return;
+    }
+    text += '&';
+    text.append( begin, length );
+    text += ';';
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class DocumentBuilder
+ Receives every call made while parsing a document, and adds nodes and
+ attributes to growing arrays.  One builder acts as the receiver for every
+ node, and keeps a stack of open elements so each call goes to the innermost
+ one.  Text with references is replaced into separate strings, and its views
+ are left without a place until MoveTo puts all text into the arena.
+ */
+class DocumentBuilder : public IDocumentReceiver, public INodeReceiver
+{
+public:
+
+    DocumentBuilder( void );
+
+    virtual ~DocumentBuilder( void ) {}
+
+    virtual INodeReceiver * AddRoot( void );
+
+    /// Adds comment to innermost open element, or to document if none is open.
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool AddCDataSection( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    /// Moves nodes, attributes, and text into one block owned by document.
+    void MoveTo( XmlDocument & document );
+
+private:
+
+    /// Not implemented.
+    DocumentBuilder( const DocumentBuilder & );
+    /// Not implemented.
+    DocumentBuilder & operator = ( const DocumentBuilder & );
+
+    /// Adds node as last child of innermost open element, or of document.
+    unsigned long AddNode( DomNode::Kinds kind );
+
+    /// Returns view of chars, or of replaced chars if they have references.
+    TextView MakeText( const char * begin, const char * end, ::std::string & replaced );
+
+    ::std::vector< DomNode > m_nodes;
+    ::std::vector< DomAttribute > m_attributes;
+    /// Indexes of elements whose end tags were not found yet.
+    ::std::vector< unsigned long > m_open;
+    /// Replaced text of Text nodes, in order of nodes.
+    ::std::string m_texts;
+    /// Replaced attribute values, in order of attributes.
+    ::std::string m_values;
+    unsigned long m_root;
+    bool m_valid;
+    bool m_standalone;
+
+};
+
+// ----------------------------------------------------------------------------
+
+bool TextView::Equals( const char * text ) const
+{
+    assert( NULL != this );
+    assert( NULL != text );
+    return ( ::strlen( text ) == m_length )
+        && ( 0 == ::memcmp( m_begin, text, m_length ) );
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentBuilder::DocumentBuilder( void ) :
+    IDocumentReceiver(),
+    INodeReceiver(),
+    m_nodes(),
+    m_attributes(),
+    m_open(),
+    m_texts(),
+    m_values(),
+    m_root( XmlDocument::NoIndex ),
+    m_valid( false ),
+    m_standalone( false )
+{
+    assert( NULL != this );
+    AddNode( DomNode::Document );
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long DocumentBuilder::AddNode( DomNode::Kinds kind )
+{
+    assert( NULL != this );
+
+    const unsigned long index = static_cast< unsigned long >( m_nodes.size() );
+    DomNode node;
+    node.m_kind = kind;
+    node.m_name = MakeView( s_empty, s_empty );
+    node.m_text = node.m_name;
+    node.m_parent = XmlDocument::NoIndex;
+    node.m_firstChild = XmlDocument::NoIndex;
+    node.m_lastChild = XmlDocument::NoIndex;
+    node.m_nextSibling = XmlDocument::NoIndex;
+    node.m_firstAttribute = XmlDocument::NoIndex;
+    node.m_attributeCount = 0;
+
+    if ( DomNode::Document != kind )
+    {
+        node.m_parent = m_open.empty() ? 0 : m_open.back();
+        DomNode & parent = m_nodes[ node.m_parent ];
+        if ( XmlDocument::NoIndex == parent.m_lastChild )
+            parent.m_firstChild = index;
+        else
+            m_nodes[ parent.m_lastChild ].m_nextSibling = index;
+        parent.m_lastChild = index;
+    }
+    m_nodes.push_back( node );
+    return index;
+}
+
+// ----------------------------------------------------------------------------
+
+TextView DocumentBuilder::MakeText( const char * begin, const char * end,
+    ::std::string & replaced )
+{
+    assert( NULL != this );
+
+    const char * amp = static_cast< const char * >(
+        ::memchr( begin, '&', end - begin ) );
+    if ( NULL == amp )
+        return MakeView( begin, end );
+
+    const ::std::string::size_type start = replaced.size();
+    const char * here = begin;
+    while ( NULL != amp )
+    {
+        replaced.append( here, amp - here );
+        const char * semicolon = static_cast< const char * >(
+            ::memchr( amp, ';', end - amp ) );
+        if ( NULL == semicolon )
+        {
+            here = amp;
+            break;
+        }
+        AddReference( amp + 1, semicolon, replaced );
+        here = semicolon + 1;
+        amp = static_cast< const char * >( ::memchr( here, '&', end - here ) );
+    }
+    replaced.append( here, end - here );
+
+    // MoveTo gives this view its place once all text is in the arena.
+    TextView view = { NULL, static_cast< unsigned long >( replaced.size() - start ) };
+    return view;
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * DocumentBuilder::AddRoot( void )
+{
+    assert( NULL != this );
+    m_root = AddNode( DomNode::Element );
+    m_open.push_back( m_root );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    const unsigned long index = AddNode( DomNode::Comment );
+    m_nodes[ index ].m_text = MakeView( begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    m_standalone = standalone;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    (void)begin;
+    (void)end;
+    m_valid = valid;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    (void)begin;
+    (void)end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    m_nodes[ m_open.back() ].m_name = MakeView( begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    const unsigned long index = AddNode( DomNode::Text );
+    m_nodes[ index ].m_text = MakeText( begin, end, m_texts );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    const unsigned long index = AddNode( DomNode::CData );
+    m_nodes[ index ].m_text = MakeView( begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+
+    DomNode & element = m_nodes[ m_open.back() ];
+    if ( 0 == element.m_attributeCount )
+        element.m_firstAttribute = static_cast< unsigned long >( m_attributes.size() );
+    ++element.m_attributeCount;
+    DomAttribute attribute;
+    attribute.m_name = MakeView( begin, end );
+    attribute.m_value = MakeView( s_empty, s_empty );
+    m_attributes.push_back( attribute );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_attributes.empty() );
+    m_attributes.back().m_value = MakeText( begin, end, m_values );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * DocumentBuilder::AddChild( void )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    m_open.push_back( AddNode( DomNode::Element ) );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DocumentBuilder::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    (void)valid;
+    (void)begin;
+    (void)end;
+    m_open.pop_back();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void DocumentBuilder::MoveTo( XmlDocument & document )
+{
+    assert( NULL != this );
+    assert( NULL == document.m_arena );
+
+    const unsigned long nodeCount = static_cast< unsigned long >( m_nodes.size() );
+    const unsigned long attributeCount = static_cast< unsigned long >( m_attributes.size() );
+    const size_t nodeBytes = RoundUp( nodeCount * sizeof( DomNode ) );
+    const size_t attributeBytes = RoundUp( attributeCount * sizeof( DomAttribute ) );
+    const size_t size = nodeBytes + attributeBytes + m_texts.size() + m_values.size();
+    char * arena = static_cast< char * >( ::malloc( size ) );
+    if ( NULL == arena )
+        throw ::std::bad_alloc();
+
+    DomNode * nodes = reinterpret_cast< DomNode * >( arena );
+    DomAttribute * attributes = reinterpret_cast< DomAttribute * >( arena + nodeBytes );
+    char * texts = arena + nodeBytes + attributeBytes;
+    char * values = texts + m_texts.size();
+    ::memcpy( texts, m_texts.data(), m_texts.size() );
+    ::memcpy( values, m_values.data(), m_values.size() );
+
+    // Replaced text was added in the same order as the views which refer to it.
+    for ( unsigned long ii = 0; ii < nodeCount; ++ii )
+    {
+        nodes[ ii ] = m_nodes[ ii ];
+        TextView & text = nodes[ ii ].m_text;
+        if ( NULL == text.m_begin )
+        {
+            text.m_begin = texts;
+            texts += text.m_length;
+        }
+    }
+    for ( unsigned long ii = 0; ii < attributeCount; ++ii )
+    {
+        attributes[ ii ] = m_attributes[ ii ];
+        TextView & value = attributes[ ii ].m_value;
+        if ( NULL == value.m_begin )
+        {
+            value.m_begin = values;
+            values += value.m_length;
+        }
+    }
+
+    document.m_arena = arena;
+    document.m_arenaSize = size;
+    document.m_nodes = nodes;
+    document.m_nodeCount = nodeCount;
+    document.m_attributes = attributes;
+    document.m_attributeCount = attributeCount;
+    document.m_root = m_root;
+    document.m_valid = m_valid;
+    document.m_standalone = m_standalone;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlDocument::XmlDocument( void ) :
+    m_arena( NULL ),
+    m_arenaSize( 0 ),
+    m_nodes( NULL ),
+    m_nodeCount( 0 ),
+    m_attributes( NULL ),
+    m_attributeCount( 0 ),
+    m_root( NoIndex ),
+    m_valid( false ),
+    m_standalone( false )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlDocument::~XmlDocument( void )
+{
+    assert( NULL != this );
+    Clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlDocument::Clear( void )
+{
+    assert( NULL != this );
+    ::free( m_arena );
+    m_arena = NULL;
+    m_arenaSize = 0;
+    m_nodes = NULL;
+    m_nodeCount = 0;
+    m_attributes = NULL;
+    m_attributeCount = 0;
+    m_root = NoIndex;
+    m_valid = false;
+    m_standalone = false;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlDocument::Parse( XmlParser & parser,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    Clear();
+    DocumentBuilder builder;
+    const XmlParser::ParseResults result = parser.ParseDocument( begin, end, &builder );
+    builder.MoveTo( *this );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+const DomNode & XmlDocument::GetNode( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_nodeCount );
+    return m_nodes[ index ];
+}
+
+// ----------------------------------------------------------------------------
+
+const DomAttribute & XmlDocument::GetAttribute( unsigned long index ) const
+{
+    assert( NULL != this );
+    assert( index < m_attributeCount );
+    return m_attributes[ index ];
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlDocument::FindChild( unsigned long parent, const char * name ) const
+{
+    assert( NULL != this );
+    assert( parent < m_nodeCount );
+
+    unsigned long index = m_nodes[ parent ].m_firstChild;
+    while ( NoIndex != index )
+    {
+        const DomNode & node = m_nodes[ index ];
+        if ( ( DomNode::Element == node.m_kind ) && node.m_name.Equals( name ) )
+            break;
+        index = node.m_nextSibling;
+    }
+    return index;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlDocument::FindNextSibling( unsigned long node ) const
+{
+    assert( NULL != this );
+    assert( node < m_nodeCount );
+
+    const TextView & name = m_nodes[ node ].m_name;
+    unsigned long index = m_nodes[ node ].m_nextSibling;
+    while ( NoIndex != index )
+    {
+        const DomNode & sibling = m_nodes[ index ];
+        if ( ( DomNode::Element == sibling.m_kind )
+          && ( name.m_length == sibling.m_name.m_length )
+          && ( 0 == ::memcmp( name.m_begin, sibling.m_name.m_begin, name.m_length ) ) )
+            break;
+        index = sibling.m_nextSibling;
+    }
+    return index;
+}
+
+// ----------------------------------------------------------------------------
+
+const DomAttribute * XmlDocument::FindAttribute( unsigned long element,
+    const char * name ) const
+{
+    assert( NULL != this );
+    assert( element < m_nodeCount );
+
+    const DomNode & node = m_nodes[ element ];
+    for ( unsigned long ii = 0; ii < node.m_attributeCount; ++ii )
+    {
+        const DomAttribute & attribute = m_attributes[ node.m_firstAttribute + ii ];
+        if ( attribute.m_name.Equals( name ) )
+            return &attribute;
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
@@ -0,0 +1,490 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlEventBatcher.cpp Adds events from an xml parser to a buffer.
+
+
+#include "../include/XmlEventBatcher.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+const char * XmlEventBatcher::GetEventName( unsigned short kind )
+{
+    switch ( kind )
+    {
+        case StartElement:   return "StartElement";
+        case AttributeName:  return "AttributeName";
+        case AttributeValue: return "AttributeValue";
+        case ValueText:      return "ValueText";
+        case Reference:      return "Reference";
+        case TagEnd:         return "TagEnd";
+        case Text:           return "Text";
+        case CData:          return "CData";
+        case Comment:        return "Comment";
+        case EndElement:     return "EndElement";
+        case EndDocument:    return "EndDocument";
+        default: break;
+    }
+    return "Unknown";
+}
+
+// ----------------------------------------------------------------------------
+
+XmlEventWriter::XmlEventWriter( EventBuffer & buffer ) :
+    m_buffer( buffer ),
+    m_documentBegin( NULL ),
+    m_depth( 0 ),
+    m_startWaiting( false ),
+    m_nameBegin( NULL ),
+    m_nameEnd( NULL ),
+    m_gotValue( false ),
+    m_done( false )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlEventWriter::~XmlEventWriter( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlEventWriter::Begin( const char * begin )
+{
+    assert( NULL != this );
+    m_documentBegin = begin;
+    m_depth = 0;
+    m_startWaiting = false;
+    m_nameBegin = NULL;
+    m_nameEnd = NULL;
+    m_gotValue = false;
+    m_done = false;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::Finish( const char * end )
+{
+    assert( NULL != this );
+    if ( !m_done )
+        DoneDocument( false, m_documentBegin, end );
+    return m_buffer.Flush();
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::FinishAttribute( void )
+{
+    assert( NULL != this );
+    AddWaiting();
+    return m_buffer.Flush();
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddWaitingNow( void )
+{
+    assert( NULL != this );
+
+    bool keep = true;
+    if ( m_startWaiting )
+    {
+        // Element name was bad, so parser never gave it.
+        m_startWaiting = false;
+        keep = m_buffer.Add( XmlEventBatcher::StartElement, 0, NULL, NULL );
+    }
+    if ( NULL != m_nameBegin )
+    {
+        const char * const nameBegin = m_nameBegin;
+        m_nameBegin = NULL;
+        keep = m_buffer.Add( XmlEventBatcher::AttributeName, 0, nameBegin,
+            m_nameEnd ) && keep;
+    }
+    return keep;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddChild( void )
+{
+    assert( NULL != this );
+    if ( !AddWaiting() || m_buffer.IsStopped() )
+        return false;
+    // Name is not known yet, so SetElementName adds the StartElement.
+    ++m_depth;
+    m_startWaiting = true;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_startWaiting = false;
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::StartElement, 0,
+        begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    if ( !AddWaiting() )
+        return false;
+    // Waits for the value, so both go into the same batch.
+    m_nameBegin = begin;
+    m_nameEnd = end;
+    return !m_buffer.IsStopped();
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( begin <= end );
+
+    unsigned short flags = XmlEventBatcher::Valid;
+    if ( NULL != ::memchr( begin, '&', end - begin ) )
+        flags |= XmlEventBatcher::HasReference;
+    if ( NULL == m_nameBegin )
+        return AddWaiting() && m_buffer.Add( XmlEventBatcher::AttributeValue,
+            flags, begin, end );
+    const char * const nameBegin = m_nameBegin;
+    m_nameBegin = NULL;
+    return m_buffer.AddPair( XmlEventBatcher::AttributeName, 0, nameBegin, m_nameEnd,
+        XmlEventBatcher::AttributeValue, flags, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::TagEnd, 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::Text, 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::CData, 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::Comment, 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    if ( 0 < m_depth )
+        --m_depth;
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::EndElement,
+        valid ? XmlEventBatcher::Valid : 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_done = true;
+    AddWaiting();
+    for ( ; 0 < m_depth; --m_depth )
+        m_buffer.Add( XmlEventBatcher::EndElement, 0, end, end );
+    return m_buffer.Add( XmlEventBatcher::EndDocument,
+        valid ? XmlEventBatcher::Valid : 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::SetName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_gotValue = false;
+    return SetAttributeName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::ValueText, 0, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventWriter::AddReference( const char * begin, const char * end,
+    IReferenceReceiver::RefType refType )
+{
+    assert( NULL != this );
+    return AddWaiting() && m_buffer.Add( XmlEventBatcher::Reference,
+        static_cast< unsigned short >( refType ), begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlEventWriter::DoneAttributeValue( bool valid, bool singleQuoted,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( begin <= end );
+
+    // The value parser calls this with the quoted value, and then the
+    // attribute parser calls it again with the whole attribute.  If the value
+    // could not be parsed, only the second call comes.
+    if ( m_gotValue )
+        return;
+    m_gotValue = true;
+    if ( ( 2 <= end - begin ) && ( ( '"' == *begin ) || ( '\'' == *begin ) )
+      && ( *begin == end[ -1 ] ) )
+    {
+        ++begin;
+        --end;
+    }
+    unsigned short flags = valid ? XmlEventBatcher::Valid : 0;
+    if ( singleQuoted )
+        flags |= XmlEventBatcher::SingleQuoted;
+    if ( NULL != ::memchr( begin, '&', end - begin ) )
+        flags |= XmlEventBatcher::HasReference;
+    AddWaiting();
+    m_buffer.Add( XmlEventBatcher::AttributeValue, flags, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlEventBatcher::XmlEventBatcher( EventBuffer & buffer ) :
+    IDocumentReceiver(),
+    INodeReceiver(),
+    IAttributeReceiver(),
+    m_buffer( buffer ),
+    m_writer( buffer )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlEventBatcher::~XmlEventBatcher( void )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlEventBatcher::ParseDocument( XmlParser & parser,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+    // Rules add events straight to the buffer, with no call to this for each.
+    return parser.ParseDocument( begin, end, m_buffer );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlEventBatcher::ParseAttribute( XmlParser & parser,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return parser.ParseAttribute( begin, end, m_buffer );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlEventBatcher::Begin( const char * documentBegin )
+{
+    assert( NULL != this );
+    m_writer.Begin( documentBegin );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::Finish( const char * end )
+{
+    assert( NULL != this );
+    return m_writer.Finish( end );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * XmlEventBatcher::AddRoot( void )
+{
+    assert( NULL != this );
+    return AddChild();
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * XmlEventBatcher::AddChild( void )
+{
+    assert( NULL != this );
+    return ( m_writer.AddChild() ) ? this : NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.SetElementName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.SetAttributeName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.SetAttributeValue( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.SetTagName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.AddCData( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.AddCDataSection( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.AddComment( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.DoneNode( valid, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    (void)standalone;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.DoneDocument( valid, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::SetName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.SetName( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::AddValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    return m_writer.AddValue( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlEventBatcher::AddReference( const char * begin, const char * end,
+    RefType refType )
+{
+    assert( NULL != this );
+    return m_writer.AddReference( begin, end, refType );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlEventBatcher::DoneAttributeValue( bool valid, bool singleQuoted,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+    m_writer.DoneAttributeValue( valid, singleQuoted, begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
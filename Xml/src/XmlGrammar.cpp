@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+
+// ----------------------------------------------------------------------------
+
+#include "./XmlGrammar.hpp"
+
+#include <assert.h>
+
+#if defined( _WIN32 )
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+
+namespace
+{
+
+#if defined( _WIN32 )
+
+/// Nonzero while a thread is building the grammar.
+volatile LONG s_busy = 0;
+
+#else
+
+pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#endif
+
+// ----------------------------------------------------------------------------
+
+/// Keeps other threads out while the grammar is built.
+class GrammarLock
+{
+public:
+
+    inline GrammarLock( void )
+    {
+#if defined( _WIN32 )
+        while ( 0 != ::InterlockedExchange( &s_busy, 1 ) )
+            ::Sleep( 0 );
+#else
+        ::pthread_mutex_lock( &s_mutex );
+#endif
+    }
+
+    inline ~GrammarLock( void )
+    {
+#if defined( _WIN32 )
+        ::InterlockedExchange( &s_busy, 0 );
+#else
+        ::pthread_mutex_unlock( &s_mutex );
+#endif
+    }
+
+private:
+    GrammarLock( const GrammarLock & );
+    GrammarLock & operator = ( const GrammarLock & );
+};
+
+}; // end anonymous namespace
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+
+// ----------------------------------------------------------------------------
+
+XmlGrammar * XmlGrammar::s_instance = NULL;
+
+// ----------------------------------------------------------------------------
+
+void XmlGrammar::Build( void )
+{
+    GrammarLock lock;
+    if ( s_instance == NULL )
+    {
+        // The sub-parser rules use the common rules while they are built.
+        // Neither is ever released, so both last until the process ends.
+        CommonParserRules::IncReference();
+        s_instance = new XmlGrammar;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+XmlGrammar::XmlGrammar( void ) :
+    m_comment(),
+    m_publicIdLiteral(),
+    m_externalIdLiteral( m_publicIdLiteral ),
+    m_name(),
+    m_peRef( m_name ),
+    m_reference( m_name ),
+    m_attributeValue( m_reference ),
+    m_attribute( m_name, m_attributeValue ),
+    m_enumeratedType( m_name ),
+    m_entityValue( m_reference, m_peRef ),
+    m_encodingDecl(),
+    m_xmlDeclaration( m_encodingDecl ),
+    m_attListDecl( m_name, m_enumeratedType, m_attributeValue ),
+    m_node( m_name, m_attribute, m_comment ),
+    m_document( m_node, m_comment, m_xmlDeclaration )
+{
+    assert( this != NULL );
+    assert( s_instance == NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
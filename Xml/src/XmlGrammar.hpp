@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+#ifndef PARSER_XML_GRAMMAR_H_INCLUDED
+#define PARSER_XML_GRAMMAR_H_INCLUDED
+
+
+// ----------------------------------------------------------------------------
+
+#include "./BasicParsers.hpp"
+#include "./PrologParsers.hpp"
+#include "./NodeParsers.hpp"
+
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+
+// ----------------------------------------------------------------------------
+
+/** @class XmlGrammar
+ Holds the rules of every XML sub-parser.  The rules are built once, when the
+ first XmlParser is made, and are shared by all XmlParsers after that until the
+ process ends, so making a parser for each request never rebuilds them.  None of
+ the rules hold a pointer to a parser, since their actions find the parse
+ running on the current thread, so the rules never change after they are
+ built and any number of threads may parse with them at once.  This makes an
+ XmlParser cheap to construct: it only makes the small objects which hold the
+ state of a parse.
+ */
+class XmlGrammar
+{
+public:
+
+    /// Builds the grammar if no XmlParser was made yet.  Safe on any thread.
+    static void Build( void );
+
+    static const XmlGrammar & GetIt( void ) { return *s_instance; }
+
+    const CommentParser::Rules           m_comment;
+    const PublicIdLiteralParser::Rules   m_publicIdLiteral;
+    const ExternalIdLiteralParser::Rules m_externalIdLiteral;
+    const NameParser::Rules              m_name;
+    const PeReferenceParser::Rules       m_peRef;
+    const ReferenceParser::Rules         m_reference;
+    const AttributeValueParser::Rules    m_attributeValue;
+    const AttributeParser::Rules         m_attribute;
+    const EnumeratedTypeParser::Rules    m_enumeratedType;
+    const EntityValueParser::Rules       m_entityValue;
+    const EncodingDeclParser::Rules      m_encodingDecl;
+    const XmlDeclarationParser::Rules    m_xmlDeclaration;
+    const AttListDeclParser::Rules       m_attListDecl;
+    const NodeParser::Rules              m_node;
+    const DocumentParser::Rules          m_document;
+
+private:
+
+    XmlGrammar( void );
+
+    /// Not implemented, since the grammar is never destroyed.
+    ~XmlGrammar( void );
+
+    XmlGrammar( const XmlGrammar & );
+    XmlGrammar & operator = ( const XmlGrammar & );
+
+    static XmlGrammar * s_instance;
+
+}; // end class XmlGrammar
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+#endif // file guardian
+
+// $Log: $
@@ -14,9 +14,12 @@
 
 
 #include "../include/XmlParser.hpp"
+#include "../include/XmlScanners.hpp"
+#include "../include/XmlEventBatcher.hpp"
+
+#include <string.h>
 
 #include <string>
-#include <fstream>
 #include <sstream>
 #include <vector>
 #include <strstream>
@@ -24,13 +27,15 @@
 #include <boost/spirit.hpp>
 #include <boost/spirit/core.hpp>
 
-#include <loki/SafeFormat.h>
-
 #include "../../Util/include/ParseUtil.hpp"
 #include "../../Util/include/ParseInfo.hpp"
+#include "../../Util/include/FileBuffer.hpp"
 
 #include "./BasicParsers.hpp"
 #include "./PrologParsers.hpp"
+#include "./NodeParsers.hpp"
+#include "./DocumentFeeder.hpp"
+#include "./XmlGrammar.hpp"
 
 
 #ifdef DEBUG
@@ -41,6 +46,12 @@
 
 DEBUG_CODE( #include <iostream> )
 
+#if defined( _MSC_VER )
+    #define PARSER_THREAD_LOCAL __declspec( thread )
+#else
+    #define PARSER_THREAD_LOCAL __thread
+#endif
+
 
 using namespace std;
 using namespace boost::spirit;
@@ -49,46 +60,6 @@ typedef std::vector< Parser::CharType > TCharBuffer;
 
 
 
-// ChangeEmbeddedNils ---------------------------------------------------------
-
-bool ChangeEmbeddedNils( string & ss, Parser::CharType ch = ' ' )
-{
-
-    bool found = false;
-    string::iterator here( ss.begin() );
-    string::iterator last( ss.end() );
-    while ( here != last )
-    {
-        if ( '\0' == *here )
-        {
-            found = true;
-            *here = ch;
-        }
-        ++here;
-    }
-
-    return found;
-}
-
-// ReadFileIntoString ---------------------------------------------------------
-
-bool ReadFileIntoString( const char * filename, string & target )
-{
-
-    target.clear();
-    ifstream input( filename );
-    if ( input.fail() ) return false;
-    input.unsetf( ios::skipws ); // Must turn off whitespace skipping.
-
-    istream_iterator< Parser::CharType > begin( input );
-    istream_iterator< Parser::CharType > end;
-    string temp( begin, end );
-    ChangeEmbeddedNils( temp );
-    temp.swap( target );
-
-    return true;
-}
-
 // ----------------------------------------------------------------------------
 
 namespace Parser
@@ -126,6 +97,259 @@ inline bool IsGoodResult( XmlParser::ParseResults result )
 
 // ----------------------------------------------------------------------------
 
+/** @class ParseState
+ Everything which changes while an XmlParser parses.  Each XmlParser has its
+ own, while the rules it parses with come from the shared XmlGrammar.  Actions
+ within those rules find the sub-parsers of the parse running on their thread
+ through a Scope, so a receiver may even start another parse on the same
+ thread without disturbing this one.
+ */
+class ParseState
+{
+public:
+
+    ParseState( Parser::IStackMessagePreparer * preparer,
+        const XmlGrammar & grammar );
+
+    ~ParseState( void );
+
+    /// Returns state of the parse running on this thread.
+    static ParseState & Current( void );
+
+    /// Makes a ParseState current on this thread until the Scope ends.
+    class Scope
+    {
+    public:
+        explicit Scope( ParseState & state );
+        ~Scope( void );
+    private:
+        Scope( const Scope & );
+        Scope & operator = ( const Scope & );
+        ParseState * m_previous;
+    };
+
+    ParserStacks m_stacks;
+    Parser::ParseInfo m_results;
+    /// True to try the FastScanParser scanners before the Spirit rules.
+    bool m_fastScanning;
+
+    CommentParser           m_commentParser;
+    PublicIdLiteralParser   m_publicIdLiteralParser;
+    ExternalIdLiteralParser m_externalIdLiteralParser;
+    NameParser              m_nameParser;
+    PeReferenceParser       m_peRefParser;
+    ReferenceParser         m_referenceParser;
+    AttributeValueParser    m_attributeValueParser;
+    AttributeParser         m_attributeParser;
+    EnumeratedTypeParser    m_enumeratedTypeParser;
+    EntityValueParser       m_entityValueParser;
+    EncodingDeclParser      m_encodingDeclParser;
+    XmlDeclarationParser    m_xmlDeclarationParser;
+    AttListDeclParser       m_attListDeclParser;
+    NodeParser              m_nodeParser;
+    DocumentParser          m_documentParser;
+    DocumentFeeder          m_documentFeeder;
+
+private:
+
+    ParseState( void );
+    ParseState( const ParseState & );
+    ParseState & operator = ( const ParseState & );
+
+}; // end class ParseState
+
+// ----------------------------------------------------------------------------
+
+/// State of the parse running on each thread, or NULL if none is running.
+static PARSER_THREAD_LOCAL ParseState * s_currentState = NULL;
+
+// ----------------------------------------------------------------------------
+
+ParseState::ParseState( Parser::IStackMessagePreparer * preparer,
+    const XmlGrammar & grammar ) :
+    m_stacks( preparer ),
+    m_results( &m_stacks.m_messages, &m_stacks.m_content ),
+    m_fastScanning( true ),
+    m_commentParser( grammar.m_comment, m_stacks ),
+    m_publicIdLiteralParser( grammar.m_publicIdLiteral, m_stacks ),
+    m_externalIdLiteralParser( grammar.m_externalIdLiteral,
+        m_publicIdLiteralParser ),
+    m_nameParser( grammar.m_name, m_stacks ),
+    m_peRefParser( grammar.m_peRef, m_nameParser ),
+    m_referenceParser( grammar.m_reference, m_nameParser ),
+    m_attributeValueParser( grammar.m_attributeValue, m_referenceParser ),
+    m_attributeParser( grammar.m_attribute, m_nameParser,
+        m_attributeValueParser ),
+    m_enumeratedTypeParser( grammar.m_enumeratedType, m_nameParser ),
+    m_entityValueParser( grammar.m_entityValue, m_referenceParser,
+        m_peRefParser ),
+    m_encodingDeclParser( grammar.m_encodingDecl, m_stacks ),
+    m_xmlDeclarationParser( grammar.m_xmlDeclaration, m_encodingDeclParser ),
+    m_attListDeclParser( grammar.m_attListDecl, m_enumeratedTypeParser,
+        m_attributeValueParser ),
+    m_nodeParser( grammar.m_node, m_nameParser, m_attributeParser,
+        m_commentParser ),
+    m_documentParser( grammar.m_document, m_nodeParser, m_commentParser,
+        m_xmlDeclarationParser ),
+    m_documentFeeder( m_documentParser )
+{
+    assert( this != NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+ParseState::~ParseState( void )
+{
+    assert( this != NULL );
+    assert( s_currentState != this );
+}
+
+// ----------------------------------------------------------------------------
+
+ParseState & ParseState::Current( void )
+{
+    assert( NULL != s_currentState );
+    return *s_currentState;
+}
+
+// ----------------------------------------------------------------------------
+
+ParseState::Scope::Scope( ParseState & state ) :
+    m_previous( s_currentState )
+{
+    assert( this != NULL );
+    s_currentState = &state;
+}
+
+// ----------------------------------------------------------------------------
+
+ParseState::Scope::~Scope( void )
+{
+    assert( this != NULL );
+    s_currentState = m_previous;
+}
+
+// ----------------------------------------------------------------------------
+
+ParserStacks & GetCurrentStacks( void )
+{
+    return ParseState::Current().m_stacks;
+}
+
+// ----------------------------------------------------------------------------
+
+bool IsFastScanning( void )
+{
+    return ParseState::Current().m_fastScanning;
+}
+
+// ----------------------------------------------------------------------------
+
+CommentParser & CommentParser::Current( void )
+{
+    return ParseState::Current().m_commentParser;
+}
+
+// ----------------------------------------------------------------------------
+
+PublicIdLiteralParser & PublicIdLiteralParser::Current( void )
+{
+    return ParseState::Current().m_publicIdLiteralParser;
+}
+
+// ----------------------------------------------------------------------------
+
+ExternalIdLiteralParser & ExternalIdLiteralParser::Current( void )
+{
+    return ParseState::Current().m_externalIdLiteralParser;
+}
+
+// ----------------------------------------------------------------------------
+
+NameParser & NameParser::Current( void )
+{
+    return ParseState::Current().m_nameParser;
+}
+
+// ----------------------------------------------------------------------------
+
+PeReferenceParser & PeReferenceParser::Current( void )
+{
+    return ParseState::Current().m_peRefParser;
+}
+
+// ----------------------------------------------------------------------------
+
+ReferenceParser & ReferenceParser::Current( void )
+{
+    return ParseState::Current().m_referenceParser;
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeValueParser & AttributeValueParser::Current( void )
+{
+    return ParseState::Current().m_attributeValueParser;
+}
+
+// ----------------------------------------------------------------------------
+
+AttributeParser & AttributeParser::Current( void )
+{
+    return ParseState::Current().m_attributeParser;
+}
+
+// ----------------------------------------------------------------------------
+
+EnumeratedTypeParser & EnumeratedTypeParser::Current( void )
+{
+    return ParseState::Current().m_enumeratedTypeParser;
+}
+
+// ----------------------------------------------------------------------------
+
+EntityValueParser & EntityValueParser::Current( void )
+{
+    return ParseState::Current().m_entityValueParser;
+}
+
+// ----------------------------------------------------------------------------
+
+EncodingDeclParser & EncodingDeclParser::Current( void )
+{
+    return ParseState::Current().m_encodingDeclParser;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlDeclarationParser & XmlDeclarationParser::Current( void )
+{
+    return ParseState::Current().m_xmlDeclarationParser;
+}
+
+// ----------------------------------------------------------------------------
+
+AttListDeclParser & AttListDeclParser::Current( void )
+{
+    return ParseState::Current().m_attListDeclParser;
+}
+
+// ----------------------------------------------------------------------------
+
+NodeParser & NodeParser::Current( void )
+{
+    return ParseState::Current().m_nodeParser;
+}
+
+// ----------------------------------------------------------------------------
+
+DocumentParser & DocumentParser::Current( void )
+{
+    return ParseState::Current().m_documentParser;
+}
+
+// ----------------------------------------------------------------------------
+
 class XmlParserImpl : public Parser::IStackMessagePreparer
 {
 public:
@@ -137,6 +361,13 @@ public:
     void SetErrorReceiver( Parser::IParseErrorReceiver * receiver )
     { m_errorReceiver = receiver; }
 
+    bool IsFastScanning( void ) const { return m_state.m_fastScanning; }
+    void SetFastScanning( bool fast )
+    {
+        if ( !m_parsing )
+            m_state.m_fastScanning = fast;
+    }
+
     bool IsReady( void ) const
     {
         return ( NULL != m_errorReceiver ) && ( !m_parsing );
@@ -172,99 +403,201 @@ public:
     inline XmlParser::ParseResults ParseComment( const char * begin,
         const char * end, ICommentReceiver * receiver )
     {
-        return DoParse( begin, end, m_commentParser, receiver );
+        return DoParse( begin, end, m_state.m_commentParser, receiver );
     }
 
     inline XmlParser::ParseResults ParsePublicIdLiteral( const char * begin,
         const char * end, IPublicIdReceiver * receiver )
     {
-        return DoParse( begin, end, m_publicIdLiteralParser, receiver );
+        return DoParse( begin, end, m_state.m_publicIdLiteralParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseExternalId( const char * begin,
         const char * end, IExternalIdReceiver * receiver )
     {
-        return DoParse( begin, end, m_externalIdLiteralParser, receiver );
+        return DoParse( begin, end, m_state.m_externalIdLiteralParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseName( const CharType * begin,
         const CharType * end, INameReceiver * receiver )
     {
-        return DoParse( begin, end, m_nameParser, receiver );
+        return DoParse( begin, end, m_state.m_nameParser, receiver );
     }
 
     inline XmlParser::ParseResults ParsePeReference(
         const char * begin, const char * end, IPeReferenceReceiver * receiver )
     {
-        return DoParse( begin, end, m_peRefParser, receiver );
+        return DoParse( begin, end, m_state.m_peRefParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseReference(
         const char * begin, const char * end, IReferenceReceiver * receiver )
     {
-        return DoParse( begin, end, m_referenceParser, receiver );
+        return DoParse( begin, end, m_state.m_referenceParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseAttributeValue( const char * begin,
         const char * end, IAttributeValueReceiver * receiver )
     {
-        return DoParse( begin, end, m_attributeValueParser, receiver );
+        return DoParse( begin, end, m_state.m_attributeValueParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseAttribute( const CharType * begin,
         const CharType * end, IAttributeReceiver * receiver )
     {
-        return DoParse( begin, end, m_attributeParser, receiver );
+        return DoParse( begin, end, m_state.m_attributeParser, receiver );
     }
 
+    inline XmlParser::ParseResults ParseAttribute( const CharType * begin,
+        const CharType * end, XmlEventWriter & events )
+    {
+        return DoParseEvents( begin, end, m_state.m_attributeParser, events );
+    }
+
     inline XmlParser::ParseResults ParseEnumeratedType( const CharType * begin,
         const CharType * end, IEnumeratedTypeReceiver * receiver )
     {
-        return DoParse( begin, end, m_enumeratedTypeParser, receiver );
+        return DoParse( begin, end, m_state.m_enumeratedTypeParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseEntityValue( const CharType * begin,
         const CharType * end, IEntityValueReceiver * receiver )
     {
-        return DoParse( begin, end, m_entityValueParser, receiver );
+        return DoParse( begin, end, m_state.m_entityValueParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseEncoding( const CharType * begin,
         const CharType * end, IEncodingDeclReceiver * receiver )
     {
-        return DoParse( begin, end, m_encodingDeclParser, receiver );
+        return DoParse( begin, end, m_state.m_encodingDeclParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseXmlDeclaration( const CharType * begin,
         const CharType * end, IXmlDeclarationReceiver * receiver )
     {
-        return DoParse( begin, end, m_xmlDeclarationParser, receiver );
+        return DoParse( begin, end, m_state.m_xmlDeclarationParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseAttListDecl( const CharType * begin,
         const CharType * end, IAttListDeclReceiver * receiver )
     {
-        return DoParse( begin, end, m_attListDeclParser, receiver );
+        return DoParse( begin, end, m_state.m_attListDeclParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseNode( const CharType * begin,
         const CharType * end, INodeReceiver * receiver )
     {
-        (void)begin;
-        (void)end;
-        (void)receiver;
-        return XmlParser::NotValid;
+        return DoParse( begin, end, m_state.m_nodeParser, receiver );
     }
 
     inline XmlParser::ParseResults ParseDocument( const CharType * begin,
         const CharType * end, IDocumentReceiver * receiver )
     {
-        (void)begin;
-        (void)end;
-        (void)receiver;
-        return XmlParser::NotValid;
+        return DoParse( begin, end, m_state.m_documentParser, receiver );
+    }
+
+    inline XmlParser::ParseResults ParseDocument( const CharType * begin,
+        const CharType * end, XmlEventWriter & events )
+    {
+        return DoParseEvents( begin, end, m_state.m_documentParser, events );
     }
 
+    XmlParser::ParseResults ParseStartTag( const CharType * begin,
+        const CharType * end, INodeReceiver * receiver );
+
+    inline XmlParser::ParseResults StartFeeding( IDocumentReceiver * receiver )
+    {
+        if ( !IsReady() )
+            return XmlParser::NotReady;
+        Setup();
+        ParseState::Scope scope( m_state );
+        m_state.m_documentFeeder.Start( receiver );
+        return XmlParser::AllValid;
+    }
+
+    inline XmlParser::ParseResults Feed( const CharType * begin,
+        const CharType * end )
+    {
+        if ( !m_state.m_documentFeeder.IsFeeding() )
+            return XmlParser::NotReady;
+        if ( NULL == begin )
+            return XmlParser::NullStart;
+        if ( NULL == end )
+            return XmlParser::NullEnd;
+        if ( end < begin )
+            return XmlParser::EndTooLow;
+        if ( end == begin )
+            return XmlParser::EmptyData;
+        ParseState::Scope scope( m_state );
+        try
+        {
+            m_state.m_documentFeeder.Feed( begin, end );
+        }
+        catch ( ... )
+        {
+            m_state.m_documentFeeder.Cancel();
+            Cleanup();
+            throw;
+        }
+        return ( m_state.m_documentFeeder.IsValid() ) ?
+            XmlParser::AllValid : XmlParser::NotValid;
+    }
+
+    inline XmlParser::ParseResults Finish( void )
+    {
+        if ( !m_state.m_documentFeeder.IsFeeding() )
+            return XmlParser::NotReady;
+        Cleaner cleaner( this );
+        if ( !m_state.m_documentFeeder.HasData() )
+        {
+            // Nothing to parse, so the receiver gets no calls, as when an
+            // empty document is parsed in one pass.
+            m_state.m_documentFeeder.Cancel();
+            return XmlParser::EmptyData;
+        }
+        ParseState::Scope scope( m_state );
+        try
+        {
+            m_state.m_documentFeeder.Finish();
+        }
+        catch ( ... )
+        {
+            m_state.m_documentFeeder.Cancel();
+            throw;
+        }
+        return ( m_state.m_documentFeeder.IsValid() ) ?
+            XmlParser::AllValid : XmlParser::NotValid;
+    }
+
+    XmlParser::ParseResults ParsePiece( const CharType * tagsBegin,
+        const CharType * tagsEnd, const CharType * begin, const CharType * end,
+        bool finishing, IDocumentReceiver * receiver );
+
+    inline const CharType * FeedItem( const CharType * begin, const CharType * end )
+    {
+        if ( !m_state.m_documentFeeder.IsFeeding() )
+            return NULL;
+        ParseState::Scope scope( m_state );
+        try
+        {
+            return m_state.m_documentFeeder.FeedItem( begin, end );
+        }
+        catch ( ... )
+        {
+            m_state.m_documentFeeder.Cancel();
+            Cleanup();
+        }
+        return NULL;
+    }
+
+    inline void CancelFeeding( void )
+    {
+        if ( !m_state.m_documentFeeder.IsFeeding() )
+            return;
+        m_state.m_documentFeeder.Cancel();
+        Cleanup();
+    }
+
 private:
 
     XmlParserImpl( const XmlParserImpl & );
@@ -296,9 +629,10 @@ private:
 
         Cleaner cleaner( this );
         Setup();
+        ParseState::Scope scope( m_state );
         parser.SetReceiver( receiver );
         const SpiritRule & rule = parser.GetRule();
-        const ParseInfo::ParseResult rawResult = m_results.Parse( begin, end, rule );
+        const ParseInfo::ParseResult rawResult = m_state.m_results.Parse( begin, end, rule );
         XmlParser::ParseResults result( Convert( rawResult ) );
         if ( IsGoodResult( result ) )
         {
@@ -307,8 +641,53 @@ private:
         }
 
         return result;
+    }
+
+    /// Same as DoParse, but the rules add events to a writer instead of
+    /// calling a receiver.
+    template < class MyParser >
+    inline XmlParser::ParseResults DoParseEvents( const CharType * begin,
+        const CharType * end, MyParser & parser, XmlEventWriter & events )
+    {
+        Cleaner cleaner( this );
+        Setup();
+        ParseState::Scope scope( m_state );
+        parser.SetEventWriter( &events );
+        ParseInfo::ParseResult rawResult = ParseInfo::NotParsed;
+        try
+        {
+            rawResult = m_state.m_results.Parse( begin, end, parser.GetRule() );
+        }
+        catch ( ... )
+        {
+            DropEventWriter();
+            throw;
+        }
+        DropEventWriter();
+        XmlParser::ParseResults result( Convert( rawResult ) );
+        if ( IsGoodResult( result ) )
+        {
+            if ( !parser.IsValid() )
+                result = XmlParser::NotValid;
+        }
+        return result;
+    }
+
+    /// Writer only lives for one parse, so no parser may keep it.
+    inline void DropEventWriter( void )
+    {
+        m_state.m_documentParser.SetReceiver( NULL );
+        m_state.m_nodeParser.SetReceiver( NULL );
+        m_state.m_attributeParser.SetReceiver( NULL );
+        m_state.m_attributeValueParser.SetReceiver( NULL );
     }
 
+    /// Gives message to receiver, and stops sending if receiver fails.
+    bool GiveMessage( const Parser::ParseMessage & message );
+
+    /// Counts errors, and throws once there are too many.
+    void CountError( Parser::ErrorLevel::Levels level );
+
     bool PrepareErrorMessage( Parser::ErrorLevel::Levels level,
         const CharType * message );
 
@@ -328,22 +707,7 @@ private:
     unsigned long m_maxErrorCount;
 
     Parser::IParseErrorReceiver * m_errorReceiver;
-    ParserStacks m_stacks;
-    Parser::ParseInfo m_results;
-
-    CommentParser           m_commentParser;
-    PublicIdLiteralParser   m_publicIdLiteralParser;
-    ExternalIdLiteralParser m_externalIdLiteralParser;
-    NameParser              m_nameParser;
-    PeReferenceParser       m_peRefParser;
-    ReferenceParser         m_referenceParser;
-    AttributeValueParser    m_attributeValueParser;
-    AttributeParser         m_attributeParser;
-    EnumeratedTypeParser    m_enumeratedTypeParser;
-    EntityValueParser       m_entityValueParser;
-    EncodingDeclParser      m_encodingDeclParser;
-    XmlDeclarationParser    m_xmlDeclarationParser;
-    AttListDeclParser       m_attListDeclParser;
+    ParseState m_state;
 
 }; // end class XmlParserImpl
 
@@ -355,21 +719,7 @@ XmlParserImpl::XmlParserImpl() :
     m_errorCount( 0 ),
     m_maxErrorCount( 100 ),
     m_errorReceiver( NULL ),
-    m_stacks( this ),
-    m_results( &m_stacks.m_messages, &m_stacks.m_content ),
-    m_commentParser( m_stacks ),
-    m_publicIdLiteralParser( m_stacks ),
-    m_externalIdLiteralParser( m_publicIdLiteralParser ),
-    m_nameParser( m_stacks ),
-    m_peRefParser( m_nameParser ),
-    m_referenceParser( m_nameParser ),
-    m_attributeValueParser( m_referenceParser ),
-    m_attributeParser( m_nameParser, m_attributeValueParser ),
-    m_enumeratedTypeParser( m_nameParser ),
-    m_entityValueParser( m_referenceParser, m_peRefParser ),
-    m_encodingDeclParser( m_stacks ),
-    m_xmlDeclarationParser( m_encodingDeclParser ),
-    m_attListDeclParser( m_enumeratedTypeParser, m_attributeValueParser )
+    m_state( this, XmlGrammar::GetIt() )
 {
     assert( this != NULL );
 }
@@ -389,14 +739,70 @@ void XmlParserImpl::Setup( void )
     assert( this != NULL );
     m_parsing = true;
     m_errorCount = 0;
-    m_stacks.m_messages.SetPreparer( this );
-    m_stacks.m_content.SetPreparer( this );
+    m_state.m_stacks.m_messages.SetPreparer( this );
+    m_state.m_stacks.m_content.SetPreparer( this );
 }
 
 // ----------------------------------------------------------------------------
 
-bool XmlParserImpl::PrepareErrorMessage( Parser::ErrorLevel::Levels level,
-    const CharType * message )
+XmlParser::ParseResults XmlParserImpl::ParsePiece( const CharType * tagsBegin,
+    const CharType * tagsEnd, const CharType * begin, const CharType * end,
+    bool finishing, IDocumentReceiver * receiver )
+{
+    assert( this != NULL );
+
+    Cleaner cleaner( this );
+    Setup();
+    ParseState::Scope scope( m_state );
+    DocumentFeeder & feeder = m_state.m_documentFeeder;
+    bool valid = false;
+    try
+    {
+        feeder.Start( receiver );
+        feeder.FeedItems( tagsBegin, tagsEnd );
+        feeder.FeedItems( begin, end );
+        if ( finishing )
+            feeder.Finish();
+        // An element still open at the end of a piece is checked only when
+        // the piece which closes it is parsed.
+        valid = feeder.IsValid() && ( !m_state.m_nodeParser.IsOpen()
+            || m_state.m_nodeParser.IsValid() );
+        if ( !finishing )
+            feeder.Cancel();
+    }
+    catch ( ... )
+    {
+        feeder.Cancel();
+        throw;
+    }
+    return ( valid ) ? XmlParser::AllValid : XmlParser::NotValid;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParserImpl::ParseStartTag( const CharType * begin,
+    const CharType * end, INodeReceiver * receiver )
+{
+    assert( this != NULL );
+
+    Cleaner cleaner( this );
+    Setup();
+    ParseState::Scope scope( m_state );
+    NodeParser & parser = m_state.m_nodeParser;
+    // As the first item of an element, so an empty tag closes its element and
+    // a start tag leaves it open without asking for the end tag.
+    parser.BeginItems( receiver );
+    const ParseInfo::ParseResult rawResult = m_state.m_results.Parse( begin, end,
+        parser.GetStartTagRule() );
+    XmlParser::ParseResults result( Convert( rawResult ) );
+    if ( IsGoodResult( result ) && !parser.IsValid() )
+        result = XmlParser::NotValid;
+    parser.SetReceiver( NULL );
+    return result;
+}
+// ----------------------------------------------------------------------------
+
+bool XmlParserImpl::GiveMessage( const Parser::ParseMessage & message )
 {
     assert( this != NULL );
 
@@ -405,7 +811,7 @@ bool XmlParserImpl::PrepareErrorMessage( Parser::ErrorLevel::Levels level,
     bool okay = false;
     try
     {
-        okay = m_errorReceiver->GiveParseMessage( level, message );
+        okay = m_errorReceiver->ReceiveParseMessage( message );
         if ( !okay )
             m_errorReceiver = NULL;
     }
@@ -414,81 +820,66 @@ bool XmlParserImpl::PrepareErrorMessage( Parser::ErrorLevel::Levels level,
         m_errorReceiver = NULL;
         // throw exception back up to indicate Parser::ErrorLevel::Except
     }
+    return okay;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlParserImpl::CountError( Parser::ErrorLevel::Levels level )
+{
+    assert( this != NULL );
+
     if ( Parser::ErrorLevel::Minor <= level )
     {
         ++m_errorCount;
         if ( m_maxErrorCount <= m_errorCount )
             throw Parser::XMaxErrorException();
     }
-
-    return okay;
 }
 
 // ----------------------------------------------------------------------------
 
 bool XmlParserImpl::PrepareErrorMessage( Parser::ErrorLevel::Levels level,
-    const CharType * begin, const CharType * end )
+    const CharType * message )
 {
     assert( this != NULL );
 
     if ( NULL == m_errorReceiver )
         return false;
-    string message( begin, end-begin );
-    return PrepareErrorMessage( level, message.c_str() );
+    const bool okay = GiveMessage( Parser::ParseMessage( level, message ) );
+    CountError( level );
+    return okay;
 }
 
 // ----------------------------------------------------------------------------
 
-bool XmlParserImpl::PrepareContentMessage( const CharType * section )
+bool XmlParserImpl::PrepareErrorMessage( Parser::ErrorLevel::Levels level,
+    const CharType * begin, const CharType * end )
 {
     assert( this != NULL );
 
     if ( NULL == m_errorReceiver )
         return false;
-    bool okay = false;
-    try
-    {
-        okay = m_errorReceiver->GiveParseMessage( Parser::ErrorLevel::Content, section );
-        if ( !okay )
-            m_errorReceiver = NULL;
-    }
-    catch ( ... )
-    {
-        m_errorReceiver = NULL;
-        // throw exception back up to indicate Parser::ErrorLevel::Except
-    }
+    const bool okay = GiveMessage( Parser::ParseMessage( level, begin, end ) );
+    CountError( level );
     return okay;
 }
 
 // ----------------------------------------------------------------------------
 
+bool XmlParserImpl::PrepareContentMessage( const CharType * section )
+{
+    assert( this != NULL );
+    return GiveMessage( Parser::ParseMessage( section, NULL, 0, 0 ) );
+}
+
+// ----------------------------------------------------------------------------
+
 bool XmlParserImpl::PrepareContentMessage( const CharType * section,
     const CharType * name )
 {
     assert( this != NULL );
-
-    if ( NULL == m_errorReceiver )
-        return false;
-    const unsigned long length = static_cast< unsigned long >
-        ( ::strlen( section ) + ::strlen( name ) + 100 );
-    std::string buffer;
-    buffer.reserve( length );
-//    char * pBuffer = const_cast< char * >( buffer.c_str() );
-//    ::_snprintf( pBuffer, length, "Inside %s section for %s", section, name );
-    ::Loki::SPrintf( buffer, "Inside %s section for %s" )( section )( name );
-    bool okay = false;
-    try
-    {
-        okay = m_errorReceiver->GiveParseMessage( Parser::ErrorLevel::Content, buffer.c_str() );
-        if ( !okay )
-            m_errorReceiver = NULL;
-    }
-    catch ( ... )
-    {
-        m_errorReceiver = NULL;
-        // throw exception back up to indicate Parser::ErrorLevel::Except
-    }
-    return okay;
+    return GiveMessage( Parser::ParseMessage( section, name, 0, 0 ) );
 }
 
 // ----------------------------------------------------------------------------
@@ -497,32 +888,7 @@ bool XmlParserImpl::PrepareContentMessage( const CharType * section,
     const CharType * name, unsigned long line, unsigned long chars )
 {
     assert( this != NULL );
-
-    if ( NULL == m_errorReceiver )
-        return false;
-    const unsigned long length = static_cast< unsigned long >
-        ( ::strlen( section ) + ::strlen( name ) + 100 );
-    std::string buffer;
-    buffer.reserve( length );
-//    char * pBuffer = const_cast< char * >( buffer.c_str() );
-//    ::_snprintf( pBuffer, length, "Inside %s section for %s on line %u at char %u.",
-//        section, name, line, chars );
-    ::Loki::SPrintf( buffer, "Inside %s section for %s on line %u at char %u." )
-        ( section )( name )( line )( chars );
-    bool okay = false;
-    try
-    {
-        okay = m_errorReceiver->GiveParseMessage( Parser::ErrorLevel::Content, buffer.c_str() );
-        if ( !okay )
-            m_errorReceiver = NULL;
-    }
-    catch ( ... )
-    {
-        m_errorReceiver = NULL;
-        // throw exception back up to indicate Parser::ErrorLevel::Except
-    }
-
-    return okay;
+    return GiveMessage( Parser::ParseMessage( section, name, line, chars ) );
 }
 
 // ----------------------------------------------------------------------------
@@ -530,7 +896,7 @@ bool XmlParserImpl::PrepareContentMessage( const CharType * section,
 XmlParser::XmlParser() : m_impl( NULL )
 {
     assert( this != NULL );
-    CommonParserRules::IncReference();
+    XmlGrammar::Build();
     m_impl = new XmlParserImpl;
     assert( m_impl != NULL );
 }
@@ -543,7 +909,6 @@ XmlParser::~XmlParser()
     assert( this != NULL );
     assert( m_impl != NULL );
     delete m_impl;
-    CommonParserRules::DecReference();
 }
 
 // ----------------------------------------------------------------------------
@@ -569,6 +934,24 @@ Parser::IParseErrorReceiver * XmlParser::GetErrorReceiver( void )
 
 // ----------------------------------------------------------------------------
 
+void XmlParser::SetFastScanning( bool fast )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    m_impl->SetFastScanning( fast );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlParser::IsFastScanning( void ) const
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    return m_impl->IsFastScanning();
+}
+
+// ----------------------------------------------------------------------------
+
 XmlParser::ParseResults XmlParser::ParseFile(
     const char * filename, IDocumentReceiver * receiver )
 {
@@ -579,13 +962,16 @@ XmlParser::ParseResults XmlParser::ParseFile(
         return XmlParser::NoFileName;
     if ( !m_impl->IsReady() )
         return XmlParser::NotReady;
-    string contents;
-    if ( !ReadFileIntoString( filename, contents ) )
+    // Contents are parsed in place, and the range ends at the last byte of
+    // the file.  Nils embedded in the file are treated as whitespace by the
+    // grammar.
+    FileBuffer contents;
+    if ( !contents.Open( filename ) )
         return XmlParser::CantOpenFile;
-    if ( contents.empty() )
+    if ( 0 == contents.GetSize() )
         return XmlParser::EndOfFile;
-    const CharType * begin = contents.c_str();
-    const CharType * end = begin + contents.size() + 1;
+    const CharType * begin = contents.GetBegin();
+    const CharType * end = contents.GetEnd();
     const XmlParser::ParseResults result =
         m_impl->ParseDocument( begin, end, receiver );
 
@@ -594,6 +980,184 @@ XmlParser::ParseResults XmlParser::ParseFile(
 
 // ----------------------------------------------------------------------------
 
+XmlParser::ParseResults XmlParser::StartFeeding( IDocumentReceiver * receiver )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    return m_impl->StartFeeding( receiver );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::Feed( const CharType * begin,
+    const CharType * end )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    return m_impl->Feed( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::Finish( void )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    return m_impl->Finish();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::ParseStartTag( const CharType * begin,
+    const CharType * end, INodeReceiver * receiver )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+
+    if ( NULL == receiver )
+        return ParseStartTagByRules( begin, end, receiver );
+    return ::Parser::Xml::ParseStartTag( *this, begin, end, *receiver );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlParser::IsReady( void ) const
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    return m_impl->IsReady();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::ParseStartTagByRules( const CharType * begin,
+    const CharType * end, INodeReceiver * receiver )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+
+    XmlParser::ParseResults result = m_impl->DoPreliminaryChecks( begin, end );
+    if ( result == XmlParser::AllValid )
+        result = m_impl->ParseStartTag( begin, end, receiver );
+    return result;
+}
+// ----------------------------------------------------------------------------
+
+const CharType * XmlParser::ScanName( const CharType * begin, const CharType * end )
+{
+    return NameParser::Scanner::Scan( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+const CharType * XmlParser::ScanStartTag( const CharType * begin,
+    const CharType * end )
+{
+    if ( ( NULL == begin ) || ( NULL == end ) || ( end <= begin ) || ( '<' != *begin ) )
+        return NULL;
+    const CharType * nameEnd = NameParser::Scanner::Scan( begin + 1, end );
+    if ( NULL == nameEnd )
+        return NULL;
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    const CharType * here = nameEnd;
+    for ( ;; )
+    {
+        const CharType * spaces = here;
+        while ( ( here != end )
+            && commonRules.IsCharClass( *here, CommonParserRules::SpaceClass ) )
+            ++here;
+        if ( here == end )
+            return NULL;
+        if ( '>' == *here )
+            return here + 1;
+        if ( '/' == *here )
+            return ( ( here + 1 != end ) && ( '>' == here[ 1 ] ) ) ? here + 2 : NULL;
+        // The rules need a space before each attribute.
+        if ( here == spaces )
+            return NULL;
+        const CharType * attributeEnd = AttributeParser::Scanner::Scan( here, end );
+        if ( NULL == attributeEnd )
+            return NULL;
+        // Leaves a repeated name for the rules to report.
+        const CharType * name = here;
+        const CharType * last = NameParser::Scanner::Scan( name, attributeEnd );
+        const size_t length = static_cast< size_t >( last - name );
+        const CharType * prior = nameEnd;
+        const CharType * priorName = NULL;
+        const CharType * priorNameEnd = NULL;
+        const CharType * priorValue = NULL;
+        while ( NULL != ( prior = ScanNextAttribute( prior, here, priorName,
+            priorNameEnd, priorValue ) ) )
+        {
+            if ( ( length == static_cast< size_t >( priorNameEnd - priorName ) )
+              && ( ::memcmp( name, priorName, length ) == 0 ) )
+                return NULL;
+        }
+        here = attributeEnd;
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+const CharType * XmlParser::ScanNextAttribute( const CharType * here,
+    const CharType * end, const CharType * & nameBegin, const CharType * & nameEnd,
+    const CharType * & valueBegin )
+{
+    const CommonParserRules & commonRules = CommonParserRules::GetIt();
+    while ( ( here != end )
+        && commonRules.IsCharClass( *here, CommonParserRules::SpaceClass ) )
+        ++here;
+    if ( ( here == end ) || !commonRules.IsCharClass( *here,
+        CommonParserRules::FirstNameClass ) )
+        return NULL;
+    const CharType * attributeEnd = AttributeParser::Scanner::Scan( here, end );
+    assert( NULL != attributeEnd );
+    nameBegin = here;
+    AttributeParser::Scanner::Split( here, attributeEnd, nameEnd, valueBegin );
+    return attributeEnd;
+}
+
+// ----------------------------------------------------------------------------
+
+const CharType * XmlParser::FeedItem( const CharType * begin, const CharType * end )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    assert( NULL != begin );
+    assert( begin < end );
+    return m_impl->FeedItem( begin, end );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlParser::CancelFeeding( void )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+    m_impl->CancelFeeding();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::ParsePiece( const CharType * tagsBegin,
+    const CharType * tagsEnd, const CharType * begin, const CharType * end,
+    bool finishing, IDocumentReceiver * receiver )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+
+    XmlParser::ParseResults result = m_impl->DoPreliminaryChecks( begin, end );
+    if ( ( result == XmlParser::AllValid ) && ( ( NULL == tagsBegin )
+      || ( NULL == tagsEnd ) || ( tagsEnd < tagsBegin ) ) )
+        result = XmlParser::NullStart;
+    if ( result == XmlParser::AllValid )
+        result = m_impl->ParsePiece( tagsBegin, tagsEnd, begin, end, finishing,
+            receiver );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
 XmlParser::ParseResults XmlParser::ParseDocument(
     const CharType * begin, IDocumentReceiver * receiver )
 {
@@ -625,6 +1189,23 @@ XmlParser::ParseResults XmlParser::ParseDocument( const CharType * begin,
 
 // ----------------------------------------------------------------------------
 
+XmlParser::ParseResults XmlParser::ParseDocument( const CharType * begin,
+    const CharType * end, EventBuffer & events )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+
+    XmlEventWriter writer( events );
+    writer.Begin( begin );
+    XmlParser::ParseResults result = m_impl->DoPreliminaryChecks( begin, end );
+    if ( result == XmlParser::AllValid )
+        result = m_impl->ParseDocument( begin, end, writer );
+    writer.Finish( end );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
 XmlParser::ParseResults XmlParser::ParseNode(
     const CharType * begin, INodeReceiver * receiver )
 {
@@ -713,6 +1294,23 @@ XmlParser::ParseResults XmlParser::ParseAttribute(
     XmlParser::ParseResults result = m_impl->DoPreliminaryChecks( begin, end );
     if ( result == XmlParser::AllValid )
         result = m_impl->ParseAttribute( begin, end, receiver );
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlParser::ParseAttribute(
+    const char * begin, const char * end, EventBuffer & events )
+{
+    assert( this != NULL );
+    assert( m_impl != NULL );
+
+    XmlEventWriter writer( events );
+    writer.Begin( begin );
+    XmlParser::ParseResults result = m_impl->DoPreliminaryChecks( begin, end );
+    if ( result == XmlParser::AllValid )
+        result = m_impl->ParseAttribute( begin, end, writer );
+    writer.FinishAttribute();
     return result;
 }
 
@@ -0,0 +1,567 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlReader.cpp Parses a document into tokens one item at a time.
+
+
+#include "../include/XmlReader.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+/** @class TokenRecorder
+ Receives every call made while parsing each item of a document and adds a
+ token for each one.  One recorder acts as the receiver for every node, and
+ keeps a stack of open elements so each EndElement can be matched to its
+ StartElement, even when they come from items parsed far apart.  The parser
+ gives DoneNode only the range of the end tag of an item, so the recorder
+ widens it to start at the start tag, as when a whole document is parsed.
+ */
+class TokenRecorder : public IDocumentReceiver, public INodeReceiver
+{
+public:
+
+    explicit TokenRecorder( XmlReader & reader );
+
+    virtual ~TokenRecorder( void ) {}
+
+    /// Prepares for a document whose chars start at begin.
+    void Start( const char * begin );
+
+    virtual INodeReceiver * AddRoot( void );
+
+    /// Adds comment to innermost open element, or to document if none is open.
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool AddCDataSection( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+    /** Closes any elements left open and adds EndDocument, if the parser
+     stopped before calling DoneDocument.
+     */
+    void Finish( void );
+
+private:
+
+    /// Not implemented.
+    TokenRecorder( const TokenRecorder & );
+    /// Not implemented.
+    TokenRecorder & operator = ( const TokenRecorder & );
+
+    void AddToken( XmlReader::Tokens kind, unsigned long depth, const char * begin,
+        const char * end );
+
+    /// Closes innermost open element with a view from its start tag to end.
+    void CloseElement( bool valid, const char * end );
+
+    XmlReader & m_reader;
+    XmlReader::TokenList & m_tokens;
+    const char * m_documentBegin;
+    /// Indexes of StartElement tokens whose elements are not closed yet.
+    ::std::vector< unsigned long > m_open;
+    /// Start of the start tag of each open element, or NULL if not parsed yet.
+    ::std::vector< const char * > m_tagBegins;
+    /// End of furthest range parsed so far, where unclosed elements end.
+    const char * m_lastEnd;
+    bool m_done;
+
+};
+
+// ----------------------------------------------------------------------------
+
+TokenRecorder::TokenRecorder( XmlReader & reader ) :
+    IDocumentReceiver(),
+    INodeReceiver(),
+    m_reader( reader ),
+    m_tokens( reader.m_tokens ),
+    m_documentBegin( NULL ),
+    m_open(),
+    m_tagBegins(),
+    m_lastEnd( NULL ),
+    m_done( false )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+void TokenRecorder::Start( const char * begin )
+{
+    assert( NULL != this );
+    m_documentBegin = begin;
+    m_open.clear();
+    m_tagBegins.clear();
+    m_lastEnd = begin;
+    m_done = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void TokenRecorder::AddToken( XmlReader::Tokens kind, unsigned long depth,
+    const char * begin, const char * end )
+{
+    assert( NULL != this );
+    const XmlReader::Token token = { kind, true, depth, 0, begin, end };
+    m_tokens.push_back( token );
+    if ( ( NULL != end ) && ( m_lastEnd < end ) )
+        m_lastEnd = end;
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * TokenRecorder::AddRoot( void )
+{
+    assert( NULL != this );
+    return AddChild();
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * TokenRecorder::AddChild( void )
+{
+    assert( NULL != this );
+    // Name is not known yet, so SetElementName fills in the view.
+    const unsigned long index = static_cast< unsigned long >( m_tokens.size() );
+    AddToken( XmlReader::StartElement, static_cast< unsigned long >( m_open.size() ),
+        NULL, NULL );
+    m_open.push_back( index );
+    m_tagBegins.push_back( NULL );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    XmlReader::Token & token = m_tokens[ m_open.back() ];
+    token.m_begin = begin;
+    token.m_end = end;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    AddToken( XmlReader::AttributeName, m_open.size() - 1, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    AddToken( XmlReader::AttributeValue, m_open.size() - 1, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+    AddToken( XmlReader::TagEnd, m_open.size() - 1, begin, end );
+    m_tagBegins.back() = begin;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    AddToken( XmlReader::Text, m_open.size(), begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    AddToken( XmlReader::CData, m_open.size(), begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    AddToken( XmlReader::Comment, m_open.size(), begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void TokenRecorder::CloseElement( bool valid, const char * end )
+{
+    assert( NULL != this );
+    assert( !m_open.empty() );
+
+    const unsigned long start = m_open.back();
+    const char * begin = m_tagBegins.back();
+    if ( NULL == begin )
+        begin = end;
+    m_open.pop_back();
+    m_tagBegins.pop_back();
+    const unsigned long index = static_cast< unsigned long >( m_tokens.size() );
+    AddToken( XmlReader::EndElement, m_open.size(), begin, end );
+    XmlReader::Token & token = m_tokens.back();
+    token.m_valid = valid;
+    token.m_match = start;
+    m_tokens[ start ].m_match = index;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    // An element closed at the end of the document gets an empty range.
+    CloseElement( valid, ( begin == end ) ? m_lastEnd : end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    m_reader.m_hasStandalone = true;
+    m_reader.m_standalone = standalone;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TokenRecorder::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    (void)begin;
+    (void)end;
+    while ( !m_open.empty() )
+        CloseElement( false, m_lastEnd );
+    AddToken( XmlReader::EndDocument, 0, m_documentBegin, m_reader.m_end );
+    m_tokens.back().m_valid = valid;
+    m_done = true;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void TokenRecorder::Finish( void )
+{
+    assert( NULL != this );
+    if ( !m_done && !m_tokens.empty() )
+        DoneDocument( false, m_documentBegin, m_reader.m_end );
+}
+
+// ----------------------------------------------------------------------------
+
+const char * XmlReader::GetTokenName( XmlReader::Tokens token )
+{
+    switch ( token )
+    {
+        case None:           return "None";
+        case StartElement:   return "StartElement";
+        case AttributeName:  return "AttributeName";
+        case AttributeValue: return "AttributeValue";
+        case TagEnd:         return "TagEnd";
+        case Text:           return "Text";
+        case CData:          return "CData";
+        case Comment:        return "Comment";
+        case EndElement:     return "EndElement";
+        case EndDocument:    return "EndDocument";
+        default: break;
+    }
+    return "Unknown";
+}
+
+// ----------------------------------------------------------------------------
+
+XmlReader::XmlReader( XmlParser & parser ) :
+    m_parser( parser ),
+    m_recorder( NULL ),
+    m_tokens(),
+    m_next( 0 ),
+    m_current( NULL ),
+    m_here( NULL ),
+    m_end( NULL ),
+    m_parsing( false ),
+    m_result( XmlParser::EmptyData ),
+    m_hasStandalone( false ),
+    m_standalone( false )
+{
+    assert( NULL != this );
+    m_recorder = new TokenRecorder( *this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlReader::~XmlReader( void )
+{
+    assert( NULL != this );
+    Close();
+    delete m_recorder;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlReader::Close( void )
+{
+    assert( NULL != this );
+    if ( m_parsing )
+    {
+        m_parser.CancelFeeding();
+        m_parsing = false;
+    }
+    m_tokens.clear();
+    m_here = NULL;
+    m_end = NULL;
+    m_result = XmlParser::EmptyData;
+    m_hasStandalone = false;
+    m_standalone = false;
+    Rewind();
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlReader::Open( const char * begin, const char * end )
+{
+    assert( NULL != this );
+
+    Close();
+    // Same checks the parser makes before parsing a whole document.
+    if ( NULL == begin )
+        return XmlParser::NullStart;
+    if ( ( begin == end ) || ( '\0' == *begin ) )
+        return XmlParser::EmptyData;
+    if ( NULL == end )
+        return XmlParser::NullEnd;
+    if ( end < begin )
+        return XmlParser::EndTooLow;
+
+    m_recorder->Start( begin );
+    const XmlParser::ParseResults result = m_parser.StartFeeding( m_recorder );
+    if ( XmlParser::AllValid != result )
+        return result;
+    m_here = begin;
+    m_end = end;
+    m_parsing = true;
+    m_result = XmlParser::ParsingNow;
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlReader::ParseItem( void )
+{
+    assert( NULL != this );
+
+    if ( !m_parsing )
+        return false;
+    if ( m_here < m_end )
+    {
+        m_here = m_parser.FeedItem( m_here, m_end );
+        if ( NULL != m_here )
+            return true;
+        m_result = XmlParser::Exception;
+    }
+    else
+    {
+        m_result = m_parser.Finish();
+    }
+    m_parsing = false;
+    m_recorder->Finish();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlReader::ParseTo( unsigned long index )
+{
+    assert( NULL != this );
+
+    while ( m_tokens.size() <= index )
+    {
+        if ( !ParseItem() )
+            return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlReader::ParseElement( unsigned long index )
+{
+    assert( NULL != this );
+    assert( index < m_tokens.size() );
+
+    // Each element is closed by the time the document ends.
+    while ( ( 0 == m_tokens[ index ].m_match ) && ParseItem() )
+    {
+    }
+    m_current = &m_tokens[ index ];
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlReader::Equals( const char * text ) const
+{
+    assert( NULL != this );
+    assert( NULL != text );
+    if ( NULL == m_current )
+        return false;
+    const unsigned long length =
+        static_cast< unsigned long >( m_current->m_end - m_current->m_begin );
+    return ( ::strlen( text ) == length )
+        && ( 0 == ::memcmp( m_current->m_begin, text, length ) );
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlReader::Replay( IDocumentReceiver * receiver )
+{
+    assert( NULL != this );
+
+    while ( ParseItem() )
+    {
+    }
+    if ( 0 < m_next )
+        m_current = &m_tokens[ m_next - 1 ];
+
+    IDocumentReceiver * document = receiver;
+    if ( NULL == document )
+        return false;
+    if ( m_hasStandalone && !document->SetStandalone( m_standalone ) )
+        document = NULL;
+
+    // Each open element has a receiver, which is NULL once it returns false.
+    ::std::vector< INodeReceiver * > open;
+    const unsigned long count = static_cast< unsigned long >( m_tokens.size() );
+    for ( unsigned long ii = 0; ii < count; ++ii )
+    {
+        const Token & token = m_tokens[ ii ];
+        INodeReceiver * node = open.empty() ? NULL : open.back();
+        switch ( token.m_kind )
+        {
+            case StartElement:
+            {
+                INodeReceiver * child = NULL;
+                if ( open.empty() )
+                    child = ( NULL == document ) ? NULL : document->AddRoot();
+                else if ( NULL != node )
+                    child = node->AddChild();
+                if ( NULL == child )
+                {
+                    // Parser makes no calls for an element without a receiver.
+                    ii = token.m_match;
+                    break;
+                }
+                open.push_back( child );
+                if ( !child->SetElementName( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            }
+            case AttributeName:
+                if ( ( NULL != node ) && !node->SetAttributeName( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case AttributeValue:
+                if ( ( NULL != node ) && !node->SetAttributeValue( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case TagEnd:
+                if ( ( NULL != node ) && !node->SetTagName( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case Text:
+                if ( ( NULL != node ) && !node->AddCData( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case CData:
+                if ( ( NULL != node ) && !node->AddCDataSection( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case Comment:
+                if ( open.empty() )
+                {
+                    if ( ( NULL != document )
+                      && !document->AddComment( token.m_begin, token.m_end ) )
+                        document = NULL;
+                }
+                else if ( ( NULL != node ) && !node->AddComment( token.m_begin, token.m_end ) )
+                    open.back() = NULL;
+                break;
+            case EndElement:
+                if ( NULL != node )
+                    node->DoneNode( token.m_valid, token.m_begin, token.m_end );
+                open.pop_back();
+                break;
+            case EndDocument:
+                if ( NULL != document )
+                    document->DoneDocument( token.m_valid, token.m_begin, token.m_end );
+                break;
+            default:
+                assert( false );
+                break;
+        }
+    }
+
+    return ( NULL != document );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $
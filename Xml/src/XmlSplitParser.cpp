@@ -0,0 +1,993 @@
+// ----------------------------------------------------------------------------
+// The Parser Library
+// Copyright (c) 2008 by Rich Sposato
+//
+// Permission to use, copy, modify, distribute and sell this software for any
+// purpose is hereby granted under the terms stated in the GNU Library Public
+// License, provided that the above copyright notice appear in all copies and
+// that both that copyright notice and this permission notice appear in
+// supporting documentation.
+//
+// ----------------------------------------------------------------------------
+
+// $Header: $
+
+/// @file XmlSplitParser.cpp Parses pieces of one document on many threads.
+
+
+#include "../include/XmlSplitParser.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "./CommonInfo.hpp"
+#include "./DocumentFeeder.hpp"
+
+
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+using ::Parser::CharType;
+using ::Parser::Xml::INodeReceiver;
+
+/// Default number of chars in each piece.
+const unsigned long s_defaultPieceSize = 1024 * 1024;
+
+// ----------------------------------------------------------------------------
+
+/// Kinds of receiver calls a PieceRecorder keeps.
+enum CallType
+{
+    AddRootCall,
+    DocumentCommentCall,
+    StandaloneCall,
+    DoneDocumentCall,
+    AddChildCall,
+    TagNameCall,
+    ElementNameCall,
+    CommentCall,
+    CDataCall,
+    CDataSectionCall,
+    AttributeNameCall,
+    AttributeValueCall,
+    DoneNodeCall
+};
+
+/// One receiver call made while parsing a piece.
+struct Call
+{
+    CallType m_type;
+    /// Standalone or valid flag, for the calls which have one.
+    bool m_flag;
+    const CharType * m_begin;
+    const CharType * m_end;
+};
+
+typedef ::std::vector< Call > Calls;
+
+/// Range of an element name within the document.
+struct Name
+{
+    const CharType * m_begin;
+    const CharType * m_end;
+};
+
+typedef ::std::vector< Name > Names;
+
+// ----------------------------------------------------------------------------
+
+/** Returns first '<' at or after here which may start a start tag or end tag,
+ or end if there is none.  It may still be inside a comment or other item.
+ */
+const CharType * FindPieceStart( const CharType * here, const CharType * end )
+{
+    const ::Parser::Xml::CommonParserRules & commonRules =
+        ::Parser::Xml::CommonParserRules::GetIt();
+    while ( here + 1 < end )
+    {
+        here = static_cast< const CharType * >(
+            ::memchr( here, '<', end - here - 1 ) );
+        if ( NULL == here )
+            break;
+        if ( ( '/' == here[ 1 ] ) || commonRules.m_firstNameChar.test( here[ 1 ] ) )
+            return here;
+        ++here;
+    }
+    return end;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Returns name which starts at begin and ends before whitespace, '/', or '>'.
+Name GetName( const CharType * begin, const CharType * end )
+{
+    const CharType * here = begin;
+    while ( ( here < end ) && ( '/' != *here ) && ( '>' != *here )
+        && ( ' ' != *here ) && ( '\t' != *here ) && ( '\r' != *here )
+        && ( '\n' != *here ) )
+        ++here;
+    const Name name = { begin, here };
+    return name;
+}
+
+// ----------------------------------------------------------------------------
+
+/** @class PieceRecorder
+ Keeps every call made while parsing one piece.  One recorder acts as the
+ receiver for the document and for every element, and counts open elements so
+ it knows whether a comment belongs to the document.  Calls for the start tags
+ given before the piece are skipped, since their elements were given to the
+ receivers by an earlier piece.
+ */
+class PieceRecorder : public ::Parser::Xml::IDocumentReceiver,
+    public ::Parser::Xml::INodeReceiver
+{
+public:
+
+    inline PieceRecorder( void ) : IDocumentReceiver(), INodeReceiver(),
+        m_calls( NULL ), m_skip( 0 ), m_depth( 0 ) {}
+
+    virtual ~PieceRecorder( void ) {}
+
+    /** Starts recording calls for a piece.
+     @param skip Number of start tags given before the piece.
+     */
+    void Start( Calls * calls, unsigned long skip );
+
+    virtual INodeReceiver * AddRoot( void );
+
+    virtual bool AddComment( const char * begin, const char * end );
+
+    virtual bool SetStandalone( bool standalone );
+
+    virtual bool DoneDocument( bool valid, const char * begin, const char * end );
+
+    virtual bool SetTagName( const char * begin, const char * end );
+
+    virtual bool SetElementName( const char * begin, const char * end );
+
+    virtual bool AddCData( const char * begin, const char * end );
+
+    virtual bool AddCDataSection( const char * begin, const char * end );
+
+    virtual bool SetAttributeName( const char * begin, const char * end );
+
+    virtual bool SetAttributeValue( const char * begin, const char * end );
+
+    virtual INodeReceiver * AddChild( void );
+
+    virtual bool DoneNode( bool valid, const char * begin, const char * end );
+
+private:
+
+    /// Not implemented.
+    PieceRecorder( const PieceRecorder & );
+    /// Not implemented.
+    PieceRecorder & operator = ( const PieceRecorder & );
+
+    void Add( CallType type, bool flag, const char * begin, const char * end );
+
+    Calls * m_calls;
+    /// Start tags whose calls are still to be skipped.
+    unsigned long m_skip;
+    /// Number of open elements, including those opened before the piece.
+    unsigned long m_depth;
+};
+
+// ----------------------------------------------------------------------------
+
+void PieceRecorder::Start( Calls * calls, unsigned long skip )
+{
+    assert( NULL != this );
+    m_calls = calls;
+    m_skip = skip;
+    m_depth = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+void PieceRecorder::Add( CallType type, bool flag, const char * begin,
+    const char * end )
+{
+    assert( NULL != this );
+    assert( NULL != m_calls );
+    const Call call = { type, flag, begin, end };
+    m_calls->push_back( call );
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * PieceRecorder::AddRoot( void )
+{
+    assert( NULL != this );
+    m_depth = 1;
+    if ( 0 == m_skip )
+        Add( AddRootCall, false, NULL, NULL );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::AddComment( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( ( 0 == m_depth ) ? DocumentCommentCall : CommentCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::SetStandalone( bool standalone )
+{
+    assert( NULL != this );
+    Add( StandaloneCall, standalone, NULL, NULL );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::DoneDocument( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( DoneDocumentCall, valid, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::SetTagName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    // Each start tag ends with this call, so it marks the end of skipping.
+    if ( 0 < m_skip )
+        --m_skip;
+    else
+        Add( TagNameCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::SetElementName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    if ( 0 == m_skip )
+        Add( ElementNameCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::AddCData( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( CDataCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::AddCDataSection( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( CDataSectionCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::SetAttributeName( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( AttributeNameCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::SetAttributeValue( const char * begin, const char * end )
+{
+    assert( NULL != this );
+    Add( AttributeValueCall, false, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+INodeReceiver * PieceRecorder::AddChild( void )
+{
+    assert( NULL != this );
+    ++m_depth;
+    if ( 0 == m_skip )
+        Add( AddChildCall, false, NULL, NULL );
+    return this;
+}
+
+// ----------------------------------------------------------------------------
+
+bool PieceRecorder::DoneNode( bool valid, const char * begin, const char * end )
+{
+    assert( NULL != this );
+    assert( 0 < m_depth );
+    --m_depth;
+    Add( DoneNodeCall, valid, begin, end );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+/// Takes no calls, so a document can be parsed again just for its messages.
+class DocumentIgnorer : public ::Parser::Xml::IDocumentReceiver
+{
+public:
+
+    inline DocumentIgnorer( void ) : IDocumentReceiver() {}
+
+    virtual ~DocumentIgnorer( void ) {}
+
+    virtual INodeReceiver * AddRoot( void ) { return NULL; }
+
+    virtual bool AddComment( const char *, const char * ) { return true; }
+
+    virtual bool SetStandalone( bool ) { return true; }
+
+    virtual bool DoneDocument( bool, const char *, const char * ) { return true; }
+
+private:
+
+    /// Not implemented.
+    DocumentIgnorer( const DocumentIgnorer & );
+    /// Not implemented.
+    DocumentIgnorer & operator = ( const DocumentIgnorer & );
+};
+
+// ----------------------------------------------------------------------------
+
+/// Parser, message counter, and recorder used by one thread.
+struct SplitWorker
+{
+    ::Parser::Xml::XmlParser m_parser;
+    ::Parser::MessageCollector m_messages;
+    PieceRecorder m_recorder;
+};
+
+}; // end anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+namespace Parser
+{
+
+namespace Xml
+{
+
+// ----------------------------------------------------------------------------
+
+class XmlSplitParser::Impl
+{
+public:
+
+    /// Part of the document parsed by one job.
+    struct Piece
+    {
+        /// Where piece starts.  Just a guess until the pieces are joined.
+        const CharType * m_begin;
+        /// Guessed start of next piece.  Items which start before it are in this piece.
+        const CharType * m_limit;
+        /// End of last item in piece.
+        const CharType * m_end;
+        /// Elements closed in piece but opened before it, innermost first.
+        Names m_closed;
+        /// Elements opened in piece and still open after it, outermost first.
+        Names m_opened;
+        /// Start tags of elements open where piece starts.
+        ::std::string m_tags;
+        unsigned long m_tagCount;
+        XmlParser::ParseResults m_result;
+        unsigned long m_messageCount;
+        Calls m_calls;
+    };
+
+    typedef ::std::vector< Piece > Pieces;
+
+    /// Element which was given to receivers and has not been done yet.
+    struct Frame
+    {
+        /// Receiver for element, or NULL if receivers stopped taking calls.
+        INodeReceiver * m_receiver;
+        const CharType * m_tagBegin;
+    };
+
+    typedef ::std::vector< Frame > Frames;
+
+    Impl( void );
+
+    ~Impl( void ) {}
+
+    void ClearStats( void );
+
+    /// Makes pieces, each starting at a guessed start tag.
+    void Split( const CharType * begin, const CharType * end, unsigned long count );
+
+    /// Finds items of piece from its start, and notes open and closed elements.
+    void Scan( Piece & piece );
+
+    /** Moves each piece whose guess was wrong to the real start and scans it
+     again, drops pieces wholly within an item of the piece before, and gives
+     each piece the start tags of the elements open where it starts.  A piece
+     which starts outside the root element joins the piece before.
+     @return False if an element is closed which was never opened.
+     */
+    bool Join( void );
+
+    /// Parses one piece with parts of one thread.
+    void ParsePiece( SplitWorker & worker, unsigned long index );
+
+    /// Starts giving calls to receivers of a document.
+    void StartGiving( IDocumentReceiver * receiver );
+
+    /// Gives recorded calls to receivers, in order.
+    void Give( const Calls & calls );
+
+    /// Does each open element, and the document, as not valid.
+    void GiveEnd( void );
+
+    /// Drops pieces and recorded calls.
+    void Clear( void );
+
+    XmlParser m_parser;
+    unsigned long m_pieceSize;
+    XmlSplitStats m_stats;
+    Pieces m_pieces;
+    /// True while jobs scan pieces, or false while jobs parse them.
+    bool m_scanning;
+    /// Piece parsed by the first job of this round.
+    unsigned long m_firstPiece;
+    const CharType * m_begin;
+    const CharType * m_end;
+
+    /// Document receiver, or NULL if it stopped taking calls.
+    IDocumentReceiver * m_receiver;
+    Frames m_frames;
+
+private:
+
+    /// Not implemented.
+    Impl( const Impl & );
+    /// Not implemented.
+    Impl & operator = ( const Impl & );
+
+    typedef bool ( INodeReceiver::*NodeCall )( const char *, const char * );
+
+    /// Makes one call on receiver of innermost element.
+    void GiveNode( NodeCall nodeCall, const Call & call );
+
+    /// Makes one call on document receiver.
+    void GiveDocument( const Call & call );
+};
+
+// ----------------------------------------------------------------------------
+
+XmlSplitParser::Impl::Impl( void ) :
+    m_parser(),
+    m_pieceSize( s_defaultPieceSize ),
+    m_stats(),
+    m_pieces(),
+    m_scanning( false ),
+    m_firstPiece( 0 ),
+    m_begin( NULL ),
+    m_end( NULL ),
+    m_receiver( NULL ),
+    m_frames()
+{
+    assert( NULL != this );
+    ClearStats();
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::ClearStats( void )
+{
+    assert( NULL != this );
+    m_stats.m_pieces = 0;
+    m_stats.m_rescans = 0;
+    m_stats.m_rounds = 0;
+    m_stats.m_reparsed = false;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::Split( const CharType * begin, const CharType * end,
+    unsigned long count )
+{
+    assert( NULL != this );
+    assert( 1 < count );
+
+    m_begin = begin;
+    m_end = end;
+    m_pieces.resize( count );
+    const double size = static_cast< double >( end - begin );
+    for ( unsigned long ii = 0; ii < count; ++ii )
+    {
+        Piece & piece = m_pieces[ ii ];
+        piece.m_begin = ( 0 == ii ) ? begin : FindPieceStart(
+            begin + static_cast< unsigned long >( size * ii / count ), end );
+        piece.m_end = piece.m_begin;
+        piece.m_tagCount = 0;
+        piece.m_result = XmlParser::NotParsed;
+        piece.m_messageCount = 0;
+        if ( 0 < ii )
+            m_pieces[ ii - 1 ].m_limit = piece.m_begin;
+    }
+    m_pieces.back().m_limit = end;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::Scan( Piece & piece )
+{
+    assert( NULL != this );
+
+    piece.m_closed.clear();
+    piece.m_opened.clear();
+    const CharType * here = piece.m_begin;
+    while ( here < piece.m_limit )
+    {
+        const CharType * itemEnd = DocumentFeeder::GetItemEnd( here, m_end );
+        assert( here < itemEnd );
+        if ( ( '<' == *here ) && ( here + 2 < itemEnd ) )
+        {
+            const CharType next = here[ 1 ];
+            if ( '/' == next )
+            {
+                if ( piece.m_opened.empty() )
+                    piece.m_closed.push_back( GetName( here + 2, itemEnd ) );
+                else
+                    piece.m_opened.pop_back();
+            }
+            else if ( ( '!' != next ) && ( '?' != next ) && ( '/' != itemEnd[ -2 ] ) )
+            {
+                piece.m_opened.push_back( GetName( here + 1, itemEnd ) );
+            }
+        }
+        here = itemEnd;
+    }
+    piece.m_end = ( here < piece.m_begin ) ? piece.m_begin : here;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlSplitParser::Impl::Join( void )
+{
+    assert( NULL != this );
+
+    Names open;
+    const CharType * end = m_begin;
+    unsigned long kept = 0;
+    for ( unsigned long ii = 0; ii < m_pieces.size(); ++ii )
+    {
+        Piece & piece = m_pieces[ ii ];
+        if ( piece.m_begin != end )
+        {
+            // Guess was inside the last item of the piece before.
+            piece.m_begin = end;
+            Scan( piece );
+            ++m_stats.m_rescans;
+        }
+        if ( piece.m_end == piece.m_begin )
+            continue;
+
+        const bool joinsLast = ( 0 < kept ) && open.empty();
+        if ( !joinsLast )
+        {
+            piece.m_tags.clear();
+            for ( Names::const_iterator it( open.begin() ); it != open.end(); ++it )
+            {
+                piece.m_tags += '<';
+                piece.m_tags.append( it->m_begin, it->m_end );
+                piece.m_tags += '>';
+            }
+            piece.m_tagCount = static_cast< unsigned long >( open.size() );
+        }
+        for ( Names::size_type jj = 0; jj < piece.m_closed.size(); ++jj )
+        {
+            if ( open.empty() )
+                return false;
+            open.pop_back();
+        }
+        open.insert( open.end(), piece.m_opened.begin(), piece.m_opened.end() );
+        end = piece.m_end;
+
+        if ( joinsLast )
+        {
+            m_pieces[ kept - 1 ].m_end = piece.m_end;
+        }
+        else
+        {
+            if ( kept != ii )
+                ::std::swap( m_pieces[ kept ], piece );
+            ++kept;
+        }
+    }
+    m_pieces.resize( kept );
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::ParsePiece( SplitWorker & worker, unsigned long index )
+{
+    assert( NULL != this );
+    assert( index < m_pieces.size() );
+
+    Piece & piece = m_pieces[ index ];
+    piece.m_result = XmlParser::Exception;
+    piece.m_messageCount = 0;
+    piece.m_calls.clear();
+    worker.m_messages.SetTarget( NULL, &piece.m_messageCount );
+    worker.m_recorder.Start( &piece.m_calls, piece.m_tagCount );
+    const CharType * tags = piece.m_tags.data();
+    piece.m_result = worker.m_parser.ParsePiece( tags, tags + piece.m_tags.size(),
+        piece.m_begin, piece.m_end, ( index + 1 == m_pieces.size() ),
+        &worker.m_recorder );
+    worker.m_messages.SetTarget( NULL, NULL );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::StartGiving( IDocumentReceiver * receiver )
+{
+    assert( NULL != this );
+    m_receiver = receiver;
+    m_frames.clear();
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::GiveNode( NodeCall nodeCall, const Call & call )
+{
+    assert( NULL != this );
+    assert( !m_frames.empty() );
+
+    Frame & frame = m_frames.back();
+    if ( NULL == frame.m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        keep = ( frame.m_receiver->*nodeCall )( call.m_begin, call.m_end );
+    }
+    catch ( ... )
+    {
+    }
+    if ( !keep )
+        frame.m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::GiveDocument( const Call & call )
+{
+    assert( NULL != this );
+
+    if ( NULL == m_receiver )
+        return;
+    bool keep = false;
+    try
+    {
+        switch ( call.m_type )
+        {
+            case DocumentCommentCall:
+                keep = m_receiver->AddComment( call.m_begin, call.m_end );
+                break;
+            case StandaloneCall:
+                keep = m_receiver->SetStandalone( call.m_flag );
+                break;
+            case DoneDocumentCall:
+                // Done with whole range, as when parsing in one pass.
+                m_receiver->DoneDocument( call.m_flag, m_begin, m_end );
+                break;
+            default:
+                assert( false );
+                break;
+        }
+    }
+    catch ( ... )
+    {
+    }
+    if ( !keep )
+        m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::Give( const Calls & calls )
+{
+    assert( NULL != this );
+
+    for ( Calls::const_iterator it( calls.begin() ); it != calls.end(); ++it )
+    {
+        const Call & call = *it;
+        switch ( call.m_type )
+        {
+            case AddRootCall:
+            case AddChildCall:
+            {
+                Frame frame = { NULL, NULL };
+                INodeReceiver * parent = ( AddRootCall == call.m_type ) ? NULL
+                    : ( m_frames.empty() ? NULL : m_frames.back().m_receiver );
+                try
+                {
+                    if ( AddRootCall == call.m_type )
+                        frame.m_receiver = ( NULL == m_receiver ) ? NULL : m_receiver->AddRoot();
+                    else if ( NULL != parent )
+                        frame.m_receiver = parent->AddChild();
+                }
+                catch ( ... )
+                {
+                }
+                m_frames.push_back( frame );
+                break;
+            }
+            case DocumentCommentCall:
+            case StandaloneCall:
+            case DoneDocumentCall:
+                GiveDocument( call );
+                break;
+            case TagNameCall:
+                assert( !m_frames.empty() );
+                m_frames.back().m_tagBegin = call.m_begin;
+                GiveNode( &INodeReceiver::SetTagName, call );
+                break;
+            case ElementNameCall:
+                GiveNode( &INodeReceiver::SetElementName, call );
+                break;
+            case CommentCall:
+                GiveNode( &INodeReceiver::AddComment, call );
+                break;
+            case CDataCall:
+                GiveNode( &INodeReceiver::AddCData, call );
+                break;
+            case CDataSectionCall:
+                GiveNode( &INodeReceiver::AddCDataSection, call );
+                break;
+            case AttributeNameCall:
+                GiveNode( &INodeReceiver::SetAttributeName, call );
+                break;
+            case AttributeValueCall:
+                GiveNode( &INodeReceiver::SetAttributeValue, call );
+                break;
+            case DoneNodeCall:
+            {
+                assert( !m_frames.empty() );
+                const Frame frame = m_frames.back();
+                m_frames.pop_back();
+                if ( NULL == frame.m_receiver )
+                    break;
+                try
+                {
+                    // The piece may not have the start tag, so the range
+                    // starts where the receivers were given it.
+                    frame.m_receiver->DoneNode( call.m_flag, frame.m_tagBegin, call.m_end );
+                }
+                catch ( ... )
+                {
+                }
+                break;
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::GiveEnd( void )
+{
+    assert( NULL != this );
+
+    while ( !m_frames.empty() )
+    {
+        const Frame frame = m_frames.back();
+        m_frames.pop_back();
+        if ( NULL == frame.m_receiver )
+            continue;
+        try
+        {
+            frame.m_receiver->DoneNode( false, frame.m_tagBegin, m_end );
+        }
+        catch ( ... )
+        {
+        }
+    }
+    const Call call = { DoneDocumentCall, false, m_begin, m_end };
+    GiveDocument( call );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::Impl::Clear( void )
+{
+    assert( NULL != this );
+    Pieces().swap( m_pieces );
+    m_frames.clear();
+    m_receiver = NULL;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlSplitParser::XmlSplitParser( unsigned long threadCount ) :
+    BatchRunner( threadCount ),
+    m_impl( new Impl )
+{
+    assert( NULL != this );
+}
+
+// ----------------------------------------------------------------------------
+
+XmlSplitParser::~XmlSplitParser( void )
+{
+    assert( NULL != this );
+    delete m_impl;
+}
+
+// ----------------------------------------------------------------------------
+
+bool XmlSplitParser::SetErrorReceiver( IParseErrorReceiver * receiver )
+{
+    assert( NULL != this );
+    return m_impl->m_parser.SetErrorReceiver( receiver );
+}
+
+// ----------------------------------------------------------------------------
+
+IParseErrorReceiver * XmlSplitParser::GetErrorReceiver( void )
+{
+    assert( NULL != this );
+    return m_impl->m_parser.GetErrorReceiver();
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::SetPieceSize( unsigned long size )
+{
+    assert( NULL != this );
+    m_impl->m_pieceSize = ( 0 == size ) ? s_defaultPieceSize : size;
+}
+
+// ----------------------------------------------------------------------------
+
+unsigned long XmlSplitParser::GetPieceSize( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_pieceSize;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlSplitStats XmlSplitParser::GetSplitStats( void ) const
+{
+    assert( NULL != this );
+    return m_impl->m_stats;
+}
+
+// ----------------------------------------------------------------------------
+
+XmlParser::ParseResults XmlSplitParser::ParseDocument( const char * begin,
+    const char * end, IDocumentReceiver * receiver )
+{
+    assert( NULL != this );
+
+    Impl & impl = *m_impl;
+    impl.ClearStats();
+    const unsigned long threadCount = GetThreadCount();
+    const unsigned long count = ( ( NULL == begin ) || ( end < begin ) ) ? 0
+        : static_cast< unsigned long >( end - begin ) / impl.m_pieceSize;
+    if ( ( count < 2 ) || ( threadCount < 2 ) || ( NULL == receiver )
+      || ( NULL == impl.m_parser.GetErrorReceiver() ) )
+        return impl.m_parser.ParseDocument( begin, end, receiver );
+
+    impl.Split( begin, end, count );
+    impl.m_scanning = true;
+    RunJobs( count );
+    impl.m_scanning = false;
+    if ( !impl.Join() || ( impl.m_pieces.size() < 2 ) )
+    {
+        impl.Clear();
+        return impl.m_parser.ParseDocument( begin, end, receiver );
+    }
+
+    const unsigned long pieceCount = static_cast< unsigned long >( impl.m_pieces.size() );
+    impl.m_stats.m_pieces = pieceCount;
+    impl.StartGiving( receiver );
+    // Enough pieces per round that threads with quick pieces can take more.
+    const unsigned long roundSize = 2 * threadCount;
+    unsigned long given = 0;
+    bool stopped = false;
+    bool hasMessages = false;
+    for ( unsigned long first = 0; ( first < pieceCount ) && !stopped; first += roundSize )
+    {
+        const unsigned long jobCount = ::std::min( roundSize, pieceCount - first );
+        impl.m_firstPiece = first;
+        RunJobs( jobCount );
+        ++impl.m_stats.m_rounds;
+        for ( unsigned long ii = first; ii < first + jobCount; ++ii )
+        {
+            Impl::Piece & piece = impl.m_pieces[ ii ];
+            if ( XmlParser::AllValid != piece.m_result )
+            {
+                stopped = true;
+                break;
+            }
+            if ( 0 != piece.m_messageCount )
+                hasMessages = true;
+            impl.Give( piece.m_calls );
+            Calls().swap( piece.m_calls );
+            ++given;
+        }
+    }
+
+    XmlParser::ParseResults result = XmlParser::AllValid;
+    if ( stopped && ( 0 == given ) )
+    {
+        impl.Clear();
+        impl.m_stats.m_reparsed = true;
+        return impl.m_parser.ParseDocument( begin, end, receiver );
+    }
+    if ( stopped )
+        impl.GiveEnd();
+    impl.Clear();
+    if ( stopped || hasMessages )
+    {
+        // Messages from pieces have places within pieces, so parse once more
+        // to give the messages a parse in one pass would give.
+        DocumentIgnorer ignorer;
+        impl.m_stats.m_reparsed = true;
+        result = impl.m_parser.ParseDocument( begin, end, &ignorer );
+    }
+    return result;
+}
+
+// ----------------------------------------------------------------------------
+
+void * XmlSplitParser::MakeWorker( void )
+{
+    assert( NULL != this );
+    SplitWorker * worker = new SplitWorker;
+    worker->m_parser.SetErrorReceiver( &worker->m_messages );
+    return worker;
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::RunJob( void * worker, unsigned long job )
+{
+    assert( NULL != this );
+
+    if ( m_impl->m_scanning )
+        m_impl->Scan( m_impl->m_pieces[ job ] );
+    else
+        m_impl->ParsePiece( *reinterpret_cast< SplitWorker * >( worker ),
+            m_impl->m_firstPiece + job );
+}
+
+// ----------------------------------------------------------------------------
+
+void XmlSplitParser::DestroyWorker( void * worker )
+{
+    assert( NULL != this );
+    delete reinterpret_cast< SplitWorker * >( worker );
+}
+
+// ----------------------------------------------------------------------------
+
+}; // end namespace Xml
+
+}; // end namespace Parser
+
+// $Log: $